@@ -0,0 +1,145 @@
+#include "static_b_tree.h"
+#include "sst.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <cstdlib>
+#include <new>
+
+// Number of heap allocations made by the whole program, counted by the replaced global operator new
+static long num_allocations = 0;
+
+void *operator new(size_t size)
+{
+    num_allocations++;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Number of pairs in the SST (a single B-Tree Internal Node over 200 Leaf pages)
+long NUM_PAIRS = 200 * MAX_PAIRS;
+
+// Number of gets and scans measured for every read path
+int NUM_QUERIES = 100000;
+
+// Number of keys returned by every scan
+long SCAN_LENGTH = 100;
+
+/*
+    Runs the queries against the B-Tree and returns the heap allocations and the
+    time (ns) per query. With a buffer pool, every query is run once beforehand
+    so that all of the pages are cached and only the in-place reads are measured.
+*/
+std::pair<double, double> measureAllocations(StaticBTree &btree, BufferPool *buffer_pool, const std::vector<long> &keys, bool is_scan)
+{
+    long checksum = 0;
+    auto runQueries = [&]()
+    {
+        for (long key : keys)
+        {
+            if (is_scan)
+            {
+                checksum += btree.scan(key, key + SCAN_LENGTH * 2, buffer_pool).size();
+            }
+            else
+            {
+                checksum += btree.get(key, buffer_pool);
+            }
+        }
+    };
+    if (buffer_pool)
+    {
+        runQueries();
+    }
+
+    long start_allocations = num_allocations;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    runQueries();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    long allocations = num_allocations - start_allocations;
+
+    if (checksum == 0)
+    {
+        std::cerr << "Error: No keys were found." << std::endl;
+    }
+    return {static_cast<double>(allocations) / keys.size(), elapsed.count() / keys.size()};
+}
+
+/*
+    Counts the heap allocations per StaticBTree get (and per scan) when the pages
+    are read from disk, from buffer pool frames and from memory mappings. Gets
+    view every page in place, so none of the read paths should allocate; a scan
+    only allocates to grow the vector of results it returns.
+*/
+int main()
+{
+    std::string filepath = DATA_FILE_PATH + "allocations";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_allocations.bin";
+    std::string btree_filename = filepath + "/btree_allocations.bin";
+    std::string bloom_filename = filepath + "/bloom_allocations.bin";
+
+    SSTWriter writer(sst_filename, btree_filename, bloom_filename);
+    for (long i = 1; i <= NUM_PAIRS; ++i)
+    {
+        writer.put(i * 2, i * 20);
+    }
+    if (!writer.finish())
+    {
+        std::cerr << "Error: Could not write the SST." << std::endl;
+        return 1;
+    }
+
+    std::mt19937 gen(443);
+    std::uniform_int_distribution<long> dist(1, NUM_PAIRS);
+    std::vector<long> keys(NUM_QUERIES);
+    for (long &key : keys)
+    {
+        key = dist(gen) * 2;
+    }
+
+    // The buffer pool is large enough to hold every page of the SST and the B-Tree
+    BufferPool *buffer_pool = new BufferPool(1024);
+    MappedFile sst_map(sst_filename);
+    MappedFile btree_map(btree_filename);
+    StaticBTree btree(sst_filename, btree_filename);
+    StaticBTree mapped_btree(sst_filename, btree_filename, &sst_map, &btree_map);
+
+    std::ofstream file("./../experiments/allocations_per_get.csv", std::ios::out);
+    file << "Read Path,Allocations per Get,Get (ns/op),Allocations per Scan,Scan (ns/op)\n";
+
+    std::vector<std::pair<std::string, std::pair<StaticBTree *, BufferPool *>>> read_paths = {
+        {"Disk", {&btree, nullptr}},
+        {"Buffer Pool", {&btree, buffer_pool}},
+        {"Mmap", {&mapped_btree, nullptr}}};
+    for (auto &[name, read_path] : read_paths)
+    {
+        auto [get_allocations, get_ns] = measureAllocations(*read_path.first, read_path.second, keys, false);
+        auto [scan_allocations, scan_ns] = measureAllocations(*read_path.first, read_path.second, keys, true);
+        std::cout << name << ": " << get_allocations << " allocations per get (" << get_ns << " ns/op), "
+                  << scan_allocations << " allocations per scan of " << SCAN_LENGTH << " keys (" << scan_ns << " ns/op)." << std::endl;
+        file << name << "," << get_allocations << "," << get_ns << "," << scan_allocations << "," << scan_ns << "\n";
+    }
+
+    delete buffer_pool;
+    std::filesystem::remove_all(filepath);
+    std::cout << "Data successfully written to ./../experiments/allocations_per_get.csv" << std::endl;
+    return 0;
+}
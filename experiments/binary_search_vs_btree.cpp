@@ -5,10 +5,13 @@
 #include <chrono>
 #include <map>
 #include <filesystem>
+#include <functional>
 #include "global.h"
 #include "memtable.h"
 #include "sst.h"
+#include "lsm_tree.h"
 #include "static_b_tree.h"
+#include "page_search.h"
 #include "test_helpers.h"
 
 // Constants
@@ -20,6 +23,9 @@ std::map<long, long> generated_pairs;
 // Keys to use for querying later
 std::vector<long> all_keys;
 
+// Page size of the SSTs, set from the command line
+size_t page_size = PAGE_SIZE;
+
 // Progress Bar Function
 void displayProgressBar(size_t current, size_t total, size_t bar_width = 50)
 {
@@ -133,6 +139,7 @@ void createTestSSTWithBTree(const std::vector<std::pair<long, long>>& data, LSMT
     // Memtable *memtable = new Memtable(data.size());
     memtable = new Memtable(MEMTABLE_SIZE);
     lsm_tree = new LSMTree(MEMTABLE_SIZE, DATABASE_NAME, memtable);
+    lsm_tree->setPageSize(page_size);
 
     generated_pairs.clear();
 
@@ -174,10 +181,90 @@ double measureThroughput(std::function<void()> query_func, size_t query_count)
     return query_count / duration; // Queries per second
 }
 
-int main() {
-    const std::string output_file = "./../experiments/binary_vs_btree_results.csv";
+/*
+    Times pageLowerBound on a full 4 KB SST page with every kernel the CPU
+    supports and prints the ns/op and the speedup over the scalar kernel.
+*/
+void measurePageSearchKernels()
+{
+    std::vector<long> page(PAGE_SIZE / sizeof(long));
+    for (size_t i = 0; i < MAX_PAIRS; ++i)
+    {
+        page[i * 2] = i * 2 + 1;
+        page[i * 2 + 1] = i;
+    }
+
+    std::mt19937 gen(443);
+    std::uniform_int_distribution<long> dist(0, MAX_PAIRS * 2);
+    std::vector<long> queries(1 << 20);
+    for (long &query : queries)
+    {
+        query = dist(gen);
+    }
+
+    SearchKernel detected_kernel = getPageSearchKernel();
+    double scalar_ns = 0;
+    for (SearchKernel kernel : {SearchKernel::SCALAR, SearchKernel::AVX2, SearchKernel::AVX512})
+    {
+        if (!setPageSearchKernel(kernel))
+        {
+            continue;
+        }
+        long checksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (long query : queries)
+        {
+            checksum += pageLowerBound(page.data(), MAX_PAIRS, 2, query);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / queries.size();
+        if (kernel == SearchKernel::SCALAR)
+        {
+            scalar_ns = ns;
+        }
+        std::cout << getPageSearchKernelName(kernel) << " page search: " << ns << " ns/op (" << scalar_ns / ns << "x over scalar, checksum " << checksum << ")." << std::endl;
+    }
+    setPageSearchKernel(detected_kernel);
+}
+
+// Measures the Binary Search and B-Tree get throughput of the LSM tree with the current page search kernel
+std::pair<double, double> measureGetThroughput(LSMTree *lsm_tree, BufferPool &buffer_pool, const std::vector<long> &query_keys, size_t query_count)
+{
+    double binary_throughput = measureThroughput([&]()
+                                                 {
+        for (long key : query_keys) {
+            lsm_tree->get(key, &buffer_pool, false);
+        } }, query_count);
+    double btree_throughput = measureThroughput([&]()
+                                                {
+        for (long key : query_keys) {
+            lsm_tree->get(key, &buffer_pool, true);
+        } }, query_count);
+    return {binary_throughput, btree_throughput};
+}
+
+/*
+    Takes the page size of the SSTs in KB as an optional argument (4 by default) so that
+    the experiment can be swept over page sizes, e.g. "./experiment1 64". The results of a
+    larger page size go to binary_vs_btree_results_<size>kb.csv.
+*/
+int main(int argc, char *argv[]) {
+    if (argc > 1)
+    {
+        page_size = std::stoul(argv[1]) * 1024;
+        if (!isValidPageSize(page_size))
+        {
+            std::cerr << "Error: unsupported page size - " << argv[1] << " KB" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Measuring the page search kernels..." << std::endl;
+    measurePageSearchKernels();
+
+    const std::string output_file = page_size == PAGE_SIZE ? "./../experiments/binary_vs_btree_results.csv"
+                                                           : "./../experiments/binary_vs_btree_results_" + std::to_string(page_size / 1024) + "kb.csv";
     std::ofstream ofs(output_file);
-    ofs << "Data Size (MB),Binary Search Throughput (queries/sec),B-Tree Throughput (queries/sec)\n";
+    ofs << "Data Size (MB),Binary Search Throughput (queries/sec),B-Tree Throughput (queries/sec),Scalar Binary Search Throughput (queries/sec),Scalar B-Tree Throughput (queries/sec),Interpolation Search Throughput (queries/sec),Binary Search Page Reads per Get,Interpolation Search Page Reads per Get,B-Tree Page Reads per Get\n";
     ofs.close();
 
     std::string filepath = DATA_FILE_PATH + "experiment_binary_search_vs_btree";
@@ -250,8 +337,12 @@ int main() {
         std::cout << "Function \"generateRandomQueryKeys\" took " << query_key_generation_time << " seconds to complete.\n"
                   << std::endl;
 
+        // Every query_count round gets all of the query keys
+        double num_gets = static_cast<double>(query_count) * query_keys.size();
+
         // Measure Binary Search Throughput
         std::cout << "Measuring Binary Search Throughput..." << std::endl;
+        resetPageReads();
         auto [binary_throughput, binary_throughput_time] = measureExecutionTime("measureBinarySearchThroughput", [&]()
                                                                                 { return measureThroughput([&]()
                                                                                                            {
@@ -263,9 +354,29 @@ int main() {
         std::cout << "Finished Measuring Binary Search Throughput." << std::endl;
         std::cout << "Function \"measureBinarySearchThroughput\" took " << binary_throughput_time << " seconds to complete.\n"
                   << std::endl;
+        double binary_page_reads = getPageReads() / num_gets;
+
+        // Measure Interpolation Search Throughput
+        std::cout << "Measuring Interpolation Search Throughput..." << std::endl;
+        lsm_tree->setSSTSearchMode(SSTSearchMode::INTERPOLATION);
+        resetPageReads();
+        auto [interpolation_throughput, interpolation_throughput_time] = measureExecutionTime("measureInterpolationSearchThroughput", [&]()
+                                                                                              { return measureThroughput([&]()
+                                                                                                                         {
+                for (long key : query_keys) {
+                    lsm_tree->get(key, &buffer_pool, false);
+                }
+            }, query_count);
+        });
+        double interpolation_page_reads = getPageReads() / num_gets;
+        lsm_tree->setSSTSearchMode(SSTSearchMode::BINARY);
+        std::cout << "Finished Measuring Interpolation Search Throughput." << std::endl;
+        std::cout << "Function \"measureInterpolationSearchThroughput\" took " << interpolation_throughput_time << " seconds to complete.\n"
+                  << std::endl;
 
         // Measure B-Tree Throughput
         std::cout << "Measuring B-Tree Throughput..." << std::endl;
+        resetPageReads();
         auto [btree_throughput, btree_throughput_time] = measureExecutionTime("measureBTreeThroughput", [&]()
                                                                               { return measureThroughput([&]()
                                                                                                          {
@@ -277,10 +388,25 @@ int main() {
         std::cout << "Finished Measuring B-Tree Throughput..." << std::endl;
         std::cout << "Function \"measureBTreeThroughput\" took " << btree_throughput_time << " seconds to complete.\n"
                   << std::endl;
+        double btree_page_reads = getPageReads() / num_gets;
+        std::cout << "Page reads per get: Binary Search " << binary_page_reads << ", Interpolation Search " << interpolation_page_reads
+                  << ", B-Tree " << btree_page_reads << ".\n"
+                  << std::endl;
+
+        // Measure both again with the scalar page search to report the speedup of the SIMD kernel
+        std::cout << "Measuring Binary Search and B-Tree Throughput with the scalar page search..." << std::endl;
+        SearchKernel detected_kernel = getPageSearchKernel();
+        setPageSearchKernel(SearchKernel::SCALAR);
+        auto [scalar_binary_throughput, scalar_btree_throughput] = measureGetThroughput(lsm_tree, buffer_pool, query_keys, query_count);
+        setPageSearchKernel(detected_kernel);
+        std::cout << getPageSearchKernelName(detected_kernel) << " speedup: Binary Search " << binary_throughput / scalar_binary_throughput
+                  << "x, B-Tree " << btree_throughput / scalar_btree_throughput << "x.\n"
+                  << std::endl;
 
         // Record results
         ofs.open(output_file, std::ios::app);
-        ofs << data_size / 1024 << "," << binary_throughput << "," << btree_throughput << "\n";
+        ofs << data_size / 1024 << "," << binary_throughput << "," << btree_throughput << "," << scalar_binary_throughput << "," << scalar_btree_throughput << ","
+            << interpolation_throughput << "," << binary_page_reads << "," << interpolation_page_reads << "," << btree_page_reads << "\n";
         ofs.close();
 
         data_size *= 2;
@@ -0,0 +1,133 @@
+#include "block_codec.h"
+#include "sst.h"
+#include "checksum.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of pairs in each SST (64 MB of plain pages)
+long NUM_PAIRS = 64 * MEGABYTE / ENTRY_SIZE;
+
+// Number of random gets measured for every codec
+long NUM_GETS = 20000;
+
+// Number of times the whole SST is read for every scan measurement
+int NUM_SCAN_PASSES = 3;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+/*
+    Measures the block compression of SST data pages. For every codec built in
+    (and no compression), an SST of increasing keys with small random gaps and
+    values is written, then read back with full scans (like a compaction) and
+    with random gets through the fence pointers (decompressing a page per get,
+    as no buffer pool is given). The size of the file and the time of each
+    phase are reported.
+*/
+int main()
+{
+    std::string filepath = DATA_FILE_PATH + "compression";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_compressed.bin";
+
+    std::mt19937_64 gen(443);
+    std::uniform_int_distribution<long> gap(1, 64);
+    std::uniform_int_distribution<long> value(0, 1L << 20);
+    std::vector<std::pair<long, long>> pairs(NUM_PAIRS);
+    long key = 0;
+    for (std::pair<long, long> &pair : pairs)
+    {
+        key += gap(gen);
+        pair = {key, value(gen)};
+    }
+    std::uniform_int_distribution<long> position(0, NUM_PAIRS - 1);
+    std::vector<long> get_keys(NUM_GETS);
+    for (long &get_key : get_keys)
+    {
+        get_key = pairs[position(gen)].first;
+    }
+
+    std::ofstream file("./../experiments/block_compression.csv", std::ios::out);
+    file << "Codec,File Size (MB),Compression Ratio,Write (s),Scan (s),Get Latency (us)\n";
+
+    double plain_size = 0;
+    for (CompressionType type : {CompressionType::NONE, CompressionType::LZ, CompressionType::LZ_HIGH, CompressionType::LZ4, CompressionType::ZSTD})
+    {
+        if (!isCompressionSupported(type))
+        {
+            std::cout << getCompressionName(type) << " was not built in." << std::endl;
+            continue;
+        }
+
+        std::filesystem::remove(sst_filename);
+        bool is_written = false;
+        SSTMetadata metadata;
+        double write_seconds = measureSeconds([&]()
+                                              {
+            SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, DEFAULT_PAGE_ENCODING, type);
+            for (const std::pair<long, long> &pair : pairs)
+            {
+                writer.put(pair.first, pair.second);
+            }
+            is_written = writer.finish();
+            metadata = writer.getMetadata(); });
+        SSTFooter footer;
+        if (!is_written || !readSSTFooter(sst_filename, footer))
+        {
+            std::cerr << "Error: Could not write the SST." << std::endl;
+            return 1;
+        }
+        double file_size = static_cast<double>(std::filesystem::file_size(sst_filename)) / MEGABYTE;
+        if (type == CompressionType::NONE)
+        {
+            plain_size = file_size;
+        }
+
+        long checksum = 0;
+        double scan_seconds = measureSeconds([&]()
+                                             {
+            for (int pass = 0; pass < NUM_SCAN_PASSES; ++pass)
+            {
+                for (SSTIterator iterator(sst_filename); iterator.valid(); iterator.next())
+                {
+                    checksum += iterator.value();
+                }
+            } }) / NUM_SCAN_PASSES;
+
+        double get_seconds = measureSeconds([&]()
+                                            {
+            for (long get_key : get_keys)
+            {
+                NodeFileOffset *found = fencePointerSearch(sst_filename, metadata, get_key, nullptr);
+                checksum += found != nullptr ? found->node->value : 0;
+                delete found;
+            } });
+        if (checksum == 0)
+        {
+            std::cerr << "Error: No pairs were read." << std::endl;
+        }
+        double get_latency = get_seconds / NUM_GETS * 1e6;
+
+        std::cout << getCompressionName(type) << ": " << file_size << " MB (" << plain_size / file_size << "x), write " << write_seconds << " s, scan "
+                  << scan_seconds << " s, get " << get_latency << " us." << std::endl;
+        file << getCompressionName(type) << "," << file_size << "," << plain_size / file_size << "," << write_seconds << "," << scan_seconds << "," << get_latency << "\n";
+    }
+
+    file.close();
+    std::filesystem::remove(sst_filename);
+    removeChecksumFile(sst_filename);
+    std::filesystem::remove(filepath);
+    return 0;
+}
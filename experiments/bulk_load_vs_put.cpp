@@ -0,0 +1,159 @@
+#include "lsm_tree.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+
+// 1 MB = 1024 KB = 1048576 bytes which can hold 65536 key-value long pairs
+int CURR_MEMTABLE_SIZE = 1048576 / ENTRY_SIZE;
+
+int BYTES_IN_MB = 1048576;
+
+std::vector<std::pair<long, long>> generate_random_pairs(size_t count)
+{
+    std::vector<std::pair<long, long>> pairs;
+    pairs.reserve(count); // Reserve memory for efficiency
+
+    // Random number generation
+    std::random_device rd;                                 // Seed
+    std::mt19937_64 gen(rd());                             // 64-bit Mersenne Twister engine
+    std::uniform_int_distribution<long> dist(0, LONG_MAX); // Generate positive longs
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        pairs.emplace_back(dist(gen), dist(gen));
+    }
+
+    return pairs;
+}
+
+void write_to_csv(const std::string &filename, const std::vector<std::pair<int, double>> &data)
+{
+    std::ofstream file(filename, std::ios::out);
+    if (!file)
+    {
+        std::cerr << "Error: Could not open file " << filename << '\n';
+        return;
+    }
+
+    // Write header row
+    file << "Key,Value\n";
+
+    // Write data rows
+    for (const auto &pair : data)
+    {
+        file << pair.first << "," << pair.second << "\n";
+    }
+    std::cout << "Data successfully written to " << filename << '\n';
+}
+
+/*
+    Compares loading the same random key-value pairs through LSMTree::put,
+    through LSMTree::ingestFile (external sort of an unsorted binary file) and
+    through LSMTree::bulkLoad. The bulk load time includes sorting the pairs
+    in memory (keeping the last value written for duplicate keys), since its
+    input must be sorted.
+*/
+int main()
+{
+    std::vector<int> x_values_mb = {1, 2, 4, 8, 16, 32, 64};
+    std::vector<std::pair<int, double>> put_latency;
+    std::vector<std::pair<int, double>> ingest_latency;
+    std::vector<std::pair<int, double>> bulk_load_latency;
+
+    for (auto &x_value : x_values_mb)
+    {
+        size_t num_pairs = x_value * BYTES_IN_MB / ENTRY_SIZE;
+        std::vector<std::pair<long, long>> random_pairs = generate_random_pairs(num_pairs);
+
+        // Load through the memtable, flushes and compactions
+        std::string put_database = "exp_put_" + getCurrentTimestamp();
+        Memtable *memtable = dbOpen(put_database, CURR_MEMTABLE_SIZE);
+        LSMTree *lsm_tree = new LSMTree(CURR_MEMTABLE_SIZE, put_database, memtable);
+
+        auto put_start_time = std::chrono::high_resolution_clock::now();
+        for (const std::pair<long, long> &pair : random_pairs)
+        {
+            lsm_tree->put(pair.first, pair.second);
+        }
+        auto put_end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> put_elapsed_time = put_end_time - put_start_time;
+        put_latency.emplace_back(x_value, put_elapsed_time.count());
+        delete lsm_tree;
+        dbClear(put_database);
+        std::filesystem::remove(DATA_FILE_PATH + put_database);
+
+        // Write the same pairs to an unsorted binary file, then external sort it straight into SSTs
+        std::string ingest_database = "exp_ingest_" + getCurrentTimestamp();
+        memtable = dbOpen(ingest_database, CURR_MEMTABLE_SIZE);
+        lsm_tree = new LSMTree(CURR_MEMTABLE_SIZE, ingest_database, memtable);
+        std::string ingest_filename = DATA_FILE_PATH + ingest_database + "/unsorted.bin";
+        std::ofstream out(ingest_filename, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(random_pairs.data()), random_pairs.size() * ENTRY_SIZE);
+        out.close();
+
+        auto ingest_start_time = std::chrono::high_resolution_clock::now();
+        bool is_ingest_success = lsm_tree->ingestFile(ingest_filename);
+        auto ingest_end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> ingest_elapsed_time = ingest_end_time - ingest_start_time;
+        ingest_latency.emplace_back(x_value, ingest_elapsed_time.count());
+        delete lsm_tree;
+        dbClear(ingest_database);
+        std::filesystem::remove(DATA_FILE_PATH + ingest_database);
+
+        if (!is_ingest_success)
+        {
+            std::cerr << "Ingest of " << x_value << "MB failed." << std::endl;
+        }
+
+        // Sort the same pairs and write them straight into SSTs
+        std::string bulk_database = "exp_bulk_" + getCurrentTimestamp();
+        memtable = dbOpen(bulk_database, CURR_MEMTABLE_SIZE);
+        lsm_tree = new LSMTree(CURR_MEMTABLE_SIZE, bulk_database, memtable);
+
+        auto bulk_start_time = std::chrono::high_resolution_clock::now();
+        std::stable_sort(random_pairs.begin(), random_pairs.end(),
+                         [](const std::pair<long, long> &a, const std::pair<long, long> &b)
+                         { return a.first < b.first; });
+        std::vector<std::pair<long, long>> sorted_pairs;
+        sorted_pairs.reserve(random_pairs.size());
+        for (const std::pair<long, long> &pair : random_pairs)
+        {
+            if (!sorted_pairs.empty() && sorted_pairs.back().first == pair.first)
+            {
+                sorted_pairs.back().second = pair.second;
+            }
+            else
+            {
+                sorted_pairs.push_back(pair);
+            }
+        }
+        bool is_success = lsm_tree->bulkLoad(sorted_pairs);
+        auto bulk_end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> bulk_elapsed_time = bulk_end_time - bulk_start_time;
+        bulk_load_latency.emplace_back(x_value, bulk_elapsed_time.count());
+        delete lsm_tree;
+        dbClear(bulk_database);
+        std::filesystem::remove(DATA_FILE_PATH + bulk_database);
+
+        if (!is_success)
+        {
+            std::cerr << "Bulk load of " << x_value << "MB failed." << std::endl;
+        }
+        std::cout << x_value << "MB of puts took " << put_elapsed_time.count() << " seconds, external sort ingest took "
+                  << ingest_elapsed_time.count() << " seconds (" << put_elapsed_time.count() / ingest_elapsed_time.count() << "x faster), bulk load took "
+                  << bulk_elapsed_time.count() << " seconds (" << put_elapsed_time.count() / bulk_elapsed_time.count() << "x faster)." << std::endl;
+    }
+
+    // Write to CSV
+    write_to_csv("./../experiments/bulkloadput.csv", put_latency);
+    write_to_csv("./../experiments/bulkloadingest.csv", ingest_latency);
+    write_to_csv("./../experiments/bulkloadbulk.csv", bulk_load_latency);
+
+    return 0;
+}
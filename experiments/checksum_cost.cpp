@@ -0,0 +1,166 @@
+#include "checksum.h"
+#include "sst.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of pairs in the SST (64 MB)
+long NUM_PAIRS = 64 * MEGABYTE / ENTRY_SIZE;
+
+// Number of times the whole SST is read for every measurement
+int NUM_READ_PASSES = 3;
+
+// Number of gets measured when the SST is mapped
+int NUM_MAPPED_QUERIES = 500000;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+// Writes the SST and returns the time (seconds) taken.
+double writeSST(const std::string &sst_filename, const std::string &btree_filename, const std::string &bloom_filename, SSTMetadata &metadata)
+{
+    std::filesystem::remove(sst_filename);
+    std::filesystem::remove(btree_filename);
+    return measureSeconds([&]()
+                          {
+        SSTWriter writer(sst_filename, btree_filename, bloom_filename);
+        for (long i = 0; i < NUM_PAIRS; ++i)
+        {
+            writer.put(i * 2, i * 20);
+        }
+        if (!writer.finish())
+        {
+            std::cerr << "Error: Could not write the SST." << std::endl;
+        }
+        metadata = writer.getMetadata(); });
+}
+
+// Reads the whole SST like a compaction does and returns the time (seconds) taken per pass.
+double readSST(const std::string &sst_filename)
+{
+    long checksum = 0;
+    double seconds = measureSeconds([&]()
+                                    {
+        for (int pass = 0; pass < NUM_READ_PASSES; ++pass)
+        {
+            SSTIterator iterator(sst_filename);
+            for (; iterator.valid(); iterator.next())
+            {
+                checksum += iterator.value();
+            }
+            if (iterator.hasError())
+            {
+                std::cerr << "Error: Could not read the SST." << std::endl;
+            }
+        } });
+    if (checksum == 0)
+    {
+        std::cerr << "Error: No pairs were read." << std::endl;
+    }
+    return seconds / NUM_READ_PASSES;
+}
+
+/*
+    Measures the cost of the CRC32C page checksums: the throughput of the
+    hardware (SSE4.2) and software kernels, the time per GB of writing an SST
+    (every page written is checksummed), of reading it sequentially from disk
+    like a compaction with checksums OFF and ON, and of gets on a mapped SST
+    with checksums OFF and PARANOID (where every mapped page read is checked).
+*/
+int main()
+{
+    std::string filepath = DATA_FILE_PATH + "checksum";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_checksum.bin";
+    std::string btree_filename = filepath + "/btree_checksum.bin";
+    std::string bloom_filename = filepath + "/bloom_checksum.bin";
+    double gigabytes = static_cast<double>(NUM_PAIRS * ENTRY_SIZE) / GIGABYTE;
+
+    std::ofstream file("./../experiments/checksum_cost.csv", std::ios::out);
+    file << "Kernel,CRC32C (s/GB),Write (s/GB),Read Checksums Off (s/GB),Read Checksums On (s/GB),"
+         << "Mapped Get Checksums Off (ns),Mapped Get Checksums Paranoid (ns)\n";
+
+    std::vector<char> buffer(NUM_PAIRS * ENTRY_SIZE);
+    std::mt19937_64 gen(443);
+    for (char &byte : buffer)
+    {
+        byte = static_cast<char>(gen());
+    }
+
+    std::vector<long> queries(NUM_MAPPED_QUERIES);
+    std::uniform_int_distribution<long> dist(0, NUM_PAIRS - 1);
+    for (long &query : queries)
+    {
+        query = dist(gen) * 2;
+    }
+
+    for (bool use_hardware : {true, false})
+    {
+        if (!setHardwareCRC32C(use_hardware))
+        {
+            std::cout << "The CPU does not support the SSE4.2 crc32 instruction." << std::endl;
+            continue;
+        }
+        const char *kernel = use_hardware ? "Hardware" : "Software";
+
+        uint32_t crc = 0;
+        double crc_seconds = measureSeconds([&]()
+                                            { crc = crc32c(buffer.data(), buffer.size(), crc); });
+
+        SSTMetadata metadata;
+        double write_seconds = writeSST(sst_filename, btree_filename, bloom_filename, metadata);
+
+        setChecksumMode(ChecksumMode::OFF);
+        double read_off_seconds = readSST(sst_filename);
+        setChecksumMode(ChecksumMode::ON);
+        double read_on_seconds = readSST(sst_filename);
+
+        MappedFile sst_map(sst_filename);
+        double mapped_ns[2];
+        for (ChecksumMode mode : {ChecksumMode::OFF, ChecksumMode::PARANOID})
+        {
+            setChecksumMode(mode);
+            long num_found = 0;
+            double seconds = measureSeconds([&]()
+                                            {
+                for (long key : queries)
+                {
+                    NodeFileOffset *ret = fencePointerSearch(sst_filename, metadata, key, nullptr, &sst_map);
+                    num_found += ret != nullptr;
+                    delete ret;
+                } });
+            if (num_found != static_cast<long>(queries.size()))
+            {
+                std::cerr << "Error: " << queries.size() - num_found << " keys were not found." << std::endl;
+            }
+            mapped_ns[mode == ChecksumMode::PARANOID] = seconds * 1e9 / queries.size();
+        }
+        setChecksumMode(ChecksumMode::ON);
+
+        std::cout << kernel << " CRC32C (checksum " << crc << "):\n"
+                  << "  Checksums: " << crc_seconds / gigabytes << " s/GB (" << gigabytes / crc_seconds << " GB/s).\n"
+                  << "  Write: " << write_seconds / gigabytes << " s/GB, of which checksums are "
+                  << 100 * crc_seconds / write_seconds << "%.\n"
+                  << "  Read from disk: " << read_off_seconds / gigabytes << " s/GB with checksums off, "
+                  << read_on_seconds / gigabytes << " s/GB with checksums on.\n"
+                  << "  Mapped get: " << mapped_ns[0] << " ns with checksums off, " << mapped_ns[1] << " ns in paranoid mode." << std::endl;
+        file << kernel << "," << crc_seconds / gigabytes << "," << write_seconds / gigabytes << "," << read_off_seconds / gigabytes << ","
+             << read_on_seconds / gigabytes << "," << mapped_ns[0] << "," << mapped_ns[1] << "\n";
+    }
+
+    setHardwareCRC32C(isHardwareCRC32CSupported());
+    std::filesystem::remove_all(filepath);
+    std::cout << "Data successfully written to ./../experiments/checksum_cost.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "page_search.h"
+#include "sst.h"
+#include "checksum.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of pages searched by the in-page measurements (64 MB, so most probes miss the CPU caches)
+long NUM_PAGES = 64 * MEGABYTE / PAGE_SIZE;
+
+// Number of searches measured for every layout and kernel
+long NUM_SEARCHES = 2000000;
+
+// Number of random gets measured for every SST
+long NUM_GETS = 200000;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+/*
+    Measures the columnar layout of SST data pages against the interleaved one.
+    First the in-page lower bound search alone, over pages filled with
+    interleaved (stride 2) or contiguous (stride 1) keys, with every kernel the
+    CPU supports. Then random gets on a mapped plain and columnar SST through
+    the fence pointers, where every get searches a single data page.
+*/
+int main()
+{
+    std::string filepath = DATA_FILE_PATH + "columnar";
+    std::filesystem::create_directories(filepath);
+
+    std::ofstream file("./../experiments/columnar_page_search.csv", std::ios::out);
+    file << "Benchmark,Kernel,Plain (M searches/s),Columnar (M searches/s)\n";
+
+    // The keys of page p are p * MAX_PAIRS * 2 + 2 * i, in both layouts
+    void *pages[2] = {nullptr, nullptr};
+    for (void *&pages_layout : pages)
+    {
+        if (posix_memalign(&pages_layout, PAGE_SIZE, NUM_PAGES * PAGE_SIZE) != 0)
+        {
+            std::cerr << "Error: Memory alignment allocation failed." << std::endl;
+            return 1;
+        }
+    }
+    for (long page = 0; page < NUM_PAGES; ++page)
+    {
+        long *plain = static_cast<long *>(pages[0]) + page * (PAGE_SIZE / sizeof(long));
+        long *columnar = static_cast<long *>(pages[1]) + page * (PAGE_SIZE / sizeof(long));
+        for (long i = 0; i < static_cast<long>(MAX_PAIRS); ++i)
+        {
+            long key = page * MAX_PAIRS * 2 + 2 * i;
+            plain[i * 2] = key;
+            plain[i * 2 + 1] = key * 10;
+            columnar[i] = key;
+            columnar[MAX_PAIRS + i] = key * 10;
+        }
+    }
+
+    std::mt19937_64 gen(443);
+    std::uniform_int_distribution<long> random_key(0, NUM_PAGES * MAX_PAIRS * 2 - 1);
+    std::vector<long> search_keys(NUM_SEARCHES);
+    for (long &key : search_keys)
+    {
+        key = random_key(gen);
+    }
+
+    SearchKernel was_kernel = getPageSearchKernel();
+    for (SearchKernel kernel : {SearchKernel::SCALAR, SearchKernel::AVX2, SearchKernel::AVX512})
+    {
+        if (!setPageSearchKernel(kernel))
+        {
+            std::cout << "The CPU does not support the " << getPageSearchKernelName(kernel) << " kernel." << std::endl;
+            continue;
+        }
+        double rates[2] = {0, 0};
+        for (int is_columnar = 0; is_columnar < 2; ++is_columnar)
+        {
+            long stride = is_columnar ? 1 : 2;
+            long checksum = 0;
+            double seconds = measureSeconds([&]()
+                                            {
+                for (long key : search_keys)
+                {
+                    long page = key / (MAX_PAIRS * 2);
+                    const long *keys = static_cast<const long *>(pages[is_columnar]) + page * (PAGE_SIZE / sizeof(long));
+                    checksum += pageLowerBound(keys, MAX_PAIRS, stride, key);
+                } });
+            if (checksum == 0)
+            {
+                std::cerr << "Error: No keys were searched." << std::endl;
+            }
+            rates[is_columnar] = NUM_SEARCHES / seconds / 1e6;
+        }
+        std::cout << "In-page search (" << getPageSearchKernelName(kernel) << "): " << rates[0] << " M/s plain, " << rates[1] << " M/s columnar." << std::endl;
+        file << "In-page search," << getPageSearchKernelName(kernel) << "," << rates[0] << "," << rates[1] << "\n";
+    }
+    setPageSearchKernel(was_kernel);
+    free(pages[0]);
+    free(pages[1]);
+
+    // Random gets through the fence pointers of a mapped SST of each layout
+    double rates[2] = {0, 0};
+    for (PageEncoding encoding : {PageEncoding::PLAIN, PageEncoding::COLUMNAR})
+    {
+        std::string sst_filename = filepath + "/sst_columnar.bin";
+        std::filesystem::remove(sst_filename);
+        SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, encoding);
+        for (long i = 0; i < NUM_PAGES * static_cast<long>(MAX_PAIRS); ++i)
+        {
+            writer.put(i * 2, i);
+        }
+        if (!writer.finish())
+        {
+            std::cerr << "Error: Could not write the SST." << std::endl;
+            return 1;
+        }
+        SSTMetadata metadata = writer.getMetadata();
+
+        MappedFile sst_map(sst_filename);
+        long checksum = 0;
+        double seconds = measureSeconds([&]()
+                                        {
+            for (long i = 0; i < NUM_GETS; ++i)
+            {
+                NodeFileOffset *found = fencePointerSearch(sst_filename, metadata, search_keys[i] & ~1L, nullptr, &sst_map);
+                checksum += found != nullptr ? found->node->value : 0;
+                delete found;
+            } });
+        if (checksum == 0)
+        {
+            std::cerr << "Error: No keys were found." << std::endl;
+        }
+        rates[encoding == PageEncoding::COLUMNAR] = NUM_GETS / seconds / 1e6;
+        std::filesystem::remove(sst_filename);
+        removeChecksumFile(sst_filename);
+    }
+    std::cout << "Mapped SST gets: " << rates[0] << " M/s plain, " << rates[1] << " M/s columnar." << std::endl;
+    file << "Mapped SST get," << getPageSearchKernelName(getPageSearchKernel()) << "," << rates[0] << "," << rates[1] << "\n";
+
+    std::filesystem::remove_all(filepath);
+    std::cout << "Data successfully written to ./../experiments/columnar_page_search.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "lsm_tree.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <atomic>
+#include <thread>
+
+// Number of keys put into the LSM tree
+long NUM_KEYS = 1000000;
+
+// Number of gets (or scans of SCAN_KEYS keys) made by every reader thread
+long NUM_GETS = 100000;
+long NUM_SCANS = 2000;
+long SCAN_KEYS = 100;
+
+/*
+    Runs the given number of reader threads at once, each with its own buffer
+    pool, making random gets (or scans if is_scan is set) of the tree. If
+    is_writing is set, then a writer thread overwrites random keys (flushing
+    and compacting the tree) until the readers are done. Returns the number of
+    operations per second of all readers together.
+*/
+double measureReaders(LSMTree *lsm_tree, int num_threads, bool is_scan, bool is_writing)
+{
+    std::atomic<bool> is_reading(true);
+    std::future<void> writer;
+    if (is_writing)
+    {
+        writer = std::async(std::launch::async, [&]()
+                            {
+            std::mt19937_64 gen(448);
+            std::uniform_int_distribution<long> key_index(0, NUM_KEYS - 1);
+            while (is_reading)
+            {
+                long key = key_index(gen);
+                lsm_tree->put(key, key + 2);
+            } });
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::vector<std::future<void>> readers;
+    for (int thread = 0; thread < num_threads; ++thread)
+    {
+        readers.push_back(std::async(std::launch::async, [&, thread]()
+                                     {
+            BufferPool buffer_pool(BUFFER_POOL_SIZE);
+            std::mt19937_64 gen(449 + thread);
+            std::uniform_int_distribution<long> key_index(0, NUM_KEYS - SCAN_KEYS);
+            long num_ops = is_scan ? NUM_SCANS : NUM_GETS;
+            for (long i = 0; i < num_ops; ++i)
+            {
+                long key = key_index(gen);
+                if (is_scan)
+                {
+                    delete[] lsm_tree->scan(key, key + SCAN_KEYS - 1, &buffer_pool, true).first;
+                }
+                else
+                {
+                    delete lsm_tree->get(key, &buffer_pool, true);
+                }
+            } }));
+    }
+    for (std::future<void> &reader : readers)
+    {
+        reader.get();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    is_reading = false;
+    if (is_writing)
+    {
+        writer.get();
+    }
+    return num_threads * (is_scan ? NUM_SCANS : NUM_GETS) / elapsed.count();
+}
+
+/*
+    Measures the throughput of gets and scans of an LSM tree of NUM_KEYS keys
+    (with 1 MB memtables) from 1 to 2 * hardware_concurrency reader threads,
+    with and without a writer running at the same time. Readers take the
+    current version of the tree instead of a lock, so their throughput should
+    grow with the number of threads up to the number of cores.
+*/
+int main()
+{
+    std::ofstream file("./../experiments/concurrent_reads.csv", std::ios::out);
+    file << "Operation,Writer,Threads,Throughput (K ops/s),Speedup\n";
+
+    std::string database = "exp_concurrent_reads";
+    Memtable *memtable = dbOpen(database, MEMTABLE_SIZE / ENTRY_SIZE);
+    LSMTree *lsm_tree = new LSMTree(MEMTABLE_SIZE / ENTRY_SIZE, database, memtable);
+    std::vector<long> keys(NUM_KEYS);
+    for (long i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(448));
+    for (long key : keys)
+    {
+        lsm_tree->put(key, key + 1);
+    }
+
+    int max_threads = std::max(2 * static_cast<int>(std::thread::hardware_concurrency()), 4);
+    for (bool is_scan : {false, true})
+    {
+        for (bool is_writing : {false, true})
+        {
+            double single_thread_throughput = 0;
+            for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+            {
+                double throughput = measureReaders(lsm_tree, num_threads, is_scan, is_writing);
+                single_thread_throughput = num_threads == 1 ? throughput : single_thread_throughput;
+                std::cout << (is_scan ? "Scan" : "Get") << (is_writing ? " with a writer" : "") << ", " << num_threads << " threads: " << throughput / 1000
+                          << " K ops/s (" << throughput / single_thread_throughput << "x)." << std::endl;
+                file << (is_scan ? "Scan" : "Get") << "," << (is_writing ? "Yes" : "No") << "," << num_threads << "," << throughput / 1000 << ","
+                     << throughput / single_thread_throughput << "\n";
+            }
+        }
+    }
+
+    file.close();
+    delete lsm_tree;
+    dbClear(database);
+    std::cout << "Data successfully written to ./../experiments/concurrent_reads.csv" << std::endl;
+    return 0;
+}
@@ -1,3 +1,4 @@
+import os
 import pandas as pd
 import matplotlib.pyplot as plt
 
@@ -17,6 +18,11 @@ for operation in operations:
     plt.figure(figsize=(8, 6))  # Optional: Adjust figure size
     plt.plot(range(len(x)), y, label="Memtable Size: 1 MB", marker='o', color='b')  # Line with points
 
+    # Gets and scans are also measured with the SSTs read through memory mappings
+    if operation != "put" and os.path.exists('step3' + operation + 'mmap.csv'):
+        mmap_data = pd.read_csv('step3' + operation + 'mmap.csv')
+        plt.plot(range(len(x)), 1 / mmap_data['Value'], label="Memtable Size: 1 MB (mmap)", marker='o', color='r')
+
     # Add labels, title, and legend
     plt.xlabel("Data Size")
     plt.ylabel("Throughput (MB/Sec)")
@@ -124,8 +124,16 @@ std::vector<std::pair<int, double>> combine_coordinates(
     return coordinates;
 }
 
-int main()
+/*
+    Takes the page size of the SSTs in KB as an optional argument (4 by default) so that
+    the experiment can be swept over page sizes, e.g. "./experiment2 16". The CSVs of a
+    larger page size are suffixed with it.
+*/
+int main(int argc, char *argv[])
 {
+    size_t page_size = argc > 1 ? std::stoul(argv[1]) * 1024 : PAGE_SIZE;
+    std::string csv_suffix = page_size == PAGE_SIZE ? "" : "_" + std::to_string(page_size / 1024) + "kb";
+
     // Generate the vector of random key-value pairs
     std::cerr << "Generating data: \n";
     std::vector<std::pair<long, long>> random_pairs = generate_random_pairs(TOTAL_PAIRS);
@@ -141,10 +149,16 @@ int main()
 
     // Create LSM tree
     LSMTree *lsm_tree = new LSMTree(CURR_MEMTABLE_SIZE, current_database, memtable);
+    if (!lsm_tree->setPageSize(page_size))
+    {
+        return 1;
+    }
     std::vector<int> x_values_mb = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
     std::vector<double> put_latency = {};
     std::vector<double> get_latency = {};
     std::vector<double> scan_latency = {};
+    std::vector<double> mmap_get_latency = {};
+    std::vector<double> mmap_scan_latency = {};
 
     int i = 0;
     for (auto &x_value : x_values_mb)
@@ -166,6 +180,10 @@ int main()
 
         std::cout << x_value << "MB of puts took " << put_elapsed_time.count() << " seconds." << std::endl;
 
+        // Report the memory used by the in-memory fence pointers of every SST
+        size_t fence_bytes = lsm_tree->getFencePointerMemory();
+        std::cout << "Fence pointers use " << fence_bytes << " bytes (" << fence_bytes / (x_value / 1024.0) / BYTES_IN_MB << " MB per GB of data)." << std::endl;
+
         // Uncomment for Random Get Keys
         std::vector<long> random_get_queries = generate_random_keys(GET_QUERIES_SIZE);
 
@@ -177,44 +195,57 @@ int main()
         // // Take the first query_count keys
         // std::vector<long> random_get_queries(all_keys.begin(), all_keys.begin() + GET_QUERIES_SIZE);
 
-        auto get_start_time = std::chrono::high_resolution_clock::now();
-        for (auto &key : random_get_queries)
-        {
-            lsm_tree->get(key, buffer_pool, with_btree);
-        }
-        auto get_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> get_elapsed_time = get_end_time - get_start_time;
-
-        get_latency.push_back(get_elapsed_time.count());
-        std::cout << "1MB of random gets took " << get_elapsed_time.count() << " seconds." << std::endl;
-
         std::vector<long> random_scan_queries = generate_random_keys(GET_QUERIES_SIZE);
 
-        auto scan_start_time = std::chrono::high_resolution_clock::now();
-        for (auto &key : random_scan_queries)
+        // Run the same gets and scans through the buffer pool and then through memory mappings of the SSTs
+        for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
         {
-            if (LONG_MAX - key < 1024)
+            bool is_mmap = read_mode == ReadMode::MMAP;
+            std::string mode_name = is_mmap ? " (mmap)" : " (buffer pool)";
+            lsm_tree->setReadMode(read_mode);
+
+            auto get_start_time = std::chrono::high_resolution_clock::now();
+            for (auto &key : random_get_queries)
             {
-                lsm_tree->scan(key - 1, key, buffer_pool, with_btree);
+                lsm_tree->get(key, buffer_pool, with_btree);
             }
-            else
+            auto get_end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> get_elapsed_time = get_end_time - get_start_time;
+
+            (is_mmap ? mmap_get_latency : get_latency).push_back(get_elapsed_time.count());
+            std::cout << "1MB of random gets" << mode_name << " took " << get_elapsed_time.count() << " seconds." << std::endl;
+
+            auto scan_start_time = std::chrono::high_resolution_clock::now();
+            for (auto &key : random_scan_queries)
             {
-                lsm_tree->scan(key, key + 1, buffer_pool, with_btree);
+                if (LONG_MAX - key < 1024)
+                {
+                    lsm_tree->scan(key - 1, key, buffer_pool, with_btree);
+                }
+                else
+                {
+                    lsm_tree->scan(key, key + 1, buffer_pool, with_btree);
+                }
             }
+            auto scan_end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> scan_elapsed_time = scan_end_time - scan_start_time;
+
+            (is_mmap ? mmap_scan_latency : scan_latency).push_back(scan_elapsed_time.count());
+            std::cout << "1MB of random scans" << mode_name << " took " << scan_elapsed_time.count() << " seconds." << std::endl;
         }
-        auto scan_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> scan_elapsed_time = scan_end_time - scan_start_time;
 
-        scan_latency.push_back(scan_elapsed_time.count());
-        std::cout << "1MB of random scans took " << scan_elapsed_time.count() << " seconds." << std::endl;
+        // Go back to the buffer pool for the next puts so that compactions do not keep mappings alive
+        lsm_tree->setReadMode(ReadMode::BUFFER_POOL);
     }
 
     std::cerr << "Done!\n";
 
     // Write to CSV
-    write_to_csv("./../experiments/step3put.csv", combine_coordinates(x_values_mb, put_latency));
-    write_to_csv("./../experiments/step3get.csv", combine_coordinates(x_values_mb, get_latency));
-    write_to_csv("./../experiments/step3scan.csv", combine_coordinates(x_values_mb, scan_latency));
+    write_to_csv("./../experiments/step3put" + csv_suffix + ".csv", combine_coordinates(x_values_mb, put_latency));
+    write_to_csv("./../experiments/step3get" + csv_suffix + ".csv", combine_coordinates(x_values_mb, get_latency));
+    write_to_csv("./../experiments/step3scan" + csv_suffix + ".csv", combine_coordinates(x_values_mb, scan_latency));
+    write_to_csv("./../experiments/step3getmmap" + csv_suffix + ".csv", combine_coordinates(x_values_mb, mmap_get_latency));
+    write_to_csv("./../experiments/step3scanmmap" + csv_suffix + ".csv", combine_coordinates(x_values_mb, mmap_scan_latency));
 
     return 0;
 }
\ No newline at end of file
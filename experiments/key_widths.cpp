@@ -0,0 +1,165 @@
+#include "typed_sst.h"
+#include "typed_lsm_tree.h"
+#include "page_search.h"
+#include "checksum.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of key-value pairs written into the SST of every type width
+long NUM_PAIRS = 4000000;
+
+// Number of random in-page searches measured for every type width and kernel
+long NUM_SEARCHES = 4000000;
+
+// Number of random gets measured on the SST of every type width
+long NUM_GETS = 200000;
+
+// Number of random key-value pairs put into the LSM tree of every type width (with a memtable of 65536 pairs)
+long NUM_TREE_PAIRS = 1000000;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+/*
+    Writes NUM_PAIRS pairs of the types into an SST, then measures the in-page
+    search of its first page with every kernel the CPU supports, random gets
+    through the buffer pool and random puts and gets through an LSM tree of the
+    types, and writes a row of the results per kernel.
+*/
+template <typename Key, typename Value>
+void measureWidth(const std::string &type_name, std::ofstream &file)
+{
+    std::string sst_filename = DATA_FILE_PATH + "key_widths/sst.bin";
+    const long max_pairs = PageLayout<Key, Value>::MAX_PAIRS;
+    TypedSSTWriter<Key, Value> writer(sst_filename);
+    double write_seconds = measureSeconds([&]()
+                                          {
+        for (long i = 0; i < NUM_PAIRS; ++i)
+        {
+            writer.put(static_cast<Key>(2 * i), static_cast<Value>(i));
+        }
+        writer.finish(); });
+    double sst_mb = static_cast<double>(std::filesystem::file_size(sst_filename)) / MEGABYTE;
+
+    TypedSSTReader<Key, Value> reader(sst_filename);
+    std::mt19937_64 gen(446);
+    std::uniform_int_distribution<long> position(0, NUM_PAIRS - 1);
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    long num_found = 0;
+    double get_seconds = measureSeconds([&]()
+                                        {
+        for (long i = 0; i < NUM_GETS; ++i)
+        {
+            Value value;
+            num_found += reader.get(static_cast<Key>(2 * position(gen)), value, buffer_pool) ? 1 : 0;
+        } });
+
+    // Random puts (flushed and compacted) and gets through the LSM tree of the types
+    TypedLSMTree<Key, Value> *lsm_tree = new TypedLSMTree<Key, Value>(MEGABYTE / ENTRY_SIZE, "key_widths");
+    std::uniform_int_distribution<long> tree_key(0, 1000000000);
+    std::vector<Key> tree_keys(NUM_TREE_PAIRS);
+    for (Key &tree_key_value : tree_keys)
+    {
+        tree_key_value = static_cast<Key>(tree_key(gen));
+    }
+    double tree_put_seconds = measureSeconds([&]()
+                                             {
+        for (long i = 0; i < NUM_TREE_PAIRS; ++i)
+        {
+            lsm_tree->put(tree_keys[i], static_cast<Value>(i));
+        } });
+    std::uniform_int_distribution<long> tree_position(0, NUM_TREE_PAIRS - 1);
+    double tree_get_seconds = measureSeconds([&]()
+                                             {
+        for (long i = 0; i < NUM_GETS; ++i)
+        {
+            Value value;
+            num_found += lsm_tree->get(tree_keys[tree_position(gen)], value, buffer_pool) ? 1 : 0;
+        } });
+    for (const std::vector<TypedSST<Key, Value>> &level : lsm_tree->getLevels())
+    {
+        for (const TypedSST<Key, Value> &sst : level)
+        {
+            std::filesystem::remove(sst.sst_filename);
+            removeChecksumFile(sst.sst_filename);
+        }
+    }
+    delete lsm_tree;
+    delete buffer_pool;
+
+    // The keys of a full page, searched in memory
+    std::vector<Key> keys(max_pairs);
+    for (long i = 0; i < max_pairs; ++i)
+    {
+        keys[i] = static_cast<Key>(2 * i);
+    }
+    std::vector<Key> queries(NUM_SEARCHES);
+    std::uniform_int_distribution<long> query(0, 2 * max_pairs);
+    for (Key &curr_query : queries)
+    {
+        curr_query = static_cast<Key>(query(gen));
+    }
+
+    SearchKernel detected_kernel = getPageSearchKernel();
+    for (SearchKernel kernel : {SearchKernel::SCALAR, SearchKernel::AVX2, SearchKernel::AVX512})
+    {
+        if (!setPageSearchKernel(kernel))
+        {
+            continue;
+        }
+        long checksum = 0;
+        double search_seconds = measureSeconds([&]()
+                                               {
+            for (Key curr_query : queries)
+            {
+                checksum += pageLowerBound(keys.data(), max_pairs, 1, curr_query);
+            } });
+        std::cout << type_name << " (" << max_pairs << " pairs/page, " << sst_mb << " MB): write " << NUM_PAIRS / write_seconds / 1000000 << " M pairs/s, "
+                  << getPageSearchKernelName(kernel) << " search " << NUM_SEARCHES / search_seconds / 1000000 << " M searches/s, get " << NUM_GETS / get_seconds / 1000
+                  << " K gets/s, tree put " << NUM_TREE_PAIRS / tree_put_seconds / 1000 << " K pairs/s, tree get " << NUM_GETS / tree_get_seconds / 1000
+                  << " K gets/s (" << num_found << " found, checksum " << checksum << ")." << std::endl;
+        file << type_name << "," << sizeof(Key) << "," << sizeof(Value) << "," << max_pairs << "," << sst_mb << "," << NUM_PAIRS / write_seconds / 1000000 << ","
+             << getPageSearchKernelName(kernel) << "," << NUM_SEARCHES / search_seconds / 1000000 << "," << NUM_GETS / get_seconds / 1000 << ","
+             << NUM_TREE_PAIRS / tree_put_seconds / 1000 << "," << NUM_GETS / tree_get_seconds / 1000 << "\n";
+    }
+    setPageSearchKernel(detected_kernel);
+
+    std::filesystem::remove(sst_filename);
+    removeChecksumFile(sst_filename);
+}
+
+/*
+    Compares the page layouts of several key and value widths: the pairs a page
+    holds, the size of an SST of the same pairs, the write throughput, the
+    in-page search throughput with every kernel, the throughput of random
+    gets on the SST, and the throughput of random puts and gets through an LSM
+    tree of the types.
+*/
+int main()
+{
+    std::filesystem::create_directories(DATA_FILE_PATH + "key_widths");
+    std::ofstream file("./../experiments/key_widths.csv", std::ios::out);
+    file << "Types,Key Bytes,Value Bytes,Pairs per Page,SST MB,Write (M pairs/s),Kernel,Page Search (M searches/s),Get (K gets/s),Tree Put (K pairs/s),Tree Get (K gets/s)\n";
+
+    measureWidth<int32_t, int32_t>("int32/int32", file);
+    measureWidth<int32_t, long>("int32/long", file);
+    measureWidth<long, int32_t>("long/int32", file);
+    measureWidth<long, long>("long/long", file);
+
+    file.close();
+    std::filesystem::remove(DATA_FILE_PATH + "key_widths");
+    std::cout << "Data successfully written to ./../experiments/key_widths.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "static_b_tree.h"
+#include "sst.h"
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of gets measured when the SST is mapped, and when every page is read from disk
+int NUM_MAPPED_QUERIES = 200000;
+int NUM_DISK_QUERIES = 20000;
+
+// Returns the average time (ns) of a lookup, checking that every key is found
+double measureLookups(const std::vector<long> &queries, const std::function<bool(long)> &lookup)
+{
+    long num_missing = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (long key : queries)
+    {
+        num_missing += !lookup(key);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    if (num_missing > 0)
+    {
+        std::cerr << "Error: " << num_missing << " keys were not found." << std::endl;
+    }
+    return elapsed.count() / queries.size();
+}
+
+/*
+    Compares the size and the get latency of the indexes of an SST of uniformly
+    distributed keys: the StaticBTree file (a descent from the Root Node), the
+    in-memory fence pointers and the in-memory piecewise-linear learned index.
+    Both in-memory indexes read one data page per get, except when the error
+    window of the learned index crosses a page boundary and the key is on the
+    other side of it.
+*/
+int main()
+{
+    // A single B-Tree Internal Node indexes up to MAX_PAIRS pages
+    std::vector<long> sizes = {MAX_PAIRS * 16, MAX_PAIRS * 64, MAX_PAIRS * MAX_PAIRS};
+    std::string filepath = DATA_FILE_PATH + "learned_index";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_learned.bin";
+    std::string btree_filename = filepath + "/btree_learned.bin";
+    std::string bloom_filename = filepath + "/bloom_learned.bin";
+
+    std::ofstream file("./../experiments/learned_index_vs_btree.csv", std::ios::out);
+    file << "Pairs,BTree Bytes,Fence Bytes,Learned Bytes,Learned Segments,Learned Pages per Get,"
+         << "BTree Mmap (ns),Fence Mmap (ns),Learned Mmap (ns),BTree Disk (ns),Fence Disk (ns),Learned Disk (ns)\n";
+
+    std::mt19937_64 gen(443);
+    for (long num_pairs : sizes)
+    {
+        // Sorted, unique and uniformly distributed keys (like generate_random_pairs)
+        std::set<long> key_set;
+        std::uniform_int_distribution<long> dist(0, LONG_MAX);
+        while (static_cast<long>(key_set.size()) < num_pairs)
+        {
+            key_set.insert(dist(gen));
+        }
+        std::vector<long> keys(key_set.begin(), key_set.end());
+
+        SSTWriter writer(sst_filename, btree_filename, bloom_filename);
+        for (long key : keys)
+        {
+            writer.put(key, key / 2);
+        }
+        if (!writer.finish())
+        {
+            std::cerr << "Error: Could not write the SST." << std::endl;
+            return 1;
+        }
+        SSTMetadata metadata = writer.getMetadata();
+
+        std::uniform_int_distribution<long> position_dist(0, num_pairs - 1);
+        std::vector<long> queries(NUM_MAPPED_QUERIES);
+        double learned_pages = 0;
+        for (long &query : queries)
+        {
+            long position = position_dist(gen);
+            query = keys[position];
+            // A second page is read when the predicted page is not the page of the key
+            learned_pages += 1 + (metadata.learned_index.predict(query) / static_cast<long>(MAX_PAIRS) != position / static_cast<long>(MAX_PAIRS));
+        }
+        learned_pages /= queries.size();
+        std::vector<long> disk_queries(queries.begin(), queries.begin() + NUM_DISK_QUERIES);
+
+        MappedFile sst_map(sst_filename);
+        MappedFile btree_map(btree_filename);
+        StaticBTree btree(sst_filename, btree_filename);
+        StaticBTree mapped_btree(sst_filename, btree_filename, &sst_map, &btree_map);
+
+        auto fenceLookup = [&](long key, MappedFile *map)
+        {
+            NodeFileOffset *ret = fencePointerSearch(sst_filename, metadata, key, nullptr, map);
+            delete ret;
+            return ret != nullptr;
+        };
+        auto learnedLookup = [&](long key, MappedFile *map)
+        {
+            NodeFileOffset *ret = learnedIndexSearch(sst_filename, metadata, key, nullptr, map);
+            delete ret;
+            return ret != nullptr;
+        };
+
+        double btree_mmap = measureLookups(queries, [&](long key) { return mapped_btree.get(key) != -1; });
+        double fence_mmap = measureLookups(queries, [&](long key) { return fenceLookup(key, &sst_map); });
+        double learned_mmap = measureLookups(queries, [&](long key) { return learnedLookup(key, &sst_map); });
+        double btree_disk = measureLookups(disk_queries, [&](long key) { return btree.get(key) != -1; });
+        double fence_disk = measureLookups(disk_queries, [&](long key) { return fenceLookup(key, nullptr); });
+        double learned_disk = measureLookups(disk_queries, [&](long key) { return learnedLookup(key, nullptr); });
+
+        size_t btree_bytes = std::filesystem::file_size(btree_filename);
+        std::cout << num_pairs << " pairs (" << (num_pairs + MAX_PAIRS - 1) / MAX_PAIRS << " pages):\n"
+                  << "  Index size: B-Tree " << btree_bytes << " bytes, fence pointers " << metadata.fenceMemoryBytes()
+                  << " bytes, learned index " << metadata.learnedMemoryBytes() << " bytes (" << metadata.learned_index.getNumSegments()
+                  << " segments, " << learned_pages << " data pages per get).\n"
+                  << "  Mmap: B-Tree " << btree_mmap << " ns, fence pointers " << fence_mmap << " ns, learned index " << learned_mmap << " ns.\n"
+                  << "  Disk: B-Tree " << btree_disk << " ns, fence pointers " << fence_disk << " ns, learned index " << learned_disk << " ns." << std::endl;
+        file << num_pairs << "," << btree_bytes << "," << metadata.fenceMemoryBytes() << "," << metadata.learnedMemoryBytes() << ","
+             << metadata.learned_index.getNumSegments() << "," << learned_pages << "," << btree_mmap << "," << fence_mmap << ","
+             << learned_mmap << "," << btree_disk << "," << fence_disk << "," << learned_disk << "\n";
+    }
+
+    std::filesystem::remove_all(filepath);
+    std::cout << "Data successfully written to ./../experiments/learned_index_vs_btree.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "packed_page.h"
+#include "sst.h"
+#include "checksum.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of pairs in each SST (64 MB of plain pages)
+long NUM_PAIRS = 64 * MEGABYTE / ENTRY_SIZE;
+
+// Number of pages decoded for every measurement of a kernel
+long NUM_DECODED_PAGES = 200000;
+
+// Number of times the whole SST is read for every scan measurement
+int NUM_SCAN_PASSES = 3;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+// Returns NUM_PAIRS strictly increasing keys whose gaps are drawn from [1, max_gap].
+std::vector<long> makeKeys(long max_gap)
+{
+    std::mt19937_64 gen(443);
+    std::uniform_int_distribution<long> gap(1, max_gap);
+    std::vector<long> keys(NUM_PAIRS);
+    long key = 0;
+    for (long &curr_key : keys)
+    {
+        key += gap(gen);
+        curr_key = key;
+    }
+    return keys;
+}
+
+// Writes the SST with the given encoding and returns its footer.
+SSTFooter writeSST(const std::string &sst_filename, const std::vector<long> &keys, PageEncoding encoding)
+{
+    std::filesystem::remove(sst_filename);
+    SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, encoding);
+    for (long key : keys)
+    {
+        writer.put(key, key * 10);
+    }
+    if (!writer.finish())
+    {
+        std::cerr << "Error: Could not write the SST." << std::endl;
+    }
+    SSTFooter footer;
+    readSSTFooter(sst_filename, footer);
+    return footer;
+}
+
+// Reads the whole SST like a compaction does and returns the time (seconds) taken per pass.
+double scanSST(const std::string &sst_filename)
+{
+    long checksum = 0;
+    double seconds = measureSeconds([&]()
+                                    {
+        for (int pass = 0; pass < NUM_SCAN_PASSES; ++pass)
+        {
+            for (SSTIterator iterator(sst_filename); iterator.valid(); iterator.next())
+            {
+                checksum += iterator.key();
+            }
+        } });
+    if (checksum == 0)
+    {
+        std::cerr << "Error: No pairs were read." << std::endl;
+    }
+    return seconds / NUM_SCAN_PASSES;
+}
+
+/*
+    Measures the delta and frame-of-reference bit-packed data pages: the
+    throughput of the scalar and AVX2 decode kernels, then for key gaps of
+    growing size (and so growing bit widths) the number of data pages of a
+    plain and a packed SST and the time of a full scan of each.
+*/
+int main()
+{
+    std::string filepath = DATA_FILE_PATH + "packed";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_packed.bin";
+
+    std::ofstream file("./../experiments/packed_decode.csv", std::ios::out);
+    file << "Max Key Gap,Bit Width,Pairs per Packed Page,Plain Pages,Packed Pages,Scalar Decode (M keys/s),AVX2 Decode (M keys/s),"
+         << "Plain Scan (s),Packed Scan (s)\n";
+
+    DecodeKernel was_kernel = getPackedDecodeKernel();
+    for (long max_gap : {1L, 16L, 256L, 65536L, 1L << 32})
+    {
+        std::vector<long> keys = makeKeys(max_gap);
+
+        // Decode the first packed page over and over
+        alignas(PAGE_SIZE) char page[PAGE_SIZE];
+        PackedPageBuilder builder;
+        for (long i = 0; i < NUM_PAIRS && builder.add(keys[i], keys[i]); ++i)
+        {
+        }
+        builder.write(page);
+        long page_pairs = getPackedPageNumPairs(page);
+        long bit_width = reinterpret_cast<const long *>(page)[1];
+
+        double decode_rates[2] = {0, 0};
+        for (DecodeKernel kernel : {DecodeKernel::SCALAR, DecodeKernel::AVX2})
+        {
+            if (!setPackedDecodeKernel(kernel))
+            {
+                std::cout << "The CPU does not support the " << getPackedDecodeKernelName(kernel) << " kernel." << std::endl;
+                continue;
+            }
+            long decoded_keys[PACKED_PAGE_MAX_PAIRS];
+            long checksum = 0;
+            double seconds = measureSeconds([&]()
+                                            {
+                for (long i = 0; i < NUM_DECODED_PAGES; ++i)
+                {
+                    checksum += decodePackedKeys(page, decoded_keys) + decoded_keys[i % page_pairs];
+                } });
+            if (checksum == 0)
+            {
+                std::cerr << "Error: No keys were decoded." << std::endl;
+            }
+            decode_rates[kernel == DecodeKernel::AVX2] = NUM_DECODED_PAGES * page_pairs / seconds / 1e6;
+        }
+        setPackedDecodeKernel(was_kernel);
+
+        SSTFooter plain_footer = writeSST(sst_filename, keys, PageEncoding::PLAIN);
+        double plain_seconds = scanSST(sst_filename);
+        SSTFooter packed_footer = writeSST(sst_filename, keys, PageEncoding::PACKED);
+        double packed_seconds = scanSST(sst_filename);
+
+        std::cout << "Key gaps up to " << max_gap << " (" << bit_width << " bits per key, " << page_pairs << " pairs per packed page):\n"
+                  << "  Decode: " << decode_rates[0] << " M keys/s scalar, " << decode_rates[1] << " M keys/s AVX2.\n"
+                  << "  Data pages: " << plain_footer.getNumDataPages() << " plain, " << packed_footer.getNumDataPages() << " packed.\n"
+                  << "  Full scan: " << plain_seconds << " s plain, " << packed_seconds << " s packed." << std::endl;
+        file << max_gap << "," << bit_width << "," << page_pairs << "," << plain_footer.getNumDataPages() << "," << packed_footer.getNumDataPages() << ","
+             << decode_rates[0] << "," << decode_rates[1] << "," << plain_seconds << "," << packed_seconds << "\n";
+    }
+
+    std::filesystem::remove_all(filepath);
+    std::cout << "Data successfully written to ./../experiments/packed_decode.csv" << std::endl;
+    return 0;
+}
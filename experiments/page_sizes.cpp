@@ -0,0 +1,130 @@
+#include "string_lsm_tree.h"
+#include "sst.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of key-value pairs (16-byte keys and 100-byte values) loaded into every LSM tree
+long NUM_PAIRS = 200000;
+
+// Number of random gets measured for every page size
+long NUM_GETS = 10000;
+
+// Number of random scans measured for every page size
+long NUM_SCANS = 500;
+
+// Number of keys in the range of every scan
+long SCAN_LENGTH = 1000;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+// Returns a 16-byte key that sorts like i.
+std::string makeKey(long i)
+{
+    std::string number = std::to_string(i);
+    return "key:" + std::string(12 - number.size(), '0') + number;
+}
+
+/*
+    Compares StringLSMTrees whose SSTs use 4 KB, 16 KB and 64 KB pages. The
+    same random pairs are put into each tree (with 1 MB memtables), then random
+    gets and scans of SCAN_LENGTH keys are measured without a buffer pool, so
+    every page is read from the disk. For every page size, the throughput, the
+    pages and bytes read per get and per scan, and the number of data and
+    index pages of the largest SST are written to a row of the results.
+*/
+int main()
+{
+    std::ofstream file("./../experiments/page_sizes.csv", std::ios::out);
+    file << "Page KB,Put (K pairs/s),Get (K gets/s),Pages per Get,KB per Get,Scan (scans/s),Pages per Scan,KB per Scan,Data Pages,Index Pages\n";
+
+    for (size_t page_size : {PAGE_SIZE, static_cast<size_t>(16 * 1024), MAX_PAGE_SIZE})
+    {
+        std::string database = "exp_page_sizes";
+        StringLSMTree *lsm_tree = new StringLSMTree(MEGABYTE, database);
+        lsm_tree->setPageSize(page_size);
+
+        std::mt19937_64 gen(447);
+        std::vector<long> keys(NUM_PAIRS);
+        for (long i = 0; i < NUM_PAIRS; ++i)
+        {
+            keys[i] = 2 * i;
+        }
+        std::shuffle(keys.begin(), keys.end(), gen);
+        std::string value(100, 'v');
+        double put_seconds = measureSeconds([&]()
+                                            {
+            for (long key : keys)
+            {
+                lsm_tree->put(makeKey(key), value);
+            }
+            lsm_tree->flush(); });
+
+        std::uniform_int_distribution<long> position(0, NUM_PAIRS - 1);
+        long num_found = 0;
+        resetPageReads();
+        double get_seconds = measureSeconds([&]()
+                                            {
+            for (long i = 0; i < NUM_GETS; ++i)
+            {
+                std::string found;
+                num_found += lsm_tree->get(makeKey(2 * position(gen)), found, nullptr) ? 1 : 0;
+            } });
+        double pages_per_get = static_cast<double>(getPageReads()) / NUM_GETS;
+
+        std::uniform_int_distribution<long> start(0, NUM_PAIRS - SCAN_LENGTH);
+        long num_scanned = 0;
+        resetPageReads();
+        double scan_seconds = measureSeconds([&]()
+                                             {
+            for (long i = 0; i < NUM_SCANS; ++i)
+            {
+                long first = 2 * start(gen);
+                num_scanned += lsm_tree->scan(makeKey(first), makeKey(first + 2 * (SCAN_LENGTH - 1)), nullptr).size();
+            } });
+        double pages_per_scan = static_cast<double>(getPageReads()) / NUM_SCANS;
+
+        // The data and index pages of the largest SST
+        SSTFooter largest_footer;
+        for (const std::vector<StringSST> &level : lsm_tree->getLevels())
+        {
+            for (const StringSST &sst : level)
+            {
+                SSTFooter footer;
+                if (readSSTFooter(sst.sst_filename, footer) && footer.num_entries > largest_footer.num_entries)
+                {
+                    largest_footer = footer;
+                }
+            }
+        }
+
+        double page_kb = static_cast<double>(page_size) / 1024;
+        std::cout << page_kb << " KB pages: put " << NUM_PAIRS / put_seconds / 1000 << " K pairs/s, get " << NUM_GETS / get_seconds / 1000 << " K gets/s ("
+                  << pages_per_get << " pages, " << pages_per_get * page_kb << " KB, " << num_found << " found), scan " << NUM_SCANS / scan_seconds << " scans/s ("
+                  << pages_per_scan << " pages, " << pages_per_scan * page_kb << " KB, " << num_scanned << " pairs), largest SST of "
+                  << largest_footer.getNumDataPages() << " data and " << largest_footer.getNumIndexPages() << " index pages." << std::endl;
+        file << page_kb << "," << NUM_PAIRS / put_seconds / 1000 << "," << NUM_GETS / get_seconds / 1000 << "," << pages_per_get << "," << pages_per_get * page_kb << ","
+             << NUM_SCANS / scan_seconds << "," << pages_per_scan << "," << pages_per_scan * page_kb << "," << largest_footer.getNumDataPages() << "," << largest_footer.getNumIndexPages() << "\n";
+
+        delete lsm_tree;
+        dbClear(database);
+    }
+
+    file.close();
+    std::cout << "Data successfully written to ./../experiments/page_sizes.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "lsm_tree.h"
+#include "row_cache.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Number of keys put into the LSM tree
+long NUM_KEYS = 1000000;
+
+// Number of gets measured for every skew and row cache size
+long NUM_GETS = 200000;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+// Frees the result of a get, except for its node if it is the node of the memtable (which get returns as is).
+void freeGetResult(LSMTree *lsm_tree, NodeFileOffset *result)
+{
+    if (result != nullptr && lsm_tree->getMemtable()->get(result->node->key) == result->node)
+    {
+        result->node = nullptr;
+    }
+    delete result;
+}
+
+/*
+    Measures gets of an LSM tree of NUM_KEYS keys (with 1 MB memtables and a
+    10 MB buffer pool) drawn from Zipfian distributions of several skews, with
+    no row cache and with row caches of several sizes. The hot keys are spread
+    over the key space, so they are not all in the same pages. Reported are the
+    get throughput, the hit rate of the row cache, and the pages read per get.
+*/
+int main()
+{
+    std::ofstream file("./../experiments/row_cache.csv", std::ios::out);
+    file << "Zipfian Exponent,Row Cache KB,Get (K gets/s),Hit Rate,Pages per Get\n";
+
+    std::string database = "exp_row_cache";
+    Memtable *memtable = dbOpen(database, MEMTABLE_SIZE / ENTRY_SIZE);
+    LSMTree *lsm_tree = new LSMTree(MEMTABLE_SIZE / ENTRY_SIZE, database, memtable);
+    std::vector<long> keys(NUM_KEYS);
+    for (long i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = 2 * i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(448));
+    for (long key : keys)
+    {
+        lsm_tree->put(key, key + 1);
+    }
+
+    for (double exponent : {0.0, 0.8, 0.99, 1.2})
+    {
+        for (size_t cache_kb : {0, 256, 1024, 4096})
+        {
+            BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+            RowCache *row_cache = cache_kb > 0 ? new RowCache(cache_kb * 1024) : nullptr;
+            lsm_tree->setRowCache(row_cache);
+
+            // The rank of a key in the distribution is not its order, so hot keys are spread over the SSTs
+            ZipfianGenerator zipfian(NUM_KEYS, exponent, 449);
+            long num_found = 0;
+            resetPageReads();
+            double get_seconds = measureSeconds([&]()
+                                                {
+                for (long i = 0; i < NUM_GETS; ++i)
+                {
+                    NodeFileOffset *result = lsm_tree->get(keys[zipfian.next()], buffer_pool, true);
+                    num_found += result != nullptr ? 1 : 0;
+                    freeGetResult(lsm_tree, result);
+                } });
+            double pages_per_get = static_cast<double>(getPageReads()) / NUM_GETS;
+            double hit_rate = row_cache != nullptr ? row_cache->getHitRate() : 0;
+
+            std::cout << "Zipfian " << exponent << ", " << cache_kb << " KB row cache: " << NUM_GETS / get_seconds / 1000 << " K gets/s, hit rate " << hit_rate << ", "
+                      << pages_per_get << " pages per get (" << num_found << " found)." << std::endl;
+            file << exponent << "," << cache_kb << "," << NUM_GETS / get_seconds / 1000 << "," << hit_rate << "," << pages_per_get << "\n";
+
+            lsm_tree->setRowCache(nullptr);
+            delete row_cache;
+            delete buffer_pool;
+        }
+    }
+
+    file.close();
+    delete lsm_tree;
+    dbClear(database);
+    std::cout << "Data successfully written to ./../experiments/row_cache.csv" << std::endl;
+    return 0;
+}
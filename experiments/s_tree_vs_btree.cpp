@@ -0,0 +1,143 @@
+#include "s_tree.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+
+// Number of lookups timed for every index size
+int NUM_QUERIES = 1 << 20;
+
+/*
+    The current static B-Tree layout kept in memory: nodes of MAX_PAIRS sorted
+    keys, where every key of an internal node is the largest key of a child,
+    searched with the same branchy binary search as StaticBTree::binarySearch.
+*/
+struct BTreeLayout
+{
+    std::vector<std::vector<long>> levels; // levels[0] holds the sorted keys, the last level is the root node
+    long num_keys;
+
+    BTreeLayout(const std::vector<long> &sorted_keys) : num_keys(sorted_keys.size())
+    {
+        levels.push_back(sorted_keys);
+        while (levels.back().size() > MAX_PAIRS)
+        {
+            const std::vector<long> &children = levels.back();
+            std::vector<long> parents;
+            for (size_t i = 0; i < children.size(); i += MAX_PAIRS)
+            {
+                parents.push_back(children[std::min(children.size(), i + MAX_PAIRS) - 1]);
+            }
+            levels.push_back(parents);
+        }
+    }
+
+    // Returns the position of the first key that is not smaller than the key in keys[first, last)
+    static long binarySearch(const std::vector<long> &keys, long first, long last, long key)
+    {
+        long left = first, right = last - 1;
+        while (left <= right)
+        {
+            long mid = left + (right - left) / 2;
+            if (keys[mid] == key)
+            {
+                return mid;
+            }
+            else if (keys[mid] < key)
+            {
+                left = mid + 1;
+            }
+            else
+            {
+                right = mid - 1;
+            }
+        }
+        return left;
+    }
+
+    long lowerBound(long key) const
+    {
+        long node = 0;
+        for (int h = levels.size() - 1; h >= 0; h--)
+        {
+            const std::vector<long> &keys = levels[h];
+            long first = node * MAX_PAIRS;
+            long last = std::min<long>(keys.size(), first + MAX_PAIRS);
+            long pos = binarySearch(keys, first, last, key);
+            if (pos == last)
+            {
+                return num_keys; // Every key is smaller
+            }
+            node = pos;
+        }
+        return node;
+    }
+};
+
+/*
+    Compares the lookup time (ns/op) of the current static B-Tree node layout
+    against the S+-tree layout (STree, B = S_TREE_BLOCK_KEYS, cache-line
+    aligned, branchless with prefetching) for indexes that fit in the CPU
+    caches and indexes that are far larger than them.
+*/
+int main()
+{
+    // 32 KB and 512 KB indexes fit in the caches, 8 MB is around the size of the last level cache, 128 MB and 512 MB do not fit
+    std::vector<long> sizes = {4096, 65536, 1048576, 16777216, 67108864};
+    std::ofstream file("./../experiments/stree_vs_btree.csv", std::ios::out);
+    file << "Keys,BTree,STree\n";
+
+    std::mt19937_64 gen(443);
+    for (long num_keys : sizes)
+    {
+        std::vector<long> keys(num_keys);
+        for (long i = 0; i < num_keys; ++i)
+        {
+            keys[i] = i * 2 + 1;
+        }
+        std::uniform_int_distribution<long> dist(0, num_keys * 2);
+        std::vector<long> queries(NUM_QUERIES);
+        for (long &query : queries)
+        {
+            query = dist(gen);
+        }
+
+        BTreeLayout btree(keys);
+        STree s_tree;
+        s_tree.build(keys);
+
+        // The checksum keeps the compiler from removing the lookups, and both layouts must agree on it
+        long btree_checksum = 0, s_tree_checksum = 0;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (long query : queries)
+        {
+            btree_checksum += btree.lowerBound(query);
+        }
+        std::chrono::duration<double, std::nano> btree_time = std::chrono::high_resolution_clock::now() - start_time;
+
+        start_time = std::chrono::high_resolution_clock::now();
+        for (long query : queries)
+        {
+            s_tree_checksum += s_tree.lowerBound(query);
+        }
+        std::chrono::duration<double, std::nano> s_tree_time = std::chrono::high_resolution_clock::now() - start_time;
+
+        if (btree_checksum != s_tree_checksum)
+        {
+            std::cerr << "Error: The B-Tree and S+-Tree lookups disagree for " << num_keys << " keys." << std::endl;
+        }
+
+        double btree_ns = btree_time.count() / NUM_QUERIES;
+        double s_tree_ns = s_tree_time.count() / NUM_QUERIES;
+        std::cout << num_keys << " keys (" << num_keys * sizeof(long) / 1024 << " KB): B-Tree " << btree_ns << " ns/op, S+-Tree "
+                  << s_tree_ns << " ns/op (" << btree_ns / s_tree_ns << "x)." << std::endl;
+        file << num_keys << "," << btree_ns << "," << s_tree_ns << "\n";
+    }
+
+    std::cout << "Data successfully written to ./../experiments/stree_vs_btree.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "string_lsm_tree.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+
+// Number of keys put into the LSM tree before the scans
+long NUM_KEYS = 200000;
+
+// Number of overwrites made during the scan, and the number of keys scanned between two batches of them
+long NUM_OVERWRITES = 400000;
+long SCAN_CHUNK_KEYS = 1000;
+
+// Returns a 16-byte key that sorts like i.
+std::string makeKey(long i)
+{
+    std::string number = std::to_string(i);
+    return "key:" + std::string(12 - number.size(), '0') + number;
+}
+
+// Returns the bytes of all SSTs of the tree.
+size_t getSSTBytes(StringLSMTree *lsm_tree)
+{
+    size_t num_bytes = 0;
+    for (const std::vector<StringSST> &level : lsm_tree->getLevels())
+    {
+        for (const StringSST &sst : level)
+        {
+            num_bytes += std::filesystem::file_size(sst.sst_filename);
+        }
+    }
+    return num_bytes;
+}
+
+/*
+    Runs a long scan of an LSM tree of NUM_KEYS keys (100-byte values, 1 MB
+    memtables) in chunks of SCAN_CHUNK_KEYS keys, while random overwrites of
+    the keys are made between the chunks. The scan either reads at a snapshot
+    taken before it started, or reads the newest values. Reported are the
+    throughput of the overwrites and of the scan, the number of keys whose
+    scanned value was not the value at the start of the scan (0 for a
+    consistent scan), and the bytes of the SSTs at the end of the scan (the
+    old versions a snapshot keeps).
+*/
+int main()
+{
+    std::ofstream file("./../experiments/snapshots.csv", std::ios::out);
+    file << "Snapshot,Overwrite (K puts/s),Scan (K keys/s),Changed Keys,SST MB\n";
+
+    for (bool is_snapshot : {false, true})
+    {
+        std::string database = "exp_snapshots";
+        StringLSMTree *lsm_tree = new StringLSMTree(MEMTABLE_SIZE, database);
+        BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+        std::string value(100, 'v');
+        for (long i = 0; i < NUM_KEYS; ++i)
+        {
+            lsm_tree->put(makeKey(i), value);
+        }
+
+        uint64_t snapshot = is_snapshot ? lsm_tree->getSnapshot() : LATEST_SEQUENCE;
+        std::mt19937_64 gen(443);
+        std::uniform_int_distribution<long> key_index(0, NUM_KEYS - 1);
+        long overwrites_per_chunk = NUM_OVERWRITES / (NUM_KEYS / SCAN_CHUNK_KEYS);
+        std::string new_value(100, 'n');
+        long num_scanned = 0;
+        long num_changed = 0;
+        double put_seconds = 0;
+        double scan_seconds = 0;
+        for (long first = 0; first < NUM_KEYS; first += SCAN_CHUNK_KEYS)
+        {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            for (long i = 0; i < overwrites_per_chunk; ++i)
+            {
+                lsm_tree->put(makeKey(key_index(gen)), new_value);
+            }
+            auto scan_time = std::chrono::high_resolution_clock::now();
+            std::vector<std::pair<std::string, std::string>> chunk = lsm_tree->scan(makeKey(first), makeKey(first + SCAN_CHUNK_KEYS - 1), buffer_pool, snapshot);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            put_seconds += std::chrono::duration<double>(scan_time - start_time).count();
+            scan_seconds += std::chrono::duration<double>(end_time - scan_time).count();
+            num_scanned += chunk.size();
+            for (const auto &pair : chunk)
+            {
+                num_changed += pair.second != value ? 1 : 0;
+            }
+        }
+        double sst_mb = static_cast<double>(getSSTBytes(lsm_tree)) / MEGABYTE;
+
+        std::cout << (is_snapshot ? "Snapshot" : "No snapshot") << ": overwrite " << NUM_OVERWRITES / put_seconds / 1000 << " K puts/s, scan "
+                  << num_scanned / scan_seconds / 1000 << " K keys/s, " << num_changed << " of " << num_scanned << " scanned keys changed, " << sst_mb
+                  << " MB of SSTs." << std::endl;
+        file << (is_snapshot ? "Yes" : "No") << "," << NUM_OVERWRITES / put_seconds / 1000 << "," << num_scanned / scan_seconds / 1000 << "," << num_changed
+             << "," << sst_mb << "\n";
+
+        if (is_snapshot)
+        {
+            lsm_tree->releaseSnapshot(snapshot);
+        }
+        delete lsm_tree;
+        delete buffer_pool;
+        dbClear(database);
+    }
+
+    file.close();
+    std::cout << "Data successfully written to ./../experiments/snapshots.csv" << std::endl;
+    return 0;
+}
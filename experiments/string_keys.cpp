@@ -0,0 +1,129 @@
+#include "lsm_tree.h"
+#include "string_lsm_tree.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Bytes of key-value pairs loaded into every LSM tree
+size_t DATA_BYTES = 16 * MEGABYTE;
+
+// Number of random gets measured for every LSM tree
+long NUM_GETS = 20000;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+// Returns a 16-byte key that sorts like i.
+std::string makeKey(long i)
+{
+    std::string number = std::to_string(i);
+    return "key:" + std::string(12 - number.size(), '0') + number;
+}
+
+/*
+    Compares the throughput of the fixed-width LSMTree of long keys and values
+    with the StringLSMTree of byte-string keys and values (16-byte keys and
+    values of 8, 100 and 1000 bytes). The same number of bytes of random pairs
+    is put into each tree (with 1 MB memtables), then random keys that were put
+    are read back.
+*/
+int main()
+{
+    std::ofstream file("./../experiments/string_keys.csv", std::ios::out);
+    file << "Tree,Key Bytes,Value Bytes,Pairs,Put (K pairs/s),Put (MB/s),Get (K gets/s)\n";
+    std::mt19937_64 gen(443);
+
+    // The fixed-width fast path
+    {
+        long num_pairs = DATA_BYTES / ENTRY_SIZE;
+        std::vector<long> keys(num_pairs);
+        for (long &key : keys)
+        {
+            key = gen() >> 1;
+        }
+        std::string database = "exp_long_keys";
+        Memtable *memtable = dbOpen(database, MEMTABLE_SIZE / ENTRY_SIZE);
+        LSMTree *lsm_tree = new LSMTree(MEMTABLE_SIZE / ENTRY_SIZE, database, memtable);
+        double put_seconds = measureSeconds([&]()
+                                            {
+            for (long key : keys)
+            {
+                lsm_tree->put(key, key / 2);
+            } });
+
+        BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+        std::uniform_int_distribution<long> position(0, num_pairs - 1);
+        long num_found = 0;
+        double get_seconds = measureSeconds([&]()
+                                            {
+            for (long i = 0; i < NUM_GETS; ++i)
+            {
+                NodeFileOffset *found = lsm_tree->get(keys[position(gen)], buffer_pool, false);
+                num_found += found != nullptr ? 1 : 0;
+                delete found;
+            } });
+        std::cout << "long keys: put " << num_pairs / put_seconds / 1000 << " K pairs/s, get " << NUM_GETS / get_seconds / 1000 << " K gets/s (" << num_found
+                  << " found)." << std::endl;
+        file << "LSMTree," << sizeof(long) << "," << sizeof(long) << "," << num_pairs << "," << num_pairs / put_seconds / 1000 << ","
+             << DATA_BYTES / put_seconds / MEGABYTE << "," << NUM_GETS / get_seconds / 1000 << "\n";
+        delete buffer_pool;
+        delete lsm_tree;
+        dbClear(database);
+        std::filesystem::remove(DATA_FILE_PATH + database);
+    }
+
+    // Byte-string keys and values
+    for (size_t value_bytes : {8, 100, 1000})
+    {
+        long num_pairs = DATA_BYTES / (16 + value_bytes);
+        std::vector<std::string> keys(num_pairs);
+        for (std::string &key : keys)
+        {
+            key = makeKey(gen() % 1000000000000L);
+        }
+        std::string value(value_bytes, 'v');
+        std::string database = "exp_string_keys";
+        StringLSMTree *lsm_tree = new StringLSMTree(MEMTABLE_SIZE, database);
+        double put_seconds = measureSeconds([&]()
+                                            {
+            for (const std::string &key : keys)
+            {
+                lsm_tree->put(key, value);
+            } });
+
+        BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+        std::uniform_int_distribution<long> position(0, num_pairs - 1);
+        long num_found = 0;
+        std::string found_value;
+        double get_seconds = measureSeconds([&]()
+                                            {
+            for (long i = 0; i < NUM_GETS; ++i)
+            {
+                num_found += lsm_tree->get(keys[position(gen)], found_value, buffer_pool) ? 1 : 0;
+            } });
+        std::cout << "string keys, " << value_bytes << " byte values: put " << num_pairs / put_seconds / 1000 << " K pairs/s, get " << NUM_GETS / get_seconds / 1000
+                  << " K gets/s (" << num_found << " found)." << std::endl;
+        file << "StringLSMTree,16," << value_bytes << "," << num_pairs << "," << num_pairs / put_seconds / 1000 << "," << DATA_BYTES / put_seconds / MEGABYTE << ","
+             << NUM_GETS / get_seconds / 1000 << "\n";
+        delete buffer_pool;
+        delete lsm_tree;
+        dbClear(database);
+        std::filesystem::remove(DATA_FILE_PATH + database);
+    }
+
+    file.close();
+    std::cout << "Data successfully written to ./../experiments/string_keys.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "string_lsm_tree.h"
+#include "test_helpers.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+
+// Bytes of values put into every LSM tree
+size_t DATA_BYTES = 64 * MEGABYTE;
+
+// Number of scans of SCAN_KEYS keys measured for every LSM tree
+long NUM_SCANS = 200;
+long SCAN_KEYS = 100;
+
+// Returns the time (seconds) taken by the function.
+double measureSeconds(const std::function<void()> &function)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+    return elapsed.count();
+}
+
+// Returns a 16-byte key that sorts like i.
+std::string makeKey(long i)
+{
+    std::string number = std::to_string(i);
+    return "key:" + std::string(12 - number.size(), '0') + number;
+}
+
+/*
+    Compares values stored inline in the SSTs of a StringLSMTree with values
+    stored in its value log, for values of 128, 1000 and 3000 bytes. The same
+    bytes of random puts (over half as many keys, so half of them are
+    overwrites) go into each tree (with 1 MB memtables). Reported are the put
+    throughput, the write amplification (the bytes written to SSTs and the
+    value log per byte put), the throughput of scans of SCAN_KEYS keys, and the
+    size of the value log before and after collecting every old segment.
+*/
+int main()
+{
+    std::ofstream file("./../experiments/value_log.csv", std::ios::out);
+    file << "Value Bytes,Value Log,Put (MB/s),Write Amplification,Scan (K keys/s),Value Log MB,Value Log MB After GC\n";
+
+    for (size_t value_bytes : {128, 1000, 3000})
+    {
+        for (bool use_value_log : {false, true})
+        {
+            long num_puts = DATA_BYTES / value_bytes;
+            long num_keys = num_puts / 2;
+            std::mt19937_64 gen(445);
+            std::uniform_int_distribution<long> key_index(0, num_keys - 1);
+            std::string value(value_bytes, 'v');
+            std::string database = "exp_value_log";
+            StringLSMTree *lsm_tree = new StringLSMTree(MEMTABLE_SIZE, database);
+            if (use_value_log)
+            {
+                lsm_tree->enableValueLog(VALUE_LOG_THRESHOLD);
+            }
+            double put_seconds = measureSeconds([&]()
+                                                {
+                for (long i = 0; i < num_puts; ++i)
+                {
+                    lsm_tree->put(makeKey(key_index(gen)), value);
+                } });
+
+            BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+            long num_scanned = 0;
+            double scan_seconds = measureSeconds([&]()
+                                                 {
+                for (long i = 0; i < NUM_SCANS; ++i)
+                {
+                    long first = key_index(gen);
+                    num_scanned += lsm_tree->scan(makeKey(first), makeKey(first + SCAN_KEYS - 1), buffer_pool).size();
+                } });
+
+            double value_log_mb = 0;
+            double value_log_mb_after_gc = 0;
+            if (use_value_log)
+            {
+                ValueLog *value_log = lsm_tree->getValueLog();
+                value_log_mb = static_cast<double>(value_log->getDiskBytes()) / MEGABYTE;
+                for (long num_segments = value_log->getNumSegments(); num_segments > 1 && lsm_tree->collectValueLogGarbage(buffer_pool); --num_segments)
+                {
+                }
+                value_log_mb_after_gc = static_cast<double>(value_log->getDiskBytes()) / MEGABYTE;
+            }
+
+            std::cout << value_bytes << " byte values" << (use_value_log ? " in the value log" : " inline") << ": put " << DATA_BYTES / put_seconds / MEGABYTE
+                      << " MB/s, write amplification " << lsm_tree->getWriteAmplification() << ", scan " << num_scanned / scan_seconds / 1000 << " K keys/s";
+            if (use_value_log)
+            {
+                std::cout << ", value log " << value_log_mb << " MB (" << value_log_mb_after_gc << " MB after GC)";
+            }
+            std::cout << "." << std::endl;
+            file << value_bytes << "," << (use_value_log ? "yes" : "no") << "," << DATA_BYTES / put_seconds / MEGABYTE << "," << lsm_tree->getWriteAmplification() << ","
+                 << num_scanned / scan_seconds / 1000 << "," << value_log_mb << "," << value_log_mb_after_gc << "\n";
+            delete buffer_pool;
+            delete lsm_tree;
+            dbClear(database);
+            std::filesystem::remove(DATA_FILE_PATH + database);
+        }
+    }
+
+    file.close();
+    std::cout << "Data successfully written to ./../experiments/value_log.csv" << std::endl;
+    return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include "global.h"
+#include <cstddef>
+
+/*
+    Represents how the data pages (blocks) of an SST are compressed.
+
+    Values:
+        NONE                Blocks are stored as they are, one per page.
+        LZ                  Built-in LZ77 codec that tries a single earlier match per position (fast).
+        LZ_HIGH             Built-in LZ77 codec that searches a chain of earlier matches for the longest one
+                            (stronger, slower to compress, as fast to decompress as LZ).
+        LZ4                 LZ4 (only when the library was found at build time).
+        ZSTD                Zstandard (only when the library was found at build time).
+*/
+enum class CompressionType
+{
+    NONE = 0,
+    LZ = 1,
+    LZ_HIGH = 2,
+    LZ4 = 3,
+    ZSTD = 4
+};
+
+const int ZSTD_COMPRESSION_LEVEL = 9; // Zstandard level used for SST blocks
+
+/*
+    Compresses and decompresses SST blocks. Every codec is stateless, so a
+    single instance of each is shared by every writer and reader.
+
+    Functions:
+        getType             Returns the compression type of the codec
+        getName             Returns the name of the codec
+        compress            Compresses size bytes of src into at most capacity bytes of dst, returns the compressed size
+                            (0 if the block does not fit in capacity bytes, so it can be stored uncompressed instead)
+        decompress          Decompresses compressed_size bytes of src into exactly size bytes of dst, returns false if the
+                            block is corrupted
+*/
+class BlockCodec
+{
+public:
+    virtual ~BlockCodec() = default;
+
+    virtual CompressionType getType() const = 0;
+    virtual const char *getName() const = 0;
+    virtual size_t compress(const char *src, size_t size, char *dst, size_t capacity) const = 0;
+    virtual bool decompress(const char *src, size_t compressed_size, char *dst, size_t size) const = 0;
+};
+
+/*
+    Returns the codec of the compression type, or nullptr for NONE and for the
+    codecs that were not built in (see isCompressionSupported).
+*/
+const BlockCodec *getBlockCodec(CompressionType type);
+bool isCompressionSupported(CompressionType type);
+const char *getCompressionName(CompressionType type);
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
 #include "global.h"
 #include "xxhash64.h"
 #include <string>
@@ -31,7 +34,7 @@ private:
     // Maximum number of pages allowed in the pool
     long max_pages;
     long curr_num_pages;
-    int hashKey(std::string id);
+    int hashKey(const std::string &id);
 
     std::list<Page *> lru;                                            // Tracks the LRU list
     std::unordered_map<Page *, std::list<Page *>::iterator> page_map; // Maps pages to their positions in the lru
@@ -40,5 +43,7 @@ public:
     BufferPool(long max_pages);
     ~BufferPool();
     void insertPage(Page *page);
-    Page *searchForPage(std::string id);
-};
\ No newline at end of file
+    Page *searchForPage(const std::string &id);
+};
+
+#endif
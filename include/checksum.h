@@ -0,0 +1,67 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "global.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Represents when the pages of SST, B-Tree and Bloom filter files are checked
+    against their CRC32C checksums.
+
+    Values:
+        OFF                 Pages are never checked.
+        ON                  Pages read from disk (including every page read by compaction) are checked.
+        PARANOID            Pages read from the buffer pool and from memory mappings are checked as well.
+*/
+enum class ChecksumMode
+{
+    OFF = 0,
+    ON = 1,
+    PARANOID = 2
+};
+
+/*
+    Returns the CRC32C (Castagnoli) checksum of the data, continuing from crc.
+    Uses the SSE4.2 crc32 instruction when the CPU supports it (checked once at
+    runtime), otherwise a table-driven software implementation.
+*/
+uint32_t crc32c(const void *data, size_t length, uint32_t crc = 0);
+
+bool isHardwareCRC32CSupported();
+bool setHardwareCRC32C(bool use_hardware);
+bool isHardwareCRC32C();
+
+ChecksumMode getChecksumMode();
+void setChecksumMode(ChecksumMode mode);
+
+/*
+    A single-file SST holds the CRC32C of each of its pages in its checksum
+    block (see SSTFooter). Every other file (the B-Tree and Bloom filter files,
+    and SSTs written as separate files or before version 6) has a sidecar file
+    (the filename followed by ".crc") holding them, so the page layout the
+    searches rely on is left untouched. The checksums of a file are read once
+    and then kept in memory (4 bytes per page). The last page of a file that is
+    not a multiple of PAGE_SIZE is checksummed up to the end of the file. Pages
+    without a checksum (files written without a sidecar) are never reported as
+    corrupted, except in an SST of the current format, whose checksum block
+    must cover every page before it: a page whose checksum is missing is
+    reported like a page that does not match.
+*/
+std::string getChecksumFilename(const std::string &filename);
+std::vector<uint32_t> computePageChecksums(const void *data, size_t size);
+bool writeChecksumFile(const std::string &filename, const std::vector<uint32_t> &checksums);
+void cachePageChecksums(const std::string &filename, const std::vector<uint32_t> &checksums);
+bool verifyPageChecksums(const std::string &filename, long first_page, const void *data, size_t size = PAGE_SIZE);
+bool isPageIntact(const std::string &filename, long first_page, const void *data, bool is_cached, size_t size = PAGE_SIZE);
+long getNumPageChecksums(const std::string &filename);
+void removeChecksumFile(const std::string &filename);
+void dropPageChecksums(const std::string &filename);
+
+// Pages found to not match their checksum
+long getChecksumMismatches();
+void resetChecksumMismatches();
+
+#endif
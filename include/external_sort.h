@@ -0,0 +1,129 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include "global.h"
+#include <vector>
+#include <deque>
+#include <queue>
+#include <string>
+#include <utility>
+#include <future>
+#include <fstream>
+
+/*
+    Reads the key-value pairs of a sorted run file written by ExternalSorter,
+    a buffer of EXTERNAL_SORT_MERGE_BUFFER_PAIRS pairs at a time.
+
+    Input:
+        filename            The name of the run file to read.
+
+    Attributes:
+        in                  The stream of the run file
+        buffer              The pairs read from the file but not returned yet
+        buffer_size         The number of pairs in buffer
+        buffer_index        The index of the next pair to return in buffer
+
+    Functions:
+        isOpen              Returns whether the run file could be opened
+        next                Gives the next pair of the run, returns false once the run is over
+*/
+struct RunReader
+{
+    std::ifstream in;
+    std::vector<std::pair<long, long>> buffer;
+    size_t buffer_size;
+    size_t buffer_index;
+
+    RunReader(const std::string &filename);
+    bool isOpen();
+    bool next(long &key, long &value);
+};
+
+/*
+    Represents the smallest pair left in a run during the k-way merge.
+*/
+struct MergeEntry
+{
+    long key;
+    long value;
+    size_t run_index;
+};
+
+/*
+    Orders the merge heap by increasing key, and for equal keys by decreasing
+    run index, so that the newest value of a key comes out first.
+*/
+struct MergeEntryCompare
+{
+    bool operator()(const MergeEntry &a, const MergeEntry &b) const
+    {
+        return a.key != b.key ? a.key > b.key : a.run_index < b.run_index;
+    }
+};
+
+/*
+    Sorts a stream of key-value pairs that does not fit in memory. Pairs are
+    buffered into runs of run_pairs pairs, and every full run is sorted and
+    written to its own file by a background thread, with at most num_threads
+    runs sorted at once (so at most (num_threads + 1) * run_pairs pairs are in
+    memory). The run files are then merged with a k-way merge. When a key was
+    added more than once, only the value added last is kept.
+
+    Input:
+        run_prefix          The prefix of the run filenames (e.g. a database directory and timestamp).
+        run_pairs           The number of pairs in each run.
+        num_threads         The number of runs that may be sorted at once.
+
+    Attributes:
+        buffer              The pairs of the run being filled
+        run_filenames       The names of the run files written so far (oldest first)
+        pending_runs        The runs still being sorted and written by a background thread
+        readers             The readers of every run file during the merge
+        heap                The smallest pair left in every run during the merge
+        has_last_key        Whether a pair was already returned by the merge
+        last_key            The key of the last pair returned by the merge
+        has_error           Whether a run could not be written or read
+
+    Functions:
+        writeRun            Sorts a run, keeps the last value of each key and writes it to a file
+        flushRun            Hands the current buffer to a background thread as a new run
+        waitForRun          Waits for the oldest pending run to be written
+        add                 Adds a key-value pair to sort
+        finish              Writes the last run and prepares the k-way merge
+        next                Gives the next pair in sorted order, returns false once all pairs were given
+        hasError            Returns whether a run could not be written or read
+        getNumRuns          Returns the number of runs written
+*/
+class ExternalSorter
+{
+private:
+    std::string run_prefix;
+    size_t run_pairs;
+    int num_threads;
+
+    std::vector<std::pair<long, long>> buffer;
+    std::vector<std::string> run_filenames;
+    std::deque<std::future<bool>> pending_runs;
+
+    std::vector<RunReader *> readers;
+    std::priority_queue<MergeEntry, std::vector<MergeEntry>, MergeEntryCompare> heap;
+    bool has_last_key;
+    long last_key;
+    bool has_error;
+
+    static bool writeRun(std::vector<std::pair<long, long>> pairs, std::string filename);
+    void flushRun();
+    void waitForRun();
+
+public:
+    ExternalSorter(std::string run_prefix, size_t run_pairs = EXTERNAL_SORT_RUN_PAIRS, int num_threads = EXTERNAL_SORT_NUM_THREADS);
+    ~ExternalSorter();
+
+    void add(long key, long value);
+    bool finish();
+    bool next(long &key, long &value);
+    bool hasError();
+    size_t getNumRuns();
+};
+
+#endif
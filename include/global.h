@@ -2,6 +2,8 @@
 #define GLOBALS_H
 
 #include <string>
+#include <cstdint>
+#include <type_traits>
 
 // Paths
 extern std::string last_known_database;
@@ -12,9 +14,37 @@ const long INTERNAL = -1;
 const long LEAF = -2;
 
 // Page and Entry Sizes
-const size_t PAGE_SIZE = 4096;                         // Page size in bytes for SST reads
-const size_t ENTRY_SIZE = sizeof(long) + sizeof(long); // Each entry has a key and value (8 bytes each)
-const size_t MAX_PAIRS = PAGE_SIZE / ENTRY_SIZE;       // Maximum key-value pairs per page
+const size_t PAGE_SIZE = 4096;          // Page size in bytes for SST reads
+const size_t MAX_PAGE_SIZE = 64 * 1024; // Largest page size of the SSTs of long and byte-string keys (a power of two multiple of PAGE_SIZE)
+
+/*
+    The layout of a page of fixed-width key-value pairs of the given types,
+    computed at compile time. The keys must be signed integers (as searched by
+    pageLowerBound) and the values trivially copyable, so pages are read and
+    written as raw bytes.
+
+    Attributes:
+        ENTRY_SIZE          Bytes of a key-value pair
+        MAX_PAIRS           Maximum key-value pairs per page
+        BTREE_PAGE_SIZE     Bytes of an in-memory B-Tree node of the types
+*/
+template <typename Key, typename Value>
+struct PageLayout
+{
+    static_assert(std::is_integral_v<Key> && std::is_signed_v<Key>, "Keys must be signed integers");
+    static_assert(std::is_trivially_copyable_v<Value>, "Values must be trivially copyable");
+
+    static constexpr size_t ENTRY_SIZE = sizeof(Key) + sizeof(Value);
+    static constexpr size_t MAX_PAIRS = PAGE_SIZE / ENTRY_SIZE;
+    static constexpr size_t BTREE_PAGE_SIZE = sizeof(bool)                                                     // is_leaf flag
+                                              + sizeof(int)                                                    // num_keys count
+                                              + sizeof(Key) * MAX_PAIRS                                        // array of keys
+                                              + (sizeof(Value) > sizeof(long) ? sizeof(Value) : sizeof(long)) // array of pages or values
+                                                    * MAX_PAIRS;
+};
+
+const size_t ENTRY_SIZE = PageLayout<long, long>::ENTRY_SIZE; // Each entry has a key and value (8 bytes each)
+const size_t MAX_PAIRS = PageLayout<long, long>::MAX_PAIRS;   // Maximum key-value pairs per page
 
 // LSM Tree Configuration
 const size_t LEVEL_SIZE_RATIO = 2; // Level size ratio for LSM tree
@@ -26,14 +56,62 @@ const size_t GIGABYTE = MEGABYTE * 1024;
 const size_t BUFFER_POOL_SIZE = (10 * MEGABYTE) / PAGE_SIZE; // 10 MB
 const size_t MEMTABLE_SIZE = MEGABYTE;                       // 1 MB memtable size
 
+// Rate Limiter Configuration
+const size_t RATE_LIMITER_BYTES_PER_SECOND = 64 * MEGABYTE; // Default flush and compaction write budget
+const double RATE_LIMITER_BURST_SECONDS = 0.1;              // Tokens the bucket can hold, in seconds of budget
+const double RATE_LIMITER_WINDOW_SECONDS = 1.0;             // Window used to measure compaction bytes per second
+const int RATE_LIMITER_TUNE_INTERVAL = 100;                 // Foreground latencies recorded between auto-tuning steps
+const size_t RATE_LIMITER_MIN_BYTES_PER_SECOND = PAGE_SIZE;  // Smallest budget auto-tuning may choose (a zero budget would never refill)
+
+// Compaction Configuration
+const size_t COMPACTION_SST_PAIRS = MAX_PAIRS * MAX_PAIRS; // Pairs per SST written by a compaction (its output is split into SSTs of this size)
+
+// Snapshot Configuration
+const uint64_t LATEST_SEQUENCE = UINT64_MAX; // Reads at this sequence number see every write
+
+// Tombstone Compaction Configuration
+const double TOMBSTONE_COMPACTION_RATIO = 0.5; // SSTs where at least this fraction of entries are tombstones get compacted
+
+// Bulk Load Configuration
+const size_t BULK_LOAD_SST_PAIRS = MAX_PAIRS * MAX_PAIRS; // Pairs per bulk-loaded SST (the leaf pages a single B-Tree Internal Node can index)
+const size_t BULK_LOAD_READ_PAIRS = 65536;                // Pairs read at a time from a bulk load file
+
+// External Sort Configuration
+const size_t EXTERNAL_SORT_RUN_PAIRS = 1048576;       // Pairs in each sorted run (16 MB)
+const int EXTERNAL_SORT_NUM_THREADS = 4;              // Runs sorted at once while the input is read
+const size_t EXTERNAL_SORT_MERGE_BUFFER_PAIRS = 4096; // Pairs read at a time from each run during the merge
+
+// Value Log Configuration
+const size_t VALUE_LOG_THRESHOLD = 256;              // Values of at least this many bytes are stored in the value log when it is enabled
+const size_t VALUE_LOG_SEGMENT_SIZE = 16 * MEGABYTE; // Bytes appended to a value log segment before a new one is started
+const int VALUE_LOG_PREFETCH_THREADS = 4;            // Values read at once by a scan of keys whose values are in the value log
+
+// Row Cache Configuration
+const size_t ROW_CACHE_SIZE = MEGABYTE; // Bytes of get results held by a row cache
+const int ROW_CACHE_NUM_SHARDS = 16;    // Shards of a row cache, each with its own LRU list and mutex
+
+// Bloom Filter Configuration
+const size_t BLOOM_FILTER_NUM_BITS = 2400;    // Number of bits in each SST's Bloom filter (at least)
+const size_t BLOOM_FILTER_BITS_PER_KEY = 10;  // Bits per key of the Bloom filter of an SST sized by SSTWriter::sizeFilter
+const int BLOOM_FILTER_NUM_HASHES = 3;        // Number of hash functions in each SST's Bloom filter
+
+// S+-Tree Configuration
+const size_t S_TREE_BLOCK_KEYS = 16;      // Keys in each S+-tree block (B)
+const size_t S_TREE_BLOCK_ALIGNMENT = 64; // Every S+-tree block starts on a cache line
+const long S_TREE_MAGIC = -3;             // First long of a B-Tree file written with the S+-tree layout
+
+// Learned Index Configuration
+const long LEARNED_INDEX_EPSILON = 64; // Largest error (in positions) of a learned index prediction, so a prediction spans at most two pages
+
+// SST Format Configuration
+const long SST_FORMAT_VERSION = 6;                 // Version of the single-file SST format (version 1 SSTs are separate sst_, btree_ and bloom_ files without a footer, version 3 adds the page encoding, version 4 the block compression, version 5 the page size, version 6 the tombstone and checksum blocks)
+const long SST_FOOTER_MAGIC = 0x3154414D52465353; // Last long of the footer page of a single-file SST ("SSFRMAT1")
+
 // Experiment Parameters
 const size_t DATA_SIZE = 1 * MEGABYTE * 1024;      // 1 GB total data size for experiment
 const size_t MEASUREMENT_INTERVAL = 10 * MEGABYTE; // Measure every 10 MB of data inserted
 
 // B-Tree Configuration
-const size_t BTREE_PAGE_SIZE = sizeof(bool)                // is_leaf flag
-                               + sizeof(int)               // num_keys count
-                               + sizeof(long) * MAX_PAIRS  // array of keys
-                               + sizeof(long) * MAX_PAIRS; // array of pages or values
+const size_t BTREE_PAGE_SIZE = PageLayout<long, long>::BTREE_PAGE_SIZE; // is_leaf flag, num_keys count, arrays of keys and of pages or values
 
 #endif // GLOBALS_H
@@ -0,0 +1,67 @@
+#ifndef LEARNED_INDEX_H
+#define LEARNED_INDEX_H
+
+#include "global.h"
+#include <vector>
+#include <cstddef>
+
+/*
+    Represents one piece of a LearnedIndex: the line through (first_key,
+    first_position) with the given slope predicts the position of every key
+    from first_key up to the first key of the next segment.
+
+    Attributes:
+        first_key           The first key covered by the segment
+        first_position      The position of first_key in the SST
+        slope               The number of positions per unit of key
+*/
+struct LearnedSegment
+{
+    long first_key;
+    long first_position;
+    double slope;
+};
+
+/*
+    A piecewise-linear learned index (as in the PGM-index) over the sorted keys
+    of an SST. It maps a key to its position in the SST with a set of segments
+    that each predict the position of the keys they cover to within
+    LEARNED_INDEX_EPSILON positions. Keys are added in increasing order and the
+    segments are built in a single pass with the shrinking cone algorithm: the
+    range of slopes that keeps every key of the current segment within the error
+    bound is narrowed with each key, and a new segment starts once it is empty.
+    Uniformly distributed keys need very few segments, so the index is a few
+    bytes per page.
+
+    Attributes:
+        segments            The segments, in key order (the last one is still being built)
+        num_keys            The number of keys added
+        slope_low           The smallest slope that keeps the last segment within the error bound
+        slope_high          The largest slope that keeps the last segment within the error bound
+
+    Functions:
+        add                 Adds the next key (keys must be given in increasing order)
+        predict             Returns the predicted position of a key, within LEARNED_INDEX_EPSILON of its position
+        getNumKeys          Returns the number of keys added
+        getNumSegments      Returns the number of segments
+        getMemoryBytes      Returns the number of bytes used by the segments
+*/
+class LearnedIndex
+{
+private:
+    std::vector<LearnedSegment> segments;
+    long num_keys;
+    double slope_low;
+    double slope_high;
+
+public:
+    LearnedIndex();
+
+    void add(long key);
+    long predict(long key) const;
+    long getNumKeys() const;
+    size_t getNumSegments() const;
+    size_t getMemoryBytes() const;
+};
+
+#endif
@@ -4,7 +4,17 @@
 #include "global.h"
 #include "memtable.h"
 #include "sst.h"
+#include "rate_limiter.h"
+#include "external_sort.h"
+#include "mapped_file.h"
+#include "row_cache.h"
 #include <map>
+#include <atomic>
+#include <set>
+#include <queue>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <utility>
 #include <vector>
 #include <string>
@@ -15,42 +25,222 @@
 #include <cstring>
 #include <stdio.h>
 #include <climits>
+#include <chrono>
+#include <functional>
+#include <fstream>
 
 struct SST
 {
     int level;
     int level_index;
+    long run; // The sorted run of the SST (the SSTs written by one flush, bulk load or compaction)
+    uint64_t min_sequence; // The sequence number of the oldest write the SST holds
+    uint64_t max_sequence; // The sequence number of the newest write the SST holds
     std::string sst_filename;
     std::string btree_filename;
+    SSTMetadata metadata;
 
-    SST(int level, int level_index, std::string &sst_filename, std::string &btree_filename);
+    SST(int level, int level_index, std::string &sst_filename, std::string &btree_filename, SSTMetadata metadata = SSTMetadata());
     virtual ~SST() = default;
 };
 
+/*
+    Owns the memory mappings of the files of an LSMTree and deletes the files
+    of the SSTs that no version contains anymore. The tree and every version
+    share it (through a shared_ptr), so a version that a reader still holds
+    once the tree is destroyed can still remove its files. A mapping is handed
+    out as a shared_ptr that the reader holds while it reads the file, so
+    dropping the mappings (when the tree goes back to BUFFER_POOL reads) never
+    unmaps a file under a reader: it is unmapped once its last reader is done.
+
+    Attributes:
+        mapped_files        The mapping of every file read in MMAP mode
+        mutex               Serializes the changes to mapped_files and the access pattern hints
+
+    Functions:
+        getMappedFile       Returns the mapping of a file, mapping it the first time it is read
+        unmapAll            Drops every mapping (each is unmapped once no reader holds it)
+        deleteSSTFiles      Deletes the files of an SST and drops their mappings
+*/
+class SSTFileReclaimer
+{
+private:
+    std::map<std::string, std::shared_ptr<MappedFile>> mapped_files;
+    std::mutex mutex;
+
+    void unmapFile(const std::string &filename);
+
+public:
+    std::shared_ptr<MappedFile> getMappedFile(const std::string &filename, AccessPattern pattern);
+    void unmapAll();
+    void deleteSSTFiles(const SST &sst);
+};
+
+/*
+    A memtable that takes no more writes, with the sequence numbers of the
+    oldest and newest writes it holds. The active memtable is frozen when a
+    snapshot is taken, so the snapshot reads it as it is instead of a copy,
+    and it is flushed with the active memtable (to an SST of its own).
+*/
+struct FrozenMemtable
+{
+    Memtable *memtable;
+    uint64_t min_sequence;
+    uint64_t max_sequence;
+};
+
+/*
+    An immutable view of an LSMTree that get and scan read from: its memtables
+    and the SSTs of its levels at the time the version was installed. Flushes,
+    compactions and bulk loads build the next version and install it
+    atomically, so a reader takes the current version once (one atomic load of
+    a shared_ptr) and reads it without holding any lock of the tree, while the
+    tree keeps changing.
+
+    A version keeps the version installed after it alive (through next), so it
+    is freed only once every older version is. The SSTs and the memtables that
+    were dropped while it was current are then no longer in any version that a
+    reader could hold, and are removed when it is freed (by the file reclaimer
+    of the tree, which the version shares, so the tree may be gone by then).
+
+    Any number of threads may call get, scan and getVersion while writes go
+    on, each with its own BufferPool. Writes are serialized by the write mutex
+    of the tree, and the active memtable (an AVL tree updated in place) is
+    probed under a shared lock. The settings that readers follow (setReadMode,
+    setFencePointers, ...) are atomic, so they may change while other threads
+    read.
+
+    Attributes:
+        file_reclaimer      The file reclaimer of the tree, which removes the files of the obsolete SSTs
+        memtable            The memtable of the version (the active one is read under the memtable mutex of the tree)
+        frozen_memtables    The frozen memtables of the version, from oldest to newest
+        levels              The SSTs in each level of the version, from oldest to newest
+        next                The version installed after this one
+        obsolete_ssts       The SSTs dropped while this version was current, removed when it is freed
+        obsolete_memtables  The memtables flushed while this version was current, freed when it is
+*/
+struct LSMVersion
+{
+    std::shared_ptr<SSTFileReclaimer> file_reclaimer;
+    Memtable *memtable;
+    std::vector<FrozenMemtable> frozen_memtables;
+    std::vector<std::vector<SST>> levels;
+    std::shared_ptr<LSMVersion> next;
+    std::vector<SST> obsolete_ssts;
+    std::vector<Memtable *> obsolete_memtables;
+
+    ~LSMVersion();
+};
+
 class LSMTree
 {
 private:
+    // Serializes a write to the tree, and installs a new version once the outermost write that changed the levels is done
+    struct WriteLock
+    {
+        LSMTree &lsm_tree;
+        WriteLock(LSMTree &lsm_tree, bool changes_levels);
+        ~WriteLock();
+    };
+
     Memtable *memtable;
+    uint64_t memtable_min_sequence = 1; // The sequence number of the first write the active memtable may hold
+    std::vector<FrozenMemtable> frozen_memtables;
     std::vector<std::vector<SST>> levels;
     int max_level = MAX_LSM_LEVEL;
     std::string database_name;
     size_t memtable_size;
     size_t level_size_ratio = LEVEL_SIZE_RATIO;
+    std::atomic<RateLimiter *> rate_limiter{nullptr};
+    std::atomic<RowCache *> row_cache{nullptr};
+    std::atomic<ReadMode> read_mode{ReadMode::BUFFER_POOL};
+    std::atomic<bool> use_fence_pointers{true};
+    std::atomic<bool> use_learned_index{false};
+    std::atomic<SSTSearchMode> sst_search_mode{SSTSearchMode::BINARY};
+    PageEncoding page_encoding = DEFAULT_PAGE_ENCODING;
+    std::vector<CompressionType> level_compression;
+    size_t page_size = PAGE_SIZE;
+    int first_page_level = 0;
+    std::shared_ptr<SSTFileReclaimer> file_reclaimer = std::make_shared<SSTFileReclaimer>();
+    std::shared_ptr<LSMVersion> current_version;
+    std::recursive_mutex write_mutex;
+    int write_depth = 0;
+    bool is_version_stale = false;
+    std::shared_mutex memtable_mutex;
+    std::vector<SST> retired_ssts;
+    std::vector<Memtable *> retired_memtables;
+    long next_run = 0;
+    std::atomic<uint64_t> last_sequence{0};
+    std::map<uint64_t, long> snapshots; // The live snapshots, with the number of times each was taken
+    std::mutex snapshots_mutex;
 
     std::pair<SST &, SST &> fileCompare(SST &sst1, SST &sst2);
-    std::pair<std::string, std::string> mergeSSTs(SST &sst1, SST &sst2, bool last_level);
+    bool mergeSSTs(const std::vector<SST> &inputs, bool last_level, int output_level, std::vector<SST> &outputs);
+    size_t countRuns(int level_idx);
+    uint64_t getStripe(uint64_t sequence);
+    bool hasSnapshotBefore(uint64_t sequence);
+    off_t getLevelBytes(const std::vector<SST> &ssts);
+    size_t getPageSize(int level);
+    bool rewriteSST(SST &sst);
+    void removeSSTFiles(const SST &sst);
+    void deleteSSTFiles(const SST &sst);
+    void installVersion();
+    bool loadBloomFilter(const SST &sst, BloomFilter &bloom_filter, BufferPool *buffer_pool);
+    std::shared_ptr<MappedFile> getMappedFile(const std::string &filename, AccessPattern pattern);
+    bool levelsOverlap(long key1, long key2, int first_level);
+    bool olderSiblingsOverlap(int level_idx, size_t position);
+    bool isTrivialMove(int level_idx, size_t position);
+    NodeFileOffset *getFromTree(long key, BufferPool *buffer_pool, bool with_btree, std::shared_ptr<const LSMVersion> version, uint64_t snapshot);
+    NodeFileOffset *getFromRowCache(long key, BufferPool *buffer_pool, bool with_btree, std::shared_ptr<const LSMVersion> version, uint64_t snapshot);
+    std::shared_ptr<const LSMVersion> findSnapshot(uint64_t snapshot);
+    bool isMemtableFull();
+    bool memtablesOverlap(long key1, long key2);
+    void flushMemtable();
+    void addLevel0SST(std::string sst_filename, std::string btree_filename, const SSTMetadata &metadata, uint64_t min_sequence, uint64_t max_sequence);
+    bool writeBulkLoad(const std::function<bool(long &key, long &value)> &next_pair, std::vector<SST> &loaded_ssts);
+    void registerBulkLoad(std::vector<SST> &loaded_ssts);
 
 public:
     LSMTree(size_t memtable_size, std::string database, Memtable *memtable);
-    ~LSMTree() = default;
+    ~LSMTree();
 
     void put(long key, long value);
-    void insertSST(std::string sst_filename, std::string btree_filename);
-    NodeFileOffset *get(long key, BufferPool *buffer_pool, bool with_btree);
-    std::pair<std::pair<long, long> *, int> scan(long key1, long key2, BufferPool *buffer_pool, bool with_btree);
+    void deleteRange(long key1, long key2);
+    bool bulkLoad(const std::function<bool(long &key, long &value)> &next_pair);
+    bool bulkLoad(const std::vector<std::pair<long, long>> &sorted_pairs);
+    bool bulkLoadFile(const std::string &filename);
+    bool ingestUnsorted(const std::function<bool(long &key, long &value)> &next_pair);
+    bool ingestFile(const std::string &filename);
+    bool insertSST(std::string sst_filename, std::string btree_filename, const SSTMetadata *metadata = nullptr);
+    NodeFileOffset *get(long key, BufferPool *buffer_pool, bool with_btree, uint64_t snapshot = LATEST_SEQUENCE);
+    std::pair<std::pair<long, long> *, int> scan(long key1, long key2, BufferPool *buffer_pool, bool with_btree, uint64_t snapshot = LATEST_SEQUENCE);
+    uint64_t getSnapshot();
+    void releaseSnapshot(uint64_t snapshot);
+    uint64_t getLastSequence();
+    void setRateLimiter(RateLimiter *new_rate_limiter);
+    RateLimiter *getRateLimiter();
+    void setRowCache(RowCache *new_row_cache);
+    RowCache *getRowCache();
+    void setReadMode(ReadMode new_read_mode);
+    ReadMode getReadMode();
+    void setFencePointers(bool enabled);
+    size_t getFencePointerMemory();
+    void setLearnedIndex(bool enabled);
+    size_t getLearnedIndexMemory();
+    void setSSTSearchMode(SSTSearchMode new_sst_search_mode);
+    SSTSearchMode getSSTSearchMode();
+    void setPageEncoding(PageEncoding new_page_encoding);
+    PageEncoding getPageEncoding();
+    bool setLevelCompression(int level, CompressionType compression);
+    CompressionType getLevelCompression(int level);
+    bool setPageSize(size_t new_page_size, int first_level = 0);
     Memtable *changeMemtable(Memtable *new_memtable);
+    Memtable *getMemtable();
     void freeMemtable();
     void compactLevels();
+    void compactTombstones();
+    const std::vector<std::vector<SST>> &getLevels();
+    std::shared_ptr<const LSMVersion> getVersion();
     void printLSMTree();
 };
 
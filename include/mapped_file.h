@@ -0,0 +1,79 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "global.h"
+#include <string>
+#include <cstddef>
+
+/*
+    Represents how LSMTree::get and LSMTree::scan read the pages of an SST.
+
+    Values:
+        BUFFER_POOL         Every page is read with pread and cached in the BufferPool.
+        MMAP                Every file is mapped once and its pages are read in place.
+*/
+enum class ReadMode
+{
+    BUFFER_POOL = 0,
+    MMAP = 1
+};
+
+/*
+    Represents the access pattern hinted to the kernel with madvise.
+
+    Values:
+        NORMAL              No hint (the default readahead).
+        RANDOM              Point lookups, readahead is disabled.
+        SEQUENTIAL          Range scans, aggressive readahead.
+*/
+enum class AccessPattern
+{
+    NORMAL = 0,
+    RANDOM = 1,
+    SEQUENTIAL = 2
+};
+
+/*
+    A read-only memory mapping of a whole file. The file is mapped once and
+    its pages can then be read in place without a system call or a copy.
+
+    Input:
+        filename            The name of the file to map.
+
+    Attributes:
+        filename            The name of the mapped file
+        data                The start of the mapping (nullptr if the file could not be mapped)
+        size                The size of the mapping in bytes
+        access_pattern      The last access pattern given to madvise
+
+    Functions:
+        isMapped            Returns whether the file was mapped
+        getData             Returns the start of the mapping
+        getSize             Returns the size of the mapping in bytes
+        getNumPages         Returns the number of whole pages in the mapping
+        getPage             Returns the page at the given index (nullptr if it is past the end)
+        advise              Gives the kernel a hint about the access pattern (only calls madvise when it changes)
+*/
+class MappedFile
+{
+private:
+    std::string filename;
+    char *data;
+    size_t size;
+    AccessPattern access_pattern;
+
+public:
+    MappedFile(const std::string &filename);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isMapped() const;
+    const char *getData() const;
+    size_t getSize() const;
+    long getNumPages() const;
+    const char *getPage(long page_index) const;
+    void advise(AccessPattern pattern);
+};
+
+#endif
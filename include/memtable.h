@@ -3,6 +3,7 @@
 
 #include "global.h"
 #include "buffer_pool.h"
+#include "range_tombstone.h"
 #include <utility> // for pair
 #include <vector>  // for tuple
 #include <string>
@@ -11,25 +12,27 @@
     Create an Node that stores key-value pairs.
 
     Input:
-        key                 8-byte int (long) associated with the value input.
-        value               8-byte int (long) associated with the key input.
+        key                 Key (of any signed integer type, a long by default) associated with the value input.
+        value               Value (trivially copyable, a long by default) associated with the key input.
 
     Attributes:
         left                pointer to the Node's left child
         right               pointer to the Node's right child
         height              the height of the Node
 */
-struct Node
+template <typename Key, typename Value>
+struct BasicNode
 {
-    long key;
-    long value;
-    Node *left;
-    Node *right;
+    Key key;
+    Value value;
+    BasicNode *left;
+    BasicNode *right;
     int height;
 
-    Node(long k, long v);
-    ~Node();
+    BasicNode(Key k, Value v);
+    ~BasicNode();
 };
+using Node = BasicNode<long, long>;
 
 /*
     Represents the 3-value return value for the get and binarySearch function.
@@ -48,7 +51,10 @@ struct NodeFileOffset
 typedef struct NodeFileOffset NodeFileOffset;
 
 /*
-    Create an AVL Binary Tree (Memtable) that stores instances of the Node class.
+    Create an AVL Binary Tree (Memtable) that stores instances of the Node class,
+    for keys and values of the given types (their page layout is
+    PageLayout<Key, Value>). The Memtable of the LSMTree is the one of long keys
+    and values, the TypedLSMTree uses the others.
 
     Input:
         memtable_size   the max size of the newly initialized Memtable
@@ -57,6 +63,7 @@ typedef struct NodeFileOffset NodeFileOffset;
         rootNode            the root Node of the entire tree
         memtable_size       the max size that the Memtable can be
         currSize            the current number of Nodes stored in the tree
+        range_tombstones    the key ranges deleted since the Memtable was created
 
     Functions:
         getHeight           gets the height of the input Node
@@ -64,35 +71,67 @@ typedef struct NodeFileOffset NodeFileOffset;
         rotateRight         rotates the sub-tree at the input Node right
         rotateLeft          rotates the sub-tree at the input Node left
         insert              inserts the input Node into the tree if there is enough space
+        getMinNode          finds the Node with the smallest key in the sub-tree
+        remove              removes the Node with the input key from the sub-tree
+        rebalance           rotates the sub-tree at the input Node until it is balanced
         get                 finds all of the Nodes with the input key and returns an array of values
+        deleteRange         removes all of the Nodes in [key1, key2] and stores a range tombstone for it
+        getRangeTombstones  returns the key ranges deleted with deleteRange
         deleteTree          recursively deletes the input Node and all of its children Nodes
 */
-class Memtable
+template <typename Key, typename Value>
+class BasicMemtable
 {
-private:
-    Node *root_node;
+protected:
+    using NodeType = BasicNode<Key, Value>;
+
+    NodeType *root_node;
     int memtable_size;
     int curr_size;
-    int getHeight(Node *node);
-    int getBalanceFactor(Node *node);
-    Node *rotateRight(Node *curr_root);
-    Node *rotateLeft(Node *curr_root);
-    Node *insert(Node *curr_root, long key, long value);
-    Node *get(Node *curr_root, long key);
-    void scan(Node *curr_root, long key1, long key2, std::vector<std::pair<long, long>> *found_nodes);
+    RangeTombstones range_tombstones;
+    int getHeight(NodeType *node);
+    int getBalanceFactor(NodeType *node);
+    NodeType *rotateRight(NodeType *curr_root);
+    NodeType *rotateLeft(NodeType *curr_root);
+    NodeType *insert(NodeType *curr_root, Key key, Value value);
+    NodeType *getMinNode(NodeType *curr_root);
+    NodeType *remove(NodeType *curr_root, Key key);
+    NodeType *rebalance(NodeType *curr_root);
+    NodeType *get(NodeType *curr_root, Key key);
+    void scan(NodeType *curr_root, Key key1, Key key2, std::vector<std::pair<Key, Value>> *found_nodes);
+
+public:
+    BasicMemtable(int memtable_size);
+    ~BasicMemtable();
+    void put(Key key, Value value);
+    NodeType *get(Key key);
+    std::pair<std::pair<Key, Value> *, int> scan(Key key1, Key key2);
+    void deleteRange(Key key1, Key key2);
+    const RangeTombstones &getRangeTombstones();
+    int getMemtableSize();
+    int getCurrSize();
+    void deleteTree(NodeType *curr_root);
+};
+
+/*
+    The Memtable of long keys and values, which can also be searched together
+    with the separate-file SSTs of a database.
 
+    Input:
+        memtable_size   the max size of the newly initialized Memtable
+
+    Functions:
+        get                 finds the Node of the input key in the Memtable, then in the SSTs of the database
+        scan                finds the key-value pairs in [key1, key2] in the Memtable and the SSTs of the database
+*/
+class Memtable : public BasicMemtable<long, long>
+{
 public:
     Memtable(int memtable_size);
-    ~Memtable();
-    void put(long key, long value);
-    Node *get(long key);
+    using BasicMemtable<long, long>::get;
+    using BasicMemtable<long, long>::scan;
     NodeFileOffset *get(long key, const std::string current_database, BufferPool *buffer_pool);
-    std::pair<std::pair<long, long> *, int> scan(long key1, long key2);
     std::pair<std::pair<long, long> *, int> scan(long key1, long key2, const std::string current_database, BufferPool *buffer_pool);
-    // void delete(long key); // Need to implement a delete function given a key
-    int getMemtableSize();
-    int getCurrSize();
-    void deleteTree(Node *curr_root);
 };
 
 #endif
\ No newline at end of file
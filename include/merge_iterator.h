@@ -0,0 +1,67 @@
+#ifndef MERGE_ITERATOR_H
+#define MERGE_ITERATOR_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+    Merges the sorted key-value pairs of the SSTs of a compaction into one
+    stream in key order, in which every key appears once with its value from
+    the newest SST that holds it. Shared by the compactions of the LSMTree
+    (over SSTIterators) and of the TypedLSMTree (over TypedSSTIterators). A
+    heap of the inputs gives the smallest key next, and of the inputs with
+    that key the newest; the older values of the key are skipped.
+
+    Input:
+        iterators           The iterators of the SSTs, from the oldest to the newest (they must outlive the MergeIterator).
+
+    Attributes:
+        iterators           The iterators of the SSTs, from the oldest to the newest
+        heap                The indexes of the iterators that hold a pair left, ordered by isAfter
+        curr_key            The current key
+        curr_value          The current value (of the newest SST that holds the key)
+        curr_source         The index of the iterator the current value comes from
+        is_valid            Whether the MergeIterator points at a key-value pair
+
+    Functions:
+        isAfter             Returns whether an iterator comes after another in the heap
+        advance             Advances an iterator and puts it back in the heap if it has a pair left
+        readNext            Moves to the smallest key left and skips its older values
+        valid               Returns whether the MergeIterator points at a key-value pair
+        hasError            Returns whether an input could not be read
+        key                 Returns the current key
+        value               Returns the current value
+        source              Returns the index of the iterator the current value comes from
+        next                Advances to the next key
+*/
+template <typename Iterator>
+class MergeIterator
+{
+private:
+    using Key = decltype(std::declval<Iterator &>().key());
+    using Value = decltype(std::declval<Iterator &>().value());
+
+    std::vector<Iterator *> iterators;
+    std::vector<size_t> heap;
+    Key curr_key;
+    Value curr_value;
+    size_t curr_source;
+    bool is_valid;
+
+    bool isAfter(size_t a, size_t b);
+    void advance(size_t index);
+    void readNext();
+
+public:
+    MergeIterator(const std::vector<Iterator *> &iterators);
+
+    bool valid();
+    bool hasError();
+    Key key();
+    Value value();
+    size_t source();
+    void next();
+};
+
+#endif
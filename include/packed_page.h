@@ -0,0 +1,102 @@
+#ifndef PACKED_PAGE_H
+#define PACKED_PAGE_H
+
+#include "global.h"
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+/*
+    Represents the instruction set used to decode the keys of a packed page.
+
+    Values:
+        SCALAR              Plain C++, available everywhere.
+        AVX2                Unpacks and prefix sums 4 keys at once.
+*/
+enum class DecodeKernel
+{
+    SCALAR = 0,
+    AVX2 = 1
+};
+
+const long PACKED_PAGE_HEADER_LONGS = 5;                                                    // num_pairs, bit_width, first_key, last_key and min_delta
+const long PACKED_PAGE_MAX_PAIRS = PAGE_SIZE / sizeof(long) - PACKED_PAGE_HEADER_LONGS - 1; // Pairs of a packed page whose keys are evenly spaced
+
+/*
+    A packed SST page stores the values of its key-value pairs as raw longs and
+    its keys with delta and frame-of-reference encoding: the difference between
+    each key and the key before it, minus the smallest such difference in the
+    page, is bit-packed with the fewest bits that fit the largest one. As page
+    longs:
+
+        [0]                 num_pairs, the number of key-value pairs in the page
+        [1]                 bit_width, the number of bits of every packed key
+        [2], [3]            first_key and last_key, so pages can be searched without decoding them
+        [4]                 min_delta, the frame of reference of the packed keys
+        [5, 5 + num_pairs)  the values
+        [5 + num_pairs, ..) the num_pairs - 1 packed keys, as a little-endian bit stream of 64-bit words
+
+    One long is always left free after the packed keys, so a decoder may read
+    the word after the last packed key. Sorted keys that are close together take
+    a few bits each, so a page holds up to PACKED_PAGE_MAX_PAIRS pairs instead of
+    MAX_PAIRS, and scans read proportionally fewer pages.
+
+    Attributes:
+        keys                The keys added to the page
+        values              The values added to the page
+        num_pairs           The number of key-value pairs added to the page
+        min_delta           The smallest difference between two consecutive keys of the page
+        max_delta           The largest difference between two consecutive keys of the page
+
+    Functions:
+        add                 Adds a key-value pair (keys must be strictly increasing), returns false if the page is full
+        write               Writes the packed page into a PAGE_SIZE buffer
+        clear               Removes every key-value pair
+        empty               Returns whether no key-value pair was added
+        size                Returns the number of key-value pairs added
+        getLastKey          Returns the last key added
+*/
+class PackedPageBuilder
+{
+private:
+    long keys[PACKED_PAGE_MAX_PAIRS];
+    long values[PACKED_PAGE_MAX_PAIRS];
+    long num_pairs;
+    long min_delta;
+    long max_delta;
+
+public:
+    PackedPageBuilder();
+
+    bool add(long key, long value);
+    void write(void *page) const;
+    void clear();
+    bool empty() const;
+    long size() const;
+    long getLastKey() const;
+};
+
+long getPackedBitWidth(uint64_t max_offset);
+long getPackedPageLongs(long num_pairs, long bit_width);
+
+long getPackedPageNumPairs(const char *page);
+long getPackedPageFirstKey(const char *page);
+long getPackedPageLastKey(const char *page);
+const long *getPackedPageValues(const char *page);
+
+/*
+    Decodes the keys of a packed page into keys (which must hold
+    PACKED_PAGE_MAX_PAIRS longs) with the fastest kernel the CPU supports
+    (chosen once at runtime). Returns the number of key-value pairs in the page.
+*/
+long decodePackedKeys(const char *page, long *keys);
+
+long findPackedKey(const char *page, long key);
+bool scanPackedPage(const char *page, long key1, long key2, std::vector<std::pair<long, long>> &results);
+
+DecodeKernel getPackedDecodeKernel();
+bool setPackedDecodeKernel(DecodeKernel kernel);
+bool isPackedDecodeKernelSupported(DecodeKernel kernel);
+const char *getPackedDecodeKernelName(DecodeKernel kernel);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PAGE_SEARCH_H
+#define PAGE_SEARCH_H
+
+#include "global.h"
+#include <cstdint>
+
+/*
+    Represents the instruction set used to search the keys of a page.
+
+    Values:
+        SCALAR              Plain C++, available everywhere.
+        AVX2                Compares 4 longs (or 8 4-byte keys) at once.
+        AVX512              Compares 8 longs (or 16 4-byte keys) at once.
+*/
+enum class SearchKernel
+{
+    SCALAR = 0,
+    AVX2 = 1,
+    AVX512 = 2
+};
+
+const long PAGE_SEARCH_WINDOW = 16; // Keys left when the binary search stops and the keys are compared with SIMD
+
+/*
+    Lower bound search within a page. Returns the number of keys in keys[0],
+    keys[stride], ..., keys[(num_keys - 1) * stride] that are valid (not
+    negative) and smaller than key. Since the valid keys of a page are sorted
+    and come before any padding (INTERNAL or LEAF), this is the index of the
+    first key that is not smaller than key. Use a stride of 2 for the
+    interleaved key-value pairs of SST and B-Tree pages and 1 for a plain array
+    of keys.
+
+    The search halves the range without branches until PAGE_SEARCH_WINDOW keys
+    are left, then compares the rest with the fastest kernel the CPU supports
+    (chosen once at runtime). Pages of 4-byte keys (see PageLayout) hold twice
+    as many keys and are compared twice as many at a time.
+*/
+long pageLowerBound(const long *keys, long num_keys, long stride, long key);
+long pageLowerBound(const int32_t *keys, long num_keys, long stride, int32_t key);
+
+/*
+    Lower bound search within a page of sorted keys that has no padding, so
+    negative keys are counted like any other (such as the columnar pages of a
+    TypedSST, whose last page repeats its last key). Returns the number of keys
+    smaller than key, searched like pageLowerBound.
+*/
+long signedPageLowerBound(const long *keys, long num_keys, long stride, long key);
+long signedPageLowerBound(const int32_t *keys, long num_keys, long stride, int32_t key);
+
+SearchKernel getPageSearchKernel();
+bool setPageSearchKernel(SearchKernel kernel);
+bool isPageSearchKernelSupported(SearchKernel kernel);
+const char *getPageSearchKernelName(SearchKernel kernel);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef RANGE_TOMBSTONE_H
+#define RANGE_TOMBSTONE_H
+
+#include <vector>
+#include <utility>
+#include <string>
+
+/*
+    Stores the key ranges deleted by DeleteRange(key1, key2) for a Memtable or
+    an SST. The ranges are inclusive, sorted by their first key and coalesced,
+    so a lookup is a single binary search. A range tombstone only hides values
+    in older Memtables and SSTs: key-value pairs stored alongside it are always
+    newer than it.
+
+    Attributes:
+        ranges              The sorted, non-overlapping deleted key ranges
+
+    Functions:
+        add                 Deletes the key range [key1, key2]
+        merge               Adds all of the key ranges of another RangeTombstones
+        covers              Returns whether the given key is in a deleted key range
+        empty               Returns whether there are no deleted key ranges
+        size                Returns the number of deleted key ranges
+        getRanges           Returns the deleted key ranges
+        serialize           Writes the deleted key ranges to a file
+        loadFromFile        Reads the deleted key ranges from a file written by serialize
+*/
+class RangeTombstones
+{
+private:
+    std::vector<std::pair<long, long>> ranges;
+
+public:
+    void add(long key1, long key2);
+    void merge(const RangeTombstones &other);
+    bool covers(long key) const;
+    bool empty() const;
+    size_t size() const;
+    const std::vector<std::pair<long, long>> &getRanges() const;
+    bool serialize(const std::string &filename) const;
+    bool loadFromFile(const std::string &filename);
+};
+
+#endif
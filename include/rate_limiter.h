@@ -0,0 +1,113 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include "global.h"
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+/*
+    Represents the priority of an I/O request made to the RateLimiter. Lower
+    values are served first whenever requests of several priorities are waiting.
+
+    Values:
+        HIGH                Memtable flushes (writeMemtableToDisk), which block puts.
+        MEDIUM              Compactions of level 0.
+        LOW                 Compactions of every deeper level.
+*/
+enum class IOPriority
+{
+    HIGH = 0,
+    MEDIUM = 1,
+    LOW = 2
+};
+
+const int NUM_IO_PRIORITIES = 3;
+
+/*
+    A token-bucket I/O rate limiter shared by flushes and compactions so that
+    background writes cannot saturate the disk and inflate foreground latency.
+
+    A budget of 0 bytes per second means no limit: every request is granted
+    at once (and only accounted for).
+
+    Input:
+        bytes_per_second        The number of bytes per second that may be written (0 for no limit).
+
+    Attributes:
+        bytes_per_second        The current budget in bytes per second (0 for no limit)
+        available_bytes         The tokens currently in the bucket (may go negative for large requests)
+        max_burst_bytes         The maximum number of tokens the bucket may hold
+        last_refill             The last time tokens were added to the bucket
+        num_waiting             The number of requests waiting at each priority
+        auto_tune               Whether the budget is tuned from foreground latency
+        target_latency          The foreground latency (in seconds) auto-tuning aims to stay under
+        min_bytes_per_second    The smallest budget auto-tuning may choose (at least RATE_LIMITER_MIN_BYTES_PER_SECOND)
+        max_bytes_per_second    The largest budget auto-tuning may choose
+        latency_average         Exponential moving average of recorded foreground latencies
+        latency_samples         The number of latencies recorded since the last tuning step
+        total_bytes             The total number of bytes granted at each priority
+        window_start            The start of the current compaction throughput window
+        window_bytes            The compaction bytes granted in the current window
+        compaction_rate         The compaction bytes per second measured over the last full window
+        has_full_window         Whether a compaction throughput window has been closed yet
+
+    Functions:
+        refill                  Adds the tokens accumulated since last_refill to the bucket
+        isHigherPriorityWaiting Checks whether a request with a higher priority is waiting
+        closeWindow             Closes the compaction throughput window once it has lasted long enough
+        recordGrant             Updates the metrics after a request has been granted
+        request                 Blocks until the given number of bytes may be written
+        setBytesPerSecond       Changes the budget
+        getBytesPerSecond       Returns the budget
+        enableAutoTune          Tunes the budget from recorded foreground latencies
+        disableAutoTune         Stops tuning the budget
+        recordForegroundLatency Records the latency of a foreground operation (e.g. get)
+        getCompactionBytesPerSecond Returns the compaction bytes per second the limiter has allowed
+        getTotalBytes           Returns the total bytes granted at the given priority
+*/
+class RateLimiter
+{
+private:
+    std::mutex mutex;
+    std::condition_variable tokens_available;
+    double bytes_per_second;
+    double available_bytes;
+    double max_burst_bytes;
+    std::chrono::steady_clock::time_point last_refill;
+    int num_waiting[NUM_IO_PRIORITIES];
+
+    bool auto_tune;
+    double target_latency;
+    double min_bytes_per_second;
+    double max_bytes_per_second;
+    double latency_average;
+    int latency_samples;
+
+    size_t total_bytes[NUM_IO_PRIORITIES];
+    std::chrono::steady_clock::time_point window_start;
+    size_t window_bytes;
+    double compaction_rate;
+    bool has_full_window;
+
+    void refill();
+    bool isHigherPriorityWaiting(IOPriority priority);
+    void closeWindow();
+    void recordGrant(size_t bytes, IOPriority priority);
+
+public:
+    RateLimiter(size_t bytes_per_second);
+    ~RateLimiter() = default;
+
+    void request(size_t bytes, IOPriority priority);
+    void setBytesPerSecond(size_t bytes_per_second);
+    size_t getBytesPerSecond();
+    void enableAutoTune(double target_latency, size_t min_bytes_per_second, size_t max_bytes_per_second);
+    void disableAutoTune();
+    void recordForegroundLatency(double latency);
+    double getCompactionBytesPerSecond();
+    size_t getTotalBytes(IOPriority priority);
+};
+
+#endif
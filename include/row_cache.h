@@ -0,0 +1,117 @@
+#ifndef ROW_CACHE_H
+#define ROW_CACHE_H
+
+#include "global.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Represents the result of a get that is held by a RowCache.
+
+    Attributes:
+        key                 The key that was searched for
+        value               The value found (LONG_MIN for a tombstone)
+        is_found            Whether the key was found in the tree (false caches its absence)
+*/
+struct RowCacheEntry
+{
+    long key;
+    long value;
+    bool is_found;
+};
+
+// Bytes charged for an entry: the entry in its LRU list node and its slot in the hash table of the shard
+const size_t ROW_CACHE_ENTRY_BYTES = sizeof(RowCacheEntry) + 2 * sizeof(void *) + sizeof(long) + sizeof(std::list<RowCacheEntry>::iterator) + 2 * sizeof(void *);
+
+/*
+    Represents a shard of a RowCache: an LRU list of entries, the hash table
+    finding them, and the mutex guarding both.
+
+    Attributes:
+        mutex               Guards every other attribute of the shard
+        lru                 The entries of the shard, most recently used first
+        entries             Maps every key of the shard to its position in the lru
+        bytes               The number of bytes charged for the entries of the shard
+        generation          Incremented whenever an entry of the shard is invalidated
+        num_hits            The number of lookups of the shard that found their key
+        num_misses          The number of lookups of the shard that did not
+*/
+struct RowCacheShard
+{
+    std::mutex mutex;
+    std::list<RowCacheEntry> lru;
+    std::unordered_map<long, std::list<RowCacheEntry>::iterator> entries;
+    size_t bytes = 0;
+    uint64_t generation = 0;
+    long num_hits = 0;
+    long num_misses = 0;
+};
+
+/*
+    A cache of the results of recent gets (the value of a key, or the fact that
+    it is absent), checked by LSMTree::get before the memtable and the levels,
+    so that a hot key costs a hash lookup instead of a Bloom filter probe per
+    level and a page read (or buffer pool lookup and copy) per B-Tree level.
+    The keys are spread over num_shards shards, each an LRU list bounded by
+    capacity / num_shards bytes with its own mutex, so concurrent gets rarely
+    wait on each other.
+
+    A write must invalidate the keys it changes (erase or eraseRange) once it
+    is visible to gets. Invalidating a key increments the generation of its
+    shard, and a result is only inserted if the generation has not changed
+    since its lookup, so a get that raced with a write cannot cache the old
+    value.
+
+    Input:
+        capacity            The max number of bytes charged for the entries of the cache.
+        num_shards          The number of shards the keys are spread over.
+
+    Attributes:
+        capacity            The max number of bytes of the cache
+        shards              The shards of the cache
+
+    Functions:
+        getShard            Returns the shard of a key
+        lookup              Finds the cached result of a get, otherwise returns the generation to insert it with
+        insert              Caches the result of a get, unless its shard was invalidated since the lookup
+        erase               Invalidates a key
+        eraseRange          Invalidates every key in [key1, key2]
+        clear               Invalidates every key
+        getNumEntries       Returns the number of cached results
+        getBytes            Returns the number of bytes charged for the cached results
+        getCapacity         Returns the max number of bytes of the cache
+        getNumHits          Returns the number of lookups that found their key
+        getNumMisses        Returns the number of lookups that did not
+        getHitRate          Returns the fraction of lookups that found their key
+        resetStats          Resets the numbers of hits and misses
+*/
+class RowCache
+{
+private:
+    size_t capacity;
+    std::vector<RowCacheShard> shards;
+
+    RowCacheShard &getShard(long key);
+
+public:
+    RowCache(size_t capacity = ROW_CACHE_SIZE, int num_shards = ROW_CACHE_NUM_SHARDS);
+    ~RowCache() = default;
+
+    bool lookup(long key, long &value, bool &is_found, uint64_t &generation);
+    void insert(long key, long value, bool is_found, uint64_t generation);
+    void erase(long key);
+    void eraseRange(long key1, long key2);
+    void clear();
+    long getNumEntries();
+    size_t getBytes();
+    size_t getCapacity();
+    long getNumHits();
+    long getNumMisses();
+    double getHitRate();
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef S_TREE_H
+#define S_TREE_H
+
+#include "global.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/*
+    A static S+-tree over a sorted array of keys, laid out for the cache instead
+    of for the disk. Keys are stored in blocks of S_TREE_BLOCK_KEYS keys aligned
+    to S_TREE_BLOCK_ALIGNMENT bytes. The bottom layer holds the sorted keys
+    themselves (padded with LONG_MAX), and every layer above holds, for each
+    child block but the first, the smallest key of that child's subtree, so each
+    block has S_TREE_BLOCK_KEYS + 1 children. A search reads one block per layer
+    and ranks the key within the block without branches, prefetching the next
+    block as soon as it is known.
+
+    Attributes:
+        keys                The blocks of every layer, from the bottom layer up
+        num_keys            The number of sorted keys indexed
+        num_longs           The number of longs in keys (all layers, including padding)
+        height              The number of layers
+        layer_offsets       The offset (in longs) of the first block of every layer
+        owns_keys           Whether keys was allocated by this S+-tree (otherwise it points into a mapping)
+
+    Functions:
+        release             Frees the blocks if they are owned
+        numBlocks           Returns the number of blocks needed for the given number of keys
+        prevKeys            Returns the number of keys in the layer above a layer of the given number of keys
+        computeLayout       Computes height, layer_offsets and num_longs for num_keys
+        rank                Returns the number of keys in a block that are smaller than the key
+        build               Builds the S+-tree from a sorted vector of keys
+        load                Uses S+-tree blocks written by write, in place or copied
+        write               Writes the blocks to a file, one page at a time
+        lowerBound          Returns the index of the first key that is not smaller than the key
+        getNumKeys          Returns the number of sorted keys indexed
+        getMemoryBytes      Returns the number of bytes used by the blocks
+        getNumLongs         Returns the number of longs in the blocks
+        getHeight           Returns the number of layers
+*/
+class STree
+{
+private:
+    long *keys;
+    long num_keys;
+    long num_longs;
+    int height;
+    std::vector<long> layer_offsets;
+    bool owns_keys;
+
+    static long numBlocks(long n);
+    static long prevKeys(long n);
+    void computeLayout();
+    static long rank(const long *block, long key);
+    void release();
+
+public:
+    STree();
+    ~STree();
+    STree(const STree &other);
+    STree &operator=(const STree &other);
+
+    bool build(const std::vector<long> &sorted_keys);
+    bool load(const long *blocks, long num_keys, bool copy);
+    bool write(int fd, void *buffer, size_t &write_offset, std::vector<uint32_t> *checksums = nullptr);
+    long lowerBound(long key) const;
+    long getNumKeys() const;
+    size_t getMemoryBytes() const;
+    long getNumLongs() const;
+    int getHeight() const;
+};
+
+#endif
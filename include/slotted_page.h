@@ -0,0 +1,97 @@
+#ifndef SLOTTED_PAGE_H
+#define SLOTTED_PAGE_H
+
+#include "global.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const size_t SLOTTED_PAGE_HEADER_SIZE = 2 * sizeof(uint32_t);   // num_slots and records_start
+const size_t SLOTTED_SLOT_SIZE = sizeof(uint32_t);              // Offset of a record
+const size_t SLOTTED_RECORD_HEADER_SIZE = 2 * sizeof(uint32_t); // key_length and value_length
+const uint32_t SLOTTED_TOMBSTONE_LENGTH = UINT32_MAX;           // value_length of a deleted key
+const uint32_t SLOTTED_VALUE_POINTER_FLAG = 0x80000000;         // Bit of value_length set when the value is a pointer into the value log
+
+// Returns the largest key plus value that fits in a slotted page of page_size bytes.
+constexpr size_t getSlottedPageMaxRecordBytes(size_t page_size)
+{
+    return page_size - SLOTTED_PAGE_HEADER_SIZE - SLOTTED_SLOT_SIZE - SLOTTED_RECORD_HEADER_SIZE;
+}
+
+const size_t SLOTTED_PAGE_MAX_RECORD_BYTES = getSlottedPageMaxRecordBytes(PAGE_SIZE); // Largest key plus value that fits in a PAGE_SIZE page
+
+/*
+    A slotted page stores variable-length byte-string key-value pairs in key
+    order. The slots (the offsets of the records) grow from the start of the
+    page and the records from its end, so the page is full when they meet:
+
+        [0, 4)              num_slots, the number of key-value pairs in the page
+        [4, 8)              records_start, the offset of the first byte of the records
+        [8, 8 + 4 * n)      the offset of the record of every pair, in key order
+        [records_start, ..) the records, each key_length and value_length (uint32), the key bytes, then the value bytes
+
+    A deleted key has a value_length of SLOTTED_TOMBSTONE_LENGTH and no value
+    bytes. A value that is a ValuePointer into the value log (a value too large
+    to keep in the tree) has SLOTTED_VALUE_POINTER_FLAG set in its
+    value_length. Keys are compared as unsigned bytes (std::string_view order),
+    so a key is found with a binary search over the slots without decoding the
+    page. Pages are PAGE_SIZE bytes unless the builder is given a larger
+    page_size (up to MAX_PAGE_SIZE, so every offset fits in a uint32).
+
+    Input:
+        page_size           The size (in bytes) of the page.
+
+    Attributes:
+        page                The page being built
+        page_size           The size (in bytes) of the page
+        num_slots           The number of key-value pairs added to the page
+        records_start       The offset of the first byte of the records added to the page
+        first_key           The first key added to the page
+        last_key            The last key added to the page
+
+    Functions:
+        add                 Adds a key-value pair, a tombstone or a value pointer (keys must be strictly increasing),
+                            returns false if the page is full
+        write               Writes the slotted page into a page_size buffer
+        clear               Removes every key-value pair
+        empty               Returns whether no key-value pair was added
+        size                Returns the number of key-value pairs added
+        getFreeBytes        Returns the number of bytes left for slots and records
+        getFirstKey         Returns the first key added
+        getLastKey          Returns the last key added
+*/
+class SlottedPageBuilder
+{
+private:
+    std::vector<char> page;
+    size_t page_size;
+    uint32_t num_slots;
+    uint32_t records_start;
+    std::string first_key;
+    std::string last_key;
+
+public:
+    SlottedPageBuilder(size_t page_size = PAGE_SIZE);
+
+    bool add(std::string_view key, std::string_view value, bool is_tombstone = false, bool is_pointer = false);
+    void write(void *page) const;
+    void clear();
+    bool empty() const;
+    long size() const;
+    size_t getFreeBytes() const;
+    const std::string &getFirstKey() const;
+    const std::string &getLastKey() const;
+};
+
+size_t getSlottedRecordBytes(size_t key_length, size_t value_length);
+
+long getSlottedPageNumSlots(const char *page);
+std::string_view getSlottedKey(const char *page, long slot);
+std::string_view getSlottedValue(const char *page, long slot);
+bool isSlottedTombstone(const char *page, long slot);
+bool isSlottedPointer(const char *page, long slot);
+long slottedLowerBound(const char *page, std::string_view key);
+bool isSlottedPageValid(const char *page, size_t page_size = PAGE_SIZE);
+
+#endif
@@ -4,7 +4,11 @@
 #include "global.h"
 #include "memtable.h"
 #include "static_b_tree.h"
-#include "lsm_tree.h"
+#include "bloom_filter.h"
+#include "rate_limiter.h"
+#include "learned_index.h"
+#include "sst_format.h"
+#include "packed_page.h"
 #include <filesystem>
 #include <algorithm>
 #include <cmath>
@@ -13,20 +17,343 @@
 #include <ctime>
 #include <iomanip>
 #include <string.h>
+#include <atomic>
 #include <string>
 #include <fstream>
 #include <climits>  // For LONG_MIN and LONG_MAX
 #include <fcntl.h>  // for open, O_RDONLY
 #include <unistd.h> // for pread, close
 
+/*
+    Represents the statistics of an SST that are kept in memory by the LSM tree.
+
+    Attributes:
+        num_entries         The number of key-value pairs in the SST
+        num_tombstones      The number of key-value pairs whose value is a tombstone (LONG_MIN)
+        min_key             The smallest key in the SST or its range tombstones (LONG_MAX if the SST is empty)
+        max_key             The largest key in the SST or its range tombstones (LONG_MIN if the SST is empty)
+        range_tombstones    The key ranges deleted by the SST (stored in its tombstone block, or its range_ file if it is separate files)
+        fence_keys          The largest key of every page of the SST (fence pointers), in page order
+        learned_index       The piecewise-linear learned index from every key to its position in the SST
+        footer              The footer of the SST file, giving its format and the location of its blocks
+
+    Functions:
+        add                 Updates the statistics with a key-value pair (pairs must be given in SST order, with
+                            whether the pair starts a page)
+        addRangeTombstone   Updates the statistics with a range tombstone
+        tombstoneRatio      Returns the fraction of key-value pairs that are tombstones
+        overlaps            Returns whether the key range of the SST overlaps [key1, key2]
+        empty               Returns whether the SST has neither key-value pairs nor range tombstones
+        fenceMemoryBytes    Returns the number of bytes used by the fence pointers
+        learnedMemoryBytes  Returns the number of bytes used by the learned index
+*/
+struct SSTMetadata
+{
+    long num_entries = 0;
+    long num_tombstones = 0;
+    long min_key = LONG_MAX;
+    long max_key = LONG_MIN;
+    RangeTombstones range_tombstones;
+    std::vector<long> fence_keys;
+    LearnedIndex learned_index;
+    SSTFooter footer;
+
+    void add(long key, long value, bool is_page_start)
+    {
+        if (is_page_start)
+        {
+            fence_keys.push_back(key);
+        }
+        else
+        {
+            fence_keys.back() = key;
+        }
+        learned_index.add(key);
+        num_entries++;
+        if (value == LONG_MIN)
+        {
+            num_tombstones++;
+        }
+        min_key = std::min(min_key, key);
+        max_key = std::max(max_key, key);
+    }
+    void addRangeTombstone(long key1, long key2)
+    {
+        range_tombstones.add(key1, key2);
+        min_key = std::min(min_key, key1);
+        max_key = std::max(max_key, key2);
+    }
+    double tombstoneRatio() const
+    {
+        return num_entries == 0 ? 0 : static_cast<double>(num_tombstones) / num_entries;
+    }
+    bool overlaps(long key1, long key2) const
+    {
+        return !empty() && min_key <= key2 && key1 <= max_key;
+    }
+    bool empty() const
+    {
+        return num_entries == 0 && range_tombstones.empty();
+    }
+    size_t fenceMemoryBytes() const
+    {
+        return fence_keys.size() * sizeof(long);
+    }
+    size_t learnedMemoryBytes() const
+    {
+        return learned_index.getMemoryBytes();
+    }
+};
+
+/*
+    Represents how a get without the B-Tree searches the pages of an SST.
+
+    Values:
+        BINARY              Binary search over the pages, about log2(pages) page reads.
+        INTERPOLATION       Interpolation search over the pages using the key range and the number of
+                            entries of the SST, about log2(log2(pages)) page reads for uniform keys. A probe
+                            that does not at least halve the remaining pages is followed by a binary search
+                            step, so skewed keys never need more than about twice the binary search reads.
+*/
+enum class SSTSearchMode
+{
+    BINARY = 0,
+    INTERPOLATION = 1
+};
+
+/*
+    Reads the key-value pairs of an SST sequentially, one page at a time, using
+    Direct I/O. Used by compaction to stream its input SSTs. The data block of a
+    single-file SST ends where its footer says, so the iterator stops after its
+    last key-value pair without looking for padding. The keys of packed pages
+    are decoded once per page. The pages of a compressed SST are read into a
+    window of two pages of the file, since a compressed page may cross into the
+    next page of the file, which the next compressed page then starts in.
+
+    Input:
+        sst_filename        The name of the SST file to read.
+
+    Attributes:
+        sst_filename        The name of the SST file (every page read is checked against its checksum unless checksums are OFF)
+        fd                  The file descriptor of the SST file
+        buffer              The aligned buffer holding the current page (footer.page_size bytes)
+        read_offset         The offset of the next page to read
+        data_end            The offset of the end of the data block (-1 to read up to the end of the file)
+        entries_left        The number of key-value pairs left, including the current one (-1 if the SST has no footer)
+        buffer_index        The index (in longs) of the current key-value pair in the buffer (twice its index in a packed page)
+        is_packed           Whether the data pages are packed
+        page_keys           The decoded keys of the current packed page
+        page_pairs          The number of key-value pairs in the current packed page
+        footer              The footer of the SST (its block index locates the compressed pages)
+        codec               The codec of the compressed pages (nullptr if the SST is not compressed)
+        compressed_buffer   The aligned buffer holding the window of the file read for the compressed pages
+        window_first_page   The first page of the file in compressed_buffer
+        window_pages        The number of pages of the file in compressed_buffer
+        next_page           The index of the next compressed page to read
+        is_valid            Whether the iterator currently points at a key-value pair
+        has_error           Whether a read failed (or a page did not match its checksum)
+
+    Functions:
+        readNextPage        Reads the next page of the SST into the buffer
+        readNextFilePage    Reads the next page of the data block into the buffer
+        readNextCompressedPage Reads and decompresses the next page of a compressed SST into the buffer
+        isOpen              Returns whether the SST file was opened successfully
+        valid               Returns whether the iterator points at a key-value pair
+        hasError            Returns whether a read failed
+        key                 Returns the current key
+        value               Returns the current value
+        startsPage          Returns whether the current key-value pair is the first of its page
+        next                Advances to the next key-value pair
+*/
+class SSTIterator
+{
+private:
+    std::string sst_filename;
+    int fd;
+    void *buffer;
+    off_t read_offset;
+    off_t data_end;
+    long entries_left;
+    size_t buffer_index;
+    bool is_packed;
+    std::vector<long> page_keys;
+    long page_pairs;
+    SSTFooter footer;
+    const BlockCodec *codec;
+    void *compressed_buffer;
+    long window_first_page;
+    long window_pages;
+    long next_page;
+    bool is_valid;
+    bool has_error;
+
+    void readNextPage();
+    bool readNextFilePage();
+    bool readNextCompressedPage();
+
+public:
+    SSTIterator(const std::string &sst_filename);
+    ~SSTIterator();
+
+    bool isOpen();
+    bool valid();
+    bool hasError();
+    long key();
+    long value();
+    bool startsPage();
+    void next();
+};
+
+/*
+    Writes a sorted stream of key-value pairs into a new SST. Shared by flushes
+    (writeMemtableToDisk) and compactions (mergeSSTs) so that both produce the
+    same layout and both go through the RateLimiter. Given only the SST
+    filename (or the SST filename as the B-Tree filename), it writes a single
+    file SST (data, index and filter blocks and a footer, see SSTFooter). Given
+    separate B-Tree and Bloom filter filenames, it writes the version 1 layout
+    of three files instead. The pages of a compressed SST are compressed one at
+    a time and written back to back, a page of the file at a time. The plain,
+    uncompressed data pages of a single-file SST take page_size bytes, so a
+    large SST needs fewer pages, and fewer B-Tree nodes to index them, while
+    the B-Tree nodes keep PAGE_SIZE pages.
+
+    Input:
+        sst_filename        The name of the SST file to create.
+        btree_filename      The name of the B-Tree file to create (version 1 layout).
+        bloom_filename      The name of the Bloom filter file to create (version 1 layout).
+        rate_limiter        The RateLimiter every page write must request bytes from (or nullptr).
+        priority            The priority of the page writes.
+        layout              The layout of the index written to the B-Tree file.
+        encoding            The encoding of the data pages (version 1 SSTs are always PLAIN).
+        compression         The compression of the data pages (version 1 SSTs are never compressed).
+        page_size           The size (in bytes) of the data pages (see isValidPageSize), PAGE_SIZE unless they are plain and uncompressed.
+
+    Attributes:
+        sst_fd              The file descriptor of the SST file
+        btree_fd            The file descriptor of the B-Tree file (-1 for a single-file SST)
+        is_single_file      Whether the B-Tree and the Bloom filter are written into the SST file
+        sst_buffer          The aligned buffer holding the current SST page
+        btree_buffer        The aligned buffer used to write B-Tree pages
+        sst_write_offset    The offset of the next SST page in the file
+        sst_buffer_offset   The offset of the next key-value pair in sst_buffer
+        btree               The StaticBTree built from the max key of each page
+        bloom_filter        The Bloom filter of all keys written
+        leaf_node_pairs_written The number of key-value pairs in the current page
+        encoding            The encoding of the data pages
+        packed_page         The key-value pairs of the current page when the pages are packed
+        compression         The compression of the data pages
+        codec               The codec of the data pages (nullptr if they are not compressed)
+        compressed_buffer   The aligned buffer (two pages) holding the compressed pages not yet written
+        compressed_buffer_offset The number of bytes in compressed_buffer
+        block_offsets       The offset in the data block of every compressed page, then the end of the last one
+        curr_page           The number of pages given to the B-Tree so far
+        final_key_added     The last key written
+        metadata            The statistics of the key-value pairs written
+        footer              The footer of a single-file SST
+        page_size           The size (in bytes) of the data pages
+        sst_checksums       The CRC32C of every PAGE_SIZE of the SST written (every page of a single-file SST)
+        btree_checksums     The CRC32C of every B-Tree page written
+        has_error           Whether a write failed
+
+    Functions:
+        writePage           Writes sst_buffer to the SST file and clears it
+        writeBlockPage      Writes btree_buffer as the next page of a single-file SST
+        writePackedPage     Writes packed_page to the SST file, adds its max key to the B-Tree and clears it
+        writeCompressedPage Compresses sst_buffer into compressed_buffer, writes its first page once full and clears sst_buffer
+        writeBlockIndex     Writes block_offsets as the block index of a compressed SST
+        writeTombstoneBlock Writes the range tombstones as the tombstone block of a single-file SST
+        writeChecksumBlock  Writes sst_checksums as the checksum block of a single-file SST
+        isOpen              Returns whether all files and buffers were created successfully
+        put                 Appends a key-value pair (keys must be given in increasing order)
+        putRangeTombstone   Adds a range tombstone that hides the key range [key1, key2] in older SSTs
+        sizeFilter          Sizes the Bloom filter for the given number of key-value pairs (before the first put)
+        finish              Writes the final page, the B-Tree, the Bloom filter, the range tombstones and the checksums (and the footer)
+        getMetadata         Returns the statistics of the key-value pairs written
+*/
+class SSTWriter
+{
+private:
+    std::string sst_filename;
+    std::string btree_filename;
+    std::string bloom_filename;
+    RateLimiter *rate_limiter;
+    IOPriority priority;
+
+    int sst_fd;
+    int btree_fd;
+    bool is_single_file;
+    void *sst_buffer;
+    void *btree_buffer;
+    size_t sst_write_offset;
+    size_t sst_buffer_offset;
+
+    StaticBTree btree;
+    BloomFilter bloom_filter;
+    int leaf_node_pairs_written;
+    PageEncoding encoding;
+    PackedPageBuilder packed_page;
+    CompressionType compression;
+    const BlockCodec *codec;
+    void *compressed_buffer;
+    size_t compressed_buffer_offset;
+    std::vector<long> block_offsets;
+    long curr_page;
+    long final_key_added;
+    SSTMetadata metadata;
+    SSTFooter footer;
+    std::vector<uint32_t> sst_checksums;
+    std::vector<uint32_t> btree_checksums;
+    size_t page_size;
+    bool has_error;
+
+    bool writePage();
+    bool writeBlockPage();
+    bool writePackedPage();
+    bool writeCompressedPage();
+    bool writeBlockIndex();
+    bool writeTombstoneBlock();
+    bool writeChecksumBlock();
+
+public:
+    SSTWriter(std::string sst_filename, RateLimiter *rate_limiter = nullptr, IOPriority priority = IOPriority::HIGH, IndexLayout layout = DEFAULT_INDEX_LAYOUT,
+              PageEncoding encoding = DEFAULT_PAGE_ENCODING, CompressionType compression = CompressionType::NONE, size_t page_size = PAGE_SIZE);
+    SSTWriter(std::string sst_filename, std::string btree_filename, std::string bloom_filename, RateLimiter *rate_limiter = nullptr, IOPriority priority = IOPriority::HIGH,
+              IndexLayout layout = DEFAULT_INDEX_LAYOUT, PageEncoding encoding = DEFAULT_PAGE_ENCODING, CompressionType compression = CompressionType::NONE,
+              size_t page_size = PAGE_SIZE);
+    ~SSTWriter();
+
+    bool isOpen();
+    bool put(long key, long value);
+    void putRangeTombstone(long key1, long key2);
+    void sizeFilter(size_t num_entries);
+    bool finish();
+    SSTMetadata getMetadata();
+};
+
 std::string getCurrentTimestamp();
-std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string database_name);
-std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string sst_filename, std::string btree_filename, std::string bloom_filename, std::string database_name);
+std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string database_name, RateLimiter *rate_limiter = nullptr, SSTMetadata *metadata = nullptr,
+                                                        PageEncoding encoding = DEFAULT_PAGE_ENCODING, CompressionType compression = CompressionType::NONE,
+                                                        size_t page_size = PAGE_SIZE);
+std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string sst_filename, std::string btree_filename, std::string bloom_filename, std::string database_name,
+                                                        RateLimiter *rate_limiter = nullptr, SSTMetadata *metadata = nullptr, PageEncoding encoding = DEFAULT_PAGE_ENCODING,
+                                                        CompressionType compression = CompressionType::NONE, size_t page_size = PAGE_SIZE);
+bool readSSTMetadata(const std::string &sst_filename, SSTMetadata &metadata);
+std::string getRangeTombstoneFilename(const std::string &sst_filename);
 
 Memtable *retrieveMemtableFromSST(std::string filename);
 std::vector<std::string> getDataFiles(const std::string current_database, std::string prefix);
-NodeFileOffset *binarySearch(std::string sstFileName, long key, BufferPool *buffer_pool);
-std::vector<std::pair<long, long>> binarySearchScan(const std::string sstFileName, long key1, long key2, BufferPool *buffer_pool);
+const char *readCompressedSSTPage(const std::string &sst_filename, const SSTFooter &footer, long page_index, char *page_buffer, BufferPool *buffer_pool, MappedFile *sst_map = nullptr);
+const char *readSSTDataPage(const std::string &sst_filename, const SSTFooter &footer, long page_index, char *page_buffer, BufferPool *buffer_pool, MappedFile *sst_map = nullptr);
+NodeFileOffset *binarySearch(std::string sstFileName, long key, BufferPool *buffer_pool, MappedFile *sst_map = nullptr, const SSTFooter *footer = nullptr);
+NodeFileOffset *fencePointerSearch(const std::string &sst_filename, const SSTMetadata &metadata, long key, BufferPool *buffer_pool, MappedFile *sst_map = nullptr);
+NodeFileOffset *interpolationSearch(const std::string &sst_filename, const SSTMetadata &metadata, long key, BufferPool *buffer_pool, MappedFile *sst_map = nullptr);
+NodeFileOffset *learnedIndexSearch(const std::string &sst_filename, const SSTMetadata &metadata, long key, BufferPool *buffer_pool, MappedFile *sst_map = nullptr);
+std::vector<std::pair<long, long>> binarySearchScan(const std::string sstFileName, long key1, long key2, BufferPool *buffer_pool, MappedFile *sst_map = nullptr, const SSTFooter *footer = nullptr);
+
+// Page reads made by gets (SST and B-Tree pages, from the mapping, the buffer pool or the disk)
+void countPageRead();
+long getPageReads();
+void resetPageReads();
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+#ifndef SST_FORMAT_H
+#define SST_FORMAT_H
+
+#include "global.h"
+#include "mapped_file.h"
+#include "block_codec.h"
+#include <string>
+#include <climits>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/*
+    Represents how the key-value pairs of the data pages of an SST are stored.
+
+    Values:
+        PLAIN               Interleaved (key, value) longs, MAX_PAIRS per PAGE_SIZE of the page, padded with INTERNAL.
+        PACKED              Values as raw longs and keys delta and frame-of-reference bit-packed (see PackedPageBuilder),
+                            so a page holds a varying number of pairs. Only single-file SSTs can be packed.
+        COLUMNAR            MAX_PAIRS keys, then their MAX_PAIRS values, so searching the keys of a page touches half of
+                            its cache lines. Only single-file SSTs can be columnar.
+        SLOTTED             Variable-length byte-string keys and values in slotted pages (see SlottedPageBuilder),
+                            written by StringSSTWriter and indexed by a B-Tree of separator keys in the index block.
+*/
+enum class PageEncoding
+{
+    PLAIN = 0,
+    PACKED = 1,
+    COLUMNAR = 2,
+    SLOTTED = 3
+};
+
+const PageEncoding DEFAULT_PAGE_ENCODING = PageEncoding::PLAIN; // Encoding of the data pages of every new SST
+
+// Returns whether an SST can use pages of the given size: a power of two multiple of PAGE_SIZE, up to MAX_PAGE_SIZE.
+inline bool isValidPageSize(long page_size)
+{
+    return page_size >= static_cast<long>(PAGE_SIZE) && page_size <= static_cast<long>(MAX_PAGE_SIZE) && (page_size & (page_size - 1)) == 0;
+}
+
+// Returns the key at a position of a plain or columnar data page.
+inline long getDataPageKey(const long *page, long pos, bool is_columnar)
+{
+    return is_columnar ? page[pos] : page[pos * 2];
+}
+
+// Returns the value at a position of a plain or columnar data page.
+inline long getDataPageValue(const long *page, long pos, bool is_columnar)
+{
+    return is_columnar ? page[MAX_PAIRS + pos] : page[pos * 2 + 1];
+}
+
+/*
+    Describes the blocks of a single-file SST. The footer is the last page of the
+    file, so the file can be opened by reading one page, and every block starts
+    on a page boundary so it can be read with Direct I/O:
+
+        data block          The key-value pairs, a full page each (the last page padded with INTERNAL) interleaved or
+                            columnar, or packed pages, or these pages compressed back to back (padded with zeros to a page)
+        index block         The StaticBTree pages (none if the data fits in a single page)
+        filter block        The Bloom filter, padded to a page
+        block index         Only when compressed: the offset in the data block of every compressed page, then the end of
+                            the last one (one long each, padded to a page). A page that does not shrink is stored as it
+                            is, so its compressed size is PAGE_SIZE.
+        tombstone block     From version 6, only with range tombstones: the key1 and key2 of every range tombstone
+                            (two longs each, padded to a page)
+        checksum block      From version 6: the CRC32C of every PAGE_SIZE bytes of the file before it (padded to a page)
+        footer              version, num_entries, min_key, max_key, the offset and size of each
+                            block, the page encoding (from version 3), the compression and the
+                            offset and size of the block index (from version 4), the page size
+                            (from version 5), the offset and size of the tombstone and checksum
+                            blocks (from version 6), the CRC32C of these longs, and
+                            SST_FOOTER_MAGIC in the last long
+
+    A compressed page takes at most PAGE_SIZE bytes, so it spans at most two
+    pages of the file. The pages of the data block are still numbered as if
+    they were not compressed, so the B-Tree and the fence pointers are the same.
+
+    The data block is made of pages of page_size bytes, and so are the index
+    and filter blocks of a byte-string SST (see StringSSTWriter). The index
+    block of an SST of long keys keeps PAGE_SIZE B-Tree nodes, which index its
+    larger data pages, and only its PLAIN, uncompressed data pages can be
+    larger than PAGE_SIZE (see SSTWriter). The footer always takes the last
+    PAGE_SIZE bytes, so it is found without knowing the page size.
+
+    The checksum block does not cover itself, and the footer is covered by its
+    own checksum. Before version 6, the range tombstones and the page checksums
+    were kept in range_ and .crc files next to the SST, as they still are for
+    SSTs written as separate sst_, btree_ and bloom_ files, which have no
+    footer and are described by the default footer (version 1).
+
+    Attributes:
+        version             The format version (1 for separate files, SST_FORMAT_VERSION for a single file)
+        num_entries         The number of key-value pairs in the data block
+        min_key             The smallest key in the data block (LONG_MAX if it is empty)
+        max_key             The largest key in the data block (LONG_MIN if it is empty)
+        data_offset         The offset (in bytes) of the data block
+        data_size           The size (in bytes) of the data block
+        index_offset        The offset (in bytes) of the index block
+        index_size          The size (in bytes) of the index block
+        filter_offset       The offset (in bytes) of the filter block
+        filter_size         The size (in bytes) of the Bloom filter in the filter block
+        page_encoding       The encoding of the data pages (PLAIN before version 3)
+        compression         The compression of the data pages (NONE before version 4)
+        block_index_offset  The offset (in bytes) of the block index
+        block_index_size    The size (in bytes) of the block index without its padding
+        page_size           The size (in bytes) of the pages of the data block (PAGE_SIZE before version 5)
+        tombstone_offset    The offset (in bytes) of the tombstone block
+        tombstone_size      The size (in bytes) of the tombstone block without its padding (0 if the SST has no range tombstones)
+        checksum_offset     The offset (in bytes) of the checksum block (0 before version 6)
+        checksum_size       The size (in bytes) of the checksum block without its padding
+        block_offsets       The block index, loaded by readSSTFooter (shared by the copies of the footer)
+
+    Functions:
+        isSingleFile        Returns whether the SST is a single file described by this footer
+        hasChecksumBlock    Returns whether the page checksums and range tombstones are blocks of the file
+        getNumDataPages     Returns the number of pages in the data block
+        getNumIndexPages    Returns the number of pages in the index block
+        isPacked            Returns whether the data pages are packed
+        isColumnar          Returns whether the data pages are columnar
+        getKeyStride        Returns the number of longs from a key of a plain or columnar data page to the next
+        isCompressed        Returns whether the data pages are compressed
+        getBlockOffset      Returns the offset in the data block of a compressed page
+        getBlockSize        Returns the compressed size of a page
+        getPagePairs        Returns the number of key-value pairs a plain or columnar page of the data block holds
+        getEntriesInPage    Returns the number of key-value pairs in a plain or columnar page of the data block
+        serialize           Writes the footer into a page
+        deserialize         Reads the footer from a page, returns false if the page is not a valid footer
+*/
+struct SSTFooter
+{
+    long version = 1;
+    long num_entries = 0;
+    long min_key = LONG_MAX;
+    long max_key = LONG_MIN;
+    long data_offset = 0;
+    long data_size = 0;
+    long index_offset = 0;
+    long index_size = 0;
+    long filter_offset = 0;
+    long filter_size = 0;
+    PageEncoding page_encoding = PageEncoding::PLAIN;
+    CompressionType compression = CompressionType::NONE;
+    long block_index_offset = 0;
+    long block_index_size = 0;
+    long page_size = PAGE_SIZE;
+    long tombstone_offset = 0;
+    long tombstone_size = 0;
+    long checksum_offset = 0;
+    long checksum_size = 0;
+    std::shared_ptr<const std::vector<long>> block_offsets;
+
+    bool isSingleFile() const
+    {
+        return version >= 2;
+    }
+    bool hasChecksumBlock() const
+    {
+        return version >= 6;
+    }
+    bool isPacked() const
+    {
+        return page_encoding == PageEncoding::PACKED;
+    }
+    bool isColumnar() const
+    {
+        return page_encoding == PageEncoding::COLUMNAR;
+    }
+    long getKeyStride() const
+    {
+        return isColumnar() ? 1 : 2;
+    }
+    bool isCompressed() const
+    {
+        return compression != CompressionType::NONE;
+    }
+    long getNumDataPages() const
+    {
+        return isCompressed() ? block_index_size / static_cast<long>(sizeof(long)) - 1 : data_size / page_size;
+    }
+    long getBlockOffset(long page_index) const
+    {
+        return (*block_offsets)[page_index];
+    }
+    long getBlockSize(long page_index) const
+    {
+        return (*block_offsets)[page_index + 1] - (*block_offsets)[page_index];
+    }
+    long getNumIndexPages() const
+    {
+        return index_size / (page_encoding == PageEncoding::SLOTTED ? page_size : static_cast<long>(PAGE_SIZE));
+    }
+    long getPagePairs() const
+    {
+        return page_size / static_cast<long>(ENTRY_SIZE);
+    }
+    long getEntriesInPage(long page_index) const
+    {
+        return std::clamp<long>(num_entries - page_index * getPagePairs(), 0, getPagePairs());
+    }
+    void serialize(void *page) const;
+    bool deserialize(const void *page);
+};
+
+bool readSSTFooter(const std::string &sst_filename, SSTFooter &footer, const MappedFile *sst_map = nullptr);
+bool readSSTChecksumBlock(const std::string &sst_filename, std::vector<uint32_t> &checksums, long &num_pages);
+
+#endif
@@ -6,8 +6,14 @@
 #include <optional>
 #include <cstring>
 #include <tuple>
-#include "sst.h"
+#include <array>
+#include <fcntl.h>  // for open, O_RDONLY
+#include <unistd.h> // for pread, close
 #include "global.h"
+#include "buffer_pool.h"
+#include "mapped_file.h"
+#include "s_tree.h"
+#include "sst_format.h"
 
 /*
     Represents a base node in the Static B-Tree structure.
@@ -32,6 +38,57 @@ struct BTreeNode
     virtual ~BTreeNode() = default;
 };
 
+/*
+    Represents a non-owning view of a B-Tree (or SST) page. The keys and the
+    pages/values are read in place from the interleaved on-disk layout, so a
+    page can be searched straight out of a stack buffer, a buffer pool frame or
+    a mapped file without copying it.
+
+    Input:
+        page                    The page data, which must outlive the view
+
+    Attributes:
+        longs                   The page as MAX_PAIRS interleaved (key, page/value) pairs
+        num_keys                The number of valid keys in the page
+
+    Functions:
+        getKey                  Returns the key at a position
+        getPageOrValue          Returns the child page (Internal Node) or value (Leaf Node) at a position
+        getKeys                 Returns the first key of the page (keys are every second long)
+        getNumKeys              Returns the number of valid keys in the page
+        isLeaf                  Returns whether the page is a Leaf Node
+*/
+class PageView
+{
+private:
+    const long *longs;
+    int num_keys;
+
+public:
+    PageView(const char *page);
+
+    long getKey(int pos) const;
+    long getPageOrValue(int pos) const;
+    const long *getKeys() const;
+    int getNumKeys() const;
+    bool isLeaf() const;
+};
+
+/*
+    Represents the layout of the index written to a B-Tree file.
+
+    Values:
+        B_TREE              Pages of MAX_PAIRS sorted keys, searched with a binary search per page.
+        S_TREE              An S+-tree (STree) over the largest key of every SST page, behind a header page.
+*/
+enum class IndexLayout
+{
+    B_TREE = 0,
+    S_TREE = 1
+};
+
+const IndexLayout DEFAULT_INDEX_LAYOUT = IndexLayout::B_TREE; // Layout of the index of every new SST
+
 /*
     Represents a Static B-Tree structure, allowing efficient storage and retrieval
     of key-value pairs through a disk-based B-Tree implementation.
@@ -45,19 +102,44 @@ struct BTreeNode
         root_page_index         Index of the root page in the nodes vector
         sst_filename            Name of the SST file used in the B-Tree construction
         btree_filename          Filename for the serialized B-Tree on disk
+        sst_map                 Mapping of the SST file (nullptr to read pages from disk)
+        btree_map               Mapping of the B-Tree file (nullptr to read pages from disk)
+        page_id                 Reused buffer for the BufferPool id of the page being read
+        layout                  Layout of the index written by finalizeTree and writeNodes
+        leaf_max_keys           The largest key of every SST page (used to build the S+-tree)
+        s_tree                  The S+-tree built by finalizeTree in the S_TREE layout
+        index_first_page        The first page of the index block of a single-file SST
+        num_index_pages         The number of pages of the index block of a single-file SST (-1 for a separate B-Tree file)
+        is_packed               Whether the data pages of the SST are packed (see PackedPageBuilder)
+        footer                  The footer of a single-file SST (its page size and block index locate the data pages)
 
     Functions:
         get                     Retrieves the value associated with a key from a specified page
         scan                    Finds and returns key-value pairs within a specified range
-        binarySearch            Performs binary search on a sorted array of keys
+        binarySearch            Performs binary search on the keys of a page
+        searchDataPage          Retrieves the value of a key from a plain or columnar data page of a single-file SST
+        scanDataPage            Finds the key-value pairs within a range in a plain or columnar data page of a single-file SST
         loadPage                Loads a page from disk into memory
-        readPageContents        Reads the content of a page, returning keys and page/value info
+        loadNodePage            Loads a page of the B-Tree (or SST) file from disk into memory
+        isCachedNodePageIntact  Checks a page of the B-Tree found in the buffer pool against its checksum
+        getMappedPage           Returns a page of the mapped B-Tree (or SST) file
+        readSSTPage             Returns a page of the SST file from the mapping, the buffer pool or the disk (decompressed if needed)
+        loadSTree               Loads the S+-tree of a B-Tree file written in the S_TREE layout
+        sTreeGet                Retrieves the value of a key through the S+-tree
+        sTreeScan               Finds the key-value pairs within a range through the S+-tree
+        getPageId               Returns the BufferPool id of a page of the B-Tree file
+        getNodePageId           Returns the BufferPool id of a page of the B-Tree (or SST) by its index in the B-Tree
+        getFilePage             Returns the page of a single-file SST holding a page of the B-Tree
+        isDataPage              Returns whether a page of the B-Tree is a page of the SST's data block
+        getDataPage             Returns the index in the data block of a data page of the B-Tree
+        setIndexBlock           Reads the B-Tree from the index block of a single-file SST
         insertInternalNode      Creates a BTreeNode Internal Node instance and addes it to the nodes vector
         insertLeafNode          Create a BTreeNode Leaf Node instance and writes it to disk
         finalizeTree            Completes the B-Tree structure before saving to disk
         writeNodes              Writes BTreeNode instances to disk
         writeNode               Writes a BTreeNode instance to disk
         getNodes                Returns a vector of all BTreeNode instances
+        getNumIndexPages        Returns the number of pages writeNodes writes
         getNumKeys              Returns the num_keys value of a BTreeNode instance
         isLeaf                  Returns the is_leaf value of a BTreeNode instance
 */
@@ -68,22 +150,48 @@ private:
     int root_page_index;
     std::string sst_filename;
     std::string btree_filename;
+    MappedFile *sst_map;
+    MappedFile *btree_map;
+    std::string page_id;
+    IndexLayout layout;
+    std::vector<long> leaf_max_keys;
+    STree s_tree;
+    long index_first_page;
+    long num_index_pages;
+    bool is_packed;
+    SSTFooter footer;
 
     // Primary Functions:
     long get(long page_index, long key, BufferPool *buffer_pool, Page *prev_page);
-    std::vector<std::pair<long, long>> scan(long page_index, long key1, long key2, BufferPool *buffer_pool, Page *prev_page);
-    int binarySearch(const long *keys, int num_keys, long key);
+    void scan(long page_index, long key1, long key2, BufferPool *buffer_pool, Page *prev_page, std::vector<std::pair<long, long>> &results);
+    int binarySearch(const PageView &page, long key);
+    long searchDataPage(const char *page_data, long data_page, long key);
+    bool scanDataPage(const char *page_data, long data_page, long key1, long key2, std::vector<std::pair<long, long>> &results);
+    long sTreeGet(const char *header, long key, BufferPool *buffer_pool);
+    void sTreeScan(const char *header, long key1, long key2, BufferPool *buffer_pool, std::vector<std::pair<long, long>> &results);
 
     // Disk I/O Functions:
     int loadPage(const std::string &filename, int page_index, void *buffer);
-    std::tuple<bool, int, std::vector<long>, std::vector<long>> readPageContents(char page[PAGE_SIZE]);
+    int loadNodePage(long &page_index, void *buffer);
+    bool isCachedNodePageIntact(long page_index, const char *page_data);
+    const char *getMappedPage(long &page_index);
+    const char *readSSTPage(long page_index, char *page_buffer, BufferPool *buffer_pool);
+    bool loadSTree(const char *header, STree &tree);
+    const std::string &getPageId(const std::string &filename, long page_index);
+    const std::string &getNodePageId(long page_index);
+    long getFilePage(long page_index) const;
+    bool isDataPage(long page_index) const;
+    long getDataPage(long page_index) const;
 
 public:
     // Constructors
     StaticBTree();
     StaticBTree(std::string sst_filename, std::string btree_filename);
+    StaticBTree(std::string sst_filename, std::string btree_filename, MappedFile *sst_map, MappedFile *btree_map);
+    StaticBTree(std::string sst_filename, std::string btree_filename, IndexLayout layout);
 
     // Primary Functions:
+    void setIndexBlock(const SSTFooter &footer);
     long get(long key, BufferPool *buffer_pool = nullptr);
     std::vector<std::pair<long, long>> scan(long key1, long key2, BufferPool *buffer_pool = nullptr);
 
@@ -91,11 +199,12 @@ public:
     void insertInternalNode(long key, long page);
     void insertLeafNode(int fd, void *buffer, BTreeNode &leaf_node, size_t &write_offset, long key, long value);
     void finalizeTree();
-    void writeNodes(int fd, void *buffer, size_t &write_offset);
+    void writeNodes(int fd, void *buffer, size_t &write_offset, std::vector<uint32_t> *checksums = nullptr);
     void writeNode(int fd, void *buffer, const BTreeNode &node, size_t &write_offset);
 
     // Getter Functions:
     std::vector<BTreeNode> getNodes();
+    long getNumIndexPages();
     int getNumKeys(const std::array<long, MAX_PAIRS> &keys);
     bool isLeaf(const std::array<long, MAX_PAIRS> &keys);
 };
@@ -0,0 +1,178 @@
+#ifndef STRING_LSM_TREE_H
+#define STRING_LSM_TREE_H
+
+#include "global.h"
+#include "string_memtable.h"
+#include "string_sst.h"
+#include "buffer_pool.h"
+#include "rate_limiter.h"
+#include "value_log.h"
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+const size_t VERSIONED_KEY_SUFFIX_BYTES = 2 + sizeof(uint64_t); // The terminator and sequence number that end every versioned key
+
+/*
+    Versioned keys store every write of a StringLSMTree under its own key: the
+    key with every zero byte escaped (0x00 0xFF), then the terminator 0x00 0x00,
+    then the bitwise complement of the sequence number of the write in big
+    endian. Plain byte order then sorts the versioned keys by key (no key is a
+    prefix of the versioned key of another), and the versions of a key from
+    the newest to the oldest, so SSTs and memtables need no other comparator.
+    The prefix of a versioned key (everything but the sequence number) is the
+    same for every version of a key, and is what the Bloom filters hold.
+*/
+std::string encodeVersionedKey(std::string_view key, uint64_t sequence);
+bool decodeVersionedKey(std::string_view versioned_key, std::string &key, uint64_t &sequence);
+std::string_view getVersionedKeyPrefix(std::string_view versioned_key);
+uint64_t getVersionedKeySequence(std::string_view versioned_key);
+
+/*
+    Represents a byte-string SST in a level of a StringLSMTree.
+
+    Attributes:
+        level               The level of the SST
+        sst_filename        The name of the SST file
+        metadata            The statistics of the SST
+*/
+struct StringSST
+{
+    int level;
+    std::string sst_filename;
+    StringSSTMetadata metadata;
+};
+
+/*
+    An LSM tree of byte-string keys and values, alongside the LSMTree of long
+    keys (which keeps its fixed-width pages). Writes go to a StringMemtable that
+    is flushed to a byte-string SST on level 0 once it holds memtable_size
+    bytes. Levels are compacted as in the LSMTree: once a level holds
+    level_size_ratio SSTs they are merged into one (the newest value of every
+    key wins), which stays on the level while it is at most
+    level_size_ratio^(level + 1) memtables big and moves to the next level
+    otherwise. Tombstones are dropped once no deeper level could hold an older
+    value for their key.
+
+    Once the value log is enabled, values of at least value_log_threshold bytes
+    are appended to a ValueLog and the tree only holds a pointer to them, so
+    compactions rewrite a few bytes per key instead of the whole value (and
+    values larger than a page can be stored). Its garbage is collected on
+    request, a segment at a time.
+
+    Every put and remove is given the next sequence number and stored as a new
+    version of its key (see encodeVersionedKey), so reads can be made at a
+    snapshot: getSnapshot returns the sequence number of the last write, and
+    gets and scans at it see the tree as it was then, whatever was written,
+    flushed or compacted since. Flushes and compactions keep the newest version
+    of every key and each older version that a live snapshot still sees (the
+    newest version not newer than the snapshot), and drop the rest, so without
+    snapshots a key has a single version once written to an SST. A long scan
+    can thus read a range in chunks at a snapshot while writes go on.
+
+    SSTs use PAGE_SIZE pages unless a larger page size is set for the levels
+    from first_page_level on: deep levels hold most of the data and are mostly
+    scanned, so larger pages mean fewer reads and smaller indexes there, while
+    the shallow levels keep small pages for point lookups.
+
+    Input:
+        memtable_size       The max number of key and value bytes of the memtable.
+        database            The name of the database (the directory of its SSTs).
+
+    Attributes:
+        memtable            The memtable receiving the writes
+        levels              The SSTs of every level, oldest first
+        max_level           The number of levels
+        database_name       The name of the database
+        memtable_size       The max number of key and value bytes of the memtable
+        level_size_ratio    The number of SSTs that makes a level compact
+        rate_limiter        The RateLimiter every SST page write must request bytes from (or nullptr)
+        value_log           The value log of large values (or nullptr until it is enabled)
+        value_log_threshold The size (in bytes) from which a value is stored in the value log
+        user_bytes_written  The number of key and value bytes given to put
+        sst_bytes_written   The number of bytes of every SST written by a flush or a compaction
+        page_size           The size (in bytes) of the pages of the SSTs from first_page_level on
+        first_page_level    The first level whose SSTs use page_size pages (shallower levels use PAGE_SIZE)
+        last_sequence       The sequence number of the last put or remove
+        snapshots           The sequence numbers of the live snapshots (a snapshot taken twice is held twice)
+
+    Functions:
+        flushMemtable       Writes the memtable to a new SST on level 0 and replaces it with an empty one
+        mergeSSTs           Merges SSTs (oldest first) into a new SST
+        levelsOverlap       Returns whether an SST on a level from first_level on overlaps a key range
+        compactLevels       Merges the SSTs of every full level
+        getPageSize         Returns the size of the pages of the SSTs written by a flush or a compaction of a level
+        isVisible           Returns whether a live snapshot sees a version (is not older than it, but older than the next newer version)
+        keepVersion         Returns whether a flush or compaction keeps a version, given the versions before it in key order
+        getEntry            Finds the newest entry of a key at a snapshot as stored (value pointers are not followed)
+        put                 Inserts or replaces the value of a key, returns false if the pair is too large for a page
+        remove              Deletes a key
+        get                 Finds the value of a key at a snapshot, returns false if the key is not found (or was deleted)
+        scan                Returns the key-value pairs in [key1, key2] at a snapshot in key order
+        getSnapshot         Returns a snapshot of the tree (the sequence number of the last write), to read at until it is released
+        releaseSnapshot     Releases a snapshot, so the versions only it sees can be dropped
+        getLastSequence     Returns the sequence number of the last write
+        flush               Writes the memtable to level 0 if it holds any key
+        setRateLimiter      Sets the RateLimiter of flushes, compactions and value log appends
+        setPageSize         Sets the page size of the SSTs written from now on for the levels from first_level on
+        enableValueLog      Stores the values of at least threshold bytes in a value log from now on
+        collectValueLogGarbage  Collects the garbage of the oldest value log segment, returns false if there was none (or a snapshot is live)
+        getValueLog         Returns the value log (or nullptr)
+        getWriteAmplification  Returns the bytes written to SSTs and the value log per byte given to put
+        getMemtable         Returns the memtable
+        getLevels           Returns the SSTs of every level
+*/
+class StringLSMTree
+{
+private:
+    StringMemtable *memtable;
+    std::vector<std::vector<StringSST>> levels;
+    int max_level = MAX_LSM_LEVEL;
+    std::string database_name;
+    size_t memtable_size;
+    size_t level_size_ratio = LEVEL_SIZE_RATIO;
+    RateLimiter *rate_limiter = nullptr;
+    ValueLog *value_log = nullptr;
+    size_t value_log_threshold = VALUE_LOG_THRESHOLD;
+    long user_bytes_written = 0;
+    long sst_bytes_written = 0;
+    size_t page_size = PAGE_SIZE;
+    int first_page_level = 0;
+    uint64_t last_sequence = 0;
+    std::multiset<uint64_t> snapshots;
+
+    bool flushMemtable();
+    bool mergeSSTs(const std::vector<StringSST> &ssts, bool drop_tombstones, StringSST &merged_sst);
+    bool levelsOverlap(std::string_view key1, std::string_view key2, int first_level);
+    void compactLevels();
+    size_t getPageSize(int level);
+    bool isVisible(uint64_t sequence, uint64_t newer_sequence);
+    bool keepVersion(std::string_view versioned_key, bool is_tombstone, bool drop_tombstones, std::string &prev_prefix, uint64_t &newer_sequence);
+    bool getEntry(std::string_view key, StringEntry &entry, BufferPool *buffer_pool, uint64_t snapshot = LATEST_SEQUENCE);
+
+public:
+    StringLSMTree(size_t memtable_size, std::string database);
+    ~StringLSMTree();
+
+    bool put(std::string_view key, std::string_view value);
+    bool remove(std::string_view key);
+    bool get(std::string_view key, std::string &value, BufferPool *buffer_pool, uint64_t snapshot = LATEST_SEQUENCE);
+    std::vector<std::pair<std::string, std::string>> scan(std::string_view key1, std::string_view key2, BufferPool *buffer_pool, uint64_t snapshot = LATEST_SEQUENCE);
+    uint64_t getSnapshot();
+    void releaseSnapshot(uint64_t snapshot);
+    uint64_t getLastSequence();
+    bool flush();
+    void setRateLimiter(RateLimiter *new_rate_limiter);
+    bool setPageSize(size_t new_page_size, int first_level = 0);
+    void enableValueLog(size_t threshold = VALUE_LOG_THRESHOLD, size_t segment_size = VALUE_LOG_SEGMENT_SIZE);
+    bool collectValueLogGarbage(BufferPool *buffer_pool);
+    ValueLog *getValueLog();
+    double getWriteAmplification();
+    StringMemtable *getMemtable();
+    const std::vector<std::vector<StringSST>> &getLevels();
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef STRING_MEMTABLE_H
+#define STRING_MEMTABLE_H
+
+#include "global.h"
+#include "string_sst.h"
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+/*
+    Create a Memtable of byte-string keys and values. Its size is bounded by
+    bytes instead of by key-value pairs, since pairs vary in size. Keys are kept
+    in a balanced binary tree (std::map) in byte order, the order of the SSTs
+    they are flushed to. A deleted key is kept as a tombstone so that it hides
+    the older values of the key in the SSTs. The StringLSMTree inserts every
+    version of a key under its own versioned key (see encodeVersionedKey), so
+    the versions of a key sit next to each other, newest first.
+
+    Input:
+        memtable_size       the max number of key and value bytes of the Memtable
+
+    Attributes:
+        entries             the value (or tombstone) of every key
+        memtable_size       the max number of key and value bytes of the Memtable
+        curr_bytes          the current number of key and value bytes stored in the tree
+
+    Functions:
+        put                 inserts or replaces the value of a key (or a pointer to it in the value log)
+        remove              replaces the value of a key with a tombstone
+        get                 finds the value (or tombstone) of a key, returns false if the key is not in the Memtable
+        seek                finds the first key in [key1, key2] and its value (or tombstone), returns false if there is none
+        scan                appends the values (and tombstones) of the keys in [key1, key2] to the results, in key order
+        isFull              returns whether the Memtable holds at least memtable_size bytes
+        getEntries          returns the values (and tombstones) of every key, in key order
+        getMemtableSize     returns the max number of key and value bytes
+        getCurrBytes        returns the current number of key and value bytes
+        size                returns the number of keys
+*/
+class StringMemtable
+{
+private:
+    std::map<std::string, StringEntry, std::less<>> entries;
+    size_t memtable_size;
+    size_t curr_bytes;
+
+    void insert(std::string_view key, std::string_view value, bool is_tombstone, bool is_pointer);
+
+public:
+    StringMemtable(size_t memtable_size);
+    void put(std::string_view key, std::string_view value, bool is_pointer = false);
+    void remove(std::string_view key);
+    bool get(std::string_view key, StringEntry &entry);
+    bool seek(std::string_view key1, std::string_view key2, std::string &key, StringEntry &entry);
+    void scan(std::string_view key1, std::string_view key2, std::vector<std::pair<std::string, StringEntry>> &results);
+    bool isFull();
+    const std::map<std::string, StringEntry, std::less<>> &getEntries();
+    size_t getMemtableSize();
+    size_t getCurrBytes();
+    long size();
+};
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef STRING_SST_H
+#define STRING_SST_H
+
+#include "global.h"
+#include "sst_format.h"
+#include "slotted_page.h"
+#include "bloom_filter.h"
+#include "buffer_pool.h"
+#include "rate_limiter.h"
+#include <climits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+const size_t STRING_SST_MAX_KEY_BYTES = (PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE) / 2 - SLOTTED_SLOT_SIZE - SLOTTED_RECORD_HEADER_SIZE - sizeof(long); // Longest key, so every index page holds two separators
+
+/*
+    Represents the value of a byte-string key: its bytes, or a tombstone if the
+    key was deleted (byte-string SSTs mark deleted keys explicitly instead of
+    reserving a value like LONG_MIN). A large value may be kept in the value
+    log, in which case the entry holds the encoded ValuePointer instead.
+
+    Attributes:
+        value               The bytes of the value (empty for a tombstone)
+        is_tombstone        Whether the key was deleted
+        is_pointer          Whether value is an encoded ValuePointer into the value log
+*/
+struct StringEntry
+{
+    std::string value;
+    bool is_tombstone = false;
+    bool is_pointer = false;
+};
+
+/*
+    Represents the statistics of a byte-string SST that are kept in memory by
+    the StringLSMTree.
+
+    Attributes:
+        num_entries         The number of key-value pairs in the SST
+        num_tombstones      The number of key-value pairs that are tombstones
+        min_key             The smallest key in the SST
+        max_key             The largest key in the SST
+        num_bytes           The number of key and value bytes in the SST
+        footer              The footer of the SST file, giving the location of its blocks
+
+    Functions:
+        add                 Updates the statistics with a key-value pair (pairs must be given in SST order)
+        overlaps            Returns whether the key range of the SST overlaps [key1, key2]
+        empty               Returns whether the SST has no key-value pairs
+*/
+struct StringSSTMetadata
+{
+    long num_entries = 0;
+    long num_tombstones = 0;
+    std::string min_key;
+    std::string max_key;
+    long num_bytes = 0;
+    SSTFooter footer;
+
+    void add(std::string_view key, std::string_view value, bool is_tombstone)
+    {
+        if (num_entries == 0)
+        {
+            min_key = key;
+        }
+        max_key = key;
+        num_entries++;
+        num_tombstones += is_tombstone ? 1 : 0;
+        num_bytes += key.size() + value.size();
+    }
+    bool overlaps(std::string_view key1, std::string_view key2) const
+    {
+        return !empty() && std::string_view(min_key) <= key2 && key1 <= std::string_view(max_key);
+    }
+    bool empty() const
+    {
+        return num_entries == 0;
+    }
+};
+
+/*
+    Writes a sorted stream of byte-string key-value pairs into a new single-file
+    SST (see SSTFooter) whose data pages are slotted pages. A page is written as
+    soon as the next pair does not fit in it, so pages hold as many pairs as
+    their sizes allow. The index block is a B-Tree built bottom up once every
+    data page is written: each of its slotted pages maps the separator key of
+    every child (the shortest prefix of the first key of the child that is
+    greater than every key of the child before it, and the empty key for the
+    first child) to the page of the child, as an 8-byte value. The root is the
+    last page of the index block. Every page write goes through the RateLimiter.
+    Pages are page_size bytes (recorded in the footer), so an SST of a deep
+    level can use pages of up to MAX_PAGE_SIZE bytes: fewer reads per scan and
+    a shallower B-Tree.
+
+    Input:
+        sst_filename        The name of the SST file to create.
+        rate_limiter        The RateLimiter every page write must request bytes from (or nullptr).
+        priority            The priority of the page writes.
+        page_size           The size (in bytes) of the pages (see isValidPageSize).
+
+    Attributes:
+        page_size           The size (in bytes) of the pages
+        fd                  The file descriptor of the SST file
+        buffer              The aligned buffer holding the page being written
+        write_offset        The offset of the next page in the file
+        data_page           The key-value pairs of the current data page
+        index_entries       The separator key and the page of every data page written
+        prev_last_key       The last key of the previous data page
+        bloom_filter        The Bloom filter of all keys written
+        filter_suffix_bytes The number of trailing bytes of every key left out of the Bloom filter
+        metadata            The statistics of the key-value pairs written
+        checksums           The CRC32C of every page written
+        has_error           Whether a write failed (or a pair could not be written)
+
+    Functions:
+        writeBufferPage     Writes the first num_bytes of buffer as the next page (or the footer) of the file
+        writeDataPage       Writes data_page and records its separator key
+        writeIndexPages     Writes the B-Tree of separator keys, a level at a time up to the root
+        isOpen              Returns whether the file and the buffer were created successfully
+        put                 Appends a key-value pair, a tombstone or a value pointer (keys must be given in increasing order and be at
+                            most STRING_SST_MAX_KEY_BYTES long, and a pair must fit in a page)
+        setFilterSuffixBytes  Leaves the last num_bytes of every key out of the Bloom filter (call before the first put)
+        finish              Writes the final data page, the B-Tree, the Bloom filter, the checksums and the footer
+        getMetadata         Returns the statistics of the key-value pairs written
+*/
+class StringSSTWriter
+{
+private:
+    std::string sst_filename;
+    RateLimiter *rate_limiter;
+    IOPriority priority;
+    size_t page_size;
+    int fd;
+    void *buffer;
+    size_t write_offset;
+    SlottedPageBuilder data_page;
+    std::vector<std::pair<std::string, long>> index_entries;
+    std::string prev_last_key;
+    BloomFilter bloom_filter;
+    size_t filter_suffix_bytes;
+    StringSSTMetadata metadata;
+    std::vector<uint32_t> checksums;
+    bool has_error;
+
+    bool writeBufferPage(size_t num_bytes);
+    bool writeDataPage();
+    bool writeIndexPages();
+
+public:
+    StringSSTWriter(std::string sst_filename, RateLimiter *rate_limiter = nullptr, IOPriority priority = IOPriority::HIGH, size_t page_size = PAGE_SIZE);
+    ~StringSSTWriter();
+
+    bool isOpen();
+    bool put(std::string_view key, std::string_view value, bool is_tombstone = false, bool is_pointer = false);
+    void setFilterSuffixBytes(size_t num_bytes);
+    bool finish();
+    StringSSTMetadata getMetadata();
+};
+
+/*
+    Reads the key-value pairs of a byte-string SST sequentially, one data page
+    at a time, using Direct I/O. Used by compaction to stream its input SSTs.
+
+    Input:
+        sst_filename        The name of the SST file to read.
+
+    Attributes:
+        sst_filename        The name of the SST file (every page read is checked against its checksum unless checksums are OFF)
+        fd                  The file descriptor of the SST file
+        buffer              The aligned buffer holding the current page
+        page_size           The size (in bytes) of the pages of the SST
+        num_pages           The number of data pages
+        next_page           The index of the next data page to read
+        slot                The slot of the current key-value pair in the buffer
+        is_valid            Whether the iterator currently points at a key-value pair
+        has_error           Whether a read failed (or a page did not match its checksum)
+
+    Functions:
+        readNextPage        Reads the next data page into the buffer
+        isOpen              Returns whether the SST file was opened successfully
+        valid               Returns whether the iterator points at a key-value pair
+        hasError            Returns whether a read failed
+        key                 Returns the current key (valid until the iterator moves to the next page)
+        value               Returns the current value (valid until the iterator moves to the next page)
+        isTombstone         Returns whether the current key was deleted
+        isPointer           Returns whether the current value is a pointer into the value log
+        next                Advances to the next key-value pair
+*/
+class StringSSTIterator
+{
+private:
+    std::string sst_filename;
+    int fd;
+    void *buffer;
+    size_t page_size;
+    long num_pages;
+    long next_page;
+    long slot;
+    bool is_valid;
+    bool has_error;
+
+    void readNextPage();
+
+public:
+    StringSSTIterator(const std::string &sst_filename);
+    ~StringSSTIterator();
+
+    bool isOpen();
+    bool valid();
+    bool hasError();
+    std::string_view key();
+    std::string_view value();
+    bool isTombstone();
+    bool isPointer();
+    void next();
+};
+
+StringSSTMetadata readStringSSTMetadata(const std::string &sst_filename);
+const char *readStringSSTPage(const std::string &sst_filename, long page_index, char *page_buffer, BufferPool *buffer_pool, size_t page_size = PAGE_SIZE);
+bool stringSSTMightContain(const std::string &sst_filename, const StringSSTMetadata &metadata, std::string_view key, BufferPool *buffer_pool);
+bool stringSSTGet(const std::string &sst_filename, const StringSSTMetadata &metadata, std::string_view key, StringEntry &entry, BufferPool *buffer_pool);
+bool stringSSTScan(const std::string &sst_filename, const StringSSTMetadata &metadata, std::string_view key1, std::string_view key2,
+                   std::vector<std::pair<std::string, StringEntry>> &results, BufferPool *buffer_pool, long max_results = LONG_MAX);
+std::string getSeparatorKey(std::string_view prev_last_key, std::string_view first_key);
+
+#endif
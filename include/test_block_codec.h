@@ -0,0 +1,11 @@
+#ifndef TEST_BLOCK_CODEC_H
+#define TEST_BLOCK_CODEC_H
+
+#include "block_codec.h"
+#include "sst.h"
+#include "test_helpers.h"
+
+void testBlockCodecs();
+void testCompressedSST();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TEST_CHECKSUM_H
+#define TEST_CHECKSUM_H
+
+#include "checksum.h"
+#include "lsm_tree.h"
+#include "sst.h"
+#include "test_helpers.h"
+
+void testCRC32C();
+void testChecksumCorruption();
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef TEST_EXTERNAL_SORT_H
+#define TEST_EXTERNAL_SORT_H
+
+#include "external_sort.h"
+#include "lsm_tree.h"
+#include "test_helpers.h"
+
+void testExternalSortRuns();
+void testLSMIngestCSV();
+
+#endif
@@ -5,9 +5,42 @@
 #include "sst.h"
 
 #include <utility>
+#include <vector>
+#include <random>
 
 Memtable *dbOpen(std::string database_name, int memtable_size);
 std::pair<std::string, std::string> dbClose(Memtable *current_memtable, std::string current_database);
 void dbClear(std::string target_directory);
 
+/*
+    Draws ranks in [0, num_items) following a Zipfian distribution: rank i is
+    drawn with a probability proportional to 1 / (i + 1)^exponent, so a few
+    ranks (the hot keys of a skewed workload) are drawn most of the time.
+
+    Input:
+        num_items           The number of ranks.
+        exponent            The skew of the distribution (0 is uniform, 0.99 is typical of skewed traffic).
+        seed                The seed of the random generator.
+
+    Attributes:
+        cdf                 The probability of drawing a rank not greater than each rank
+        gen                 The random generator
+        uniform             Draws the probability that is searched in the cdf
+
+    Functions:
+        next                Returns the next rank
+*/
+class ZipfianGenerator
+{
+private:
+    std::vector<double> cdf;
+    std::mt19937_64 gen;
+    std::uniform_real_distribution<double> uniform;
+
+public:
+    ZipfianGenerator(long num_items, double exponent, uint64_t seed);
+
+    long next();
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef TEST_LEARNED_INDEX_H
+#define TEST_LEARNED_INDEX_H
+
+#include "learned_index.h"
+#include "test_helpers.h"
+
+void testLearnedIndexErrorBound();
+
+#endif
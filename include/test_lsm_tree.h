@@ -7,5 +7,21 @@
 void testLSMScanTwoPage();
 void testLSMScanTwoPagesDiskOnePageInMemoryOneLevel();
 void testLSMScanThreePagesOnDiskTwoLevel();
+void testLSMTombstoneDroppedEarly();
+void testLSMTombstoneDensityCompaction();
+void testLSMTombstoneCompactionOverlap();
+void testLSMDeleteRange();
+void testLSMDeleteRangeCompaction();
+void testLSMTrivialMove();
+void testLSMBulkLoad();
+void testLSMCompactionSplit();
+void testLSMMmapReadMode();
+void testLSMFencePointers();
+void testLSMLearnedIndex();
+void testLSMPackedPages();
+void testLSMCompression();
+void testLSMColumnarPages();
+void testLSMPageSize();
+void testLSMCorruptedCompaction();
 
 #endif
\ No newline at end of file
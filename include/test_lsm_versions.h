@@ -0,0 +1,11 @@
+#ifndef TEST_LSM_VERSIONS_H
+#define TEST_LSM_VERSIONS_H
+
+#include "lsm_tree.h"
+#include "test_helpers.h"
+
+void testLSMVersions();
+void testLSMConcurrentReads();
+void testLSMSnapshots();
+
+#endif
@@ -8,4 +8,10 @@ void testMemtableGetNodes();
 // Tests for Subtask 2
 void testScanMemtableEmpty();
 void testScanMemtableAllInRange();
+
+// Tests for range tombstones
+void testMemtableDeleteRange();
+
+// Tests for Memtables of other key and value types
+void testBasicMemtableTypes();
 #endif
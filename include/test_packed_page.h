@@ -0,0 +1,11 @@
+#ifndef TEST_PACKED_PAGE_H
+#define TEST_PACKED_PAGE_H
+
+#include "packed_page.h"
+#include "sst.h"
+#include "test_helpers.h"
+
+void testPackedPageKernels();
+void testPackedSST();
+
+#endif
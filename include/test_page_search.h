@@ -0,0 +1,9 @@
+#ifndef TEST_PAGE_SEARCH_H
+#define TEST_PAGE_SEARCH_H
+
+#include "page_search.h"
+#include "test_helpers.h"
+
+void testPageLowerBoundKernels();
+
+#endif
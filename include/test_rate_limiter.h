@@ -0,0 +1,13 @@
+#ifndef TEST_RATE_LIMITER_H
+#define TEST_RATE_LIMITER_H
+
+#include "rate_limiter.h"
+#include "lsm_tree.h"
+#include "test_helpers.h"
+
+void testRateLimiterThrottle();
+void testRateLimiterAutoTune();
+void testRateLimiterZeroBudget();
+void testLSMTreeRateLimiter();
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef TEST_ROW_CACHE_H
+#define TEST_ROW_CACHE_H
+
+#include "row_cache.h"
+#include "lsm_tree.h"
+#include "test_helpers.h"
+
+void testRowCache();
+void testRowCacheLSMTree();
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef TEST_SNAPSHOTS_H
+#define TEST_SNAPSHOTS_H
+
+#include "string_lsm_tree.h"
+#include "test_helpers.h"
+
+void testVersionedKeys();
+void testStringLSMSnapshots();
+
+#endif
@@ -9,5 +9,11 @@
 
 void testWriteMemtableToSST();
 void testGetFromSST();
+void testInterpolationSearch();
+void testSingleFileSST();
+void testSSTChecksumBlock();
+void testColumnarSST();
+void testLargePageSST();
+void testSizedBloomFilter();
 
 #endif
@@ -18,6 +18,10 @@ void createTestSSTWithBTree(int size);
 void testBTreeGet(StaticBTree btree, std::uniform_int_distribution<> distrib, std::mt19937 &gen, BufferPool *buffer_pool);       // Tests the get function for specific keys in the B-Tree file
 void testBTreeRangeScan(StaticBTree btree, std::uniform_int_distribution<> distrib, std::mt19937 &gen, BufferPool *buffer_pool); // Tests the range scan function for a range of keys
 
+void testSTreeLowerBound(); // Tests the S+-tree lower bound against std::lower_bound
+void testSTreeLayoutSST();  // Tests get and scan on an SST whose index uses the S+-tree layout
+void testBTreePageView();   // Tests reading B-Tree pages in place through a PageView
+
 // Main function to run all B-Tree tests
 int testBTreeMain(int memtable_size);
 
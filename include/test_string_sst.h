@@ -0,0 +1,14 @@
+#ifndef TEST_STRING_SST_H
+#define TEST_STRING_SST_H
+
+#include "slotted_page.h"
+#include "string_sst.h"
+#include "string_lsm_tree.h"
+#include "test_helpers.h"
+
+void testSlottedPage();
+void testStringSST();
+void testStringLSMTree();
+void testStringSSTPageSizes();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TEST_TYPED_SST_H
+#define TEST_TYPED_SST_H
+
+#include "typed_sst.h"
+#include "typed_lsm_tree.h"
+#include "test_helpers.h"
+
+void testPageLayout();
+void testTypedSST();
+void testTypedLSMTree();
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef TEST_VALUE_LOG_H
+#define TEST_VALUE_LOG_H
+
+#include "value_log.h"
+#include "string_lsm_tree.h"
+#include "test_helpers.h"
+
+void testValueLog();
+void testValueLogLSMTree();
+
+#endif
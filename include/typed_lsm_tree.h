@@ -0,0 +1,100 @@
+#ifndef TYPED_LSM_TREE_H
+#define TYPED_LSM_TREE_H
+
+#include "global.h"
+#include "memtable.h"
+#include "typed_sst.h"
+#include "buffer_pool.h"
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+
+/*
+    Represents an SST in a level of a TypedLSMTree.
+
+    Attributes:
+        level               The level of the SST
+        sst_filename        The name of the SST file
+        reader              The reader of the SST (holding its fence pointers)
+*/
+template <typename Key, typename Value>
+struct TypedSST
+{
+    int level;
+    std::string sst_filename;
+    std::shared_ptr<TypedSSTReader<Key, Value>> reader;
+};
+
+/*
+    An LSM tree of fixed-width keys and values of the given types, alongside the
+    LSMTree of long keys and values (whose SSTs also hold tombstones, packed,
+    columnar and compressed pages, B-Trees and value pointers, all laid out for
+    longs). Writes go to a BasicMemtable of the types, which is flushed to an
+    SST of PageLayout<Key, Value> pages (see TypedSSTWriter) on level 0 once
+    it holds memtable_size pairs, so 4-byte keys and values fill a page with
+    512 pairs instead of 256. Keys may be any value of their type, and a key is
+    deleted by a tombstone: the smallest value of the type (as LONG_MIN is for
+    the LSMTree). Levels are compacted as in the LSMTree: once a level holds
+    level_size_ratio SSTs they are merged into one by the same MergeIterator
+    (the newest value of every key wins, and tombstones are dropped once no
+    deeper level holds an SST), which stays on the level while it is at most
+    level_size_ratio^(level + 1) memtables big and moves to the next level
+    otherwise.
+
+    Input:
+        memtable_size       The max number of key-value pairs of the memtable.
+        database            The name of the database (the directory of its SSTs).
+
+    Attributes:
+        memtable            The memtable receiving the writes
+        levels              The SSTs of every level, oldest first
+        max_level           The number of levels
+        database_name       The name of the database
+        memtable_size       The max number of key-value pairs of the memtable
+        level_size_ratio    The number of SSTs that makes a level compact
+        TOMBSTONE           The value that marks a deleted key
+
+    Functions:
+        flushMemtable       Writes the memtable to a new SST on level 0 and replaces it with an empty one
+        mergeSSTs           Merges SSTs (oldest first) into a new SST
+        compactLevels       Merges the SSTs of every full level
+        put                 Inserts or replaces the value of a key, returns false if the memtable could not be flushed
+        remove              Deletes a key, returns false if the memtable could not be flushed
+        get                 Finds the value of a key, returns false if the key is not found or was deleted
+        scan                Returns the key-value pairs in [key1, key2] in key order
+        flush               Writes the memtable to level 0 if it holds any key
+        getMemtable         Returns the memtable
+        getLevels           Returns the SSTs of every level
+*/
+template <typename Key, typename Value>
+class TypedLSMTree
+{
+private:
+    BasicMemtable<Key, Value> *memtable;
+    std::vector<std::vector<TypedSST<Key, Value>>> levels;
+    int max_level = MAX_LSM_LEVEL;
+    std::string database_name;
+    int memtable_size;
+    size_t level_size_ratio = LEVEL_SIZE_RATIO;
+    static constexpr Value TOMBSTONE = std::numeric_limits<Value>::min();
+
+    bool flushMemtable();
+    bool mergeSSTs(const std::vector<TypedSST<Key, Value>> &ssts, bool drop_tombstones, TypedSST<Key, Value> &merged_sst);
+    void compactLevels();
+
+public:
+    TypedLSMTree(int memtable_size, std::string database);
+    ~TypedLSMTree();
+
+    bool put(Key key, Value value);
+    bool remove(Key key);
+    bool get(Key key, Value &value, BufferPool *buffer_pool);
+    std::vector<std::pair<Key, Value>> scan(Key key1, Key key2, BufferPool *buffer_pool);
+    bool flush();
+    BasicMemtable<Key, Value> *getMemtable();
+    const std::vector<std::vector<TypedSST<Key, Value>>> &getLevels();
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef TYPED_SST_H
+#define TYPED_SST_H
+
+#include "global.h"
+#include "buffer_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+/*
+    Writes a sorted stream of fixed-width key-value pairs of the given types into
+    a new SST file of PAGE_SIZE data pages, each laid out by
+    PageLayout<Key, Value>: the MAX_PAIRS keys of the page, then its MAX_PAIRS
+    values (a columnar page, so keys of any width are searched as a plain
+    array). The keys of the last page are padded with copies of its last key,
+    so they stay sorted and keys may be negative. With 4-byte keys and values, a page holds 512 pairs instead of
+    the 256 of long keys and values. Every page is recorded in a checksum file.
+
+    Input:
+        sst_filename        The name of the SST file to create.
+
+    Attributes:
+        sst_filename        The name of the SST file
+        fd                  The file descriptor of the SST file
+        buffer              The aligned buffer holding the page being written
+        write_offset        The offset of the next page in the file
+        num_page_pairs      The number of pairs in the buffer
+        num_entries         The number of pairs written
+        last_key            The last key written
+        checksums           The CRC32C of every page written
+        has_error           Whether a write failed (or a pair could not be written)
+
+    Functions:
+        writePage           Pads the keys of the buffer with its last key and writes it as the next page of the file
+        isOpen              Returns whether the file and the buffer were created successfully
+        put                 Appends a key-value pair (keys must be given in increasing order)
+        finish              Writes the final page and the checksums
+        getNumEntries       Returns the number of pairs written
+*/
+template <typename Key, typename Value>
+class TypedSSTWriter
+{
+private:
+    std::string sst_filename;
+    int fd;
+    void *buffer;
+    size_t write_offset;
+    long num_page_pairs;
+    long num_entries;
+    Key last_key;
+    std::vector<uint32_t> checksums;
+    bool has_error;
+
+    bool writePage();
+
+public:
+    TypedSSTWriter(std::string sst_filename);
+    ~TypedSSTWriter();
+
+    bool isOpen();
+    bool put(Key key, Value value);
+    bool finish();
+    long getNumEntries();
+};
+
+/*
+    Reads an SST written by a TypedSSTWriter of the same types. The first key of
+    every page (its fence pointer) is read when the SST is opened, so a get
+    reads a single page, which is searched with signedPageLowerBound (comparing
+    8 or 16 4-byte keys at once where the CPU supports it).
+
+    Input:
+        sst_filename        The name of the SST file to read.
+
+    Attributes:
+        sst_filename        The name of the SST file (every page read is checked against its checksum unless checksums are OFF)
+        fd                  The file descriptor of the SST file
+        fence_keys          The first key of every page
+        page_id             Reused buffer for the BufferPool id of the page being read
+
+    Functions:
+        readPage            Returns a page from the buffer pool or the disk
+        isOpen              Returns whether the SST was opened successfully
+        getNumPages         Returns the number of pages of the SST
+        get                 Finds the value of a key, returns false if it is not in the SST
+        scan                Appends the key-value pairs in [key1, key2] to the results, in key order
+        readPairs           Appends the key-value pairs of a page to the results, in key order
+*/
+template <typename Key, typename Value>
+class TypedSSTReader
+{
+private:
+    std::string sst_filename;
+    int fd;
+    std::vector<Key> fence_keys;
+    std::string page_id;
+
+    const char *readPage(long page_index, char *page_buffer, BufferPool *buffer_pool);
+
+public:
+    TypedSSTReader(std::string sst_filename);
+    ~TypedSSTReader();
+
+    bool isOpen();
+    long getNumPages();
+    bool get(Key key, Value &value, BufferPool *buffer_pool = nullptr);
+    bool scan(Key key1, Key key2, std::vector<std::pair<Key, Value>> &results, BufferPool *buffer_pool = nullptr);
+    bool readPairs(long page_index, std::vector<std::pair<Key, Value>> &results, BufferPool *buffer_pool = nullptr);
+};
+
+/*
+    Reads the key-value pairs of a TypedSST in key order, a page at a time, so
+    SSTs can be merged by a MergeIterator like the SSTs of the LSMTree.
+
+    Input:
+        reader              The reader of the SST (which must outlive the iterator).
+
+    Attributes:
+        reader              The reader of the SST
+        page_pairs          The key-value pairs of the current page
+        pos                 The position of the current key-value pair in page_pairs
+        next_page           The index of the next page to read
+        has_error           Whether a page could not be read
+
+    Functions:
+        readNextPage        Reads pages until one holds a pair (or the SST ends)
+        valid               Returns whether the iterator points at a key-value pair
+        hasError            Returns whether a page could not be read
+        key                 Returns the current key
+        value               Returns the current value
+        next                Advances to the next key-value pair
+*/
+template <typename Key, typename Value>
+class TypedSSTIterator
+{
+private:
+    TypedSSTReader<Key, Value> *reader;
+    std::vector<std::pair<Key, Value>> page_pairs;
+    size_t pos;
+    long next_page;
+    bool has_error;
+
+    void readNextPage();
+
+public:
+    TypedSSTIterator(TypedSSTReader<Key, Value> *reader);
+
+    bool valid();
+    bool hasError();
+    Key key();
+    Value value();
+    void next();
+};
+
+#endif
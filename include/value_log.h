@@ -0,0 +1,122 @@
+#ifndef VALUE_LOG_H
+#define VALUE_LOG_H
+
+#include "global.h"
+#include "rate_limiter.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const size_t VALUE_LOG_RECORD_HEADER_SIZE = 3 * sizeof(uint32_t); // CRC32C, key_length and value_length
+
+/*
+    Locates a value in the value log. Stored in the LSM tree in place of the
+    value, as VALUE_POINTER_SIZE bytes.
+
+    Attributes:
+        segment             The segment file holding the record of the value
+        offset              The offset (in bytes) of the record in the segment
+        size                The size (in bytes) of the record
+
+    Functions:
+        encode              Returns the bytes stored in the LSM tree for the pointer
+        decode              Reads a pointer from the bytes stored in the LSM tree, returns false if they are not a pointer
+*/
+struct ValuePointer
+{
+    long segment = -1;
+    long offset = 0;
+    long size = 0;
+
+    std::string encode() const;
+    bool decode(std::string_view bytes);
+    bool operator==(const ValuePointer &other) const
+    {
+        return segment == other.segment && offset == other.offset && size == other.size;
+    }
+};
+
+const size_t VALUE_POINTER_SIZE = 3 * sizeof(long); // Bytes of an encoded ValuePointer
+
+/*
+    An append-only log of the large values of a StringLSMTree (WiscKey key-value
+    separation), so compactions move a small pointer instead of the value. The
+    log is a sequence of segment files (vlog_<segment>.log in the directory of
+    the database). Records are appended to the newest segment until it holds
+    segment_size bytes:
+
+        [0, 4)              the CRC32C of the rest of the record
+        [4, 8)              key_length
+        [8, 12)             value_length
+        [12, ..)            the key bytes, then the value bytes
+
+    The key is kept with the value so that garbage collection can ask the LSM
+    tree whether the record is still the newest value of its key. Garbage
+    collection goes through the oldest segment other than the newest one,
+    appends its live records again and then removes the segment file.
+
+    Input:
+        directory           The directory of the segment files.
+        segment_size        The number of bytes appended to a segment before a new one is started.
+
+    Attributes:
+        directory           The directory of the segment files
+        segment_size        The number of bytes appended to a segment before a new one is started
+        segments            The file descriptor and size of every segment, by segment number
+        head_segment        The segment records are appended to
+        rate_limiter        The RateLimiter every append must request bytes from (or nullptr)
+        bytes_written       The number of bytes appended, including relocated records
+        segments_mutex      Guards segments while reads run in parallel
+
+    Functions:
+        getSegmentFilename  Returns the name of the file of a segment
+        openSegment         Returns the file descriptor of a segment, opening it if needed
+        startSegment        Starts a new head segment
+        readRecord          Reads and checks the record a pointer locates
+        append              Appends a key and its value, returns false if the write failed
+        read                Reads the value a pointer locates, returns false if it could not be read or is corrupted
+        readValues          Reads the values many pointers locate, with up to num_threads reads at once
+        collectGarbage      Relocates the live records of the oldest segment (using is_live and relocate) and removes it
+        getNumSegments      Returns the number of segment files
+        getBytesWritten     Returns the number of bytes appended, including relocated records
+        getDiskBytes        Returns the number of bytes of every segment file
+        setRateLimiter      Sets the RateLimiter of appends
+        removeAll           Removes every segment file
+*/
+class ValueLog
+{
+private:
+    std::string directory;
+    size_t segment_size;
+    std::map<long, std::pair<int, long>> segments;
+    long head_segment;
+    RateLimiter *rate_limiter;
+    long bytes_written;
+    std::mutex segments_mutex;
+
+    std::string getSegmentFilename(long segment);
+    int openSegment(long segment);
+    bool startSegment();
+    bool readRecord(const ValuePointer &pointer, std::string &key, std::string &value);
+
+public:
+    ValueLog(std::string directory, size_t segment_size = VALUE_LOG_SEGMENT_SIZE);
+    ~ValueLog();
+
+    bool append(std::string_view key, std::string_view value, ValuePointer &pointer, IOPriority priority = IOPriority::HIGH);
+    bool read(const ValuePointer &pointer, std::string &value);
+    bool readValues(const std::vector<ValuePointer> &pointers, std::vector<std::string> &values, int num_threads = VALUE_LOG_PREFETCH_THREADS);
+    bool collectGarbage(const std::function<bool(const std::string &key, const ValuePointer &pointer)> &is_live,
+                        const std::function<bool(const std::string &key, const ValuePointer &pointer)> &relocate);
+    long getNumSegments();
+    long getBytesWritten();
+    long getDiskBytes();
+    void setRateLimiter(RateLimiter *new_rate_limiter);
+    void removeAll();
+};
+
+#endif
@@ -37,7 +37,7 @@ int main()
             if (current_memtable != nullptr)
             {
                 // Write memtable to SST if there is unsaved data
-                if (current_memtable->getCurrSize() != 0)
+                if (current_memtable->getCurrSize() != 0 || !current_memtable->getRangeTombstones().empty())
                 {
                     std::pair<std::string, std::string> filenames = close(current_memtable, current_database, lsm_tree);
                     std::cout << "Wrote new SST: " << filenames.first << std::endl;
@@ -95,7 +95,7 @@ int main()
                 continue;
             }
             // If current memtable has data in it, then we write it to disk before closing database
-            if (current_memtable->getCurrSize() != 0)
+            if (current_memtable->getCurrSize() != 0 || !current_memtable->getRangeTombstones().empty())
             {
                 // Write current memtable to SST by calling close (which will write to disk)
                 std::pair<std::string, std::string> filenames = close(current_memtable, current_database, lsm_tree);
@@ -271,10 +271,45 @@ int main()
             // Call lsmTree put function with the LONG_MIN value representing a tombstone
             lsm_tree->put(key, value);
         }
+        // Handle DeleteRange(key1,key2) command
+        else if (std::regex_match(command, match, std::regex("DeleteRange\\(([0-9]+),([0-9]+)\\)")))
+        {
+            // Check if we are currently in a database.
+            if (current_memtable == nullptr || current_database.empty())
+            {
+                std::cout << "You must first open a database to use this operation." << std::endl;
+                continue;
+            }
+            long key1 = std::stol(match[1]);
+            long key2 = std::stol(match[2]);
+            // Call lsmTree deleteRange function which stores a single range tombstone for all of the keys
+            lsm_tree->deleteRange(key1, key2);
+        }
+        // Handle Ingest("filename") command
+        else if (std::regex_match(command, match, std::regex("Ingest\\(\"([^\"]+)\"\\)")))
+        {
+            // Check if we are currently in a database.
+            if (current_memtable == nullptr || current_database.empty())
+            {
+                std::cout << "You must first open a database to use this operation." << std::endl;
+                continue;
+            }
+            std::string filename = match[1];
+            // Sort the unsorted CSV or binary file of key-value pairs and load it straight into SSTs
+            if (lsm_tree->ingestFile(filename))
+            {
+                std::cout << "Ingested " << filename << "." << std::endl;
+                lsm_tree->printLSMTree();
+            }
+            else
+            {
+                std::cout << "Failed to ingest " << filename << "." << std::endl;
+            }
+        }
         // In case of Invalid data we prompt user with useful tips on using the API
         else
         {
-            std::cout << "Invalid Input: use Open(\"database name\"), Put(key, value), Get(key), Scan(key1, key2), Delete(key), Close(), Quit()." << std::endl;
+            std::cout << "Invalid Input: use Open(\"database name\"), Put(key, value), Get(key), Scan(key1, key2), Delete(key), DeleteRange(key1, key2), Ingest(\"filename\"), Close(), Quit()." << std::endl;
         }
     }
     return 0;
@@ -286,7 +321,8 @@ int main()
 std::pair<std::string, std::string> close(Memtable *current_memtable, std::string current_database, LSMTree *lsm_tree)
 {
     // Write current memtable to SST
-    std::pair<std::string, std::string> filenames = writeMemtableToDisk(current_memtable, current_database);
-    lsm_tree->insertSST(filenames.first, filenames.second);
+    SSTMetadata metadata;
+    std::pair<std::string, std::string> filenames = writeMemtableToDisk(current_memtable, current_database, lsm_tree->getRateLimiter(), &metadata);
+    lsm_tree->insertSST(filenames.first, filenames.second, &metadata);
     return filenames;
 }
\ No newline at end of file
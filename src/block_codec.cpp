@@ -0,0 +1,401 @@
+#include "block_codec.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the built-in LZ codec.
+/*
+    The built-in codec writes a block as a list of sequences, each made of a
+    token byte, literal bytes copied as they are, and a match copied from
+    earlier in the block:
+
+        token               The number of literals (high 4 bits) and the match length minus LZ_MIN_MATCH
+                            (low 4 bits), where 15 means the length continues in the following bytes
+        literal length      255 for every further 255 literals, then the remainder (only if the high bits are 15)
+        literals            The bytes copied as they are
+        match offset        How far back the match starts, 2 bytes little-endian (1 to LZ_MAX_OFFSET)
+        match length        Same as the literal length (only if the low bits are 15)
+
+    The last sequence of a block has no match, so the block ends after its
+    literals. Pages of sorted longs repeat most of their bytes (the high bytes
+    of nearby keys, the zero bytes of small values, the padding), which this
+    finds with a hash of the next 4 bytes.
+*/
+const size_t LZ_MIN_MATCH = 4;
+const size_t LZ_MAX_OFFSET = 65535;
+const int LZ_HASH_BITS = 12;
+const int LZ_HIGH_MAX_CANDIDATES = 64; // Earlier positions with the same hash tried by LZ_HIGH
+
+// Returns the hash of the 4 bytes at p.
+static uint32_t hashLZ(const char *p)
+{
+    uint32_t bytes;
+    std::memcpy(&bytes, p, sizeof(bytes));
+    return (bytes * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+// Returns the number of equal bytes at a and b, up to limit bytes.
+static size_t matchLengthLZ(const char *a, const char *b, size_t limit)
+{
+    size_t length = 0;
+    while (length + sizeof(uint64_t) <= limit)
+    {
+        uint64_t a_word, b_word;
+        std::memcpy(&a_word, a + length, sizeof(a_word));
+        std::memcpy(&b_word, b + length, sizeof(b_word));
+        if (a_word != b_word)
+        {
+            return length + __builtin_ctzll(a_word ^ b_word) / 8;
+        }
+        length += sizeof(uint64_t);
+    }
+    while (length < limit && a[length] == b[length])
+    {
+        length++;
+    }
+    return length;
+}
+
+// Writes the continuation bytes of a length of 15 or more, returns false if they do not fit.
+static bool writeLengthLZ(size_t length, char *dst, size_t &dst_offset, size_t capacity)
+{
+    for (length -= 15; length >= 255; length -= 255)
+    {
+        if (dst_offset >= capacity)
+        {
+            return false;
+        }
+        dst[dst_offset++] = static_cast<char>(255);
+    }
+    if (dst_offset >= capacity)
+    {
+        return false;
+    }
+    dst[dst_offset++] = static_cast<char>(length);
+    return true;
+}
+
+// Reads the continuation bytes of a length of 15, returns false if the block ends first.
+static bool readLengthLZ(const unsigned char *src, size_t &src_offset, size_t compressed_size, size_t &length)
+{
+    unsigned char byte;
+    do
+    {
+        if (src_offset >= compressed_size)
+        {
+            return false;
+        }
+        byte = src[src_offset++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/*
+    Writes a sequence of the literals [literals, literals + num_literals) and a
+    match of match_length bytes at offset (none if match_length is 0). Returns
+    false if the sequence does not fit in the capacity.
+*/
+static bool writeSequenceLZ(const char *literals, size_t num_literals, size_t offset, size_t match_length, char *dst, size_t &dst_offset, size_t capacity)
+{
+    if (dst_offset >= capacity)
+    {
+        return false;
+    }
+    size_t token_offset = dst_offset++;
+    size_t match_code = match_length > 0 ? match_length - LZ_MIN_MATCH : 0;
+    dst[token_offset] = static_cast<char>((std::min<size_t>(num_literals, 15) << 4) | std::min<size_t>(match_code, 15));
+    if (num_literals >= 15 && !writeLengthLZ(num_literals, dst, dst_offset, capacity))
+    {
+        return false;
+    }
+    if (dst_offset + num_literals > capacity)
+    {
+        return false;
+    }
+    std::memcpy(dst + dst_offset, literals, num_literals);
+    dst_offset += num_literals;
+    if (match_length == 0)
+    {
+        return true;
+    }
+
+    if (dst_offset + 2 > capacity)
+    {
+        return false;
+    }
+    dst[dst_offset++] = static_cast<char>(offset & 0xFF);
+    dst[dst_offset++] = static_cast<char>(offset >> 8);
+    return match_code < 15 || writeLengthLZ(match_code, dst, dst_offset, capacity);
+}
+
+/*
+    The built-in LZ codec. The fast preset tries the last position with the
+    same hash, the high preset follows a chain of up to LZ_HIGH_MAX_CANDIDATES
+    positions with the same hash and keeps the longest match. Both write the
+    same format, so they share the decoder.
+
+    Attributes:
+        is_high             Whether the codec searches the chain of earlier positions (LZ_HIGH)
+*/
+class LZCodec : public BlockCodec
+{
+private:
+    bool is_high;
+
+public:
+    LZCodec(bool is_high) : is_high(is_high) {}
+
+    CompressionType getType() const override
+    {
+        return is_high ? CompressionType::LZ_HIGH : CompressionType::LZ;
+    }
+    const char *getName() const override
+    {
+        return is_high ? "LZ (high)" : "LZ";
+    }
+    size_t compress(const char *src, size_t size, char *dst, size_t capacity) const override;
+    bool decompress(const char *src, size_t compressed_size, char *dst, size_t size) const override;
+};
+
+// Implementation of the compress function.
+size_t LZCodec::compress(const char *src, size_t size, char *dst, size_t capacity) const
+{
+    int32_t heads[1 << LZ_HASH_BITS];
+    std::fill(heads, heads + (1 << LZ_HASH_BITS), -1);
+    // The earlier position with the same hash as each position (only followed by LZ_HIGH)
+    std::vector<int32_t> chain(is_high ? size : 0, -1);
+
+    size_t dst_offset = 0;
+    size_t anchor = 0; // First byte not yet written
+    size_t pos = 0;
+    while (pos + LZ_MIN_MATCH <= size)
+    {
+        uint32_t hash = hashLZ(src + pos);
+        int32_t candidate = heads[hash];
+        heads[hash] = static_cast<int32_t>(pos);
+        if (is_high)
+        {
+            chain[pos] = candidate;
+        }
+
+        size_t best_length = 0, best_offset = 0;
+        for (int tries = 0; candidate >= 0 && pos - candidate <= LZ_MAX_OFFSET && tries < (is_high ? LZ_HIGH_MAX_CANDIDATES : 1); tries++)
+        {
+            size_t length = matchLengthLZ(src + candidate, src + pos, size - pos);
+            if (length > best_length)
+            {
+                best_length = length;
+                best_offset = pos - candidate;
+            }
+            candidate = is_high ? chain[candidate] : -1;
+        }
+
+        if (best_length < LZ_MIN_MATCH)
+        {
+            pos++;
+            continue;
+        }
+        if (!writeSequenceLZ(src + anchor, pos - anchor, best_offset, best_length, dst, dst_offset, capacity))
+        {
+            return 0;
+        }
+
+        // Hash the positions covered by the match, so later matches can start within it
+        for (size_t covered = pos + 1; covered < pos + best_length && covered + LZ_MIN_MATCH <= size; covered++)
+        {
+            uint32_t covered_hash = hashLZ(src + covered);
+            if (is_high)
+            {
+                chain[covered] = heads[covered_hash];
+            }
+            heads[covered_hash] = static_cast<int32_t>(covered);
+        }
+        pos += best_length;
+        anchor = pos;
+    }
+
+    // The bytes after the last match are written as the literals of the last sequence
+    if (!writeSequenceLZ(src + anchor, size - anchor, 0, 0, dst, dst_offset, capacity))
+    {
+        return 0;
+    }
+    return dst_offset;
+}
+
+// Implementation of the decompress function.
+bool LZCodec::decompress(const char *src, size_t compressed_size, char *dst, size_t size) const
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(src);
+    size_t src_offset = 0, dst_offset = 0;
+    while (src_offset < compressed_size)
+    {
+        unsigned char token = bytes[src_offset++];
+        size_t num_literals = token >> 4;
+        if (num_literals == 15 && !readLengthLZ(bytes, src_offset, compressed_size, num_literals))
+        {
+            return false;
+        }
+        if (src_offset + num_literals > compressed_size || dst_offset + num_literals > size)
+        {
+            return false;
+        }
+        std::memcpy(dst + dst_offset, src + src_offset, num_literals);
+        src_offset += num_literals;
+        dst_offset += num_literals;
+
+        // The last sequence has no match
+        if (src_offset == compressed_size)
+        {
+            break;
+        }
+        if (src_offset + 2 > compressed_size)
+        {
+            return false;
+        }
+        size_t offset = bytes[src_offset] | (static_cast<size_t>(bytes[src_offset + 1]) << 8);
+        src_offset += 2;
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !readLengthLZ(bytes, src_offset, compressed_size, match_length))
+        {
+            return false;
+        }
+        match_length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > dst_offset || dst_offset + match_length > size)
+        {
+            return false;
+        }
+
+        // A match may overlap the bytes it writes (e.g. a run of one repeated byte), so it is copied forwards
+        char *match = dst + dst_offset - offset;
+        for (size_t i = 0; i < match_length; i++)
+        {
+            dst[dst_offset + i] = match[i];
+        }
+        dst_offset += match_length;
+    }
+    return dst_offset == size;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the optional library codecs.
+#ifdef HAVE_LZ4
+// LZ4 codec (LZ4_compress_default and LZ4_decompress_safe).
+class LZ4Codec : public BlockCodec
+{
+public:
+    CompressionType getType() const override
+    {
+        return CompressionType::LZ4;
+    }
+    const char *getName() const override
+    {
+        return "LZ4";
+    }
+    size_t compress(const char *src, size_t size, char *dst, size_t capacity) const override
+    {
+        int compressed_size = LZ4_compress_default(src, dst, static_cast<int>(size), static_cast<int>(capacity));
+        return compressed_size > 0 ? compressed_size : 0;
+    }
+    bool decompress(const char *src, size_t compressed_size, char *dst, size_t size) const override
+    {
+        return LZ4_decompress_safe(src, dst, static_cast<int>(compressed_size), static_cast<int>(size)) == static_cast<int>(size);
+    }
+};
+#endif
+
+#ifdef HAVE_ZSTD
+// Zstandard codec at ZSTD_COMPRESSION_LEVEL.
+class ZstdCodec : public BlockCodec
+{
+public:
+    CompressionType getType() const override
+    {
+        return CompressionType::ZSTD;
+    }
+    const char *getName() const override
+    {
+        return "Zstandard";
+    }
+    size_t compress(const char *src, size_t size, char *dst, size_t capacity) const override
+    {
+        size_t compressed_size = ZSTD_compress(dst, capacity, src, size, ZSTD_COMPRESSION_LEVEL);
+        return ZSTD_isError(compressed_size) ? 0 : compressed_size;
+    }
+    bool decompress(const char *src, size_t compressed_size, char *dst, size_t size) const override
+    {
+        size_t decompressed_size = ZSTD_decompress(dst, size, src, compressed_size);
+        return !ZSTD_isError(decompressed_size) && decompressed_size == size;
+    }
+};
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the codec registry.
+// Implementation of the getBlockCodec function.
+const BlockCodec *getBlockCodec(CompressionType type)
+{
+    static const LZCodec lz_codec(false);
+    static const LZCodec lz_high_codec(true);
+#ifdef HAVE_LZ4
+    static const LZ4Codec lz4_codec;
+#endif
+#ifdef HAVE_ZSTD
+    static const ZstdCodec zstd_codec;
+#endif
+
+    switch (type)
+    {
+    case CompressionType::LZ:
+        return &lz_codec;
+    case CompressionType::LZ_HIGH:
+        return &lz_high_codec;
+#ifdef HAVE_LZ4
+    case CompressionType::LZ4:
+        return &lz4_codec;
+#endif
+#ifdef HAVE_ZSTD
+    case CompressionType::ZSTD:
+        return &zstd_codec;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+// Implementation of the isCompressionSupported function.
+bool isCompressionSupported(CompressionType type)
+{
+    return type == CompressionType::NONE || getBlockCodec(type) != nullptr;
+}
+
+// Implementation of the getCompressionName function.
+const char *getCompressionName(CompressionType type)
+{
+    switch (type)
+    {
+    case CompressionType::NONE:
+        return "None";
+    case CompressionType::LZ:
+        return "LZ";
+    case CompressionType::LZ_HIGH:
+        return "LZ (high)";
+    case CompressionType::LZ4:
+        return "LZ4";
+    case CompressionType::ZSTD:
+        return "Zstandard";
+    }
+    return "Unknown";
+}
+////////////////////////////////////////////////////////////////////////////
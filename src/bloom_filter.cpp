@@ -1,5 +1,7 @@
 #include "bloom_filter.h"
+#include "checksum.h"
 #include <fstream>
+#include <algorithm>
 #include <stdexcept>
 #include <functional>
 #include <iterator>
@@ -56,6 +58,7 @@ void BloomFilter::serialize(const std::string& filename) const {
         throw std::ios_base::failure("Unable to open Bloom filter file for writing.");
     }
     out.write(reinterpret_cast<const char*>(bit_array.data()), bit_array.size());
+    writeChecksumFile(filename, computePageChecksums(bit_array.data(), bit_array.size()));
 }
 
 // Load a Bloom filter from a binary file
@@ -68,6 +71,11 @@ void BloomFilter::loadBitArrayFromFile(const std::string& filename) {
     // Read the bit array from the file
     bit_array.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
     size = bit_array.size() * 8; // Recalculate size in bits
+
+    // A corrupted filter could hide keys that are in the SST, so it lets every key through instead
+    if (!isPageIntact(filename, 0, bit_array.data(), false, bit_array.size())) {
+        std::fill(bit_array.begin(), bit_array.end(), 0xFF);
+    }
 }
 
 // Ensure buffer size matches Bloom filter size
@@ -83,3 +91,13 @@ void BloomFilter::loadBitArrayFromBuffer(const void* buffer, size_t buffer_size)
 void BloomFilter::copyBitArrayToBuffer(void* buffer) const {
     std::memcpy(buffer, bit_array.data(), bit_array.size());
 }
+
+// Return the bit array, to be written into the filter block of an SST
+const void* BloomFilter::getRawBitArray() const {
+    return bit_array.data();
+}
+
+// Return the size of the bit array in bytes
+size_t BloomFilter::getSizeInBytes() const {
+    return bit_array.size();
+}
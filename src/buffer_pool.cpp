@@ -7,7 +7,7 @@
 /*
     Returns an index to the hashmap using the XXHash64 hash function.
 */
-int BufferPool::hashKey(std::string id)
+int BufferPool::hashKey(const std::string &id)
 {
     return XXHash64::hash(id.c_str(), id.size(), 0) % max_pages;
 }
@@ -43,7 +43,7 @@ BufferPool::~BufferPool()
     Return the page given a page id from the buffer pool. If id is not in
     bufferpool, then we return nullptr.
 */
-Page *BufferPool::searchForPage(std::string id)
+Page *BufferPool::searchForPage(const std::string &id)
 {
     int hash_index = hashKey(id);
 
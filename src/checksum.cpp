@@ -0,0 +1,367 @@
+#include "checksum.h"
+#include "sst_format.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdio>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CHECKSUM_X86
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the CRC32C kernels.
+// The reflected Castagnoli polynomial used by the SSE4.2 crc32 instruction
+static const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+/*
+    Tables of the software kernel (slicing-by-8): table[0] is the classic byte
+    at a time table and table[k] advances the checksum of a byte by k more bytes,
+    so eight bytes are folded in with eight independent lookups.
+*/
+struct CRC32CTables
+{
+    uint32_t table[8][256];
+
+    CRC32CTables()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0 - (crc & 1)));
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            for (int k = 1; k < 8; k++)
+            {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+static const CRC32CTables crc32c_tables;
+
+// Implementation of the software kernel.
+static uint32_t crc32cSoftware(const unsigned char *data, size_t length, uint32_t crc)
+{
+    const uint32_t(*table)[256] = crc32c_tables.table;
+    while (length >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        word ^= crc;
+        crc = table[7][word & 0xFF] ^ table[6][(word >> 8) & 0xFF] ^ table[5][(word >> 16) & 0xFF] ^ table[4][(word >> 24) & 0xFF] ^
+              table[3][(word >> 32) & 0xFF] ^ table[2][(word >> 40) & 0xFF] ^ table[1][(word >> 48) & 0xFF] ^ table[0][word >> 56];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0)
+    {
+        crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CHECKSUM_X86
+// Implementation of the hardware kernel, eight bytes per crc32 instruction.
+__attribute__((target("sse4.2"))) static uint32_t crc32cHardware(const unsigned char *data, size_t length, uint32_t crc)
+{
+    uint64_t crc64 = crc;
+    while (length >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (length-- > 0)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the runtime dispatch and the checksum mode.
+typedef uint32_t (*CRC32CFunction)(const unsigned char *, size_t, uint32_t);
+
+// Implementation of the isHardwareCRC32CSupported function.
+bool isHardwareCRC32CSupported()
+{
+#ifdef CHECKSUM_X86
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
+
+// Returns the kernel of the hardware or the software implementation.
+static CRC32CFunction getCRC32CFunction(bool use_hardware)
+{
+#ifdef CHECKSUM_X86
+    if (use_hardware)
+    {
+        return crc32cHardware;
+    }
+#endif
+    return crc32cSoftware;
+}
+
+static bool use_hardware_crc32c = isHardwareCRC32CSupported();
+static CRC32CFunction crc32c_function = getCRC32CFunction(use_hardware_crc32c);
+static std::atomic<ChecksumMode> checksum_mode(ChecksumMode::ON);
+static std::atomic<long> checksum_mismatches(0);
+
+// Implementation of the crc32c function.
+uint32_t crc32c(const void *data, size_t length, uint32_t crc)
+{
+    return ~crc32c_function(static_cast<const unsigned char *>(data), length, ~crc);
+}
+
+/*
+    Chooses between the hardware and the software kernel (used to compare
+    them). Returns false if the hardware kernel is not supported.
+*/
+bool setHardwareCRC32C(bool use_hardware)
+{
+    if (use_hardware && !isHardwareCRC32CSupported())
+    {
+        return false;
+    }
+    use_hardware_crc32c = use_hardware;
+    crc32c_function = getCRC32CFunction(use_hardware);
+    return true;
+}
+
+// Implementation of the isHardwareCRC32C function.
+bool isHardwareCRC32C()
+{
+    return use_hardware_crc32c;
+}
+
+// Implementation of the getChecksumMode function.
+ChecksumMode getChecksumMode()
+{
+    return checksum_mode;
+}
+
+// Implementation of the setChecksumMode function.
+void setChecksumMode(ChecksumMode mode)
+{
+    checksum_mode = mode;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the checksum files.
+/*
+    The checksums of a file. A file of the current SST format must have the
+    checksum of each of its first num_pages pages, so a checksum that is
+    missing (a checksum block cut short) fails the page instead of passing it.
+
+    Attributes:
+        checksums           The checksum of every page, in page order (empty if the file has no checksums)
+        num_pages           The number of pages that must have a checksum (0 for files written before the checksum block)
+*/
+struct PageChecksums
+{
+    std::vector<uint32_t> checksums;
+    long num_pages = 0;
+};
+
+// The checksums of every file read so far, by filename
+static std::unordered_map<std::string, PageChecksums> checksum_cache;
+static std::shared_mutex checksum_cache_mutex;
+
+/*
+    Returns the cached checksums of the file, reading its checksum file (or the
+    checksum block of a single-file SST) the first time. The caller must hold
+    checksum_cache_mutex exclusively.
+*/
+static const PageChecksums &getPageChecksums(const std::string &filename)
+{
+    auto it = checksum_cache.find(filename);
+    if (it != checksum_cache.end())
+    {
+        return it->second;
+    }
+
+    PageChecksums page_checksums;
+    std::vector<uint32_t> &checksums = page_checksums.checksums;
+    std::ifstream in(getChecksumFilename(filename), std::ios::binary | std::ios::ate);
+    if (in)
+    {
+        std::streamsize size = in.tellg();
+        checksums.resize(size / sizeof(uint32_t));
+        in.seekg(0);
+        in.read(reinterpret_cast<char *>(checksums.data()), checksums.size() * sizeof(uint32_t));
+    }
+    else
+    {
+        readSSTChecksumBlock(filename, checksums, page_checksums.num_pages);
+    }
+    return checksum_cache.emplace(filename, std::move(page_checksums)).first->second;
+}
+
+// Implementation of the getChecksumFilename function.
+std::string getChecksumFilename(const std::string &filename)
+{
+    return filename + ".crc";
+}
+
+// Returns the checksum of every page of the data (the last page may be partial).
+std::vector<uint32_t> computePageChecksums(const void *data, size_t size)
+{
+    std::vector<uint32_t> checksums;
+    checksums.reserve((size + PAGE_SIZE - 1) / PAGE_SIZE);
+    const char *page = static_cast<const char *>(data);
+    for (size_t offset = 0; offset < size; offset += PAGE_SIZE)
+    {
+        checksums.push_back(crc32c(page + offset, std::min(PAGE_SIZE, size - offset)));
+    }
+    return checksums;
+}
+
+/*
+    Writes the checksum file of a file that was just written, replacing the
+    cached checksums of any older file with the same name. Returns false if the
+    checksum file could not be written.
+*/
+bool writeChecksumFile(const std::string &filename, const std::vector<uint32_t> &checksums)
+{
+    std::ofstream out(getChecksumFilename(filename), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(checksums.data()), checksums.size() * sizeof(uint32_t));
+    bool is_written = static_cast<bool>(out);
+    if (!is_written)
+    {
+        std::cerr << "Error: Failed to write checksum file of " << filename << std::endl;
+    }
+
+    std::lock_guard<std::shared_mutex> lock(checksum_cache_mutex);
+    checksum_cache[filename] = is_written ? PageChecksums{checksums, 0} : PageChecksums();
+    return is_written;
+}
+
+/*
+    Caches the checksums of a file that was just written with its checksums
+    inside it (each of the pages they cover must match), replacing the cached
+    checksums of any older file with the same name.
+*/
+void cachePageChecksums(const std::string &filename, const std::vector<uint32_t> &checksums)
+{
+    std::lock_guard<std::shared_mutex> lock(checksum_cache_mutex);
+    checksum_cache[filename] = PageChecksums{checksums, static_cast<long>(checksums.size())};
+}
+
+/*
+    Checks the pages of a file starting at first_page, read into data, against
+    their checksums. Returns false (and reports the page) if any page does not
+    match. Threads reading at once share the cache, and only the first read of
+    a file takes it exclusively to load its checksum file.
+*/
+bool verifyPageChecksums(const std::string &filename, long first_page, const void *data, size_t size)
+{
+    const char *page = static_cast<const char *>(data);
+    std::shared_lock<std::shared_mutex> lock(checksum_cache_mutex);
+    auto it = checksum_cache.find(filename);
+    if (it == checksum_cache.end())
+    {
+        lock.unlock();
+        {
+            std::lock_guard<std::shared_mutex> exclusive_lock(checksum_cache_mutex);
+            getPageChecksums(filename);
+        }
+        lock.lock();
+        it = checksum_cache.find(filename);
+        if (it == checksum_cache.end())
+        {
+            return true;
+        }
+    }
+    const std::vector<uint32_t> &checksums = it->second.checksums;
+    for (size_t offset = 0; offset < size; offset += PAGE_SIZE, first_page++)
+    {
+        if (first_page >= static_cast<long>(checksums.size()) && first_page < it->second.num_pages)
+        {
+            checksum_mismatches++;
+            std::cerr << "Error: Missing checksum of page " << first_page << " of " << filename << std::endl;
+            return false;
+        }
+        if (first_page >= static_cast<long>(checksums.size()))
+        {
+            break;
+        }
+        if (crc32c(page + offset, std::min(PAGE_SIZE, size - offset)) != checksums[first_page])
+        {
+            checksum_mismatches++;
+            std::cerr << "Error: Checksum mismatch in page " << first_page << " of " << filename << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Checks pages against their checksums if the checksum mode asks for it:
+    pages read from disk are checked unless the mode is OFF, and cached pages
+    (from the buffer pool or a mapping) only in PARANOID mode. Returns false if
+    the pages are checked and do not match.
+*/
+bool isPageIntact(const std::string &filename, long first_page, const void *data, bool is_cached, size_t size)
+{
+    ChecksumMode mode = checksum_mode;
+    if (mode == ChecksumMode::OFF || (is_cached && mode != ChecksumMode::PARANOID))
+    {
+        return true;
+    }
+    return verifyPageChecksums(filename, first_page, data, size);
+}
+
+// Implementation of the getNumPageChecksums function.
+long getNumPageChecksums(const std::string &filename)
+{
+    std::lock_guard<std::shared_mutex> lock(checksum_cache_mutex);
+    return getPageChecksums(filename).checksums.size();
+}
+
+// Removes the checksum file (if any) of a file that is being removed, along with its cached checksums.
+void removeChecksumFile(const std::string &filename)
+{
+    std::remove(getChecksumFilename(filename).c_str());
+    dropPageChecksums(filename);
+}
+
+// Drops the cached checksums of a file that is being removed (a single-file SST holds its checksums).
+void dropPageChecksums(const std::string &filename)
+{
+    std::lock_guard<std::shared_mutex> lock(checksum_cache_mutex);
+    checksum_cache.erase(filename);
+}
+
+// Implementation of the getChecksumMismatches function.
+long getChecksumMismatches()
+{
+    return checksum_mismatches;
+}
+
+// Implementation of the resetChecksumMismatches function.
+void resetChecksumMismatches()
+{
+    checksum_mismatches = 0;
+}
+////////////////////////////////////////////////////////////////////////////
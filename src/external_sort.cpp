@@ -0,0 +1,232 @@
+#include "external_sort.h"
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the RunReader struct's constructor and functions.
+RunReader::RunReader(const std::string &filename)
+    : in(filename, std::ios::binary), buffer(EXTERNAL_SORT_MERGE_BUFFER_PAIRS), buffer_size(0), buffer_index(0) {}
+
+// Implementation of the isOpen function.
+bool RunReader::isOpen()
+{
+    return static_cast<bool>(in);
+}
+
+// Implementation of the next function.
+bool RunReader::next(long &key, long &value)
+{
+    if (buffer_index == buffer_size)
+    {
+        in.read(reinterpret_cast<char *>(buffer.data()), EXTERNAL_SORT_MERGE_BUFFER_PAIRS * ENTRY_SIZE);
+        buffer_size = in.gcount() / ENTRY_SIZE;
+        buffer_index = 0;
+        if (buffer_size == 0)
+        {
+            return false;
+        }
+    }
+    key = buffer[buffer_index].first;
+    value = buffer[buffer_index].second;
+    buffer_index++;
+    return true;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the ExternalSorter class's constructor and destructor.
+ExternalSorter::ExternalSorter(std::string run_prefix, size_t run_pairs, int num_threads)
+    : run_prefix(run_prefix), run_pairs(std::max<size_t>(run_pairs, 1)), num_threads(std::max(num_threads, 1)),
+      has_last_key(false), last_key(0), has_error(false)
+{
+    buffer.reserve(this->run_pairs);
+}
+
+ExternalSorter::~ExternalSorter()
+{
+    while (!pending_runs.empty())
+    {
+        waitForRun();
+    }
+    for (RunReader *reader : readers)
+    {
+        delete reader;
+    }
+
+    // The run files are only needed until the merge is over
+    for (const std::string &run_filename : run_filenames)
+    {
+        std::remove(run_filename.c_str());
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the ExternalSorter class's private functions.
+/*
+    Sorts the given run by key (keeping the order in which equal keys were
+    added), keeps only the last value of each key and writes it to the file.
+*/
+bool ExternalSorter::writeRun(std::vector<std::pair<long, long>> pairs, std::string filename)
+{
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [](const std::pair<long, long> &a, const std::pair<long, long> &b)
+                     { return a.first < b.first; });
+
+    // Keep the last value of every key
+    size_t num_unique = 0;
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        if (num_unique > 0 && pairs[num_unique - 1].first == pairs[i].first)
+        {
+            pairs[num_unique - 1].second = pairs[i].second;
+        }
+        else
+        {
+            pairs[num_unique++] = pairs[i];
+        }
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out)
+    {
+        std::cerr << "External Sort Error: Failed to open run file " << filename << " for writing." << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(pairs.data()), num_unique * ENTRY_SIZE);
+    return static_cast<bool>(out);
+}
+
+// Implementation of the flushRun function.
+void ExternalSorter::flushRun()
+{
+    if (buffer.empty())
+    {
+        return;
+    }
+
+    // Bound the memory used by waiting for the oldest run once num_threads runs are being sorted
+    if (pending_runs.size() >= static_cast<size_t>(num_threads))
+    {
+        waitForRun();
+    }
+
+    std::string run_filename = run_prefix + "_" + std::to_string(run_filenames.size()) + ".bin";
+    run_filenames.push_back(run_filename);
+    pending_runs.push_back(std::async(std::launch::async, writeRun, std::move(buffer), run_filename));
+
+    buffer = std::vector<std::pair<long, long>>();
+    buffer.reserve(run_pairs);
+}
+
+// Implementation of the waitForRun function.
+void ExternalSorter::waitForRun()
+{
+    if (!pending_runs.front().get())
+    {
+        has_error = true;
+    }
+    pending_runs.pop_front();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the ExternalSorter class's public functions.
+// Implementation of the add function.
+void ExternalSorter::add(long key, long value)
+{
+    buffer.emplace_back(key, value);
+    if (buffer.size() >= run_pairs)
+    {
+        flushRun();
+    }
+}
+
+/*
+    Writes the last run, waits for every run to be written and fills the heap
+    with the first pair of every run. Returns false if a run failed.
+*/
+bool ExternalSorter::finish()
+{
+    flushRun();
+    while (!pending_runs.empty())
+    {
+        waitForRun();
+    }
+    if (has_error)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < run_filenames.size(); ++i)
+    {
+        RunReader *reader = new RunReader(run_filenames[i]);
+        readers.push_back(reader);
+        if (!reader->isOpen())
+        {
+            std::cerr << "External Sort Error: Failed to open run file " << run_filenames[i] << " for reading." << std::endl;
+            has_error = true;
+            return false;
+        }
+
+        MergeEntry entry;
+        entry.run_index = i;
+        if (reader->next(entry.key, entry.value))
+        {
+            heap.push(entry);
+        }
+    }
+    return true;
+}
+
+/*
+    Pops the smallest key from the heap. Every run holds a key at most once and
+    newer runs come out first for equal keys, so the first pair of every key is
+    its last written value and the other pairs of that key are skipped.
+*/
+bool ExternalSorter::next(long &key, long &value)
+{
+    while (!heap.empty() && !has_error)
+    {
+        MergeEntry entry = heap.top();
+        heap.pop();
+
+        // Refill the heap from the run the pair came from
+        MergeEntry next_entry;
+        next_entry.run_index = entry.run_index;
+        if (readers[entry.run_index]->next(next_entry.key, next_entry.value))
+        {
+            heap.push(next_entry);
+        }
+        else if (readers[entry.run_index]->in.bad())
+        {
+            has_error = true;
+            return false;
+        }
+
+        if (has_last_key && entry.key == last_key)
+        {
+            continue;
+        }
+        has_last_key = true;
+        last_key = entry.key;
+        key = entry.key;
+        value = entry.value;
+        return true;
+    }
+    return false;
+}
+
+// Implementation of the hasError function.
+bool ExternalSorter::hasError()
+{
+    return has_error;
+}
+
+// Implementation of the getNumRuns function.
+size_t ExternalSorter::getNumRuns()
+{
+    return run_filenames.size();
+}
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,86 @@
+#include "learned_index.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the LearnedIndex class's constructor.
+LearnedIndex::LearnedIndex() : num_keys(0), slope_low(0), slope_high(std::numeric_limits<double>::infinity()) {}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the LearnedIndex class's public functions.
+/*
+    Adds the next key at position num_keys. The key narrows the cone of slopes
+    of the last segment to the slopes that predict its position to within
+    LEARNED_INDEX_EPSILON. If no slope is left, the key starts a new segment.
+    The slope of the last segment is kept in the middle of its cone, so the
+    index can be searched at any time.
+*/
+void LearnedIndex::add(long key)
+{
+    long position = num_keys++;
+    if (!segments.empty() && key > segments.back().first_key)
+    {
+        LearnedSegment &segment = segments.back();
+        double key_distance = static_cast<double>(key - segment.first_key);
+        double new_low = std::max(slope_low, (position - LEARNED_INDEX_EPSILON - segment.first_position) / key_distance);
+        double new_high = std::min(slope_high, (position + LEARNED_INDEX_EPSILON - segment.first_position) / key_distance);
+        if (new_low <= new_high)
+        {
+            slope_low = new_low;
+            slope_high = new_high;
+            segment.slope = (slope_low + slope_high) / 2;
+            return;
+        }
+    }
+
+    segments.push_back({key, position, 0});
+    slope_low = 0;
+    slope_high = std::numeric_limits<double>::infinity();
+}
+
+/*
+    Predicts the position of a key with the segment covering it. Positions are
+    clamped to the positions of the segment's keys, so a key between two
+    segments is never predicted past the next segment's first key. The position
+    of a key that was added is within LEARNED_INDEX_EPSILON of the prediction
+    (plus one for rounding).
+*/
+long LearnedIndex::predict(long key) const
+{
+    if (segments.empty() || key <= segments.front().first_key)
+    {
+        return 0;
+    }
+
+    // The last segment whose first key is not larger than the key covers it
+    auto next = std::upper_bound(segments.begin(), segments.end(), key,
+                                 [](long k, const LearnedSegment &segment)
+                                 { return k < segment.first_key; });
+    const LearnedSegment &segment = *(next - 1);
+    long last_position = next == segments.end() ? num_keys - 1 : next->first_position - 1;
+
+    double offset = segment.slope * static_cast<double>(key - segment.first_key);
+    long position = segment.first_position + std::lround(std::min(offset, static_cast<double>(last_position - segment.first_position)));
+    return std::clamp(position, segment.first_position, last_position);
+}
+
+// Implementation of the getNumKeys function.
+long LearnedIndex::getNumKeys() const
+{
+    return num_keys;
+}
+
+// Implementation of the getNumSegments function.
+size_t LearnedIndex::getNumSegments() const
+{
+    return segments.size();
+}
+
+// Implementation of the getMemoryBytes function.
+size_t LearnedIndex::getMemoryBytes() const
+{
+    return segments.size() * sizeof(LearnedSegment);
+}
+////////////////////////////////////////////////////////////////////////////
@@ -1,25 +1,136 @@
 #include "lsm_tree.h"
 #include "bloom_filter.h"
+#include "checksum.h"
+#include "merge_iterator.h"
 ////////////////////////////////////////////////////////////////////////////
 // Define the SST struct's constructor and destructor.
-SST::SST(int level, int level_index, std::string &sst_filename, std::string &btree_filename)
-    : level(level), level_index(level_index), sst_filename(sst_filename), btree_filename(btree_filename) {}
+SST::SST(int level, int level_index, std::string &sst_filename, std::string &btree_filename, SSTMetadata metadata)
+    : level(level), level_index(level_index), run(0), min_sequence(0), max_sequence(0), sst_filename(sst_filename), btree_filename(btree_filename), metadata(metadata) {}
 
 // SST::~SST() {}
 ////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////
+// Define the LSMVersion struct's destructor.
+// Removes the SSTs and frees the memtables that were dropped while the version was current (no reader can see them anymore).
+LSMVersion::~LSMVersion()
+{
+    for (const SST &sst : obsolete_ssts)
+    {
+        file_reclaimer->deleteSSTFiles(sst);
+    }
+    for (Memtable *obsolete_memtable : obsolete_memtables)
+    {
+        delete obsolete_memtable;
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the SSTFileReclaimer class's functions.
+/*
+    Returns the mapping of the given file, mapping it the first time it is
+    read, and hints the access pattern of the following reads to the kernel.
+    Files are never written after they are created, so a mapping stays valid
+    until the file is removed.
+*/
+std::shared_ptr<MappedFile> SSTFileReclaimer::getMappedFile(const std::string &filename, AccessPattern pattern)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = mapped_files.find(filename);
+    if (it == mapped_files.end())
+    {
+        it = mapped_files.emplace(filename, std::make_shared<MappedFile>(filename)).first;
+    }
+    it->second->advise(pattern);
+    return it->second;
+}
+
+// Implementation of the unmapFile function.
+void SSTFileReclaimer::unmapFile(const std::string &filename)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    mapped_files.erase(filename);
+}
+
+// Implementation of the unmapAll function.
+void SSTFileReclaimer::unmapAll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    mapped_files.clear();
+}
+
+/*
+    Deletes the SST, B-Tree, Bloom filter, range tombstone and checksum files of the given SST
+    (a single-file SST holds all of them as blocks).
+*/
+void SSTFileReclaimer::deleteSSTFiles(const SST &sst)
+{
+    unmapFile(sst.sst_filename);
+    std::remove(sst.sst_filename.c_str());
+    if (sst.btree_filename == sst.sst_filename)
+    {
+        dropPageChecksums(sst.sst_filename);
+        return;
+    }
+    std::remove(getRangeTombstoneFilename(sst.sst_filename).c_str());
+    removeChecksumFile(sst.sst_filename);
+
+    std::string bloom_filename = sst.sst_filename;
+    bloom_filename.replace(bloom_filename.find("sst_"), 4, "bloom_");
+
+    unmapFile(sst.btree_filename);
+    unmapFile(bloom_filename);
+
+    std::remove(sst.btree_filename.c_str());
+    std::remove(bloom_filename.c_str());
+    removeChecksumFile(sst.btree_filename);
+    removeChecksumFile(bloom_filename);
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the LSMTree::WriteLock struct's constructor and destructor.
+LSMTree::WriteLock::WriteLock(LSMTree &lsm_tree, bool changes_levels) : lsm_tree(lsm_tree)
+{
+    lsm_tree.write_mutex.lock();
+    lsm_tree.write_depth++;
+    lsm_tree.is_version_stale = lsm_tree.is_version_stale || changes_levels;
+}
+
+// Implementation of the LSMTree::WriteLock destructor.
+LSMTree::WriteLock::~WriteLock()
+{
+    if (--lsm_tree.write_depth == 0 && lsm_tree.is_version_stale)
+    {
+        lsm_tree.installVersion();
+    }
+    lsm_tree.write_mutex.unlock();
+}
+////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////
 // Define the LSMTree class's constructor and destructor.
 LSMTree::LSMTree(size_t m_s, std::string database, Memtable *memtable)
-    : memtable_size(m_s), database_name(database), memtable(memtable)
+    : memtable(memtable), database_name(database), memtable_size(m_s)
 {
     for (int i = 0; i < max_level; i++)
     {
         levels.emplace_back();
+        level_compression.push_back(CompressionType::NONE);
     }
+    installVersion();
 }
 
-// LSMTree::~LSMTree() {}
+// Implementation of the LSMTree destructor (the SSTs and the memtable of the current version are kept, the frozen memtables are freed with it).
+LSMTree::~LSMTree()
+{
+    for (const FrozenMemtable &frozen : frozen_memtables)
+    {
+        current_version->obsolete_memtables.push_back(frozen.memtable);
+    }
+    std::atomic_store(&current_version, std::shared_ptr<LSMVersion>());
+}
 ////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////
@@ -30,821 +141,1789 @@ std::pair<SST &, SST &> LSMTree::fileCompare(SST &sst1, SST &sst2)
     return sst1.sst_filename < sst2.sst_filename ? std::pair<SST &, SST &>{sst1, sst2} : std::pair<SST &, SST &>{sst2, sst1};
 }
 
-void freeMergeSSTsResources(int fd1, int fd2, int fd3, int fd4, void *buffer1, void *buffer2, void *buffer3, void *buffer4)
+/*
+    Merges the given SSTs, ordered from oldest to newest, in a single pass of
+    a MergeIterator: for a key found in several SSTs only the value of the
+    newest is kept. The inputs are all of
+    one stripe (see getStripe), so no live snapshot sees a value that is
+    dropped. A key-value pair covered by a range tombstone of a newer input is
+    dropped. A tombstone (or range tombstone) is dropped if no snapshot is
+    older than the inputs (a snapshot could otherwise still see an older value
+    in an older stripe) and this is the last level or no SST below the level of
+    the oldest input could hold an older value for it. The output
+    is split into SSTs of COMPACTION_SST_PAIRS pairs, which form a single
+    sorted run compressed as set for output_level. Each output SST keeps the
+    range tombstones clipped to the keys between it and the next one, so the
+    outputs never overlap. If successful then fill in the output SSTs (none if
+    nothing is left) and return true. If unsuccessful then every output file is
+    deleted and false is returned. The inputs are left for the caller to remove.
+*/
+bool LSMTree::mergeSSTs(const std::vector<SST> &inputs, bool last_level, int output_level, std::vector<SST> &outputs)
 {
-    if (fd1 >= 0)
+    // Open every input for sequential reads
+    std::vector<std::unique_ptr<SSTIterator>> iterators;
+    long num_input_entries = 0;
+    uint64_t min_sequence = LATEST_SEQUENCE;
+    uint64_t max_sequence = 0;
+    for (const SST &input : inputs)
     {
-        close(fd1);
+        iterators.emplace_back(new SSTIterator(input.sst_filename));
+        if (!iterators.back()->isOpen())
+        {
+            return false;
+        }
+        num_input_entries += input.metadata.num_entries;
+        min_sequence = std::min(min_sequence, input.min_sequence);
+        max_sequence = std::max(max_sequence, input.max_sequence);
     }
-    if (fd2 >= 0)
+    bool keeps_tombstones = hasSnapshotBefore(min_sequence);
+
+    // Gives the smallest key next, with its value from the newest input holding it
+    std::vector<SSTIterator *> merged_iterators;
+    for (const std::unique_ptr<SSTIterator> &iterator : iterators)
     {
-        close(fd2);
+        merged_iterators.push_back(iterator.get());
     }
-    if (fd3 >= 0)
+    MergeIterator<SSTIterator> merge_iterator(merged_iterators);
+
+    // Keep the range tombstones of every input that may still hide older values in deeper levels
+    int first_older_level = inputs.front().level + 1;
+    RangeTombstones range_tombstones;
+    for (const SST &input : inputs)
     {
-        close(fd3);
+        for (const std::pair<long, long> &range : input.metadata.range_tombstones.getRanges())
+        {
+            if (keeps_tombstones || (!last_level && levelsOverlap(range.first, range.second, first_older_level)))
+            {
+                range_tombstones.add(range.first, range.second);
+            }
+        }
     }
-    if (fd4 >= 0)
+
+    // Compactions of level 0 free up room for flushes, so they are given priority over deeper compactions
+    IOPriority priority = inputs.front().level == 0 ? IOPriority::MEDIUM : IOPriority::LOW;
+    long run = next_run++;
+    std::unique_ptr<SSTWriter> writer;
+    std::string sst_filename;
+    long lower_key = LONG_MIN;
+    size_t num_pairs = 0;
+    bool is_success = true;
+
+    // Finishes the current output SST with the range tombstones between lower_key and upper_key
+    auto finish_output = [&](long upper_key)
+    {
+        for (const std::pair<long, long> &range : range_tombstones.getRanges())
+        {
+            if (range.first <= upper_key && lower_key <= range.second)
+            {
+                writer->putRangeTombstone(std::max(range.first, lower_key), std::min(range.second, upper_key));
+            }
+        }
+        is_success = writer->finish();
+        SST output(output_level, 0, sst_filename, sst_filename, writer->getMetadata());
+        output.run = run;
+        output.min_sequence = min_sequence;
+        output.max_sequence = max_sequence;
+        outputs.push_back(output);
+        writer.reset();
+    };
+
+    for (; is_success && merge_iterator.valid(); merge_iterator.next())
     {
-        close(fd4);
+        size_t newest = merge_iterator.source();
+        long key = merge_iterator.key();
+        long value = merge_iterator.value();
+
+        // Drop the key-value pair if a newer SST deleted its key range
+        bool is_deleted = false;
+        for (size_t i = newest + 1; i < inputs.size() && !is_deleted; ++i)
+        {
+            is_deleted = inputs[i].metadata.range_tombstones.covers(key);
+        }
+        // Drop tombstones if its the last level or if there is no older value left for them to hide
+        if (is_deleted || (value == LONG_MIN && !keeps_tombstones && (last_level || !levelsOverlap(key, key, first_older_level))))
+        {
+            continue;
+        }
+
+        // Start the next output SST once the current one is full
+        if (writer != nullptr && num_pairs == COMPACTION_SST_PAIRS)
+        {
+            finish_output(key - 1);
+            lower_key = key;
+        }
+        if (writer == nullptr && is_success)
+        {
+            sst_filename = DATA_FILE_PATH + database_name + "/sst_" + getCurrentTimestamp() + ".bin";
+            writer.reset(new SSTWriter(sst_filename, rate_limiter, priority, DEFAULT_INDEX_LAYOUT, page_encoding, level_compression[output_level], getPageSize(output_level)));
+            writer->sizeFilter(std::min<size_t>(num_input_entries, COMPACTION_SST_PAIRS));
+            num_pairs = 0;
+            is_success = writer->isOpen();
+        }
+        is_success = is_success && writer->put(key, value);
+        num_pairs++;
     }
 
-    if (buffer1 != nullptr)
+    // The last output SST also keeps the range tombstones above its keys (an output is only written for them if nothing else is left)
+    if (is_success && writer == nullptr && !range_tombstones.empty())
+    {
+        sst_filename = DATA_FILE_PATH + database_name + "/sst_" + getCurrentTimestamp() + ".bin";
+        writer.reset(new SSTWriter(sst_filename, rate_limiter, priority, DEFAULT_INDEX_LAYOUT, page_encoding, level_compression[output_level], getPageSize(output_level)));
+        is_success = writer->isOpen();
+    }
+    if (writer != nullptr)
     {
-        free(buffer1);
-        buffer1 = nullptr;
+        finish_output(LONG_MAX);
     }
-    if (buffer2 != nullptr)
+
+    is_success = is_success && !merge_iterator.hasError();
+    if (!is_success)
     {
-        free(buffer2);
-        buffer2 = nullptr;
+        // The outputs were never part of a version, so no reader can see them
+        for (const SST &output : outputs)
+        {
+            deleteSSTFiles(output);
+        }
+        outputs.clear();
+        std::remove(sst_filename.c_str());
+        return false;
     }
-    if (buffer3 != nullptr)
+    return true;
+}
+
+/*
+    Puts the given sst and btree into the first level of the LSM tree,
+    if compaction is needed then perform compactLevels.
+*/
+void LSMTree::put(long key, long value)
+{
+    WriteLock write_lock(*this, false);
     {
-        free(buffer3);
-        buffer3 = nullptr;
+        std::unique_lock<std::shared_mutex> memtable_lock(memtable_mutex);
+        memtable->put(key, value);
     }
-    if (buffer4 != nullptr)
+    last_sequence++;
+    RowCache *curr_row_cache = row_cache;
+    if (curr_row_cache != nullptr)
     {
-        free(buffer4);
-        buffer4 = nullptr;
+        curr_row_cache->erase(key);
     }
 
-    return;
+    if (!isMemtableFull())
+    {
+        return;
+    }
+    flushMemtable();
 }
 
 /*
-    Merges the two given SSTs together. If successful then return new merged SST
-    filename. If unsuccessful then return empty string.
+    Deletes every key in [key1, key2] by storing a single range tombstone in
+    the memtable, instead of a tombstone for each key.
 */
-std::pair<std::string, std::string> LSMTree::mergeSSTs(SST &sst1, SST &sst2, bool last_level)
+void LSMTree::deleteRange(long key1, long key2)
 {
-    // Prepare all needed Resources
-    int fd1 = -1;
-    int fd2 = -1;
-    int fd3 = -1;
-    int fd4 = -1;
-    void *read_buffer_1 = nullptr;
-    void *read_buffer_2 = nullptr;
-    void *write_buffer_SST = nullptr;
-    void *write_buffer_BTree = nullptr;
-    // Open two sst files
-    fd1 = open(sst1.sst_filename.c_str(), O_RDONLY | O_DIRECT);
-    if (fd1 < 0)
+    WriteLock write_lock(*this, false);
+    {
+        std::unique_lock<std::shared_mutex> memtable_lock(memtable_mutex);
+        memtable->deleteRange(key1, key2);
+    }
+    last_sequence++;
+    RowCache *curr_row_cache = row_cache;
+    if (curr_row_cache != nullptr)
     {
-        std::cerr << "Read SST Error: Failed to open SST file - " << sst1.sst_filename << " for read." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        curr_row_cache->eraseRange(key1, key2);
     }
 
-    fd2 = open(sst2.sst_filename.c_str(), O_RDONLY | O_DIRECT);
-    if (fd2 < 0)
+    if (!isMemtableFull())
     {
-        std::cerr << "Read SST Error: Failed to open SST file - " << sst2.sst_filename << " for read." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        return;
     }
-    // Prepare new filenames
-    std::string string_time_now = getCurrentTimestamp();
-    std::string new_sst_filename = DATA_FILE_PATH + database_name + "/sst_" + string_time_now + ".bin";
-    std::string new_btree_filename = DATA_FILE_PATH + database_name + "/btree_" + string_time_now + ".bin";
-    std::string bloom_filter_filename = DATA_FILE_PATH + database_name + "/bloom_" + string_time_now + ".bin";
+    flushMemtable();
+}
 
-    // Prepare new files to write to
-    fd3 = open(new_sst_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
-    fd4 = open(new_btree_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
+/*
+    Returns whether the active and the frozen memtables together hold as many
+    entries as the memtable may. Every range tombstone takes up a slot in the
+    memtable, so that they are flushed too.
+*/
+bool LSMTree::isMemtableFull()
+{
+    size_t num_entries = memtable->getCurrSize() + memtable->getRangeTombstones().size();
+    for (const FrozenMemtable &frozen : frozen_memtables)
+    {
+        num_entries += frozen.memtable->getCurrSize() + frozen.memtable->getRangeTombstones().size();
+    }
+    return num_entries >= static_cast<size_t>(memtable->getMemtableSize());
+}
 
-    if (fd3 < 0)
+// Returns whether the active or a frozen memtable holds a key or a range tombstone in [key1, key2].
+bool LSMTree::memtablesOverlap(long key1, long key2)
+{
+    std::vector<Memtable *> memtables{memtable};
+    for (const FrozenMemtable &frozen : frozen_memtables)
     {
-        perror("open failed");
-        std::cerr << "Read SST Error: Failed to open SST file for read." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        memtables.push_back(frozen.memtable);
     }
 
-    if (fd4 < 0)
+    bool is_overlapping = false;
+    for (Memtable *curr_memtable : memtables)
     {
-        perror("open failed");
-        std::cerr << "Read B-Tree Error: Failed to open B-Tree file for read." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        std::pair<std::pair<long, long> *, int> array_size_pair = curr_memtable->scan(key1, key2);
+        is_overlapping = is_overlapping || array_size_pair.second > 0;
+        delete[] array_size_pair.first;
+        for (const std::pair<long, long> &range : curr_memtable->getRangeTombstones().getRanges())
+        {
+            is_overlapping = is_overlapping || (range.first <= key2 && key1 <= range.second);
+        }
     }
+    return is_overlapping;
+}
 
-    // Alignment and buffer size requirements for Direct I/O
-    const size_t buffer_size = PAGE_SIZE;
+/*
+    Writes the frozen memtables, from oldest to newest, and then the memtable
+    to new SSTs on level 0, and replaces the memtable with an empty one. Every
+    memtable is written to an SST of its own, so no SST holds writes on both
+    sides of a live snapshot.
+*/
+void LSMTree::flushMemtable()
+{
+    WriteLock write_lock(*this, true);
+    std::vector<FrozenMemtable> flushed_memtables = std::move(frozen_memtables);
+    frozen_memtables.clear();
+    if (memtable->getCurrSize() > 0 || !memtable->getRangeTombstones().empty())
+    {
+        flushed_memtables.push_back({memtable, memtable_min_sequence, last_sequence});
+        memtable = new Memtable(memtable_size);
+        memtable_min_sequence = last_sequence + 1;
+    }
 
-    if (posix_memalign(&read_buffer_1, PAGE_SIZE, buffer_size) != 0)
+    for (const FrozenMemtable &flushed : flushed_memtables)
     {
-        std::cerr << "Error: Memory alignment allocation failed." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        SSTMetadata metadata;
+        std::pair<std::string, std::string> filenames = writeMemtableToDisk(flushed.memtable, database_name, rate_limiter, &metadata, page_encoding, level_compression[0], getPageSize(0));
+        retired_memtables.push_back(flushed.memtable); // Freed once no reader can see it (its in SST now)
+        addLevel0SST(filenames.first, filenames.second, metadata, flushed.min_sequence, flushed.max_sequence);
     }
+}
 
-    if (posix_memalign(&read_buffer_2, PAGE_SIZE, buffer_size) != 0)
+/*
+    Adds the given SST to level 0 as the newest SST of the tree. If its
+    metadata is not given, then it is computed by reading the SST, and the SST
+    is refused (false is returned) if it could not be read in full, so no read
+    relies on statistics that miss some of its keys. Adding the SST is a write
+    of its own, which takes the next sequence number.
+*/
+bool LSMTree::insertSST(std::string sst_filename, std::string btree_filename, const SSTMetadata *metadata)
+{
+    WriteLock write_lock(*this, true);
+    SSTMetadata sst_metadata;
+    if (metadata != nullptr)
     {
-        std::cerr << "Error: Memory alignment allocation failed." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        sst_metadata = *metadata;
     }
+    else if (!readSSTMetadata(sst_filename, sst_metadata))
+    {
+        std::cerr << "Error: SST file " << sst_filename << " was not added to the LSM tree." << std::endl;
+        return false;
+    }
+    last_sequence++;
+    addLevel0SST(sst_filename, btree_filename, sst_metadata, last_sequence, last_sequence);
+    return true;
+}
+
+/*
+    Adds an SST holding the writes with sequence numbers in [min_sequence,
+    max_sequence] to level 0, then compacts the levels that are full and any
+    SST that has too many tombstones. The SST is added even if level 0 is
+    still full because a compaction failed (for example on a corrupted page),
+    so a flushed SST is never lost: its compaction is tried again on the next
+    flush.
+*/
+void LSMTree::addLevel0SST(std::string sst_filename, std::string btree_filename, const SSTMetadata &metadata, uint64_t min_sequence, uint64_t max_sequence)
+{
+    levels[0].emplace_back(0, levels[0].size(), sst_filename, btree_filename, metadata);
+    levels[0].back().run = next_run++;
+    levels[0].back().min_sequence = min_sequence;
+    levels[0].back().max_sequence = max_sequence;
 
-    if (posix_memalign(&write_buffer_SST, PAGE_SIZE, buffer_size) != 0)
+    if (countRuns(0) >= level_size_ratio)
     {
-        std::cerr << "Error: Memory alignment allocation failed." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        compactLevels();
     }
+    compactTombstones();
+}
 
-    if (posix_memalign(&write_buffer_BTree, PAGE_SIZE, buffer_size) != 0)
+/*
+    Returns the result of scanning the lsm tree, as of the version that is
+    current when the scan starts, or as of the given snapshot (an empty result
+    if it is not live). A scan at a snapshot skips the memtables and SSTs that
+    only hold newer writes.
+*/
+std::pair<std::pair<long, long> *, int> LSMTree::scan(long key1, long key2, BufferPool *buffer_pool, bool with_btree, uint64_t snapshot)
+{
+    std::shared_ptr<const LSMVersion> version = snapshot != LATEST_SEQUENCE ? findSnapshot(snapshot) : std::atomic_load(&current_version);
+    if (version == nullptr)
     {
-        std::cerr << "Error: Memory alignment allocation failed." << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        return {new std::pair<long, long>[0], 0};
     }
+    const std::vector<std::vector<SST>> &levels = version->levels;
 
-    off_t read_page_offset_1 = 0;
-    off_t read_page_offset_2 = 0;
-    off_t sst_write_page_offset = 0;
+    // First, check the memtable for the key
+    std::map<long, long> key_value_pairs;
 
-    off_t sst_write_offset = 0;
+    // Key ranges deleted by the memtable or an SST that was already scanned (these hide every older SST)
+    RangeTombstones deleted_ranges;
 
-    off_t read_file_size1 = lseek(fd1, 0, SEEK_END);
-    off_t read_file_size2 = lseek(fd2, 0, SEEK_END);
+    // First check memtable (it only holds writes newer than every live snapshot, see getSnapshot)
+    if (snapshot == LATEST_SEQUENCE)
+    {
+        std::shared_lock<std::shared_mutex> memtable_lock(memtable_mutex);
+        std::pair<std::pair<long, long> *, int> array_size_pair = version->memtable->scan(key1, key2);
+        std::pair<long, long> *key_value_pairs_memtable = array_size_pair.first;
+        int scanned_size = array_size_pair.second;
+        for (int i = 0; i < scanned_size; i++)
+        {
+            // std::cerr << "From Memtable: " << key_value_pairs_memtable[i].first << ", " << key_value_pairs_memtable[i].second;
+            key_value_pairs[key_value_pairs_memtable[i].first] = key_value_pairs_memtable[i].second;
+        }
+        delete[] key_value_pairs_memtable;
+        deleted_ranges.merge(version->memtable->getRangeTombstones());
+    }
 
-    // std::cerr << read_file_size1 << ", " << read_file_size2 << "\n";
+    // Then the frozen memtables, newest first (they take no more writes, so they are read without a lock)
+    for (auto frozen = version->frozen_memtables.rbegin(); frozen != version->frozen_memtables.rend(); ++frozen)
+    {
+        if (frozen->max_sequence > snapshot)
+        {
+            continue;
+        }
+        std::pair<std::pair<long, long> *, int> array_size_pair = frozen->memtable->scan(key1, key2);
+        for (int i = 0; i < array_size_pair.second; i++)
+        {
+            if (key_value_pairs.find(array_size_pair.first[i].first) == key_value_pairs.end() && !deleted_ranges.covers(array_size_pair.first[i].first))
+            {
+                key_value_pairs[array_size_pair.first[i].first] = array_size_pair.first[i].second;
+            }
+        }
+        delete[] array_size_pair.first;
+        deleted_ranges.merge(frozen->memtable->getRangeTombstones());
+    }
 
-    // Initially read in a buffer size worth of data from first SSTs
-    ssize_t read_page1 = pread(fd1, read_buffer_1, PAGE_SIZE, read_page_offset_1);
-    if (read_page1 < 0)
+    for (size_t level_idx = 0; level_idx < levels.size(); level_idx++)
     {
-        std::cerr << "Error: Failed to read page in SST file " << sst1.sst_filename << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        const std::vector<SST> &level = levels[level_idx];
+
+        // Scan the newest SST of the level first
+        for (int i = level.size() - 1; i >= 0; --i)
+        {
+            // Skip the SST if the range is outside of its key range, or if it only holds writes newer than the snapshot
+            if (!level[i].metadata.overlaps(key1, key2) || level[i].max_sequence > snapshot)
+            {
+                continue;
+            }
+
+            std::string sst_filename = level[i].sst_filename; // Filter file associated with the SST
+            std::string btree_filename = level[i].btree_filename;
+
+            std::vector<std::pair<long, long>> scanned_values;
+            if (read_mode == ReadMode::MMAP)
+            {
+                std::shared_ptr<MappedFile> sst_map = getMappedFile(sst_filename, AccessPattern::SEQUENTIAL);
+                if (with_btree)
+                {
+                    std::shared_ptr<MappedFile> btree_map = getMappedFile(btree_filename, AccessPattern::SEQUENTIAL);
+                    StaticBTree btree(sst_filename, btree_filename, sst_map.get(), btree_map.get());
+                    btree.setIndexBlock(level[i].metadata.footer);
+                    scanned_values = btree.scan(key1, key2);
+                }
+                else
+                {
+                    scanned_values = binarySearchScan(sst_filename, key1, key2, buffer_pool, sst_map.get(), &level[i].metadata.footer);
+                }
+            }
+            else if (with_btree)
+            {
+                StaticBTree btree(sst_filename, btree_filename);
+                btree.setIndexBlock(level[i].metadata.footer);
+                scanned_values = btree.scan(key1, key2, buffer_pool);
+            }
+            else
+            {
+                scanned_values = binarySearchScan(sst_filename, key1, key2, buffer_pool, nullptr, &level[i].metadata.footer);
+            }
+
+            for (size_t j = 0; j < scanned_values.size(); j++)
+            {
+                if (key_value_pairs.find(scanned_values[j].first) == key_value_pairs.end() && !deleted_ranges.covers(scanned_values[j].first))
+                {
+                    // std::cerr << "From SST: " << scanned_values[j].first << ", " << scanned_values[j].second;
+                    key_value_pairs[scanned_values[j].first] = scanned_values[j].second;
+                }
+            }
+            deleted_ranges.merge(level[i].metadata.range_tombstones);
+
+            // If we find all of the keys in the range then end early (no point in searching more)
+            if (!key_value_pairs.empty() && key_value_pairs.size() - 1 >= static_cast<unsigned long>(key2) - static_cast<unsigned long>(key1))
+            {
+                // Dynamically allocate memory for the result array
+                std::pair<long, long> *arr_values = new std::pair<long, long>[key_value_pairs.size()];
+                std::copy(key_value_pairs.begin(), key_value_pairs.end(), arr_values);
+
+                return {arr_values, static_cast<int>(key_value_pairs.size())};
+            }
+        }
     }
-    read_page_offset_1 += read_page1;
 
-    // Intially read in a buffer size worth of data from second SSTs
-    ssize_t read_page2 = pread(fd2, read_buffer_2, PAGE_SIZE, read_page_offset_2);
-    if (read_page2 < 0)
+    // Dynamically allocate memory for the result array
+    std::pair<long, long> *arr_values = new std::pair<long, long>[key_value_pairs.size()];
+    std::copy(key_value_pairs.begin(), key_value_pairs.end(), arr_values);
+
+    return {arr_values, static_cast<int>(key_value_pairs.size())};
+}
+
+/*
+    Returns the result of get on the lsm tree.
+*/
+NodeFileOffset *LSMTree::get(long key, BufferPool *buffer_pool, bool with_btree, uint64_t snapshot)
+{
+    // A get at a snapshot that is not live finds nothing
+    std::shared_ptr<const LSMVersion> version;
+    if (snapshot != LATEST_SEQUENCE && (version = findSnapshot(snapshot)) == nullptr)
     {
-        std::cerr << "Error: Failed to read page in SST file " << sst2.sst_filename << std::endl;
-        freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-        return {"", ""};
+        return nullptr;
     }
-    read_page_offset_2 += read_page2;
 
-    long *long_buffer_1 = static_cast<long *>(read_buffer_1);
-    long *long_buffer_2 = static_cast<long *>(read_buffer_2);
+    // Report the latency of every get to the rate limiter so that it can tune the compaction budget
+    RateLimiter *curr_rate_limiter = rate_limiter;
+    if (curr_rate_limiter != nullptr)
+    {
+        auto start_time = std::chrono::steady_clock::now();
+        NodeFileOffset *result = getFromRowCache(key, buffer_pool, with_btree, version, snapshot);
+        std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start_time;
+        curr_rate_limiter->recordForegroundLatency(latency.count());
+        return result;
+    }
+    return getFromRowCache(key, buffer_pool, with_btree, version, snapshot);
+}
 
-    // Calculate the number of long values
-    size_t num_longs = buffer_size / sizeof(long);
+/*
+    Returns the cached result of a get of the key if the row cache holds it.
+    Otherwise searches the tree and caches the result (whether the key was
+    found, deleted, or absent). A get at a snapshot skips the row cache, which
+    only holds the newest results.
+*/
+NodeFileOffset *LSMTree::getFromRowCache(long key, BufferPool *buffer_pool, bool with_btree, std::shared_ptr<const LSMVersion> version, uint64_t snapshot)
+{
+    RowCache *curr_row_cache = row_cache;
+    if (curr_row_cache == nullptr || snapshot != LATEST_SEQUENCE)
+    {
+        return getFromTree(key, buffer_pool, with_btree, version, snapshot);
+    }
 
-    int buffer_1_Index = 0;
-    int buffer_2_Index = 0;
+    long value;
+    bool is_found;
+    uint64_t generation;
+    if (curr_row_cache->lookup(key, value, is_found, generation))
+    {
+        return is_found ? new NodeFileOffset(new Node(key, value), "", -1) : nullptr;
+    }
+    NodeFileOffset *result = getFromTree(key, buffer_pool, with_btree, nullptr, LATEST_SEQUENCE);
+    curr_row_cache->insert(key, result != nullptr ? result->node->value : 0, result != nullptr, generation);
+    return result;
+}
 
-    // Variables to create the B-Tree and write it to disk
-    StaticBTree btree(new_sst_filename, new_btree_filename);
-    size_t btree_write_offset = 0;
+/*
+    Searches the memtables and then every level of the LSM tree for the key,
+    in the given version (nullptr for the one that is current when the search
+    starts) as of the given snapshot: the memtables and SSTs that only hold
+    newer writes are skipped. A key found in a memtable is returned as a copy
+    of its Node, since the memtable may change (or be freed) once the search
+    is done.
+*/
+NodeFileOffset *LSMTree::getFromTree(long key, BufferPool *buffer_pool, bool with_btree, std::shared_ptr<const LSMVersion> version, uint64_t snapshot)
+{
+    if (version == nullptr)
+    {
+        version = std::atomic_load(&current_version);
+    }
+    const std::vector<std::vector<SST>> &levels = version->levels;
 
-    // Variables to create the B-Tree
-    int leaf_node_pairs_written = 0;
-    long curr_page = 0;
-    long final_key_added;
-    int leaf_nodes_written = 0;
+    // First, check the memtable for the key (it only holds writes newer than every live snapshot, see getSnapshot)
+    if (snapshot == LATEST_SEQUENCE)
+    {
+        std::shared_lock<std::shared_mutex> memtable_lock(memtable_mutex);
+        Node *result = version->memtable->get(key);
+        if (result != nullptr)
+        {
+            return new NodeFileOffset(new Node(key, result->value), "", -1); // Return from memtable if found
+        }
+        // If a range tombstone of the memtable covers the key, then it was deleted
+        if (version->memtable->getRangeTombstones().covers(key))
+        {
+            return new NodeFileOffset(new Node(key, LONG_MIN), "", -1);
+        }
+    }
 
-    // Initialize Bloom filter
-    size_t bloom_size = 2400; // Example size
-    int num_hashes = 3;       // Number of hash functions
-    BloomFilter bloom_filter(bloom_size, num_hashes);
+    // Then the frozen memtables, newest first (they take no more writes, so they are read without a lock)
+    for (auto frozen = version->frozen_memtables.rbegin(); frozen != version->frozen_memtables.rend(); ++frozen)
+    {
+        if (frozen->max_sequence > snapshot)
+        {
+            continue;
+        }
+        Node *result = frozen->memtable->get(key);
+        if (result != nullptr)
+        {
+            return new NodeFileOffset(new Node(key, result->value), "", -1);
+        }
+        if (frozen->memtable->getRangeTombstones().covers(key))
+        {
+            return new NodeFileOffset(new Node(key, LONG_MIN), "", -1);
+        }
+    }
 
-    // Run main while loop which will continually read data from both SSTS
-    while (true)
+    // Iterate through each level in the LSM tree
+    for (int level_idx = 0; level_idx < static_cast<int>(levels.size()); ++level_idx)
     {
-        long key1 = long_buffer_1[buffer_1_Index];
-        long key2 = long_buffer_2[buffer_2_Index];
+        const std::vector<SST> &level = levels[level_idx];
 
-        // If both of the next data is valid then check which key to put in first
-        if (key1 >= 0 && key2 >= 0)
+        // Search the newest SST of the level first
+        for (int i = level.size() - 1; i >= 0; --i)
         {
-            // If key2 is greater than add key1 and value1 first
-            if (key1 < key2)
+            // Skip the SST if the key is outside of its key range, or if it only holds writes newer than the snapshot
+            if (!level[i].metadata.overlaps(key, key) || level[i].max_sequence > snapshot)
             {
-                long value1 = long_buffer_1[buffer_1_Index + 1];
-                // Make sure to check tombstones if its the last level
-                if (!(last_level && (value1 == LONG_MIN)))
-                {
+                continue;
+            }
 
-                    std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &key1, sizeof(key1));
-                    sst_write_page_offset += sizeof(key1);
-                    std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &value1, sizeof(value1));
-                    sst_write_page_offset += sizeof(value1);
-                    bloom_filter.put(std::to_string(key1));
+            std::string sst_filename = level[i].sst_filename; // Filter file associated with the SST
+            std::string btree_filename = level[i].btree_filename;
 
-                    // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
-                    leaf_node_pairs_written++;
-                    final_key_added = key1;
+            // A corrupted Bloom filter lets every key through
+            BloomFilter bloom_filter(BLOOM_FILTER_NUM_BITS, BLOOM_FILTER_NUM_HASHES); // Match the size and hash functions used during creation
+            bool is_bloom_intact = loadBloomFilter(level[i], bloom_filter, buffer_pool);
+            // std::cerr << "Checking Bloom filter for key: " << key << std::endl;
 
-                    // When a Leaf Node is full, i.e., when leaf_node_pairs_written is equal to MAX_PAIRS, add the most recently added key (the max key in the Leaf Node) to max_keys_in_leaves and reset both leaf_node_pairs_written and write_leaf_node
-                    if (leaf_node_pairs_written == MAX_PAIRS)
-                    {
-                        curr_page++;
-                        btree.insertInternalNode(key1, curr_page);
-                        leaf_node_pairs_written = 0;
-                        leaf_nodes_written++;
-                    }
+            if (is_bloom_intact && !bloom_filter.mightContain(std::to_string(key)))
+            {
+                // The key is not in this SST, move on to the next one
+            }
+            // std::cerr << "Key might be in SST: " << sstFileName << std::endl;
+            // With the learned index, the B-Tree descent is replaced by a prediction of the key's position and (usually) a single page read
+            else if (with_btree && use_learned_index)
+            {
+                std::shared_ptr<MappedFile> sst_map = read_mode == ReadMode::MMAP ? getMappedFile(sst_filename, AccessPattern::RANDOM) : nullptr;
+                NodeFileOffset *ret = learnedIndexSearch(sst_filename, level[i].metadata, key, buffer_pool, sst_map.get());
+                if (ret != nullptr)
+                {
+                    return ret;
                 }
-                buffer_1_Index += 2;
             }
-            // If they are equal then we must take the newer one but still advance both
-            // In this case the data in buffer2 is newer thus we take from buffer2
-            else if (key1 == key2)
+            // With fence pointers, the B-Tree descent is replaced by a search of the fence keys in memory and a single page read
+            else if (with_btree && use_fence_pointers)
             {
-                long value2 = long_buffer_2[buffer_2_Index + 1];
-                // Make sure to check tombstones if its the last level
-                if (!(last_level && (value2 == LONG_MIN)))
+                std::shared_ptr<MappedFile> sst_map = read_mode == ReadMode::MMAP ? getMappedFile(sst_filename, AccessPattern::RANDOM) : nullptr;
+                NodeFileOffset *ret = fencePointerSearch(sst_filename, level[i].metadata, key, buffer_pool, sst_map.get());
+                if (ret != nullptr)
                 {
-
-                    std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &key2, sizeof(key2));
-                    sst_write_page_offset += sizeof(key2);
-                    std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &value2, sizeof(value2));
-                    sst_write_page_offset += sizeof(value2);
-                    bloom_filter.put(std::to_string(key2));
-
-                    // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
-                    leaf_node_pairs_written++;
-                    final_key_added = key2;
-
-                    // When a Leaf Node is full, i.e., when leaf_node_pairs_written is equal to MAX_PAIRS, add the most recently added key (the max key in the Leaf Node) to max_keys_in_leaves and reset both leaf_node_pairs_written and write_leaf_node
-                    if (leaf_node_pairs_written == MAX_PAIRS)
-                    {
-                        curr_page++;
-                        btree.insertInternalNode(key2, curr_page);
-                        leaf_node_pairs_written = 0;
-                        leaf_nodes_written++;
-                    }
+                    return ret;
                 }
-                buffer_1_Index += 2;
-                buffer_2_Index += 2;
             }
-            // If key1 is greater than add key2 and value2 first
-            else
+            else if (read_mode == ReadMode::MMAP)
             {
-                long value2 = long_buffer_2[buffer_2_Index + 1];
-                // Make sure to check tombstones if its the last level
-                if (!(last_level && (value2 == LONG_MIN)))
+                std::shared_ptr<MappedFile> sst_map = getMappedFile(sst_filename, AccessPattern::RANDOM);
+                if (with_btree)
                 {
-
-                    std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &key2, sizeof(key2));
-                    sst_write_page_offset += sizeof(key2);
-                    std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &value2, sizeof(value2));
-                    sst_write_page_offset += sizeof(value2);
-                    bloom_filter.put(std::to_string(key2));
-
-                    // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
-                    leaf_node_pairs_written++;
-                    final_key_added = key2;
-
-                    // When a Leaf Node is full, i.e., when leaf_node_pairs_written is equal to MAX_PAIRS, add the most recently added key (the max key in the Leaf Node) to max_keys_in_leaves and reset both leaf_node_pairs_written and write_leaf_node
-                    if (leaf_node_pairs_written == MAX_PAIRS)
+                    std::shared_ptr<MappedFile> btree_map = getMappedFile(btree_filename, AccessPattern::RANDOM);
+                    StaticBTree btree(sst_filename, btree_filename, sst_map.get(), btree_map.get());
+                    btree.setIndexBlock(level[i].metadata.footer);
+                    long value = btree.get(key);
+                    if (value != -1)
+                    {
+                        return new NodeFileOffset(new Node(key, value), btree_filename, 0);
+                    }
+                }
+                else
+                {
+                    NodeFileOffset *ret = sst_search_mode == SSTSearchMode::INTERPOLATION ? interpolationSearch(sst_filename, level[i].metadata, key, buffer_pool, sst_map.get())
+                                                                                           : binarySearch(sst_filename, key, buffer_pool, sst_map.get(), &level[i].metadata.footer);
+                    if (ret != nullptr)
                     {
-                        curr_page++;
-                        btree.insertInternalNode(key2, curr_page);
-                        leaf_node_pairs_written = 0;
-                        leaf_nodes_written++;
+                        return ret;
                     }
                 }
-                buffer_2_Index += 2;
             }
-        }
-        // If write buffer is full then write it to file and then clear the buffer
-        if (sst_write_page_offset + ENTRY_SIZE > buffer_size)
-        {
-            ssize_t bytes_written = pwrite(fd3, write_buffer_SST, buffer_size, sst_write_offset);
-            if (bytes_written != buffer_size)
+            else if (with_btree)
             {
-                perror("pwrite failed");
-                std::cerr << "Error: Incomplete write for key-value pairs batch." << std::endl;
-                freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                return {"", ""};
-            }
-            sst_write_offset += bytes_written;
-            sst_write_page_offset = 0;                               // Reset the buffer for the next batch
-            std::memset(write_buffer_SST, INTERNAL, buffer_size); // Clear the buffer
-        }
-        // If buffer2 is done reading its page or there is no valid data left, then try to read in the next page
-        if (key2 < 0 || buffer_2_Index >= num_longs)
-        {
-            read_page2 = pread(fd2, read_buffer_2, PAGE_SIZE, read_page_offset_2);
-            if (read_page2 < 0)
+                StaticBTree btree(sst_filename, btree_filename);
+                btree.setIndexBlock(level[i].metadata.footer);
+                long value = btree.get(key, buffer_pool);
+                // If value is found then break out of the look
+                if (value != -1)
+                {
+                    return new NodeFileOffset(new Node(key, value), btree_filename, 0);
+                }
+            }
+            else
             {
-                std::cerr << "Error: Failed to read page in SST file " << sst2.sst_filename << std::endl;
-                freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                return {"", ""};
+                NodeFileOffset *ret = sst_search_mode == SSTSearchMode::INTERPOLATION ? interpolationSearch(sst_filename, level[i].metadata, key, buffer_pool)
+                                                                                       : binarySearch(sst_filename, key, buffer_pool, nullptr, &level[i].metadata.footer);
+                if (ret != nullptr)
+                {
+                    return ret;
+                }
             }
-            // If there is no more pages to read from 2nd SST, then we finish reading the rest of 1st SST.
-            if (read_page2 == 0)
+
+            // The key-value pairs of an SST are newer than its range tombstones, so only check them when the key is not in the SST
+            if (level[i].metadata.range_tombstones.covers(key))
             {
-                // If there is no more data in sst2, write the rest of the data in sst1.
-                while (true)
+                return new NodeFileOffset(new Node(key, LONG_MIN), sst_filename, -1);
+            }
+        }
+    }
+
+    return nullptr; // Key not found
+}
+
+/*
+    Sets the RateLimiter shared by flushes and compactions (nullptr disables rate limiting).
+*/
+void LSMTree::setRateLimiter(RateLimiter *new_rate_limiter)
+{
+    rate_limiter = new_rate_limiter;
+}
+
+// Implementation of the getRateLimiter function.
+RateLimiter *LSMTree::getRateLimiter()
+{
+    return rate_limiter;
+}
+
+/*
+    Sets the row cache checked by get before the memtable and the levels (or
+    nullptr for none). The cache is cleared, since it may hold the results of
+    another tree; a cache must not be shared by several trees.
+*/
+void LSMTree::setRowCache(RowCache *new_row_cache)
+{
+    row_cache = new_row_cache;
+    if (new_row_cache != nullptr)
+    {
+        new_row_cache->clear();
+    }
+}
+
+// Implementation of the getRowCache function.
+RowCache *LSMTree::getRowCache()
+{
+    return row_cache;
+}
+
+/*
+    Sets how get and scan read the pages of the SSTs. In MMAP mode every SST,
+    B-Tree and Bloom filter file is mapped the first time it is read and its
+    pages are then read in place, which suits datasets that fit in memory.
+    Switching back to BUFFER_POOL unmaps every file once the reads that are
+    still using its mapping are done.
+*/
+void LSMTree::setReadMode(ReadMode new_read_mode)
+{
+    read_mode = new_read_mode;
+    if (new_read_mode == ReadMode::BUFFER_POOL)
+    {
+        file_reclaimer->unmapAll();
+    }
+}
+
+// Implementation of the getReadMode function.
+ReadMode LSMTree::getReadMode()
+{
+    return read_mode;
+}
+
+/*
+    Sets whether gets that use the B-Tree search the in-memory fence pointers
+    of each SST instead of descending its B-Tree file.
+*/
+void LSMTree::setFencePointers(bool enabled)
+{
+    use_fence_pointers = enabled;
+}
+
+/*
+    Returns the number of bytes of memory used by the fence pointers of every
+    SST of the current version.
+*/
+size_t LSMTree::getFencePointerMemory()
+{
+    std::shared_ptr<const LSMVersion> version = std::atomic_load(&current_version);
+    size_t total_bytes = 0;
+    for (const std::vector<SST> &level : version->levels)
+    {
+        for (const SST &sst : level)
+        {
+            total_bytes += sst.metadata.fenceMemoryBytes();
+        }
+    }
+    return total_bytes;
+}
+
+/*
+    Sets whether gets that use the B-Tree search the in-memory learned index of
+    each SST instead of descending its B-Tree file. The learned index takes
+    precedence over the fence pointers.
+*/
+void LSMTree::setLearnedIndex(bool enabled)
+{
+    use_learned_index = enabled;
+}
+
+/*
+    Returns the number of bytes of memory used by the learned indexes of every
+    SST of the current version.
+*/
+size_t LSMTree::getLearnedIndexMemory()
+{
+    std::shared_ptr<const LSMVersion> version = std::atomic_load(&current_version);
+    size_t total_bytes = 0;
+    for (const std::vector<SST> &level : version->levels)
+    {
+        for (const SST &sst : level)
+        {
+            total_bytes += sst.metadata.learnedMemoryBytes();
+        }
+    }
+    return total_bytes;
+}
+
+/*
+    Sets how gets that do not use the B-Tree search the pages of each SST.
+*/
+void LSMTree::setSSTSearchMode(SSTSearchMode new_sst_search_mode)
+{
+    sst_search_mode = new_sst_search_mode;
+}
+
+// Implementation of the getSSTSearchMode function.
+SSTSearchMode LSMTree::getSSTSearchMode()
+{
+    return sst_search_mode;
+}
+
+/*
+    Sets how the data pages of the SSTs written from now on (by flushes,
+    compactions and bulk loads) are encoded. Existing SSTs keep their encoding,
+    which is read from their footers.
+*/
+void LSMTree::setPageEncoding(PageEncoding new_page_encoding)
+{
+    page_encoding = new_page_encoding;
+}
+
+// Implementation of the getPageEncoding function.
+PageEncoding LSMTree::getPageEncoding()
+{
+    return page_encoding;
+}
+
+/*
+    Sets how the data pages of the SSTs written from now on into the given level
+    (by flushes for level 0, compactions and bulk loads for the last level) are
+    compressed, so that the large, cold deeper levels can use a stronger codec
+    than the levels that are rewritten often. Existing SSTs keep their
+    compression, which is read from their footers. Returns false if the level
+    does not exist or the codec was not built in.
+*/
+bool LSMTree::setLevelCompression(int level, CompressionType compression)
+{
+    if (level < 0 || level >= max_level || !isCompressionSupported(compression))
+    {
+        return false;
+    }
+    level_compression[level] = compression;
+    return true;
+}
+
+// Implementation of the getLevelCompression function.
+CompressionType LSMTree::getLevelCompression(int level)
+{
+    return level >= 0 && level < max_level ? level_compression[level] : CompressionType::NONE;
+}
+
+/*
+    Sets the size of the data pages of the SSTs that flushes (if first_level is
+    0), compactions into the levels from first_level on and bulk loads write
+    from now on, so the large deeper levels can read more key-value pairs per
+    I/O and index fewer pages. The SSTs already written keep their pages (every
+    SST records its page size), and packed, columnar or compressed SSTs keep
+    PAGE_SIZE pages. Returns false if the page size is not valid.
+*/
+bool LSMTree::setPageSize(size_t new_page_size, int first_level)
+{
+    if (!isValidPageSize(new_page_size) || first_level < 0)
+    {
+        std::cerr << "Error: The page size must be a power of two between " << PAGE_SIZE << " and " << MAX_PAGE_SIZE << " bytes." << std::endl;
+        return false;
+    }
+    page_size = new_page_size;
+    first_page_level = first_level;
+    return true;
+}
+
+// Implementation of the getPageSize function.
+size_t LSMTree::getPageSize(int level)
+{
+    return level >= first_page_level ? page_size : PAGE_SIZE;
+}
+
+/*
+    Changes the memtable of the current LSMTree (a write of its own, which
+    takes the next sequence number). The frozen memtables are kept.
+*/
+Memtable *LSMTree::changeMemtable(Memtable *new_memtable)
+{
+    WriteLock write_lock(*this, true);
+    last_sequence++;
+    if (new_memtable == nullptr)
+    {
+        // Clean up the old memtable once no reader can see it
+        retired_memtables.push_back(this->memtable);
+
+        // Assign the new memtable
+        this->memtable = new Memtable(memtable_size);
+        memtable_min_sequence = last_sequence + 1;
+
+        return this->memtable;
+    }
+    else
+    {
+        // Assign the new memtable (whose keys the row cache knows nothing about)
+        this->memtable = new_memtable;
+        memtable_min_sequence = last_sequence + 1;
+        installVersion();
+        RowCache *curr_row_cache = row_cache;
+        if (curr_row_cache != nullptr)
+        {
+            curr_row_cache->clear();
+        }
+
+        return this->memtable;
+    }
+}
+
+// Implementation of the getMemtable function.
+Memtable *LSMTree::getMemtable()
+{
+    return this->memtable;
+}
+
+/*
+    Compacts the levels in the LSMTree. The SSTs of a full level that overlap
+    nothing in their level or below are moved to the next level without being
+    rewritten (they stay where they are on the last level). The other SSTs of
+    each stripe (see getStripe) are merged in one pass into a new sorted run
+    (see mergeSSTs), though a stripe of a single sorted run is left as it is
+    while there are other stripes. A level is full once it holds
+    level_size_ratio sorted runs.
+*/
+void LSMTree::compactLevels()
+{
+    WriteLock write_lock(*this, true);
+    for (int level_idx = 0; level_idx < static_cast<int>(levels.size()); ++level_idx)
+    {
+        bool is_last_level = (max_level - 1) == level_idx;
+        if (countRuns(level_idx) >= level_size_ratio)
+        {
+            // Split the level into the SSTs that can be moved as they are and the SSTs that must be merged
+            std::vector<SST> level;
+            std::vector<SST> moved_ssts;
+            for (size_t i = 0; i < levels[level_idx].size(); ++i)
+            {
+                if (isTrivialMove(level_idx, i))
                 {
-                    key1 = long_buffer_1[buffer_1_Index];
-                    if (key1 >= 0)
-                    {
-                        long value1 = long_buffer_1[buffer_1_Index + 1];
-                        if (!(last_level && (value1 == LONG_MIN)))
-                        {
+                    moved_ssts.push_back(levels[level_idx][i]);
+                }
+                else
+                {
+                    level.push_back(levels[level_idx][i]);
+                }
+            }
+            levels[level_idx].clear();
 
-                            std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &key1, sizeof(key1));
-                            sst_write_page_offset += sizeof(key1);
-                            std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &value1, sizeof(value1));
-                            sst_write_page_offset += sizeof(value1);
-                            bloom_filter.put(std::to_string(key1));
+            for (SST &moved_sst : moved_ssts)
+            {
+                if (is_last_level)
+                {
+                    levels[level_idx].push_back(moved_sst);
+                }
+                else
+                {
+                    moved_sst.level = level_idx + 1;
+                    levels[level_idx + 1].push_back(moved_sst);
+                }
+            }
+            if (level.empty())
+            {
+                continue;
+            }
 
-                            // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
-                            leaf_node_pairs_written++;
-                            final_key_added = key1;
+            // Split the SSTs by stripe, from the oldest stripe to the newest
+            std::map<uint64_t, std::vector<SST>> stripes;
+            for (const SST &sst : level)
+            {
+                stripes[getStripe(sst.max_sequence)].push_back(sst);
+            }
 
-                            // When a Leaf Node is full, i.e., when leaf_node_pairs_written is equal to MAX_PAIRS, add the most recently added key (the max key in the Leaf Node) to max_keys_in_leaves and reset both leaf_node_pairs_written and write_leaf_node
-                            if (leaf_node_pairs_written == MAX_PAIRS)
-                            {
-                                curr_page++;
-                                btree.insertInternalNode(key1, curr_page);
-                                leaf_node_pairs_written = 0;
-                                leaf_nodes_written++;
-                            }
-                        }
-                        // std::cerr << long_buffer_1[buffer_1_Index] << ", " << long_buffer_1[buffer_1_Index + 1] << std::endl;
-                        buffer_1_Index += 2;
-                    }
+            std::vector<SST> merged_ssts;
+            std::vector<SST> written_ssts;
+            std::vector<SST> merged_inputs;
+            for (const std::pair<const uint64_t, std::vector<SST>> &stripe : stripes)
+            {
+                std::set<long> runs;
+                for (const SST &sst : stripe.second)
+                {
+                    runs.insert(sst.run);
+                }
+                if (runs.size() == 1 && stripes.size() > 1)
+                {
+                    merged_ssts.insert(merged_ssts.end(), stripe.second.begin(), stripe.second.end());
+                    continue;
+                }
 
-                    if (key1 < 0 || buffer_1_Index >= num_longs)
+                // Keep the inputs if a merge failed (for example on a page that does not match its checksum)
+                std::vector<SST> stripe_ssts;
+                if (!this->mergeSSTs(stripe.second, is_last_level, is_last_level ? level_idx : level_idx + 1, stripe_ssts))
+                {
+                    for (const SST &written_sst : written_ssts)
                     {
-                        read_page1 = pread(fd1, read_buffer_1, PAGE_SIZE, read_page_offset_1);
-                        if (read_page1 < 0)
-                        {
-                            std::cerr << "Error: Failed to read page in SST file " << sst1.sst_filename << std::endl;
-                            freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                            return {"", ""};
-                        }
-                        // If we finished reading from sst2 then break as there is no more data left
-                        if (read_page1 == 0)
-                        {
-                            break;
-                        }
-                        read_page_offset_1 += read_page1;
-                        buffer_1_Index = 0;
-                    }
-                    if (sst_write_page_offset + ENTRY_SIZE > buffer_size)
-                    {
-                        ssize_t bytes_written = pwrite(fd3, write_buffer_SST, buffer_size, sst_write_offset);
-                        if (bytes_written != buffer_size)
-                        {
-                            perror("pwrite failed");
-                            std::cerr << "Error: Incomplete write for key-value pairs batch." << std::endl;
-                            freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                            return {"", ""};
-                        }
-                        sst_write_offset += bytes_written;
-                        sst_write_page_offset = 0;                               // Reset the buffer for the next batch
-                        std::memset(write_buffer_SST, INTERNAL, buffer_size); // Clear the buffer
+                        deleteSSTFiles(written_sst);
                     }
+                    levels[level_idx].insert(levels[level_idx].begin(), level.begin(), level.end());
+                    return;
                 }
-                break;
+                merged_ssts.insert(merged_ssts.end(), stripe_ssts.begin(), stripe_ssts.end());
+                written_ssts.insert(written_ssts.end(), stripe_ssts.begin(), stripe_ssts.end());
+                merged_inputs.insert(merged_inputs.end(), stripe.second.begin(), stripe.second.end());
+            }
+            for (const SST &sst : merged_inputs)
+            {
+                removeSSTFiles(sst);
+            }
+
+            // If the runs have less than p^(level + 1) entries, then they stay on the same level, otherwise they go to the next level
+            // (as do level_size_ratio stripes, which would leave the level full)
+            size_t current_level_max_size = pow(level_size_ratio, level_idx + 1) * memtable_size;
+            int target_level = (getLevelBytes(merged_ssts) <= static_cast<off_t>(current_level_max_size) && stripes.size() < level_size_ratio) || is_last_level ? level_idx : level_idx + 1;
+            for (SST &merged_sst : merged_ssts)
+            {
+                merged_sst.level = target_level;
+                merged_sst.level_index = levels[target_level].size();
+                levels[target_level].push_back(merged_sst);
             }
-            read_page_offset_2 += read_page2;
-            buffer_2_Index = 0;
         }
-        // If buffer1 is done reading its page or there is no valid data left, then try to read in the next page
-        if (key1 < 0 || buffer_1_Index >= num_longs)
+    }
+}
+
+/*
+    Compacts every SST where at least TOMBSTONE_COMPACTION_RATIO of the entries
+    are tombstones, so that deletes stop being scanned over in the upper levels:
+        - If no older SST overlaps its key range, then none of its tombstones hide
+          anything and the SST is rewritten without them.
+        - Otherwise, if SSTs of the next level overlap it, then it is merged with
+          them (and with the SSTs of the next level overlapping those, so that
+          none of the SSTs left in the next level overlap the merged ones),
+          dropping every tombstone with no older value below that level. The
+          other SSTs of the next level are left as they are. The SST is left
+          where it is if they are not all of its stripe (see getStripe).
+        - Otherwise, if nothing in the next level overlaps it, then it is moved
+          into the next level (without rewriting it) and considered again from
+          there.
+    An SST is only pushed down when no older SST in its own level overlaps it,
+    as it would otherwise end up below the older values its tombstones hide.
+*/
+void LSMTree::compactTombstones()
+{
+    WriteLock write_lock(*this, true);
+    for (int level_idx = 0; level_idx < static_cast<int>(levels.size()); ++level_idx)
+    {
+        bool is_last_level = (max_level - 1) == level_idx;
+        size_t i = 0;
+        while (i < levels[level_idx].size())
         {
-            read_page1 = pread(fd1, read_buffer_1, PAGE_SIZE, read_page_offset_1);
-            if (read_page1 < 0)
+            SST sst = levels[level_idx][i];
+            if (sst.metadata.num_tombstones == 0 || sst.metadata.tombstoneRatio() < TOMBSTONE_COMPACTION_RATIO)
             {
-                std::cerr << "Error: Failed to read page in SST file " << sst1.sst_filename << std::endl;
-                freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                return {"", ""};
+                i++;
+                continue;
+            }
+
+            bool older_siblings_overlap = olderSiblingsOverlap(level_idx, i);
+            if (!older_siblings_overlap && !levelsOverlap(sst.metadata.min_key, sst.metadata.max_key, level_idx + 1))
+            {
+                if (!rewriteSST(levels[level_idx][i]))
+                {
+                    return;
+                }
+                // Remove the SST if it only held tombstones
+                if (levels[level_idx][i].metadata.empty())
+                {
+                    removeSSTFiles(levels[level_idx][i]);
+                    levels[level_idx].erase(levels[level_idx].begin() + i);
+                    continue;
+                }
             }
-            if (read_page1 == 0)
+            else if (!older_siblings_overlap && !is_last_level)
             {
-                // If there is no more data in sst1, write the rest of the data in sst2.
-                while (true)
+                levels[level_idx].erase(levels[level_idx].begin() + i);
+
+                // Select the (older) SSTs of the next level that overlap the SST, or overlap an SST already selected
+                std::vector<SST> &next_level = levels[level_idx + 1];
+                bool is_next_last_level = (max_level - 1) == level_idx + 1;
+                std::vector<bool> is_input(next_level.size(), false);
+                long min_key = sst.metadata.min_key;
+                long max_key = sst.metadata.max_key;
+                bool is_growing = true;
+                while (is_growing)
                 {
-                    key2 = long_buffer_2[buffer_2_Index];
-                    if (key2 >= 0)
+                    is_growing = false;
+                    for (size_t j = 0; j < next_level.size(); ++j)
                     {
-                        long value2 = long_buffer_2[buffer_2_Index + 1];
-                        if (!(last_level && (value2 == LONG_MIN)))
+                        if (!is_input[j] && next_level[j].metadata.overlaps(min_key, max_key))
                         {
-
-                            std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &key2, sizeof(key2));
-                            sst_write_page_offset += sizeof(key2);
-                            std::memcpy(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, &value2, sizeof(value2));
-                            sst_write_page_offset += sizeof(value2);
-                            bloom_filter.put(std::to_string(key2));
-
-                            // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
-                            leaf_node_pairs_written++;
-                            final_key_added = key2;
-
-                            // When a Leaf Node is full, i.e., when leaf_node_pairs_written is equal to MAX_PAIRS, add the most recently added key (the max key in the Leaf Node) to max_keys_in_leaves and reset both leaf_node_pairs_written and write_leaf_node
-                            if (leaf_node_pairs_written == MAX_PAIRS)
-                            {
-                                curr_page++;
-                                btree.insertInternalNode(key2, curr_page);
-                                leaf_node_pairs_written = 0;
-                                leaf_nodes_written++;
-                            }
+                            is_input[j] = true;
+                            min_key = std::min(min_key, next_level[j].metadata.min_key);
+                            max_key = std::max(max_key, next_level[j].metadata.max_key);
+                            is_growing = true;
                         }
-                        buffer_2_Index += 2;
                     }
+                }
+                std::vector<SST> inputs;
+                std::vector<SST> kept_ssts;
+                for (size_t j = 0; j < next_level.size(); ++j)
+                {
+                    (is_input[j] ? inputs : kept_ssts).push_back(next_level[j]);
+                }
 
-                    if (key2 < 0 || buffer_2_Index >= num_longs)
+                // Versions on both sides of a live snapshot are never merged, so the SST then waits for the snapshot to be released
+                bool is_one_stripe = true;
+                for (const SST &input : inputs)
+                {
+                    is_one_stripe = is_one_stripe && getStripe(input.max_sequence) == getStripe(sst.max_sequence);
+                }
+                if (!is_one_stripe)
+                {
+                    levels[level_idx].insert(levels[level_idx].begin() + i, sst);
+                    i++;
+                    continue;
+                }
+
+                // Merge the SST with the selected SSTs only
+                if (!inputs.empty())
+                {
+                    inputs.push_back(sst);
+                    std::vector<SST> merged_ssts;
+                    if (!this->mergeSSTs(inputs, is_next_last_level, level_idx + 1, merged_ssts))
                     {
-                        read_page2 = pread(fd2, read_buffer_2, PAGE_SIZE, read_page_offset_2);
-                        if (read_page2 < 0)
-                        {
-                            std::cerr << "Error: Failed to read page in SST file " << sst2.sst_filename << std::endl;
-                            freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                            return {"", ""};
-                        }
-                        // If we finished reading from sst2 then break as there is no more data left
-                        if (read_page2 == 0)
-                        {
-                            break;
-                        }
-                        read_page_offset_2 += read_page2;
-                        buffer_1_Index = 0;
+                        levels[level_idx].insert(levels[level_idx].begin() + i, sst);
+                        return;
+                    }
+                    for (const SST &input : inputs)
+                    {
+                        removeSSTFiles(input);
+                    }
+                    next_level = kept_ssts;
+                    for (SST &merged_sst : merged_ssts)
+                    {
+                        merged_sst.level_index = next_level.size();
+                        next_level.push_back(merged_sst);
                     }
+                    continue;
+                }
+
+                sst.level = level_idx + 1;
+                sst.level_index = next_level.size();
+                if (!sst.metadata.empty())
+                {
+                    next_level.push_back(sst);
+                }
+                else
+                {
+                    removeSSTFiles(sst);
+                }
+                continue;
+            }
+            i++;
+        }
+    }
+}
+
+/*
+    Rewrites the given SST without any of its tombstones or range tombstones. The caller must make
+    sure that no older SST overlaps its key range. Returns false on failure.
+*/
+bool LSMTree::rewriteSST(SST &sst)
+{
+    SSTIterator iterator(sst.sst_filename);
+    if (!iterator.isOpen())
+    {
+        return false;
+    }
+
+    std::string string_time_now = getCurrentTimestamp();
+    std::string new_sst_filename = DATA_FILE_PATH + database_name + "/sst_" + string_time_now + ".bin";
+
+    IOPriority priority = sst.level == 0 ? IOPriority::MEDIUM : IOPriority::LOW;
+    SSTWriter writer(new_sst_filename, rate_limiter, priority, DEFAULT_INDEX_LAYOUT, page_encoding, level_compression[sst.level], getPageSize(sst.level));
+    if (!writer.isOpen())
+    {
+        return false;
+    }
+
+    while (iterator.valid())
+    {
+        if (iterator.value() != LONG_MIN && !writer.put(iterator.key(), iterator.value()))
+        {
+            return false;
+        }
+        iterator.next();
+    }
+
+    if (iterator.hasError() || !writer.finish())
+    {
+        return false;
+    }
+
+    removeSSTFiles(sst);
+    sst.sst_filename = new_sst_filename;
+    sst.btree_filename = new_sst_filename;
+    sst.metadata = writer.getMetadata();
+    return true;
+}
+
+/*
+    Removes the given SST from disk once no version that a reader may hold
+    contains it: its files are deleted when the version that is current at
+    the next install is freed.
+*/
+void LSMTree::removeSSTFiles(const SST &sst)
+{
+    retired_ssts.push_back(sst);
+}
+
+// Implementation of the deleteSSTFiles function (for SSTs that were never part of a version).
+void LSMTree::deleteSSTFiles(const SST &sst)
+{
+    file_reclaimer->deleteSSTFiles(sst);
+}
+
+/*
+    Loads the Bloom filter of the given SST from its mapping, the buffer pool or
+    the disk (adding it to the buffer pool). A single-file SST keeps it in its
+    filter block, which takes several pages when the filter was sized for a
+    large SST (see SSTWriter::sizeFilter), otherwise it is the SST's bloom_
+    file. Returns false if the Bloom filter does not match its checksum, in
+    which case it must not be used.
+*/
+bool LSMTree::loadBloomFilter(const SST &sst, BloomFilter &bloom_filter, BufferPool *buffer_pool)
+{
+    const size_t bloom_size_bytes = BLOOM_FILTER_NUM_BITS / 8;
+    const SSTFooter &footer = sst.metadata.footer;
+    std::shared_ptr<MappedFile> bloom_map;
+    Page *bloom_page = nullptr;
+
+    if (footer.isSingleFile())
+    {
+        // The filter block is padded to a page, and each of its pages is checksummed as a whole
+        long filter_page = footer.filter_offset / PAGE_SIZE;
+        size_t filter_pages = (footer.filter_size + PAGE_SIZE - 1) / PAGE_SIZE;
+        bloom_filter = BloomFilter(footer.filter_size * 8, BLOOM_FILTER_NUM_HASHES);
+        if (read_mode == ReadMode::MMAP && (bloom_map = getMappedFile(sst.sst_filename, AccessPattern::RANDOM))->getSize() >= footer.filter_offset + filter_pages * PAGE_SIZE)
+        {
+            const char *filter_data = bloom_map->getData() + footer.filter_offset;
+            bloom_filter.loadBitArrayFromBuffer(filter_data, footer.filter_size);
+            return isPageIntact(sst.sst_filename, filter_page, filter_data, true, filter_pages * PAGE_SIZE);
+        }
 
-                    if (sst_write_page_offset + ENTRY_SIZE > buffer_size)
-                    {
-                        ssize_t bytes_written = pwrite(fd3, write_buffer_SST, buffer_size, sst_write_offset);
-                        if (bytes_written != buffer_size)
-                        {
-                            perror("pwrite failed");
-                            std::cerr << "Error: Incomplete write for key-value pairs batch." << std::endl;
-                            freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-                            return {"", ""};
-                        }
-                        sst_write_offset += bytes_written;
-                        sst_write_page_offset = 0;                               // Reset the buffer for the next batch
-                        std::memset(write_buffer_SST, INTERNAL, buffer_size); // Clear the buffer
-                    }
-                }
+        // Every page of the filter block is cached on its own, and the block is only read from disk if one of them is missing
+        char *filter_buffer = nullptr;
+        if (posix_memalign(reinterpret_cast<void **>(&filter_buffer), PAGE_SIZE, filter_pages * PAGE_SIZE) != 0)
+        {
+            std::cerr << "Error: Could not allocate the Bloom filter of " << sst.sst_filename << std::endl;
+            return false;
+        }
+        bool is_cached = true;
+        for (size_t i = 0; i < filter_pages && is_cached; ++i)
+        {
+            std::string filter_id = sst.sst_filename + std::to_string(footer.filter_offset + i * PAGE_SIZE);
+            if ((bloom_page = buffer_pool->searchForPage(filter_id)) == nullptr)
+            {
+                is_cached = false;
                 break;
             }
-            read_page_offset_1 += read_page1;
-            buffer_1_Index = 0;
+            std::memcpy(filter_buffer + i * PAGE_SIZE, bloom_page->data, PAGE_SIZE);
         }
-    }
-
-    // Write any remaining data in the buffer if it's partially filled
-    if (sst_write_page_offset > 0)
-    {
-        // Pad the remaining buffer with zeroes (or another INTERNAL if needed)
-        std::memset(static_cast<char *>(write_buffer_SST) + sst_write_page_offset, INTERNAL, buffer_size - sst_write_page_offset);
-
-        if (sst_write_page_offset % PAGE_SIZE != 0) {
-            // Set the last long in the buffer to LEAF
-            long *buffer_as_longs = static_cast<long *>(write_buffer_SST);
-            int total_longs_in_buffer = buffer_size / sizeof(long);
-            buffer_as_longs[total_longs_in_buffer - 2] = LEAF;
+        if (is_cached)
+        {
+            bloom_filter.loadBitArrayFromBuffer(filter_buffer, footer.filter_size);
+            bool is_intact = isPageIntact(sst.sst_filename, filter_page, filter_buffer, true, filter_pages * PAGE_SIZE);
+            free(filter_buffer);
+            return is_intact;
         }
 
-        ssize_t bytes_written = pwrite(fd3, write_buffer_SST, buffer_size, sst_write_offset);
-        if (bytes_written != buffer_size)
+        int fd = open(sst.sst_filename.c_str(), O_RDONLY | O_DIRECT);
+        ssize_t bytes_read = fd < 0 ? -1 : pread(fd, filter_buffer, filter_pages * PAGE_SIZE, footer.filter_offset);
+        if (fd >= 0)
         {
-            perror("pwrite failed");
-            std::cerr << "Error: Incomplete final write for remaining key-value pairs." << std::endl;
-            freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-            return {"", ""};
+            close(fd);
         }
-
-        curr_page++;
-        btree.insertInternalNode(final_key_added, curr_page);
-    }
-
-    // Finalize the B-Tree and write Internal Nodes to the B-Tree file
-    if (btree.getNodes().size() > 0 && leaf_nodes_written > 1)
-    {
-        btree.finalizeTree();
-        btree.writeNodes(fd4, write_buffer_BTree, btree_write_offset);
+        if (bytes_read != static_cast<ssize_t>(filter_pages * PAGE_SIZE) || !isPageIntact(sst.sst_filename, filter_page, filter_buffer, false, filter_pages * PAGE_SIZE))
+        {
+            std::cerr << "Error: Could not read the Bloom filter of " << sst.sst_filename << std::endl;
+            free(filter_buffer);
+            return false;
+        }
+        bloom_filter.loadBitArrayFromBuffer(filter_buffer, footer.filter_size);
+        for (size_t i = 0; i < filter_pages; ++i)
+        {
+            std::string filter_id = sst.sst_filename + std::to_string(footer.filter_offset + i * PAGE_SIZE);
+            buffer_pool->insertPage(new Page(filter_id, filter_buffer + i * PAGE_SIZE));
+        }
+        free(filter_buffer);
+        return true;
     }
 
-    // Delete old  Bloom filter files
-    std::string btreeFile1 = sst1.sst_filename;
-    btreeFile1.replace(btreeFile1.find("sst_"), 4, "btree_");
-    std::string btreeFile2 = sst2.sst_filename;
-    btreeFile2.replace(btreeFile2.find("sst_"), 4, "btree_");
+    // Generate the Bloom filter filename
+    std::string bloom_filename = sst.sst_filename;
+    bloom_filename.replace(bloom_filename.find("sst_"), 4, "bloom_");
 
-    if (std::remove(btreeFile1.c_str()) != 0)
+    // In mmap mode the Bloom filter is read from its mapping, otherwise check if it is in the buffer pool
+    if (read_mode == ReadMode::MMAP && (bloom_map = getMappedFile(bloom_filename, AccessPattern::RANDOM))->getSize() >= bloom_size_bytes)
     {
-        perror("Error deleting Bloom file 1");
+        bloom_filter.loadBitArrayFromBuffer(bloom_map->getData(), bloom_size_bytes);
+        return isPageIntact(bloom_filename, 0, bloom_map->getData(), true, bloom_size_bytes);
     }
-    if (std::remove(btreeFile2.c_str()) != 0)
+    if ((bloom_page = buffer_pool->searchForPage(bloom_filename)) != nullptr)
     {
-        perror("Error deleting Bloom file 2");
+        // Load from the buffer pool
+        bloom_filter.loadBitArrayFromBuffer(bloom_page->data, bloom_size_bytes);
+        return isPageIntact(bloom_filename, 0, bloom_page->data, true, bloom_size_bytes);
     }
 
-    bloom_filter.serialize(bloom_filter_filename);
+    // Load from file
+    bloom_filter.loadBitArrayFromFile(bloom_filename);
+
+    // Create a temporary buffer for the bit array
+    char temp_buffer[PAGE_SIZE] = {0}; // Assuming PAGE_SIZE >= bloom_size_bytes
+    bloom_filter.copyBitArrayToBuffer(temp_buffer);
+
+    // Insert into the buffer pool
+    Page *new_page = new Page(bloom_filename, temp_buffer);
+    buffer_pool->insertPage(new_page);
+    return true;
+}
 
-    // Delete old  Bloom filter files
-    std::string bloomFile1 = sst1.sst_filename;
-    bloomFile1.replace(bloomFile1.find("sst_"), 4, "bloom_");
-    std::string bloomFile2 = sst2.sst_filename;
-    bloomFile2.replace(bloomFile2.find("sst_"), 4, "bloom_");
+// Implementation of the getMappedFile function.
+std::shared_ptr<MappedFile> LSMTree::getMappedFile(const std::string &filename, AccessPattern pattern)
+{
+    return file_reclaimer->getMappedFile(filename, pattern);
+}
 
-    if (std::remove(bloomFile1.c_str()) != 0)
+/*
+    Returns whether the SST at the given position can be moved to the next level
+    without merging it: its key range overlaps no other SST in its level nor any
+    SST below, and it has no tombstones that a merge would drop.
+*/
+bool LSMTree::isTrivialMove(int level_idx, size_t position)
+{
+    const SSTMetadata &metadata = levels[level_idx][position].metadata;
+    if (metadata.num_tombstones > 0 || !metadata.range_tombstones.empty())
     {
-        perror("Error deleting Bloom file 1");
+        return false;
     }
-    if (std::remove(bloomFile2.c_str()) != 0)
+
+    for (size_t i = 0; i < levels[level_idx].size(); ++i)
     {
-        perror("Error deleting Bloom file 2");
+        if (i != position && levels[level_idx][i].metadata.overlaps(metadata.min_key, metadata.max_key))
+        {
+            return false;
+        }
     }
-
-    freeMergeSSTsResources(fd1, fd2, fd3, fd4, read_buffer_1, read_buffer_2, write_buffer_SST, write_buffer_BTree);
-    return {new_sst_filename, new_btree_filename};
+    return !levelsOverlap(metadata.min_key, metadata.max_key, level_idx + 1);
 }
 
 /*
-    Puts the given sst and btree into the first level of the LSM tree,
-    if compaction is needed then perform compactLevels.
+    Returns the number of sorted runs in the given level. The SSTs written by
+    one compaction (or bulk load) are a single run, so splitting the output of
+    a compaction does not make its level look fuller.
 */
-void LSMTree::put(long key, long value)
+size_t LSMTree::countRuns(int level_idx)
 {
-    memtable->put(key, value);
-
-    if (!(memtable->getCurrSize() >= memtable->getMemtableSize()))
+    std::set<long> runs;
+    for (const SST &sst : levels[level_idx])
     {
-        return;
+        runs.insert(sst.run);
     }
-    // Write current memtable to SST
-    std::pair<std::string, std::string> filenames = writeMemtableToDisk(memtable, database_name);
-
-    // Free the currentMemtable as that information is no longer needed (its in SST now)
-    // Newly created database
-    this->changeMemtable(nullptr);
+    return runs.size();
+}
 
-    std::string sst_filename = filenames.first;
-    std::string btree_filename = filenames.second;
+/*
+    Returns the stripe of a write with the given sequence number: the oldest
+    live snapshot that sees it (LATEST_SEQUENCE if none does). Flushes and
+    compactions never put writes of different stripes into one SST, so every
+    SST is either wholly seen by a snapshot or not at all, and a merge only
+    drops the versions that no live snapshot sees.
+*/
+uint64_t LSMTree::getStripe(uint64_t sequence)
+{
+    std::lock_guard<std::mutex> lock(snapshots_mutex);
+    auto snapshot = snapshots.lower_bound(sequence);
+    return snapshot != snapshots.end() ? snapshot->first : LATEST_SEQUENCE;
+}
 
-    insertSST(sst_filename, btree_filename);
+// Returns whether a live snapshot is older than the given sequence number.
+bool LSMTree::hasSnapshotBefore(uint64_t sequence)
+{
+    std::lock_guard<std::mutex> lock(snapshots_mutex);
+    return !snapshots.empty() && snapshots.begin()->first < sequence;
 }
 
-void LSMTree::insertSST(std::string sst_filename, std::string btree_filename)
+/*
+    Returns the number of bytes in the given SSTs. A compressed SST is sized by
+    its pages before compression, so compression does not change the level a
+    compaction puts it in.
+*/
+off_t LSMTree::getLevelBytes(const std::vector<SST> &ssts)
 {
-    if (levels[0].size() < level_size_ratio)
+    off_t num_bytes = 0;
+    for (const SST &sst : ssts)
     {
-        // std::cerr << "LSM add to level 0.\n";
-        levels[0].emplace_back(0, levels[0].size(), sst_filename, btree_filename);
-
-        if (levels[0].size() == level_size_ratio)
+        std::error_code error;
+        uintmax_t file_size = std::filesystem::file_size(sst.sst_filename, error);
+        num_bytes += error ? 0 : static_cast<off_t>(file_size);
+        const SSTFooter &footer = sst.metadata.footer;
+        if (footer.isCompressed())
         {
-            // std::cerr << "compactLevels\n";
-            compactLevels();
+            num_bytes += footer.getNumDataPages() * PAGE_SIZE - footer.data_size;
         }
     }
-    return;
+    return num_bytes;
 }
 
 /*
-    Returns the result of scanning the lsm tree.
+    Returns whether any SST in first_level or a deeper level overlaps [key1, key2].
 */
-std::pair<std::pair<long, long> *, int> LSMTree::scan(long key1, long key2, BufferPool *buffer_pool, bool with_btree)
+bool LSMTree::levelsOverlap(long key1, long key2, int first_level)
 {
-    // First, check the memtable for the key
-    std::map<long, long> key_value_pairs;
-
-    // First check memtable
-    std::pair<std::pair<long, long> *, int> array_size_pair = memtable->scan(key1, key2);
-    std::pair<long, long> *key_value_pairs_memtable = array_size_pair.first;
-    int scanned_size = array_size_pair.second;
-    for (int i = 0; i < scanned_size; i++)
-    {
-        // std::cerr << "From Memtable: " << key_value_pairs_memtable[i].first << ", " << key_value_pairs_memtable[i].second;
-        key_value_pairs[key_value_pairs_memtable[i].first] = key_value_pairs_memtable[i].second;
-    }
-    free(key_value_pairs_memtable);
-
-    // Alignment and buffer size requirements for Direct I/O
-    const size_t buffer_size = PAGE_SIZE;
-
-    for (int level_idx = 0; level_idx < levels.size(); level_idx++)
+    for (int level_idx = first_level; level_idx < static_cast<int>(levels.size()); ++level_idx)
     {
-        std::vector<SST> level = levels[level_idx];
-
-        for (int i = 0; i < level.size(); ++i)
+        for (const SST &sst : levels[level_idx])
         {
-            std::string sst_filename = level[i].sst_filename; // Filter file associated with the SST
-            std::string btree_filename = level[i].btree_filename;
-
-            std::vector<std::pair<long, long>> scanned_values;
-            if (with_btree)
+            if (sst.metadata.overlaps(key1, key2))
             {
-                StaticBTree btree(sst_filename, btree_filename);
-                scanned_values = btree.scan(key1, key2, buffer_pool);
-            }
-            else
-            {
-                scanned_values = binarySearchScan(sst_filename, key1, key2, buffer_pool);
-            }
-
-            for (int j = 0; j < scanned_values.size(); j++)
-            {
-                if (key_value_pairs.find(scanned_values[j].first) == key_value_pairs.end())
-                {
-                    // std::cerr << "From SST: " << scanned_values[j].first << ", " << scanned_values[j].second;
-                    key_value_pairs[scanned_values[j].first] = scanned_values[j].second;
-                }
-            }
-
-            // If we find all of the keys in the range then end early (no point in searching more)
-            if (key_value_pairs.size() >= (key2 - key1 + 1))
-            {
-                // Dynamically allocate memory for the result array
-                std::pair<long, long> *arr_values = new std::pair<long, long>[key_value_pairs.size()];
-                std::copy(key_value_pairs.begin(), key_value_pairs.end(), arr_values);
-
-                return {arr_values, static_cast<int>(key_value_pairs.size())};
+                return true;
             }
         }
     }
+    return false;
+}
 
-    // Dynamically allocate memory for the result array
-    std::pair<long, long> *arr_values = new std::pair<long, long>[key_value_pairs.size()];
-    std::copy(key_value_pairs.begin(), key_value_pairs.end(), arr_values);
+/*
+    Returns whether any SST that is older than the SST at the given position
+    in the same level overlaps its key range.
+*/
+bool LSMTree::olderSiblingsOverlap(int level_idx, size_t position)
+{
+    const SSTMetadata &metadata = levels[level_idx][position].metadata;
+    for (size_t i = 0; i < position; ++i)
+    {
+        if (levels[level_idx][i].metadata.overlaps(metadata.min_key, metadata.max_key))
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
-    return {arr_values, static_cast<int>(key_value_pairs.size())};
+/*
+    Returns the SSTs in each level of the LSMTree, from oldest to newest. These
+    are the levels that writes change, so threads that read while others write
+    must use getVersion instead.
+*/
+const std::vector<std::vector<SST>> &LSMTree::getLevels()
+{
+    return levels;
 }
 
 /*
-    Returns the result of get on the lsm tree.
+    Takes a snapshot of the tree at the sequence number of the last write, and
+    returns it to read at (with get and scan) until it is released. The active
+    memtable is frozen (and an empty one takes the next writes), so it is not
+    copied and only ever holds writes that no live snapshot sees. Reads at the
+    snapshot then skip every memtable and SST that only holds newer writes,
+    and compactions keep the versions it sees (see getStripe) instead of it
+    holding on to the SSTs of its time. Snapshots taken with no write in
+    between share a sequence number.
 */
-NodeFileOffset *LSMTree::get(long key, BufferPool *buffer_pool, bool with_btree)
+uint64_t LSMTree::getSnapshot()
 {
-    // First, check the memtable for the key
-    Node *result = memtable->get(key);
-    if (result != nullptr)
+    WriteLock write_lock(*this, false);
+    uint64_t sequence = last_sequence;
+    if (memtable->getCurrSize() > 0 || !memtable->getRangeTombstones().empty())
     {
-        return new NodeFileOffset(result, "", -1); // Return from memtable if found
+        frozen_memtables.push_back({memtable, memtable_min_sequence, sequence});
+        memtable = new Memtable(memtable_size);
+        memtable_min_sequence = sequence + 1;
+        is_version_stale = true;
     }
+    std::lock_guard<std::mutex> lock(snapshots_mutex);
+    snapshots[sequence]++;
+    return sequence;
+}
 
-    // Iterate through each level in the LSM tree
-    for (int level_idx = 0; level_idx < levels.size(); ++level_idx)
+/*
+    Releases a snapshot. Once every snapshot at its sequence number is
+    released, the next compactions merge away the versions only it saw.
+*/
+void LSMTree::releaseSnapshot(uint64_t snapshot)
+{
+    std::lock_guard<std::mutex> lock(snapshots_mutex);
+    auto it = snapshots.find(snapshot);
+    if (it == snapshots.end())
     {
-        std::vector<SST> level = levels[level_idx];
+        std::cerr << "Error: Snapshot " << snapshot << " is not live" << std::endl;
+        return;
+    }
+    if (--it->second == 0)
+    {
+        snapshots.erase(it);
+    }
+}
 
-        for (int i = 0; i < level.size(); ++i)
-        {
-            std::string sst_filename = level[i].sst_filename; // Filter file associated with the SST
-            std::string btree_filename = level[i].btree_filename;
+// Implementation of the getLastSequence function.
+uint64_t LSMTree::getLastSequence()
+{
+    return last_sequence;
+}
 
-            // Generate the Bloom filter filename
-            std::string bloom_filename = sst_filename;
-            bloom_filename.replace(bloom_filename.find("sst_"), 4, "bloom_");
+/*
+    Returns the current version to read at the given snapshot, or nullptr (and
+    reports it) if the snapshot is not live. The version is taken while the
+    snapshot is known to be live, so no compaction that ran after its release
+    can have merged away a version it sees.
+*/
+std::shared_ptr<const LSMVersion> LSMTree::findSnapshot(uint64_t snapshot)
+{
+    std::lock_guard<std::mutex> lock(snapshots_mutex);
+    if (snapshots.find(snapshot) == snapshots.end())
+    {
+        std::cerr << "Error: Snapshot " << snapshot << " is not live" << std::endl;
+        return nullptr;
+    }
+    return std::atomic_load(&current_version);
+}
 
-            // std::cerr << "Loading Bloom filter from file: " << bloomFilename << std::endl;
+/*
+    Returns the current version of the tree. Its SSTs stay on disk (and its
+    memtable in memory) for as long as it is held, even once they were
+    compacted or flushed away.
+*/
+std::shared_ptr<const LSMVersion> LSMTree::getVersion()
+{
+    return std::atomic_load(&current_version);
+}
 
-            // Check if Bloom filter is in the buffer pool
-            Page *bloom_page = buffer_pool->searchForPage(bloom_filename);
-            const size_t bloom_size_bytes = 2400 / 8; // Adjust size based on your configuration
-            BloomFilter bloom_filter(2400, 3);       // Match the size and hash functions used during creation
+/*
+    Installs a version made of the current memtable and levels. The SSTs and
+    memtables dropped since the last install are handed to the version being
+    replaced, which frees them once it and every older version are released.
+*/
+void LSMTree::installVersion()
+{
+    std::shared_ptr<LSMVersion> version = std::make_shared<LSMVersion>();
+    version->file_reclaimer = file_reclaimer;
+    version->memtable = memtable;
+    version->frozen_memtables = frozen_memtables;
+    version->levels = levels;
+    std::shared_ptr<LSMVersion> old_version = current_version;
+    if (old_version != nullptr)
+    {
+        old_version->obsolete_ssts = std::move(retired_ssts);
+        old_version->obsolete_memtables = std::move(retired_memtables);
+        old_version->next = version;
+    }
+    retired_ssts.clear();
+    retired_memtables.clear();
+    is_version_stale = false;
+    std::atomic_store(&current_version, version);
+}
 
-            if (bloom_page != nullptr)
-            {
-                // Load from the buffer pool
-                bloom_filter.loadBitArrayFromBuffer(bloom_page->data, bloom_size_bytes);
-            }
-            else
-            {
-                // Load from file
-                bloom_filter.loadBitArrayFromFile(bloom_filename);
+/*
+    Loads a stream of key-value pairs sorted by strictly increasing key without
+    going through the memtable: the pairs are written straight into SSTs (with
+    their B-Trees and Bloom filters) of at most BULK_LOAD_SST_PAIRS pairs each,
+    which are only added to the LSM tree once all of them were written. The
+    stream gives its next pair through next_pair, which returns false once the
+    stream is over. Returns false (and adds nothing) if the stream is not
+    sorted or a write fails.
+*/
+bool LSMTree::bulkLoad(const std::function<bool(long &key, long &value)> &next_pair)
+{
+    std::vector<SST> loaded_ssts;
+    if (!writeBulkLoad(next_pair, loaded_ssts))
+    {
+        return false;
+    }
+    registerBulkLoad(loaded_ssts);
+    return true;
+}
 
-                // Create a temporary buffer for the bit array
-                char temp_buffer[PAGE_SIZE] = {0}; // Assuming PAGE_SIZE >= bloom_size_bytes
-                bloom_filter.copyBitArrayToBuffer(temp_buffer);
+/*
+    Writes the sorted stream into the SSTs of a bulk load without adding them
+    to the LSM tree. If it fails, then every file written is removed.
+*/
+bool LSMTree::writeBulkLoad(const std::function<bool(long &key, long &value)> &next_pair, std::vector<SST> &loaded_ssts)
+{
+    long key;
+    long value;
+    long last_key = LONG_MIN;
+    bool has_next = next_pair(key, value);
+    bool is_success = true;
 
-                // Insert into the buffer pool
-                Page *new_page = new Page(bloom_filename, temp_buffer);
-                buffer_pool->insertPage(new_page);
-            }
-            // std::cerr << "Checking Bloom filter for key: " << key << std::endl;
+    while (has_next && is_success)
+    {
+        std::string string_time_now = getCurrentTimestamp();
+        std::string sst_filename = DATA_FILE_PATH + database_name + "/sst_" + string_time_now + ".bin";
 
-            if (!bloom_filter.mightContain(std::to_string(key)))
+        SSTWriter writer(sst_filename, rate_limiter, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, page_encoding, level_compression[max_level - 1], getPageSize(max_level - 1));
+        writer.sizeFilter(BULK_LOAD_SST_PAIRS);
+        is_success = writer.isOpen();
+        for (size_t num_pairs = 0; is_success && has_next && num_pairs < BULK_LOAD_SST_PAIRS; ++num_pairs)
+        {
+            if (key <= last_key)
             {
-                std::cerr << "Key not in bloom filter of this SST" << std::endl;
-                continue; // Skip this SST if the Bloom filter says the key is absent
+                std::cerr << "Bulk Load Error: Keys must be strictly increasing, but " << key << " came after " << last_key << "." << std::endl;
+                is_success = false;
+                break;
             }
+            is_success = writer.put(key, value);
+            last_key = key;
+            has_next = next_pair(key, value);
+        }
+        is_success = is_success && writer.finish();
 
-            // std::cerr << "Key might be in SST: " << sstFileName << std::endl;
-            if (with_btree)
-            {
-                StaticBTree btree(sst_filename, btree_filename);
-                long value = btree.get(key, buffer_pool);
-                // If value is found then break out of the look
-                if (value != -1)
-                {
-                    return new NodeFileOffset(new Node(key, value), btree_filename, 0);
-                }
-            }
-            else
-            {
-                NodeFileOffset *ret = binarySearch(sst_filename, key, buffer_pool);
-                if (ret != nullptr)
-                {
-                    return ret;
-                }
-            }
+        // Keep track of the SST even if it failed, so that its files get removed
+        loaded_ssts.emplace_back(max_level - 1, 0, sst_filename, sst_filename, writer.getMetadata());
+    }
+
+    if (!is_success)
+    {
+        for (const SST &sst : loaded_ssts)
+        {
+            deleteSSTFiles(sst);
         }
+        loaded_ssts.clear();
+        return false;
     }
+    return true;
+}
 
-    return nullptr; // Key not found
+// Implementation of the bulkLoad function for key-value pairs sorted in memory.
+bool LSMTree::bulkLoad(const std::vector<std::pair<long, long>> &sorted_pairs)
+{
+    size_t i = 0;
+    return bulkLoad([&](long &key, long &value)
+                    {
+                        if (i == sorted_pairs.size())
+                        {
+                            return false;
+                        }
+                        key = sorted_pairs[i].first;
+                        value = sorted_pairs[i].second;
+                        i++;
+                        return true; });
 }
 
 /*
-    Changes the memtable of the current LSMTree
+    Bulk loads a binary file of key-value pairs (each stored as two longs)
+    sorted by strictly increasing key. The file is read BULK_LOAD_READ_PAIRS
+    pairs at a time.
 */
-Memtable *LSMTree::changeMemtable(Memtable *new_memtable)
+bool LSMTree::bulkLoadFile(const std::string &filename)
 {
-    if (new_memtable == nullptr)
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
     {
-        // Clean up the old memtable if necessary
-        delete this->memtable;
+        std::cerr << "Bulk Load Error: Failed to open file - " << filename << std::endl;
+        return false;
+    }
 
-        // Assign the new memtable
-        this->memtable = new Memtable(memtable_size);
+    std::vector<std::pair<long, long>> buffer(BULK_LOAD_READ_PAIRS);
+    size_t buffer_size = 0;
+    size_t buffer_index = 0;
+    return bulkLoad([&](long &key, long &value)
+                    {
+                        if (buffer_index == buffer_size)
+                        {
+                            in.read(reinterpret_cast<char *>(buffer.data()), BULK_LOAD_READ_PAIRS * ENTRY_SIZE);
+                            buffer_size = in.gcount() / ENTRY_SIZE;
+                            buffer_index = 0;
+                            if (buffer_size == 0)
+                            {
+                                return false;
+                            }
+                        }
+                        key = buffer[buffer_index].first;
+                        value = buffer[buffer_index].second;
+                        buffer_index++;
+                        return true; });
+}
 
-        return this->memtable;
+/*
+    Loads a stream of key-value pairs in any order without going through the
+    memtable. The pairs are external sorted in bounded memory (runs of
+    EXTERNAL_SORT_RUN_PAIRS pairs sorted in parallel, then a k-way merge),
+    keeping the value given last for every key, and the sorted pairs are then
+    bulk loaded. Returns false (and adds nothing) if anything fails.
+*/
+bool LSMTree::ingestUnsorted(const std::function<bool(long &key, long &value)> &next_pair)
+{
+    ExternalSorter sorter(DATA_FILE_PATH + database_name + "/run_" + getCurrentTimestamp());
+    long key;
+    long value;
+    while (next_pair(key, value))
+    {
+        sorter.add(key, value);
     }
-    else
+    if (!sorter.finish())
     {
-        // Assign the new memtable
-        this->memtable = new_memtable;
+        return false;
+    }
 
-        return this->memtable;
+    std::vector<SST> loaded_ssts;
+    if (!writeBulkLoad([&](long &key, long &value)
+                       { return sorter.next(key, value); },
+                       loaded_ssts))
+    {
+        return false;
+    }
+
+    // A run that failed to be read ends the stream early, so the SSTs are missing pairs
+    if (sorter.hasError())
+    {
+        for (const SST &sst : loaded_ssts)
+        {
+            deleteSSTFiles(sst);
+        }
+        return false;
     }
+    registerBulkLoad(loaded_ssts);
+    return true;
 }
 
 /*
-    Compacts the levels in the LSMTree.
+    Ingests a file of unsorted key-value pairs. A file ending in ".csv" holds
+    a "key,value" pair per line (lines that are not a pair, like a header, are
+    skipped), any other file holds binary pairs of longs.
 */
-void LSMTree::compactLevels()
+bool LSMTree::ingestFile(const std::string &filename)
 {
-    for (int level_idx = 0; level_idx < levels.size(); ++level_idx)
+    bool is_csv = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+    std::ifstream in(filename, is_csv ? std::ios::in : std::ios::binary);
+    if (!in)
     {
-        std::vector<SST> level = levels[level_idx];
-        bool is_last_level = (max_level - 1) == level_idx;
-        if (level.size() == level_size_ratio)
-        {
-            SST merged_sst = level[0];
-            for (size_t i = 1; i < level.size(); ++i)
-            {
-                SST current_sst = level[i];
-                std::pair<std::string, std::string> merged_filenames = this->mergeSSTs(merged_sst, current_sst, is_last_level);
-                std::string new_merged_sst_filename = merged_filenames.first;
-                std::string new_merged_btree_filename = merged_filenames.second;
-                // Delete the current_sst
-                if (std::remove(current_sst.sst_filename.c_str()) != 0)
-                {
-                    perror("Error deleting file");
-                    return;
-                }
-                // Delete the old merged_sst
-                if (std::remove(merged_sst.sst_filename.c_str()) != 0)
-                {
-                    perror("Error deleting file");
-                    return;
-                }
-                merged_sst.sst_filename = new_merged_sst_filename;
-                merged_sst.btree_filename = new_merged_btree_filename;
-            }
-            // Clear current level as we have merged all of them.
-            levels[level_idx].clear();
+        std::cerr << "Ingest Error: Failed to open file - " << filename << std::endl;
+        return false;
+    }
 
-            // Check file size to see where it goes
-            int fd = open(merged_sst.sst_filename.c_str(), O_RDONLY);
-            if (fd < 0)
-            {
-                std::cerr << "CompactLevels LSM Tree: Failed to open merged SST file - " << merged_sst.sst_filename << std::endl;
-                return;
-            }
-            off_t merged_file_size = lseek(fd, 0, SEEK_END);
-            close(fd);
+    if (is_csv)
+    {
+        std::string line;
+        return ingestUnsorted([&](long &key, long &value)
+                              {
+                                  while (std::getline(in, line))
+                                  {
+                                      if (std::sscanf(line.c_str(), "%ld , %ld", &key, &value) == 2)
+                                      {
+                                          return true;
+                                      }
+                                  }
+                                  return false; });
+    }
 
-            size_t current_level_max_size = pow(level_size_ratio, level_idx + 1) * memtable_size;
-            // If file has less than p^(level + 1) entries, then it stays on the same level
-            if (merged_file_size <= current_level_max_size || is_last_level)
-            {
-                levels[level_idx].push_back(merged_sst);
-            }
-            // Otherwise add it to the next level
-            else
+    std::vector<std::pair<long, long>> buffer(BULK_LOAD_READ_PAIRS);
+    size_t buffer_size = 0;
+    size_t buffer_index = 0;
+    return ingestUnsorted([&](long &key, long &value)
+                          {
+                              if (buffer_index == buffer_size)
+                              {
+                                  in.read(reinterpret_cast<char *>(buffer.data()), BULK_LOAD_READ_PAIRS * ENTRY_SIZE);
+                                  buffer_size = in.gcount() / ENTRY_SIZE;
+                                  buffer_index = 0;
+                                  if (buffer_size == 0)
+                                  {
+                                      return false;
+                                  }
+                              }
+                              key = buffer[buffer_index].first;
+                              value = buffer[buffer_index].second;
+                              buffer_index++;
+                              return true; });
+}
+
+/*
+    Adds the bulk-loaded SSTs to the LSM tree all at once. They are newer than
+    everything already in the tree, so they go to the deepest level that has
+    no SST overlapping them above it (the last level if nothing overlaps them),
+    after the SSTs already in that level. If a memtable overlaps them, then the
+    memtables are flushed first so that their older values end up below them.
+*/
+void LSMTree::registerBulkLoad(std::vector<SST> &loaded_ssts)
+{
+    if (loaded_ssts.empty())
+    {
+        return;
+    }
+    WriteLock write_lock(*this, true);
+    long min_key = loaded_ssts.front().metadata.min_key;
+    long max_key = loaded_ssts.back().metadata.max_key;
+    if (memtablesOverlap(min_key, max_key))
+    {
+        flushMemtable();
+    }
+    last_sequence++;
+
+    int target_level = max_level - 1;
+    for (int level_idx = max_level - 1; level_idx >= 0; --level_idx)
+    {
+        for (const SST &sst : levels[level_idx])
+        {
+            if (sst.metadata.overlaps(min_key, max_key))
             {
-                merged_sst.level = level_idx + 1;
-                levels[level_idx + 1].push_back(merged_sst);
+                target_level = level_idx;
             }
         }
     }
+
+    long run = next_run++;
+    for (SST &sst : loaded_ssts)
+    {
+        sst.run = run;
+        sst.min_sequence = last_sequence;
+        sst.max_sequence = last_sequence;
+        sst.level = target_level;
+        sst.level_index = levels[target_level].size();
+        levels[target_level].push_back(sst);
+    }
+
+    // The loaded SSTs must be visible before the row cache is invalidated, so that no get caches an older value after it
+    installVersion();
+    RowCache *curr_row_cache = row_cache;
+    if (curr_row_cache != nullptr)
+    {
+        curr_row_cache->eraseRange(min_key, max_key);
+    }
+    compactLevels();
 }
 
 /*
@@ -853,10 +1932,12 @@ void LSMTree::compactLevels()
 void LSMTree::printLSMTree()
 {
     std::cerr << "LSM Tree: \n";
-    for (const std::vector level : levels)
+    long total_entries = 0;
+    for (const std::vector<SST> &level : levels)
     {
         for (const SST &sst : level)
         {
+            total_entries += sst.metadata.num_entries;
             int fd = open(sst.sst_filename.c_str(), O_RDONLY);
             if (fd < 0)
             {
@@ -875,7 +1956,24 @@ void LSMTree::printLSMTree()
             off_t filesize1 = lseek(fd1, 0, SEEK_END);
             close(fd1);
 
-            std::cerr << "Level:" << sst.level << ", Index: " << sst.level_index << ", SSTFilename: " << sst.sst_filename << ", Filesize: " << filesize << ", BtreeFilename : " << sst.btree_filename << ", Filesize : " << filesize1 << "\n";
+            std::cerr << "Level:" << sst.level << ", Index: " << sst.level_index << ", SSTFilename: " << sst.sst_filename << ", Filesize: " << filesize << ", BtreeFilename : " << sst.btree_filename << ", Filesize : " << filesize1 << ", Entries: " << sst.metadata.num_entries << ", Tombstones: " << sst.metadata.num_tombstones << "\n";
         }
     }
+
+    // Print the memory used by the fence pointers and the learned indexes, scaled to a GB of key-value pairs
+    if (total_entries > 0)
+    {
+        size_t fence_bytes = getFencePointerMemory();
+        double data_gb = static_cast<double>(total_entries) * ENTRY_SIZE / (1024.0 * 1024.0 * 1024.0);
+        std::cerr << "Fence Pointers: " << fence_bytes << " bytes, " << fence_bytes / data_gb << " bytes per GB of data\n";
+        size_t learned_bytes = getLearnedIndexMemory();
+        std::cerr << "Learned Index: " << learned_bytes << " bytes, " << learned_bytes / data_gb << " bytes per GB of data\n";
+    }
+
+    // Print the rate limiter metrics
+    RateLimiter *curr_rate_limiter = rate_limiter;
+    if (curr_rate_limiter != nullptr)
+    {
+        std::cerr << "Rate Limiter Budget: " << curr_rate_limiter->getBytesPerSecond() << " bytes/sec, Compaction: " << curr_rate_limiter->getCompactionBytesPerSecond() << " bytes/sec\n";
+    }
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "mapped_file.h"
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the MappedFile class's constructor and destructor.
+/*
+    Maps the whole file read-only. Empty or missing files are left unmapped,
+    in which case the readers fall back to pread.
+*/
+MappedFile::MappedFile(const std::string &filename)
+    : filename(filename), data(nullptr), size(0), access_pattern(AccessPattern::NORMAL)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0 || file_stat.st_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Error: Unable to mmap file " << filename << std::endl;
+        return;
+    }
+
+    data = static_cast<char *>(mapping);
+    size = file_stat.st_size;
+}
+
+// Implementation of the MappedFile destructor.
+MappedFile::~MappedFile()
+{
+    if (data != nullptr)
+    {
+        munmap(data, size);
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the MappedFile class's public functions.
+// Implementation of the isMapped function.
+bool MappedFile::isMapped() const
+{
+    return data != nullptr;
+}
+
+// Implementation of the getData function.
+const char *MappedFile::getData() const
+{
+    return data;
+}
+
+// Implementation of the getSize function.
+size_t MappedFile::getSize() const
+{
+    return size;
+}
+
+// Implementation of the getNumPages function.
+long MappedFile::getNumPages() const
+{
+    return size / PAGE_SIZE;
+}
+
+// Implementation of the getPage function.
+const char *MappedFile::getPage(long page_index) const
+{
+    if (data == nullptr || page_index < 0 || page_index >= getNumPages())
+    {
+        return nullptr;
+    }
+    return data + page_index * PAGE_SIZE;
+}
+
+/*
+    Hints the access pattern of the following reads to the kernel. The hint
+    covers the whole mapping, so madvise is only called when it changes.
+*/
+void MappedFile::advise(AccessPattern pattern)
+{
+    if (data == nullptr || pattern == access_pattern)
+    {
+        return;
+    }
+
+    int advice = MADV_NORMAL;
+    if (pattern == AccessPattern::RANDOM)
+    {
+        advice = MADV_RANDOM;
+    }
+    else if (pattern == AccessPattern::SEQUENTIAL)
+    {
+        advice = MADV_SEQUENTIAL;
+    }
+
+    if (madvise(data, size, advice) < 0)
+    {
+        std::cerr << "Error: madvise failed for file " << filename << std::endl;
+        return;
+    }
+    access_pattern = pattern;
+}
+////////////////////////////////////////////////////////////////////////////
@@ -2,8 +2,9 @@
 #include "memtable.h"
 #include "sst.h"
 ////////////////////////////////////////////////////////////////////////////
-// Define the Node struct's constructor and destructor.
-Node::Node(long k, long v)
+// Define the BasicNode struct's constructor and destructor.
+template <typename Key, typename Value>
+BasicNode<Key, Value>::BasicNode(Key k, Value v)
 {
     key = k;
     value = v;
@@ -12,7 +13,8 @@ Node::Node(long k, long v)
     height = 1;
 }
 
-Node::~Node()
+template <typename Key, typename Value>
+BasicNode<Key, Value>::~BasicNode()
 {
     // Add code here to free up dynamically allocated memory, but as there
     // is no dynamically allocated memory right now, there is no code.
@@ -20,24 +22,27 @@ Node::~Node()
 ////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////
-// Define the Memtable class's constructor and destructor.
-Memtable::Memtable(int memtable_s)
+// Define the BasicMemtable class's constructor and destructor.
+template <typename Key, typename Value>
+BasicMemtable<Key, Value>::BasicMemtable(int memtable_s)
 {
     root_node = nullptr;
     memtable_size = memtable_s;
     curr_size = 0;
 }
 
-Memtable::~Memtable()
+template <typename Key, typename Value>
+BasicMemtable<Key, Value>::~BasicMemtable()
 {
     deleteTree(root_node);
 }
 ////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////
-// Implement all of the Memtable class's private functions.
+// Implement all of the BasicMemtable class's private functions.
 // Implementation of the getHeight function.
-int Memtable::getHeight(Node *node)
+template <typename Key, typename Value>
+int BasicMemtable<Key, Value>::getHeight(NodeType *node)
 {
     if (node == nullptr)
     {
@@ -47,7 +52,8 @@ int Memtable::getHeight(Node *node)
 }
 
 // Implementation of the getBalanceFunction function.
-int Memtable::getBalanceFactor(Node *node)
+template <typename Key, typename Value>
+int BasicMemtable<Key, Value>::getBalanceFactor(NodeType *node)
 {
     if (node == nullptr)
     {
@@ -57,7 +63,8 @@ int Memtable::getBalanceFactor(Node *node)
 }
 
 // Implementation of the rotateRight function.
-Node *Memtable::rotateRight(Node *curr_root)
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::rotateRight(NodeType *curr_root)
 {
     if (curr_root == nullptr || curr_root->left == nullptr)
     {
@@ -66,8 +73,8 @@ Node *Memtable::rotateRight(Node *curr_root)
     }
 
     // Save the Nodes which are being moved
-    Node *new_root = curr_root->left;
-    Node *move_right = new_root->right;
+    NodeType *new_root = curr_root->left;
+    NodeType *move_right = new_root->right;
 
     // Complete the actual rotation
     new_root->right = curr_root;
@@ -82,7 +89,8 @@ Node *Memtable::rotateRight(Node *curr_root)
 }
 
 // Implementation of the rotateLeft function.
-Node *Memtable::rotateLeft(Node *curr_root)
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::rotateLeft(NodeType *curr_root)
 {
     if (curr_root == nullptr || curr_root->right == nullptr)
     {
@@ -91,8 +99,8 @@ Node *Memtable::rotateLeft(Node *curr_root)
     }
 
     // Save the Nodes which are being moved
-    Node *new_root = curr_root->right;
-    Node *move_left = new_root->left;
+    NodeType *new_root = curr_root->right;
+    NodeType *move_left = new_root->left;
 
     // Complete the actual rotation
     new_root->left = curr_root;
@@ -107,12 +115,13 @@ Node *Memtable::rotateLeft(Node *curr_root)
 }
 
 // Implementation of the insert function.
-Node *Memtable::insert(Node *curr_root, long key, long value)
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::insert(NodeType *curr_root, Key key, Value value)
 {
     if (curr_root == nullptr)
     {
         curr_size++;
-        return new Node(key, value);
+        return new NodeType(key, value);
     }
 
     if (key < curr_root->key)
@@ -166,8 +175,89 @@ Node *Memtable::insert(Node *curr_root, long key, long value)
     return curr_root;
 }
 
+// Implementation of the getMinNode function.
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::getMinNode(NodeType *curr_root)
+{
+    while (curr_root->left != nullptr)
+    {
+        curr_root = curr_root->left;
+    }
+    return curr_root;
+}
+
+// Implementation of the remove function.
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::remove(NodeType *curr_root, Key key)
+{
+    if (curr_root == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (key < curr_root->key)
+    {
+        curr_root->left = remove(curr_root->left, key);
+    }
+    else if (key > curr_root->key)
+    {
+        curr_root->right = remove(curr_root->right, key);
+    }
+    // If the Node has at most one child, then the child takes its place
+    else if (curr_root->left == nullptr || curr_root->right == nullptr)
+    {
+        NodeType *child = curr_root->left != nullptr ? curr_root->left : curr_root->right;
+        delete curr_root;
+        curr_size--;
+        return child;
+    }
+    // Otherwise take the key-value pair of the next Node in order and remove that Node instead
+    else
+    {
+        NodeType *successor = getMinNode(curr_root->right);
+        curr_root->key = successor->key;
+        curr_root->value = successor->value;
+        curr_root->right = remove(curr_root->right, successor->key);
+    }
+
+    return rebalance(curr_root);
+}
+
+// Implementation of the rebalance function.
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::rebalance(NodeType *curr_root)
+{
+    curr_root->height = 1 + std::max(getHeight(curr_root->left), getHeight(curr_root->right));
+    int balance = getBalanceFactor(curr_root);
+
+    if (balance > 1 && getBalanceFactor(curr_root->left) >= 0)
+    {
+        return rotateRight(curr_root);
+    }
+
+    if (balance > 1)
+    {
+        curr_root->left = rotateLeft(curr_root->left);
+        return rotateRight(curr_root);
+    }
+
+    if (balance < -1 && getBalanceFactor(curr_root->right) <= 0)
+    {
+        return rotateLeft(curr_root);
+    }
+
+    if (balance < -1)
+    {
+        curr_root->right = rotateRight(curr_root->right);
+        return rotateLeft(curr_root);
+    }
+
+    return curr_root;
+}
+
 // Implementation of the get function.
-Node *Memtable::get(Node *curr_root, long key)
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::get(NodeType *curr_root, Key key)
 {
     if (curr_size == 0 || curr_root == nullptr)
     {
@@ -194,7 +284,8 @@ Node *Memtable::get(Node *curr_root, long key)
 }
 
 // Implementation of the deleteTree function.
-void Memtable::deleteTree(Node *curr_root)
+template <typename Key, typename Value>
+void BasicMemtable<Key, Value>::deleteTree(NodeType *curr_root)
 {
     if (curr_root != nullptr)
     {
@@ -204,7 +295,8 @@ void Memtable::deleteTree(Node *curr_root)
     }
 }
 // Implementation of the scan function.
-void Memtable::scan(Node *curr_root, long key1, long key2, std::vector<std::pair<long, long>> *found_nodes)
+template <typename Key, typename Value>
+void BasicMemtable<Key, Value>::scan(NodeType *curr_root, Key key1, Key key2, std::vector<std::pair<Key, Value>> *found_nodes)
 {
     // If the current node is null, then return
     if (curr_root == nullptr)
@@ -212,9 +304,9 @@ void Memtable::scan(Node *curr_root, long key1, long key2, std::vector<std::pair
         return;
     }
     // If the current node is not null, then return
-    long curr_key = curr_root->key;
-    long curr_value = curr_root->value;
-    std::pair<long, long> key_value_pair(curr_key, curr_value);
+    Key curr_key = curr_root->key;
+    Value curr_value = curr_root->value;
+    std::pair<Key, Value> key_value_pair(curr_key, curr_value);
     // Traverse and scan
     if (key1 < curr_key)
     {
@@ -236,9 +328,10 @@ void Memtable::scan(Node *curr_root, long key1, long key2, std::vector<std::pair
 ////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////
-// Implement all of the Memtable class's public functions.
+// Implement all of the BasicMemtable class's public functions.
 // Implementation of the put function.
-void Memtable::put(long key, long value)
+template <typename Key, typename Value>
+void BasicMemtable<Key, Value>::put(Key key, Value value)
 {
     if (curr_size < memtable_size)
     {
@@ -252,10 +345,95 @@ void Memtable::put(long key, long value)
 }
 
 // Implementation of the get function.
-Node *Memtable::get(long key)
+template <typename Key, typename Value>
+typename BasicMemtable<Key, Value>::NodeType *BasicMemtable<Key, Value>::get(Key key)
 {
     return get(root_node, key);
 }
+
+// Implementation of the scan function.
+// You must free up the array of key-value pairs after receiving them.
+template <typename Key, typename Value>
+std::pair<std::pair<Key, Value> *, int> BasicMemtable<Key, Value>::scan(Key key1, Key key2)
+{
+    std::vector<std::pair<Key, Value>> found_nodes;
+
+    // Call the internal scan function
+    scan(root_node, key1, key2, &found_nodes);
+
+    // Copy results into dynamically allocated array
+    std::pair<Key, Value> *arr_values = new std::pair<Key, Value>[found_nodes.size()];
+    std::copy(found_nodes.begin(), found_nodes.end(), arr_values);
+
+    // Return array and its size
+    return {arr_values, static_cast<int>(found_nodes.size())};
+}
+
+/*
+    Deletes every key in [key1, key2] with a single range tombstone. The Nodes
+    already in the range are removed, so every Node left in the Memtable is
+    newer than its range tombstones and the tombstones only hide older SSTs.
+*/
+template <typename Key, typename Value>
+void BasicMemtable<Key, Value>::deleteRange(Key key1, Key key2)
+{
+    if (key1 > key2)
+    {
+        std::cerr << "Error: DeleteRange requires key1 <= key2." << std::endl;
+        return;
+    }
+
+    std::vector<std::pair<Key, Value>> found_nodes;
+    scan(root_node, key1, key2, &found_nodes);
+    for (const std::pair<Key, Value> &key_value_pair : found_nodes)
+    {
+        root_node = remove(root_node, key_value_pair.first);
+    }
+
+    range_tombstones.add(key1, key2);
+}
+
+// Get the range tombstones
+template <typename Key, typename Value>
+const RangeTombstones &BasicMemtable<Key, Value>::getRangeTombstones()
+{
+    return range_tombstones;
+}
+
+// Get memtable size
+template <typename Key, typename Value>
+int BasicMemtable<Key, Value>::getMemtableSize()
+{
+    return memtable_size;
+}
+// Get current size
+template <typename Key, typename Value>
+int BasicMemtable<Key, Value>::getCurrSize()
+{
+    return curr_size;
+}
+////////////////////////////////////////////////////////////////////////////
+
+// The key and value types of the Memtables (the long ones are the Memtable of the LSMTree).
+template struct BasicNode<int32_t, int32_t>;
+template struct BasicNode<int32_t, long>;
+template struct BasicNode<long, int32_t>;
+template struct BasicNode<long, long>;
+template class BasicMemtable<int32_t, int32_t>;
+template class BasicMemtable<int32_t, long>;
+template class BasicMemtable<long, int32_t>;
+template class BasicMemtable<long, long>;
+
+////////////////////////////////////////////////////////////////////////////
+// Define the Memtable class's constructor.
+Memtable::Memtable(int memtable_s) : BasicMemtable<long, long>(memtable_s)
+{
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the Memtable class's functions.
+// Implementation of the get function.
 NodeFileOffset *Memtable::get(long key, const std::string current_database, BufferPool *buffer_pool)
 {
     // Search in the memtable
@@ -280,23 +458,6 @@ NodeFileOffset *Memtable::get(long key, const std::string current_database, Buff
     return nullptr;
 }
 
-// Implementation of the scan function.
-// You must free up the array of key-value pairs after receiving them.
-std::pair<std::pair<long, long> *, int> Memtable::scan(long key1, long key2)
-{
-    std::vector<std::pair<long, long>> found_nodes;
-
-    // Call the internal scan function
-    scan(root_node, key1, key2, &found_nodes);
-
-    // Copy results into dynamically allocated array
-    std::pair<long, long> *arr_values = new std::pair<long, long>[found_nodes.size()];
-    std::copy(found_nodes.begin(), found_nodes.end(), arr_values);
-
-    // Return array and its size
-    return {arr_values, static_cast<int>(found_nodes.size())};
-}
-
 // Public scan function: scans memtable and SSTs
 std::pair<std::pair<long, long> *, int> Memtable::scan(long key1, long key2, const std::string current_database, BufferPool *buffer_pool)
 {
@@ -322,15 +483,4 @@ std::pair<std::pair<long, long> *, int> Memtable::scan(long key1, long key2, con
 
     return {arr_values, static_cast<int>(results.size())};
 }
-
-// Get memtable size
-int Memtable::getMemtableSize()
-{
-    return memtable_size;
-}
-// Get current size
-int Memtable::getCurrSize()
-{
-    return curr_size;
-}
 ////////////////////////////////////////////////////////////////////////////
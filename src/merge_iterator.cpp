@@ -0,0 +1,137 @@
+#include "merge_iterator.h"
+#include "sst.h"
+#include "typed_sst.h"
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the MergeIterator class's constructor.
+template <typename Iterator>
+MergeIterator<Iterator>::MergeIterator(const std::vector<Iterator *> &iterators)
+    : iterators(iterators), curr_key(), curr_value(), curr_source(0), is_valid(false)
+{
+    for (size_t i = 0; i < iterators.size(); ++i)
+    {
+        if (iterators[i]->valid())
+        {
+            heap.push_back(i);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), [this](size_t a, size_t b)
+                   { return isAfter(a, b); });
+    readNext();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the MergeIterator class's functions.
+// Orders the heap by key, then from the newest iterator to the oldest.
+template <typename Iterator>
+bool MergeIterator<Iterator>::isAfter(size_t a, size_t b)
+{
+    Key key_a = iterators[a]->key();
+    Key key_b = iterators[b]->key();
+    return key_a > key_b || (key_a == key_b && a < b);
+}
+
+// Implementation of the advance function.
+template <typename Iterator>
+void MergeIterator<Iterator>::advance(size_t index)
+{
+    iterators[index]->next();
+    if (iterators[index]->valid())
+    {
+        heap.push_back(index);
+        std::push_heap(heap.begin(), heap.end(), [this](size_t a, size_t b)
+                       { return isAfter(a, b); });
+    }
+}
+
+/*
+    Takes the newest pair of the smallest key left from the heap, then skips
+    the older pairs of the key.
+*/
+template <typename Iterator>
+void MergeIterator<Iterator>::readNext()
+{
+    auto is_after = [this](size_t a, size_t b)
+    {
+        return isAfter(a, b);
+    };
+    is_valid = !heap.empty();
+    if (!is_valid)
+    {
+        return;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), is_after);
+    curr_source = heap.back();
+    heap.pop_back();
+    curr_key = iterators[curr_source]->key();
+    curr_value = iterators[curr_source]->value();
+    advance(curr_source);
+
+    while (!heap.empty() && iterators[heap.front()]->key() == curr_key)
+    {
+        std::pop_heap(heap.begin(), heap.end(), is_after);
+        size_t older = heap.back();
+        heap.pop_back();
+        advance(older);
+    }
+}
+
+// Implementation of the valid function.
+template <typename Iterator>
+bool MergeIterator<Iterator>::valid()
+{
+    return is_valid;
+}
+
+// Implementation of the hasError function.
+template <typename Iterator>
+bool MergeIterator<Iterator>::hasError()
+{
+    for (Iterator *iterator : iterators)
+    {
+        if (iterator->hasError())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Implementation of the key function.
+template <typename Iterator>
+typename MergeIterator<Iterator>::Key MergeIterator<Iterator>::key()
+{
+    return curr_key;
+}
+
+// Implementation of the value function.
+template <typename Iterator>
+typename MergeIterator<Iterator>::Value MergeIterator<Iterator>::value()
+{
+    return curr_value;
+}
+
+// Implementation of the source function.
+template <typename Iterator>
+size_t MergeIterator<Iterator>::source()
+{
+    return curr_source;
+}
+
+// Implementation of the next function.
+template <typename Iterator>
+void MergeIterator<Iterator>::next()
+{
+    readNext();
+}
+////////////////////////////////////////////////////////////////////////////
+
+// The SSTs merged by compactions: those of the LSMTree and those of the TypedLSMTree of every key and value type.
+template class MergeIterator<SSTIterator>;
+template class MergeIterator<TypedSSTIterator<int32_t, int32_t>>;
+template class MergeIterator<TypedSSTIterator<int32_t, long>>;
+template class MergeIterator<TypedSSTIterator<long, int32_t>>;
+template class MergeIterator<TypedSSTIterator<long, long>>;
@@ -0,0 +1,343 @@
+#include "packed_page.h"
+#include "page_search.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define PACKED_PAGE_X86
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Define the PackedPageBuilder class's constructor.
+PackedPageBuilder::PackedPageBuilder() : num_pairs(0), min_delta(LONG_MAX), max_delta(LONG_MIN) {}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the PackedPageBuilder class's functions.
+/*
+    Adds a key-value pair to the page. Keys must be strictly increasing.
+    Returns false (and leaves the page unchanged) if the pair does not fit,
+    since its key would widen the packed keys past the end of the page.
+*/
+bool PackedPageBuilder::add(long key, long value)
+{
+    if (num_pairs == PACKED_PAGE_MAX_PAIRS)
+    {
+        return false;
+    }
+    if (num_pairs > 0)
+    {
+        long delta = key - keys[num_pairs - 1];
+        long new_min_delta = std::min(min_delta, delta);
+        long new_max_delta = std::max(max_delta, delta);
+        long bit_width = getPackedBitWidth(new_max_delta - new_min_delta);
+        if (getPackedPageLongs(num_pairs + 1, bit_width) > static_cast<long>(PAGE_SIZE / sizeof(long)))
+        {
+            return false;
+        }
+        min_delta = new_min_delta;
+        max_delta = new_max_delta;
+    }
+    keys[num_pairs] = key;
+    values[num_pairs] = value;
+    num_pairs++;
+    return true;
+}
+
+// Implementation of the write function.
+void PackedPageBuilder::write(void *page) const
+{
+    long *longs = static_cast<long *>(page);
+    std::memset(page, 0, PAGE_SIZE);
+
+    long frame = num_pairs > 1 ? min_delta : 0;
+    long bit_width = num_pairs > 1 ? getPackedBitWidth(max_delta - min_delta) : 0;
+    longs[0] = num_pairs;
+    longs[1] = bit_width;
+    longs[2] = num_pairs > 0 ? keys[0] : INTERNAL;
+    longs[3] = num_pairs > 0 ? keys[num_pairs - 1] : INTERNAL;
+    longs[4] = frame;
+    std::memcpy(longs + PACKED_PAGE_HEADER_LONGS, values, num_pairs * sizeof(long));
+
+    uint64_t *words = reinterpret_cast<uint64_t *>(longs + PACKED_PAGE_HEADER_LONGS + num_pairs);
+    for (long i = 1; i < num_pairs && bit_width > 0; i++)
+    {
+        uint64_t packed_key = static_cast<uint64_t>(keys[i] - keys[i - 1] - frame);
+        long bit_offset = (i - 1) * bit_width;
+        long word = bit_offset / 64;
+        long shift = bit_offset % 64;
+        words[word] |= packed_key << shift;
+        if (shift + bit_width > 64)
+        {
+            words[word + 1] |= packed_key >> (64 - shift);
+        }
+    }
+}
+
+// Implementation of the clear function.
+void PackedPageBuilder::clear()
+{
+    num_pairs = 0;
+    min_delta = LONG_MAX;
+    max_delta = LONG_MIN;
+}
+
+// Implementation of the empty function.
+bool PackedPageBuilder::empty() const
+{
+    return num_pairs == 0;
+}
+
+// Implementation of the size function.
+long PackedPageBuilder::size() const
+{
+    return num_pairs;
+}
+
+// Implementation of the getLastKey function.
+long PackedPageBuilder::getLastKey() const
+{
+    return keys[num_pairs - 1];
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the page layout helpers.
+// Returns the number of bits needed to store every offset up to max_offset.
+long getPackedBitWidth(uint64_t max_offset)
+{
+    return max_offset == 0 ? 0 : 64 - __builtin_clzl(max_offset);
+}
+
+// Returns the number of page longs used by a packed page (including the free long after the packed keys).
+long getPackedPageLongs(long num_pairs, long bit_width)
+{
+    long packed_words = (std::max(num_pairs - 1, 0L) * bit_width + 63) / 64;
+    return PACKED_PAGE_HEADER_LONGS + num_pairs + packed_words + 1;
+}
+
+// Implementation of the getPackedPageNumPairs function.
+long getPackedPageNumPairs(const char *page)
+{
+    return reinterpret_cast<const long *>(page)[0];
+}
+
+// Implementation of the getPackedPageFirstKey function.
+long getPackedPageFirstKey(const char *page)
+{
+    return reinterpret_cast<const long *>(page)[2];
+}
+
+// Implementation of the getPackedPageLastKey function.
+long getPackedPageLastKey(const char *page)
+{
+    return reinterpret_cast<const long *>(page)[3];
+}
+
+// Implementation of the getPackedPageValues function.
+const long *getPackedPageValues(const char *page)
+{
+    return reinterpret_cast<const long *>(page) + PACKED_PAGE_HEADER_LONGS;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the kernels that decode the packed keys after the first key.
+/*
+    Decodes the packed keys first to first + count - 1, starting from the key
+    before them, into keys[first] to keys[first + count - 1].
+*/
+static void decodeScalarRange(const uint64_t *words, long first, long count, long bit_width, long key, long frame, long *keys)
+{
+    uint64_t mask = (1UL << bit_width) - 1;
+    for (long i = first; i < first + count; i++)
+    {
+        long bit_offset = i * bit_width;
+        long word = bit_offset / 64;
+        long shift = bit_offset % 64;
+        uint64_t packed_key = words[word] >> shift;
+        if (shift + bit_width > 64)
+        {
+            packed_key |= words[word + 1] << (64 - shift);
+        }
+        key += frame + static_cast<long>(packed_key & mask);
+        keys[i] = key;
+    }
+}
+
+// Implementation of the scalar kernel.
+static void decodeScalar(const uint64_t *words, long count, long bit_width, long key, long frame, long *keys)
+{
+    decodeScalarRange(words, 0, count, bit_width, key, frame, keys);
+}
+
+#ifdef PACKED_PAGE_X86
+/*
+    AVX2 kernel. Each lane gathers the two words its packed key may span and
+    shifts it out (a shift of 64 gives 0, so keys within one word need no
+    branch). The four deltas are then turned into keys with a prefix sum in
+    the register, carrying the last key over to the next four.
+*/
+__attribute__((target("avx2"))) static void decodeAVX2(const uint64_t *words, long count, long bit_width, long key, long frame, long *keys)
+{
+    const __m256i mask = _mm256_set1_epi64x((1UL << bit_width) - 1);
+    const __m256i frame_vector = _mm256_set1_epi64x(frame);
+    const __m256i lane_offsets = _mm256_setr_epi64x(0, bit_width, 2 * bit_width, 3 * bit_width);
+    const __m256i sixty_three = _mm256_set1_epi64x(63);
+    const __m256i sixty_four = _mm256_set1_epi64x(64);
+    const __m256i zero = _mm256_setzero_si256();
+    const long long *gather_words = reinterpret_cast<const long long *>(words);
+    __m256i carry = _mm256_set1_epi64x(key);
+
+    long i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i bit_offsets = _mm256_add_epi64(_mm256_set1_epi64x(i * bit_width), lane_offsets);
+        __m256i word_indexes = _mm256_srli_epi64(bit_offsets, 6);
+        __m256i shifts = _mm256_and_si256(bit_offsets, sixty_three);
+        __m256i low = _mm256_i64gather_epi64(gather_words, word_indexes, 8);
+        __m256i high = _mm256_i64gather_epi64(gather_words + 1, word_indexes, 8);
+        __m256i deltas = _mm256_or_si256(_mm256_srlv_epi64(low, shifts), _mm256_sllv_epi64(high, _mm256_sub_epi64(sixty_four, shifts)));
+        deltas = _mm256_add_epi64(_mm256_and_si256(deltas, mask), frame_vector);
+
+        // Prefix sum of the four deltas: add the lane one to the left, then the lanes two to the left
+        deltas = _mm256_add_epi64(deltas, _mm256_blend_epi32(_mm256_permute4x64_epi64(deltas, 0x90), zero, 0x03));
+        deltas = _mm256_add_epi64(deltas, _mm256_blend_epi32(_mm256_permute4x64_epi64(deltas, 0x40), zero, 0x0F));
+        __m256i curr_keys = _mm256_add_epi64(deltas, carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(keys + i), curr_keys);
+        carry = _mm256_permute4x64_epi64(curr_keys, 0xFF);
+    }
+
+    // The remaining keys continue from the last key decoded
+    decodeScalarRange(words, i, count - i, bit_width, i > 0 ? keys[i - 1] : key, frame, keys);
+}
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the runtime dispatch and the decoding of a page.
+typedef void (*DecodeFunction)(const uint64_t *, long, long, long, long, long *);
+
+// Implementation of the isPackedDecodeKernelSupported function.
+bool isPackedDecodeKernelSupported(DecodeKernel kernel)
+{
+#ifdef PACKED_PAGE_X86
+    return kernel == DecodeKernel::SCALAR || __builtin_cpu_supports("avx2");
+#else
+    return kernel == DecodeKernel::SCALAR;
+#endif
+}
+
+// Returns the decode function of the given kernel.
+static DecodeFunction getDecodeFunction(DecodeKernel kernel)
+{
+#ifdef PACKED_PAGE_X86
+    if (kernel == DecodeKernel::AVX2)
+    {
+        return decodeAVX2;
+    }
+#endif
+    return decodeScalar;
+}
+
+static DecodeKernel current_kernel = isPackedDecodeKernelSupported(DecodeKernel::AVX2) ? DecodeKernel::AVX2 : DecodeKernel::SCALAR;
+static DecodeFunction decode_function = getDecodeFunction(current_kernel);
+
+// Implementation of the decodePackedKeys function.
+long decodePackedKeys(const char *page, long *keys)
+{
+    const long *longs = reinterpret_cast<const long *>(page);
+    long num_pairs = longs[0];
+    long bit_width = longs[1];
+    long frame = longs[4];
+    if (num_pairs <= 0)
+    {
+        return 0;
+    }
+    keys[0] = longs[2];
+
+    // Evenly spaced keys need no bits at all
+    if (bit_width == 0)
+    {
+        for (long i = 1; i < num_pairs; i++)
+        {
+            keys[i] = keys[i - 1] + frame;
+        }
+        return num_pairs;
+    }
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(longs + PACKED_PAGE_HEADER_LONGS + num_pairs);
+    decode_function(words, num_pairs - 1, bit_width, keys[0], frame, keys + 1);
+    return num_pairs;
+}
+
+/*
+    Returns the position of the key in a packed page (its value is at the same
+    position of getPackedPageValues), or -1 if the key is not in the page.
+*/
+long findPackedKey(const char *page, long key)
+{
+    if (key < getPackedPageFirstKey(page) || key > getPackedPageLastKey(page))
+    {
+        return -1;
+    }
+    long keys[PACKED_PAGE_MAX_PAIRS];
+    long num_pairs = decodePackedKeys(page, keys);
+    long pos = pageLowerBound(keys, num_pairs, 1, key);
+    return pos < num_pairs && keys[pos] == key ? pos : -1;
+}
+
+/*
+    Appends the key-value pairs of a packed page within [key1, key2] to
+    results. Returns false if the page holds a key past key2, so the pages
+    after it need not be read.
+*/
+bool scanPackedPage(const char *page, long key1, long key2, std::vector<std::pair<long, long>> &results)
+{
+    if (getPackedPageLastKey(page) < key1)
+    {
+        return true;
+    }
+    long keys[PACKED_PAGE_MAX_PAIRS];
+    long num_pairs = decodePackedKeys(page, keys);
+    const long *values = getPackedPageValues(page);
+    for (long i = pageLowerBound(keys, num_pairs, 1, key1); i < num_pairs; i++)
+    {
+        if (keys[i] > key2)
+        {
+            return false;
+        }
+        results.emplace_back(keys[i], values[i]);
+    }
+    return true;
+}
+
+// Implementation of the getPackedDecodeKernel function.
+DecodeKernel getPackedDecodeKernel()
+{
+    return current_kernel;
+}
+
+/*
+    Changes the kernel used by decodePackedKeys (e.g. to compare kernels in a
+    benchmark). Returns false and keeps the current kernel if the CPU does not
+    support the given one.
+*/
+bool setPackedDecodeKernel(DecodeKernel kernel)
+{
+    if (!isPackedDecodeKernelSupported(kernel))
+    {
+        return false;
+    }
+    current_kernel = kernel;
+    decode_function = getDecodeFunction(kernel);
+    return true;
+}
+
+// Implementation of the getPackedDecodeKernelName function.
+const char *getPackedDecodeKernelName(DecodeKernel kernel)
+{
+    return kernel == DecodeKernel::AVX2 ? "AVX2" : "Scalar";
+}
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,291 @@
+#include "page_search.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PAGE_SEARCH_X86
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the kernels that count the keys of a window that are smaller than the key (and valid, if SKIPS_NEGATIVE).
+// Implementation of the scalar kernel (for keys of any width).
+template <bool SKIPS_NEGATIVE, typename Key>
+static long countSmallerScalar(const Key *keys, long num_keys, long stride, Key key)
+{
+    long count = 0;
+    for (long i = 0; i < num_keys; i++)
+    {
+        Key curr_key = keys[i * stride];
+        count += (!SKIPS_NEGATIVE || curr_key >= 0) & (curr_key < key);
+    }
+    return count;
+}
+
+#ifdef PAGE_SEARCH_X86
+/*
+    AVX2 kernel. For interleaved pairs, two loads of 4 longs are unpacked into
+    4 keys (in a different order, which does not matter for a count).
+*/
+template <bool SKIPS_NEGATIVE>
+__attribute__((target("avx2"))) static long countSmallerAVX2(const long *keys, long num_keys, long stride, long key)
+{
+    const __m256i key_vector = _mm256_set1_epi64x(key);
+    const __m256i minus_one = _mm256_set1_epi64x(-1);
+    long count = 0;
+    long i = 0;
+    for (; i + 4 <= num_keys; i += 4)
+    {
+        __m256i curr_keys;
+        if (stride == 1)
+        {
+            curr_keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+        }
+        else
+        {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * stride));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * stride + 4));
+            curr_keys = _mm256_unpacklo_epi64(low, high);
+        }
+        __m256i is_smaller = _mm256_cmpgt_epi64(key_vector, curr_keys);
+        if (SKIPS_NEGATIVE)
+        {
+            is_smaller = _mm256_and_si256(is_smaller, _mm256_cmpgt_epi64(curr_keys, minus_one));
+        }
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(is_smaller)));
+    }
+    return count + countSmallerScalar<SKIPS_NEGATIVE>(keys + i * stride, num_keys - i, stride, key);
+}
+
+/*
+    AVX-512 kernel. For interleaved pairs, the value lanes are masked out of
+    the compares, and the tail of the window is read with a masked load.
+*/
+template <bool SKIPS_NEGATIVE>
+__attribute__((target("avx512f"))) static long countSmallerAVX512(const long *keys, long num_keys, long stride, long key)
+{
+    const __m512i key_vector = _mm512_set1_epi64(key);
+    const __m512i zero = _mm512_setzero_si512();
+    const long keys_per_vector = 8 / stride;
+    const __mmask8 key_lanes = stride == 1 ? 0xFF : 0x55;
+    long count = 0;
+    for (long i = 0; i < num_keys; i += keys_per_vector)
+    {
+        long lanes = std::min(keys_per_vector, num_keys - i) * stride;
+        __mmask8 load_mask = lanes >= 8 ? 0xFF : static_cast<__mmask8>((1 << lanes) - 1);
+        __m512i curr_keys = _mm512_maskz_loadu_epi64(load_mask, keys + i * stride);
+        __mmask8 is_valid = SKIPS_NEGATIVE ? _mm512_mask_cmpge_epi64_mask(key_lanes & load_mask, curr_keys, zero) : key_lanes & load_mask;
+        count += __builtin_popcount(_mm512_mask_cmplt_epi64_mask(is_valid, curr_keys, key_vector));
+    }
+    return count;
+}
+
+/*
+    AVX2 kernel for 4-byte keys, which compares 8 keys at once. For interleaved
+    pairs of 4-byte keys and values, the value lanes are masked out of the
+    count.
+*/
+template <bool SKIPS_NEGATIVE>
+__attribute__((target("avx2"))) static long countSmallerAVX2(const int32_t *keys, long num_keys, long stride, int32_t key)
+{
+    const __m256i key_vector = _mm256_set1_epi32(key);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    const long keys_per_vector = 8 / stride;
+    const int key_lanes = stride == 1 ? 0xFF : 0x55;
+    long count = 0;
+    long i = 0;
+    for (; i + keys_per_vector <= num_keys; i += keys_per_vector)
+    {
+        __m256i curr_keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * stride));
+        __m256i is_smaller = _mm256_cmpgt_epi32(key_vector, curr_keys);
+        if (SKIPS_NEGATIVE)
+        {
+            is_smaller = _mm256_and_si256(is_smaller, _mm256_cmpgt_epi32(curr_keys, minus_one));
+        }
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(is_smaller)) & key_lanes);
+    }
+    return count + countSmallerScalar<SKIPS_NEGATIVE>(keys + i * stride, num_keys - i, stride, key);
+}
+
+// AVX-512 kernel for 4-byte keys, which compares 16 keys at once.
+template <bool SKIPS_NEGATIVE>
+__attribute__((target("avx512f"))) static long countSmallerAVX512(const int32_t *keys, long num_keys, long stride, int32_t key)
+{
+    const __m512i key_vector = _mm512_set1_epi32(key);
+    const __m512i zero = _mm512_setzero_si512();
+    const long keys_per_vector = 16 / stride;
+    const __mmask16 key_lanes = stride == 1 ? 0xFFFF : 0x5555;
+    long count = 0;
+    for (long i = 0; i < num_keys; i += keys_per_vector)
+    {
+        long lanes = std::min(keys_per_vector, num_keys - i) * stride;
+        __mmask16 load_mask = lanes >= 16 ? 0xFFFF : static_cast<__mmask16>((1 << lanes) - 1);
+        __m512i curr_keys = _mm512_maskz_loadu_epi32(load_mask, keys + i * stride);
+        __mmask16 is_valid = SKIPS_NEGATIVE ? _mm512_mask_cmpge_epi32_mask(key_lanes & load_mask, curr_keys, zero) : key_lanes & load_mask;
+        count += __builtin_popcount(_mm512_mask_cmplt_epi32_mask(is_valid, curr_keys, key_vector));
+    }
+    return count;
+}
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement the runtime dispatch and the page search.
+typedef long (*CountSmallerFunction)(const long *, long, long, long);
+typedef long (*CountSmallerInt32Function)(const int32_t *, long, long, int32_t);
+
+// Implementation of the isPageSearchKernelSupported function.
+bool isPageSearchKernelSupported(SearchKernel kernel)
+{
+#ifdef PAGE_SEARCH_X86
+    if (kernel == SearchKernel::AVX512)
+    {
+        return __builtin_cpu_supports("avx512f");
+    }
+    if (kernel == SearchKernel::AVX2)
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+    return true;
+#else
+    return kernel == SearchKernel::SCALAR;
+#endif
+}
+
+// Returns the fastest kernel the CPU supports.
+static SearchKernel detectPageSearchKernel()
+{
+    if (isPageSearchKernelSupported(SearchKernel::AVX512))
+    {
+        return SearchKernel::AVX512;
+    }
+    if (isPageSearchKernelSupported(SearchKernel::AVX2))
+    {
+        return SearchKernel::AVX2;
+    }
+    return SearchKernel::SCALAR;
+}
+
+// Returns the count function of the given kernel.
+template <bool SKIPS_NEGATIVE>
+static CountSmallerFunction getCountSmallerFunction(SearchKernel kernel)
+{
+#ifdef PAGE_SEARCH_X86
+    if (kernel == SearchKernel::AVX512)
+    {
+        return countSmallerAVX512<SKIPS_NEGATIVE>;
+    }
+    if (kernel == SearchKernel::AVX2)
+    {
+        return countSmallerAVX2<SKIPS_NEGATIVE>;
+    }
+#endif
+    return countSmallerScalar<SKIPS_NEGATIVE, long>;
+}
+
+// Returns the count function of the given kernel for 4-byte keys.
+template <bool SKIPS_NEGATIVE>
+static CountSmallerInt32Function getCountSmallerInt32Function(SearchKernel kernel)
+{
+#ifdef PAGE_SEARCH_X86
+    if (kernel == SearchKernel::AVX512)
+    {
+        return countSmallerAVX512<SKIPS_NEGATIVE>;
+    }
+    if (kernel == SearchKernel::AVX2)
+    {
+        return countSmallerAVX2<SKIPS_NEGATIVE>;
+    }
+#endif
+    return countSmallerScalar<SKIPS_NEGATIVE, int32_t>;
+}
+
+static SearchKernel current_kernel = detectPageSearchKernel();
+static CountSmallerFunction count_smaller = getCountSmallerFunction<true>(current_kernel);
+static CountSmallerInt32Function count_smaller_int32 = getCountSmallerInt32Function<true>(current_kernel);
+static CountSmallerFunction count_smaller_signed = getCountSmallerFunction<false>(current_kernel);
+static CountSmallerInt32Function count_smaller_signed_int32 = getCountSmallerInt32Function<false>(current_kernel);
+
+/*
+    Halves the range without branches until PAGE_SEARCH_WINDOW keys are left,
+    then counts the rest with the given kernel.
+*/
+template <bool SKIPS_NEGATIVE, typename Key, typename CountFunction>
+static long lowerBound(const Key *keys, long num_keys, long stride, Key key, CountFunction count_function)
+{
+    // Every key before low is smaller than the key (and valid), and the answer is at most low + length
+    long low = 0;
+    long length = num_keys;
+    while (length > PAGE_SEARCH_WINDOW)
+    {
+        long half = length / 2;
+        Key curr_key = keys[(low + half) * stride];
+        bool is_smaller = (!SKIPS_NEGATIVE || curr_key >= 0) & (curr_key < key);
+        low = is_smaller ? low + half + 1 : low;
+        length = is_smaller ? length - half - 1 : half;
+    }
+    return low + count_function(keys + low * stride, length, stride, key);
+}
+
+// Implementation of the pageLowerBound function.
+long pageLowerBound(const long *keys, long num_keys, long stride, long key)
+{
+    return lowerBound<true>(keys, num_keys, stride, key, count_smaller);
+}
+
+// Implementation of the pageLowerBound function for 4-byte keys.
+long pageLowerBound(const int32_t *keys, long num_keys, long stride, int32_t key)
+{
+    return lowerBound<true>(keys, num_keys, stride, key, count_smaller_int32);
+}
+
+// Implementation of the signedPageLowerBound function.
+long signedPageLowerBound(const long *keys, long num_keys, long stride, long key)
+{
+    return lowerBound<false>(keys, num_keys, stride, key, count_smaller_signed);
+}
+
+// Implementation of the signedPageLowerBound function for 4-byte keys.
+long signedPageLowerBound(const int32_t *keys, long num_keys, long stride, int32_t key)
+{
+    return lowerBound<false>(keys, num_keys, stride, key, count_smaller_signed_int32);
+}
+
+// Implementation of the getPageSearchKernel function.
+SearchKernel getPageSearchKernel()
+{
+    return current_kernel;
+}
+
+/*
+    Changes the kernel used by pageLowerBound (e.g. to compare kernels in a
+    benchmark). Returns false and keeps the current kernel if the CPU does not
+    support the given one.
+*/
+bool setPageSearchKernel(SearchKernel kernel)
+{
+    if (!isPageSearchKernelSupported(kernel))
+    {
+        return false;
+    }
+    current_kernel = kernel;
+    count_smaller = getCountSmallerFunction<true>(kernel);
+    count_smaller_int32 = getCountSmallerInt32Function<true>(kernel);
+    count_smaller_signed = getCountSmallerFunction<false>(kernel);
+    count_smaller_signed_int32 = getCountSmallerInt32Function<false>(kernel);
+    return true;
+}
+
+// Implementation of the getPageSearchKernelName function.
+const char *getPageSearchKernelName(SearchKernel kernel)
+{
+    if (kernel == SearchKernel::AVX512)
+    {
+        return "AVX-512";
+    }
+    if (kernel == SearchKernel::AVX2)
+    {
+        return "AVX2";
+    }
+    return "Scalar";
+}
+////////////////////////////////////////////////////////////////////////////
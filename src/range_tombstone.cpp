@@ -0,0 +1,119 @@
+#include "range_tombstone.h"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the RangeTombstones class's public functions.
+/*
+    Inserts [key1, key2] into the sorted ranges, coalescing it with every range
+    it overlaps or touches.
+*/
+void RangeTombstones::add(long key1, long key2)
+{
+    if (key1 > key2)
+    {
+        std::cerr << "Error: Range tombstone has its first key (" << key1 << ") after its last key (" << key2 << ")." << std::endl;
+        return;
+    }
+
+    // Find the first range that ends at or after key1 - 1 (so touching ranges are coalesced too), without computing LONG_MIN - 1
+    auto it = std::lower_bound(ranges.begin(), ranges.end(), key1,
+                               [](const std::pair<long, long> &range, long key)
+                               { return key > LONG_MIN && range.second < key - 1; });
+
+    // Absorb every range that starts at or before key2 + 1, without computing LONG_MAX + 1
+    auto last = it;
+    while (last != ranges.end() && (key2 == LONG_MAX || last->first <= key2 + 1))
+    {
+        key1 = std::min(key1, last->first);
+        key2 = std::max(key2, last->second);
+        ++last;
+    }
+    it = ranges.erase(it, last);
+    ranges.insert(it, {key1, key2});
+}
+
+// Implementation of the merge function.
+void RangeTombstones::merge(const RangeTombstones &other)
+{
+    for (const std::pair<long, long> &range : other.ranges)
+    {
+        add(range.first, range.second);
+    }
+}
+
+// Implementation of the covers function.
+bool RangeTombstones::covers(long key) const
+{
+    // Find the last range that starts at or before key
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), key,
+                               [](long key, const std::pair<long, long> &range)
+                               { return key < range.first; });
+    if (it == ranges.begin())
+    {
+        return false;
+    }
+    --it;
+    return key <= it->second;
+}
+
+// Implementation of the empty function.
+bool RangeTombstones::empty() const
+{
+    return ranges.empty();
+}
+
+// Implementation of the size function.
+size_t RangeTombstones::size() const
+{
+    return ranges.size();
+}
+
+// Implementation of the getRanges function.
+const std::vector<std::pair<long, long>> &RangeTombstones::getRanges() const
+{
+    return ranges;
+}
+
+/*
+    Writes the ranges as consecutive (key1, key2) pairs of longs.
+*/
+bool RangeTombstones::serialize(const std::string &filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out)
+    {
+        std::cerr << "Error: Unable to open range tombstone file for writing - " << filename << std::endl;
+        return false;
+    }
+    for (const std::pair<long, long> &range : ranges)
+    {
+        out.write(reinterpret_cast<const char *>(&range.first), sizeof(long));
+        out.write(reinterpret_cast<const char *>(&range.second), sizeof(long));
+    }
+    return static_cast<bool>(out);
+}
+
+/*
+    Replaces the ranges with the ones in the given file. Returns false if the
+    file does not exist, which is the case for every SST without range tombstones.
+*/
+bool RangeTombstones::loadFromFile(const std::string &filename)
+{
+    ranges.clear();
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    long range[2];
+    while (in.read(reinterpret_cast<char *>(range), sizeof(range)))
+    {
+        add(range[0], range[1]);
+    }
+    return true;
+}
+////////////////////////////////////////////////////////////////////////////
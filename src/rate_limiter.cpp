@@ -0,0 +1,227 @@
+#include "rate_limiter.h"
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the RateLimiter class's constructor.
+RateLimiter::RateLimiter(size_t b_p_s)
+    : bytes_per_second(b_p_s), available_bytes(b_p_s * RATE_LIMITER_BURST_SECONDS),
+      max_burst_bytes(b_p_s * RATE_LIMITER_BURST_SECONDS), last_refill(std::chrono::steady_clock::now()),
+      auto_tune(false), target_latency(0), min_bytes_per_second(b_p_s), max_bytes_per_second(b_p_s),
+      latency_average(0), latency_samples(0), window_start(std::chrono::steady_clock::now()), window_bytes(0),
+      compaction_rate(0), has_full_window(false)
+{
+    for (int i = 0; i < NUM_IO_PRIORITIES; i++)
+    {
+        num_waiting[i] = 0;
+        total_bytes[i] = 0;
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the RateLimiter class's private functions.
+// The caller must hold the mutex for all of these functions.
+// Implementation of the refill function.
+void RateLimiter::refill()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - last_refill;
+    last_refill = now;
+
+    available_bytes = std::min(max_burst_bytes, available_bytes + elapsed.count() * bytes_per_second);
+}
+
+// Implementation of the isHigherPriorityWaiting function.
+bool RateLimiter::isHigherPriorityWaiting(IOPriority priority)
+{
+    for (int i = 0; i < static_cast<int>(priority); i++)
+    {
+        if (num_waiting[i] > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    Closes the compaction throughput window once it is long enough to give a
+    stable measurement. It is also called when the rate is read, so a window
+    without any compaction writes still closes and the rate decays to what was
+    written over the whole window instead of keeping the last busy one.
+*/
+void RateLimiter::closeWindow()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - window_start;
+    if (elapsed.count() >= RATE_LIMITER_WINDOW_SECONDS)
+    {
+        compaction_rate = window_bytes / elapsed.count();
+        has_full_window = true;
+        window_bytes = 0;
+        window_start = now;
+    }
+}
+
+// Implementation of the recordGrant function.
+void RateLimiter::recordGrant(size_t bytes, IOPriority priority)
+{
+    total_bytes[static_cast<int>(priority)] += bytes;
+    if (priority == IOPriority::HIGH)
+    {
+        return;
+    }
+
+    window_bytes += bytes;
+    closeWindow();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the RateLimiter class's public functions.
+/*
+    Blocks until the given number of bytes may be written. Requests are only
+    granted when no request of a higher priority is waiting, so flushes are
+    never stuck behind deep-level compactions. A request larger than the bucket
+    is granted once the bucket is non-empty and leaves the bucket in debt, which
+    later requests then have to wait out. Without a budget (0 bytes per second)
+    every request is granted at once.
+*/
+void RateLimiter::request(size_t bytes, IOPriority priority)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (bytes_per_second <= 0)
+    {
+        recordGrant(bytes, priority);
+        return;
+    }
+    num_waiting[static_cast<int>(priority)]++;
+
+    while (true)
+    {
+        refill();
+        if (bytes_per_second <= 0 || (available_bytes > 0 && !isHigherPriorityWaiting(priority)))
+        {
+            break;
+        }
+
+        // Sleep until the bucket is expected to be non-empty again (or a higher priority request finishes)
+        double wait_seconds = std::max(0.001, (1 - available_bytes) / bytes_per_second);
+        tokens_available.wait_for(lock, std::chrono::duration<double>(wait_seconds));
+    }
+
+    available_bytes -= bytes;
+    num_waiting[static_cast<int>(priority)]--;
+    recordGrant(bytes, priority);
+
+    // Wake up any lower priority requests that were waiting on this one
+    tokens_available.notify_all();
+}
+
+// Implementation of the setBytesPerSecond function.
+void RateLimiter::setBytesPerSecond(size_t b_p_s)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    refill();
+    // A limit set after running without one starts from a full bucket
+    bool had_budget = bytes_per_second > 0;
+    bytes_per_second = b_p_s;
+    max_burst_bytes = b_p_s * RATE_LIMITER_BURST_SECONDS;
+    available_bytes = had_budget ? std::min(available_bytes, max_burst_bytes) : max_burst_bytes;
+    tokens_available.notify_all();
+}
+
+// Implementation of the getBytesPerSecond function.
+size_t RateLimiter::getBytesPerSecond()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes_per_second;
+}
+
+/*
+    Enables auto-tuning: every RATE_LIMITER_TUNE_INTERVAL recorded foreground
+    latencies, the budget shrinks if the average latency is above the target
+    and slowly grows back (up to max_bytes_per_second) once it is well below it.
+    The minimum is at least RATE_LIMITER_MIN_BYTES_PER_SECOND, so shrinking
+    never stalls the writes, and a limiter without a budget is tuned down from
+    max_bytes_per_second.
+*/
+void RateLimiter::enableAutoTune(double target, size_t min_b_p_s, size_t max_b_p_s)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto_tune = true;
+    target_latency = target;
+    min_bytes_per_second = std::max(min_b_p_s, RATE_LIMITER_MIN_BYTES_PER_SECOND);
+    max_bytes_per_second = std::max<double>(min_bytes_per_second, max_b_p_s);
+    latency_average = 0;
+    latency_samples = 0;
+}
+
+// Implementation of the disableAutoTune function.
+void RateLimiter::disableAutoTune()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto_tune = false;
+}
+
+// Implementation of the recordForegroundLatency function.
+void RateLimiter::recordForegroundLatency(double latency)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!auto_tune)
+    {
+        return;
+    }
+
+    latency_average = latency_samples == 0 ? latency : 0.9 * latency_average + 0.1 * latency;
+    latency_samples++;
+    if (latency_samples < RATE_LIMITER_TUNE_INTERVAL)
+    {
+        return;
+    }
+
+    double curr_bytes_per_second = bytes_per_second > 0 ? bytes_per_second : max_bytes_per_second;
+    double new_bytes_per_second = bytes_per_second;
+    if (latency_average > target_latency)
+    {
+        new_bytes_per_second = std::max(min_bytes_per_second, curr_bytes_per_second * 0.75);
+    }
+    else if (latency_average < target_latency / 2 && bytes_per_second > 0)
+    {
+        new_bytes_per_second = std::min(max_bytes_per_second, curr_bytes_per_second * 1.1);
+    }
+
+    refill();
+    bool had_budget = bytes_per_second > 0;
+    bytes_per_second = new_bytes_per_second;
+    max_burst_bytes = new_bytes_per_second * RATE_LIMITER_BURST_SECONDS;
+    available_bytes = had_budget ? std::min(available_bytes, max_burst_bytes) : max_burst_bytes;
+    latency_samples = 0;
+}
+
+/*
+    Returns the compaction bytes per second allowed by the limiter, measured
+    over the last RATE_LIMITER_WINDOW_SECONDS window (or the longer idle time
+    since the last window closed). Before the first window has finished, the
+    rate of the current partial window is returned.
+*/
+double RateLimiter::getCompactionBytesPerSecond()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeWindow();
+    if (has_full_window)
+    {
+        return compaction_rate;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - window_start;
+    return elapsed.count() > 0 ? window_bytes / elapsed.count() : 0;
+}
+
+// Implementation of the getTotalBytes function.
+size_t RateLimiter::getTotalBytes(IOPriority priority)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return total_bytes[static_cast<int>(priority)];
+}
+////////////////////////////////////////////////////////////////////////////
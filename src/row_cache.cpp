@@ -0,0 +1,216 @@
+#include "row_cache.h"
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the RowCache class's constructor.
+RowCache::RowCache(size_t capacity, int num_shards) : capacity(capacity), shards(std::max(num_shards, 1)) {}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the RowCache class's functions.
+// Returns the shard of a key (the key is mixed first, so consecutive keys land in different shards).
+RowCacheShard &RowCache::getShard(long key)
+{
+    uint64_t hash = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+    return shards[(hash >> 32) % shards.size()];
+}
+
+/*
+    Finds the cached result of a get of the key and moves it to the front of
+    the LRU list of its shard. On a miss, the generation of the shard is
+    returned, to be given to insert once the key was searched in the tree.
+*/
+bool RowCache::lookup(long key, long &value, bool &is_found, uint64_t &generation)
+{
+    RowCacheShard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end())
+    {
+        shard.num_misses++;
+        generation = shard.generation;
+        return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    value = it->second->value;
+    is_found = it->second->is_found;
+    shard.num_hits++;
+    return true;
+}
+
+/*
+    Caches the result of a get, evicting the least recently used entries of
+    its shard until it fits. Nothing is cached if a key of the shard was
+    invalidated since the lookup that returned the generation, since the
+    result may predate the write.
+*/
+void RowCache::insert(long key, long value, bool is_found, uint64_t generation)
+{
+    size_t shard_capacity = capacity / shards.size();
+    RowCacheShard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.generation != generation || ROW_CACHE_ENTRY_BYTES > shard_capacity)
+    {
+        return;
+    }
+
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end())
+    {
+        it->second->value = value;
+        it->second->is_found = is_found;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+    while (shard.bytes + ROW_CACHE_ENTRY_BYTES > shard_capacity)
+    {
+        shard.entries.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+        shard.bytes -= ROW_CACHE_ENTRY_BYTES;
+    }
+    shard.lru.push_front({key, value, is_found});
+    shard.entries[key] = shard.lru.begin();
+    shard.bytes += ROW_CACHE_ENTRY_BYTES;
+}
+
+// Implementation of the erase function.
+void RowCache::erase(long key)
+{
+    RowCacheShard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.generation++;
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end())
+    {
+        shard.lru.erase(it->second);
+        shard.entries.erase(it);
+        shard.bytes -= ROW_CACHE_ENTRY_BYTES;
+    }
+}
+
+/*
+    Invalidates every key in [key1, key2]. The keys of a shard are looked up
+    one by one if there are fewer of them than entries in the shard, and the
+    entries of the shard are checked otherwise.
+*/
+void RowCache::eraseRange(long key1, long key2)
+{
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.generation++;
+        unsigned long span = static_cast<unsigned long>(key2) - static_cast<unsigned long>(key1);
+        if (key2 >= key1 && span < shard.entries.size())
+        {
+            for (unsigned long offset = 0; offset <= span; ++offset)
+            {
+                auto it = shard.entries.find(key1 + static_cast<long>(offset));
+                if (it != shard.entries.end())
+                {
+                    shard.lru.erase(it->second);
+                    shard.entries.erase(it);
+                    shard.bytes -= ROW_CACHE_ENTRY_BYTES;
+                }
+            }
+            continue;
+        }
+        for (auto it = shard.lru.begin(); it != shard.lru.end();)
+        {
+            if (it->key < key1 || it->key > key2)
+            {
+                ++it;
+                continue;
+            }
+            shard.entries.erase(it->key);
+            it = shard.lru.erase(it);
+            shard.bytes -= ROW_CACHE_ENTRY_BYTES;
+        }
+    }
+}
+
+// Implementation of the clear function.
+void RowCache::clear()
+{
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.generation++;
+        shard.lru.clear();
+        shard.entries.clear();
+        shard.bytes = 0;
+    }
+}
+
+// Implementation of the getNumEntries function.
+long RowCache::getNumEntries()
+{
+    long num_entries = 0;
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        num_entries += shard.entries.size();
+    }
+    return num_entries;
+}
+
+// Implementation of the getBytes function.
+size_t RowCache::getBytes()
+{
+    size_t bytes = 0;
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        bytes += shard.bytes;
+    }
+    return bytes;
+}
+
+// Implementation of the getCapacity function.
+size_t RowCache::getCapacity()
+{
+    return capacity;
+}
+
+// Implementation of the getNumHits function.
+long RowCache::getNumHits()
+{
+    long num_hits = 0;
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        num_hits += shard.num_hits;
+    }
+    return num_hits;
+}
+
+// Implementation of the getNumMisses function.
+long RowCache::getNumMisses()
+{
+    long num_misses = 0;
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        num_misses += shard.num_misses;
+    }
+    return num_misses;
+}
+
+// Implementation of the getHitRate function.
+double RowCache::getHitRate()
+{
+    long num_hits = getNumHits();
+    long num_lookups = num_hits + getNumMisses();
+    return num_lookups == 0 ? 0 : static_cast<double>(num_hits) / num_lookups;
+}
+
+// Implementation of the resetStats function.
+void RowCache::resetStats()
+{
+    for (RowCacheShard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.num_hits = 0;
+        shard.num_misses = 0;
+    }
+}
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,271 @@
+#include "s_tree.h"
+#include "checksum.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the STree class's constructors and destructor.
+STree::STree() : keys(nullptr), num_keys(0), num_longs(0), height(0), owns_keys(false) {}
+
+// Implementation of the STree copy constructor (blocks that point into a mapping are shared, owned blocks are copied).
+STree::STree(const STree &other) : keys(nullptr), num_keys(0), num_longs(0), height(0), owns_keys(false)
+{
+    *this = other;
+}
+
+// Implementation of the STree copy assignment operator.
+STree &STree::operator=(const STree &other)
+{
+    if (this != &other)
+    {
+        release();
+        if (other.keys != nullptr)
+        {
+            load(other.keys, other.num_keys, other.owns_keys);
+        }
+    }
+    return *this;
+}
+
+// Implementation of the STree destructor.
+STree::~STree()
+{
+    release();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the STree class's private functions.
+// Implementation of the numBlocks function.
+long STree::numBlocks(long n)
+{
+    return (n + S_TREE_BLOCK_KEYS - 1) / S_TREE_BLOCK_KEYS;
+}
+
+// Implementation of the prevKeys function (each block of the layer above separates S_TREE_BLOCK_KEYS + 1 blocks).
+long STree::prevKeys(long n)
+{
+    return (numBlocks(n) + S_TREE_BLOCK_KEYS) / (S_TREE_BLOCK_KEYS + 1) * S_TREE_BLOCK_KEYS;
+}
+
+// Implementation of the computeLayout function.
+void STree::computeLayout()
+{
+    layer_offsets.clear();
+    num_longs = 0;
+    long layer_keys = num_keys;
+    while (true)
+    {
+        layer_offsets.push_back(num_longs);
+        num_longs += numBlocks(layer_keys) * S_TREE_BLOCK_KEYS;
+        if (layer_keys <= static_cast<long>(S_TREE_BLOCK_KEYS))
+        {
+            break;
+        }
+        layer_keys = prevKeys(layer_keys);
+    }
+    height = layer_offsets.size();
+}
+
+/*
+    Counts the keys of the block that are smaller than the key. The loop has a
+    fixed trip count and no branches, so the compiler turns it into SIMD compares.
+*/
+long STree::rank(const long *block, long key)
+{
+    long count = 0;
+    for (size_t i = 0; i < S_TREE_BLOCK_KEYS; i++)
+    {
+        count += block[i] < key;
+    }
+    return count;
+}
+
+// Implementation of the release function.
+void STree::release()
+{
+    if (owns_keys && keys != nullptr)
+    {
+        free(keys);
+    }
+    keys = nullptr;
+    owns_keys = false;
+    num_keys = 0;
+    num_longs = 0;
+    height = 0;
+    layer_offsets.clear();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the STree class's public functions.
+/*
+    Builds the S+-tree from keys sorted in increasing order. Returns false if
+    the blocks could not be allocated.
+*/
+bool STree::build(const std::vector<long> &sorted_keys)
+{
+    release();
+    num_keys = sorted_keys.size();
+    computeLayout();
+
+    void *blocks = nullptr;
+    if (posix_memalign(&blocks, S_TREE_BLOCK_ALIGNMENT, num_longs * sizeof(long)) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the S+-Tree." << std::endl;
+        release();
+        return false;
+    }
+    keys = static_cast<long *>(blocks);
+    owns_keys = true;
+
+    // The bottom layer is the sorted keys padded to whole blocks
+    std::copy(sorted_keys.begin(), sorted_keys.end(), keys);
+    std::fill(keys + num_keys, keys + layer_offsets[0] + numBlocks(num_keys) * S_TREE_BLOCK_KEYS, LONG_MAX);
+
+    // Every key of an upper layer is the smallest key of the subtree right of it, found by going right once and then left to the bottom
+    for (int h = 1; h < height; h++)
+    {
+        long layer_size = (h + 1 < height ? layer_offsets[h + 1] : num_longs) - layer_offsets[h];
+        for (long i = 0; i < layer_size; i++)
+        {
+            long block = i / S_TREE_BLOCK_KEYS;
+            long j = i - block * S_TREE_BLOCK_KEYS;
+            long child = block * (S_TREE_BLOCK_KEYS + 1) + j + 1;
+            for (int l = 0; l < h - 1; l++)
+            {
+                child *= (S_TREE_BLOCK_KEYS + 1);
+            }
+            keys[layer_offsets[h] + i] = child * static_cast<long>(S_TREE_BLOCK_KEYS) < num_keys ? keys[child * S_TREE_BLOCK_KEYS] : LONG_MAX;
+        }
+    }
+    return true;
+}
+
+/*
+    Uses the blocks of an S+-tree of num_keys keys (as written by write). The
+    blocks are copied into aligned memory if copy is true, otherwise they are
+    searched in place (e.g. in a mapping, which keeps them aligned).
+*/
+bool STree::load(const long *blocks, long n, bool copy)
+{
+    release();
+    num_keys = n;
+    computeLayout();
+
+    if (!copy)
+    {
+        keys = const_cast<long *>(blocks);
+        return true;
+    }
+
+    void *copied_blocks = nullptr;
+    if (posix_memalign(&copied_blocks, S_TREE_BLOCK_ALIGNMENT, num_longs * sizeof(long)) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the S+-Tree." << std::endl;
+        release();
+        return false;
+    }
+    std::memcpy(copied_blocks, blocks, num_longs * sizeof(long));
+    keys = static_cast<long *>(copied_blocks);
+    owns_keys = true;
+    return true;
+}
+
+/*
+    Writes a header page (S_TREE_MAGIC, the number of keys, the height and the
+    number of longs) followed by the blocks, one page at a time. The CRC32C of
+    every page is appended to checksums (if given).
+*/
+bool STree::write(int fd, void *buffer, size_t &write_offset, std::vector<uint32_t> *checksums)
+{
+    std::memset(buffer, INTERNAL, PAGE_SIZE);
+    long *header = static_cast<long *>(buffer);
+    header[0] = S_TREE_MAGIC;
+    header[1] = num_keys;
+    header[2] = height;
+    header[3] = num_longs;
+    if (pwrite(fd, buffer, PAGE_SIZE, write_offset) != PAGE_SIZE)
+    {
+        std::cerr << "Error: Incomplete write to disk." << std::endl;
+        return false;
+    }
+    write_offset += PAGE_SIZE;
+    if (checksums)
+    {
+        checksums->push_back(crc32c(buffer, PAGE_SIZE));
+    }
+
+    const long longs_per_page = PAGE_SIZE / sizeof(long);
+    for (long written = 0; written < num_longs; written += longs_per_page)
+    {
+        long longs = std::min(longs_per_page, num_longs - written);
+        std::memset(buffer, INTERNAL, PAGE_SIZE);
+        std::memcpy(buffer, keys + written, longs * sizeof(long));
+        if (pwrite(fd, buffer, PAGE_SIZE, write_offset) != PAGE_SIZE)
+        {
+            std::cerr << "Error: Incomplete write to disk." << std::endl;
+            return false;
+        }
+        write_offset += PAGE_SIZE;
+        if (checksums)
+        {
+            checksums->push_back(crc32c(buffer, PAGE_SIZE));
+        }
+    }
+    return true;
+}
+
+/*
+    Returns the index of the first key that is not smaller than the key, or
+    the number of keys if every key is smaller. Each layer costs one block
+    read, and the block of the next layer is prefetched as soon as it is known.
+*/
+long STree::lowerBound(long key) const
+{
+    if (keys == nullptr || num_keys == 0)
+    {
+        return num_keys;
+    }
+
+    long k = 0;
+    for (int h = height - 1; h > 0; h--)
+    {
+        long i = rank(keys + layer_offsets[h] + k, key);
+        k = k * (S_TREE_BLOCK_KEYS + 1) + i * S_TREE_BLOCK_KEYS;
+        const long *next_block = keys + layer_offsets[h - 1] + k;
+        __builtin_prefetch(next_block);
+        __builtin_prefetch(next_block + S_TREE_BLOCK_ALIGNMENT / sizeof(long));
+    }
+    long index = k + rank(keys + k, key);
+    return std::min(index, num_keys);
+}
+
+// Implementation of the getNumKeys function.
+long STree::getNumKeys() const
+{
+    return num_keys;
+}
+
+// Implementation of the getMemoryBytes function.
+size_t STree::getMemoryBytes() const
+{
+    return num_longs * sizeof(long);
+}
+
+// Implementation of the getNumLongs function.
+long STree::getNumLongs() const
+{
+    return num_longs;
+}
+
+// Implementation of the getHeight function.
+int STree::getHeight() const
+{
+    return height;
+}
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,212 @@
+#include "slotted_page.h"
+#include <cstring>
+
+// Returns the uint32 at an offset of the page.
+static uint32_t readUInt32(const char *page, size_t offset)
+{
+    uint32_t value;
+    std::memcpy(&value, page + offset, sizeof(value));
+    return value;
+}
+
+// Writes a uint32 at an offset of the page.
+static void writeUInt32(char *page, size_t offset, uint32_t value)
+{
+    std::memcpy(page + offset, &value, sizeof(value));
+}
+
+// Returns the number of value bytes of a record from its value_length.
+static uint32_t getValueBytes(uint32_t value_length)
+{
+    return value_length == SLOTTED_TOMBSTONE_LENGTH ? 0 : (value_length & ~SLOTTED_VALUE_POINTER_FLAG);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Define the SlottedPageBuilder class's constructor.
+SlottedPageBuilder::SlottedPageBuilder(size_t page_size) : page(page_size), page_size(page_size)
+{
+    clear();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the SlottedPageBuilder class's functions.
+/*
+    Adds a key-value pair (or a tombstone for the key, whose value is ignored)
+    to the page. A value that is a pointer into the value log is flagged as
+    one. Keys must be strictly increasing. Returns false (and leaves the page
+    unchanged) if the pair does not fit in the space left.
+*/
+bool SlottedPageBuilder::add(std::string_view key, std::string_view value, bool is_tombstone, bool is_pointer)
+{
+    size_t value_length = is_tombstone ? 0 : value.size();
+    size_t record_bytes = SLOTTED_RECORD_HEADER_SIZE + key.size() + value_length;
+    if (SLOTTED_SLOT_SIZE + record_bytes > getFreeBytes())
+    {
+        return false;
+    }
+
+    records_start -= record_bytes;
+    writeUInt32(page.data(), records_start, key.size());
+    writeUInt32(page.data(), records_start + sizeof(uint32_t), is_tombstone ? SLOTTED_TOMBSTONE_LENGTH : (value_length | (is_pointer ? SLOTTED_VALUE_POINTER_FLAG : 0)));
+    std::memcpy(page.data() + records_start + SLOTTED_RECORD_HEADER_SIZE, key.data(), key.size());
+    std::memcpy(page.data() + records_start + SLOTTED_RECORD_HEADER_SIZE + key.size(), value.data(), value_length);
+    writeUInt32(page.data(), SLOTTED_PAGE_HEADER_SIZE + num_slots * SLOTTED_SLOT_SIZE, records_start);
+
+    if (num_slots == 0)
+    {
+        first_key = key;
+    }
+    last_key = key;
+    num_slots++;
+    return true;
+}
+
+// Implementation of the write function.
+void SlottedPageBuilder::write(void *page) const
+{
+    char *bytes = static_cast<char *>(page);
+    std::memcpy(bytes, this->page.data(), page_size);
+    writeUInt32(bytes, 0, num_slots);
+    writeUInt32(bytes, sizeof(uint32_t), records_start);
+}
+
+// Implementation of the clear function.
+void SlottedPageBuilder::clear()
+{
+    std::memset(page.data(), 0, page_size);
+    num_slots = 0;
+    records_start = page_size;
+    first_key.clear();
+    last_key.clear();
+}
+
+// Implementation of the empty function.
+bool SlottedPageBuilder::empty() const
+{
+    return num_slots == 0;
+}
+
+// Implementation of the size function.
+long SlottedPageBuilder::size() const
+{
+    return num_slots;
+}
+
+// Implementation of the getFreeBytes function.
+size_t SlottedPageBuilder::getFreeBytes() const
+{
+    return records_start - SLOTTED_PAGE_HEADER_SIZE - num_slots * SLOTTED_SLOT_SIZE;
+}
+
+// Implementation of the getFirstKey function.
+const std::string &SlottedPageBuilder::getFirstKey() const
+{
+    return first_key;
+}
+
+// Implementation of the getLastKey function.
+const std::string &SlottedPageBuilder::getLastKey() const
+{
+    return last_key;
+}
+////////////////////////////////////////////////////////////////////////////
+
+// Returns the number of bytes of a page (slot and record) taken by a key-value pair.
+size_t getSlottedRecordBytes(size_t key_length, size_t value_length)
+{
+    return SLOTTED_SLOT_SIZE + SLOTTED_RECORD_HEADER_SIZE + key_length + value_length;
+}
+
+// Returns the number of key-value pairs in a slotted page.
+long getSlottedPageNumSlots(const char *page)
+{
+    return readUInt32(page, 0);
+}
+
+// Returns the key of a slot of a slotted page, in place.
+std::string_view getSlottedKey(const char *page, long slot)
+{
+    uint32_t offset = readUInt32(page, SLOTTED_PAGE_HEADER_SIZE + slot * SLOTTED_SLOT_SIZE);
+    return std::string_view(page + offset + SLOTTED_RECORD_HEADER_SIZE, readUInt32(page, offset));
+}
+
+// Returns the value of a slot of a slotted page, in place (empty for a tombstone).
+std::string_view getSlottedValue(const char *page, long slot)
+{
+    uint32_t offset = readUInt32(page, SLOTTED_PAGE_HEADER_SIZE + slot * SLOTTED_SLOT_SIZE);
+    uint32_t key_length = readUInt32(page, offset);
+    uint32_t value_length = readUInt32(page, offset + sizeof(uint32_t));
+    return std::string_view(page + offset + SLOTTED_RECORD_HEADER_SIZE + key_length, getValueBytes(value_length));
+}
+
+// Returns whether a slot of a slotted page is a tombstone.
+bool isSlottedTombstone(const char *page, long slot)
+{
+    uint32_t offset = readUInt32(page, SLOTTED_PAGE_HEADER_SIZE + slot * SLOTTED_SLOT_SIZE);
+    return readUInt32(page, offset + sizeof(uint32_t)) == SLOTTED_TOMBSTONE_LENGTH;
+}
+
+// Returns whether the value of a slot of a slotted page is a pointer into the value log.
+bool isSlottedPointer(const char *page, long slot)
+{
+    uint32_t offset = readUInt32(page, SLOTTED_PAGE_HEADER_SIZE + slot * SLOTTED_SLOT_SIZE);
+    uint32_t value_length = readUInt32(page, offset + sizeof(uint32_t));
+    return value_length != SLOTTED_TOMBSTONE_LENGTH && (value_length & SLOTTED_VALUE_POINTER_FLAG) != 0;
+}
+
+/*
+    Returns the first slot of a slotted page whose key is not smaller than key
+    (the number of slots if every key is smaller), with a binary search over
+    the slots.
+*/
+long slottedLowerBound(const char *page, std::string_view key)
+{
+    long low = 0;
+    long high = getSlottedPageNumSlots(page);
+    while (low < high)
+    {
+        long mid = low + (high - low) / 2;
+        if (getSlottedKey(page, mid) < key)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/*
+    Returns whether every slot and record of a page (of page_size bytes) read
+    from disk lies inside the page, so a corrupted or foreign page is never
+    read past its end.
+*/
+bool isSlottedPageValid(const char *page, size_t page_size)
+{
+    uint32_t num_slots = readUInt32(page, 0);
+    uint32_t records_start = readUInt32(page, sizeof(uint32_t));
+    if (records_start > page_size || num_slots > (page_size - SLOTTED_PAGE_HEADER_SIZE) / SLOTTED_SLOT_SIZE ||
+        SLOTTED_PAGE_HEADER_SIZE + num_slots * SLOTTED_SLOT_SIZE > records_start)
+    {
+        return false;
+    }
+    for (uint32_t slot = 0; slot < num_slots; ++slot)
+    {
+        uint32_t offset = readUInt32(page, SLOTTED_PAGE_HEADER_SIZE + slot * SLOTTED_SLOT_SIZE);
+        if (offset < records_start || offset + SLOTTED_RECORD_HEADER_SIZE > page_size)
+        {
+            return false;
+        }
+        uint64_t key_length = readUInt32(page, offset);
+        uint32_t value_length = readUInt32(page, offset + sizeof(uint32_t));
+        uint64_t record_bytes = SLOTTED_RECORD_HEADER_SIZE + key_length + getValueBytes(value_length);
+        if (offset + record_bytes > page_size)
+        {
+            return false;
+        }
+    }
+    return true;
+}
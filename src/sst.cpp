@@ -1,5 +1,10 @@
 #include "sst.h"
+#include "page_search.h"
 #include "bloom_filter.h"
+#include "checksum.h"
+
+// Number of pages read by gets since the last resetPageReads
+static std::atomic<long> page_reads(0);
 ////////////////////////////////////////////////////////////////////////////
 /*
     Writes a given memtable to a sorted string table (SST), into a file with the
@@ -29,23 +34,27 @@ std::string getCurrentTimestamp()
     std::tm local_time;
     localtime_r(&now_time_t, &local_time);
 
+    // Sequence number so that files created within the same millisecond (e.g. a flush immediately followed by a merge) never share a name
+    static std::atomic<unsigned long> sequence(0);
+
     // Format the time into a string
     std::ostringstream oss;
-    oss << std::put_time(&local_time, "%Y%m%d_%H%M%S") << "_" << std::setfill('0') << std::setw(3) << now_ms.count();
+    oss << std::put_time(&local_time, "%Y%m%d_%H%M%S") << "_" << std::setfill('0') << std::setw(3) << now_ms.count()
+        << "_" << std::setw(6) << (sequence++ % 1000000);
     return oss.str();
 }
 
-std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string database_name)
+std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string database_name, RateLimiter *rate_limiter, SSTMetadata *metadata, PageEncoding encoding,
+                                                        CompressionType compression, size_t page_size)
 {
     std::string string_time_now = getCurrentTimestamp();
 
     std::string sst_filename = DATA_FILE_PATH + database_name + "/sst_" + string_time_now + ".bin";
-    std::string btree_filename = DATA_FILE_PATH + database_name + "/btree_" + string_time_now + ".bin";
-    std::string bloom_filename = DATA_FILE_PATH + database_name + "/bloom_" + string_time_now + ".bin";
 
     last_known_database = database_name;
 
-    return writeMemtableToDisk(memtable, sst_filename, btree_filename, bloom_filename, database_name);
+    // The B-Tree and the Bloom filter are written into the SST file
+    return writeMemtableToDisk(memtable, sst_filename, sst_filename, sst_filename, database_name, rate_limiter, metadata, encoding, compression, page_size);
 }
 
 /*
@@ -58,224 +67,113 @@ std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std:
     This function assumes that the memtable is ready to be written to a sorted
     file (i.e. The memtable has reached its max capacity OR database closing.)
 */
-std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string sst_filename, std::string btree_filename, std::string bloom_filename, std::string database_name)
+std::pair<std::string, std::string> writeMemtableToDisk(Memtable *memtable, std::string sst_filename, std::string btree_filename, std::string bloom_filename, std::string /* database_name */,
+                                                        RateLimiter *rate_limiter, SSTMetadata *metadata, PageEncoding encoding, CompressionType compression,
+                                                        size_t page_size)
 {
-    // Get all key-value pairs in the memtable.
-    // Initialize Bloom filter
-    size_t bloom_size = 2400; // Example size (can be tuned based on expected key count)
-    int num_hashes = 3;       // Number of hash functions
-    BloomFilter bloom_filter(bloom_size, num_hashes);
-
     // Get all key value pairs in memtable.
     std::pair<std::pair<long, long> *, int> pair_array_size = memtable->scan(LONG_MIN, LONG_MAX);
     std::pair<long, long> *key_value_pairs = pair_array_size.first;
     int size = pair_array_size.second;
 
-    // Open the SST file for writing with Direct I/O
-    int sst_fd = open(sst_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
-    if (sst_fd < 0)
-    {
-        std::cerr << "Write memtable Error: Failed to open SST file for writing." << std::endl;
-        return {sst_filename, btree_filename};
-    }
-
-    // Open B-Tree file for writing with Direct I/O
-    int btree_fd = open(btree_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
-    if (btree_fd < 0)
-    {
-        std::cerr << "Error: Failed to open B-Tree file for writing." << std::endl;
-        return {sst_filename, btree_filename};
-    }
-
-    // Alignment and buffer size requirements for Direct I/O
-    const size_t buffer_size = PAGE_SIZE;
-
-    // Create the buffer to write to for the SST
-    void *sst_buffer;
-    if (posix_memalign(&sst_buffer, PAGE_SIZE, buffer_size) != 0)
-    {
-        std::cerr << "Error: Memory alignment allocation failed for the SST Buffer." << std::endl;
-        close(sst_fd);
-        return {sst_filename, btree_filename};
-    }
-    std::memset(sst_buffer, INTERNAL, buffer_size);
-
-    // Create the buffer to write to for the B-Tree
-    void *btree_buffer;
-    if (posix_memalign(&btree_buffer, PAGE_SIZE, buffer_size) != 0)
+    // Flushes block puts, so they are given the highest priority by the rate limiter
+    SSTWriter writer(sst_filename, btree_filename, bloom_filename, rate_limiter, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, encoding, compression, page_size);
+    if (!writer.isOpen())
     {
-        std::cerr << "Error: Memory alignment allocation failed for the B-Tree Buffer." << std::endl;
-        close(btree_fd);
+        delete[] key_value_pairs;
         return {sst_filename, btree_filename};
     }
 
-    // Offsets for writing the SST
-    size_t sst_write_offset = 0;
-    size_t sst_buffer_offset = 0;
-
-    // Variables to create the B-Tree and write it to disk
-    StaticBTree btree(sst_filename, btree_filename);
-    size_t btree_write_offset = 0;
-
-    // Variables to create the B-Tree
-    int leaf_node_pairs_written = 0;
-    long curr_page = 0;
-    long final_key_added;
-    int leaf_nodes_written = 0;
-
     // Write key-value pairs to the SST file
     for (int i = 0; i < size; ++i)
     {
-        long key = key_value_pairs[i].first;
-        long value = key_value_pairs[i].second;
-
-        bloom_filter.put(std::to_string(key));
-
-        // Copy the key and value into the aligned buffer at the current buffer offset
-        std::memcpy(static_cast<char *>(sst_buffer) + sst_buffer_offset, &key, sizeof(key));
-        sst_buffer_offset += sizeof(key);
-        std::memcpy(static_cast<char *>(sst_buffer) + sst_buffer_offset, &value, sizeof(value));
-        sst_buffer_offset += sizeof(value);
-
-        // If the buffer is full, write it to the SST file
-        if (sst_buffer_offset + ENTRY_SIZE > buffer_size)
-        {
-            ssize_t bytes_written = pwrite(sst_fd, sst_buffer, buffer_size, sst_write_offset);
-            if (bytes_written != buffer_size)
-            {
-                std::cerr << "Error: Incomplete write for key-value pairs batch." << std::endl;
-                break;
-            }
-            sst_write_offset += bytes_written;
-            sst_buffer_offset = 0;                             // Reset the buffer for the next batch
-            std::memset(sst_buffer, INTERNAL, buffer_size); // Clear the buffer
-        }
-
-        // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
-        leaf_node_pairs_written++;
-        final_key_added = key;
-
-        // When a Leaf Node is full, i.e., when leaf_node_pairs_written is equal to MAX_PAIRS, add the most recently added key (the max key in the Leaf Node) to max_keys_in_leaves and reset both leaf_node_pairs_written and write_leaf_node
-        if (leaf_node_pairs_written == MAX_PAIRS)
+        if (!writer.put(key_value_pairs[i].first, key_value_pairs[i].second))
         {
-            curr_page++;
-            btree.insertInternalNode(key, curr_page);
-            leaf_node_pairs_written = 0;
-            leaf_nodes_written++;
+            break;
         }
     }
+    delete[] key_value_pairs;
 
-    // After processing all key-value pairs, check if there is remaining data in the buffer
-    if (sst_buffer_offset > 0)
+    // Keep the deleted key ranges so that they still hide the older SSTs
+    for (const std::pair<long, long> &range : memtable->getRangeTombstones().getRanges())
     {
-        // Pad the remaining buffer space with -1
-        std::memset(static_cast<char *>(sst_buffer) + sst_buffer_offset, INTERNAL, buffer_size - sst_buffer_offset);
-
-        if (sst_buffer_offset % PAGE_SIZE != 0) {
-            // Set the last long in the buffer to LEAF
-            long *buffer_as_longs = static_cast<long *>(sst_buffer);
-            int total_longs_in_buffer = buffer_size / sizeof(long);
-            buffer_as_longs[total_longs_in_buffer - 2] = LEAF;
-        }
-
-        // Write the padded buffer to the SST file
-        ssize_t bytes_written = pwrite(sst_fd, sst_buffer, buffer_size, sst_write_offset);
-        if (bytes_written != buffer_size)
-        {
-            std::cerr << "Error: Incomplete write for final buffer." << std::endl;
-        }
-        sst_write_offset += bytes_written;
-
-        curr_page++;
-        btree.insertInternalNode(final_key_added, curr_page);
+        writer.putRangeTombstone(range.first, range.second);
     }
 
-    // Clean up SST resources
-    free(sst_buffer);
-    close(sst_fd);
-
-    // Finalize the B-Tree and write Internal Nodes to the B-Tree file
-    if (btree.getNodes().size() > 0 && leaf_nodes_written > 1)
+    // Write the final page, the B-Tree, the Bloom filter and the range tombstones
+    writer.finish();
+    if (metadata != nullptr)
     {
-        btree.finalizeTree();
-        btree.writeNodes(btree_fd, btree_buffer, btree_write_offset);
+        *metadata = writer.getMetadata();
     }
 
-    // Clean up B-Tree resources
-    free(btree_buffer);
-    close(btree_fd);
-
     // Return the SST and B-Tree filenames
-    // Serialize the Bloom filter to a separate file
-    bloom_filter.serialize(bloom_filename);
-
     return {sst_filename, btree_filename};
 }
 
 ////////////////////////////////////////////////////////////////////////////
-NodeFileOffset *binarySearch(const std::string sst_filename, long key, BufferPool *buffer_pool)
+static const char *readSSTPage(const std::string &sst_filename, long page_index, char *page_buffer, BufferPool *buffer_pool, MappedFile *sst_map, const SSTFooter &footer);
+static NodeFileOffset *pageBinarySearch(const std::string &sst_filename, const SSTFooter &footer, long key, BufferPool *buffer_pool, MappedFile *sst_map);
+static std::vector<std::pair<long, long>> pageBinarySearchScan(const std::string &sst_filename, const SSTFooter &footer, long key1, long key2, BufferPool *buffer_pool, MappedFile *sst_map);
+
+NodeFileOffset *binarySearch(const std::string sst_filename, long key, BufferPool *buffer_pool, MappedFile *sst_map, const SSTFooter *footer)
 {
-    int fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT, 0666);
-    if (fd < 0)
+    // The footer of a single-file SST gives the number of key-value pairs, otherwise it is estimated from the file size
+    SSTFooter file_footer;
+    if (footer == nullptr)
     {
-        std::cerr << "Error: Unable to open SST file " << sst_filename << std::endl;
-        return nullptr;
+        readSSTFooter(sst_filename, file_footer, sst_map);
+        footer = &file_footer;
     }
-    // Get the file size
-    off_t file_size = lseek(fd, 0, SEEK_END);
-    long entries = file_size / ENTRY_SIZE;
+    if (footer->isPacked() || footer->isColumnar() || footer->isCompressed())
+    {
+        return pageBinarySearch(sst_filename, *footer, key, buffer_pool, sst_map);
+    }
+
+    // A mapped SST file is searched in place, otherwise its pages are read through the buffer pool
+    long entries = footer->num_entries;
+    if (!footer->isSingleFile())
+    {
+        std::error_code error;
+        off_t file_size = sst_map != nullptr ? sst_map->getSize() : static_cast<off_t>(std::filesystem::file_size(sst_filename, error));
+        if (error)
+        {
+            std::cerr << "Error: Unable to open SST file " << sst_filename << std::endl;
+            return nullptr;
+        }
+        entries = file_size / ENTRY_SIZE;
+    }
+    long page_pairs = footer->getPagePairs();
 
     long start = 0;
     long end = entries - 1;
 
-    // Page buffer to store key-value pairs during each read
-    char page_buffer[PAGE_SIZE];
-    // Initialize buffer to INTERNAL values
-    std::memset(page_buffer, INTERNAL, PAGE_SIZE);
+    // Page buffer to store key-value pairs during each read (a page of the data block takes up to MAX_PAGE_SIZE bytes)
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
 
     while (start <= end)
     {
         long mid = start + (end - start) / 2;
 
-        // off_t page_offset = (mid * ENTRY_SIZE / PAGE_SIZE) * PAGE_SIZE;
-        off_t page_offset = (mid / (PAGE_SIZE / ENTRY_SIZE)) * PAGE_SIZE;
-
-        size_t entries_page;
-        // First check if the  page is already in buffer pool
-        std::string filename_offset = sst_filename + std::to_string(page_offset);
-
-        Page *possible_page = buffer_pool->searchForPage(filename_offset);
-        if (possible_page != nullptr)
-        {
-            // If the page is in the buffer pool then we get the page from the buffer pool.
-            std::memcpy(page_buffer, possible_page->data, PAGE_SIZE);
-            entries_page = PAGE_SIZE / ENTRY_SIZE;
-        }
-        else
+        long page_index = mid / page_pairs;
+        off_t page_offset = footer->data_offset + page_index * footer->page_size;
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, *footer);
+        if (page_data == nullptr)
         {
-            // Use pread to read one page starting from page_offset
-            ssize_t read_page = pread(fd, page_buffer, PAGE_SIZE, page_offset);
-            if (read_page < 0)
-            {
-                std::cerr << "Error: Failed to read page in SST file " << sst_filename << std::endl;
-                close(fd);
-                return nullptr;
-            }
-            // Determine the number of entries in the page
-            entries_page = read_page / ENTRY_SIZE;
-            // Store page in buffer
-            Page *page = new Page(sst_filename + std::to_string(page_offset), page_buffer);
-            buffer_pool->insertPage(page);
+            return nullptr;
         }
 
+        // The footer gives the number of key-value pairs in the page, so the padding of the last page is never scanned
+        size_t entries_page = footer->isSingleFile() ? footer->getEntriesInPage(page_index) : page_pairs;
+
         // Determine if the input key exists in this page by comparing it to the smallest and largest keys in it
         long smallest_key = 0, largest_key = 0;
-        std::memcpy(&smallest_key, page_buffer, sizeof(long));                                   // First key
-        std::memcpy(&largest_key, page_buffer + ((entries_page - 1) * ENTRY_SIZE), sizeof(long)); // Last key
+        std::memcpy(&smallest_key, page_data, sizeof(long));                                   // First key
+        std::memcpy(&largest_key, page_data + ((entries_page - 1) * ENTRY_SIZE), sizeof(long)); // Last key
 
 
         if (largest_key < 0) {
-            char *curr_offset = page_buffer;
+            const char *curr_offset = page_data;
             // Go through the key-value pairs in the page.
             for (size_t i = 0; i < entries_page; i++)
             {
@@ -288,7 +186,6 @@ NodeFileOffset *binarySearch(const std::string sst_filename, long key, BufferPoo
 
                 if (curr_key == key)
                 {
-                    close(fd);
                     NodeFileOffset *ret = new NodeFileOffset(new Node(curr_key, curr_val), sst_filename, page_offset);
                     return ret; // Key found, return node
                 }
@@ -318,204 +215,722 @@ NodeFileOffset *binarySearch(const std::string sst_filename, long key, BufferPoo
         }
         else
         {
-            int left = 0;
-            int right = entries_page - 1;
-            while (left <= right) 
+            // Find the first key that is not smaller than the key with the SIMD page search
+            long pos = pageLowerBound(reinterpret_cast<const long *>(page_data), entries_page, 2, key);
+            if (pos < static_cast<long>(entries_page))
             {
-                int mid = left + (right - left) / 2;
-                char *curr_offset = page_buffer + mid * ENTRY_SIZE;
-                long key_at_mid;
-                memcpy(&key_at_mid, curr_offset, sizeof(long));
-
-                if (key_at_mid >= smallest_key && key_at_mid <= largest_key) 
-                { // Valid key
-                    if (key_at_mid == key) 
-                    {
-                        long val_at_mid;
-                        memcpy(&val_at_mid, curr_offset + sizeof(long), sizeof(long));
-                        close(fd);
-                        NodeFileOffset *ret = new NodeFileOffset(new Node(key_at_mid, val_at_mid), sst_filename, page_offset);
-                        return ret; // Key found, return node
-                    } 
-                    else if (key_at_mid < key) 
-                    {
-                        left = mid + 1; // Search in the right half
-                    } 
-                    else 
-                    {
-                        right = mid - 1; // Search in the left half
-                    }
-                } 
-                else if (mid == MAX_PAIRS - 1 && key_at_mid < 0) 
+                const char *curr_offset = page_data + pos * ENTRY_SIZE;
+                long key_at_pos;
+                memcpy(&key_at_pos, curr_offset, sizeof(long));
+                if (key_at_pos == key)
                 {
-                    // If key is greater than all valid keys, direct to the last child
-                    long val_at_mid;
-                    memcpy(&val_at_mid, curr_offset + sizeof(long), sizeof(long));
-                    close(fd);
-                    NodeFileOffset *ret = new NodeFileOffset(new Node(key_at_mid, val_at_mid), sst_filename, page_offset);
+                    long val_at_pos;
+                    memcpy(&val_at_pos, curr_offset + sizeof(long), sizeof(long));
+                    NodeFileOffset *ret = new NodeFileOffset(new Node(key_at_pos, val_at_pos), sst_filename, page_offset);
                     return ret; // Key found, return node
                 }
             }
 
             std::cerr << "Error: Failed to find key in this SST. " << std::endl;
-            close(fd);
             return nullptr;
         }
     }
 
-    close(fd);
     return nullptr; // Key not found
 }
 
-std::vector<std::pair<long, long>> binarySearchScan(const std::string sst_filename, long key1, long key2, BufferPool *buffer_pool)
+/*
+    Returns a page of the data block of a compressed SST. The decompressed page
+    is cached in the buffer pool (apart from the pages of the file, as it is
+    not one of them), so later reads neither read nor decompress it again.
+    Otherwise the compressed page is read in place from the mapping, or from
+    the one or two pages of the file holding it, which are checked against
+    their checksums, and decompressed into page_buffer. Returns nullptr if the
+    page could not be read or decompressed.
+*/
+const char *readCompressedSSTPage(const std::string &sst_filename, const SSTFooter &footer, long page_index, char *page_buffer, BufferPool *buffer_pool, MappedFile *sst_map)
 {
-    int fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT, 0666);
-    if (fd < 0)
+    std::string page_id = sst_filename + "#" + std::to_string(page_index);
+    Page *cached_page = buffer_pool != nullptr ? buffer_pool->searchForPage(page_id) : nullptr;
+    if (cached_page != nullptr)
     {
-        std::cerr << "Error: Unable to open SST file " << sst_filename << std::endl;
-        return {};
+        return cached_page->data;
     }
 
-    off_t file_size = lseek(fd, 0, SEEK_END);
-    long total_entries = file_size / ENTRY_SIZE;
-
-    long start = 0;
-    long end = total_entries - 1;
-
-    char page_buffer[PAGE_SIZE];
-    std::memset(page_buffer, INTERNAL, PAGE_SIZE);
-
-    long first_in_range = -1; // Index of the first key in range
-    std::vector<std::pair<long, long>> results;
-
-    // Step 1: Use binary search to find the first key within the range
-    while (start <= end)
+    const BlockCodec *codec = getBlockCodec(footer.compression);
+    if (codec == nullptr)
     {
-        long mid = start + (end - start) / 2;
-        off_t page_offset = (mid * ENTRY_SIZE / PAGE_SIZE) * PAGE_SIZE;
-
-        Page *cached_page = buffer_pool->searchForPage(sst_filename + std::to_string(page_offset));
-        if (cached_page != nullptr)
+        std::cerr << "Error: SST file " << sst_filename << " is compressed with " << getCompressionName(footer.compression) << ", which was not built in." << std::endl;
+        return nullptr;
+    }
+    if (page_index < 0 || page_index >= footer.getNumDataPages())
+    {
+        std::cerr << "Error: Page " << page_index << " is not in the data block of SST file " << sst_filename << std::endl;
+        return nullptr;
+    }
+    long offset = footer.data_offset + footer.getBlockOffset(page_index);
+    long size = footer.getBlockSize(page_index);
+    long first_page = offset / PAGE_SIZE;
+    size_t num_bytes = ((offset + size + PAGE_SIZE - 1) / PAGE_SIZE - first_page) * PAGE_SIZE;
+
+    const char *block = nullptr;
+    alignas(PAGE_SIZE) char file_pages[2 * PAGE_SIZE];
+    if (sst_map != nullptr)
+    {
+        if (sst_map->getSize() < first_page * PAGE_SIZE + num_bytes || !isPageIntact(sst_filename, first_page, sst_map->getData() + first_page * PAGE_SIZE, true, num_bytes))
         {
-            std::memcpy(page_buffer, cached_page->data, PAGE_SIZE);
+            std::cerr << "Error: Failed to read page in SST file " << sst_filename << std::endl;
+            return nullptr;
         }
-        else
+        block = sst_map->getData() + offset;
+    }
+    else
+    {
+        int fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT, 0666);
+        if (fd < 0)
         {
-            ssize_t bytes_read = pread(fd, page_buffer, PAGE_SIZE, page_offset);
-            if (bytes_read < 0)
-            {
-                std::cerr << "Error: Failed to read SST file " << sst_filename << std::endl;
-                close(fd);
-                return {};
-            }
-            Page *new_page = new Page(sst_filename + std::to_string(page_offset), page_buffer);
-            buffer_pool->insertPage(new_page);
+            std::cerr << "Error: Unable to open SST file " << sst_filename << std::endl;
+            return nullptr;
         }
-
-        char *current_offset = page_buffer;
-        size_t entries_per_page = PAGE_SIZE / ENTRY_SIZE;
-
-        for (size_t i = 0; i < entries_per_page; i++)
+        ssize_t bytes_read = pread(fd, file_pages, num_bytes, first_page * PAGE_SIZE);
+        close(fd);
+        if (bytes_read != static_cast<ssize_t>(num_bytes) || !isPageIntact(sst_filename, first_page, file_pages, false, num_bytes))
         {
-            long current_key;
-            memcpy(&current_key, current_offset, sizeof(long));
-            current_offset += sizeof(long);
-
-            if (current_key < 0)
-                break;
+            std::cerr << "Error: Failed to read page in SST file " << sst_filename << std::endl;
+            return nullptr;
+        }
+        block = file_pages + (offset - first_page * PAGE_SIZE);
+    }
 
-            if (current_key >= key1)
-            {
-                first_in_range = mid; // First key in range found
-                end = mid - 1;      // Narrow search for the lower bound
-                break;
-            }
+    // A page that did not shrink was stored as it is
+    if (size == PAGE_SIZE)
+    {
+        std::memcpy(page_buffer, block, PAGE_SIZE);
+    }
+    else if (!codec->decompress(block, size, page_buffer, PAGE_SIZE))
+    {
+        std::cerr << "Error: Failed to decompress page " << page_index << " of SST file " << sst_filename << std::endl;
+        return nullptr;
+    }
+    if (buffer_pool != nullptr)
+    {
+        buffer_pool->insertPage(new Page(page_id, page_buffer));
+    }
+    return page_buffer;
+}
 
-            if (i == entries_per_page - 1)
-                start = mid + 1;
+/*
+    Returns a page of the data block of an SST, read in place from the mapping
+    or the buffer pool when possible, otherwise read from the file into
+    page_buffer (and added to the buffer pool). A page takes footer.page_size
+    bytes, so a page larger than PAGE_SIZE is cached as PAGE_SIZE frames (with
+    the ids of the pages of the file they hold), like the pages of a
+    byte-string SST, and is read from the file unless every frame is cached.
+    The pages of a compressed SST are decompressed. page_buffer must hold
+    footer.page_size bytes. Returns nullptr if the page could not be read.
+*/
+const char *readSSTDataPage(const std::string &sst_filename, const SSTFooter &footer, long page_index, char *page_buffer, BufferPool *buffer_pool, MappedFile *sst_map)
+{
+    if (footer.isCompressed())
+    {
+        return readCompressedSSTPage(sst_filename, footer, page_index, page_buffer, buffer_pool, sst_map);
+    }
+    size_t page_size = footer.page_size;
+    off_t page_offset = footer.data_offset + page_index * page_size;
+    long first_frame = page_offset / PAGE_SIZE;
+    long num_frames = page_size / PAGE_SIZE;
+    if (sst_map != nullptr)
+    {
+        if (page_index < 0 || sst_map->getSize() < page_offset + page_size)
+        {
+            std::cerr << "Error: Failed to read page in SST file " << sst_filename << std::endl;
+            return nullptr;
         }
+        const char *page_data = sst_map->getData() + page_offset;
+        return isPageIntact(sst_filename, first_frame, page_data, true, page_size) ? page_data : nullptr;
     }
-
-    // Step 2: Collect all keys and values in the range sequentially
-    if (first_in_range != -1)
+    if (buffer_pool != nullptr)
     {
-        long index = first_in_range;
-        while (index < total_entries)
+        long frame = 0;
+        for (; frame < num_frames; frame++)
         {
-            off_t page_offset = (index * ENTRY_SIZE / PAGE_SIZE) * PAGE_SIZE;
-
-            Page *cached_page = buffer_pool->searchForPage(sst_filename + std::to_string(page_offset));
-            if (cached_page != nullptr)
+            Page *cached_page = buffer_pool->searchForPage(sst_filename + std::to_string((first_frame + frame) * PAGE_SIZE));
+            if (cached_page == nullptr)
             {
-                std::memcpy(page_buffer, cached_page->data, PAGE_SIZE);
+                break;
             }
-            else
+            if (!isPageIntact(sst_filename, first_frame + frame, cached_page->data, true))
             {
-                ssize_t bytes_read = pread(fd, page_buffer, PAGE_SIZE, page_offset);
-                if (bytes_read < 0)
-                {
-                    std::cerr << "Error: Failed to read SST file " << sst_filename << std::endl;
-                    break;
-                }
-                Page *new_page = new Page(sst_filename + std::to_string(page_offset), page_buffer);
-                buffer_pool->insertPage(new_page);
+                return nullptr;
             }
-
-            char *current_offset = page_buffer;
-            size_t entries_per_page = PAGE_SIZE / ENTRY_SIZE;
-
-            for (size_t i = 0; i < entries_per_page; i++)
+            if (num_frames == 1)
             {
-                long current_key;
-                memcpy(&current_key, current_offset, sizeof(long));
-                current_offset += sizeof(long);
-                long current_val;
-                memcpy(&current_val, current_offset, sizeof(long));
-                current_offset += sizeof(long);
+                return cached_page->data;
+            }
+            std::memcpy(page_buffer + frame * PAGE_SIZE, cached_page->data, PAGE_SIZE);
+        }
+        if (frame == num_frames)
+        {
+            return page_buffer;
+        }
+    }
 
-                if (current_key < 0)
-                    break;
+    int fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT, 0666);
+    if (fd < 0)
+    {
+        std::cerr << "Error: Unable to open SST file " << sst_filename << std::endl;
+        return nullptr;
+    }
+    ssize_t bytes_read = pread(fd, page_buffer, page_size, page_offset);
+    close(fd);
+    if (bytes_read != static_cast<ssize_t>(page_size) || !isPageIntact(sst_filename, first_frame, page_buffer, false, page_size))
+    {
+        std::cerr << "Error: Failed to read page in SST file " << sst_filename << std::endl;
+        return nullptr;
+    }
+    for (long frame = 0; buffer_pool != nullptr && frame < num_frames; frame++)
+    {
+        buffer_pool->insertPage(new Page(sst_filename + std::to_string((first_frame + frame) * PAGE_SIZE), page_buffer + frame * PAGE_SIZE));
+    }
+    return page_buffer;
+}
 
-                if (current_key > key2)
-                {
-                    close(fd);
-                    return results;
-                }
+// Counts a page read by a get or a scan and returns the data page (see readSSTDataPage).
+static const char *readSSTPage(const std::string &sst_filename, long page_index, char *page_buffer, BufferPool *buffer_pool, MappedFile *sst_map, const SSTFooter &footer)
+{
+    countPageRead();
+    return readSSTDataPage(sst_filename, footer, page_index, page_buffer, buffer_pool, sst_map);
+}
 
-                if (current_key >= key1)
-                {
-                    results.emplace_back(current_key, current_val);
-                }
-            }
+/*
+    Searches the first entries_page key-value pairs of a plain or columnar SST
+    page for the key. The keys of a columnar page are contiguous, so they are
+    searched with a stride of one long instead of two. Returns nullptr if the
+    key is not in the page.
+*/
+static NodeFileOffset *searchSSTPage(const std::string &sst_filename, const SSTFooter &footer, const char *page_data, long page_index, long entries_page, long key)
+{
+    const long *page_longs = reinterpret_cast<const long *>(page_data);
+    bool is_columnar = footer.isColumnar();
+    long pos = pageLowerBound(page_longs, entries_page, footer.getKeyStride(), key);
+    if (pos >= entries_page || getDataPageKey(page_longs, pos, is_columnar) != key)
+    {
+        return nullptr;
+    }
+    return new NodeFileOffset(new Node(key, getDataPageValue(page_longs, pos, is_columnar)), sst_filename, footer.data_offset + page_index * footer.page_size);
+}
 
-            index += PAGE_SIZE / ENTRY_SIZE;
-        }
+/*
+    Searches a packed SST page for the key. Returns nullptr if the key is not in
+    the page.
+*/
+static NodeFileOffset *searchPackedSSTPage(const std::string &sst_filename, const char *page_data, long page_index, long key)
+{
+    long pos = findPackedKey(page_data, key);
+    if (pos < 0)
+    {
+        return nullptr;
     }
+    return new NodeFileOffset(new Node(key, getPackedPageValues(page_data)[pos]), sst_filename, page_index * PAGE_SIZE);
+}
 
-    close(fd);
-    return results;
+// Returns the first key of a data page of a single-file SST.
+static long getDataPageFirstKey(const SSTFooter &footer, const char *page_data)
+{
+    return footer.isPacked() ? getPackedPageFirstKey(page_data) : reinterpret_cast<const long *>(page_data)[0];
 }
 
-// Function to get SST files
-std::vector<std::string> getDataFiles(const std::string current_database, std::string prefix)
+// Returns the last key of a data page of a single-file SST.
+static long getDataPageLastKey(const SSTFooter &footer, const char *page_data, long page_index)
 {
-    std::vector<std::string> sst_files;
-    std::string directory = DATA_FILE_PATH + current_database; // Path to the SST directory
+    return footer.isPacked() ? getPackedPageLastKey(page_data) : getDataPageKey(reinterpret_cast<const long *>(page_data), footer.getEntriesInPage(page_index) - 1, footer.isColumnar());
+}
 
-    // List all SST files in the directory
-    for (const auto &entry : std::filesystem::directory_iterator(directory))
+/*
+    Appends the key-value pairs of a data page of a single-file SST within
+    [key1, key2] to results. Returns false if the page holds a key past key2.
+*/
+static bool scanDataPage(const SSTFooter &footer, const char *page_data, long page_index, long key1, long key2, std::vector<std::pair<long, long>> &results)
+{
+    if (footer.isPacked())
+    {
+        return scanPackedPage(page_data, key1, key2, results);
+    }
+    const long *page_longs = reinterpret_cast<const long *>(page_data);
+    long entries_page = footer.getEntriesInPage(page_index);
+    bool is_columnar = footer.isColumnar();
+    for (long i = pageLowerBound(page_longs, entries_page, footer.getKeyStride(), key1); i < entries_page; i++)
     {
+        long curr_key = getDataPageKey(page_longs, i, is_columnar);
+        if (curr_key > key2)
+        {
+            return false;
+        }
+        results.emplace_back(curr_key, getDataPageValue(page_longs, i, is_columnar));
+    }
+    return true;
+}
 
-        if (entry.path().extension() == ".bin")
+/*
+    Finds the key in a packed, columnar or compressed SST with a binary search
+    over its pages. Packed pages hold a varying number of key-value pairs,
+    columnar pages do not keep a pair together and compressed pages are not at
+    fixed offsets of the file, so the pages (decompressed if needed) are
+    bisected by their first and last keys instead of by the pair positions.
+    Returns nullptr if the key is not in the SST.
+*/
+static NodeFileOffset *pageBinarySearch(const std::string &sst_filename, const SSTFooter &footer, long key, BufferPool *buffer_pool, MappedFile *sst_map)
+{
+    long low_page = 0, high_page = footer.getNumDataPages() - 1;
+    alignas(PAGE_SIZE) char page_buffer[PAGE_SIZE];
+    while (low_page <= high_page)
+    {
+        long page_index = low_page + (high_page - low_page) / 2;
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, footer);
+        if (page_data == nullptr)
         {
-            // Check if the prefix is correct (either sst or btree)
-            std::string filename = entry.path().filename().string();
+            return nullptr;
+        }
 
-            if (filename.rfind(prefix, 0) == 0)
-            {
-                // std::cout << filename << std::endl;
-                sst_files.push_back(entry.path().string());
-            }
+        if (key < getDataPageFirstKey(footer, page_data))
+        {
+            high_page = page_index - 1;
+        }
+        else if (key > getDataPageLastKey(footer, page_data, page_index))
+        {
+            low_page = page_index + 1;
+        }
+        else if (footer.isPacked())
+        {
+            return searchPackedSSTPage(sst_filename, page_data, page_index, key);
+        }
+        else
+        {
+            return searchSSTPage(sst_filename, footer, page_data, page_index, footer.getEntriesInPage(page_index), key);
+        }
+    }
+    return nullptr;
+}
+
+/*
+    Returns the key-value pairs of a packed, columnar or compressed SST within
+    [key1, key2]. The first page whose last key is not smaller than key1 is found with
+    a binary search over the pages, then the pages are read in order until a
+    key past key2.
+*/
+static std::vector<std::pair<long, long>> pageBinarySearchScan(const std::string &sst_filename, const SSTFooter &footer, long key1, long key2, BufferPool *buffer_pool, MappedFile *sst_map)
+{
+    long num_pages = footer.getNumDataPages();
+    long low_page = 0, high_page = num_pages;
+    alignas(PAGE_SIZE) char page_buffer[PAGE_SIZE];
+    while (low_page < high_page)
+    {
+        long page_index = low_page + (high_page - low_page) / 2;
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, footer);
+        if (page_data == nullptr)
+        {
+            return {};
+        }
+        if (getDataPageLastKey(footer, page_data, page_index) < key1)
+        {
+            low_page = page_index + 1;
+        }
+        else
+        {
+            high_page = page_index;
+        }
+    }
+
+    std::vector<std::pair<long, long>> results;
+    for (long page_index = low_page; page_index < num_pages; page_index++)
+    {
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, footer);
+        if (page_data == nullptr || !scanDataPage(footer, page_data, page_index, key1, key2, results))
+        {
+            break;
+        }
+    }
+    return results;
+}
+
+/*
+    Finds the key in an SST using its in-memory fence pointers. The page that
+    may hold the key is found by searching the fence keys in memory, so exactly
+    one data page is read (from the mapping, the buffer pool or the file).
+    Returns nullptr if the key is not in the SST.
+*/
+NodeFileOffset *fencePointerSearch(const std::string &sst_filename, const SSTMetadata &metadata, long key, BufferPool *buffer_pool, MappedFile *sst_map)
+{
+    // The first page whose largest key is not smaller than the key is the only page that may hold it
+    auto fence = std::lower_bound(metadata.fence_keys.begin(), metadata.fence_keys.end(), key);
+    if (fence == metadata.fence_keys.end())
+    {
+        return nullptr;
+    }
+    long page_index = fence - metadata.fence_keys.begin();
+    long page_pairs = metadata.footer.getPagePairs();
+    long entries_page = std::min(page_pairs, metadata.num_entries - page_index * page_pairs);
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, metadata.footer);
+    if (page_data == nullptr)
+    {
+        return nullptr;
+    }
+    if (metadata.footer.isPacked())
+    {
+        return searchPackedSSTPage(sst_filename, page_data, page_index, key);
+    }
+    return searchSSTPage(sst_filename, metadata.footer, page_data, page_index, entries_page, key);
+}
+
+/*
+    Finds the key in an SST with an interpolation search over its pages. The
+    page of the next probe is estimated from where the key falls between the
+    keys bounding the remaining pages (the smallest and largest keys of the SST
+    at first, then the last key of the page below and the first key of the page
+    above), which takes about log2(log2(pages)) page reads for uniform keys. If
+    a probe does not at least halve the remaining pages, the keys are skewed
+    there and the next probe is the middle page instead. Returns nullptr if the
+    key is not in the SST.
+*/
+NodeFileOffset *interpolationSearch(const std::string &sst_filename, const SSTMetadata &metadata, long key, BufferPool *buffer_pool, MappedFile *sst_map)
+{
+    if (metadata.num_entries == 0 || key < metadata.min_key || key > metadata.max_key)
+    {
+        return nullptr;
+    }
+
+    // Packed pages hold a varying number of key-value pairs, so their footer gives the number of pages
+    bool is_packed = metadata.footer.isPacked();
+    long page_pairs = metadata.footer.getPagePairs();
+    long low_page = 0, high_page = is_packed ? metadata.footer.getNumDataPages() - 1 : (metadata.num_entries - 1) / page_pairs;
+    long low_key = metadata.min_key, high_key = metadata.max_key;
+    bool is_bisecting = false;
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    while (low_page <= high_page)
+    {
+        long num_pages = high_page - low_page + 1;
+        long page_index = low_page + num_pages / 2;
+        if (!is_bisecting && high_key > low_key)
+        {
+            double fraction = static_cast<double>(key - low_key) / static_cast<double>(high_key - low_key);
+            page_index = std::clamp(low_page + static_cast<long>(fraction * num_pages), low_page, high_page);
+        }
+
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, metadata.footer);
+        if (page_data == nullptr)
+        {
+            return nullptr;
+        }
+        long entries_page = std::min(page_pairs, metadata.num_entries - page_index * page_pairs);
+        const long *page_longs = reinterpret_cast<const long *>(page_data);
+        long first_key = is_packed ? getPackedPageFirstKey(page_data) : page_longs[0];
+        long last_key = is_packed ? getPackedPageLastKey(page_data) : getDataPageKey(page_longs, entries_page - 1, metadata.footer.isColumnar());
+
+        if (key < first_key)
+        {
+            high_page = page_index - 1;
+            high_key = first_key;
+        }
+        else if (key > last_key)
+        {
+            low_page = page_index + 1;
+            low_key = last_key;
+        }
+        else
+        {
+            return is_packed ? searchPackedSSTPage(sst_filename, page_data, page_index, key)
+                             : searchSSTPage(sst_filename, metadata.footer, page_data, page_index, entries_page, key);
+        }
+
+        // Fall back to a binary search step after a probe that did not halve the remaining pages
+        is_bisecting = !is_bisecting && (high_page - low_page + 1) * 2 > num_pages;
+    }
+    return nullptr;
+}
+
+/*
+    Finds the key in an SST using its in-memory learned index. The learned index
+    predicts the position of the key to within LEARNED_INDEX_EPSILON, so the key
+    can only be in the page of the prediction or, when the error window crosses
+    a page boundary, in the page next to it. The predicted page is read first and
+    its first and last keys tell whether the neighbouring page has to be read, so
+    most lookups read a single data page. Returns nullptr if the key is not in
+    the SST.
+*/
+NodeFileOffset *learnedIndexSearch(const std::string &sst_filename, const SSTMetadata &metadata, long key, BufferPool *buffer_pool, MappedFile *sst_map)
+{
+    // The position of a key does not give its page when pages are packed, but the fence pointers do
+    if (metadata.footer.isPacked())
+    {
+        return fencePointerSearch(sst_filename, metadata, key, buffer_pool, sst_map);
+    }
+
+    long num_entries = metadata.learned_index.getNumKeys();
+    if (num_entries == 0 || key < metadata.min_key || key > metadata.max_key)
+    {
+        return nullptr;
+    }
+
+    // One extra position on each side covers the rounding of the prediction
+    long position = metadata.learned_index.predict(key);
+    long page_pairs = metadata.footer.getPagePairs();
+    long first_page = std::max(0L, position - LEARNED_INDEX_EPSILON - 1) / page_pairs;
+    long last_page = std::min(num_entries - 1, position + LEARNED_INDEX_EPSILON + 1) / page_pairs;
+    long page_index = position / page_pairs;
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    for (bool is_neighbour = false;; is_neighbour = true)
+    {
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, metadata.footer);
+        if (page_data == nullptr)
+        {
+            return nullptr;
+        }
+        long entries_page = std::min(page_pairs, num_entries - page_index * page_pairs);
+        const long *page_longs = reinterpret_cast<const long *>(page_data);
+
+        // Move to the neighbouring page (at most once) if the key is outside of this page and the error window reaches it
+        if (!is_neighbour && key < page_longs[0] && page_index > first_page)
+        {
+            page_index--;
+        }
+        else if (!is_neighbour && key > getDataPageKey(page_longs, entries_page - 1, metadata.footer.isColumnar()) && page_index < last_page)
+        {
+            page_index++;
+        }
+        else
+        {
+            return searchSSTPage(sst_filename, metadata.footer, page_data, page_index, entries_page, key);
+        }
+    }
+}
+
+std::vector<std::pair<long, long>> binarySearchScan(const std::string sst_filename, long key1, long key2, BufferPool *buffer_pool, MappedFile *sst_map, const SSTFooter *footer)
+{
+    // The footer of a single-file SST gives the number of key-value pairs, otherwise it is estimated from the file size
+    SSTFooter file_footer;
+    if (footer == nullptr)
+    {
+        readSSTFooter(sst_filename, file_footer, sst_map);
+        footer = &file_footer;
+    }
+    if (footer->isPacked() || footer->isColumnar() || footer->isCompressed())
+    {
+        return pageBinarySearchScan(sst_filename, *footer, key1, key2, buffer_pool, sst_map);
+    }
+
+    // A mapped SST file is scanned in place, otherwise its pages are read through the buffer pool
+    long total_entries = footer->num_entries;
+    if (!footer->isSingleFile())
+    {
+        std::error_code error;
+        off_t file_size = sst_map != nullptr ? sst_map->getSize() : static_cast<off_t>(std::filesystem::file_size(sst_filename, error));
+        if (error)
+        {
+            std::cerr << "Error: Unable to open SST file " << sst_filename << std::endl;
+            return {};
+        }
+        total_entries = file_size / ENTRY_SIZE;
+    }
+    long page_pairs = footer->getPagePairs();
+
+    long start = 0;
+    long end = total_entries - 1;
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+
+    long first_in_range = -1; // Index of the first key in range
+    std::vector<std::pair<long, long>> results;
+
+    // Step 1: Use binary search to find the first key within the range
+    while (start <= end)
+    {
+        long mid = start + (end - start) / 2;
+        long page_index = mid / page_pairs;
+        const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, *footer);
+        if (page_data == nullptr)
+        {
+            return {};
+        }
+
+        const char *current_offset = page_data;
+        size_t entries_per_page = footer->isSingleFile() ? footer->getEntriesInPage(page_index) : page_pairs;
+
+        for (size_t i = 0; i < entries_per_page; i++)
+        {
+            long current_key;
+            memcpy(&current_key, current_offset, sizeof(long));
+            current_offset += sizeof(long);
+
+            if (current_key < 0)
+                break;
+
+            if (current_key >= key1)
+            {
+                first_in_range = mid; // First key in range found
+                end = mid - 1;      // Narrow search for the lower bound
+                break;
+            }
+
+            if (i == entries_per_page - 1)
+                start = mid + 1;
+        }
+    }
+
+    // Step 2: Collect all keys and values in the range sequentially
+    if (first_in_range != -1)
+    {
+        long index = first_in_range;
+        while (index < total_entries)
+        {
+            long page_index = index / page_pairs;
+            const char *page_data = readSSTPage(sst_filename, page_index, page_buffer, buffer_pool, sst_map, *footer);
+            if (page_data == nullptr)
+            {
+                break;
+            }
+
+            const char *current_offset = page_data;
+            size_t entries_per_page = footer->isSingleFile() ? footer->getEntriesInPage(page_index) : page_pairs;
+
+            for (size_t i = 0; i < entries_per_page; i++)
+            {
+                long current_key;
+                memcpy(&current_key, current_offset, sizeof(long));
+                current_offset += sizeof(long);
+                long current_val;
+                memcpy(&current_val, current_offset, sizeof(long));
+                current_offset += sizeof(long);
+
+                if (current_key < 0)
+                    break;
+
+                if (current_key > key2)
+                {
+                    return results;
+                }
+
+                if (current_key >= key1)
+                {
+                    results.emplace_back(current_key, current_val);
+                }
+            }
+
+            index += page_pairs;
+        }
+    }
+
+    return results;
+}
+
+/*
+    Reads the range tombstones in the tombstone block of a single-file SST.
+    Returns false if the block could not be read or does not match its
+    checksums, in which case no range tombstone is added.
+*/
+static bool readTombstoneBlock(const std::string &sst_filename, const SSTFooter &footer, RangeTombstones &range_tombstones)
+{
+    if (footer.tombstone_size == 0)
+    {
+        return true;
+    }
+    int fd = open(sst_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    size_t num_bytes = (footer.tombstone_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    std::vector<long> ranges(num_bytes / sizeof(long));
+    bool is_read = pread(fd, ranges.data(), num_bytes, footer.tombstone_offset) == static_cast<ssize_t>(num_bytes) &&
+                   isPageIntact(sst_filename, footer.tombstone_offset / PAGE_SIZE, ranges.data(), false, num_bytes);
+    close(fd);
+    if (!is_read)
+    {
+        std::cerr << "Error: Failed to read the range tombstones of SST file " << sst_filename << std::endl;
+        return false;
+    }
+    for (long i = 0; i + 1 < footer.tombstone_size / static_cast<long>(sizeof(long)); i += 2)
+    {
+        range_tombstones.add(ranges[i], ranges[i + 1]);
+    }
+    return true;
+}
+
+/*
+    Computes the statistics of an existing SST by reading it sequentially. Used
+    for SSTs that were written without collecting their statistics. Returns
+    false if a page or the tombstone block could not be read (or does not match
+    its checksum), as the statistics would then miss the keys after it.
+*/
+bool readSSTMetadata(const std::string &sst_filename, SSTMetadata &metadata)
+{
+    metadata = SSTMetadata();
+    readSSTFooter(sst_filename, metadata.footer);
+    SSTIterator iterator(sst_filename);
+    while (iterator.valid())
+    {
+        metadata.add(iterator.key(), iterator.value(), iterator.startsPage());
+        iterator.next();
+    }
+    if (iterator.hasError())
+    {
+        std::cerr << "Error: Failed to read the statistics of SST file " << sst_filename << std::endl;
+        return false;
+    }
+
+    // SSTs without range tombstones have no tombstone block or range tombstone file
+    RangeTombstones range_tombstones;
+    if (metadata.footer.hasChecksumBlock())
+    {
+        if (!readTombstoneBlock(sst_filename, metadata.footer, range_tombstones))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        range_tombstones.loadFromFile(getRangeTombstoneFilename(sst_filename));
+    }
+    for (const std::pair<long, long> &range : range_tombstones.getRanges())
+    {
+        metadata.addRangeTombstone(range.first, range.second);
+    }
+    return true;
+}
+
+/*
+    Returns the name of the file holding the range tombstones of the given SST.
+*/
+std::string getRangeTombstoneFilename(const std::string &sst_filename)
+{
+    std::string range_filename = sst_filename;
+    range_filename.replace(range_filename.rfind("sst_"), 4, "range_");
+    return range_filename;
+}
+
+// Function to get SST files
+std::vector<std::string> getDataFiles(const std::string current_database, std::string prefix)
+{
+    std::vector<std::string> sst_files;
+    std::string directory = DATA_FILE_PATH + current_database; // Path to the SST directory
+
+    // List all SST files in the directory
+    for (const auto &entry : std::filesystem::directory_iterator(directory))
+    {
+
+        if (entry.path().extension() == ".bin")
+        {
+            // Check if the prefix is correct (either sst or btree)
+            std::string filename = entry.path().filename().string();
+
+            if (filename.rfind(prefix, 0) == 0)
+            {
+                // std::cout << filename << std::endl;
+                sst_files.push_back(entry.path().string());
+            }
         }
     }
 
@@ -524,4 +939,828 @@ std::vector<std::string> getDataFiles(const std::string current_database, std::s
     return sst_files;
 }
 
-////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+// Define the SSTIterator class's constructor and destructor.
+SSTIterator::SSTIterator(const std::string &sst_filename)
+    : sst_filename(sst_filename), fd(-1), buffer(nullptr), read_offset(0), data_end(-1), entries_left(-1), buffer_index(0), is_packed(false), page_pairs(0),
+      codec(nullptr), compressed_buffer(nullptr), window_first_page(-1), window_pages(0), next_page(0), is_valid(false), has_error(false)
+{
+    // A single-file SST ends its data block where its footer says, and the index and filter blocks are never read
+    if (readSSTFooter(sst_filename, footer))
+    {
+        read_offset = footer.data_offset;
+        data_end = footer.data_offset + footer.data_size;
+        entries_left = footer.num_entries;
+        is_packed = footer.isPacked();
+    }
+    if (is_packed)
+    {
+        page_keys.resize(PACKED_PAGE_MAX_PAIRS);
+    }
+
+    fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0)
+    {
+        std::cerr << "Read SST Error: Failed to open SST file - " << sst_filename << " for read." << std::endl;
+        return;
+    }
+
+    if (posix_memalign(&buffer, PAGE_SIZE, footer.page_size) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed." << std::endl;
+        buffer = nullptr;
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    // A compressed page spans at most two pages of the file, which are read into a window of two pages
+    if (footer.isCompressed())
+    {
+        codec = getBlockCodec(footer.compression);
+        if (codec == nullptr)
+        {
+            std::cerr << "Error: SST file " << sst_filename << " is compressed with " << getCompressionName(footer.compression) << ", which was not built in." << std::endl;
+            has_error = true;
+            return;
+        }
+        if (posix_memalign(&compressed_buffer, PAGE_SIZE, 2 * PAGE_SIZE) != 0)
+        {
+            std::cerr << "Error: Memory alignment allocation failed." << std::endl;
+            compressed_buffer = nullptr;
+            has_error = true;
+            return;
+        }
+    }
+
+    readNextPage();
+}
+
+SSTIterator::~SSTIterator()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (buffer != nullptr)
+    {
+        free(buffer);
+    }
+    if (compressed_buffer != nullptr)
+    {
+        free(compressed_buffer);
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the SSTIterator class's functions.
+// Implementation of the readNextPage function.
+void SSTIterator::readNextPage()
+{
+    is_valid = false;
+    buffer_index = 0;
+
+    // No more pairs in the data block of a single-file SST
+    if (entries_left == 0 || (data_end >= 0 && read_offset >= data_end))
+    {
+        return;
+    }
+
+    if (footer.isCompressed())
+    {
+        if (next_page >= footer.getNumDataPages())
+        {
+            return;
+        }
+        if (codec == nullptr || !readNextCompressedPage())
+        {
+            has_error = true;
+            return;
+        }
+    }
+    else if (!readNextFilePage())
+    {
+        return;
+    }
+
+    // The keys of a packed page are decoded once, before its first pair is returned
+    if (is_packed)
+    {
+        page_pairs = decodePackedKeys(static_cast<const char *>(buffer), page_keys.data());
+        is_valid = entries_left > 0 && page_pairs > 0;
+        return;
+    }
+
+    // A page starting with padding holds no key-value pairs
+    is_valid = entries_left > 0 || (entries_left < 0 && static_cast<long *>(buffer)[0] >= 0);
+}
+
+/*
+    Reads the next page of the data block (footer.page_size bytes) into the
+    buffer. Returns false at the end of the file or if the page could not be
+    read (setting has_error).
+*/
+bool SSTIterator::readNextFilePage()
+{
+    ssize_t bytes_read = pread(fd, buffer, footer.page_size, read_offset);
+    if (bytes_read < 0)
+    {
+        std::cerr << "Error: Failed to read page in SST file." << std::endl;
+        has_error = true;
+        return false;
+    }
+    // No more pages to read
+    if (bytes_read == 0)
+    {
+        return false;
+    }
+    // Compaction must not write a corrupted page into a new SST, so every page is checked unless checksums are OFF
+    if (!isPageIntact(sst_filename, read_offset / PAGE_SIZE, buffer, false, bytes_read))
+    {
+        has_error = true;
+        return false;
+    }
+    read_offset += bytes_read;
+    return true;
+}
+
+/*
+    Reads and decompresses the next page of a compressed SST into the buffer.
+    The compressed pages are back to back, so a page starts on the last page of
+    the file in the window (or the one after it), which is kept so that every
+    page of the file is read and checked once. Returns false if the page could
+    not be read or decompressed.
+*/
+bool SSTIterator::readNextCompressedPage()
+{
+    long offset = footer.data_offset + footer.getBlockOffset(next_page);
+    long size = footer.getBlockSize(next_page);
+    long first_page = offset / PAGE_SIZE;
+    long last_page = (offset + size - 1) / PAGE_SIZE;
+    char *window = static_cast<char *>(compressed_buffer);
+
+    if (window_pages == 0 || first_page >= window_first_page + window_pages)
+    {
+        window_first_page = first_page;
+        window_pages = 0;
+    }
+    else if (first_page > window_first_page)
+    {
+        std::memmove(window, window + PAGE_SIZE, PAGE_SIZE);
+        window_first_page = first_page;
+        window_pages = 1;
+    }
+
+    long num_pages = last_page - window_first_page + 1;
+    if (num_pages > window_pages)
+    {
+        size_t num_bytes = (num_pages - window_pages) * PAGE_SIZE;
+        char *pages = window + window_pages * PAGE_SIZE;
+        long page_index = window_first_page + window_pages;
+        if (pread(fd, pages, num_bytes, page_index * PAGE_SIZE) != static_cast<ssize_t>(num_bytes) || !isPageIntact(sst_filename, page_index, pages, false, num_bytes))
+        {
+            std::cerr << "Error: Failed to read page in SST file " << sst_filename << std::endl;
+            window_pages = 0;
+            return false;
+        }
+        window_pages = num_pages;
+    }
+
+    // A page that did not shrink was stored as it is
+    const char *block = window + (offset - window_first_page * PAGE_SIZE);
+    if (size == PAGE_SIZE)
+    {
+        std::memcpy(buffer, block, PAGE_SIZE);
+    }
+    else if (!codec->decompress(block, size, static_cast<char *>(buffer), PAGE_SIZE))
+    {
+        std::cerr << "Error: Failed to decompress page " << next_page << " of SST file " << sst_filename << std::endl;
+        return false;
+    }
+    next_page++;
+    return true;
+}
+
+// Implementation of the isOpen function.
+bool SSTIterator::isOpen()
+{
+    return fd >= 0 && buffer != nullptr;
+}
+
+// Implementation of the valid function.
+bool SSTIterator::valid()
+{
+    return is_valid;
+}
+
+// Implementation of the hasError function.
+bool SSTIterator::hasError()
+{
+    return has_error;
+}
+
+// Implementation of the key function.
+long SSTIterator::key()
+{
+    if (is_packed)
+    {
+        return page_keys[buffer_index / 2];
+    }
+    return getDataPageKey(static_cast<const long *>(buffer), buffer_index / 2, footer.isColumnar());
+}
+
+// Implementation of the value function.
+long SSTIterator::value()
+{
+    if (is_packed)
+    {
+        return getPackedPageValues(static_cast<const char *>(buffer))[buffer_index / 2];
+    }
+    return getDataPageValue(static_cast<const long *>(buffer), buffer_index / 2, footer.isColumnar());
+}
+
+// Implementation of the startsPage function.
+bool SSTIterator::startsPage()
+{
+    return buffer_index == 0;
+}
+
+/*
+    Advances to the next key-value pair. A single-file SST counts down the pairs
+    left, otherwise keys are never negative, so a negative key (INTERNAL padding
+    or the LEAF marker) means the rest of the page is empty. A packed page gives
+    its number of pairs.
+*/
+void SSTIterator::next()
+{
+    if (!is_valid)
+    {
+        return;
+    }
+
+    buffer_index += 2;
+    if (entries_left > 0 && --entries_left == 0)
+    {
+        is_valid = false;
+        return;
+    }
+    if (is_packed ? static_cast<long>(buffer_index / 2) >= page_pairs
+                  : buffer_index >= footer.page_size / sizeof(long) || (entries_left < 0 && static_cast<long *>(buffer)[buffer_index] < 0))
+    {
+        readNextPage();
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the SSTWriter class's constructor and destructor.
+SSTWriter::SSTWriter(std::string sst_filename, RateLimiter *rate_limiter, IOPriority priority, IndexLayout layout, PageEncoding encoding, CompressionType compression,
+                     size_t page_size)
+    : SSTWriter(sst_filename, sst_filename, sst_filename, rate_limiter, priority, layout, encoding, compression, page_size) {}
+
+SSTWriter::SSTWriter(std::string sst_filename, std::string btree_filename, std::string bloom_filename, RateLimiter *rate_limiter, IOPriority priority, IndexLayout layout,
+                     PageEncoding encoding, CompressionType compression, size_t page_size)
+    : sst_filename(sst_filename), btree_filename(btree_filename), bloom_filename(bloom_filename), rate_limiter(rate_limiter),
+      priority(priority), sst_fd(-1), btree_fd(-1), is_single_file(btree_filename == sst_filename), sst_buffer(nullptr), btree_buffer(nullptr),
+      sst_write_offset(0), sst_buffer_offset(0), btree(sst_filename, btree_filename, layout), bloom_filter(BLOOM_FILTER_NUM_BITS, BLOOM_FILTER_NUM_HASHES),
+      leaf_node_pairs_written(0), encoding(btree_filename == sst_filename ? encoding : PageEncoding::PLAIN),
+      compression(btree_filename == sst_filename ? compression : CompressionType::NONE), codec(nullptr), compressed_buffer(nullptr), compressed_buffer_offset(0),
+      block_offsets(1, 0), curr_page(0), final_key_added(0), page_size(PAGE_SIZE), has_error(false)
+{
+    if (!isValidPageSize(page_size))
+    {
+        std::cerr << "Write SST Error: Unsupported page size " << page_size << std::endl;
+        has_error = true;
+        return;
+    }
+    // Only the plain, uncompressed pages of a single-file SST can be larger than PAGE_SIZE
+    this->page_size = this->encoding == PageEncoding::PLAIN && this->compression == CompressionType::NONE && is_single_file ? page_size : PAGE_SIZE;
+
+    // A compressed SST needs its codec to be built in
+    if (this->compression != CompressionType::NONE && (codec = getBlockCodec(this->compression)) == nullptr)
+    {
+        std::cerr << "Write SST Error: " << getCompressionName(this->compression) << " compression was not built in." << std::endl;
+        has_error = true;
+        return;
+    }
+
+    // Open the SST file for writing with Direct I/O
+    sst_fd = open(sst_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
+    if (sst_fd < 0)
+    {
+        std::cerr << "Write SST Error: Failed to open SST file " << sst_filename << " for writing." << std::endl;
+        has_error = true;
+        return;
+    }
+
+    // Open B-Tree file for writing with Direct I/O (a single-file SST appends its B-Tree to the SST file)
+    if (!is_single_file)
+    {
+        btree_fd = open(btree_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
+        if (btree_fd < 0)
+        {
+            std::cerr << "Error: Failed to open B-Tree file " << btree_filename << " for writing." << std::endl;
+            has_error = true;
+            return;
+        }
+    }
+
+    // Create the aligned buffers to write to for the SST and the B-Tree
+    if (posix_memalign(&sst_buffer, PAGE_SIZE, this->page_size) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the SST Buffer." << std::endl;
+        sst_buffer = nullptr;
+        has_error = true;
+        return;
+    }
+    std::memset(sst_buffer, INTERNAL, this->page_size);
+
+    if (posix_memalign(&btree_buffer, PAGE_SIZE, PAGE_SIZE) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the B-Tree Buffer." << std::endl;
+        btree_buffer = nullptr;
+        has_error = true;
+        return;
+    }
+
+    // A compressed page is appended to at most a page of compressed pages not yet written
+    if (codec != nullptr && posix_memalign(&compressed_buffer, PAGE_SIZE, 2 * PAGE_SIZE) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the compressed pages Buffer." << std::endl;
+        compressed_buffer = nullptr;
+        has_error = true;
+        return;
+    }
+}
+
+SSTWriter::~SSTWriter()
+{
+    if (sst_fd >= 0)
+    {
+        close(sst_fd);
+    }
+    if (btree_fd >= 0)
+    {
+        close(btree_fd);
+    }
+    if (sst_buffer != nullptr)
+    {
+        free(sst_buffer);
+    }
+    if (btree_buffer != nullptr)
+    {
+        free(btree_buffer);
+    }
+    if (compressed_buffer != nullptr)
+    {
+        free(compressed_buffer);
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the SSTWriter class's functions.
+// Implementation of the writePage function.
+bool SSTWriter::writePage()
+{
+    if (codec != nullptr)
+    {
+        return writeCompressedPage();
+    }
+    if (rate_limiter != nullptr)
+    {
+        rate_limiter->request(page_size, priority);
+    }
+
+    ssize_t bytes_written = pwrite(sst_fd, sst_buffer, page_size, sst_write_offset);
+    if (bytes_written != static_cast<ssize_t>(page_size))
+    {
+        perror("pwrite failed");
+        std::cerr << "Error: Incomplete write for key-value pairs batch." << std::endl;
+        has_error = true;
+        return false;
+    }
+    // A page larger than PAGE_SIZE gets a checksum for every PAGE_SIZE of it
+    for (size_t offset = 0; offset < page_size; offset += PAGE_SIZE)
+    {
+        sst_checksums.push_back(crc32c(static_cast<const char *>(sst_buffer) + offset, PAGE_SIZE));
+    }
+    sst_write_offset += bytes_written;
+    sst_buffer_offset = 0;                        // Reset the buffer for the next batch
+    std::memset(sst_buffer, INTERNAL, page_size); // Clear the buffer
+    return true;
+}
+
+// Implementation of the writeBlockPage function.
+bool SSTWriter::writeBlockPage()
+{
+    ssize_t bytes_written = pwrite(sst_fd, btree_buffer, PAGE_SIZE, sst_write_offset);
+    if (bytes_written != PAGE_SIZE)
+    {
+        perror("pwrite failed");
+        std::cerr << "Error: Incomplete write for a block of SST file " << sst_filename << std::endl;
+        has_error = true;
+        return false;
+    }
+    sst_checksums.push_back(crc32c(btree_buffer, PAGE_SIZE));
+    sst_write_offset += bytes_written;
+    return true;
+}
+
+/*
+    Compresses sst_buffer and appends it to the compressed pages not yet
+    written, then writes them a page of the file at a time. A page that does
+    not shrink is appended as it is. Returns false if a write failed.
+*/
+bool SSTWriter::writeCompressedPage()
+{
+    char *compressed_pages = static_cast<char *>(compressed_buffer);
+    size_t size = codec->compress(static_cast<const char *>(sst_buffer), PAGE_SIZE, compressed_pages + compressed_buffer_offset, PAGE_SIZE - 1);
+    if (size == 0)
+    {
+        std::memcpy(compressed_pages + compressed_buffer_offset, sst_buffer, PAGE_SIZE);
+        size = PAGE_SIZE;
+    }
+    compressed_buffer_offset += size;
+    block_offsets.push_back(block_offsets.back() + size);
+    sst_buffer_offset = 0;
+    std::memset(sst_buffer, INTERNAL, PAGE_SIZE);
+
+    while (compressed_buffer_offset >= PAGE_SIZE)
+    {
+        if (rate_limiter != nullptr)
+        {
+            rate_limiter->request(PAGE_SIZE, priority);
+        }
+        std::memcpy(btree_buffer, compressed_pages, PAGE_SIZE);
+        if (!writeBlockPage())
+        {
+            return false;
+        }
+        compressed_buffer_offset -= PAGE_SIZE;
+        std::memmove(compressed_pages, compressed_pages + PAGE_SIZE, compressed_buffer_offset);
+    }
+    return true;
+}
+
+// Implementation of the writeBlockIndex function.
+bool SSTWriter::writeBlockIndex()
+{
+    footer.compression = compression;
+    footer.block_index_offset = sst_write_offset;
+    footer.block_index_size = block_offsets.size() * sizeof(long);
+    if (rate_limiter != nullptr)
+    {
+        rate_limiter->request((footer.block_index_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE, priority);
+    }
+
+    // Write the offsets, padded with zeros to the next page
+    const char *offsets = reinterpret_cast<const char *>(block_offsets.data());
+    for (long offset = 0; offset < footer.block_index_size; offset += PAGE_SIZE)
+    {
+        std::memset(btree_buffer, 0, PAGE_SIZE);
+        std::memcpy(btree_buffer, offsets + offset, std::min<long>(PAGE_SIZE, footer.block_index_size - offset));
+        if (!writeBlockPage())
+        {
+            return false;
+        }
+    }
+    footer.block_offsets = std::make_shared<const std::vector<long>>(block_offsets);
+    return true;
+}
+
+/*
+    Writes the key1 and key2 of every range tombstone as the tombstone block of
+    a single-file SST (padded with zeros to the next page). Returns false if a
+    write failed.
+*/
+bool SSTWriter::writeTombstoneBlock()
+{
+    std::vector<long> ranges;
+    for (const std::pair<long, long> &range : metadata.range_tombstones.getRanges())
+    {
+        ranges.push_back(range.first);
+        ranges.push_back(range.second);
+    }
+    footer.tombstone_offset = sst_write_offset;
+    footer.tombstone_size = ranges.size() * sizeof(long);
+    if (rate_limiter != nullptr)
+    {
+        rate_limiter->request((footer.tombstone_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE, priority);
+    }
+
+    const char *range_bytes = reinterpret_cast<const char *>(ranges.data());
+    for (long offset = 0; offset < footer.tombstone_size; offset += PAGE_SIZE)
+    {
+        std::memset(btree_buffer, 0, PAGE_SIZE);
+        std::memcpy(btree_buffer, range_bytes + offset, std::min<long>(PAGE_SIZE, footer.tombstone_size - offset));
+        if (!writeBlockPage())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Writes the checksum of every page written so far as the checksum block of
+    a single-file SST (padded with zeros to the next page), and caches them for
+    the readers. Returns false if a write failed.
+*/
+bool SSTWriter::writeChecksumBlock()
+{
+    std::vector<uint32_t> page_checksums = sst_checksums;
+    footer.checksum_offset = sst_write_offset;
+    footer.checksum_size = page_checksums.size() * sizeof(uint32_t);
+    if (rate_limiter != nullptr)
+    {
+        rate_limiter->request((footer.checksum_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE, priority);
+    }
+
+    const char *checksum_bytes = reinterpret_cast<const char *>(page_checksums.data());
+    for (long offset = 0; offset < footer.checksum_size; offset += PAGE_SIZE)
+    {
+        std::memset(btree_buffer, 0, PAGE_SIZE);
+        std::memcpy(btree_buffer, checksum_bytes + offset, std::min<long>(PAGE_SIZE, footer.checksum_size - offset));
+        if (!writeBlockPage())
+        {
+            return false;
+        }
+    }
+    cachePageChecksums(sst_filename, page_checksums);
+    return true;
+}
+
+// Implementation of the writePackedPage function.
+bool SSTWriter::writePackedPage()
+{
+    packed_page.write(sst_buffer);
+    curr_page++;
+    btree.insertInternalNode(packed_page.getLastKey(), curr_page);
+    packed_page.clear();
+    return writePage();
+}
+
+// Implementation of the isOpen function.
+bool SSTWriter::isOpen()
+{
+    return !has_error;
+}
+
+/*
+    Appends a key-value pair to the SST. Returns false if a previous or the
+    current write failed.
+*/
+bool SSTWriter::put(long key, long value)
+{
+    if (has_error)
+    {
+        return false;
+    }
+
+    bloom_filter.put(std::to_string(key));
+    footer.num_entries++;
+    footer.min_key = std::min(footer.min_key, key);
+    footer.max_key = std::max(footer.max_key, key);
+
+    // A packed page takes pairs until their keys no longer fit, then it is written and the pair starts the next page
+    if (encoding == PageEncoding::PACKED)
+    {
+        bool is_page_start = packed_page.empty();
+        if (!packed_page.add(key, value))
+        {
+            if (!writePackedPage())
+            {
+                return false;
+            }
+            packed_page.add(key, value);
+            is_page_start = true;
+        }
+        metadata.add(key, value, is_page_start);
+        final_key_added = key;
+        return true;
+    }
+    metadata.add(key, value, leaf_node_pairs_written == 0);
+
+    // A columnar page keeps its keys in the first half and their values in the second half
+    if (encoding == PageEncoding::COLUMNAR)
+    {
+        long *buffer_as_longs = static_cast<long *>(sst_buffer);
+        buffer_as_longs[leaf_node_pairs_written] = key;
+        buffer_as_longs[MAX_PAIRS + leaf_node_pairs_written] = value;
+        sst_buffer_offset += ENTRY_SIZE;
+    }
+    else
+    {
+        // Copy the key and value into the aligned buffer at the current buffer offset
+        std::memcpy(static_cast<char *>(sst_buffer) + sst_buffer_offset, &key, sizeof(key));
+        sst_buffer_offset += sizeof(key);
+        std::memcpy(static_cast<char *>(sst_buffer) + sst_buffer_offset, &value, sizeof(value));
+        sst_buffer_offset += sizeof(value);
+    }
+
+    // Incremenet the number of key-value pairs written to the Leaf Node and assign key to final_key_added in case this Leaf Node will not be entirely filled
+    leaf_node_pairs_written++;
+    final_key_added = key;
+
+    // If the buffer is full, write it to the SST file and add its max key to the B-Tree
+    if (sst_buffer_offset + ENTRY_SIZE > page_size)
+    {
+        curr_page++;
+        btree.insertInternalNode(key, curr_page);
+        leaf_node_pairs_written = 0;
+        return writePage();
+    }
+    return true;
+}
+
+/*
+    Writes the final (padded) page of the SST, then the B-Tree, the checksum,
+    Bloom filter and range tombstone files. A single-file SST gets its B-Tree,
+    Bloom filter, range tombstones and checksums appended as blocks, followed
+    by its footer, instead. Returns false if any write failed.
+*/
+bool SSTWriter::finish()
+{
+    if (has_error)
+    {
+        return false;
+    }
+
+    // Write the last packed page (the buffer itself only holds plain pages)
+    if (!packed_page.empty() && !writePackedPage())
+    {
+        return false;
+    }
+
+    // After processing all key-value pairs, check if there is remaining data in the buffer
+    if (sst_buffer_offset > 0)
+    {
+        // Set the last key in the partially filled page to LEAF (the rest of the buffer is already padded with -1), a single-file SST knows its number of pairs instead
+        if (!is_single_file)
+        {
+            long *buffer_as_longs = static_cast<long *>(sst_buffer);
+            int total_longs_in_buffer = PAGE_SIZE / sizeof(long);
+            buffer_as_longs[total_longs_in_buffer - 2] = LEAF;
+        }
+
+        if (!writePage())
+        {
+            return false;
+        }
+
+        curr_page++;
+        btree.insertInternalNode(final_key_added, curr_page);
+    }
+
+    // Write the last compressed pages, padded with zeros to the next page
+    if (codec != nullptr && compressed_buffer_offset > 0)
+    {
+        if (rate_limiter != nullptr)
+        {
+            rate_limiter->request(PAGE_SIZE, priority);
+        }
+        std::memset(btree_buffer, 0, PAGE_SIZE);
+        std::memcpy(btree_buffer, compressed_buffer, compressed_buffer_offset);
+        if (!writeBlockPage())
+        {
+            return false;
+        }
+        compressed_buffer_offset = 0;
+    }
+    footer.data_size = sst_write_offset;
+    footer.index_offset = sst_write_offset;
+
+    // Finalize the B-Tree and write Internal Nodes to the B-Tree file (an SST of a single page needs no B-Tree)
+    if (curr_page > 1)
+    {
+        btree.finalizeTree();
+        if (rate_limiter != nullptr)
+        {
+            rate_limiter->request(btree.getNumIndexPages() * PAGE_SIZE, priority);
+        }
+        if (is_single_file)
+        {
+            btree.writeNodes(sst_fd, btree_buffer, sst_write_offset, &sst_checksums);
+        }
+        else
+        {
+            size_t btree_write_offset = 0;
+            btree.writeNodes(btree_fd, btree_buffer, btree_write_offset, &btree_checksums);
+        }
+    }
+
+    if (is_single_file)
+    {
+        footer.index_size = sst_write_offset - footer.index_offset;
+        footer.filter_offset = sst_write_offset;
+        footer.filter_size = bloom_filter.getSizeInBytes();
+        footer.version = SST_FORMAT_VERSION;
+        footer.page_encoding = encoding;
+        footer.page_size = page_size;
+        if (rate_limiter != nullptr)
+        {
+            rate_limiter->request((footer.filter_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE + PAGE_SIZE, priority);
+        }
+
+        // Write the Bloom filter, padded with zeros to the next page
+        const char *bit_array = static_cast<const char *>(bloom_filter.getRawBitArray());
+        for (long offset = 0; offset < footer.filter_size; offset += PAGE_SIZE)
+        {
+            std::memset(btree_buffer, 0, PAGE_SIZE);
+            std::memcpy(btree_buffer, bit_array + offset, std::min<long>(PAGE_SIZE, footer.filter_size - offset));
+            if (!writeBlockPage())
+            {
+                return false;
+            }
+        }
+
+        // Write the block index of the compressed pages after the Bloom filter
+        if (codec != nullptr && !writeBlockIndex())
+        {
+            return false;
+        }
+
+        // Write the range tombstones and the checksums of every page before them, then the footer as the last page
+        if ((!metadata.range_tombstones.empty() && !writeTombstoneBlock()) || !writeChecksumBlock())
+        {
+            return false;
+        }
+        footer.serialize(btree_buffer);
+        if (!writeBlockPage())
+        {
+            return false;
+        }
+        metadata.footer = footer;
+        return true;
+    }
+
+    // Write the checksums of the SST and B-Tree pages (the Bloom filter writes its own)
+    if (!writeChecksumFile(sst_filename, sst_checksums) || !writeChecksumFile(btree_filename, btree_checksums))
+    {
+        return false;
+    }
+
+    // Serialize the Bloom filter to a separate file
+    bloom_filter.serialize(bloom_filename);
+
+    // Serialize the range tombstones to a separate file (only SSTs that have any get one)
+    if (!metadata.range_tombstones.empty() && !metadata.range_tombstones.serialize(getRangeTombstoneFilename(sst_filename)))
+    {
+        return false;
+    }
+    return true;
+}
+
+// Implementation of the putRangeTombstone function.
+void SSTWriter::putRangeTombstone(long key1, long key2)
+{
+    metadata.addRangeTombstone(key1, key2);
+}
+
+/*
+    Sizes the Bloom filter of a single-file SST for the given number of
+    key-value pairs, BLOOM_FILTER_BITS_PER_KEY bits each (and never smaller than
+    BLOOM_FILTER_NUM_BITS), so large SSTs keep a useful false positive rate.
+    The size is kept in the footer in bytes, so it is rounded up to whole
+    bytes for the readers to hash keys to the same bits. The bloom_ file of the version 1 layout is
+    always BLOOM_FILTER_NUM_BITS bits, since its readers assume that size.
+*/
+void SSTWriter::sizeFilter(size_t num_entries)
+{
+    if (is_single_file && metadata.num_entries == 0)
+    {
+        size_t num_bits = std::max(BLOOM_FILTER_NUM_BITS, num_entries * BLOOM_FILTER_BITS_PER_KEY);
+        bloom_filter = BloomFilter((num_bits + 7) / 8 * 8, BLOOM_FILTER_NUM_HASHES);
+    }
+}
+
+// Implementation of the getMetadata function.
+SSTMetadata SSTWriter::getMetadata()
+{
+    return metadata;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Page read counters.
+// Implementation of the countPageRead function.
+void countPageRead()
+{
+    page_reads++;
+}
+
+// Implementation of the getPageReads function.
+long getPageReads()
+{
+    return page_reads;
+}
+
+// Implementation of the resetPageReads function.
+void resetPageReads()
+{
+    page_reads = 0;
+}
+////////////////////////////////////////////////////////////////////////////
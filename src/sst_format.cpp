@@ -0,0 +1,223 @@
+#include "sst_format.h"
+#include "checksum.h"
+#include <cstring>
+#include <iostream>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Returns the number of longs of the footer covered by its checksum, which is the long after them.
+static long getFooterLongs(long version)
+{
+    return version >= 6 ? 19 : (version >= 5 ? 15 : (version >= 4 ? 14 : (version >= 3 ? 11 : 10)));
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the SSTFooter struct's functions.
+// Implementation of the serialize function.
+void SSTFooter::serialize(void *page) const
+{
+    long *longs = static_cast<long *>(page);
+    std::memset(page, 0, PAGE_SIZE);
+    longs[0] = version;
+    longs[1] = num_entries;
+    longs[2] = min_key;
+    longs[3] = max_key;
+    longs[4] = data_offset;
+    longs[5] = data_size;
+    longs[6] = index_offset;
+    longs[7] = index_size;
+    longs[8] = filter_offset;
+    longs[9] = filter_size;
+    long footer_longs = getFooterLongs(version);
+    if (version >= 3)
+    {
+        longs[10] = static_cast<long>(page_encoding);
+    }
+    if (version >= 4)
+    {
+        longs[11] = static_cast<long>(compression);
+        longs[12] = block_index_offset;
+        longs[13] = block_index_size;
+    }
+    if (version >= 5)
+    {
+        longs[14] = page_size;
+    }
+    if (version >= 6)
+    {
+        longs[15] = tombstone_offset;
+        longs[16] = tombstone_size;
+        longs[17] = checksum_offset;
+        longs[18] = checksum_size;
+    }
+    longs[footer_longs] = crc32c(longs, footer_longs * sizeof(long));
+    longs[PAGE_SIZE / sizeof(long) - 1] = SST_FOOTER_MAGIC;
+}
+
+/*
+    Reads the footer from a page. The last page of an SST written as separate
+    files is a data page, which is told apart by the magic number and the
+    checksum, so the footer is left unchanged and false is returned.
+*/
+bool SSTFooter::deserialize(const void *page)
+{
+    const long *longs = static_cast<const long *>(page);
+    if (longs[PAGE_SIZE / sizeof(long) - 1] != SST_FOOTER_MAGIC)
+    {
+        return false;
+    }
+    long footer_longs = getFooterLongs(longs[0]);
+    if (longs[footer_longs] != static_cast<long>(crc32c(longs, footer_longs * sizeof(long))))
+    {
+        return false;
+    }
+    if (longs[0] < 2 || longs[0] > SST_FORMAT_VERSION)
+    {
+        std::cerr << "Error: Unsupported SST format version " << longs[0] << std::endl;
+        return false;
+    }
+    // Only plain, uncompressed pages of long keys and slotted pages can be larger than PAGE_SIZE
+    bool is_large_page_encoding = longs[11] == static_cast<long>(CompressionType::NONE) &&
+                                  (longs[10] == static_cast<long>(PageEncoding::PLAIN) || longs[10] == static_cast<long>(PageEncoding::SLOTTED));
+    if (longs[0] >= 5 && (!isValidPageSize(longs[14]) || (longs[14] != static_cast<long>(PAGE_SIZE) && !is_large_page_encoding)))
+    {
+        std::cerr << "Error: Unsupported SST page size " << longs[14] << std::endl;
+        return false;
+    }
+    version = longs[0];
+    num_entries = longs[1];
+    min_key = longs[2];
+    max_key = longs[3];
+    data_offset = longs[4];
+    data_size = longs[5];
+    index_offset = longs[6];
+    index_size = longs[7];
+    filter_offset = longs[8];
+    filter_size = longs[9];
+    page_encoding = version >= 3 ? static_cast<PageEncoding>(longs[10]) : PageEncoding::PLAIN;
+    compression = version >= 4 ? static_cast<CompressionType>(longs[11]) : CompressionType::NONE;
+    block_index_offset = version >= 4 ? longs[12] : 0;
+    block_index_size = version >= 4 ? longs[13] : 0;
+    page_size = version >= 5 ? longs[14] : PAGE_SIZE;
+    tombstone_offset = version >= 6 ? longs[15] : 0;
+    tombstone_size = version >= 6 ? longs[16] : 0;
+    checksum_offset = version >= 6 ? longs[17] : 0;
+    checksum_size = version >= 6 ? longs[18] : 0;
+    return true;
+}
+////////////////////////////////////////////////////////////////////////////
+
+/*
+    Reads the block index of a compressed SST into the footer, from the mapping
+    if given, otherwise from the file. Returns false if it could not be read or
+    does not match its checksum.
+*/
+static bool readBlockIndex(const std::string &sst_filename, SSTFooter &footer, const MappedFile *sst_map, int fd)
+{
+    size_t num_bytes = (footer.block_index_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    long first_page = footer.block_index_offset / PAGE_SIZE;
+    const long *offsets = nullptr;
+    void *pages = nullptr;
+    if (sst_map != nullptr)
+    {
+        if (sst_map->getSize() < footer.block_index_offset + num_bytes ||
+            !isPageIntact(sst_filename, first_page, sst_map->getData() + footer.block_index_offset, true, num_bytes))
+        {
+            return false;
+        }
+        offsets = reinterpret_cast<const long *>(sst_map->getData() + footer.block_index_offset);
+    }
+    else
+    {
+        if (posix_memalign(&pages, PAGE_SIZE, num_bytes) != 0)
+        {
+            return false;
+        }
+        if (pread(fd, pages, num_bytes, footer.block_index_offset) != static_cast<ssize_t>(num_bytes) || !isPageIntact(sst_filename, first_page, pages, false, num_bytes))
+        {
+            free(pages);
+            return false;
+        }
+        offsets = static_cast<const long *>(pages);
+    }
+    footer.block_offsets = std::make_shared<const std::vector<long>>(offsets, offsets + footer.block_index_size / sizeof(long));
+    free(pages);
+    return true;
+}
+
+/*
+    Reads the footer of an SST from its last page (from the mapping if given),
+    and the block index of a compressed SST. Returns false if the SST has no
+    footer (it was written as separate files) or could not be read, in which
+    case the footer is left unchanged.
+*/
+bool readSSTFooter(const std::string &sst_filename, SSTFooter &footer, const MappedFile *sst_map)
+{
+    SSTFooter read_footer;
+    if (sst_map != nullptr)
+    {
+        long num_pages = sst_map->getNumPages();
+        if (num_pages == 0 || sst_map->getSize() % PAGE_SIZE != 0 || !read_footer.deserialize(sst_map->getPage(num_pages - 1)) ||
+            (read_footer.isCompressed() && !readBlockIndex(sst_filename, read_footer, sst_map, -1)))
+        {
+            return false;
+        }
+        footer = read_footer;
+        return true;
+    }
+
+    int fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0)
+    {
+        return false;
+    }
+    off_t file_size = lseek(fd, 0, SEEK_END);
+    bool is_read = false;
+    void *page = nullptr;
+    if (file_size >= static_cast<off_t>(PAGE_SIZE) && file_size % PAGE_SIZE == 0 && posix_memalign(&page, PAGE_SIZE, PAGE_SIZE) == 0)
+    {
+        is_read = pread(fd, page, PAGE_SIZE, file_size - PAGE_SIZE) == static_cast<ssize_t>(PAGE_SIZE) && read_footer.deserialize(page) &&
+                  (!read_footer.isCompressed() || readBlockIndex(sst_filename, read_footer, nullptr, fd));
+        free(page);
+    }
+    close(fd);
+    if (is_read)
+    {
+        footer = read_footer;
+    }
+    return is_read;
+}
+
+/*
+    Reads the checksum block of a single-file SST into checksums, and the
+    number of pages it must cover (every page before it) into num_pages. The
+    pages are not checked against it (the footer is checked against its own
+    checksum), since it is what they are checked against. Returns false if the
+    file has no footer or its footer has no checksum block (it was written
+    before version 6), in which case both are left unchanged.
+*/
+bool readSSTChecksumBlock(const std::string &sst_filename, std::vector<uint32_t> &checksums, long &num_pages)
+{
+    int fd = open(sst_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    off_t file_size = lseek(fd, 0, SEEK_END);
+    std::vector<long> page(PAGE_SIZE / sizeof(long));
+    SSTFooter footer;
+    bool has_block = file_size >= static_cast<off_t>(PAGE_SIZE) && file_size % PAGE_SIZE == 0 &&
+                     pread(fd, page.data(), PAGE_SIZE, file_size - PAGE_SIZE) == static_cast<ssize_t>(PAGE_SIZE) && footer.deserialize(page.data()) &&
+                     footer.hasChecksumBlock();
+    if (has_block)
+    {
+        // A block cut short by a truncated file only holds the checksums that could be read
+        checksums.resize(footer.checksum_size / sizeof(uint32_t));
+        ssize_t bytes_read = pread(fd, checksums.data(), checksums.size() * sizeof(uint32_t), footer.checksum_offset);
+        checksums.resize(std::max<ssize_t>(bytes_read, 0) / sizeof(uint32_t));
+        num_pages = footer.checksum_offset / PAGE_SIZE;
+    }
+    close(fd);
+    return has_block;
+}
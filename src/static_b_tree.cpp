@@ -1,5 +1,10 @@
 #include "static_b_tree.h"
+#include "page_search.h"
+#include "sst.h"
+#include "checksum.h"
+#include "packed_page.h"
 #include <fstream>
+#include <cstdio>
 #include <algorithm>
 #include <iostream>
 
@@ -24,6 +29,24 @@ BTreeNode::BTreeNode(bool leaf) : num_keys(0), is_leaf(leaf)
     pages_or_values.fill(-1); // Initialize all elements to -1
 }
 
+/*
+    Constructor for PageView.
+
+    Input:
+        page                The page data, read in place.
+
+    Initializes:
+        longs               Set to the page data.
+        num_keys            Set to the number of keys that are neither padding (-1) nor the LEAF marker.
+*/
+PageView::PageView(const char *page) : longs(reinterpret_cast<const long *>(page)), num_keys(0)
+{
+    for (size_t i = 0; i < MAX_PAIRS; ++i) {
+        long key = longs[i * 2];
+        num_keys += (key != -1 && key != LEAF);
+    }
+}
+
 /*
     Constructor for StaticBTree.
 
@@ -32,7 +55,7 @@ BTreeNode::BTreeNode(bool leaf) : num_keys(0), is_leaf(leaf)
         btree_filename      Empty filename for B-Tree, set later upon initialization.
         root_page_index     Defaulted to 0, updated when the B-Tree root node is created.
 */
-StaticBTree::StaticBTree() : sst_filename(""), btree_filename(""), root_page_index(0) {}
+StaticBTree::StaticBTree() : root_page_index(0), sst_filename(""), btree_filename(""), sst_map(nullptr), btree_map(nullptr), layout(DEFAULT_INDEX_LAYOUT), index_first_page(0), num_index_pages(-1), is_packed(false) {}
 
 /*
     Overloaded constructor for StaticBTree.
@@ -45,7 +68,37 @@ StaticBTree::StaticBTree() : sst_filename(""), btree_filename(""), root_page_ind
         root_page_index     Set to 0, updated when root node is created.
 */
 StaticBTree::StaticBTree(std::string sst_filename, std::string btree_filename)
-    : sst_filename(sst_filename), btree_filename(btree_filename), root_page_index(0) {}
+    : root_page_index(0), sst_filename(sst_filename), btree_filename(btree_filename), sst_map(nullptr), btree_map(nullptr), layout(DEFAULT_INDEX_LAYOUT), index_first_page(0), num_index_pages(-1), is_packed(false) {}
+
+/*
+    Overloaded constructor for StaticBTree that reads its pages from memory mappings
+    of the SST and B-Tree files instead of from disk.
+
+    Input:
+        sst_filename        Filename for SST data storage.
+        btree_filename      Filename for B-Tree storage.
+        sst_map             The mapping of the SST file.
+        btree_map           The mapping of the B-Tree file.
+
+    Initializes:
+        root_page_index     Set to 0, updated when root node is created.
+*/
+StaticBTree::StaticBTree(std::string sst_filename, std::string btree_filename, MappedFile *sst_map, MappedFile *btree_map)
+    : root_page_index(0), sst_filename(sst_filename), btree_filename(btree_filename), sst_map(sst_map), btree_map(btree_map), layout(DEFAULT_INDEX_LAYOUT), index_first_page(0), num_index_pages(-1), is_packed(false) {}
+
+/*
+    Overloaded constructor for StaticBTree that chooses the layout of the index it writes.
+
+    Input:
+        sst_filename        Filename for SST data storage.
+        btree_filename      Filename for B-Tree storage.
+        layout              Layout of the index written by finalizeTree and writeNodes.
+
+    Initializes:
+        root_page_index     Set to 0, updated when root node is created.
+*/
+StaticBTree::StaticBTree(std::string sst_filename, std::string btree_filename, IndexLayout layout)
+    : root_page_index(0), sst_filename(sst_filename), btree_filename(btree_filename), sst_map(nullptr), btree_map(nullptr), layout(layout), index_first_page(0), num_index_pages(-1), is_packed(false) {}
 
 ////////////////////////////////////////////////////////////////////////////
 // Private: Primary Functions
@@ -54,46 +107,69 @@ StaticBTree::StaticBTree(std::string sst_filename, std::string btree_filename)
 //     Binary search helper function for locating a key.
 
 //     Input:
-//         keys                Array of sorted keys.
-//         num_keys            Number of keys in the array.
+//         page                View of the page to search.
 //         key                 The key to search for.
 
 //     Returns:
 //         Position of the key if found, or where it would be inserted.
 // */
-int StaticBTree::binarySearch(const long *keys, int num_keys, long key)
-{
-    int left = 0, right = num_keys - 1;
-
-    while (left <= right) 
-    {
-        int mid = left + (right - left) / 2;
-        long val_at_mid = keys[mid];
-
-        if (val_at_mid >= 0) 
-        { // Valid key
-            if (val_at_mid == key) 
-            {
-                return mid; // Exact match
-            } 
-            else if (val_at_mid < key) 
-            {
-                left = mid + 1; // Search in the right half
-            } 
-            else 
-            {
-                right = mid - 1; // Search in the left half
-            }
-        } 
-        else if (mid == MAX_PAIRS - 1 && (val_at_mid == -1 || val_at_mid == LEAF)) 
-        {
-            // If key is greater than all valid keys, direct to the last child
-            return num_keys - 1; // Return the last valid index for traversal
+int StaticBTree::binarySearch(const PageView &page, long key)
+{
+    // The keys of a Node are sorted and valid, so the insertion point is their lower bound (found with SIMD when the CPU supports it)
+    return pageLowerBound(page.getKeys(), page.getNumKeys(), 2, key);
+}
+
+/*
+    Searches a plain or columnar page of the data block of a single-file SST for
+    a key. The footer gives the number of key-value pairs in the page, which
+    may be larger than PAGE_SIZE. The keys of a columnar page are contiguous,
+    so they are searched with a stride of one long and the value is read from
+    the second half of the page.
+
+    Input:
+        page_data           The content of the page.
+        data_page           Index of the page in the data block.
+        key                 The key to search for.
+
+    Returns:
+        Value associated with the key, or -1 if not found.
+*/
+long StaticBTree::searchDataPage(const char *page_data, long data_page, long key)
+{
+    const long *page_longs = reinterpret_cast<const long *>(page_data);
+    long entries_page = footer.getEntriesInPage(data_page);
+    bool is_columnar = footer.isColumnar();
+    long pos = pageLowerBound(page_longs, entries_page, footer.getKeyStride(), key);
+    return pos < entries_page && getDataPageKey(page_longs, pos, is_columnar) == key ? getDataPageValue(page_longs, pos, is_columnar) : -1;
+}
+
+/*
+    Appends the key-value pairs of a plain or columnar page of the data block of
+    a single-file SST within a range to the results.
+
+    Input:
+        page_data           The content of the page.
+        data_page           Index of the page in the data block.
+        key1                Start of the key range.
+        key2                End of the key range.
+        results             Vector the key-value pairs within the specified range are appended to.
+
+    Returns:
+        False if the page holds a key past the range, true otherwise.
+*/
+bool StaticBTree::scanDataPage(const char *page_data, long data_page, long key1, long key2, std::vector<std::pair<long, long>> &results)
+{
+    const long *page_longs = reinterpret_cast<const long *>(page_data);
+    long entries_page = footer.getEntriesInPage(data_page);
+    bool is_columnar = footer.isColumnar();
+    for (long i = pageLowerBound(page_longs, entries_page, footer.getKeyStride(), key1); i < entries_page; ++i) {
+        long curr_key = getDataPageKey(page_longs, i, is_columnar);
+        if (curr_key > key2) {
+            return false;
         }
+        results.emplace_back(curr_key, getDataPageValue(page_longs, i, is_columnar));
     }
-
-    // Return the index of the closest child page for the key
-    return left;
+    return true;
 }
 
 /*
@@ -109,28 +185,42 @@ int StaticBTree::binarySearch(const long *keys, int num_keys, long key)
 */
 long StaticBTree::get(long page_index, long key, BufferPool *buffer_pool, Page *prev_page)
 {
-    char page[PAGE_SIZE];
+    countPageRead();
+    alignas(PAGE_SIZE) char page[MAX_PAGE_SIZE];
+
+    const char *page_data = page;
 
+    // A compressed SST page is decompressed (and cached decompressed in the buffer pool), and a page larger than PAGE_SIZE is read whole
+    if (isDataPage(page_index) && (footer.isCompressed() || footer.page_size > static_cast<long>(PAGE_SIZE))) {
+        page_data = readSSTDataPage(sst_filename, footer, getDataPage(page_index), page, buffer_pool, sst_map);
+        if (!page_data) {
+            return -1; // Return immediately on failure
+        }
+    }
+    // If the files are mapped, then read the page in place without a system call or a copy
+    else if (btree_map) {
+        page_data = getMappedPage(page_index);
+        if (!page_data) {
+            return -1; // Return immediately on failure
+        }
+    }
     // If page is already in the buffer pool, then retrieve it from the buffer pool, otherwise, read the page from the B-Tree file and if the buffer pool exists, then add it to the buffer pool as a new page.
-    std::string filename_offset = btree_filename + std::to_string(page_index * PAGE_SIZE);
-    if (buffer_pool) {
+    else if (buffer_pool) {
+        const std::string &filename_offset = getNodePageId(page_index);
         Page *possible_page = buffer_pool->searchForPage(filename_offset);
         if (possible_page && possible_page != prev_page)
         {
-            // If the page is in the buffer pool then we get the page from the buffer pool.
+            // If the page is in the buffer pool then we search it in place, as nothing is evicted before we are done with it.
             // std::cerr << "Saved 1 I/O by reading " << filename_offset << " from BufferPool while finding key: " << key << ".\n";
-            std::memcpy(page, possible_page->data, PAGE_SIZE);
+            page_data = possible_page->data;
+            if (!isCachedNodePageIntact(page_index, page_data)) {
+                return -1;
+            }
         }
         else
         {
-            if (loadPage(btree_filename, page_index, page) < 0)
-            {
-                if (page_index > 0) {
-                    page_index--;
-                }
-                if (loadPage(sst_filename, page_index, page) < 0) {
-                    return -1; // Return immediately on failure
-                }
+            if (loadNodePage(page_index, page) < 0) {
+                return -1; // Return immediately on failure
             }
 
             Page *page_struct = new Page(filename_offset, page);
@@ -139,19 +229,28 @@ long StaticBTree::get(long page_index, long key, BufferPool *buffer_pool, Page *
         }
     }
     else {
-        if (loadPage(btree_filename, page_index, page) < 0)
-        {
-            if (page_index > 0) {
-                page_index--;
-            }
-            if (loadPage(sst_filename, page_index - 1, page) < 0) {
-                return -1; // Return immediately on failure
-            } 
+        if (loadNodePage(page_index, page) < 0) {
+            return -1; // Return immediately on failure
         }
     }
 
-    // Retrieve all of the values from the page we read
-    auto [is_leaf, num_keys, keys, pages_or_values] = readPageContents(page);
+    // A B-Tree file written in the S_TREE layout starts with a header page instead of the Root Node
+    if (page_index == root_page_index && *reinterpret_cast<const long *>(page_data) == S_TREE_MAGIC) {
+        return sTreeGet(page_data, key, buffer_pool);
+    }
+
+    // A packed SST page is searched by its decoded keys
+    if (is_packed && isDataPage(page_index)) {
+        long pos = findPackedKey(page_data, key);
+        return pos < 0 ? -1 : getPackedPageValues(page_data)[pos];
+    }
+    if (num_index_pages >= 0 && isDataPage(page_index)) {
+        return searchDataPage(page_data, getDataPage(page_index), key);
+    }
+
+    // View the keys and values of the page we read in place
+    PageView page_view(page_data);
+    int num_keys = page_view.getNumKeys();
 
     // If the number of keys in the page we read is less than or equal to 0, that means that there was some sort of error, so return -1
     if (num_keys <= 0) {
@@ -159,19 +258,19 @@ long StaticBTree::get(long page_index, long key, BufferPool *buffer_pool, Page *
         return -1;
     }
 
-    // If the page we read is a Leaf Node, then retrieve the value at key and return it
-    if (is_leaf) {
-        int pos = binarySearch(keys.data(), num_keys, key);
+    // If the page we read is a Leaf Node, then retrieve the value at key and return it (the last SST page of a single-file SST has no LEAF marker)
+    if (isDataPage(page_index) || page_view.isLeaf()) {
+        int pos = binarySearch(page_view, key);
         if (pos == LEAF) {
-            return pages_or_values[MAX_PAIRS - 1];
+            return page_view.getPageOrValue(MAX_PAIRS - 1);
         }
-        else if (pos < num_keys && keys[pos] == key) {
-            return pages_or_values[pos];
+        else if (pos < num_keys && page_view.getKey(pos) == key) {
+            return page_view.getPageOrValue(pos);
         }
     } 
     // If the page we read is an Internal Node, then search the page we have read to determine if key exists in it or if it exist in another Internal Node
     else {
-        int pos = binarySearch(keys.data(), num_keys, key);
+        int pos = binarySearch(page_view, key);
         if (pos == -1) {
             // If pos is -1 and num_keys is 255 (MAX_PAIRS - 1), that means we need to retrieve the value at 255 from pages_or_values
             if (num_keys == MAX_PAIRS - 1) {
@@ -184,10 +283,10 @@ long StaticBTree::get(long page_index, long key, BufferPool *buffer_pool, Page *
         }
 
         // If pages_or_values[pos] is still -1 for some reason, then iteratively decrease pos by 1 to move backwards through pages_or_values to find the first position where pages_or_values[pos] is not -1
-        while (pages_or_values[pos] == -1) {
+        while (page_view.getPageOrValue(pos) == -1) {
             pos--;
         }
-        int child_page = pages_or_values[pos];
+        int child_page = page_view.getPageOrValue(pos);
 
         // Recursively call get with the child_page that we found
         return get(child_page, key, buffer_pool, prev_page);
@@ -205,35 +304,45 @@ long StaticBTree::get(long page_index, long key, BufferPool *buffer_pool, Page *
         key1                Start of the key range.
         key2                End of the key range.
         buffer_pool         The BufferPool containing recently read pages.
-
-    Returns:
-        Vector of key-value pairs within the specified range.
+        results             Vector the key-value pairs within the specified range are appended to.
 */
-std::vector<std::pair<long, long>> StaticBTree::scan(long page_index, long key1, long key2, BufferPool *buffer_pool, Page *prev_page)
+void StaticBTree::scan(long page_index, long key1, long key2, BufferPool *buffer_pool, Page *prev_page, std::vector<std::pair<long, long>> &results)
 {
-    std::vector<std::pair<long, long>> results;
-    char page[PAGE_SIZE];
+    alignas(PAGE_SIZE) char page[MAX_PAGE_SIZE];
+
+    const char *page_data = page;
 
+    // A compressed SST page is decompressed (and cached decompressed in the buffer pool), and a page larger than PAGE_SIZE is read whole
+    if (isDataPage(page_index) && (footer.isCompressed() || footer.page_size > static_cast<long>(PAGE_SIZE))) {
+        page_data = readSSTDataPage(sst_filename, footer, getDataPage(page_index), page, buffer_pool, sst_map);
+        if (!page_data) {
+            return; // Return immediately on failure
+        }
+    }
+    // If the files are mapped, then read the page in place without a system call or a copy
+    else if (btree_map) {
+        page_data = getMappedPage(page_index);
+        if (!page_data) {
+            return; // Return immediately on failure
+        }
+    }
     // If page is already in the buffer pool, then retrieve it from the buffer pool, otherwise, read the page from the B-Tree file and if the buffer pool exists, then add it to the buffer pool as a new page.
-    std::string filename_offset = btree_filename + std::to_string(page_index * PAGE_SIZE);
-    if (buffer_pool) {
+    else if (buffer_pool) {
+        const std::string &filename_offset = getNodePageId(page_index);
         Page *possible_page = buffer_pool->searchForPage(filename_offset);
         if (possible_page && possible_page != prev_page)
         {
-            // If the page is in the buffer pool then we get the page from the buffer pool.
+            // If the page is in the buffer pool then we copy it to the stack, as scanning the children may evict it.
             // std::cerr << "Saved 1 I/O by reading " << filename_offset << " from BufferPool while finding key: " << key << ".\n";
             std::memcpy(page, possible_page->data, PAGE_SIZE);
+            if (!isCachedNodePageIntact(page_index, page)) {
+                return;
+            }
         }
         else
         {
-            if (loadPage(btree_filename, page_index, page) < 0)
-            {
-                if (page_index > 0) {
-                    page_index--;
-                }
-                if (loadPage(sst_filename, page_index, page) < 0) {
-                    return results; // Return immediately on failure
-                }
+            if (loadNodePage(page_index, page) < 0) {
+                return; // Return immediately on failure
             }
 
             Page *page_struct = new Page(filename_offset, page);
@@ -242,49 +351,161 @@ std::vector<std::pair<long, long>> StaticBTree::scan(long page_index, long key1,
         }
     }
     else {
-        if (loadPage(btree_filename, page_index, page) < 0)
-        {
-            if (page_index > 0) {
-                page_index--;
-            }
-            if (loadPage(sst_filename, page_index - 1, page) < 0) {
-                return results; // Return immediately on failure
-            } 
+        if (loadNodePage(page_index, page) < 0) {
+            return; // Return immediately on failure
         }
     }
 
-    // Retrieve all of the values from the page we read
-    auto [is_leaf, num_keys, keys, pages_or_values] = readPageContents(page);
+    // A B-Tree file written in the S_TREE layout starts with a header page instead of the Root Node
+    if (page_index == root_page_index && *reinterpret_cast<const long *>(page_data) == S_TREE_MAGIC) {
+        sTreeScan(page_data, key1, key2, buffer_pool, results);
+        return;
+    }
+
+    // A packed SST page is scanned by its decoded keys
+    if (is_packed && isDataPage(page_index)) {
+        scanPackedPage(page_data, key1, key2, results);
+        return;
+    }
+    if (num_index_pages >= 0 && isDataPage(page_index)) {
+        scanDataPage(page_data, getDataPage(page_index), key1, key2, results);
+        return;
+    }
+
+    // View the keys and values of the page we read in place
+    PageView page_view(page_data);
+    int num_keys = page_view.getNumKeys();
 
     // If the page we read is a Leaf Node, then retrieve all of the values at keys between key1 and key2
-    if (is_leaf) {
-        for (int i = 0; i < num_keys; ++i) {
-            if (keys[i] > key2)
+    if (isDataPage(page_index) || page_view.isLeaf()) {
+        for (int i = binarySearch(page_view, key1); i < num_keys; ++i) {
+            long key = page_view.getKey(i);
+            if (key > key2)
                 break;
-            if (keys[i] >= key1)
-                results.emplace_back(keys[i], pages_or_values[i]);
+            results.emplace_back(key, page_view.getPageOrValue(i));
         }
     }
     // If the page we read is an Internal Node, then search the page we have read to determine if key1 and key2 exist in it or if they exist in another Internal Node
     else {
-        int key1_pos = binarySearch(keys.data(), num_keys, key1);
-        int key2_pos = binarySearch(keys.data(), num_keys, key2);
+        int key1_pos = binarySearch(page_view, key1);
+        int key2_pos = binarySearch(page_view, key2);
 
         // If neither key1 nor key2 exists in the Internal Node or no index to another Internal Node was output from binarySearch, that means that key1 or key2 simply do not exist in the B-Tree so we must return an error
         if (key1_pos == -1 || key2_pos == -1) {
             std::cerr << "Please input a valid range of keys to scan over." << std::endl;
-            return results;
+            return;
         }
 
-        // If key1 or key2 exist in the Internal Node or an index to another Internal Node was output from binarySearch, then we recursively call the scan function to retrieve all of the values at keys between key1 and key2
-        for (int i = key1_pos; i <= key2_pos && i < MAX_PAIRS; ++i) {
-            auto child_results = scan(page_index + pages_or_values[i], key1, key2, buffer_pool, prev_page);
-            results.insert(results.end(), child_results.begin(), child_results.end());
+        // If key1 or key2 exist in the Internal Node or an index to another Internal Node was output from binarySearch, then we recursively call the scan function to append all of the values at keys between key1 and key2
+        for (int i = key1_pos; i <= key2_pos && i < static_cast<int>(MAX_PAIRS); ++i) {
+            // A key2 past the last key of a node that is not full leads to an unused child, as in get
+            if (page_view.getPageOrValue(i) == -1) {
+                break;
+            }
+            scan(page_index + page_view.getPageOrValue(i), key1, key2, buffer_pool, prev_page, results);
         }
     }
+}
 
-    // Return the list of key-value pairs
-    return results;
+/*
+    Retrieves a value associated with a key through the S+-tree of a B-Tree file
+    written in the S_TREE layout. The S+-tree gives the only SST page that may
+    hold the key, so a single SST page is read.
+
+    Input:
+        header              The header page of the B-Tree file.
+        key                 The key to search for.
+        buffer_pool         The BufferPool containing recently read pages.
+
+    Returns:
+        Value associated with the key, or -1 if not found.
+*/
+long StaticBTree::sTreeGet(const char *header, long key, BufferPool *buffer_pool)
+{
+    STree tree;
+    if (!loadSTree(header, tree)) {
+        return -1;
+    }
+
+    long page_index = tree.lowerBound(key);
+    if (page_index >= tree.getNumKeys()) {
+        return -1;
+    }
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    const char *page_data = readSSTPage(page_index, page_buffer, buffer_pool);
+    if (!page_data) {
+        return -1;
+    }
+    if (is_packed) {
+        long pos = findPackedKey(page_data, key);
+        return pos < 0 ? -1 : getPackedPageValues(page_data)[pos];
+    }
+    if (num_index_pages >= 0) {
+        return searchDataPage(page_data, page_index, key);
+    }
+
+    // Search the key-value pairs of the page (padding keys are negative and are never counted as smaller)
+    long pos = pageLowerBound(reinterpret_cast<const long *>(page_data), MAX_PAIRS, 2, key);
+    long key_at_pos = INTERNAL;
+    if (pos < static_cast<long>(MAX_PAIRS)) {
+        std::memcpy(&key_at_pos, page_data + pos * ENTRY_SIZE, sizeof(long));
+    }
+    if (key_at_pos != key) {
+        return -1;
+    }
+    long val_at_pos;
+    std::memcpy(&val_at_pos, page_data + pos * ENTRY_SIZE + sizeof(long), sizeof(long));
+    return val_at_pos;
+}
+
+/*
+    Scans a range of keys through the S+-tree of a B-Tree file written in the
+    S_TREE layout. The S+-tree gives the first SST page of the range, and the
+    following pages are read until a key past the range is found.
+
+    Input:
+        header              The header page of the B-Tree file.
+        key1                Start of the key range.
+        key2                End of the key range.
+        buffer_pool         The BufferPool containing recently read pages.
+        results             Vector the key-value pairs within the specified range are appended to.
+*/
+void StaticBTree::sTreeScan(const char *header, long key1, long key2, BufferPool *buffer_pool, std::vector<std::pair<long, long>> &results)
+{
+    STree tree;
+    if (!loadSTree(header, tree)) {
+        return;
+    }
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    for (long page_index = tree.lowerBound(key1); page_index < tree.getNumKeys(); ++page_index) {
+        const char *page_data = readSSTPage(page_index, page_buffer, buffer_pool);
+        if (!page_data) {
+            break;
+        }
+        if (is_packed) {
+            if (!scanPackedPage(page_data, key1, key2, results)) {
+                return;
+            }
+            continue;
+        }
+        if (num_index_pages >= 0) {
+            if (!scanDataPage(page_data, page_index, key1, key2, results)) {
+                return;
+            }
+            continue;
+        }
+
+        PageView page_view(page_data);
+        for (int i = binarySearch(page_view, key1); i < page_view.getNumKeys(); ++i) {
+            long curr_key = page_view.getKey(i);
+            if (curr_key > key2) {
+                return;
+            }
+            results.emplace_back(curr_key, page_view.getPageOrValue(i));
+        }
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -299,7 +520,7 @@ std::vector<std::pair<long, long>> StaticBTree::scan(long page_index, long key1,
         buffer              Buffer to store the page content.
 
     Returns:
-        0 on success, -1 on failure.
+        0 on success, -1 on failure, -2 if the page does not match its checksum.
 */
 int StaticBTree::loadPage(const std::string &filename, int page_index, void *buffer)
 {
@@ -318,7 +539,7 @@ int StaticBTree::loadPage(const std::string &filename, int page_index, void *buf
     off_t offset = page_index * PAGE_SIZE;
 
     off_t file_size = lseek(fd, 0, SEEK_END);
-    if (file_size < offset + PAGE_SIZE) {
+    if (file_size < offset + static_cast<off_t>(PAGE_SIZE)) {
         close(fd);
         return -1;
     }
@@ -331,48 +552,253 @@ int StaticBTree::loadPage(const std::string &filename, int page_index, void *buf
     }
 
     close(fd);
-    return 0;
+    return isPageIntact(filename, page_index, buffer, false) ? 0 : -2;
 }
 
 /*
-    Reads and extracts the contents of a B-Tree page.
+    Loads a page of the B-Tree from disk. Like getMappedPage, a page past the
+    end of the B-Tree file is read from the SST file instead, but a B-Tree page
+    that does not match its checksum is never replaced by an SST page. The
+    pages of a single-file SST are all read from the SST file (see getFilePage).
 
     Input:
-        page                Buffer containing the page data.
+        page_index          Index of the page to load, moved back by one when it is read from a separate SST file.
+        buffer              Buffer to store the page content.
+
+    Returns:
+        0 on success, -1 on failure.
+*/
+int StaticBTree::loadNodePage(long &page_index, void *buffer)
+{
+    if (num_index_pages >= 0) {
+        return loadPage(sst_filename, getFilePage(page_index), buffer) == 0 ? 0 : -1;
+    }
+
+    int status = loadPage(btree_filename, page_index, buffer);
+    if (status == 0) {
+        return 0;
+    }
+    if (status == -2) {
+        return -1;
+    }
+
+    if (page_index > 0) {
+        page_index--;
+    }
+    return loadPage(sst_filename, page_index, buffer) == 0 ? 0 : -1;
+}
+
+/*
+    Checks a page of the B-Tree found in the buffer pool against its checksum
+    (only in PARANOID mode). A page past the end of the B-Tree file was read
+    from the SST file, so it is checked against the SST page before it.
+
+    Input:
+        page_index          Index of the page in the B-Tree file.
+        page_data           The content of the page.
+
+    Returns:
+        True if the page is not checked or matches its checksum, false otherwise.
+*/
+bool StaticBTree::isCachedNodePageIntact(long page_index, const char *page_data)
+{
+    if (getChecksumMode() != ChecksumMode::PARANOID) {
+        return true;
+    }
+    if (num_index_pages >= 0) {
+        return isPageIntact(sst_filename, getFilePage(page_index), page_data, true);
+    }
+    if (page_index < getNumPageChecksums(btree_filename)) {
+        return isPageIntact(btree_filename, page_index, page_data, true);
+    }
+    return isPageIntact(sst_filename, page_index - 1, page_data, true);
+}
+
+/*
+    Returns a page of the mapped B-Tree file. Like loadPage, a page past the end
+    of the B-Tree file is read from the mapped SST file instead.
+
+    Input:
+        page_index          Index of the page to return, moved back by one when it is read from the SST file.
+
+    Returns:
+        A pointer to the mapped page, or nullptr on failure.
+*/
+const char *StaticBTree::getMappedPage(long &page_index)
+{
+    if (num_index_pages >= 0) {
+        const char *mapped_page = btree_map->getPage(getFilePage(page_index));
+        return mapped_page && isPageIntact(sst_filename, getFilePage(page_index), mapped_page, true) ? mapped_page : nullptr;
+    }
+
+    const char *mapped_page = btree_map->getPage(page_index);
+    if (mapped_page) {
+        return isPageIntact(btree_filename, page_index, mapped_page, true) ? mapped_page : nullptr;
+    }
+
+    if (page_index > 0) {
+        page_index--;
+    }
+    mapped_page = sst_map ? sst_map->getPage(page_index) : nullptr;
+    return mapped_page && isPageIntact(sst_filename, page_index, mapped_page, true) ? mapped_page : nullptr;
+}
+
+/*
+    Returns a page of the SST file, read in place from its mapping, copied from
+    the buffer pool, or read from disk (and then added to the buffer pool). The
+    data pages of a single-file SST are read as its footer describes them
+    (see readSSTDataPage).
+
+    Input:
+        page_index          Index of the SST page to return.
+        page_buffer         Buffer to store the page content when it is not mapped (MAX_PAGE_SIZE bytes).
+        buffer_pool         The BufferPool containing recently read pages.
 
     Returns:
-        A tuple with the leaf status, number of keys, key vector, and pages/values vector.
+        A pointer to the page, or nullptr on failure.
 */
-std::tuple<bool, int, std::vector<long>, std::vector<long>> StaticBTree::readPageContents(char page[PAGE_SIZE])
+const char *StaticBTree::readSSTPage(long page_index, char *page_buffer, BufferPool *buffer_pool)
 {
-    char *curr_offset = page;
-    std::array<long, MAX_PAIRS> keys, pages_or_values;
-    bool is_leaf = (*reinterpret_cast<long *>(page + 4080) != (long)-1);
+    countPageRead();
+    if (num_index_pages >= 0) {
+        return readSSTDataPage(sst_filename, footer, page_index, page_buffer, buffer_pool, sst_map);
+    }
+    if (sst_map) {
+        const char *mapped_page = sst_map->getPage(page_index);
+        return mapped_page && isPageIntact(sst_filename, page_index, mapped_page, true) ? mapped_page : nullptr;
+    }
 
-    int curr_key = 0;
-    while (curr_key < MAX_PAIRS) {
-        memcpy(&keys[curr_key], curr_offset, sizeof(long));
-        curr_offset += sizeof(long) * 2;
-        curr_key++;
+    const std::string &filename_offset = getPageId(sst_filename, page_index);
+    Page *cached_page = buffer_pool ? buffer_pool->searchForPage(filename_offset) : nullptr;
+    if (cached_page) {
+        return isPageIntact(sst_filename, page_index, cached_page->data, true) ? cached_page->data : nullptr;
     }
 
-    int curr_val = 0;
-    curr_offset = page + sizeof(long);
-    while (curr_val < MAX_PAIRS) {
-        memcpy(&pages_or_values[curr_val], curr_offset, sizeof(long));
-        curr_offset += sizeof(long) * 2;
-        curr_val++;
+    if (loadPage(sst_filename, page_index, page_buffer) < 0) {
+        return nullptr;
+    }
+    if (buffer_pool) {
+        buffer_pool->insertPage(new Page(filename_offset, page_buffer));
+    }
+    return page_buffer;
+}
+
+/*
+    Loads the S+-tree of a B-Tree file written in the S_TREE layout. A mapped
+    file is searched in place, otherwise the blocks are read from disk.
+
+    Input:
+        header              The header page of the B-Tree file.
+        tree                The STree to load the blocks into.
+
+    Returns:
+        True on success, false on failure.
+*/
+bool StaticBTree::loadSTree(const char *header, STree &tree)
+{
+    const long *header_longs = reinterpret_cast<const long *>(header);
+    long num_keys = header_longs[1];
+    long num_longs = header_longs[3];
+    size_t num_bytes = (num_longs * sizeof(long) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    // The blocks follow the header page, which is the first page of the index block of a single-file SST
+    long first_page = (num_index_pages >= 0 ? index_first_page : 0) + 1;
+
+    if (btree_map) {
+        if (btree_map->getSize() < first_page * PAGE_SIZE + num_bytes) {
+            std::cerr << "Error: Truncated S+-Tree in " << btree_filename << std::endl;
+            return false;
+        }
+        const char *blocks = btree_map->getData() + first_page * PAGE_SIZE;
+        return isPageIntact(btree_filename, first_page, blocks, true, num_bytes) && tree.load(reinterpret_cast<const long *>(blocks), num_keys, false);
+    }
+
+    void *blocks = nullptr;
+    if (posix_memalign(&blocks, PAGE_SIZE, num_bytes) != 0) {
+        std::cerr << "Error: Memory alignment allocation failed for the S+-Tree." << std::endl;
+        return false;
+    }
+
+    int fd = open(btree_filename.c_str(), O_RDONLY | O_DIRECT);
+    ssize_t bytes_read = fd < 0 ? -1 : pread(fd, blocks, num_bytes, first_page * PAGE_SIZE);
+    if (fd >= 0) {
+        close(fd);
+    }
+    bool is_loaded = bytes_read == static_cast<ssize_t>(num_bytes) && isPageIntact(btree_filename, first_page, blocks, false, num_bytes) &&
+                     tree.load(static_cast<const long *>(blocks), num_keys, true);
+    if (!is_loaded) {
+        std::cerr << "Error: Could not read the S+-Tree in " << btree_filename << std::endl;
+    }
+    free(blocks);
+    return is_loaded;
+}
+
+/*
+    Builds the BufferPool id of a page in the reused page_id buffer, so the
+    buffer pool can be searched without allocating a new string per page.
+
+    Input:
+        filename            Filename of the B-Tree or SST file.
+        page_index          Index of the page.
+
+    Returns:
+        The id of the page, valid until the next call.
+*/
+const std::string &StaticBTree::getPageId(const std::string &filename, long page_index)
+{
+    char offset[24];
+    int offset_length = std::snprintf(offset, sizeof(offset), "%ld", page_index * PAGE_SIZE);
+    page_id.assign(filename);
+    page_id.append(offset, offset_length);
+    return page_id;
+}
+
+/*
+    Builds the BufferPool id of a page of the B-Tree. A page read from the SST
+    file is given the id of the SST page, so it is shared with readSSTPage.
+
+    Input:
+        page_index          Index of the page in the B-Tree.
+
+    Returns:
+        The id of the page, valid until the next call.
+*/
+const std::string &StaticBTree::getNodePageId(long page_index)
+{
+    if (num_index_pages >= 0) {
+        return getPageId(sst_filename, getFilePage(page_index));
     }
+    return getPageId(btree_filename, page_index);
+}
 
-    int num_keys = getNumKeys(keys);
+/*
+    Maps a page of the B-Tree of a single-file SST to its page in the file.
+    Like a separate B-Tree file, the index block holds the first pages, and a
+    page past it is the SST page before it (see loadNodePage).
+
+    Input:
+        page_index          Index of the page in the B-Tree.
 
-    if (num_keys < 0 || num_keys > MAX_PAIRS) {
-        std::cerr << "Error: Invalid number of keys read from page" << std::endl;
-        num_keys = 0; // Prevent further undefined behavior
+    Returns:
+        The index of the page in the SST file.
+*/
+long StaticBTree::getFilePage(long page_index) const
+{
+    if (page_index < num_index_pages) {
+        return index_first_page + page_index;
     }
+    return std::max(page_index - 1, 0L);
+}
 
-    return {is_leaf, num_keys, std::vector<long>(keys.begin(), keys.end()),
-            std::vector<long>(pages_or_values.begin(), pages_or_values.end())};
+// Implementation of the isDataPage function.
+bool StaticBTree::isDataPage(long page_index) const
+{
+    return num_index_pages >= 0 && page_index >= num_index_pages;
+}
+
+// Implementation of the getDataPage function.
+long StaticBTree::getDataPage(long page_index) const
+{
+    return getFilePage(page_index) - footer.data_offset / PAGE_SIZE;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -390,6 +816,12 @@ std::tuple<bool, int, std::vector<long>, std::vector<long>> StaticBTree::readPag
         Inserts the key-page pair into the current Internal Node and updates `num_keys`.
 */
 void StaticBTree::insertInternalNode(long key, long page) {
+    // The S_TREE layout only needs the largest key of every page
+    if (layout == IndexLayout::S_TREE) {
+        leaf_max_keys.push_back(key);
+        return;
+    }
+
     // If the nodes vector for the B-Tree is empty, then create a new Internal Node and add it to the nodes vector
     if (nodes.empty()) {
         BTreeNode new_internal = BTreeNode(false);
@@ -424,7 +856,7 @@ void StaticBTree::insertInternalNode(long key, long page) {
 void StaticBTree::insertLeafNode(int fd, void *buffer, BTreeNode &leaf_node, size_t &write_offset, long key, long value)
 {
     // If the input Leaf Node has space in it, add the key-value pair to it
-    if (leaf_node.num_keys < MAX_PAIRS) {
+    if (leaf_node.num_keys < static_cast<int>(MAX_PAIRS)) {
         leaf_node.keys[leaf_node.num_keys] = key;
         leaf_node.pages_or_values[leaf_node.num_keys] = value;
         leaf_node.num_keys++;
@@ -451,6 +883,12 @@ void StaticBTree::insertLeafNode(int fd, void *buffer, BTreeNode &leaf_node, siz
 */
 void StaticBTree::finalizeTree()
 {
+    // In the S_TREE layout, the index is an S+-tree over the largest key of every page
+    if (layout == IndexLayout::S_TREE) {
+        s_tree.build(leaf_max_keys);
+        return;
+    }
+
     // If the last Internal Node in nodes is empty, then just remove it from the vector
     if (nodes.back().num_keys == 0) {
         nodes.pop_back();
@@ -500,7 +938,7 @@ void StaticBTree::finalizeTree()
     }
 
     // Iterate through all of the Internal Nodes (excluding the Root Node) and ensure that the page index for the Internal Nodes are all updated correctly
-    for (int i = 1; i < nodes.size(); ++i) {
+    for (size_t i = 1; i < nodes.size(); ++i) {
         BTreeNode &internal_node = nodes[i];
         std::transform(
             internal_node.pages_or_values.begin(), 
@@ -519,8 +957,9 @@ void StaticBTree::finalizeTree()
         fd                  The file descriptor for the output file.
         buffer              Buffer to write the Node content to.
         write_offset        Offset for writing into the buffer.
+        checksums           The CRC32C of every page written is appended to it (if given).
 */
-void StaticBTree::writeNodes(int fd, void *buffer, size_t &write_offset)
+void StaticBTree::writeNodes(int fd, void *buffer, size_t &write_offset, std::vector<uint32_t> *checksums)
 {
     // Open the file using low-level POSIX open with Direct I/O
     if (fd < 0) {
@@ -528,8 +967,16 @@ void StaticBTree::writeNodes(int fd, void *buffer, size_t &write_offset)
         return;
     }
 
+    if (layout == IndexLayout::S_TREE) {
+        s_tree.write(fd, buffer, write_offset, checksums);
+        return;
+    }
+
     for (const auto &node : nodes) {
         writeNode(fd, buffer, node, write_offset);
+        if (checksums) {
+            checksums->push_back(crc32c(buffer, PAGE_SIZE));
+        }
     }
 }
 
@@ -550,7 +997,7 @@ void StaticBTree::writeNode(int fd, void *buffer, const BTreeNode &node, size_t
     // Populate the aligned buffer with node data
     char *buffer_offset = static_cast<char *>(buffer);
     int index = 0;
-    while (index < MAX_PAIRS) {
+    while (index < static_cast<int>(MAX_PAIRS)) {
         std::memcpy(buffer_offset, &node.keys[index], sizeof(long));
         buffer_offset += sizeof(long);
         std::memcpy(buffer_offset, &node.pages_or_values[index], sizeof(long));
@@ -571,6 +1018,25 @@ void StaticBTree::writeNode(int fd, void *buffer, const BTreeNode &node, size_t
 ////////////////////////////////////////////////////////////////////////////
 // Public: Primary Functions
 
+/*
+    Reads the B-Tree from the index block of a single-file SST instead of a
+    separate B-Tree file. Does nothing for an SST without a footer.
+
+    Input:
+        footer              The footer of the SST.
+*/
+void StaticBTree::setIndexBlock(const SSTFooter &footer)
+{
+    if (!footer.isSingleFile()) {
+        return;
+    }
+    btree_filename = sst_filename;
+    index_first_page = footer.index_offset / PAGE_SIZE;
+    num_index_pages = footer.getNumIndexPages();
+    is_packed = footer.isPacked();
+    this->footer = footer;
+}
+
 /*
     Retrieves a value associated with a key from the B-Tree.
 
@@ -599,7 +1065,9 @@ long StaticBTree::get(long key, BufferPool *buffer_pool)
 */
 std::vector<std::pair<long, long>> StaticBTree::scan(long key1, long key2, BufferPool *buffer_pool)
 {
-    return scan(root_page_index, key1, key2, buffer_pool, nullptr);
+    std::vector<std::pair<long, long>> results;
+    scan(root_page_index, key1, key2, buffer_pool, nullptr, results);
+    return results;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -616,6 +1084,20 @@ std::vector<BTreeNode> StaticBTree::getNodes()
     return nodes;
 }
 
+/*
+    Getter for the number of pages writeNodes writes to the B-Tree file.
+
+    Returns:
+        The number of Nodes, or the header page and the S+-tree pages in the S_TREE layout.
+*/
+long StaticBTree::getNumIndexPages()
+{
+    if (layout == IndexLayout::S_TREE) {
+        return 1 + (s_tree.getNumLongs() * sizeof(long) + PAGE_SIZE - 1) / PAGE_SIZE;
+    }
+    return nodes.size();
+}
+
 /*
     Getter for the number of Keys in the input Node.
 
@@ -634,4 +1116,44 @@ int StaticBTree::getNumKeys(const std::array<long, MAX_PAIRS> &keys) {
 */
 bool StaticBTree::isLeaf(const std::array<long, MAX_PAIRS> &keys) {
     return keys[MAX_PAIRS - 1] != -1;
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Public: PageView Functions
+
+// Implementation of the getKey function.
+long PageView::getKey(int pos) const
+{
+    return longs[pos * 2];
+}
+
+// Implementation of the getPageOrValue function.
+long PageView::getPageOrValue(int pos) const
+{
+    return longs[pos * 2 + 1];
+}
+
+// Implementation of the getKeys function.
+const long *PageView::getKeys() const
+{
+    return longs;
+}
+
+// Implementation of the getNumKeys function.
+int PageView::getNumKeys() const
+{
+    return num_keys;
+}
+
+/*
+    Getter for whether the viewed page is an Internal Node or Leaf Node. Internal
+    Nodes are padded with -1 up to the last key, while a full Leaf page ends with
+    a key and a partial one ends with the LEAF marker.
+
+    Returns:
+        Boolean stating whether the page is a Leaf Node.
+*/
+bool PageView::isLeaf() const
+{
+    return longs[(MAX_PAIRS - 1) * 2] != -1;
+}
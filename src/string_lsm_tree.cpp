@@ -0,0 +1,622 @@
+#include "string_lsm_tree.h"
+#include "sst.h"
+#include "checksum.h"
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <map>
+
+// Returns the versioned key of a write of the key with the given sequence number.
+std::string encodeVersionedKey(std::string_view key, uint64_t sequence)
+{
+    std::string versioned_key;
+    versioned_key.reserve(key.size() + VERSIONED_KEY_SUFFIX_BYTES);
+    for (char byte : key)
+    {
+        versioned_key.push_back(byte);
+        if (byte == '\0')
+        {
+            versioned_key.push_back('\xFF');
+        }
+    }
+    versioned_key.append(2, '\0');
+    uint64_t inverted_sequence = ~sequence;
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        versioned_key.push_back(static_cast<char>((inverted_sequence >> shift) & 0xFF));
+    }
+    return versioned_key;
+}
+
+// Decodes the key and the sequence number of a versioned key, returns false if it is not a valid versioned key.
+bool decodeVersionedKey(std::string_view versioned_key, std::string &key, uint64_t &sequence)
+{
+    if (versioned_key.size() < VERSIONED_KEY_SUFFIX_BYTES || versioned_key[versioned_key.size() - VERSIONED_KEY_SUFFIX_BYTES] != '\0' ||
+        versioned_key[versioned_key.size() - VERSIONED_KEY_SUFFIX_BYTES + 1] != '\0')
+    {
+        return false;
+    }
+    std::string_view escaped_key = versioned_key.substr(0, versioned_key.size() - VERSIONED_KEY_SUFFIX_BYTES);
+    key.clear();
+    for (size_t i = 0; i < escaped_key.size(); ++i)
+    {
+        key.push_back(escaped_key[i]);
+        if (escaped_key[i] == '\0' && (++i >= escaped_key.size() || escaped_key[i] != '\xFF'))
+        {
+            return false;
+        }
+    }
+    sequence = getVersionedKeySequence(versioned_key);
+    return true;
+}
+
+// Returns the part of a versioned key shared by every version of its key (all but the sequence number).
+std::string_view getVersionedKeyPrefix(std::string_view versioned_key)
+{
+    return versioned_key.substr(0, versioned_key.size() - std::min(versioned_key.size(), sizeof(uint64_t)));
+}
+
+// Returns the sequence number of a versioned key.
+uint64_t getVersionedKeySequence(std::string_view versioned_key)
+{
+    uint64_t inverted_sequence = 0;
+    for (char byte : versioned_key.substr(getVersionedKeyPrefix(versioned_key).size()))
+    {
+        inverted_sequence = (inverted_sequence << 8) | static_cast<unsigned char>(byte);
+    }
+    return ~inverted_sequence;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Define the StringLSMTree class's constructor and destructor.
+StringLSMTree::StringLSMTree(size_t memtable_size, std::string database)
+    : memtable(new StringMemtable(memtable_size)), database_name(database), memtable_size(memtable_size)
+{
+    levels.resize(max_level);
+    std::filesystem::create_directories(DATA_FILE_PATH + database_name);
+}
+
+// Implementation of the StringLSMTree destructor.
+StringLSMTree::~StringLSMTree()
+{
+    delete memtable;
+    delete value_log;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the StringLSMTree class's private functions.
+/*
+    Writes the memtable to a new SST on level 0 and replaces it with an empty
+    one, then compacts the levels that are full. Returns false (and keeps the
+    memtable) if the SST could not be written.
+*/
+bool StringLSMTree::flushMemtable()
+{
+    std::string sst_filename = DATA_FILE_PATH + database_name + "/strsst_" + getCurrentTimestamp() + ".bin";
+    StringSSTWriter writer(sst_filename, rate_limiter, IOPriority::HIGH, getPageSize(0));
+    writer.setFilterSuffixBytes(sizeof(uint64_t));
+    std::string prev_prefix;
+    uint64_t newer_sequence = LATEST_SEQUENCE;
+    for (const auto &[key, entry] : memtable->getEntries())
+    {
+        if (keepVersion(key, entry.is_tombstone, false, prev_prefix, newer_sequence) && !writer.put(key, entry.value, entry.is_tombstone, entry.is_pointer))
+        {
+            return false;
+        }
+    }
+    if (!writer.finish())
+    {
+        return false;
+    }
+    sst_bytes_written += std::filesystem::file_size(sst_filename);
+
+    delete memtable;
+    memtable = new StringMemtable(memtable_size);
+    levels[0].push_back({0, sst_filename, writer.getMetadata()});
+    if (levels[0].size() >= level_size_ratio)
+    {
+        compactLevels();
+    }
+    return true;
+}
+
+/*
+    Merges the given SSTs, ordered from the oldest to the newest, into a new
+    SST: the versions are read in key order from all of them at once, and only
+    those keepVersion keeps are written (tombstones are dropped if asked to and
+    no snapshot needs them). Returns false if an SST could not be read or the
+    new SST written.
+*/
+bool StringLSMTree::mergeSSTs(const std::vector<StringSST> &ssts, bool drop_tombstones, StringSST &merged_sst)
+{
+    std::vector<StringSSTIterator *> iterators;
+    for (const StringSST &sst : ssts)
+    {
+        iterators.push_back(new StringSSTIterator(sst.sst_filename));
+    }
+
+    // Compactions of level 0 free up room for flushes, so they are given priority over deeper compactions
+    merged_sst.sst_filename = DATA_FILE_PATH + database_name + "/strsst_" + getCurrentTimestamp() + ".bin";
+    StringSSTWriter writer(merged_sst.sst_filename, rate_limiter, ssts[0].level == 0 ? IOPriority::MEDIUM : IOPriority::LOW,
+                           getPageSize(ssts[0].level));
+    writer.setFilterSuffixBytes(sizeof(uint64_t));
+    std::string prev_prefix;
+    uint64_t newer_sequence = LATEST_SEQUENCE;
+    bool is_success = writer.isOpen();
+    while (is_success)
+    {
+        // Find the smallest key, taking the value of the newest SST that holds it
+        int newest = -1;
+        for (int i = 0; i < static_cast<int>(iterators.size()); ++i)
+        {
+            if (iterators[i]->valid() && (newest < 0 || iterators[i]->key() <= iterators[newest]->key()))
+            {
+                newest = i;
+            }
+        }
+        if (newest < 0)
+        {
+            break;
+        }
+
+        std::string key(iterators[newest]->key());
+        if (keepVersion(key, iterators[newest]->isTombstone(), drop_tombstones, prev_prefix, newer_sequence))
+        {
+            is_success = writer.put(key, iterators[newest]->value(), iterators[newest]->isTombstone(), iterators[newest]->isPointer());
+        }
+        for (StringSSTIterator *iterator : iterators)
+        {
+            if (iterator->valid() && iterator->key() == key)
+            {
+                iterator->next();
+            }
+        }
+    }
+
+    for (StringSSTIterator *iterator : iterators)
+    {
+        is_success = is_success && !iterator->hasError();
+        delete iterator;
+    }
+    if (!is_success || !writer.finish())
+    {
+        std::remove(merged_sst.sst_filename.c_str());
+        dropPageChecksums(merged_sst.sst_filename);
+        return false;
+    }
+    merged_sst.metadata = writer.getMetadata();
+    sst_bytes_written += std::filesystem::file_size(merged_sst.sst_filename);
+    return true;
+}
+
+// Implementation of the getPageSize function.
+size_t StringLSMTree::getPageSize(int level)
+{
+    return level >= first_page_level ? page_size : PAGE_SIZE;
+}
+
+// Implementation of the levelsOverlap function.
+bool StringLSMTree::levelsOverlap(std::string_view key1, std::string_view key2, int first_level)
+{
+    for (int level_idx = first_level; level_idx < static_cast<int>(levels.size()); ++level_idx)
+    {
+        for (const StringSST &sst : levels[level_idx])
+        {
+            if (sst.metadata.overlaps(key1, key2))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*
+    Merges the SSTs of every level that holds level_size_ratio SSTs into one,
+    which stays on the level if it is small enough and moves to the next level
+    otherwise. The input SSTs are kept if the merge failed.
+*/
+void StringLSMTree::compactLevels()
+{
+    for (int level_idx = 0; level_idx < static_cast<int>(levels.size()); ++level_idx)
+    {
+        bool is_last_level = (max_level - 1) == level_idx;
+        if (levels[level_idx].size() < level_size_ratio)
+        {
+            continue;
+        }
+
+        std::vector<StringSST> &level = levels[level_idx];
+        std::string min_key = level[0].metadata.min_key;
+        std::string max_key = level[0].metadata.max_key;
+        for (const StringSST &sst : level)
+        {
+            min_key = std::min(min_key, sst.metadata.min_key);
+            max_key = std::max(max_key, sst.metadata.max_key);
+        }
+
+        StringSST merged_sst{level_idx, "", StringSSTMetadata()};
+        if (!mergeSSTs(level, is_last_level || !levelsOverlap(min_key, max_key, level_idx + 1), merged_sst))
+        {
+            return;
+        }
+        for (const StringSST &sst : level)
+        {
+            std::remove(sst.sst_filename.c_str());
+            dropPageChecksums(sst.sst_filename);
+        }
+        level.clear();
+
+        // If every entry was a dropped tombstone, then there is nothing left to keep
+        if (merged_sst.metadata.empty())
+        {
+            std::remove(merged_sst.sst_filename.c_str());
+            dropPageChecksums(merged_sst.sst_filename);
+            continue;
+        }
+
+        size_t current_level_max_size = pow(level_size_ratio, level_idx + 1) * memtable_size;
+        if (std::filesystem::file_size(merged_sst.sst_filename) <= current_level_max_size || is_last_level)
+        {
+            level.push_back(merged_sst);
+        }
+        else
+        {
+            merged_sst.level = level_idx + 1;
+            levels[level_idx + 1].push_back(merged_sst);
+        }
+    }
+}
+
+// Implementation of the isVisible function.
+bool StringLSMTree::isVisible(uint64_t sequence, uint64_t newer_sequence)
+{
+    auto snapshot = snapshots.lower_bound(sequence);
+    return snapshot != snapshots.end() && *snapshot < newer_sequence;
+}
+
+/*
+    Decides whether a flush or compaction writes a version, given in key order
+    (so the versions of a key come newest first). prev_prefix and
+    newer_sequence carry the prefix and sequence number of the version before
+    it. The newest version of a key is always kept (a newer one may be in a
+    shallower level), and an older version only if a live snapshot sees it. A
+    tombstone is dropped if drop_tombstones is set (no deeper level holds the
+    key) and no snapshot is older than it, since no older version is kept then.
+*/
+bool StringLSMTree::keepVersion(std::string_view versioned_key, bool is_tombstone, bool drop_tombstones, std::string &prev_prefix, uint64_t &newer_sequence)
+{
+    std::string_view prefix = getVersionedKeyPrefix(versioned_key);
+    uint64_t sequence = getVersionedKeySequence(versioned_key);
+    bool is_newest = prefix != prev_prefix;
+    bool is_seen = is_newest || isVisible(sequence, newer_sequence);
+    if (is_newest)
+    {
+        prev_prefix.assign(prefix);
+    }
+    newer_sequence = sequence;
+
+    bool is_older_kept = !snapshots.empty() && *snapshots.begin() < sequence;
+    return is_seen && !(is_tombstone && drop_tombstones && !is_older_kept);
+}
+
+/*
+    Searches the memtable and then every level of the tree, newest SST first,
+    for the newest version of the key that is not newer than the snapshot:
+    the first versioned key from that of the key at the snapshot on. Each SST
+    whose Bloom filter might hold the key is searched through its B-Tree.
+    Returns false if the key was not found.
+*/
+bool StringLSMTree::getEntry(std::string_view key, StringEntry &entry, BufferPool *buffer_pool, uint64_t snapshot)
+{
+    std::string first_key = encodeVersionedKey(key, snapshot);
+    std::string last_key = encodeVersionedKey(key, 0);
+    std::string_view prefix = getVersionedKeyPrefix(first_key);
+    std::string found_key;
+    bool is_found = memtable->seek(first_key, last_key, found_key, entry);
+    for (int level_idx = 0; !is_found && level_idx < static_cast<int>(levels.size()); ++level_idx)
+    {
+        const std::vector<StringSST> &level = levels[level_idx];
+        for (int i = static_cast<int>(level.size()) - 1; !is_found && i >= 0; --i)
+        {
+            if (level[i].metadata.overlaps(first_key, last_key) && stringSSTMightContain(level[i].sst_filename, level[i].metadata, prefix, buffer_pool))
+            {
+                std::vector<std::pair<std::string, StringEntry>> results;
+                stringSSTScan(level[i].sst_filename, level[i].metadata, first_key, last_key, results, buffer_pool, 1);
+                if (!results.empty())
+                {
+                    entry = std::move(results[0].second);
+                    is_found = true;
+                }
+            }
+        }
+    }
+    return is_found;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the StringLSMTree class's public functions.
+/*
+    Inserts a new version of the key with the next sequence number into the
+    memtable, and flushes the memtable once it is full. A value of at least
+    value_log_threshold bytes is appended to the value log (when it is
+    enabled) and only its pointer is inserted. Returns false if the versioned
+    key is longer than STRING_SST_MAX_KEY_BYTES, the pair does not fit in a
+    page, or the value log append failed.
+*/
+bool StringLSMTree::put(std::string_view key, std::string_view value)
+{
+    bool is_separated = value_log != nullptr && value.size() >= value_log_threshold;
+    std::string versioned_key = encodeVersionedKey(key, last_sequence + 1);
+    if (versioned_key.size() > STRING_SST_MAX_KEY_BYTES || versioned_key.size() + (is_separated ? VALUE_POINTER_SIZE : value.size()) > SLOTTED_PAGE_MAX_RECORD_BYTES)
+    {
+        std::cerr << "Error: A key-value pair of " << key.size() << " + " << value.size() << " bytes does not fit in a page." << std::endl;
+        return false;
+    }
+    user_bytes_written += key.size() + value.size();
+    last_sequence++;
+
+    if (is_separated)
+    {
+        ValuePointer pointer;
+        if (!value_log->append(key, value, pointer))
+        {
+            return false;
+        }
+        memtable->put(versioned_key, pointer.encode(), true);
+    }
+    else
+    {
+        memtable->put(versioned_key, value);
+    }
+    return !memtable->isFull() || flushMemtable();
+}
+
+// Implementation of the remove function.
+bool StringLSMTree::remove(std::string_view key)
+{
+    std::string versioned_key = encodeVersionedKey(key, last_sequence + 1);
+    if (versioned_key.size() > STRING_SST_MAX_KEY_BYTES)
+    {
+        return false;
+    }
+    last_sequence++;
+    memtable->remove(versioned_key);
+    return !memtable->isFull() || flushMemtable();
+}
+
+/*
+    Finds the newest entry of the key at the snapshot (LATEST_SEQUENCE for the
+    newest of all), and reads its value from the value log if the entry is a
+    pointer. Returns false if the key was not found, was deleted, or its value
+    could not be read.
+*/
+bool StringLSMTree::get(std::string_view key, std::string &value, BufferPool *buffer_pool, uint64_t snapshot)
+{
+    StringEntry entry;
+    if (!getEntry(key, entry, buffer_pool, snapshot) || entry.is_tombstone)
+    {
+        return false;
+    }
+    if (entry.is_pointer)
+    {
+        ValuePointer pointer;
+        return value_log != nullptr && pointer.decode(entry.value) && value_log->read(pointer, value);
+    }
+    value = entry.value;
+    return true;
+}
+
+/*
+    Returns the key-value pairs in [key1, key2] at the snapshot in key order.
+    The versions of the keys in the range are scanned from the memtable and
+    every SST, and for each key only the newest version not newer than the
+    snapshot is kept, so deleted keys are left out. The values
+    kept in the value log are then read together, VALUE_LOG_PREFETCH_THREADS
+    at a time, since they are scattered across its segments. Pairs whose value
+    could not be read are left out.
+*/
+std::vector<std::pair<std::string, std::string>> StringLSMTree::scan(std::string_view key1, std::string_view key2, BufferPool *buffer_pool, uint64_t snapshot)
+{
+    std::string first_key = encodeVersionedKey(key1, LATEST_SEQUENCE);
+    std::string last_key = encodeVersionedKey(key2, 0);
+    std::vector<std::pair<std::string, StringEntry>> scanned_entries;
+    memtable->scan(first_key, last_key, scanned_entries);
+    for (const std::vector<StringSST> &level : levels)
+    {
+        for (int i = static_cast<int>(level.size()) - 1; i >= 0; --i)
+        {
+            stringSSTScan(level[i].sst_filename, level[i].metadata, first_key, last_key, scanned_entries, buffer_pool);
+        }
+    }
+
+    // Keeps the version with the largest sequence number that the snapshot sees
+    std::map<std::string, std::pair<uint64_t, StringEntry>> versions;
+    std::string key;
+    uint64_t sequence;
+    for (std::pair<std::string, StringEntry> &scanned_entry : scanned_entries)
+    {
+        if (!decodeVersionedKey(scanned_entry.first, key, sequence) || sequence > snapshot)
+        {
+            continue;
+        }
+        auto [it, is_inserted] = versions.try_emplace(key, sequence, scanned_entry.second);
+        if (!is_inserted && it->second.first < sequence)
+        {
+            it->second = {sequence, std::move(scanned_entry.second)};
+        }
+    }
+    std::map<std::string, StringEntry> newest_entries;
+    for (auto &[version_key, version] : versions)
+    {
+        newest_entries.emplace_hint(newest_entries.end(), version_key, std::move(version.second));
+    }
+
+    std::vector<std::pair<std::string, std::string>> results;
+    std::vector<size_t> pointer_results;
+    std::vector<ValuePointer> pointers;
+    for (auto &[key, entry] : newest_entries)
+    {
+        if (entry.is_tombstone)
+        {
+            continue;
+        }
+        ValuePointer pointer;
+        if (entry.is_pointer)
+        {
+            if (value_log == nullptr || !pointer.decode(entry.value))
+            {
+                continue;
+            }
+            pointer_results.push_back(results.size());
+            pointers.push_back(pointer);
+        }
+        results.emplace_back(key, std::move(entry.value));
+    }
+
+    if (!pointers.empty())
+    {
+        std::vector<std::string> values;
+        if (!value_log->readValues(pointers, values))
+        {
+            std::cerr << "Error: Could not read every value of the scan from the value log." << std::endl;
+        }
+        for (size_t i = 0; i < pointers.size(); ++i)
+        {
+            results[pointer_results[i]].second = std::move(values[i]);
+        }
+    }
+    return results;
+}
+
+// Implementation of the flush function.
+bool StringLSMTree::flush()
+{
+    return memtable->size() == 0 || flushMemtable();
+}
+
+// Implementation of the setRateLimiter function.
+void StringLSMTree::setRateLimiter(RateLimiter *new_rate_limiter)
+{
+    rate_limiter = new_rate_limiter;
+    if (value_log != nullptr)
+    {
+        value_log->setRateLimiter(rate_limiter);
+    }
+}
+
+/*
+    Sets the size of the pages of the SSTs that flushes (if first_level is 0)
+    and compactions of the levels from first_level on write from now on. The
+    SSTs already written keep their pages (every SST records its page size).
+    Returns false if the page size is not valid.
+*/
+bool StringLSMTree::setPageSize(size_t new_page_size, int first_level)
+{
+    if (!isValidPageSize(new_page_size) || first_level < 0)
+    {
+        std::cerr << "Error: The page size must be a power of two between " << PAGE_SIZE << " and " << MAX_PAGE_SIZE << " bytes." << std::endl;
+        return false;
+    }
+    page_size = new_page_size;
+    first_page_level = first_level;
+    return true;
+}
+
+/*
+    Opens the value log in the directory of the database (if it is not open
+    yet, with segments of segment_size bytes), and from now on stores the values of at least threshold bytes in it.
+    The values already in the tree stay where they are.
+*/
+void StringLSMTree::enableValueLog(size_t threshold, size_t segment_size)
+{
+    if (value_log == nullptr)
+    {
+        value_log = new ValueLog(DATA_FILE_PATH + database_name, segment_size);
+        value_log->setRateLimiter(rate_limiter);
+    }
+    value_log_threshold = threshold;
+}
+
+/*
+    Collects the garbage of the oldest value log segment (other than the one
+    being appended to). A record is live if the newest entry of its key still
+    points at it, in which case its value is appended again and the key is
+    pointed at the new record through the memtable, like a put. Returns false
+    if there was no segment to collect, a snapshot is live (it may still read
+    an older record of a key), or the collection failed.
+*/
+bool StringLSMTree::collectValueLogGarbage(BufferPool *buffer_pool)
+{
+    if (value_log == nullptr || !snapshots.empty())
+    {
+        return false;
+    }
+    auto is_live = [&](const std::string &key, const ValuePointer &pointer)
+    {
+        StringEntry entry;
+        ValuePointer newest_pointer;
+        return getEntry(key, entry, buffer_pool) && entry.is_pointer && newest_pointer.decode(entry.value) && newest_pointer == pointer;
+    };
+    auto relocate = [&](const std::string &key, const ValuePointer &pointer)
+    {
+        memtable->put(encodeVersionedKey(key, ++last_sequence), pointer.encode(), true);
+        return !memtable->isFull() || flushMemtable();
+    };
+    return value_log->collectGarbage(is_live, relocate);
+}
+
+// Implementation of the getValueLog function.
+ValueLog *StringLSMTree::getValueLog()
+{
+    return value_log;
+}
+
+// Implementation of the getWriteAmplification function.
+double StringLSMTree::getWriteAmplification()
+{
+    long bytes_written = sst_bytes_written + (value_log != nullptr ? value_log->getBytesWritten() : 0);
+    return user_bytes_written == 0 ? 0 : static_cast<double>(bytes_written) / user_bytes_written;
+}
+
+/*
+    Returns a snapshot of the tree: the sequence number of the last write,
+    which get and scan take to read the tree as it was then. The versions the
+    snapshot sees are kept by flushes and compactions until it is released.
+*/
+uint64_t StringLSMTree::getSnapshot()
+{
+    snapshots.insert(last_sequence);
+    return last_sequence;
+}
+
+// Implementation of the releaseSnapshot function.
+void StringLSMTree::releaseSnapshot(uint64_t snapshot)
+{
+    auto it = snapshots.find(snapshot);
+    if (it != snapshots.end())
+    {
+        snapshots.erase(it);
+    }
+}
+
+// Implementation of the getLastSequence function.
+uint64_t StringLSMTree::getLastSequence()
+{
+    return last_sequence;
+}
+
+// Implementation of the getMemtable function.
+StringMemtable *StringLSMTree::getMemtable()
+{
+    return memtable;
+}
+
+// Implementation of the getLevels function.
+const std::vector<std::vector<StringSST>> &StringLSMTree::getLevels()
+{
+    return levels;
+}
+////////////////////////////////////////////////////////////////////////////
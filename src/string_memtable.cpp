@@ -0,0 +1,104 @@
+#include "string_memtable.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Define the StringMemtable class's constructor.
+StringMemtable::StringMemtable(size_t memtable_size) : memtable_size(memtable_size), curr_bytes(0) {}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the StringMemtable class's functions.
+/*
+    Inserts the value (or a tombstone, or a value pointer) of a key, replacing
+    the one already stored, and keeps the number of bytes held up to date.
+*/
+void StringMemtable::insert(std::string_view key, std::string_view value, bool is_tombstone, bool is_pointer)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+    {
+        it = entries.emplace(std::string(key), StringEntry()).first;
+        curr_bytes += key.size();
+    }
+    curr_bytes -= it->second.value.size();
+    it->second.value = is_tombstone ? std::string() : std::string(value);
+    it->second.is_tombstone = is_tombstone;
+    it->second.is_pointer = is_pointer;
+    curr_bytes += it->second.value.size();
+}
+
+// Implementation of the put function.
+void StringMemtable::put(std::string_view key, std::string_view value, bool is_pointer)
+{
+    insert(key, value, false, is_pointer);
+}
+
+// Implementation of the remove function.
+void StringMemtable::remove(std::string_view key)
+{
+    insert(key, std::string_view(), true, false);
+}
+
+// Implementation of the get function.
+bool StringMemtable::get(std::string_view key, StringEntry &entry)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+    {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+// Implementation of the seek function.
+bool StringMemtable::seek(std::string_view key1, std::string_view key2, std::string &key, StringEntry &entry)
+{
+    auto it = entries.lower_bound(key1);
+    if (it == entries.end() || std::string_view(it->first) > key2)
+    {
+        return false;
+    }
+    key = it->first;
+    entry = it->second;
+    return true;
+}
+
+// Implementation of the scan function.
+void StringMemtable::scan(std::string_view key1, std::string_view key2, std::vector<std::pair<std::string, StringEntry>> &results)
+{
+    for (auto it = entries.lower_bound(key1); it != entries.end() && std::string_view(it->first) <= key2; ++it)
+    {
+        results.push_back(*it);
+    }
+}
+
+// Implementation of the isFull function.
+bool StringMemtable::isFull()
+{
+    return curr_bytes >= memtable_size;
+}
+
+// Implementation of the getEntries function.
+const std::map<std::string, StringEntry, std::less<>> &StringMemtable::getEntries()
+{
+    return entries;
+}
+
+// Implementation of the getMemtableSize function.
+size_t StringMemtable::getMemtableSize()
+{
+    return memtable_size;
+}
+
+// Implementation of the getCurrBytes function.
+size_t StringMemtable::getCurrBytes()
+{
+    return curr_bytes;
+}
+
+// Implementation of the size function.
+long StringMemtable::size()
+{
+    return entries.size();
+}
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,594 @@
+#include "string_sst.h"
+#include "checksum.h"
+#include "sst.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+    Returns the shortest key that is greater than prev_last_key and not greater
+    than first_key (which must be greater than prev_last_key): the prefix of
+    first_key one byte longer than its common prefix with prev_last_key. Every
+    key of the page starting with first_key is then at least the separator, and
+    every key of the page before it is smaller.
+*/
+std::string getSeparatorKey(std::string_view prev_last_key, std::string_view first_key)
+{
+    size_t common = std::mismatch(prev_last_key.begin(), prev_last_key.end(), first_key.begin(), first_key.end()).first - prev_last_key.begin();
+    return std::string(first_key.substr(0, std::min(common + 1, first_key.size())));
+}
+
+// Returns the child page of a slot of an index page.
+static long getChildPage(const char *page, long slot)
+{
+    long child_page = -1;
+    std::string_view value = getSlottedValue(page, slot);
+    if (value.size() == sizeof(long))
+    {
+        std::memcpy(&child_page, value.data(), sizeof(long));
+    }
+    return child_page;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Define the StringSSTWriter class's constructor and destructor.
+StringSSTWriter::StringSSTWriter(std::string sst_filename, RateLimiter *rate_limiter, IOPriority priority, size_t page_size)
+    : sst_filename(sst_filename), rate_limiter(rate_limiter), priority(priority), page_size(page_size), fd(-1), buffer(nullptr), write_offset(0),
+      data_page(page_size), bloom_filter(BLOOM_FILTER_NUM_BITS, BLOOM_FILTER_NUM_HASHES), filter_suffix_bytes(0), has_error(false)
+{
+    if (!isValidPageSize(page_size))
+    {
+        std::cerr << "Write SST Error: Unsupported page size " << page_size << std::endl;
+        has_error = true;
+        return;
+    }
+
+    // Open the SST file for writing with Direct I/O
+    fd = open(sst_filename.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0666);
+    if (fd < 0)
+    {
+        std::cerr << "Write SST Error: Failed to open SST file " << sst_filename << " for writing." << std::endl;
+        has_error = true;
+        return;
+    }
+
+    if (posix_memalign(&buffer, PAGE_SIZE, page_size) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the SST Buffer." << std::endl;
+        buffer = nullptr;
+        has_error = true;
+    }
+}
+
+StringSSTWriter::~StringSSTWriter()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    free(buffer);
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the StringSSTWriter class's functions.
+// Implementation of the isOpen function.
+bool StringSSTWriter::isOpen()
+{
+    return !has_error;
+}
+
+/*
+    Appends a key-value pair (or a tombstone for the key, or a pointer to its
+    value in the value log) to the current data page, writing the page first
+    if the pair does not fit in it. Returns false if the key is not greater
+    than the last key, the pair does not fit in an empty page, or a write
+    failed.
+*/
+bool StringSSTWriter::put(std::string_view key, std::string_view value, bool is_tombstone, bool is_pointer)
+{
+    if (has_error)
+    {
+        return false;
+    }
+    if (!metadata.empty() && key <= std::string_view(metadata.max_key))
+    {
+        std::cerr << "Write SST Error: Keys must be written in increasing order." << std::endl;
+        return false;
+    }
+    if (key.size() > STRING_SST_MAX_KEY_BYTES || key.size() + (is_tombstone ? 0 : value.size()) > getSlottedPageMaxRecordBytes(page_size))
+    {
+        std::cerr << "Write SST Error: A key-value pair of " << key.size() << " + " << value.size() << " bytes does not fit in a page." << std::endl;
+        return false;
+    }
+
+    if (!data_page.add(key, value, is_tombstone, is_pointer))
+    {
+        if (!writeDataPage())
+        {
+            return false;
+        }
+        data_page.add(key, value, is_tombstone, is_pointer);
+    }
+    bloom_filter.put(std::string(key.substr(0, key.size() - std::min(key.size(), filter_suffix_bytes))));
+    metadata.add(key, is_tombstone ? std::string_view() : value, is_tombstone);
+    return true;
+}
+
+/*
+    Writes the first num_bytes of the buffer (a page, or PAGE_SIZE bytes for the
+    footer) at the end of the file, and records the checksum of every PAGE_SIZE
+    bytes of it.
+*/
+bool StringSSTWriter::writeBufferPage(size_t num_bytes)
+{
+    if (rate_limiter != nullptr)
+    {
+        rate_limiter->request(num_bytes, priority);
+    }
+    ssize_t bytes_written = pwrite(fd, buffer, num_bytes, write_offset);
+    if (bytes_written != static_cast<ssize_t>(num_bytes))
+    {
+        perror("pwrite failed");
+        std::cerr << "Error: Incomplete write for a page of SST file " << sst_filename << std::endl;
+        has_error = true;
+        return false;
+    }
+    std::vector<uint32_t> page_checksums = computePageChecksums(buffer, num_bytes);
+    checksums.insert(checksums.end(), page_checksums.begin(), page_checksums.end());
+    write_offset += bytes_written;
+    return true;
+}
+
+// Implementation of the writeDataPage function.
+bool StringSSTWriter::writeDataPage()
+{
+    std::string separator = index_entries.empty() ? std::string() : getSeparatorKey(prev_last_key, data_page.getFirstKey());
+    index_entries.emplace_back(separator, write_offset / page_size);
+    prev_last_key = data_page.getLastKey();
+
+    data_page.write(buffer);
+    data_page.clear();
+    return writeBufferPage(page_size);
+}
+
+/*
+    Writes the B-Tree of separator keys after the data pages. Every level is
+    packed into as few slotted pages as its entries fit in, and the first
+    separator of each page becomes its entry in the level above, until a level
+    fits in a single page: the root, which is written last. An SST without data
+    pages gets an empty root.
+*/
+bool StringSSTWriter::writeIndexPages()
+{
+    std::vector<std::pair<std::string, long>> level = index_entries;
+    std::vector<std::pair<std::string, long>> parent_level;
+    SlottedPageBuilder index_page(page_size);
+
+    // Writes index_page and adds its first separator to the level above
+    auto write_index_page = [&]()
+    {
+        parent_level.emplace_back(index_page.getFirstKey(), write_offset / page_size);
+        index_page.write(buffer);
+        index_page.clear();
+        return writeBufferPage(page_size);
+    };
+
+    do
+    {
+        parent_level.clear();
+        for (const std::pair<std::string, long> &entry : level)
+        {
+            std::string_view child_page(reinterpret_cast<const char *>(&entry.second), sizeof(long));
+            if (!index_page.add(entry.first, child_page))
+            {
+                if (!write_index_page())
+                {
+                    return false;
+                }
+                index_page.add(entry.first, child_page);
+            }
+        }
+        if ((!index_page.empty() || parent_level.empty()) && !write_index_page())
+        {
+            return false;
+        }
+        level = parent_level;
+    } while (level.size() > 1);
+    return true;
+}
+
+// Implementation of the finish function.
+bool StringSSTWriter::finish()
+{
+    if (has_error || (!data_page.empty() && !writeDataPage()))
+    {
+        return false;
+    }
+
+    SSTFooter &footer = metadata.footer;
+    footer.version = SST_FORMAT_VERSION;
+    footer.page_encoding = PageEncoding::SLOTTED;
+    footer.page_size = page_size;
+    footer.num_entries = metadata.num_entries;
+    footer.data_size = write_offset;
+    footer.index_offset = write_offset;
+    if (!writeIndexPages())
+    {
+        return false;
+    }
+    footer.index_size = write_offset - footer.index_offset;
+
+    // Write the Bloom filter, padded with zeros to the next page
+    footer.filter_offset = write_offset;
+    footer.filter_size = bloom_filter.getSizeInBytes();
+    const char *bit_array = static_cast<const char *>(bloom_filter.getRawBitArray());
+    for (long offset = 0; offset < footer.filter_size; offset += page_size)
+    {
+        std::memset(buffer, 0, page_size);
+        std::memcpy(buffer, bit_array + offset, std::min<long>(page_size, footer.filter_size - offset));
+        if (!writeBufferPage(page_size))
+        {
+            return false;
+        }
+    }
+
+    // Write the checksums of every page before them (padded with zeros to the next PAGE_SIZE bytes), then the footer as the last PAGE_SIZE bytes
+    std::vector<uint32_t> page_checksums = checksums;
+    footer.checksum_offset = write_offset;
+    footer.checksum_size = page_checksums.size() * sizeof(uint32_t);
+    const char *checksum_bytes = reinterpret_cast<const char *>(page_checksums.data());
+    for (long offset = 0; offset < footer.checksum_size; offset += PAGE_SIZE)
+    {
+        std::memset(buffer, 0, PAGE_SIZE);
+        std::memcpy(buffer, checksum_bytes + offset, std::min<long>(PAGE_SIZE, footer.checksum_size - offset));
+        if (!writeBufferPage(PAGE_SIZE))
+        {
+            return false;
+        }
+    }
+    cachePageChecksums(sst_filename, page_checksums);
+    footer.serialize(buffer);
+    return writeBufferPage(PAGE_SIZE);
+}
+
+// Implementation of the setFilterSuffixBytes function.
+void StringSSTWriter::setFilterSuffixBytes(size_t num_bytes)
+{
+    filter_suffix_bytes = num_bytes;
+}
+
+// Implementation of the getMetadata function.
+StringSSTMetadata StringSSTWriter::getMetadata()
+{
+    return metadata;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the StringSSTIterator class's constructor and destructor.
+StringSSTIterator::StringSSTIterator(const std::string &sst_filename)
+    : sst_filename(sst_filename), fd(-1), buffer(nullptr), page_size(PAGE_SIZE), num_pages(0), next_page(0), slot(0), is_valid(false), has_error(false)
+{
+    SSTFooter footer;
+    if (!readSSTFooter(sst_filename, footer) || footer.page_encoding != PageEncoding::SLOTTED)
+    {
+        std::cerr << "Error: " << sst_filename << " is not a byte-string SST." << std::endl;
+        has_error = true;
+        return;
+    }
+    num_pages = footer.getNumDataPages();
+    page_size = footer.page_size;
+
+    fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0 || posix_memalign(&buffer, PAGE_SIZE, page_size) != 0)
+    {
+        std::cerr << "Error: Could not open SST file " << sst_filename << " for reading." << std::endl;
+        buffer = nullptr;
+        has_error = true;
+        return;
+    }
+    readNextPage();
+}
+
+StringSSTIterator::~StringSSTIterator()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    free(buffer);
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the StringSSTIterator class's functions.
+// Implementation of the readNextPage function.
+void StringSSTIterator::readNextPage()
+{
+    is_valid = false;
+    slot = 0;
+    while (next_page < num_pages)
+    {
+        const char *page = static_cast<const char *>(buffer);
+        if (pread(fd, buffer, page_size, next_page * page_size) != static_cast<ssize_t>(page_size) ||
+            !isPageIntact(sst_filename, next_page * (page_size / PAGE_SIZE), buffer, false, page_size) || !isSlottedPageValid(page, page_size))
+        {
+            std::cerr << "Error: Could not read page " << next_page << " of SST file " << sst_filename << std::endl;
+            has_error = true;
+            return;
+        }
+        next_page++;
+        if (getSlottedPageNumSlots(page) > 0)
+        {
+            is_valid = true;
+            return;
+        }
+    }
+}
+
+// Implementation of the isOpen function.
+bool StringSSTIterator::isOpen()
+{
+    return fd >= 0 && buffer != nullptr;
+}
+
+// Implementation of the valid function.
+bool StringSSTIterator::valid()
+{
+    return is_valid;
+}
+
+// Implementation of the hasError function.
+bool StringSSTIterator::hasError()
+{
+    return has_error;
+}
+
+// Implementation of the key function.
+std::string_view StringSSTIterator::key()
+{
+    return getSlottedKey(static_cast<const char *>(buffer), slot);
+}
+
+// Implementation of the value function.
+std::string_view StringSSTIterator::value()
+{
+    return getSlottedValue(static_cast<const char *>(buffer), slot);
+}
+
+// Implementation of the isTombstone function.
+bool StringSSTIterator::isTombstone()
+{
+    return isSlottedTombstone(static_cast<const char *>(buffer), slot);
+}
+
+// Implementation of the isPointer function.
+bool StringSSTIterator::isPointer()
+{
+    return isSlottedPointer(static_cast<const char *>(buffer), slot);
+}
+
+// Implementation of the next function.
+void StringSSTIterator::next()
+{
+    if (!is_valid)
+    {
+        return;
+    }
+    if (++slot >= getSlottedPageNumSlots(static_cast<const char *>(buffer)))
+    {
+        readNextPage();
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+/*
+    Computes the statistics of a byte-string SST by reading its footer and every
+    one of its key-value pairs. Used when the SSTs of a database are reopened.
+*/
+StringSSTMetadata readStringSSTMetadata(const std::string &sst_filename)
+{
+    StringSSTMetadata metadata;
+    if (!readSSTFooter(sst_filename, metadata.footer))
+    {
+        return metadata;
+    }
+    for (StringSSTIterator iterator(sst_filename); iterator.valid(); iterator.next())
+    {
+        metadata.add(iterator.key(), iterator.value(), iterator.isTombstone());
+    }
+    return metadata;
+}
+
+/*
+    Reads a page of a byte-string SST, from the buffer pool if it holds it,
+    otherwise from the file (and then adds it to the buffer pool). A page
+    larger than PAGE_SIZE is cached as PAGE_SIZE frames, so the buffer pool
+    stays bounded by bytes, and is read from the file unless every frame is
+    cached. Returns the page, or nullptr if it could not be read or does not
+    match its checksum.
+
+    Input:
+        sst_filename        The name of the SST file.
+        page_index          The page of the file to read.
+        page_buffer         An aligned buffer of page_size bytes the page may be read into.
+        buffer_pool         The BufferPool containing recently read pages (or nullptr).
+        page_size           The size (in bytes) of the pages of the SST.
+*/
+const char *readStringSSTPage(const std::string &sst_filename, long page_index, char *page_buffer, BufferPool *buffer_pool, size_t page_size)
+{
+    countPageRead();
+    long num_frames = page_size / PAGE_SIZE;
+    long first_frame = page_index * num_frames;
+    if (buffer_pool != nullptr)
+    {
+        long frame = 0;
+        for (; frame < num_frames; ++frame)
+        {
+            Page *cached_page = buffer_pool->searchForPage(sst_filename + "#" + std::to_string(first_frame + frame));
+            if (cached_page == nullptr)
+            {
+                break;
+            }
+            if (!isPageIntact(sst_filename, first_frame + frame, cached_page->data, true))
+            {
+                return nullptr;
+            }
+            if (num_frames == 1)
+            {
+                return cached_page->data;
+            }
+            std::memcpy(page_buffer + frame * PAGE_SIZE, cached_page->data, PAGE_SIZE);
+        }
+        if (frame == num_frames)
+        {
+            return page_buffer;
+        }
+    }
+
+    int fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT);
+    ssize_t bytes_read = fd < 0 ? -1 : pread(fd, page_buffer, page_size, page_index * page_size);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (bytes_read != static_cast<ssize_t>(page_size) || !isPageIntact(sst_filename, first_frame, page_buffer, false, page_size))
+    {
+        std::cerr << "Error: Could not read page " << page_index << " of SST file " << sst_filename << std::endl;
+        return nullptr;
+    }
+    for (long frame = 0; buffer_pool != nullptr && frame < num_frames; ++frame)
+    {
+        buffer_pool->insertPage(new Page(sst_filename + "#" + std::to_string(first_frame + frame), page_buffer + frame * PAGE_SIZE));
+    }
+    return page_buffer;
+}
+
+// Returns whether the Bloom filter of a byte-string SST might contain the key (true if it could not be read).
+bool stringSSTMightContain(const std::string &sst_filename, const StringSSTMetadata &metadata, std::string_view key, BufferPool *buffer_pool)
+{
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    const char *filter_page = readStringSSTPage(sst_filename, metadata.footer.filter_offset / metadata.footer.page_size, page_buffer, buffer_pool, metadata.footer.page_size);
+    if (filter_page == nullptr)
+    {
+        return true;
+    }
+    BloomFilter bloom_filter(BLOOM_FILTER_NUM_BITS, BLOOM_FILTER_NUM_HASHES);
+    bloom_filter.loadBitArrayFromBuffer(filter_page, metadata.footer.filter_size);
+    return bloom_filter.mightContain(std::string(key));
+}
+
+/*
+    Descends the B-Tree of separator keys of a byte-string SST from its root to
+    the data page that may hold the key: the child of the last separator that
+    is not greater than the key. Returns the data page, or -1 if a page could
+    not be read.
+*/
+static long findStringDataPage(const std::string &sst_filename, const SSTFooter &footer, std::string_view key, BufferPool *buffer_pool)
+{
+    long num_data_pages = footer.getNumDataPages();
+    long page_index = (footer.index_offset + footer.index_size) / footer.page_size - 1;
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    while (page_index >= num_data_pages)
+    {
+        const char *page = readStringSSTPage(sst_filename, page_index, page_buffer, buffer_pool, footer.page_size);
+        if (page == nullptr || !isSlottedPageValid(page, footer.page_size) || getSlottedPageNumSlots(page) == 0)
+        {
+            return -1;
+        }
+        long slot = slottedLowerBound(page, key);
+        if (slot == getSlottedPageNumSlots(page) || getSlottedKey(page, slot) != key)
+        {
+            slot--;
+        }
+        long child_page = getChildPage(page, std::max(slot, 0L));
+        if (child_page < 0 || child_page >= page_index)
+        {
+            return -1;
+        }
+        page_index = child_page;
+    }
+    return page_index;
+}
+
+/*
+    Searches a byte-string SST for a key through its B-Tree, reading a single
+    data page. Returns whether the key was found, in which case entry holds its
+    value (or whether it was deleted).
+*/
+bool stringSSTGet(const std::string &sst_filename, const StringSSTMetadata &metadata, std::string_view key, StringEntry &entry, BufferPool *buffer_pool)
+{
+    if (!metadata.overlaps(key, key))
+    {
+        return false;
+    }
+    long data_page = findStringDataPage(sst_filename, metadata.footer, key, buffer_pool);
+    if (data_page < 0)
+    {
+        return false;
+    }
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    const char *page = readStringSSTPage(sst_filename, data_page, page_buffer, buffer_pool, metadata.footer.page_size);
+    if (page == nullptr || !isSlottedPageValid(page, metadata.footer.page_size))
+    {
+        return false;
+    }
+    long slot = slottedLowerBound(page, key);
+    if (slot == getSlottedPageNumSlots(page) || getSlottedKey(page, slot) != key)
+    {
+        return false;
+    }
+    entry.value = getSlottedValue(page, slot);
+    entry.is_tombstone = isSlottedTombstone(page, slot);
+    entry.is_pointer = isSlottedPointer(page, slot);
+    return true;
+}
+
+/*
+    Appends the key-value pairs (and tombstones) of a byte-string SST within
+    [key1, key2] to the results, reading the data pages in order from the one
+    the B-Tree gives for key1, and stops after max_results pairs (a max_results
+    of 1 finds the first key that is not smaller than key1). Returns false if a
+    page could not be read.
+*/
+bool stringSSTScan(const std::string &sst_filename, const StringSSTMetadata &metadata, std::string_view key1, std::string_view key2,
+                   std::vector<std::pair<std::string, StringEntry>> &results, BufferPool *buffer_pool, long max_results)
+{
+    if (!metadata.overlaps(key1, key2))
+    {
+        return true;
+    }
+    long data_page = findStringDataPage(sst_filename, metadata.footer, key1, buffer_pool);
+    if (data_page < 0)
+    {
+        return false;
+    }
+
+    alignas(PAGE_SIZE) char page_buffer[MAX_PAGE_SIZE];
+    for (long num_data_pages = metadata.footer.getNumDataPages(); data_page < num_data_pages; ++data_page)
+    {
+        const char *page = readStringSSTPage(sst_filename, data_page, page_buffer, buffer_pool, metadata.footer.page_size);
+        if (page == nullptr || !isSlottedPageValid(page, metadata.footer.page_size))
+        {
+            return false;
+        }
+        for (long slot = slottedLowerBound(page, key1); slot < getSlottedPageNumSlots(page); ++slot)
+        {
+            std::string_view key = getSlottedKey(page, slot);
+            if (key > key2)
+            {
+                return true;
+            }
+            results.push_back({std::string(key), StringEntry{std::string(getSlottedValue(page, slot)), isSlottedTombstone(page, slot), isSlottedPointer(page, slot)}});
+            if (--max_results <= 0)
+            {
+                return true;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,287 @@
+#include "typed_lsm_tree.h"
+#include "sst.h"
+#include "checksum.h"
+#include "merge_iterator.h"
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <map>
+
+////////////////////////////////////////////////////////////////////////////
+// Define the TypedLSMTree class's constructor and destructor.
+template <typename Key, typename Value>
+TypedLSMTree<Key, Value>::TypedLSMTree(int memtable_size, std::string database)
+    : memtable(new BasicMemtable<Key, Value>(memtable_size)), database_name(database), memtable_size(memtable_size)
+{
+    levels.resize(max_level);
+    std::filesystem::create_directories(DATA_FILE_PATH + database_name);
+}
+
+// Implementation of the TypedLSMTree destructor.
+template <typename Key, typename Value>
+TypedLSMTree<Key, Value>::~TypedLSMTree()
+{
+    delete memtable;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the TypedLSMTree class's private functions.
+/*
+    Writes the memtable to a new SST on level 0 and replaces it with an empty
+    one, then compacts the levels that are full. Returns false (and keeps the
+    memtable) if the SST could not be written.
+*/
+template <typename Key, typename Value>
+bool TypedLSMTree<Key, Value>::flushMemtable()
+{
+    std::string sst_filename = DATA_FILE_PATH + database_name + "/typedsst_" + getCurrentTimestamp() + ".bin";
+    std::pair<std::pair<Key, Value> *, int> pairs = memtable->scan(std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max());
+    bool is_success = true;
+    {
+        TypedSSTWriter<Key, Value> writer(sst_filename);
+        is_success = writer.isOpen();
+        for (int i = 0; is_success && i < pairs.second; ++i)
+        {
+            is_success = writer.put(pairs.first[i].first, pairs.first[i].second);
+        }
+        is_success = is_success && writer.finish();
+    }
+    delete[] pairs.first;
+
+    std::shared_ptr<TypedSSTReader<Key, Value>> reader = is_success ? std::make_shared<TypedSSTReader<Key, Value>>(sst_filename) : nullptr;
+    if (reader == nullptr || !reader->isOpen())
+    {
+        std::cerr << "Error: Could not flush the memtable to SST file " << sst_filename << std::endl;
+        std::remove(sst_filename.c_str());
+        removeChecksumFile(sst_filename);
+        return false;
+    }
+
+    delete memtable;
+    memtable = new BasicMemtable<Key, Value>(memtable_size);
+    levels[0].push_back({0, sst_filename, reader});
+    if (levels[0].size() >= level_size_ratio)
+    {
+        compactLevels();
+    }
+    return true;
+}
+
+/*
+    Merges the given SSTs, ordered from the oldest to the newest, into a new
+    SST with a MergeIterator (as the compactions of the LSMTree do), so of the
+    pairs of a key only the one of the newest SST is written. Tombstones are
+    dropped if drop_tombstones is set (no older SST is left for them to hide a
+    value of). Returns false if an SST could not be read or the new SST
+    written.
+*/
+template <typename Key, typename Value>
+bool TypedLSMTree<Key, Value>::mergeSSTs(const std::vector<TypedSST<Key, Value>> &ssts, bool drop_tombstones, TypedSST<Key, Value> &merged_sst)
+{
+    merged_sst.sst_filename = DATA_FILE_PATH + database_name + "/typedsst_" + getCurrentTimestamp() + ".bin";
+    bool is_success = true;
+    {
+        std::vector<std::unique_ptr<TypedSSTIterator<Key, Value>>> iterators;
+        std::vector<TypedSSTIterator<Key, Value> *> merged_iterators;
+        for (const TypedSST<Key, Value> &sst : ssts)
+        {
+            iterators.emplace_back(new TypedSSTIterator<Key, Value>(sst.reader.get()));
+            merged_iterators.push_back(iterators.back().get());
+        }
+        MergeIterator<TypedSSTIterator<Key, Value>> merge_iterator(merged_iterators);
+
+        TypedSSTWriter<Key, Value> writer(merged_sst.sst_filename);
+        is_success = writer.isOpen();
+        for (; is_success && merge_iterator.valid(); merge_iterator.next())
+        {
+            if (!drop_tombstones || merge_iterator.value() != TOMBSTONE)
+            {
+                is_success = writer.put(merge_iterator.key(), merge_iterator.value());
+            }
+        }
+        is_success = is_success && !merge_iterator.hasError() && writer.finish();
+    }
+
+    merged_sst.reader = is_success ? std::make_shared<TypedSSTReader<Key, Value>>(merged_sst.sst_filename) : nullptr;
+    if (merged_sst.reader == nullptr || !merged_sst.reader->isOpen())
+    {
+        std::cerr << "Error: Could not merge SSTs into SST file " << merged_sst.sst_filename << std::endl;
+        std::remove(merged_sst.sst_filename.c_str());
+        removeChecksumFile(merged_sst.sst_filename);
+        return false;
+    }
+    return true;
+}
+
+/*
+    Merges the SSTs of every level that holds level_size_ratio SSTs into one,
+    which stays on the level if it is small enough and moves to the next level
+    otherwise. Tombstones are dropped once no deeper level holds an SST. The
+    input SSTs are kept if the merge failed.
+*/
+template <typename Key, typename Value>
+void TypedLSMTree<Key, Value>::compactLevels()
+{
+    for (int level_idx = 0; level_idx < static_cast<int>(levels.size()); ++level_idx)
+    {
+        bool is_last_level = (max_level - 1) == level_idx;
+        if (levels[level_idx].size() < level_size_ratio)
+        {
+            continue;
+        }
+
+        bool has_older_ssts = false;
+        for (size_t older_level = level_idx + 1; older_level < levels.size(); ++older_level)
+        {
+            has_older_ssts |= !levels[older_level].empty();
+        }
+
+        std::vector<TypedSST<Key, Value>> &level = levels[level_idx];
+        TypedSST<Key, Value> merged_sst{level_idx, "", nullptr};
+        if (!mergeSSTs(level, !has_older_ssts, merged_sst))
+        {
+            return;
+        }
+        for (const TypedSST<Key, Value> &sst : level)
+        {
+            std::remove(sst.sst_filename.c_str());
+            removeChecksumFile(sst.sst_filename);
+        }
+        level.clear();
+
+        size_t current_level_max_size = pow(level_size_ratio, level_idx + 1) * memtable_size * PageLayout<Key, Value>::ENTRY_SIZE;
+        if (std::filesystem::file_size(merged_sst.sst_filename) <= current_level_max_size || is_last_level)
+        {
+            level.push_back(merged_sst);
+        }
+        else
+        {
+            merged_sst.level = level_idx + 1;
+            levels[level_idx + 1].push_back(merged_sst);
+        }
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the TypedLSMTree class's public functions.
+/*
+    Inserts or replaces the value of a key in the memtable, then flushes the
+    memtable once it is full. Returns false if the memtable could not be
+    flushed.
+*/
+template <typename Key, typename Value>
+bool TypedLSMTree<Key, Value>::put(Key key, Value value)
+{
+    memtable->put(key, value);
+    return memtable->getCurrSize() < memtable->getMemtableSize() || flushMemtable();
+}
+
+/*
+    Deletes a key by putting a tombstone for it, which hides the older values
+    of the key until a compaction drops it. Returns false if the memtable could
+    not be flushed.
+*/
+template <typename Key, typename Value>
+bool TypedLSMTree<Key, Value>::remove(Key key)
+{
+    return put(key, TOMBSTONE);
+}
+
+/*
+    Finds the value of a key in the memtable, then in the SSTs from the newest
+    to the oldest. Returns false if the key is not found or was deleted.
+*/
+template <typename Key, typename Value>
+bool TypedLSMTree<Key, Value>::get(Key key, Value &value, BufferPool *buffer_pool)
+{
+    BasicNode<Key, Value> *node = memtable->get(key);
+    if (node != nullptr)
+    {
+        value = node->value;
+        return value != TOMBSTONE;
+    }
+
+    for (const std::vector<TypedSST<Key, Value>> &level : levels)
+    {
+        for (auto sst = level.rbegin(); sst != level.rend(); ++sst)
+        {
+            if (sst->reader->get(key, value, buffer_pool))
+            {
+                return value != TOMBSTONE;
+            }
+        }
+    }
+    return false;
+}
+
+/*
+    Scans the SSTs from the oldest to the newest and then the memtable, so
+    the newest value of every key in [key1, key2] is the one returned (and
+    deleted keys are left out).
+*/
+template <typename Key, typename Value>
+std::vector<std::pair<Key, Value>> TypedLSMTree<Key, Value>::scan(Key key1, Key key2, BufferPool *buffer_pool)
+{
+    std::map<Key, Value> results;
+    std::vector<std::pair<Key, Value>> sst_results;
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+    {
+        for (const TypedSST<Key, Value> &sst : *level)
+        {
+            sst_results.clear();
+            sst.reader->scan(key1, key2, sst_results, buffer_pool);
+            for (const std::pair<Key, Value> &key_value_pair : sst_results)
+            {
+                results[key_value_pair.first] = key_value_pair.second;
+            }
+        }
+    }
+
+    std::pair<std::pair<Key, Value> *, int> memtable_results = memtable->scan(key1, key2);
+    for (int i = 0; i < memtable_results.second; ++i)
+    {
+        results[memtable_results.first[i].first] = memtable_results.first[i].second;
+    }
+    delete[] memtable_results.first;
+
+    std::vector<std::pair<Key, Value>> key_value_pairs;
+    for (const std::pair<const Key, Value> &key_value_pair : results)
+    {
+        if (key_value_pair.second != TOMBSTONE)
+        {
+            key_value_pairs.push_back(key_value_pair);
+        }
+    }
+    return key_value_pairs;
+}
+
+// Implementation of the flush function.
+template <typename Key, typename Value>
+bool TypedLSMTree<Key, Value>::flush()
+{
+    return memtable->getCurrSize() == 0 || flushMemtable();
+}
+
+// Implementation of the getMemtable function.
+template <typename Key, typename Value>
+BasicMemtable<Key, Value> *TypedLSMTree<Key, Value>::getMemtable()
+{
+    return memtable;
+}
+
+// Implementation of the getLevels function.
+template <typename Key, typename Value>
+const std::vector<std::vector<TypedSST<Key, Value>>> &TypedLSMTree<Key, Value>::getLevels()
+{
+    return levels;
+}
+////////////////////////////////////////////////////////////////////////////
+
+// The key and value types of the trees (the same as those of the TypedSSTWriter).
+template class TypedLSMTree<int32_t, int32_t>;
+template class TypedLSMTree<int32_t, long>;
+template class TypedLSMTree<long, int32_t>;
+template class TypedLSMTree<long, long>;
@@ -0,0 +1,385 @@
+#include "typed_sst.h"
+#include "sst.h"
+#include "checksum.h"
+#include "page_search.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Returns the key at a position of a page of the layout.
+template <typename Key>
+static Key getPageKey(const char *page, long pos)
+{
+    Key key;
+    std::memcpy(&key, page + pos * sizeof(Key), sizeof(Key));
+    return key;
+}
+
+// Returns the value at a position of a page of the layout (the values follow the MAX_PAIRS keys, possibly unaligned).
+template <typename Key, typename Value>
+static Value getPageValue(const char *page, long pos)
+{
+    Value value;
+    std::memcpy(&value, page + PageLayout<Key, Value>::MAX_PAIRS * sizeof(Key) + pos * sizeof(Value), sizeof(Value));
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Define the TypedSSTWriter class's constructor and destructor.
+template <typename Key, typename Value>
+TypedSSTWriter<Key, Value>::TypedSSTWriter(std::string sst_filename)
+    : sst_filename(sst_filename), fd(-1), buffer(nullptr), write_offset(0), num_page_pairs(0), num_entries(0), last_key(0), has_error(false)
+{
+    // Open the SST file for writing with Direct I/O
+    fd = open(sst_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+    if (fd < 0)
+    {
+        std::cerr << "Write SST Error: Failed to open SST file " << sst_filename << " for writing." << std::endl;
+        has_error = true;
+        return;
+    }
+
+    if (posix_memalign(&buffer, PAGE_SIZE, PAGE_SIZE) != 0)
+    {
+        std::cerr << "Error: Memory alignment allocation failed for the SST Buffer." << std::endl;
+        buffer = nullptr;
+        has_error = true;
+        return;
+    }
+    std::memset(buffer, INTERNAL, PAGE_SIZE);
+}
+
+template <typename Key, typename Value>
+TypedSSTWriter<Key, Value>::~TypedSSTWriter()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    free(buffer);
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the TypedSSTWriter class's functions.
+/*
+    Pads the keys of a partial page with copies of its last key (so its keys
+    stay sorted and any key can be written, and a reader finds the end of the
+    page where a key repeats), then writes it as the next page of the file.
+*/
+template <typename Key, typename Value>
+bool TypedSSTWriter<Key, Value>::writePage()
+{
+    for (long pos = num_page_pairs; pos < static_cast<long>(PageLayout<Key, Value>::MAX_PAIRS); ++pos)
+    {
+        std::memcpy(static_cast<char *>(buffer) + pos * sizeof(Key), &last_key, sizeof(Key));
+    }
+    checksums.push_back(crc32c(buffer, PAGE_SIZE));
+    if (pwrite(fd, buffer, PAGE_SIZE, write_offset) != static_cast<ssize_t>(PAGE_SIZE))
+    {
+        perror("pwrite failed");
+        std::cerr << "Error: Incomplete write to SST file " << sst_filename << std::endl;
+        has_error = true;
+        return false;
+    }
+    write_offset += PAGE_SIZE;
+    num_page_pairs = 0;
+    std::memset(buffer, INTERNAL, PAGE_SIZE);
+    return true;
+}
+
+// Implementation of the isOpen function.
+template <typename Key, typename Value>
+bool TypedSSTWriter<Key, Value>::isOpen()
+{
+    return fd >= 0 && buffer != nullptr;
+}
+
+/*
+    Appends a key-value pair to the current page, writing the page once it
+    holds MAX_PAIRS pairs. Returns false if the key is not greater than the
+    last key, or a write failed.
+*/
+template <typename Key, typename Value>
+bool TypedSSTWriter<Key, Value>::put(Key key, Value value)
+{
+    if (has_error)
+    {
+        return false;
+    }
+    if (num_entries > 0 && key <= last_key)
+    {
+        std::cerr << "Write SST Error: Keys must be written in increasing order." << std::endl;
+        return false;
+    }
+
+    char *page = static_cast<char *>(buffer);
+    std::memcpy(page + num_page_pairs * sizeof(Key), &key, sizeof(Key));
+    std::memcpy(page + PageLayout<Key, Value>::MAX_PAIRS * sizeof(Key) + num_page_pairs * sizeof(Value), &value, sizeof(Value));
+    last_key = key;
+    num_entries++;
+    return ++num_page_pairs < static_cast<long>(PageLayout<Key, Value>::MAX_PAIRS) || writePage();
+}
+
+// Implementation of the finish function.
+template <typename Key, typename Value>
+bool TypedSSTWriter<Key, Value>::finish()
+{
+    if (has_error || (num_page_pairs > 0 && !writePage()))
+    {
+        return false;
+    }
+    return writeChecksumFile(sst_filename, checksums);
+}
+
+// Implementation of the getNumEntries function.
+template <typename Key, typename Value>
+long TypedSSTWriter<Key, Value>::getNumEntries()
+{
+    return num_entries;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the TypedSSTReader class's constructor and destructor.
+/*
+    Opens the SST and reads the first key of every page, so that a get reads
+    only the page that may hold its key.
+*/
+template <typename Key, typename Value>
+TypedSSTReader<Key, Value>::TypedSSTReader(std::string sst_filename) : sst_filename(sst_filename), fd(-1)
+{
+    fd = open(sst_filename.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0)
+    {
+        std::cerr << "Error: Could not open SST file " << sst_filename << " for reading." << std::endl;
+        return;
+    }
+
+    alignas(PAGE_SIZE) char page_buffer[PAGE_SIZE];
+    long num_pages = lseek(fd, 0, SEEK_END) / PAGE_SIZE;
+    for (long page_index = 0; page_index < num_pages; ++page_index)
+    {
+        const char *page = readPage(page_index, page_buffer, nullptr);
+        if (page == nullptr)
+        {
+            close(fd);
+            fd = -1;
+            return;
+        }
+        fence_keys.push_back(getPageKey<Key>(page, 0));
+    }
+}
+
+template <typename Key, typename Value>
+TypedSSTReader<Key, Value>::~TypedSSTReader()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the TypedSSTReader class's functions.
+/*
+    Reads a page of the SST, from the buffer pool if it holds it, otherwise
+    from the file (and then adds it to the buffer pool). Returns the page, or
+    nullptr if it could not be read or does not match its checksum.
+*/
+template <typename Key, typename Value>
+const char *TypedSSTReader<Key, Value>::readPage(long page_index, char *page_buffer, BufferPool *buffer_pool)
+{
+    countPageRead();
+    page_id.assign(sst_filename).append("#").append(std::to_string(page_index));
+    Page *cached_page = buffer_pool != nullptr ? buffer_pool->searchForPage(page_id) : nullptr;
+    if (cached_page != nullptr)
+    {
+        return isPageIntact(sst_filename, page_index, cached_page->data, true) ? cached_page->data : nullptr;
+    }
+
+    if (pread(fd, page_buffer, PAGE_SIZE, page_index * PAGE_SIZE) != static_cast<ssize_t>(PAGE_SIZE) ||
+        !isPageIntact(sst_filename, page_index, page_buffer, false))
+    {
+        std::cerr << "Error: Could not read page " << page_index << " of SST file " << sst_filename << std::endl;
+        return nullptr;
+    }
+    if (buffer_pool != nullptr)
+    {
+        buffer_pool->insertPage(new Page(page_id, page_buffer));
+    }
+    return page_buffer;
+}
+
+// Implementation of the isOpen function.
+template <typename Key, typename Value>
+bool TypedSSTReader<Key, Value>::isOpen()
+{
+    return fd >= 0;
+}
+
+// Implementation of the getNumPages function.
+template <typename Key, typename Value>
+long TypedSSTReader<Key, Value>::getNumPages()
+{
+    return fence_keys.size();
+}
+
+/*
+    Finds the page that may hold the key from the fence pointers and searches
+    its keys. Returns false if the key is not in the SST or the page could not
+    be read.
+*/
+template <typename Key, typename Value>
+bool TypedSSTReader<Key, Value>::get(Key key, Value &value, BufferPool *buffer_pool)
+{
+    long page_index = std::upper_bound(fence_keys.begin(), fence_keys.end(), key) - fence_keys.begin() - 1;
+    if (page_index < 0)
+    {
+        return false;
+    }
+
+    alignas(PAGE_SIZE) char page_buffer[PAGE_SIZE];
+    const char *page = readPage(page_index, page_buffer, buffer_pool);
+    if (page == nullptr)
+    {
+        return false;
+    }
+    long pos = signedPageLowerBound(reinterpret_cast<const Key *>(page), PageLayout<Key, Value>::MAX_PAIRS, 1, key);
+    if (pos == static_cast<long>(PageLayout<Key, Value>::MAX_PAIRS) || getPageKey<Key>(page, pos) != key)
+    {
+        return false;
+    }
+    value = getPageValue<Key, Value>(page, pos);
+    return true;
+}
+
+/*
+    Appends the key-value pairs in [key1, key2] to the results, reading the
+    pages in order from the one that may hold key1. Returns false if a page
+    could not be read.
+*/
+template <typename Key, typename Value>
+bool TypedSSTReader<Key, Value>::scan(Key key1, Key key2, std::vector<std::pair<Key, Value>> &results, BufferPool *buffer_pool)
+{
+    long page_index = std::max<long>(std::upper_bound(fence_keys.begin(), fence_keys.end(), key1) - fence_keys.begin() - 1, 0);
+    alignas(PAGE_SIZE) char page_buffer[PAGE_SIZE];
+    for (; page_index < getNumPages() && fence_keys[page_index] <= key2; ++page_index)
+    {
+        const char *page = readPage(page_index, page_buffer, buffer_pool);
+        if (page == nullptr)
+        {
+            return false;
+        }
+        for (long pos = signedPageLowerBound(reinterpret_cast<const Key *>(page), PageLayout<Key, Value>::MAX_PAIRS, 1, key1);
+             pos < static_cast<long>(PageLayout<Key, Value>::MAX_PAIRS); ++pos)
+        {
+            Key key = getPageKey<Key>(page, pos);
+            if ((pos > 0 && key == getPageKey<Key>(page, pos - 1)) || key > key2)
+            {
+                return true;
+            }
+            results.emplace_back(key, getPageValue<Key, Value>(page, pos));
+        }
+    }
+    return true;
+}
+
+/*
+    Appends the key-value pairs of a page to the results (the padding of the
+    last page, where its last key repeats, is skipped), so an SST can be read in order a page at a time.
+    Returns false if the page could not be read.
+*/
+template <typename Key, typename Value>
+bool TypedSSTReader<Key, Value>::readPairs(long page_index, std::vector<std::pair<Key, Value>> &results, BufferPool *buffer_pool)
+{
+    alignas(PAGE_SIZE) char page_buffer[PAGE_SIZE];
+    const char *page = page_index < getNumPages() ? readPage(page_index, page_buffer, buffer_pool) : nullptr;
+    if (page == nullptr)
+    {
+        return false;
+    }
+    for (long pos = 0; pos < static_cast<long>(PageLayout<Key, Value>::MAX_PAIRS) && (pos == 0 || getPageKey<Key>(page, pos) != getPageKey<Key>(page, pos - 1)); ++pos)
+    {
+        results.emplace_back(getPageKey<Key>(page, pos), getPageValue<Key, Value>(page, pos));
+    }
+    return true;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the TypedSSTIterator class's constructor.
+template <typename Key, typename Value>
+TypedSSTIterator<Key, Value>::TypedSSTIterator(TypedSSTReader<Key, Value> *reader) : reader(reader), pos(0), next_page(0), has_error(false)
+{
+    readNextPage();
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the TypedSSTIterator class's functions.
+// Reads pages until one holds a pair, or the SST ends or a page could not be read.
+template <typename Key, typename Value>
+void TypedSSTIterator<Key, Value>::readNextPage()
+{
+    while (!has_error && pos == page_pairs.size() && next_page < reader->getNumPages())
+    {
+        page_pairs.clear();
+        pos = 0;
+        has_error = !reader->readPairs(next_page++, page_pairs);
+    }
+}
+
+// Implementation of the valid function.
+template <typename Key, typename Value>
+bool TypedSSTIterator<Key, Value>::valid()
+{
+    return !has_error && pos < page_pairs.size();
+}
+
+// Implementation of the hasError function.
+template <typename Key, typename Value>
+bool TypedSSTIterator<Key, Value>::hasError()
+{
+    return has_error;
+}
+
+// Implementation of the key function.
+template <typename Key, typename Value>
+Key TypedSSTIterator<Key, Value>::key()
+{
+    return page_pairs[pos].first;
+}
+
+// Implementation of the value function.
+template <typename Key, typename Value>
+Value TypedSSTIterator<Key, Value>::value()
+{
+    return page_pairs[pos].second;
+}
+
+// Implementation of the next function.
+template <typename Key, typename Value>
+void TypedSSTIterator<Key, Value>::next()
+{
+    pos++;
+    readNextPage();
+}
+////////////////////////////////////////////////////////////////////////////
+
+// The key and value types SSTs can be written with (keys are searched with the kernels of pageLowerBound).
+template class TypedSSTWriter<int32_t, int32_t>;
+template class TypedSSTWriter<int32_t, long>;
+template class TypedSSTWriter<long, int32_t>;
+template class TypedSSTWriter<long, long>;
+template class TypedSSTReader<int32_t, int32_t>;
+template class TypedSSTReader<int32_t, long>;
+template class TypedSSTReader<long, int32_t>;
+template class TypedSSTReader<long, long>;
+template class TypedSSTIterator<int32_t, int32_t>;
+template class TypedSSTIterator<int32_t, long>;
+template class TypedSSTIterator<long, int32_t>;
+template class TypedSSTIterator<long, long>;
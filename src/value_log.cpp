@@ -0,0 +1,316 @@
+#include "value_log.h"
+#include "checksum.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the ValuePointer struct's functions.
+// Implementation of the encode function.
+std::string ValuePointer::encode() const
+{
+    long longs[3] = {segment, offset, size};
+    return std::string(reinterpret_cast<const char *>(longs), VALUE_POINTER_SIZE);
+}
+
+// Implementation of the decode function.
+bool ValuePointer::decode(std::string_view bytes)
+{
+    if (bytes.size() != VALUE_POINTER_SIZE)
+    {
+        return false;
+    }
+    long longs[3];
+    std::memcpy(longs, bytes.data(), VALUE_POINTER_SIZE);
+    segment = longs[0];
+    offset = longs[1];
+    size = longs[2];
+    return true;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Define the ValueLog class's constructor and destructor.
+/*
+    Opens the value log in the directory. The segments already in it stay
+    readable, and new records are appended to a new segment after them.
+*/
+ValueLog::ValueLog(std::string directory, size_t segment_size) : directory(directory), segment_size(segment_size), head_segment(-1), rate_limiter(nullptr), bytes_written(0)
+{
+    std::filesystem::create_directories(directory);
+    for (const auto &entry : std::filesystem::directory_iterator(directory))
+    {
+        std::string filename = entry.path().filename().string();
+        if (filename.rfind("vlog_", 0) == 0 && filename.size() > 9 && filename.substr(filename.size() - 4) == ".log")
+        {
+            long segment = std::stol(filename.substr(5, filename.size() - 9));
+            segments[segment] = {-1, static_cast<long>(entry.file_size())};
+        }
+    }
+    startSegment();
+}
+
+ValueLog::~ValueLog()
+{
+    for (auto &[segment, fd_size] : segments)
+    {
+        if (fd_size.first >= 0)
+        {
+            close(fd_size.first);
+        }
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the ValueLog class's private functions.
+// Implementation of the getSegmentFilename function.
+std::string ValueLog::getSegmentFilename(long segment)
+{
+    return directory + "/vlog_" + std::to_string(segment) + ".log";
+}
+
+// Implementation of the openSegment function.
+int ValueLog::openSegment(long segment)
+{
+    std::lock_guard<std::mutex> lock(segments_mutex);
+    auto it = segments.find(segment);
+    if (it == segments.end())
+    {
+        return -1;
+    }
+    if (it->second.first < 0)
+    {
+        it->second.first = open(getSegmentFilename(segment).c_str(), O_RDWR | O_CREAT, 0666);
+    }
+    return it->second.first;
+}
+
+// Implementation of the startSegment function.
+bool ValueLog::startSegment()
+{
+    head_segment = segments.empty() ? 0 : segments.rbegin()->first + 1;
+    {
+        std::lock_guard<std::mutex> lock(segments_mutex);
+        segments[head_segment] = {-1, 0};
+    }
+    if (openSegment(head_segment) < 0)
+    {
+        std::cerr << "Error: Could not create value log segment " << getSegmentFilename(head_segment) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Reads the record a pointer locates and checks its checksum and lengths.
+    Returns false if it could not be read or is corrupted.
+*/
+bool ValueLog::readRecord(const ValuePointer &pointer, std::string &key, std::string &value)
+{
+    int fd = openSegment(pointer.segment);
+    if (fd < 0 || pointer.size < static_cast<long>(VALUE_LOG_RECORD_HEADER_SIZE))
+    {
+        return false;
+    }
+    std::string record(pointer.size, '\0');
+    if (pread(fd, record.data(), pointer.size, pointer.offset) != pointer.size)
+    {
+        return false;
+    }
+
+    uint32_t header[3];
+    std::memcpy(header, record.data(), VALUE_LOG_RECORD_HEADER_SIZE);
+    if (VALUE_LOG_RECORD_HEADER_SIZE + static_cast<uint64_t>(header[1]) + header[2] != static_cast<uint64_t>(pointer.size) ||
+        crc32c(record.data() + sizeof(uint32_t), pointer.size - sizeof(uint32_t)) != header[0])
+    {
+        std::cerr << "Error: Value log record at " << pointer.offset << " of segment " << pointer.segment << " is corrupted." << std::endl;
+        return false;
+    }
+    key.assign(record, VALUE_LOG_RECORD_HEADER_SIZE, header[1]);
+    value.assign(record, VALUE_LOG_RECORD_HEADER_SIZE + header[1], header[2]);
+    return true;
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the ValueLog class's public functions.
+/*
+    Appends a record of the key and its value to the head segment (starting a
+    new one once it is full) and returns where it was written in pointer.
+*/
+bool ValueLog::append(std::string_view key, std::string_view value, ValuePointer &pointer, IOPriority priority)
+{
+    if (segments[head_segment].second >= static_cast<long>(segment_size) && !startSegment())
+    {
+        return false;
+    }
+
+    std::string record(VALUE_LOG_RECORD_HEADER_SIZE, '\0');
+    record.append(key);
+    record.append(value);
+    uint32_t header[3] = {0, static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size())};
+    std::memcpy(record.data() + sizeof(uint32_t), header + 1, 2 * sizeof(uint32_t));
+    header[0] = crc32c(record.data() + sizeof(uint32_t), record.size() - sizeof(uint32_t));
+    std::memcpy(record.data(), header, sizeof(uint32_t));
+
+    if (rate_limiter != nullptr)
+    {
+        rate_limiter->request(record.size(), priority);
+    }
+    int fd = openSegment(head_segment);
+    long offset = segments[head_segment].second;
+    if (fd < 0 || pwrite(fd, record.data(), record.size(), offset) != static_cast<ssize_t>(record.size()))
+    {
+        perror("pwrite failed");
+        std::cerr << "Error: Incomplete write to value log segment " << getSegmentFilename(head_segment) << std::endl;
+        return false;
+    }
+    segments[head_segment].second += record.size();
+    bytes_written += record.size();
+    pointer = {head_segment, offset, static_cast<long>(record.size())};
+    return true;
+}
+
+// Implementation of the read function.
+bool ValueLog::read(const ValuePointer &pointer, std::string &value)
+{
+    std::string key;
+    return readRecord(pointer, key, value);
+}
+
+/*
+    Reads the values the pointers locate into values (in the same order). The
+    pointers are split into up to num_threads contiguous groups that are read
+    at once, so a scan waits for about one read per group instead of one read
+    per value. Returns false if any value could not be read.
+*/
+bool ValueLog::readValues(const std::vector<ValuePointer> &pointers, std::vector<std::string> &values, int num_threads)
+{
+    values.assign(pointers.size(), std::string());
+    size_t num_groups = std::clamp<size_t>(num_threads, 1, std::max<size_t>(pointers.size(), 1));
+    size_t group_size = (pointers.size() + num_groups - 1) / num_groups;
+
+    auto read_group = [&](size_t first, size_t last)
+    {
+        bool is_success = true;
+        for (size_t i = first; i < last; ++i)
+        {
+            is_success &= read(pointers[i], values[i]);
+        }
+        return is_success;
+    };
+
+    std::vector<std::future<bool>> pending_groups;
+    for (size_t first = group_size; first < pointers.size(); first += group_size)
+    {
+        pending_groups.push_back(std::async(std::launch::async, read_group, first, std::min(first + group_size, pointers.size())));
+    }
+    bool is_success = read_group(0, std::min(group_size, pointers.size()));
+    for (std::future<bool> &pending_group : pending_groups)
+    {
+        is_success &= pending_group.get();
+    }
+    return is_success;
+}
+
+/*
+    Collects the garbage of the oldest segment other than the head segment:
+    every record that is_live says is still the newest value of its key is
+    appended again and given to relocate (which points the key at its new
+    place), then the segment file is removed. Returns false if there is no
+    segment to collect or a record could not be read or relocated, in which
+    case the segment is kept.
+*/
+bool ValueLog::collectGarbage(const std::function<bool(const std::string &key, const ValuePointer &pointer)> &is_live,
+                              const std::function<bool(const std::string &key, const ValuePointer &pointer)> &relocate)
+{
+    if (segments.size() < 2)
+    {
+        return false;
+    }
+    long segment = segments.begin()->first;
+    long segment_size = segments.begin()->second.second;
+
+    std::string key;
+    std::string value;
+    for (long offset = 0; offset < segment_size;)
+    {
+        // Read the header first to find the size of the record
+        uint32_t header[3];
+        int fd = openSegment(segment);
+        if (fd < 0 || pread(fd, header, VALUE_LOG_RECORD_HEADER_SIZE, offset) != static_cast<ssize_t>(VALUE_LOG_RECORD_HEADER_SIZE))
+        {
+            return false;
+        }
+        ValuePointer pointer = {segment, offset, static_cast<long>(VALUE_LOG_RECORD_HEADER_SIZE + static_cast<uint64_t>(header[1]) + header[2])};
+        if (!readRecord(pointer, key, value))
+        {
+            return false;
+        }
+        if (is_live(key, pointer))
+        {
+            ValuePointer new_pointer;
+            if (!append(key, value, new_pointer, IOPriority::LOW) || !relocate(key, new_pointer))
+            {
+                return false;
+            }
+        }
+        offset += pointer.size;
+    }
+
+    std::lock_guard<std::mutex> lock(segments_mutex);
+    close(segments.begin()->second.first);
+    segments.erase(segments.begin());
+    std::remove(getSegmentFilename(segment).c_str());
+    return true;
+}
+
+// Implementation of the getNumSegments function.
+long ValueLog::getNumSegments()
+{
+    return segments.size();
+}
+
+// Implementation of the getBytesWritten function.
+long ValueLog::getBytesWritten()
+{
+    return bytes_written;
+}
+
+// Implementation of the getDiskBytes function.
+long ValueLog::getDiskBytes()
+{
+    long disk_bytes = 0;
+    for (const auto &[segment, fd_size] : segments)
+    {
+        disk_bytes += fd_size.second;
+    }
+    return disk_bytes;
+}
+
+// Implementation of the setRateLimiter function.
+void ValueLog::setRateLimiter(RateLimiter *new_rate_limiter)
+{
+    rate_limiter = new_rate_limiter;
+}
+
+// Implementation of the removeAll function.
+void ValueLog::removeAll()
+{
+    std::lock_guard<std::mutex> lock(segments_mutex);
+    for (auto &[segment, fd_size] : segments)
+    {
+        if (fd_size.first >= 0)
+        {
+            close(fd_size.first);
+        }
+        std::remove(getSegmentFilename(segment).c_str());
+    }
+    segments.clear();
+}
+////////////////////////////////////////////////////////////////////////////
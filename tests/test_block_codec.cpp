@@ -0,0 +1,190 @@
+#include "test_block_codec.h"
+#include "checksum.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Every compression type, including the ones that may not be built in.
+static const CompressionType COMPRESSION_TYPES[] = {CompressionType::LZ, CompressionType::LZ_HIGH, CompressionType::LZ4, CompressionType::ZSTD};
+
+void testBlockCodecs()
+{
+    check(getBlockCodec(CompressionType::NONE) == nullptr && isCompressionSupported(CompressionType::NONE) && isCompressionSupported(CompressionType::LZ) &&
+              isCompressionSupported(CompressionType::LZ_HIGH),
+          "testBlockCodecs: The built-in codecs are always supported");
+
+    // A page of a plain SST, a page of random bytes and a page of zeros
+    alignas(PAGE_SIZE) char pages[3][PAGE_SIZE];
+    long *longs = reinterpret_cast<long *>(pages[0]);
+    for (long i = 0; i < static_cast<long>(MAX_PAIRS); ++i)
+    {
+        longs[i * 2] = 1000 + i * 3;
+        longs[i * 2 + 1] = (1000 + i * 3) * 10;
+    }
+    std::mt19937_64 gen(443);
+    for (size_t i = 0; i < PAGE_SIZE / sizeof(long); ++i)
+    {
+        reinterpret_cast<unsigned long *>(pages[1])[i] = gen();
+    }
+    std::memset(pages[2], 0, PAGE_SIZE);
+
+    for (CompressionType type : COMPRESSION_TYPES)
+    {
+        const BlockCodec *codec = getBlockCodec(type);
+        if (codec == nullptr)
+        {
+            std::cout << getCompressionName(type) << " was not built in." << std::endl;
+            continue;
+        }
+        std::string name = codec->getName();
+        char compressed[PAGE_SIZE];
+        alignas(PAGE_SIZE) char decompressed[PAGE_SIZE];
+
+        size_t size = codec->compress(pages[0], PAGE_SIZE, compressed, PAGE_SIZE - 1);
+        bool is_equal = size > 0 && size * 3 < PAGE_SIZE * 2 && codec->decompress(compressed, size, decompressed, PAGE_SIZE) &&
+                        std::memcmp(decompressed, pages[0], PAGE_SIZE) == 0;
+        check(codec->getType() == type && is_equal, "testBlockCodecs: " + name + " shrinks an SST page by a third and decompresses it back");
+        check(!codec->decompress(compressed, size / 2, decompressed, PAGE_SIZE), "testBlockCodecs: " + name + " rejects a truncated block");
+
+        size = codec->compress(pages[2], PAGE_SIZE, compressed, PAGE_SIZE - 1);
+        check(size > 0 && size < 256 && codec->decompress(compressed, size, decompressed, PAGE_SIZE) && std::memcmp(decompressed, pages[2], PAGE_SIZE) == 0,
+              "testBlockCodecs: " + name + " compresses a page of zeros to a few bytes");
+
+        // Random bytes do not shrink, so they are left for the writer to store as they are
+        check(codec->compress(pages[1], PAGE_SIZE, compressed, PAGE_SIZE - 1) == 0, "testBlockCodecs: " + name + " gives up on incompressible pages");
+    }
+}
+
+void testCompressedSST()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_compressed.bin";
+    std::string plain_filename = filepath + "/sst_plain.bin";
+
+    std::vector<long> keys;
+    for (long i = 0; i < 20 * static_cast<long>(MAX_PAIRS) + 17; ++i)
+    {
+        keys.push_back(1000 + i * 3 + (i % 7 == 0));
+    }
+    SSTWriter plain_writer(plain_filename);
+    for (long key : keys)
+    {
+        plain_writer.put(key, key * 10);
+    }
+    check(plain_writer.finish(), "testCompressedSST: Write a plain SST");
+    SSTFooter plain_footer;
+    readSSTFooter(plain_filename, plain_footer);
+
+    for (CompressionType type : COMPRESSION_TYPES)
+    {
+        if (!isCompressionSupported(type))
+        {
+            continue;
+        }
+        for (PageEncoding encoding : {PageEncoding::PLAIN, PageEncoding::PACKED})
+        {
+            for (IndexLayout layout : {IndexLayout::B_TREE, IndexLayout::S_TREE})
+            {
+                std::string name = std::string("testCompressedSST: ") + getCompressionName(type) + (encoding == PageEncoding::PACKED ? " packed" : " plain") +
+                                   (layout == IndexLayout::S_TREE ? " S+-tree" : " B-Tree");
+                std::filesystem::remove(sst_filename);
+                SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, layout, encoding, type);
+                for (long key : keys)
+                {
+                    writer.put(key, key * 10);
+                }
+                bool is_written = writer.finish();
+                SSTMetadata metadata = writer.getMetadata();
+
+                SSTFooter footer;
+                check(is_written && readSSTFooter(sst_filename, footer) && footer.compression == type && footer.num_entries == static_cast<long>(keys.size()) &&
+                          *footer.block_offsets == *metadata.footer.block_offsets && std::filesystem::file_size(sst_filename) < std::filesystem::file_size(plain_filename),
+                      name + ": the file is smaller and the footer loads its block index");
+
+                std::vector<long> read_keys;
+                bool is_success = true;
+                SSTIterator iterator(sst_filename);
+                for (; iterator.valid(); iterator.next())
+                {
+                    read_keys.push_back(iterator.key());
+                    is_success &= iterator.value() == iterator.key() * 10;
+                }
+                check(is_success && read_keys == keys && !iterator.hasError(), name + ": iterator returns every pair");
+
+                // Every get path decompresses the pages, through the B-Tree from disk and from a mapping, and without it
+                BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+                MappedFile sst_map(sst_filename);
+                StaticBTree btree(sst_filename, sst_filename);
+                StaticBTree mapped_btree(sst_filename, sst_filename, &sst_map, &sst_map);
+                btree.setIndexBlock(footer);
+                mapped_btree.setIndexBlock(footer);
+                is_success = true;
+                for (size_t i = 0; i < keys.size(); i += 7)
+                {
+                    long key = keys[i];
+                    NodeFileOffset *results[] = {binarySearch(sst_filename, key, buffer_pool, nullptr, &footer), fencePointerSearch(sst_filename, metadata, key, nullptr),
+                                                 interpolationSearch(sst_filename, metadata, key, nullptr, &sst_map), learnedIndexSearch(sst_filename, metadata, key, buffer_pool)};
+                    for (NodeFileOffset *found : results)
+                    {
+                        is_success &= found != nullptr && found->node->value == key * 10;
+                        delete found;
+                    }
+                    is_success &= btree.get(key, buffer_pool) == key * 10 && mapped_btree.get(key) == key * 10 && btree.get(key + 1) == -1;
+                }
+                check(is_success, name + ": get keys through the index, binary, fence pointer, interpolation and learned index searches");
+
+                long key1 = keys[MAX_PAIRS + 5], key2 = keys[10 * MAX_PAIRS];
+                std::vector<std::pair<long, long>> expected;
+                for (long key : keys)
+                {
+                    if (key >= key1 && key <= key2)
+                    {
+                        expected.emplace_back(key, key * 10);
+                    }
+                }
+                check(btree.scan(key1, key2, buffer_pool) == expected && mapped_btree.scan(key1, key2) == expected &&
+                          binarySearchScan(sst_filename, key1, key2, nullptr, &sst_map, &footer) == expected,
+                      name + ": scans return every pair in the range");
+
+                // A page found in the buffer pool is already decompressed, so it is not read again
+                NodeFileOffset *found = binarySearch(sst_filename, keys[3 * MAX_PAIRS], buffer_pool, nullptr, &footer);
+                check(found != nullptr && found->node->value == keys[3 * MAX_PAIRS] * 10 && buffer_pool->searchForPage(sst_filename + "#3") != nullptr,
+                      name + ": decompressed pages are cached in the buffer pool");
+                delete found;
+                delete buffer_pool;
+            }
+        }
+    }
+
+    // A compressed page that does not match its checksum is never decompressed
+    std::filesystem::remove(sst_filename);
+    SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, PageEncoding::PLAIN, CompressionType::LZ);
+    for (long key : keys)
+    {
+        writer.put(key, key * 10);
+    }
+    writer.finish();
+    {
+        std::fstream file(sst_filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(PAGE_SIZE + 100);
+        file.put('\x7f');
+    }
+    long num_pairs = 0;
+    SSTIterator iterator(sst_filename);
+    for (; iterator.valid(); iterator.next())
+    {
+        num_pairs++;
+    }
+    check(iterator.hasError() && num_pairs < static_cast<long>(keys.size()), "testCompressedSST: Iterator stops at a corrupted compressed page");
+
+    for (const std::string &filename : {sst_filename, plain_filename})
+    {
+        std::filesystem::remove(filename);
+        removeChecksumFile(filename);
+    }
+}
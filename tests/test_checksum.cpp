@@ -0,0 +1,136 @@
+#include "test_checksum.h"
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+void testCRC32C()
+{
+    const std::string check_string = "123456789";
+    bool was_hardware = isHardwareCRC32C();
+
+    setHardwareCRC32C(false);
+    check(crc32c(check_string.data(), check_string.size()) == 0xE3069283, "CRC32C Test: Software checksum of the check string");
+    check(crc32c(check_string.data() + 4, 5, crc32c(check_string.data(), 4)) == 0xE3069283, "CRC32C Test: Software checksum can be continued");
+
+    if (setHardwareCRC32C(true))
+    {
+        check(crc32c(check_string.data(), check_string.size()) == 0xE3069283, "CRC32C Test: Hardware checksum of the check string");
+
+        // Both kernels agree on every length and alignment (including the tails shorter than 8 bytes)
+        std::mt19937 gen(443);
+        std::vector<unsigned char> data(PAGE_SIZE + 64);
+        for (unsigned char &byte : data)
+        {
+            byte = static_cast<unsigned char>(gen());
+        }
+        bool is_equal = true;
+        for (size_t offset = 0; offset < 8; offset++)
+        {
+            for (size_t length : {0UL, 1UL, 7UL, 8UL, 9UL, 63UL, PAGE_SIZE})
+            {
+                setHardwareCRC32C(true);
+                uint32_t hardware = crc32c(data.data() + offset, length);
+                setHardwareCRC32C(false);
+                is_equal &= hardware == crc32c(data.data() + offset, length);
+            }
+        }
+        check(is_equal, "CRC32C Test: Hardware and software checksums are equal");
+    }
+    setHardwareCRC32C(was_hardware);
+}
+
+// Flips every bit of the byte at the given offset of a file.
+static void corruptByte(const std::string &filename, off_t offset)
+{
+    int fd = open(filename.c_str(), O_RDWR);
+    char byte;
+    pread(fd, &byte, 1, offset);
+    byte = ~byte;
+    pwrite(fd, &byte, 1, offset);
+    close(fd);
+}
+
+void testChecksumCorruption()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_checksum.bin";
+    std::string btree_filename = filepath + "/btree_checksum.bin";
+    std::string bloom_filename = filepath + "/bloom_checksum.bin";
+
+    // Four pages of keys 0, 2, 4, ... with values 10 times larger
+    SSTWriter writer(sst_filename, btree_filename, bloom_filename);
+    for (long i = 0; i < 4 * static_cast<long>(MAX_PAIRS); i++)
+    {
+        writer.put(i * 2, i * 20);
+    }
+    writer.finish();
+    SSTMetadata metadata = writer.getMetadata();
+    long good_key = 0;
+    long bad_key = MAX_PAIRS * 2; // The first key of the second page
+
+    check(getNumPageChecksums(sst_filename) == 4 && getNumPageChecksums(bloom_filename) == 1, "Checksum Test: Every page written has a checksum");
+    check(verifyPageChecksums(sst_filename, 1, nullptr, 0), "Checksum Test: An empty read is intact");
+
+    // Corrupt the value of the first pair of the second page
+    corruptByte(sst_filename, PAGE_SIZE + sizeof(long));
+    resetChecksumMismatches();
+
+    setChecksumMode(ChecksumMode::OFF);
+    NodeFileOffset *unchecked = fencePointerSearch(sst_filename, metadata, bad_key, nullptr);
+    check(unchecked != nullptr && unchecked->node->value != bad_key * 10, "Checksum Test: The corrupted value is returned when checksums are off");
+    delete unchecked;
+    check(getChecksumMismatches() == 0, "Checksum Test: No page is checked when checksums are off");
+
+    setChecksumMode(ChecksumMode::ON);
+    NodeFileOffset *intact = fencePointerSearch(sst_filename, metadata, good_key, nullptr);
+    check(intact != nullptr && intact->node->value == good_key * 10, "Checksum Test: Intact pages are still read");
+    delete intact;
+    check(fencePointerSearch(sst_filename, metadata, bad_key, nullptr) == nullptr, "Checksum Test: Fence pointer search rejects the corrupted page");
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    check(binarySearch(sst_filename, bad_key, buffer_pool) == nullptr, "Checksum Test: Binary search rejects the corrupted page");
+    delete buffer_pool;
+    StaticBTree btree(sst_filename, btree_filename);
+    check(btree.get(bad_key) == -1 && btree.get(good_key) == good_key * 10, "Checksum Test: B-Tree get rejects the corrupted page");
+
+    // Compaction reads its input with an SSTIterator, which stops at the corrupted page
+    SSTIterator iterator(sst_filename);
+    long num_pairs = 0;
+    for (; iterator.valid(); iterator.next())
+    {
+        num_pairs++;
+    }
+    check(iterator.hasError() && num_pairs == MAX_PAIRS, "Checksum Test: Compaction input stops at the corrupted page");
+
+    // The statistics of the SST cannot be rebuilt past the corrupted page, so an LSM tree refuses it
+    SSTMetadata read_metadata;
+    check(!readSSTMetadata(sst_filename, read_metadata), "Checksum Test: Reading the statistics fails at the corrupted page");
+    LSMTree *lsm_tree = new LSMTree(MAX_PAIRS, "test_db", dbOpen("test_db", MAX_PAIRS));
+    check(!lsm_tree->insertSST(sst_filename, btree_filename) && lsm_tree->getLevels()[0].empty(), "Checksum Test: An LSM tree refuses the corrupted SST");
+    delete lsm_tree;
+
+    // Mapped pages are only checked in PARANOID mode
+    MappedFile sst_map(sst_filename);
+    NodeFileOffset *mapped = fencePointerSearch(sst_filename, metadata, bad_key, nullptr, &sst_map);
+    check(mapped != nullptr, "Checksum Test: Mapped pages are not checked when checksums are on");
+    delete mapped;
+    setChecksumMode(ChecksumMode::PARANOID);
+    check(fencePointerSearch(sst_filename, metadata, bad_key, nullptr, &sst_map) == nullptr, "Checksum Test: Mapped pages are checked in paranoid mode");
+    setChecksumMode(ChecksumMode::ON);
+
+    // A corrupted Bloom filter lets every key through instead of hiding keys
+    corruptByte(bloom_filename, 0);
+    long mismatches = getChecksumMismatches();
+    BloomFilter bloom_filter(BLOOM_FILTER_NUM_BITS, BLOOM_FILTER_NUM_HASHES);
+    bloom_filter.loadBitArrayFromFile(bloom_filename);
+    check(getChecksumMismatches() == mismatches + 1 && bloom_filter.mightContain("-1"), "Checksum Test: A corrupted Bloom filter lets every key through");
+
+    for (const std::string &filename : {sst_filename, btree_filename, bloom_filename})
+    {
+        std::remove(filename.c_str());
+        removeChecksumFile(filename);
+    }
+}
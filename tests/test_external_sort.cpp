@@ -0,0 +1,98 @@
+#include "test_external_sort.h"
+#include <iostream>
+#include <map>
+#include <random>
+
+extern void check(bool condition, const std::string &test_name);
+
+void testExternalSortRuns()
+{
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, 1);
+    delete memtable;
+
+    // Small runs so that the pairs are spread over many runs sorted by two threads
+    std::string run_prefix = DATA_FILE_PATH + current_database + "/run_test";
+    std::map<long, long> answer_map;
+    size_t num_runs = 0;
+    bool is_sorted = true;
+    bool is_success = true;
+    size_t num_pairs = 0;
+    {
+        ExternalSorter sorter(run_prefix, 100, 2);
+        std::mt19937_64 gen(42);
+        std::uniform_int_distribution<long> dist(0, 500);
+        for (long i = 0; i < 2000; ++i)
+        {
+            long key = dist(gen);
+            sorter.add(key, i);
+            answer_map[key] = i;
+        }
+        check(sorter.finish(), "testExternalSortRuns: Runs are written.");
+        num_runs = sorter.getNumRuns();
+
+        long key;
+        long value;
+        long last_key = -1;
+        while (sorter.next(key, value))
+        {
+            is_sorted = is_sorted && key > last_key;
+            is_success = is_success && answer_map.count(key) == 1 && answer_map[key] == value;
+            last_key = key;
+            num_pairs++;
+        }
+        is_success = is_success && !sorter.hasError();
+    }
+
+    check(num_runs == 20, "testExternalSortRuns: Pairs are split into runs of bounded size.");
+    check(is_sorted && num_pairs == answer_map.size(), "testExternalSortRuns: Merge returns every key once in increasing order.");
+    check(is_success, "testExternalSortRuns: Merge keeps the last value written for each key.");
+    check(!std::filesystem::exists(run_prefix + "_0.bin"), "testExternalSortRuns: Run files are removed afterwards.");
+
+    dbClear(current_database);
+}
+
+void testLSMIngestCSV()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+
+    // Write an unsorted CSV file with a header and repeated keys
+    std::string csv_filename = DATA_FILE_PATH + current_database + "/ingest.csv";
+    std::ofstream out(csv_filename);
+    out << "key,value\n";
+    std::map<long, long> answer_map;
+    for (long i = 0; i < 3000; ++i)
+    {
+        long key = (i * 7919) % 1000;
+        out << key << "," << i << "\n";
+        answer_map[key] = i;
+    }
+    out.close();
+
+    check(lsm_tree->ingestFile(csv_filename), "testLSMIngestCSV: Ingest an unsorted CSV file.");
+    check(lsm_tree->getMemtable()->getCurrSize() == 0, "testLSMIngestCSV: Ingest bypasses the memtable.");
+
+    bool is_success = true;
+    for (const auto &entry : answer_map)
+    {
+        NodeFileOffset *node_file_offset = lsm_tree->get(entry.first, buffer_pool, false);
+        if (node_file_offset == nullptr || node_file_offset->node->value != entry.second)
+        {
+            is_success = false;
+        }
+    }
+    check(is_success, "testLSMIngestCSV: Get the last value written for every key.");
+
+    std::pair<std::pair<long, long> *, int> scanned_pairs = lsm_tree->scan(0, 999, buffer_pool, false);
+    check(scanned_pairs.second == static_cast<int>(answer_map.size()), "testLSMIngestCSV: Scan returns every key once.");
+    delete[] scanned_pairs.first;
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
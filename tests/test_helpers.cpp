@@ -1,4 +1,6 @@
 #include "test_helpers.h"
+#include <algorithm>
+#include <cmath>
 
 /*
     The function for the open command-line argument for our DB.
@@ -43,3 +45,30 @@ void dbClear(std::string current_database)
         }
     }
 }
+
+////////////////////////////////////////////////////////////////////////////
+// Define the ZipfianGenerator class's constructor.
+ZipfianGenerator::ZipfianGenerator(long num_items, double exponent, uint64_t seed) : cdf(std::max(num_items, 1L)), gen(seed), uniform(0, 1)
+{
+    double total = 0;
+    for (size_t i = 0; i < cdf.size(); ++i)
+    {
+        total += 1 / std::pow(i + 1, exponent);
+        cdf[i] = total;
+    }
+    for (double &probability : cdf)
+    {
+        probability /= total;
+    }
+}
+////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////
+// Implement all of the ZipfianGenerator class's functions.
+// Implementation of the next function.
+long ZipfianGenerator::next()
+{
+    long rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin();
+    return std::min<long>(rank, cdf.size() - 1);
+}
+////////////////////////////////////////////////////////////////////////////
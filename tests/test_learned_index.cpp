@@ -0,0 +1,64 @@
+#include "test_learned_index.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns whether every key is predicted within the error bound (plus one for rounding) of its position.
+static bool isWithinErrorBound(const LearnedIndex &index, const std::vector<long> &keys)
+{
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (std::abs(index.predict(keys[i]) - static_cast<long>(i)) > LEARNED_INDEX_EPSILON + 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testLearnedIndexErrorBound()
+{
+    std::mt19937_64 gen(443);
+
+    // Uniformly distributed keys, like the keys of generate_random_pairs
+    std::set<long> uniform_set;
+    std::uniform_int_distribution<long> uniform_dist(0, LONG_MAX);
+    while (uniform_set.size() < 100000)
+    {
+        uniform_set.insert(uniform_dist(gen));
+    }
+    std::vector<long> uniform_keys(uniform_set.begin(), uniform_set.end());
+
+    // Skewed keys: dense runs separated by large gaps
+    std::vector<long> skewed_keys;
+    long key = 0;
+    for (int run = 0; run < 200; ++run)
+    {
+        key += std::uniform_int_distribution<long>(1, 1L << 40)(gen);
+        for (int i = 0; i < 500; ++i)
+        {
+            key += std::uniform_int_distribution<long>(1, 3)(gen);
+            skewed_keys.push_back(key);
+        }
+    }
+
+    LearnedIndex uniform_index, skewed_index, empty_index;
+    for (long k : uniform_keys)
+    {
+        uniform_index.add(k);
+    }
+    for (long k : skewed_keys)
+    {
+        skewed_index.add(k);
+    }
+
+    check(isWithinErrorBound(uniform_index, uniform_keys), "Learned Index Test: Uniform keys are predicted within the error bound");
+    check(isWithinErrorBound(skewed_index, skewed_keys), "Learned Index Test: Skewed keys are predicted within the error bound");
+    check(uniform_index.getNumSegments() * MAX_PAIRS < uniform_keys.size(), "Learned Index Test: Uniform keys need fewer segments than pages");
+    check(empty_index.predict(42) == 0 && uniform_index.predict(-1) == 0 && uniform_index.predict(LONG_MAX) < static_cast<long>(uniform_keys.size()),
+          "Learned Index Test: Keys outside of the index are clamped to its positions");
+}
@@ -64,9 +64,9 @@ void testLSMScanTwoPage()
 
     check(is_success, "testLSMScanTwoPage: Scan SSTs with two page each.");
     dbClear(current_database);
-    free(buffer_pool);
-    free(memtable);
-    free(lsm_tree);
+    // The LSM tree deleted the original memtable when it was flushed
+    delete buffer_pool;
+    delete lsm_tree;
 }
 
 void testLSMScanTwoPagesDiskOnePageInMemoryOneLevel()
@@ -121,9 +121,9 @@ void testLSMScanTwoPagesDiskOnePageInMemoryOneLevel()
     }
 
     check(is_success, "testLSMScanTwoPagesDiskOnePageInMemoryOneLevel: Scan LSM tree with 3 pages total.");
-    free(buffer_pool);
-    free(memtable);
-    free(lsm_tree);
+    // The LSM tree deleted the original memtable when it was flushed
+    delete buffer_pool;
+    delete lsm_tree;
     dbClear(current_database);
 }
 
@@ -147,7 +147,8 @@ void testLSMScanThreePagesOnDiskTwoLevel()
         answer_map[i] = i * 10;
     }
 
-    std::pair<std::string, std::string> filenames = dbClose(memtable, current_database);
+    // The first memtable was freed by the first flush, so write out the current one
+    std::pair<std::string, std::string> filenames = dbClose(lsm_tree->getMemtable(), current_database);
     lsm_tree->insertSST(filenames.first, filenames.second);
 
     // Setup Expected values to compare
@@ -181,8 +182,943 @@ void testLSMScanThreePagesOnDiskTwoLevel()
     }
 
     check(is_success, "testLSMScanThreePagesOnDiskTwoLevel: Scan LSM tree with 3 pages total");
-    free(buffer_pool);
-    free(memtable);
-    free(lsm_tree);
+    delete buffer_pool;
+    delete lsm_tree;
     dbClear(current_database);
-}
\ No newline at end of file
+}
+void testLSMTombstoneDroppedEarly()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    // First SST holds the odd keys, second SST only deletes the even keys (which were never written)
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (int i = 1; i <= 256; ++i)
+    {
+        lsm_tree->put(2 * i - 1, i * 10);
+    }
+    for (int i = 1; i <= 256; ++i)
+    {
+        lsm_tree->put(2 * i, LONG_MIN);
+    }
+
+    // Nothing older can hold those keys, so the compaction of level 0 drops the tombstones
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    check(levels[0].empty() && levels[1].size() == 1, "testLSMTombstoneDroppedEarly: Level 0 is compacted into level 1.");
+    check(levels[1].size() == 1 && levels[1][0].metadata.num_entries == 256, "testLSMTombstoneDroppedEarly: Merged SST keeps every put.");
+    check(levels[1].size() == 1 && levels[1][0].metadata.num_tombstones == 0, "testLSMTombstoneDroppedEarly: Merged SST drops every tombstone.");
+
+    delete lsm_tree;
+    dbClear(current_database);
+}
+
+void testLSMTombstoneDensityCompaction()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Two flushes of sequential keys are moved down the tree
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (int i = 1; i <= 512; ++i)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+
+    // Flush an SST that only holds tombstones, which is merged down without waiting for level 0 to fill up
+    for (int i = 1; i <= 256; ++i)
+    {
+        lsm_tree->put(i, LONG_MIN);
+    }
+
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    long num_entries = 0;
+    long num_tombstones = 0;
+    for (const std::vector<SST> &level : levels)
+    {
+        for (const SST &sst : level)
+        {
+            num_entries += sst.metadata.num_entries;
+            num_tombstones += sst.metadata.num_tombstones;
+        }
+    }
+    check(levels[0].empty(), "testLSMTombstoneDensityCompaction: Tombstone SST is compacted out of level 0.");
+    check(num_entries == 256, "testLSMTombstoneDensityCompaction: Deleted keys are removed from the tree.");
+    check(num_tombstones == 0, "testLSMTombstoneDensityCompaction: Tombstones are dropped at the bottom of the tree.");
+
+    bool is_success = true;
+    for (int i = 1; i <= 512; ++i)
+    {
+        NodeFileOffset *node_file_offset = lsm_tree->get(i, buffer_pool, false);
+        if (i <= 256 && node_file_offset != nullptr && node_file_offset->node->value != LONG_MIN)
+        {
+            is_success = false;
+        }
+        if (i > 256 && (node_file_offset == nullptr || node_file_offset->node->value != i * 10))
+        {
+            is_success = false;
+        }
+    }
+    check(is_success, "testLSMTombstoneDensityCompaction: Get returns the values left after the compaction.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMTombstoneCompactionOverlap()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Two bulk loads of disjoint keys leave two SSTs on the last level
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    std::vector<std::pair<long, long>> low_pairs;
+    std::vector<std::pair<long, long>> high_pairs;
+    for (long i = 1; i <= 256; ++i)
+    {
+        low_pairs.emplace_back(i, i * 10);
+        high_pairs.emplace_back(i + 1000, (i + 1000) * 10);
+    }
+    lsm_tree->bulkLoad(low_pairs);
+    lsm_tree->bulkLoad(high_pairs);
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    const std::vector<SST> &last_level = levels[MAX_LSM_LEVEL - 1];
+    std::string high_filename = last_level.size() == 2 ? last_level[1].sst_filename : "";
+    check(last_level.size() == 2 && last_level[1].metadata.min_key == 1001, "testLSMTombstoneCompactionOverlap: Bulk loads fill the last level.");
+
+    // Flush an SST that deletes every low key, which is merged down into the low SST only
+    for (long i = 1; i <= 256; ++i)
+    {
+        lsm_tree->put(i, LONG_MIN);
+    }
+    size_t num_ssts = 0;
+    for (const std::vector<SST> &level : levels)
+    {
+        num_ssts += level.size();
+    }
+    check(num_ssts == 1 && last_level.size() == 1 && last_level[0].sst_filename == high_filename,
+          "testLSMTombstoneCompactionOverlap: The SST that does not overlap the tombstones is left as it is.");
+
+    bool is_success = true;
+    for (long i = 1; i <= 256; ++i)
+    {
+        NodeFileOffset *deleted = lsm_tree->get(i, buffer_pool, true);
+        NodeFileOffset *kept = lsm_tree->get(i + 1000, buffer_pool, true);
+        is_success &= (deleted == nullptr || deleted->node->value == LONG_MIN) && kept != nullptr && kept->node->value == (i + 1000) * 10;
+        delete deleted;
+        delete kept;
+    }
+    check(is_success, "testLSMTombstoneCompactionOverlap: Get returns the values left after the compaction.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMDeleteRange()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Two flushes of sequential keys are moved down the tree
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (int i = 1; i <= 512; ++i)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+
+    // Delete a range with a single range tombstone, then put a key back into it
+    lsm_tree->deleteRange(100, 199);
+    lsm_tree->put(150, 1);
+
+    NodeFileOffset *node_file_offset = lsm_tree->get(120, buffer_pool, false);
+    check(node_file_offset != nullptr && node_file_offset->node->value == LONG_MIN, "testLSMDeleteRange: Get of a key deleted by the memtable range tombstone.");
+    delete node_file_offset;
+    node_file_offset = lsm_tree->get(150, buffer_pool, false);
+    check(node_file_offset != nullptr && node_file_offset->node->value == 1, "testLSMDeleteRange: Get of a key put after the range tombstone.");
+    delete node_file_offset;
+
+    std::pair<std::pair<long, long> *, int> scanned_pairs = lsm_tree->scan(90, 210, buffer_pool, false);
+    check(scanned_pairs.second == 22, "testLSMDeleteRange: Scan skips the keys deleted by the memtable range tombstone.");
+    delete[] scanned_pairs.first;
+
+    // Flush the range tombstone into an SST on level 0
+    for (int i = 1000; lsm_tree->getLevels()[0].empty(); ++i)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    check(levels[0].size() == 1 && levels[0][0].metadata.range_tombstones.size() == 1, "testLSMDeleteRange: Flushed SST holds a single range tombstone.");
+    check(levels[0].size() == 1 && levels[0][0].metadata.num_tombstones == 0, "testLSMDeleteRange: Flushed SST holds no tombstone per key.");
+
+    bool is_success = true;
+    for (int i = 1; i <= 512; ++i)
+    {
+        node_file_offset = lsm_tree->get(i, buffer_pool, false);
+        bool is_deleted = node_file_offset == nullptr || node_file_offset->node->value == LONG_MIN;
+        if (i >= 100 && i <= 199 && i != 150 && !is_deleted)
+        {
+            is_success = false;
+        }
+        if (i == 150 && (is_deleted || node_file_offset->node->value != 1))
+        {
+            is_success = false;
+        }
+        if ((i < 100 || i > 199) && (is_deleted || node_file_offset->node->value != i * 10))
+        {
+            is_success = false;
+        }
+        delete node_file_offset;
+    }
+    check(is_success, "testLSMDeleteRange: Get consults the range tombstones of SSTs.");
+
+    scanned_pairs = lsm_tree->scan(90, 210, buffer_pool, false);
+    check(scanned_pairs.second == 22, "testLSMDeleteRange: Scan skips the keys deleted by an SST range tombstone.");
+    delete[] scanned_pairs.first;
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMDeleteRangeCompaction()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    // Two overlapping flushes are compacted into a single SST on level 1
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (int i = 1; i <= 512; i += 2)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+    for (int i = 2; i <= 512; i += 2)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+    lsm_tree->deleteRange(100, 199);
+
+    // Two more overlapping flushes fill up level 0 and then level 1, which merges the range tombstone with the older keys
+    for (int i = 1000; i < 1510; i += 2)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+    for (int i = 1001; i <= 1512; i += 2)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+
+    long num_entries = 0;
+    long num_range_tombstones = 0;
+    for (const std::vector<SST> &level : lsm_tree->getLevels())
+    {
+        for (const SST &sst : level)
+        {
+            num_entries += sst.metadata.num_entries;
+            num_range_tombstones += sst.metadata.range_tombstones.size();
+        }
+    }
+    check(num_entries == 412 + 511, "testLSMDeleteRangeCompaction: Compaction drops the keys covered by the range tombstone.");
+    check(num_range_tombstones == 0, "testLSMDeleteRangeCompaction: Range tombstone is dropped once nothing older is left to hide.");
+
+    delete lsm_tree;
+    dbClear(current_database);
+}
+
+void testLSMTrivialMove()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Flush four SSTs of sequential keys, so no SST overlaps another
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    std::vector<std::string> flushed_filenames;
+    for (int i = 1; i <= 1024; ++i)
+    {
+        lsm_tree->put(i, i * 10);
+        if (i % db_size == 0)
+        {
+            flushed_filenames.push_back(lsm_tree->getLevels()[0].empty() ? lsm_tree->getLevels()[MAX_LSM_LEVEL - 1].back().sst_filename : lsm_tree->getLevels()[0].back().sst_filename);
+        }
+    }
+
+    // Every SST was moved down to the last level without being rewritten
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    bool is_success = levels[MAX_LSM_LEVEL - 1].size() == 4;
+    for (int level_idx = 0; level_idx < static_cast<int>(MAX_LSM_LEVEL) - 1; ++level_idx)
+    {
+        is_success = is_success && levels[level_idx].empty();
+    }
+    check(is_success, "testLSMTrivialMove: Non-overlapping SSTs are moved to the last level.");
+
+    is_success = levels[MAX_LSM_LEVEL - 1].size() == 4;
+    for (size_t i = 0; is_success && i < flushed_filenames.size(); ++i)
+    {
+        is_success = levels[MAX_LSM_LEVEL - 1][i].sst_filename == flushed_filenames[i];
+    }
+    check(is_success, "testLSMTrivialMove: Moved SSTs keep their files.");
+
+    is_success = true;
+    for (int i = 1; i <= 1024; ++i)
+    {
+        NodeFileOffset *node_file_offset = lsm_tree->get(i, buffer_pool, false);
+        if (node_file_offset == nullptr || node_file_offset->node->value != i * 10)
+        {
+            is_success = false;
+        }
+    }
+    check(is_success, "testLSMTrivialMove: Get all keys after the moves.");
+
+    // SSTs that overlap the SSTs below are merged instead of being moved
+    for (int i = 1; i <= 2 * db_size; ++i)
+    {
+        lsm_tree->put(i, i * 100);
+    }
+    check(levels[0].empty() && levels[1].size() == 1 && levels[1][0].metadata.num_entries == 2 * db_size, "testLSMTrivialMove: SSTs overlapping the last level are merged.");
+
+    NodeFileOffset *node_file_offset = lsm_tree->get(1, buffer_pool, false);
+    check(node_file_offset != nullptr && node_file_offset->node->value == 100, "testLSMTrivialMove: Get the newer value after the merge.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMBulkLoad()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    lsm_tree->put(5, 1);
+
+    // Bulk load more pairs than fit in a single bulk-loaded SST
+    long num_pairs = BULK_LOAD_SST_PAIRS + 1000;
+    std::vector<std::pair<long, long>> sorted_pairs;
+    for (long i = 1; i <= num_pairs; ++i)
+    {
+        sorted_pairs.emplace_back(i, i * 10);
+    }
+    check(lsm_tree->bulkLoad(sorted_pairs), "testLSMBulkLoad: Bulk load sorted pairs.");
+
+    // The memtable overlapped the pairs, so it was flushed below them
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    size_t num_ssts = 0;
+    long num_entries = 0;
+    for (const std::vector<SST> &level : levels)
+    {
+        num_ssts += level.size();
+        for (const SST &sst : level)
+        {
+            num_entries += sst.metadata.num_entries;
+        }
+    }
+    check(lsm_tree->getMemtable()->getCurrSize() == 0, "testLSMBulkLoad: Overlapping memtable is flushed first.");
+    check(num_entries == num_pairs && num_ssts == 2, "testLSMBulkLoad: Pairs are split into SSTs.");
+
+    bool is_success = true;
+    for (long i = 1; i <= num_pairs; i += 97)
+    {
+        NodeFileOffset *node_file_offset = lsm_tree->get(i, buffer_pool, false);
+        if (node_file_offset == nullptr || node_file_offset->node->value != i * 10)
+        {
+            is_success = false;
+        }
+    }
+    check(is_success, "testLSMBulkLoad: Get bulk-loaded values.");
+
+    NodeFileOffset *node_file_offset = lsm_tree->get(5, buffer_pool, false);
+    check(node_file_offset != nullptr && node_file_offset->node->value == 50, "testLSMBulkLoad: Bulk-loaded value is newer than the memtable value.");
+
+    // Unsorted pairs are rejected without changing the tree
+    std::vector<std::pair<long, long>> unsorted_pairs = {{num_pairs + 2, 1}, {num_pairs + 1, 1}};
+    check(!lsm_tree->bulkLoad(unsorted_pairs), "testLSMBulkLoad: Unsorted pairs are rejected.");
+    size_t num_last_level_ssts = levels[MAX_LSM_LEVEL - 1].size();
+    size_t num_ssts_after = 0;
+    for (const std::vector<SST> &level : levels)
+    {
+        num_ssts_after += level.size();
+    }
+    check(num_ssts_after == num_ssts, "testLSMBulkLoad: Rejected bulk load adds no SST.");
+
+    // Pairs that overlap nothing go straight to the last level
+    std::string bulk_filename = DATA_FILE_PATH + current_database + "/bulk_load.bin";
+    std::ofstream out(bulk_filename, std::ios::binary);
+    for (long i = num_pairs + 1; i <= num_pairs + 500; ++i)
+    {
+        long value = i * 10;
+        out.write(reinterpret_cast<const char *>(&i), sizeof(long));
+        out.write(reinterpret_cast<const char *>(&value), sizeof(long));
+    }
+    out.close();
+    check(lsm_tree->bulkLoadFile(bulk_filename), "testLSMBulkLoad: Bulk load a sorted file.");
+    check(levels[MAX_LSM_LEVEL - 1].size() == num_last_level_ssts + 1 && levels[MAX_LSM_LEVEL - 1].back().metadata.num_entries == 500, "testLSMBulkLoad: Non-overlapping pairs go to the last level.");
+
+    node_file_offset = lsm_tree->get(num_pairs + 250, buffer_pool, false);
+    check(node_file_offset != nullptr && node_file_offset->node->value == (num_pairs + 250) * 10, "testLSMBulkLoad: Get a value loaded from a file.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMCompactionSplit()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+
+    // Two overlapping bulk loads are two runs of the last level, which are merged in a single pass
+    long num_pairs = COMPACTION_SST_PAIRS + COMPACTION_SST_PAIRS / 2;
+    std::vector<std::pair<long, long>> even_pairs;
+    std::vector<std::pair<long, long>> odd_pairs;
+    for (long i = 0; i < num_pairs; ++i)
+    {
+        even_pairs.emplace_back(i * 2, i * 20);
+        odd_pairs.emplace_back(i * 2 + 1, i * 20 + 10);
+    }
+    check(lsm_tree->bulkLoad(even_pairs) && lsm_tree->bulkLoad(odd_pairs), "testLSMCompactionSplit: Bulk load two overlapping runs.");
+
+    // The merged run is split into SSTs of COMPACTION_SST_PAIRS pairs that do not overlap
+    const std::vector<SST> &last_level = lsm_tree->getLevels()[MAX_LSM_LEVEL - 1];
+    bool is_split = last_level.size() == (2 * num_pairs + COMPACTION_SST_PAIRS - 1) / COMPACTION_SST_PAIRS;
+    long num_entries = 0;
+    for (size_t i = 0; i < last_level.size(); ++i)
+    {
+        num_entries += last_level[i].metadata.num_entries;
+        is_split &= last_level[i].run == last_level[0].run && last_level[i].metadata.num_entries <= static_cast<long>(COMPACTION_SST_PAIRS);
+        is_split &= i == 0 || last_level[i - 1].metadata.max_key < last_level[i].metadata.min_key;
+    }
+    check(is_split && num_entries == 2 * num_pairs, "testLSMCompactionSplit: The merged run is split into non-overlapping SSTs.");
+
+    bool is_success = true;
+    for (long key = 0; key < 2 * num_pairs; key += 89)
+    {
+        NodeFileOffset *node_file_offset = lsm_tree->get(key, buffer_pool, true);
+        is_success &= node_file_offset != nullptr && node_file_offset->node->value == key * 10;
+    }
+    check(is_success, "testLSMCompactionSplit: Get the values of every SST of the run.");
+
+    // A scan across the boundary between two SSTs of the run returns every key once
+    long boundary = last_level[0].metadata.max_key;
+    std::pair<std::pair<long, long> *, int> scanned = lsm_tree->scan(boundary - 50, boundary + 50, buffer_pool, true);
+    is_success = scanned.second == 101;
+    for (int i = 0; i < scanned.second; ++i)
+    {
+        is_success &= scanned.first[i].first == boundary - 50 + i && scanned.first[i].second == scanned.first[i].first * 10;
+    }
+    delete[] scanned.first;
+    check(is_success, "testLSMCompactionSplit: Scan across two SSTs of the run.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+// Returns the value got from the LSM tree (-1 if the key was not found).
+static long getValue(LSMTree *lsm_tree, long key, BufferPool *buffer_pool, bool with_btree)
+{
+    NodeFileOffset *node_file_offset = lsm_tree->get(key, buffer_pool, with_btree);
+    return node_file_offset == nullptr ? -1 : node_file_offset->node->value;
+}
+
+void testLSMMmapReadMode()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Write overlapping SSTs so that the reads go through several levels and compactions
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (long i = 1; i <= 2048; ++i)
+    {
+        lsm_tree->put(i, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i, i * 2);
+    }
+
+    for (bool with_btree : {false, true})
+    {
+        std::string mode = with_btree ? "B-Tree" : "Binary Search";
+
+        bool is_success = true;
+        for (long key = 1; key <= 2100; ++key)
+        {
+            lsm_tree->setReadMode(ReadMode::BUFFER_POOL);
+            long buffer_pool_value = getValue(lsm_tree, key, buffer_pool, with_btree);
+            lsm_tree->setReadMode(ReadMode::MMAP);
+            if (getValue(lsm_tree, key, buffer_pool, with_btree) != buffer_pool_value)
+            {
+                is_success = false;
+            }
+        }
+        check(is_success, "testLSMMmapReadMode: " + mode + " gets match the buffer pool mode.");
+
+        lsm_tree->setReadMode(ReadMode::BUFFER_POOL);
+        std::pair<std::pair<long, long> *, int> buffer_pool_scan = lsm_tree->scan(100, 1500, buffer_pool, with_btree);
+        lsm_tree->setReadMode(ReadMode::MMAP);
+        std::pair<std::pair<long, long> *, int> mmap_scan = lsm_tree->scan(100, 1500, buffer_pool, with_btree);
+        check(mmap_scan.second == buffer_pool_scan.second && std::equal(mmap_scan.first, mmap_scan.first + mmap_scan.second, buffer_pool_scan.first),
+              "testLSMMmapReadMode: " + mode + " scan matches the buffer pool mode.");
+        delete[] buffer_pool_scan.first;
+        delete[] mmap_scan.first;
+    }
+
+    // Mappings of compacted SSTs are dropped, and the new SSTs are mapped when they are read
+    for (long i = 2; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i, i * 3);
+    }
+    check(getValue(lsm_tree, 3, buffer_pool, true) == 6 && getValue(lsm_tree, 4, buffer_pool, true) == 12 && getValue(lsm_tree, 2000, buffer_pool, false) == 2000,
+          "testLSMMmapReadMode: Get after compaction in mmap mode.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMFencePointers()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (long i = 1; i <= 2048; ++i)
+    {
+        lsm_tree->put(i, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i, i * 2);
+    }
+
+    // Every SST has one fence key per page, the same as when its fence pointers are rebuilt from its file
+    bool is_success = true;
+    size_t num_pages = 0;
+    for (const std::vector<SST> &level : lsm_tree->getLevels())
+    {
+        for (const SST &sst : level)
+        {
+            size_t sst_pages = (sst.metadata.num_entries + MAX_PAIRS - 1) / MAX_PAIRS;
+            num_pages += sst_pages;
+            SSTMetadata rebuilt;
+            if (sst.metadata.fence_keys.size() != sst_pages || sst.metadata.fence_keys.back() != sst.metadata.max_key ||
+                !readSSTMetadata(sst.sst_filename, rebuilt) || rebuilt.fence_keys != sst.metadata.fence_keys)
+            {
+                is_success = false;
+            }
+        }
+    }
+    check(is_success && num_pages > 0, "testLSMFencePointers: One fence key per page.");
+    check(lsm_tree->getFencePointerMemory() == num_pages * sizeof(long), "testLSMFencePointers: Fence pointers use one long per page.");
+
+    for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
+    {
+        lsm_tree->setReadMode(read_mode);
+        is_success = true;
+        for (long key = 1; key <= 2100; ++key)
+        {
+            long expected = key > 2048 ? -1 : (key <= 1024 && key % 2 == 1 ? key * 2 : key);
+            if (getValue(lsm_tree, key, buffer_pool, true) != expected)
+            {
+                is_success = false;
+            }
+        }
+        check(is_success, std::string("testLSMFencePointers: Get with fence pointers in ") + (read_mode == ReadMode::MMAP ? "mmap" : "buffer pool") + " mode.");
+    }
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMLearnedIndex()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    lsm_tree->setLearnedIndex(true);
+    for (long i = 1; i <= 4096; ++i)
+    {
+        lsm_tree->put(i * 7, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i * 7, i * 2);
+    }
+
+    // Every SST has a learned index over all of its keys, the same as when it is rebuilt from its file
+    bool is_success = true;
+    for (const std::vector<SST> &level : lsm_tree->getLevels())
+    {
+        for (const SST &sst : level)
+        {
+            SSTMetadata rebuilt;
+            if (!readSSTMetadata(sst.sst_filename, rebuilt) || sst.metadata.learned_index.getNumKeys() != sst.metadata.num_entries ||
+                rebuilt.learned_index.getNumSegments() != sst.metadata.learned_index.getNumSegments())
+            {
+                is_success = false;
+            }
+        }
+    }
+    check(is_success && lsm_tree->getLearnedIndexMemory() > 0, "testLSMLearnedIndex: One learned index per SST.");
+
+    for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
+    {
+        lsm_tree->setReadMode(read_mode);
+        is_success = true;
+        for (long key = 1; key <= 4100 * 7; ++key)
+        {
+            long expected = (key % 7 != 0 || key > 4096 * 7) ? -1 : (key / 7 <= 1024 && (key / 7) % 2 == 1 ? key / 7 * 2 : key / 7);
+            if (getValue(lsm_tree, key, buffer_pool, true) != expected)
+            {
+                is_success = false;
+            }
+        }
+        check(is_success, std::string("testLSMLearnedIndex: Get with the learned index in ") + (read_mode == ReadMode::MMAP ? "mmap" : "buffer pool") + " mode.");
+    }
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMPackedPages()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Flushes and compactions both write packed SSTs
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    lsm_tree->setPageEncoding(PageEncoding::PACKED);
+    for (long i = 1; i <= 4096; ++i)
+    {
+        lsm_tree->put(i * 3, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i * 3, i * 2);
+    }
+
+    bool is_success = true;
+    for (const std::vector<SST> &level : lsm_tree->getLevels())
+    {
+        for (const SST &sst : level)
+        {
+            is_success &= sst.metadata.footer.isPacked() && sst.metadata.footer.getNumDataPages() <= (sst.metadata.num_entries + static_cast<long>(MAX_PAIRS) - 1) / static_cast<long>(MAX_PAIRS);
+        }
+    }
+    check(is_success, "testLSMPackedPages: Every SST is packed into no more pages than plain pages.");
+
+    for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
+    {
+        lsm_tree->setReadMode(read_mode);
+        for (bool with_btree : {true, false})
+        {
+            is_success = true;
+            for (long key = 1; key <= 4100 * 3; ++key)
+            {
+                long expected = (key % 3 != 0 || key > 4096 * 3) ? -1 : (key / 3 <= 1024 && (key / 3) % 2 == 1 ? key / 3 * 2 : key / 3);
+                if (getValue(lsm_tree, key, buffer_pool, with_btree) != expected)
+                {
+                    is_success = false;
+                }
+            }
+            check(is_success, std::string("testLSMPackedPages: Get ") + (with_btree ? "with" : "without") + " the B-Tree in " +
+                                  (read_mode == ReadMode::MMAP ? "mmap" : "buffer pool") + " mode.");
+        }
+    }
+
+    std::pair<std::pair<long, long> *, int> scanned_pairs = lsm_tree->scan(300, 6000, buffer_pool, true);
+    check(scanned_pairs.second == 1901, "testLSMPackedPages: Scan returns every key in the range.");
+    delete[] scanned_pairs.first;
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMCompression()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Only the levels below level 0 are compressed, with the strongest built-in codec
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    check(!lsm_tree->setLevelCompression(MAX_LSM_LEVEL, CompressionType::LZ) && lsm_tree->getLevelCompression(0) == CompressionType::NONE,
+          "testLSMCompression: Levels default to no compression and a missing level cannot be set.");
+    for (int level = 1; level < static_cast<int>(MAX_LSM_LEVEL); ++level)
+    {
+        lsm_tree->setLevelCompression(level, CompressionType::LZ_HIGH);
+    }
+    for (long i = 1; i <= 4096; ++i)
+    {
+        lsm_tree->put(i * 3, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i * 3, i * 2);
+    }
+
+    bool is_success = true;
+    bool has_compressed = false;
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    for (size_t level_idx = 0; level_idx < levels.size(); ++level_idx)
+    {
+        for (const SST &sst : levels[level_idx])
+        {
+            // An SST moved down without being rewritten keeps the compression of its old level
+            is_success &= level_idx > 0 || !sst.metadata.footer.isCompressed();
+            has_compressed |= sst.metadata.footer.isCompressed();
+        }
+    }
+    check(is_success && has_compressed, "testLSMCompression: Compactions compress the SSTs they write below level 0.");
+
+    for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
+    {
+        lsm_tree->setReadMode(read_mode);
+        for (bool with_btree : {true, false})
+        {
+            is_success = true;
+            for (long key = 1; key <= 4100 * 3; ++key)
+            {
+                long expected = (key % 3 != 0 || key > 4096 * 3) ? -1 : (key / 3 <= 1024 && (key / 3) % 2 == 1 ? key / 3 * 2 : key / 3);
+                if (getValue(lsm_tree, key, buffer_pool, with_btree) != expected)
+                {
+                    is_success = false;
+                }
+            }
+            check(is_success, std::string("testLSMCompression: Get ") + (with_btree ? "with" : "without") + " the B-Tree in " +
+                                  (read_mode == ReadMode::MMAP ? "mmap" : "buffer pool") + " mode.");
+        }
+    }
+
+    std::pair<std::pair<long, long> *, int> scanned_pairs = lsm_tree->scan(300, 6000, buffer_pool, true);
+    check(scanned_pairs.second == 1901, "testLSMCompression: Scan returns every key in the range.");
+    delete[] scanned_pairs.first;
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMColumnarPages()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Flushes and compactions both write columnar SSTs
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    lsm_tree->setPageEncoding(PageEncoding::COLUMNAR);
+    for (long i = 1; i <= 4096; ++i)
+    {
+        lsm_tree->put(i * 3, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i * 3, i * 2);
+    }
+
+    bool is_success = true;
+    for (const std::vector<SST> &level : lsm_tree->getLevels())
+    {
+        for (const SST &sst : level)
+        {
+            is_success &= sst.metadata.footer.isColumnar();
+        }
+    }
+    check(is_success, "testLSMColumnarPages: Every SST is columnar.");
+
+    for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
+    {
+        lsm_tree->setReadMode(read_mode);
+        for (bool with_btree : {true, false})
+        {
+            is_success = true;
+            for (long key = 1; key <= 4100 * 3; ++key)
+            {
+                long expected = (key % 3 != 0 || key > 4096 * 3) ? -1 : (key / 3 <= 1024 && (key / 3) % 2 == 1 ? key / 3 * 2 : key / 3);
+                if (getValue(lsm_tree, key, buffer_pool, with_btree) != expected)
+                {
+                    is_success = false;
+                }
+            }
+            check(is_success, std::string("testLSMColumnarPages: Get ") + (with_btree ? "with" : "without") + " the B-Tree in " +
+                                  (read_mode == ReadMode::MMAP ? "mmap" : "buffer pool") + " mode.");
+        }
+    }
+
+    std::pair<std::pair<long, long> *, int> scanned_pairs = lsm_tree->scan(300, 6000, buffer_pool, true);
+    check(scanned_pairs.second == 1901, "testLSMColumnarPages: Scan returns every key in the range.");
+    delete[] scanned_pairs.first;
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMPageSize()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+
+    // Flushes keep PAGE_SIZE pages, while compactions write 16 KB pages into the levels below level 0
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    check(!lsm_tree->setPageSize(24 * 1024) && !lsm_tree->setPageSize(2 * MAX_PAGE_SIZE) && lsm_tree->setPageSize(16 * 1024, 1),
+          "testLSMPageSize: Only powers of two from PAGE_SIZE to MAX_PAGE_SIZE are page sizes.");
+    for (long i = 1; i <= 4096; ++i)
+    {
+        lsm_tree->put(i * 3, i);
+    }
+    for (long i = 1; i <= 1024; i += 2)
+    {
+        lsm_tree->put(i * 3, i * 2);
+    }
+
+    bool is_success = true;
+    bool has_large_pages = false;
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+    for (size_t level_idx = 0; level_idx < levels.size(); ++level_idx)
+    {
+        for (const SST &sst : levels[level_idx])
+        {
+            // An SST moved down without being rewritten keeps the pages of its old level
+            is_success &= level_idx > 0 || sst.metadata.footer.page_size == static_cast<long>(PAGE_SIZE);
+            has_large_pages |= sst.metadata.footer.page_size == 16 * 1024;
+        }
+    }
+    check(is_success && has_large_pages, "testLSMPageSize: Compactions write 16 KB pages below level 0.");
+
+    for (ReadMode read_mode : {ReadMode::BUFFER_POOL, ReadMode::MMAP})
+    {
+        lsm_tree->setReadMode(read_mode);
+        for (bool with_btree : {true, false})
+        {
+            is_success = true;
+            for (long key = 1; key <= 4100 * 3; ++key)
+            {
+                long expected = (key % 3 != 0 || key > 4096 * 3) ? -1 : (key / 3 <= 1024 && (key / 3) % 2 == 1 ? key / 3 * 2 : key / 3);
+                if (getValue(lsm_tree, key, buffer_pool, with_btree) != expected)
+                {
+                    is_success = false;
+                }
+            }
+            check(is_success, std::string("testLSMPageSize: Get ") + (with_btree ? "with" : "without") + " the B-Tree in " +
+                                  (read_mode == ReadMode::MMAP ? "mmap" : "buffer pool") + " mode.");
+        }
+    }
+
+    for (bool with_btree : {true, false})
+    {
+        std::pair<std::pair<long, long> *, int> scanned_pairs = lsm_tree->scan(300, 6000, buffer_pool, with_btree);
+        check(scanned_pairs.second == 1901, std::string("testLSMPageSize: Scan ") + (with_btree ? "with" : "without") + " the B-Tree returns every key in the range.");
+        delete[] scanned_pairs.first;
+    }
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMCorruptedCompaction()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    const std::vector<std::vector<SST>> &levels = lsm_tree->getLevels();
+
+    // Flush an SST to level 0, then flip a byte of its first data page
+    for (long i = 1; i <= db_size; ++i)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+    check(levels[0].size() == 1, "testLSMCorruptedCompaction: The first flush is on level 0.");
+    if (levels[0].size() == 1)
+    {
+        int fd = open(levels[0][0].sst_filename.c_str(), O_RDWR);
+        off_t offset = levels[0][0].metadata.footer.data_offset + sizeof(long);
+        char byte;
+        pread(fd, &byte, 1, offset);
+        byte = ~byte;
+        pwrite(fd, &byte, 1, offset);
+        close(fd);
+    }
+
+    // An overlapping flush fills level 0, and its compaction fails on the corrupted page
+    for (long i = 1; i <= db_size; ++i)
+    {
+        lsm_tree->put(i, i * 20);
+    }
+    check(levels[0].size() == 2, "testLSMCorruptedCompaction: The inputs of a failed compaction are kept on level 0.");
+
+    // The next flush is still added to the full level 0 (and then moved down, as it overlaps nothing), so none of its keys are lost
+    for (long i = 1001; i <= 1000 + db_size; ++i)
+    {
+        lsm_tree->put(i, i * 10);
+    }
+    size_t num_ssts = 0;
+    for (const std::vector<SST> &level : levels)
+    {
+        num_ssts += level.size();
+    }
+    check(levels[0].size() == 2 && num_ssts == 3 && lsm_tree->getMemtable()->getCurrSize() == 0, "testLSMCorruptedCompaction: A flush onto a full level 0 keeps its SST.");
+
+    bool is_success = true;
+    for (long i = 1001; i <= 1000 + db_size; ++i)
+    {
+        NodeFileOffset *node_file_offset = lsm_tree->get(i, buffer_pool, false);
+        is_success &= node_file_offset != nullptr && node_file_offset->node->value == i * 10;
+        delete node_file_offset;
+    }
+    check(is_success, "testLSMCorruptedCompaction: Get finds every key flushed after the failed compaction.");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
@@ -0,0 +1,287 @@
+#include "test_lsm_versions.h"
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns the SST filenames of the given levels.
+static std::set<std::string> getSSTFilenames(const std::vector<std::vector<SST>> &levels)
+{
+    std::set<std::string> filenames;
+    for (const std::vector<SST> &level : levels)
+    {
+        for (const SST &sst : level)
+        {
+            filenames.insert(sst.sst_filename);
+        }
+    }
+    return filenames;
+}
+
+// Returns the number of entries of the SSTs whose writes are all as old as the snapshot, or -1 if an SST holds writes on both sides of it.
+static long getSnapshotEntries(const std::vector<std::vector<SST>> &levels, uint64_t snapshot)
+{
+    long num_entries = 0;
+    for (const std::vector<SST> &level : levels)
+    {
+        for (const SST &sst : level)
+        {
+            if (sst.min_sequence <= snapshot && sst.max_sequence > snapshot)
+            {
+                return -1;
+            }
+            num_entries += sst.max_sequence <= snapshot ? sst.metadata.num_entries : 0;
+        }
+    }
+    return num_entries;
+}
+
+// Returns the SST files in the folder of the database.
+static std::set<std::string> getSSTFilesOnDisk(const std::string &database)
+{
+    std::set<std::string> filenames;
+    for (const auto &entry : std::filesystem::directory_iterator(DATA_FILE_PATH + database))
+    {
+        std::string filename = entry.path().filename().string();
+        if (filename.rfind("sst_", 0) == 0 && entry.path().extension() == ".bin")
+        {
+            filenames.insert(DATA_FILE_PATH + database + "/" + filename);
+        }
+    }
+    return filenames;
+}
+
+void testLSMVersions()
+{
+    int db_size = 512;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+    dbClear(current_database);
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (long key = 0; key < 5000; ++key)
+    {
+        lsm_tree->put(key, key * 10);
+    }
+
+    // A get from the memtable returns a copy of its Node
+    NodeFileOffset *result = lsm_tree->get(4999, buffer_pool, true);
+    check(result != nullptr && result->node->value == 49990 && result->node != lsm_tree->getMemtable()->get(4999),
+          "testLSMVersions: A key found in the memtable is returned as a copy");
+    delete result;
+
+    // A held version keeps its SSTs on disk while compactions replace them
+    std::shared_ptr<const LSMVersion> version = lsm_tree->getVersion();
+    std::set<std::string> version_files = getSSTFilenames(version->levels);
+    check(version_files == getSSTFilenames(lsm_tree->getLevels()) && version->memtable == lsm_tree->getMemtable(),
+          "testLSMVersions: The current version holds the memtable and the levels of the tree");
+    for (long key = 0; key < 5000; ++key)
+    {
+        lsm_tree->put(key, key * 10 + 1);
+    }
+    std::set<std::string> current_files = getSSTFilenames(lsm_tree->getLevels());
+    std::set<std::string> files_on_disk = getSSTFilesOnDisk(current_database);
+    bool is_compacted_away = false;
+    bool is_kept = true;
+    for (const std::string &filename : version_files)
+    {
+        is_compacted_away = is_compacted_away || current_files.count(filename) == 0;
+        is_kept &= files_on_disk.count(filename) == 1;
+    }
+    check(is_compacted_away && is_kept && lsm_tree->getVersion() != version, "testLSMVersions: The SSTs of a held version stay on disk after compactions");
+
+    // Releasing the version removes the SSTs that no other version holds
+    version.reset();
+    check(getSSTFilesOnDisk(current_database) == current_files, "testLSMVersions: The SSTs compacted away are removed once no version holds them");
+
+    bool is_success = true;
+    for (long key = 0; key < 5000; ++key)
+    {
+        result = lsm_tree->get(key, buffer_pool, true);
+        is_success &= result != nullptr && result->node->value == key * 10 + 1;
+        delete result;
+    }
+    check(is_success, "testLSMVersions: Gets read the newest version");
+
+    // A version held after the tree is destroyed still removes the SSTs compacted away once it is released
+    version = lsm_tree->getVersion();
+    version_files = getSSTFilenames(version->levels);
+    for (long key = 0; key < 5000; ++key)
+    {
+        lsm_tree->put(key, key * 10 + 2);
+    }
+    current_files = getSSTFilenames(lsm_tree->getLevels());
+    delete lsm_tree;
+    check(getSSTFilesOnDisk(current_database).size() > current_files.size(), "testLSMVersions: A version held after the tree is destroyed keeps its SSTs");
+    version.reset();
+    check(getSSTFilesOnDisk(current_database) == current_files, "testLSMVersions: A version released after the tree is destroyed removes its obsolete SSTs");
+
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testLSMConcurrentReads()
+{
+    int db_size = 512;
+    long num_keys = 20000;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (long key = 0; key < num_keys; ++key)
+    {
+        lsm_tree->put(key, key * 10);
+    }
+
+    // Readers run gets and scans while a writer overwrites every key in rounds, which flushes and compacts the tree,
+    // and the read settings keep changing (switching back to the buffer pool drops the mappings that readers may use)
+    std::atomic<bool> is_writing(true);
+    std::future<void> tuner = std::async(std::launch::async, [lsm_tree, &is_writing]()
+                                         {
+        for (int i = 0; is_writing; ++i)
+        {
+            lsm_tree->setReadMode(i % 2 == 0 ? ReadMode::MMAP : ReadMode::BUFFER_POOL);
+            lsm_tree->setFencePointers(i % 3 != 0);
+            lsm_tree->setSSTSearchMode(i % 5 == 0 ? SSTSearchMode::INTERPOLATION : SSTSearchMode::BINARY);
+            lsm_tree->getFencePointerMemory();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } });
+    std::vector<std::future<bool>> readers;
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        readers.push_back(std::async(std::launch::async, [lsm_tree, num_keys, thread, &is_writing]()
+                                     {
+            BufferPool buffer_pool(BUFFER_POOL_SIZE);
+            std::mt19937_64 gen(450 + thread);
+            std::uniform_int_distribution<long> key_index(0, num_keys - 100);
+            std::map<long, long> last_values;
+            bool is_correct = true;
+            for (long i = 0; i < 3000 || is_writing; ++i)
+            {
+                long key = key_index(gen);
+                if (i % 50 == 0)
+                {
+                    std::pair<std::pair<long, long> *, int> scanned = lsm_tree->scan(key, key + 99, &buffer_pool, true);
+                    is_correct &= scanned.second == 100;
+                    for (int j = 0; j < scanned.second; ++j)
+                    {
+                        is_correct &= scanned.first[j].first == key + j && scanned.first[j].second / 10 == key + j;
+                    }
+                    delete[] scanned.first;
+                    continue;
+                }
+
+                // Every key is found, and a thread never sees a value older than one it saw before
+                NodeFileOffset *result = lsm_tree->get(key, &buffer_pool, i % 2 == 0);
+                is_correct &= result != nullptr && result->node->value / 10 == key && result->node->value >= last_values[key];
+                if (result != nullptr)
+                {
+                    last_values[key] = result->node->value;
+                }
+                delete result;
+            }
+            return is_correct; }));
+    }
+    for (long round = 1; round <= 3; ++round)
+    {
+        for (long key = 0; key < num_keys; ++key)
+        {
+            lsm_tree->put(key, key * 10 + round);
+        }
+    }
+    is_writing = false;
+    tuner.get();
+    bool is_success = true;
+    for (std::future<bool> &reader : readers)
+    {
+        is_success &= reader.get();
+    }
+    check(is_success, "testLSMConcurrentReads: Gets and scans from several threads see every key while a writer flushes and compacts and the read settings change");
+    check(getSSTFilesOnDisk(current_database) == getSSTFilenames(lsm_tree->getLevels()),
+          "testLSMConcurrentReads: Every SST compacted away is removed once the readers are done");
+
+    delete lsm_tree;
+    dbClear(current_database);
+}
+
+void testLSMSnapshots()
+{
+    int db_size = 512;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+    dbClear(current_database);
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    for (long key = 0; key < 5000; ++key)
+    {
+        lsm_tree->put(key, key * 10);
+    }
+    check(lsm_tree->getLastSequence() == 5000, "testLSMSnapshots: Every put is given the next sequence number");
+
+    // Every key of the snapshot is overwritten, a range is deleted, and the tree flushes and compacts meanwhile
+    uint64_t snapshot = lsm_tree->getSnapshot();
+    check(lsm_tree->getSnapshot() == snapshot, "testLSMSnapshots: Snapshots taken with no write in between share a sequence number");
+    lsm_tree->releaseSnapshot(snapshot);
+    std::shared_ptr<const LSMVersion> version = lsm_tree->getVersion();
+    check(lsm_tree->getMemtable()->getCurrSize() == 0 && version->frozen_memtables.size() == 1 && version->frozen_memtables[0].max_sequence == snapshot &&
+              version->frozen_memtables[0].memtable->getCurrSize() == 5000 % db_size,
+          "testLSMSnapshots: A snapshot freezes the memtable instead of copying it");
+    version.reset();
+    for (long key = 0; key < 5000; ++key)
+    {
+        lsm_tree->put(key, key * 10 + 1);
+    }
+    lsm_tree->deleteRange(1000, 1999);
+    lsm_tree->put(5000, 50000);
+
+    bool is_success = true;
+    for (long key = 0; key <= 5000; ++key)
+    {
+        NodeFileOffset *old_result = lsm_tree->get(key, buffer_pool, key % 2 == 0, snapshot);
+        NodeFileOffset *new_result = lsm_tree->get(key, buffer_pool, true);
+        is_success &= key < 5000 ? old_result != nullptr && old_result->node->value == key * 10 : old_result == nullptr;
+        is_success &= new_result != nullptr && new_result->node->value == (key >= 1000 && key <= 1999 ? LONG_MIN : (key < 5000 ? key * 10 + 1 : 50000));
+        delete old_result;
+        delete new_result;
+    }
+    check(is_success, "testLSMSnapshots: A get at a snapshot sees the values as of the snapshot");
+
+    std::pair<std::pair<long, long> *, int> scanned = lsm_tree->scan(990, 1009, buffer_pool, true, snapshot);
+    is_success = scanned.second == 20;
+    for (int i = 0; i < scanned.second; ++i)
+    {
+        is_success &= scanned.first[i].first == 990 + i && scanned.first[i].second == (990 + i) * 10;
+    }
+    delete[] scanned.first;
+    check(is_success, "testLSMSnapshots: A scan at a snapshot sees the values as of the snapshot");
+
+    // Compactions merge the SSTs the snapshot sees among themselves, so it holds on to no SST that was compacted away
+    check(getSnapshotEntries(lsm_tree->getLevels(), snapshot) == 5000, "testLSMSnapshots: Compactions keep the version of every key the snapshot sees, once");
+    check(getSSTFilesOnDisk(current_database) == getSSTFilenames(lsm_tree->getLevels()), "testLSMSnapshots: A live snapshot keeps no SST that was compacted away");
+
+    // Once the snapshot is released, the compactions merge away the versions only it saw
+    lsm_tree->releaseSnapshot(snapshot);
+    NodeFileOffset *released = lsm_tree->get(0, buffer_pool, true, snapshot);
+    check(released == nullptr, "testLSMSnapshots: A get at a released snapshot finds nothing");
+    for (long key = 0; key < 5000; ++key)
+    {
+        lsm_tree->put(key, key * 10 + 2);
+    }
+    is_success = getSnapshotEntries(lsm_tree->getLevels(), snapshot) == -1;
+    for (long key = 0; key < 5000; key += 7)
+    {
+        NodeFileOffset *result = lsm_tree->get(key, buffer_pool, true);
+        is_success &= result != nullptr && result->node->value == key * 10 + 2;
+        delete result;
+    }
+    check(is_success, "testLSMSnapshots: Once the snapshot is released, compactions merge the writes on both sides of it");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
@@ -1,6 +1,7 @@
 #include "memtable.h"
 #include "test_memtable.h"
 #include <iostream>
+#include <climits>
 
 // Declare the check function from tests_main.cpp
 extern void check(bool condition, const std::string &test_name);
@@ -40,3 +41,67 @@ void testMemtableGetNodes()
     node = memtable.get(3);
     check(node == nullptr, "Memtable Get Test: Get Non-existent Key 3");
 }
+
+void testMemtableDeleteRange()
+{
+    Memtable memtable(100);
+    for (int i = 1; i <= 50; ++i)
+    {
+        memtable.put(i, i * 10);
+    }
+    memtable.deleteRange(10, 19);
+    memtable.deleteRange(20, 29);
+    memtable.put(15, 1);
+
+    // The Nodes in the range are removed, but a later put is kept
+    check(memtable.getCurrSize() == 31, "Memtable DeleteRange Test: Nodes in the range are removed");
+    check(memtable.get(12) == nullptr && memtable.get(25) == nullptr, "Memtable DeleteRange Test: Deleted keys are not found");
+    check(memtable.get(15) != nullptr && memtable.get(15)->value == 1, "Memtable DeleteRange Test: Put after DeleteRange is kept");
+    check(memtable.get(9) != nullptr && memtable.get(30) != nullptr, "Memtable DeleteRange Test: Keys outside the range are kept");
+
+    // Touching ranges are coalesced into a single range tombstone
+    const RangeTombstones &range_tombstones = memtable.getRangeTombstones();
+    check(range_tombstones.size() == 1, "Memtable DeleteRange Test: Touching ranges are coalesced");
+    check(range_tombstones.covers(10) && range_tombstones.covers(29) && !range_tombstones.covers(9) && !range_tombstones.covers(30), "Memtable DeleteRange Test: Range tombstone covers [10, 29]");
+
+    // Ranges reaching the smallest and largest keys are coalesced without overflowing
+    memtable.deleteRange(LONG_MIN, 5);
+    memtable.deleteRange(LONG_MIN, LONG_MIN);
+    memtable.deleteRange(6, 8);
+    memtable.deleteRange(100, LONG_MAX);
+    memtable.deleteRange(LONG_MAX, LONG_MAX);
+    memtable.deleteRange(60, 99);
+    const std::vector<std::pair<long, long>> &ranges = range_tombstones.getRanges();
+    check(ranges.size() == 3 && ranges[0] == std::make_pair(LONG_MIN, 8L) && ranges[1] == std::make_pair(10L, 29L) && ranges[2] == std::make_pair(60L, LONG_MAX),
+          "Memtable DeleteRange Test: Ranges from LONG_MIN and to LONG_MAX are coalesced");
+    check(range_tombstones.covers(LONG_MIN) && range_tombstones.covers(LONG_MAX) && !range_tombstones.covers(9) && !range_tombstones.covers(59),
+          "Memtable DeleteRange Test: Range tombstones cover LONG_MIN and LONG_MAX");
+}
+
+void testBasicMemtableTypes()
+{
+    BasicMemtable<int32_t, int32_t> memtable(100);
+    for (int32_t i = 50; i > 0; --i)
+    {
+        memtable.put(i * 2, -i);
+    }
+    memtable.put(10, 7);
+
+    // The Memtable of 4-byte keys and values works like the one of longs
+    BasicNode<int32_t, int32_t> *node = memtable.get(10);
+    check(memtable.getCurrSize() == 50 && node != nullptr && node->value == 7, "BasicMemtable Types Test: Put and Get 4-byte keys and values");
+    check(memtable.get(11) == nullptr, "BasicMemtable Types Test: Get Non-existent 4-byte Key");
+
+    std::pair<std::pair<int32_t, int32_t> *, int> pairs = memtable.scan(20, 29);
+    bool is_sorted = pairs.second == 5;
+    for (int i = 0; is_sorted && i < pairs.second; ++i)
+    {
+        is_sorted = pairs.first[i].first == 20 + 2 * i && pairs.first[i].second == -(10 + i);
+    }
+    delete[] pairs.first;
+    check(is_sorted, "BasicMemtable Types Test: Scan 4-byte keys in key order");
+
+    BasicMemtable<long, int32_t> long_key_memtable(10);
+    long_key_memtable.put(5000000000L, 1);
+    check(long_key_memtable.get(5000000000L) != nullptr && long_key_memtable.get(705032704L) == nullptr, "BasicMemtable Types Test: Keys are not narrowed to the value type");
+}
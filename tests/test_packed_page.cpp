@@ -0,0 +1,163 @@
+#include "test_packed_page.h"
+#include "checksum.h"
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns strictly increasing keys whose gaps are drawn from [1, max_gap].
+static std::vector<long> makeKeys(long num_keys, long max_gap, unsigned int seed)
+{
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<long> gap(1, max_gap);
+    std::vector<long> keys;
+    long key = 0;
+    for (long i = 0; i < num_keys; ++i)
+    {
+        key += gap(gen);
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+void testPackedPageKernels()
+{
+    DecodeKernel was_kernel = getPackedDecodeKernel();
+    alignas(PAGE_SIZE) char page[PAGE_SIZE];
+    long keys[PACKED_PAGE_MAX_PAIRS];
+
+    // Every bit width round trips, from evenly spaced keys (no bits) to gaps of up to 2^40
+    bool is_success = true;
+    bool is_equal = true;
+    for (long max_gap : {1L, 2L, 3L, 100L, 5000L, 1L << 20, 1L << 40})
+    {
+        std::vector<long> expected = makeKeys(PACKED_PAGE_MAX_PAIRS, max_gap, static_cast<unsigned int>(max_gap));
+        PackedPageBuilder builder;
+        long num_pairs = 0;
+        while (num_pairs < static_cast<long>(expected.size()) && builder.add(expected[num_pairs], -expected[num_pairs]))
+        {
+            num_pairs++;
+        }
+        builder.write(page);
+        is_success &= num_pairs > 0 && getPackedPageNumPairs(page) == num_pairs && getPackedPageFirstKey(page) == expected[0] &&
+                      getPackedPageLastKey(page) == expected[num_pairs - 1];
+
+        for (DecodeKernel kernel : {DecodeKernel::SCALAR, DecodeKernel::AVX2})
+        {
+            if (!setPackedDecodeKernel(kernel))
+            {
+                continue;
+            }
+            std::fill(keys, keys + PACKED_PAGE_MAX_PAIRS, INTERNAL);
+            is_equal &= decodePackedKeys(page, keys) == num_pairs && std::equal(keys, keys + num_pairs, expected.begin());
+        }
+        is_success &= getPackedPageValues(page)[num_pairs - 1] == -expected[num_pairs - 1] && findPackedKey(page, expected[num_pairs / 2]) == num_pairs / 2 &&
+                      findPackedKey(page, expected[num_pairs - 1] + 1) == -1;
+    }
+    check(is_success, "testPackedPageKernels: Pages hold as many pairs as fit and keep their first and last keys");
+    check(is_equal, "testPackedPageKernels: Every kernel decodes every bit width");
+
+    // Evenly spaced keys need no bits, so the page is full of values
+    PackedPageBuilder builder;
+    for (long i = 0; i < PACKED_PAGE_MAX_PAIRS; ++i)
+    {
+        builder.add(i * 4, i);
+    }
+    check(!builder.add(PACKED_PAGE_MAX_PAIRS * 4, 0) && builder.size() == PACKED_PAGE_MAX_PAIRS, "testPackedPageKernels: Evenly spaced keys fill the page");
+
+    setPackedDecodeKernel(was_kernel);
+}
+
+void testPackedSST()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_packed.bin";
+    std::string plain_filename = filepath + "/sst_plain.bin";
+    std::vector<long> keys = makeKeys(20 * MAX_PAIRS + 17, 40, 443);
+
+    SSTWriter plain_writer(plain_filename);
+    SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, PageEncoding::PACKED);
+    for (long key : keys)
+    {
+        plain_writer.put(key, key * 10);
+        writer.put(key, key * 10);
+    }
+    check(plain_writer.finish() && writer.finish(), "testPackedSST: Write a plain and a packed SST");
+    SSTMetadata metadata = writer.getMetadata();
+
+    SSTFooter footer, plain_footer;
+    readSSTFooter(sst_filename, footer);
+    readSSTFooter(plain_filename, plain_footer);
+    check(footer.isPacked() && !plain_footer.isPacked() && footer.num_entries == static_cast<long>(keys.size()) &&
+              footer.getNumDataPages() * 3 <= plain_footer.getNumDataPages() * 2,
+          "testPackedSST: Packed SST has at most two thirds of the data pages");
+    SSTMetadata read_metadata;
+    check(static_cast<long>(metadata.fence_keys.size()) == footer.getNumDataPages() && readSSTMetadata(sst_filename, read_metadata) &&
+              read_metadata.fence_keys == metadata.fence_keys,
+          "testPackedSST: One fence key per packed page, the same when read back");
+
+    std::vector<long> read_keys;
+    SSTIterator iterator(sst_filename);
+    bool is_success = true;
+    for (; iterator.valid(); iterator.next())
+    {
+        read_keys.push_back(iterator.key());
+        is_success &= iterator.value() == iterator.key() * 10;
+    }
+    check(is_success && read_keys == keys && !iterator.hasError(), "testPackedSST: Iterator returns every pair");
+
+    // Every get path reads the packed pages, through the B-Tree from disk and from a mapping, and without it
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    MappedFile sst_map(sst_filename);
+    StaticBTree btree(sst_filename, sst_filename);
+    StaticBTree mapped_btree(sst_filename, sst_filename, &sst_map, &sst_map);
+    btree.setIndexBlock(footer);
+    mapped_btree.setIndexBlock(footer);
+    is_success = true;
+    bool is_missing = true;
+    for (size_t i = 0; i < keys.size(); i += 7)
+    {
+        long key = keys[i];
+        NodeFileOffset *results[] = {binarySearch(sst_filename, key, buffer_pool, nullptr, &footer), fencePointerSearch(sst_filename, metadata, key, buffer_pool),
+                                     interpolationSearch(sst_filename, metadata, key, nullptr, &sst_map), learnedIndexSearch(sst_filename, metadata, key, buffer_pool)};
+        for (NodeFileOffset *found : results)
+        {
+            is_success &= found != nullptr && found->node->value == key * 10;
+            delete found;
+        }
+        is_success &= btree.get(key, buffer_pool) == key * 10 && mapped_btree.get(key) == key * 10;
+
+        // A key between two keys of the SST is in none of its pages
+        if (i + 1 < keys.size() && keys[i + 1] > key + 1)
+        {
+            NodeFileOffset *found = fencePointerSearch(sst_filename, metadata, key + 1, buffer_pool);
+            is_missing &= found == nullptr && btree.get(key + 1, buffer_pool) == -1;
+            delete found;
+        }
+    }
+    check(is_success, "testPackedSST: Get keys through the B-Tree, binary, fence pointer, interpolation and learned index searches");
+    check(is_missing, "testPackedSST: Keys between the keys of the SST are not found");
+
+    long key1 = keys[MAX_PAIRS], key2 = keys[10 * MAX_PAIRS];
+    std::vector<std::pair<long, long>> expected;
+    for (long key : keys)
+    {
+        if (key >= key1 && key <= key2)
+        {
+            expected.emplace_back(key, key * 10);
+        }
+    }
+    check(btree.scan(key1, key2, buffer_pool) == expected && mapped_btree.scan(key1, key2) == expected &&
+              binarySearchScan(sst_filename, key1, key2, buffer_pool, nullptr, &footer) == expected,
+          "testPackedSST: Scans return every pair in the range");
+    delete buffer_pool;
+
+    for (const std::string &filename : {sst_filename, plain_filename})
+    {
+        std::filesystem::remove(filename);
+        removeChecksumFile(filename);
+    }
+}
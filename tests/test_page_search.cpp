@@ -0,0 +1,126 @@
+#include "test_page_search.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns the number of valid keys smaller than key, the result every kernel must give.
+template <typename Key>
+static long countSmallerReference(const std::vector<Key> &page, long num_keys, long stride, Key key)
+{
+    long count = 0;
+    for (long i = 0; i < num_keys; ++i)
+    {
+        if (page[i * stride] >= 0 && page[i * stride] < key)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void testPageLowerBoundKernels()
+{
+    SearchKernel detected_kernel = getPageSearchKernel();
+    std::mt19937_64 gen(443);
+
+    for (SearchKernel kernel : {SearchKernel::SCALAR, SearchKernel::AVX2, SearchKernel::AVX512})
+    {
+        if (!setPageSearchKernel(kernel))
+        {
+            std::cout << getPageSearchKernelName(kernel) << " is not supported by this CPU, skipping it." << std::endl;
+            continue;
+        }
+
+        bool is_success = true;
+        for (long num_valid : {0L, 1L, 15L, 16L, 17L, 100L, 255L, 256L})
+        {
+            // An SST page of interleaved pairs padded like the last page of an SST, and the same keys as a plain array
+            std::vector<long> page(PAGE_SIZE / sizeof(long), INTERNAL);
+            std::vector<long> keys(MAX_PAIRS, INTERNAL);
+            long key = 0;
+            for (long i = 0; i < num_valid; ++i)
+            {
+                key += 1 + gen() % 5;
+                page[i * 2] = key;
+                page[i * 2 + 1] = -key;
+                keys[i] = key;
+            }
+            if (num_valid < static_cast<long>(MAX_PAIRS))
+            {
+                page[PAGE_SIZE / sizeof(long) - 2] = LEAF;
+            }
+
+            for (long query = -2; query <= key + 2; ++query)
+            {
+                if (pageLowerBound(page.data(), MAX_PAIRS, 2, query) != countSmallerReference(page, MAX_PAIRS, 2, query) ||
+                    pageLowerBound(keys.data(), MAX_PAIRS, 1, query) != countSmallerReference(keys, MAX_PAIRS, 1, query))
+                {
+                    is_success = false;
+                }
+            }
+        }
+        check(is_success, std::string("testPageLowerBoundKernels: ") + getPageSearchKernelName(kernel) + " kernel matches the reference.");
+
+        // Pages of 4-byte keys hold twice as many keys
+        const long max_pairs_int32 = PageLayout<int32_t, int32_t>::MAX_PAIRS;
+        is_success = true;
+        for (long num_valid : {0L, 1L, 7L, 8L, 9L, 33L, 511L, 512L})
+        {
+            std::vector<int32_t> page(PAGE_SIZE / sizeof(int32_t), INTERNAL);
+            std::vector<int32_t> keys(max_pairs_int32, INTERNAL);
+            int32_t key = 0;
+            for (long i = 0; i < num_valid; ++i)
+            {
+                key += 1 + gen() % 5;
+                page[i * 2] = key;
+                page[i * 2 + 1] = -key;
+                keys[i] = key;
+            }
+
+            for (int32_t query = -2; query <= key + 2; ++query)
+            {
+                if (pageLowerBound(page.data(), max_pairs_int32, 2, query) != countSmallerReference(page, max_pairs_int32, 2, query) ||
+                    pageLowerBound(keys.data(), max_pairs_int32, 1, query) != countSmallerReference(keys, max_pairs_int32, 1, query))
+                {
+                    is_success = false;
+                }
+            }
+        }
+        check(is_success, std::string("testPageLowerBoundKernels: ") + getPageSearchKernelName(kernel) + " kernel matches the reference for 4-byte keys.");
+
+        // Columnar pages of signed keys, whose last page repeats its last key instead of padding
+        is_success = true;
+        for (long num_keys : {1L, 9L, 17L, 300L, 512L})
+        {
+            std::vector<long> keys(MAX_PAIRS);
+            std::vector<int32_t> keys_int32(max_pairs_int32);
+            long key = -static_cast<long>(num_keys);
+            for (long i = 0; i < max_pairs_int32; ++i)
+            {
+                key += i < num_keys ? 1 + gen() % 3 : 0;
+                keys_int32[i] = static_cast<int32_t>(key);
+                if (i < static_cast<long>(MAX_PAIRS))
+                {
+                    keys[i] = key;
+                }
+            }
+
+            for (long query = -2 * num_keys; query <= key + 2; ++query)
+            {
+                long count = std::lower_bound(keys.begin(), keys.end(), query) - keys.begin();
+                long count_int32 = std::lower_bound(keys_int32.begin(), keys_int32.end(), static_cast<int32_t>(query)) - keys_int32.begin();
+                if (signedPageLowerBound(keys.data(), MAX_PAIRS, 1, query) != count ||
+                    signedPageLowerBound(keys_int32.data(), max_pairs_int32, 1, static_cast<int32_t>(query)) != count_int32)
+                {
+                    is_success = false;
+                }
+            }
+        }
+        check(is_success, std::string("testPageLowerBoundKernels: ") + getPageSearchKernelName(kernel) + " kernel matches the reference for signed keys.");
+    }
+
+    setPageSearchKernel(detected_kernel);
+}
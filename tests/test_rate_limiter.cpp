@@ -0,0 +1,133 @@
+#include "test_rate_limiter.h"
+#include <iostream>
+#include <thread>
+
+extern void check(bool condition, const std::string &test_name);
+
+void testRateLimiterThrottle()
+{
+    // 1 MB/s budget, so the bucket holds 100 KB and 400 KB of compaction writes must wait for ~300 KB of refills
+    RateLimiter rate_limiter(MEGABYTE);
+
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; i++)
+    {
+        rate_limiter.request(PAGE_SIZE, IOPriority::LOW);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+    check(elapsed.count() >= 0.25, "testRateLimiterThrottle: 400 KB at 1 MB/s took " + std::to_string(elapsed.count()) + " seconds.");
+    check(rate_limiter.getTotalBytes(IOPriority::LOW) == 100 * PAGE_SIZE, "testRateLimiterThrottle: All compaction bytes are accounted for.");
+    check(rate_limiter.getTotalBytes(IOPriority::HIGH) == 0, "testRateLimiterThrottle: No flush bytes are accounted for.");
+
+    double compaction_rate = rate_limiter.getCompactionBytesPerSecond();
+    check(compaction_rate > 0 && compaction_rate <= 1.5 * MEGABYTE, "testRateLimiterThrottle: Compaction rate of " + std::to_string(compaction_rate) + " bytes/sec is within the budget.");
+
+    // Without compaction writes the rate decays instead of reporting the last busy window
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    double idle_rate = rate_limiter.getCompactionBytesPerSecond();
+    check(idle_rate < compaction_rate / 2, "testRateLimiterThrottle: Idle compaction rate of " + std::to_string(idle_rate) + " bytes/sec decays.");
+}
+
+void testRateLimiterAutoTune()
+{
+    RateLimiter rate_limiter(16 * MEGABYTE);
+    rate_limiter.enableAutoTune(0.001, MEGABYTE, 32 * MEGABYTE);
+
+    // Foreground latency above the target shrinks the budget
+    for (int i = 0; i < RATE_LIMITER_TUNE_INTERVAL; i++)
+    {
+        rate_limiter.recordForegroundLatency(0.01);
+    }
+    size_t reduced_budget = rate_limiter.getBytesPerSecond();
+    check(reduced_budget < 16 * MEGABYTE, "testRateLimiterAutoTune: Slow gets reduce the budget.");
+
+    // The budget never drops below the minimum
+    for (int i = 0; i < 100 * RATE_LIMITER_TUNE_INTERVAL; i++)
+    {
+        rate_limiter.recordForegroundLatency(0.01);
+    }
+    check(rate_limiter.getBytesPerSecond() == MEGABYTE, "testRateLimiterAutoTune: Budget is bounded by the minimum.");
+
+    // Foreground latency well below the target grows the budget again
+    for (int i = 0; i < 2 * RATE_LIMITER_TUNE_INTERVAL; i++)
+    {
+        rate_limiter.recordForegroundLatency(0.000001);
+    }
+    check(rate_limiter.getBytesPerSecond() > MEGABYTE, "testRateLimiterAutoTune: Fast gets increase the budget.");
+
+    // Without auto-tuning the budget is left alone
+    rate_limiter.disableAutoTune();
+    size_t budget = rate_limiter.getBytesPerSecond();
+    for (int i = 0; i < RATE_LIMITER_TUNE_INTERVAL; i++)
+    {
+        rate_limiter.recordForegroundLatency(0.01);
+    }
+    check(rate_limiter.getBytesPerSecond() == budget, "testRateLimiterAutoTune: Disabled auto-tuning keeps the budget.");
+}
+
+void testRateLimiterZeroBudget()
+{
+    // A zero budget is no limit, instead of a bucket that never refills
+    RateLimiter rate_limiter(0);
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++)
+    {
+        rate_limiter.request(PAGE_SIZE, IOPriority::LOW);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    check(elapsed.count() < 1 && rate_limiter.getTotalBytes(IOPriority::LOW) == 1000 * PAGE_SIZE, "testRateLimiterZeroBudget: A zero budget grants every request at once.");
+
+    // A budget set afterwards starts from a full bucket, not from the debt of the unlimited requests
+    rate_limiter.setBytesPerSecond(MEGABYTE);
+    start_time = std::chrono::steady_clock::now();
+    rate_limiter.request(PAGE_SIZE, IOPriority::LOW);
+    elapsed = std::chrono::steady_clock::now() - start_time;
+    check(elapsed.count() < 0.05, "testRateLimiterZeroBudget: A budget set after running without one starts from a full bucket.");
+
+    // Auto-tuning with a zero minimum never shrinks the budget to nothing
+    rate_limiter.enableAutoTune(0.001, 0, 32 * MEGABYTE);
+    for (int i = 0; i < 200 * RATE_LIMITER_TUNE_INTERVAL; i++)
+    {
+        rate_limiter.recordForegroundLatency(0.01);
+    }
+    check(rate_limiter.getBytesPerSecond() == RATE_LIMITER_MIN_BYTES_PER_SECOND, "testRateLimiterZeroBudget: Auto-tuning keeps the budget above zero.");
+}
+
+void testLSMTreeRateLimiter()
+{
+    int db_size = 256;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    RateLimiter *rate_limiter = new RateLimiter(RATE_LIMITER_BYTES_PER_SECOND);
+
+    // Create LSM tree that flushes the same keys twice and merges level 0 once
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    lsm_tree->setRateLimiter(rate_limiter);
+    for (int i = 1; i <= 513; ++i)
+    {
+        lsm_tree->put((i - 1) % db_size + 1, i * 10);
+    }
+
+    check(rate_limiter->getTotalBytes(IOPriority::HIGH) >= 2 * PAGE_SIZE, "testLSMTreeRateLimiter: Flushes go through the rate limiter.");
+    check(rate_limiter->getTotalBytes(IOPriority::MEDIUM) >= PAGE_SIZE, "testLSMTreeRateLimiter: Level 0 compactions go through the rate limiter.");
+
+    bool is_success = true;
+    for (int i = 1; i <= db_size; ++i)
+    {
+        long expected_value = (i == 1 ? 513 : i + db_size) * 10;
+        NodeFileOffset *node_file_offset = lsm_tree->get(i, buffer_pool, false);
+        if (node_file_offset == nullptr || node_file_offset->node->value != expected_value)
+        {
+            is_success = false;
+        }
+    }
+    check(is_success, "testLSMTreeRateLimiter: Get all keys written through the rate limiter.");
+
+    delete lsm_tree;
+    delete rate_limiter;
+    delete buffer_pool;
+    dbClear(current_database);
+}
@@ -0,0 +1,219 @@
+#include "test_row_cache.h"
+#include <future>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns whether the row cache holds the result of a get of the key, with the given value and whether it was found.
+static bool isCached(RowCache &row_cache, long key, long expected_value, bool expected_is_found)
+{
+    long value = 0;
+    bool is_found = false;
+    uint64_t generation;
+    return row_cache.lookup(key, value, is_found, generation) && is_found == expected_is_found && (!is_found || value == expected_value);
+}
+
+// Caches the result of a get of the key, as LSMTree::get does after a miss.
+static void cacheResult(RowCache &row_cache, long key, long value, bool is_found)
+{
+    long cached_value;
+    bool cached_is_found;
+    uint64_t generation;
+    if (!row_cache.lookup(key, cached_value, cached_is_found, generation))
+    {
+        row_cache.insert(key, value, is_found, generation);
+    }
+}
+
+// Frees the result of a get, except for its node if it is the node of the memtable (which get returns as is).
+static void freeGetResult(LSMTree *lsm_tree, NodeFileOffset *result)
+{
+    if (result != nullptr && lsm_tree->getMemtable()->get(result->node->key) == result->node)
+    {
+        result->node = nullptr;
+    }
+    delete result;
+}
+
+void testRowCache()
+{
+    RowCache row_cache(100 * ROW_CACHE_ENTRY_BYTES, 4);
+    long value;
+    bool is_found;
+    uint64_t generation;
+    check(!row_cache.lookup(7, value, is_found, generation), "testRowCache: An empty cache misses");
+    row_cache.insert(7, 70, true, generation);
+    cacheResult(row_cache, 8, 0, false);
+    check(isCached(row_cache, 7, 70, true) && isCached(row_cache, 8, 0, false), "testRowCache: Values and absent keys are cached");
+    check(row_cache.getNumHits() == 2 && row_cache.getNumMisses() == 2 && row_cache.getHitRate() == 0.5, "testRowCache: Hits and misses are counted");
+
+    row_cache.erase(7);
+    check(!isCached(row_cache, 7, 70, true) && isCached(row_cache, 8, 0, false), "testRowCache: Erase invalidates only its key");
+
+    // A result read before a write of its shard is not cached
+    RowCache single_shard(100 * ROW_CACHE_ENTRY_BYTES, 1);
+    single_shard.lookup(1, value, is_found, generation);
+    single_shard.erase(2);
+    single_shard.insert(1, 10, true, generation);
+    check(!isCached(single_shard, 1, 10, true), "testRowCache: A result older than an invalidation of its shard is dropped");
+
+    // The cache stays within its capacity and evicts the least recently used entries
+    for (long key = 0; key < 1000; ++key)
+    {
+        cacheResult(row_cache, key, key * 10, true);
+    }
+    check(row_cache.getBytes() <= row_cache.getCapacity() && row_cache.getNumEntries() > 50 &&
+              row_cache.getBytes() == row_cache.getNumEntries() * ROW_CACHE_ENTRY_BYTES && isCached(row_cache, 999, 9990, true) && !isCached(row_cache, 0, 0, true),
+          "testRowCache: The cache is bounded by its capacity in bytes");
+
+    RowCache lru_cache(3 * ROW_CACHE_ENTRY_BYTES, 1);
+    for (long key = 1; key <= 3; ++key)
+    {
+        cacheResult(lru_cache, key, key, true);
+    }
+    isCached(lru_cache, 1, 1, true);
+    cacheResult(lru_cache, 4, 4, true);
+    check(isCached(lru_cache, 1, 1, true) && !isCached(lru_cache, 2, 2, true) && isCached(lru_cache, 3, 3, true) && isCached(lru_cache, 4, 4, true),
+          "testRowCache: The least recently used entry is evicted first");
+
+    // Ranges are invalidated key by key when short, and entry by entry when long
+    RowCache range_cache(1000 * ROW_CACHE_ENTRY_BYTES, 4);
+    for (long key = 0; key < 500; ++key)
+    {
+        cacheResult(range_cache, key, key, true);
+    }
+    range_cache.eraseRange(10, 12);
+    range_cache.eraseRange(200, LONG_MAX);
+    bool is_success = range_cache.getNumEntries() == 197;
+    for (long key = 0; key < 500; ++key)
+    {
+        is_success &= isCached(range_cache, key, key, true) == (key < 10 || (key > 12 && key < 200));
+    }
+    check(is_success, "testRowCache: EraseRange invalidates every key of the range");
+    range_cache.clear();
+    check(range_cache.getNumEntries() == 0 && range_cache.getBytes() == 0, "testRowCache: Clear invalidates every key");
+
+    // Threads using the cache at once, each with its own keys
+    RowCache shared_cache(4000 * ROW_CACHE_ENTRY_BYTES, ROW_CACHE_NUM_SHARDS);
+    std::vector<std::future<bool>> futures;
+    for (long thread = 0; thread < 4; ++thread)
+    {
+        futures.push_back(std::async(std::launch::async, [&shared_cache, thread]()
+                                     {
+            bool is_correct = true;
+            for (long i = 0; i < 20000; ++i)
+            {
+                long key = thread * 1000 + i % 1000;
+                long value;
+                bool is_found;
+                uint64_t generation;
+                if (shared_cache.lookup(key, value, is_found, generation))
+                {
+                    is_correct &= is_found && value == key * 3;
+                }
+                else
+                {
+                    shared_cache.insert(key, key * 3, true, generation);
+                }
+                if (i % 97 == 0)
+                {
+                    shared_cache.erase(key);
+                }
+            }
+            return is_correct; }));
+    }
+    is_success = true;
+    for (std::future<bool> &future : futures)
+    {
+        is_success &= future.get();
+    }
+    check(is_success && shared_cache.getBytes() == shared_cache.getNumEntries() * ROW_CACHE_ENTRY_BYTES && shared_cache.getBytes() <= shared_cache.getCapacity(),
+          "testRowCache: Concurrent lookups, inserts and erases keep the cache consistent");
+}
+
+void testRowCacheLSMTree()
+{
+    int db_size = 512;
+    long num_keys = 5000;
+    std::string current_database = "test_db";
+    Memtable *memtable = dbOpen(current_database, db_size);
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    LSMTree *lsm_tree = new LSMTree(db_size, current_database, memtable);
+    RowCache *row_cache = new RowCache(1000 * ROW_CACHE_ENTRY_BYTES);
+    lsm_tree->setRowCache(row_cache);
+
+    // Gets between the puts, deletes and range deletes, so every write must invalidate a cached result
+    std::map<long, long> expected;
+    std::mt19937_64 gen(448);
+    std::uniform_int_distribution<long> key_index(0, num_keys - 1);
+    bool is_success = true;
+    for (long i = 0; i < 30000; ++i)
+    {
+        long key = key_index(gen);
+        if (i % 3 == 0)
+        {
+            NodeFileOffset *result = lsm_tree->get(key, buffer_pool, true);
+            auto it = expected.find(key);
+            bool is_found = result != nullptr && result->node->value != LONG_MIN;
+            is_success &= it == expected.end() ? !is_found : is_found && result->node->value == it->second;
+            freeGetResult(lsm_tree, result);
+        }
+        else if (i % 11 == 0)
+        {
+            lsm_tree->put(key, LONG_MIN);
+            expected.erase(key);
+        }
+        else if (i % 1001 == 0)
+        {
+            lsm_tree->deleteRange(key, key + 20);
+            expected.erase(expected.lower_bound(key), expected.upper_bound(key + 20));
+        }
+        else
+        {
+            lsm_tree->put(key, i);
+            expected[key] = i;
+        }
+    }
+    check(is_success && row_cache->getNumHits() > 0, "testRowCacheLSMTree: Gets return the newest value while puts, deletes and range deletes invalidate the cache");
+    check(row_cache->getBytes() <= row_cache->getCapacity(), "testRowCacheLSMTree: The cache stays within its capacity");
+
+    // A Zipfian get workload: the hot keys are served by the row cache instead of the levels
+    is_success = true;
+    for (long key = 0; key < num_keys; ++key)
+    {
+        lsm_tree->put(key, key * 10);
+    }
+    ZipfianGenerator zipfian(num_keys, 0.99, 448);
+    row_cache->resetStats();
+    resetPageReads();
+    for (long i = 0; i < 20000; ++i)
+    {
+        long key = zipfian.next();
+        NodeFileOffset *result = lsm_tree->get(key, buffer_pool, true);
+        is_success &= result != nullptr && result->node->value == key * 10;
+        freeGetResult(lsm_tree, result);
+    }
+    long cached_page_reads = getPageReads();
+    double hit_rate = row_cache->getHitRate();
+    std::cout << "Row cache hit rate under a Zipfian get workload: " << hit_rate << std::endl;
+
+    lsm_tree->setRowCache(nullptr);
+    ZipfianGenerator uncached_zipfian(num_keys, 0.99, 448);
+    resetPageReads();
+    for (long i = 0; i < 20000; ++i)
+    {
+        long key = uncached_zipfian.next();
+        NodeFileOffset *result = lsm_tree->get(key, buffer_pool, true);
+        is_success &= result != nullptr && result->node->value == key * 10;
+        freeGetResult(lsm_tree, result);
+    }
+    check(is_success && hit_rate > 0.5 && cached_page_reads < getPageReads() / 2, "testRowCacheLSMTree: The row cache serves most gets of a Zipfian workload");
+
+    delete lsm_tree;
+    delete row_cache;
+    delete buffer_pool;
+    dbClear(current_database);
+}
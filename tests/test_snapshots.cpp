@@ -0,0 +1,169 @@
+#include "test_snapshots.h"
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns the number of SSTs of the tree.
+static long getNumSSTs(StringLSMTree *lsm_tree)
+{
+    long num_ssts = 0;
+    for (const std::vector<StringSST> &level : lsm_tree->getLevels())
+    {
+        num_ssts += level.size();
+    }
+    return num_ssts;
+}
+
+// Returns the number of versions of the key held by the SSTs of the tree.
+static long getNumVersions(StringLSMTree *lsm_tree, const std::string &key)
+{
+    long num_versions = 0;
+    std::string decoded_key;
+    uint64_t sequence;
+    for (const std::vector<StringSST> &level : lsm_tree->getLevels())
+    {
+        for (const StringSST &sst : level)
+        {
+            for (StringSSTIterator iterator(sst.sst_filename); iterator.valid(); iterator.next())
+            {
+                num_versions += decodeVersionedKey(iterator.key(), decoded_key, sequence) && decoded_key == key ? 1 : 0;
+            }
+        }
+    }
+    return num_versions;
+}
+
+// Puts a new value of the key and flushes the memtable until the tree is compacted into a single SST.
+static bool compactIntoOneSST(StringLSMTree *lsm_tree, const std::string &key)
+{
+    bool is_success = true;
+    for (int i = 0; i < 64 && (i == 0 || getNumSSTs(lsm_tree) > 1); ++i)
+    {
+        is_success &= lsm_tree->put(key, "filler" + std::to_string(i)) && lsm_tree->flush();
+    }
+    return is_success && getNumSSTs(lsm_tree) == 1;
+}
+
+void testVersionedKeys()
+{
+    std::vector<std::string> keys = {"", "a", std::string("a\0", 2), std::string("a\0b", 3), std::string("\0\0", 2), "ab", "b"};
+    bool is_success = true;
+    for (const std::string &key : keys)
+    {
+        for (uint64_t sequence : {static_cast<uint64_t>(0), static_cast<uint64_t>(1), static_cast<uint64_t>(0x1234567890), LATEST_SEQUENCE})
+        {
+            std::string versioned_key = encodeVersionedKey(key, sequence);
+            std::string decoded_key;
+            uint64_t decoded_sequence;
+            is_success &= decodeVersionedKey(versioned_key, decoded_key, decoded_sequence) && decoded_key == key && decoded_sequence == sequence &&
+                          getVersionedKeySequence(versioned_key) == sequence && getVersionedKeyPrefix(versioned_key) == getVersionedKeyPrefix(encodeVersionedKey(key, 7));
+        }
+    }
+    check(is_success, "testVersionedKeys: Keys with zero bytes and their sequence numbers are decoded back");
+
+    std::string decoded_key;
+    uint64_t sequence;
+    check(!decodeVersionedKey("abc", decoded_key, sequence) && !decodeVersionedKey(std::string("a\0b", 3) + std::string(10, '\0'), decoded_key, sequence),
+          "testVersionedKeys: Invalid versioned keys are rejected");
+
+    // The versions of a key are grouped and newest first, and the keys keep their order
+    is_success = encodeVersionedKey("a", 9) < encodeVersionedKey("a", 8) && encodeVersionedKey("a", 1) < encodeVersionedKey("a", 0);
+    std::vector<std::string> sorted_keys = {"", std::string("\0", 1), std::string("\0\0", 2), "a", std::string("a\0", 2), std::string("a\0b", 3), std::string("a\x01", 2), "ab", "b"};
+    for (size_t i = 0; i + 1 < sorted_keys.size(); ++i)
+    {
+        is_success &= encodeVersionedKey(sorted_keys[i], 0) < encodeVersionedKey(sorted_keys[i + 1], LATEST_SEQUENCE);
+    }
+    check(is_success, "testVersionedKeys: Versioned keys sort by key, then newest version first");
+}
+
+void testStringLSMSnapshots()
+{
+    std::string current_database = "test_db";
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    StringLSMTree *lsm_tree = new StringLSMTree(16 * 1024, current_database);
+
+    // A snapshot taken in the memtable sees the values of its time after overwrites and deletes
+    lsm_tree->put("hot", "v0");
+    lsm_tree->put("gone", "here");
+    uint64_t sequence = lsm_tree->getLastSequence();
+    uint64_t snapshot = lsm_tree->getSnapshot();
+    lsm_tree->put("hot", "v1");
+    lsm_tree->remove("gone");
+    lsm_tree->put("new", "later");
+    std::string value;
+    check(snapshot == sequence && sequence == 2 && lsm_tree->getLastSequence() == 5, "testStringLSMSnapshots: Every write takes the next sequence number");
+    check(lsm_tree->get("hot", value, buffer_pool, snapshot) && value == "v0" && lsm_tree->get("gone", value, buffer_pool, snapshot) && value == "here" &&
+              !lsm_tree->get("new", value, buffer_pool, snapshot),
+          "testStringLSMSnapshots: A snapshot reads the memtable as it was");
+    check(lsm_tree->get("hot", value, buffer_pool) && value == "v1" && !lsm_tree->get("gone", value, buffer_pool) && lsm_tree->get("new", value, buffer_pool),
+          "testStringLSMSnapshots: Reads without a snapshot see the newest values");
+
+    // The versions the snapshot sees survive flushes and compactions into a single SST
+    bool is_success = compactIntoOneSST(lsm_tree, "hot");
+    check(is_success && lsm_tree->get("hot", value, buffer_pool, snapshot) && value == "v0" && lsm_tree->get("gone", value, buffer_pool, snapshot) &&
+              value == "here" && !lsm_tree->get("gone", value, buffer_pool) && getNumVersions(lsm_tree, "hot") == 2 && getNumVersions(lsm_tree, "gone") == 2,
+          "testStringLSMSnapshots: Compaction keeps the versions a live snapshot sees");
+
+    // Once released, the old versions and the tombstone are dropped by the next compaction
+    lsm_tree->releaseSnapshot(snapshot);
+    is_success = compactIntoOneSST(lsm_tree, "hot");
+    check(is_success && getNumVersions(lsm_tree, "hot") == 1 && getNumVersions(lsm_tree, "gone") == 0 && lsm_tree->get("new", value, buffer_pool) && value == "later",
+          "testStringLSMSnapshots: Compaction drops the versions of released snapshots");
+
+    // A long scan in chunks at a snapshot stays consistent while writes flush and compact the tree
+    std::map<std::string, std::string> expected;
+    std::mt19937_64 gen(449);
+    std::uniform_int_distribution<long> key_index(0, 1999);
+    for (long i = 0; i < 6000; ++i)
+    {
+        std::string key = "key" + std::to_string(key_index(gen));
+        lsm_tree->put(key, std::to_string(i));
+        expected[key] = std::to_string(i);
+    }
+    snapshot = lsm_tree->getSnapshot();
+    uint64_t second_snapshot = lsm_tree->getSnapshot();
+    std::vector<std::pair<std::string, std::string>> scanned;
+    is_success = true;
+    for (long i = 0; i < 20000; ++i)
+    {
+        std::string key = "key" + std::to_string(key_index(gen));
+        if (i % 5 == 0)
+        {
+            is_success &= lsm_tree->remove(key);
+        }
+        else
+        {
+            is_success &= lsm_tree->put(key, "after" + std::to_string(i));
+        }
+
+        // One chunk of the scan, the keys starting with the next digit, every 2000 writes
+        if (i % 2000 == 0)
+        {
+            std::string prefix = "key" + std::to_string(i / 2000);
+            std::vector<std::pair<std::string, std::string>> chunk = lsm_tree->scan(prefix, prefix + "~", buffer_pool, snapshot);
+            scanned.insert(scanned.end(), chunk.begin(), chunk.end());
+        }
+    }
+    check(is_success && getNumSSTs(lsm_tree) > 1, "testStringLSMSnapshots: Writes continue while the snapshot is live");
+
+    std::vector<std::pair<std::string, std::string>> expected_pairs(expected.begin(), expected.end());
+    check(scanned == expected_pairs && lsm_tree->scan("key", "key~", buffer_pool, snapshot) == expected_pairs,
+          "testStringLSMSnapshots: A scan in chunks at the snapshot returns the pairs of its time");
+
+    // The snapshot was taken twice, so it stays live until both are released
+    lsm_tree->releaseSnapshot(snapshot);
+    is_success = true;
+    for (const auto &[key, expected_value] : expected)
+    {
+        is_success &= lsm_tree->get(key, value, buffer_pool, second_snapshot) && value == expected_value;
+    }
+    check(is_success, "testStringLSMSnapshots: A snapshot taken twice is kept until it is released twice");
+    lsm_tree->releaseSnapshot(second_snapshot);
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
@@ -1,4 +1,8 @@
 #include "test_sst.h"
+#include "checksum.h"
+#include <random>
+#include <tuple>
+#include <fstream>
 
 extern void check(bool condition, const std::string &test_name);
 
@@ -110,4 +114,496 @@ void testGetFromSST()
     check(is_success, "testGetFromSST: Get Items From SST");
 
     dbClear(current_database);
-}
\ No newline at end of file
+}
+
+// Writes the keys (with values of ten times the key) to a new SST in the test database and returns its metadata.
+static SSTMetadata writeTestSST(const std::string &sst_filename, const std::vector<long> &keys)
+{
+    SSTWriter writer(sst_filename, sst_filename + ".btree", sst_filename + ".bloom");
+    for (long key : keys)
+    {
+        writer.put(key, key * 10);
+    }
+    writer.finish();
+    return writer.getMetadata();
+}
+
+void testInterpolationSearch()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string uniform_filename = filepath + "/sst_uniform.bin";
+    std::string skewed_filename = filepath + "/sst_skewed.bin";
+
+    // Uniform keys over 512 pages, and skewed keys where most pages hold a dense run at the end of the key range
+    std::mt19937_64 gen(443);
+    std::vector<long> uniform_keys, skewed_keys;
+    for (long i = 0; i < 512 * static_cast<long>(MAX_PAIRS); ++i)
+    {
+        uniform_keys.push_back(i * 1000 + std::uniform_int_distribution<long>(0, 999)(gen));
+        skewed_keys.push_back(i < 1000 ? i * (1L << 40) : (1L << 50) + i * 2);
+    }
+    SSTMetadata uniform_metadata = writeTestSST(uniform_filename, uniform_keys);
+    SSTMetadata skewed_metadata = writeTestSST(skewed_filename, skewed_keys);
+
+    for (auto [sst_filename, metadata, keys] : {std::tie(uniform_filename, uniform_metadata, uniform_keys), std::tie(skewed_filename, skewed_metadata, skewed_keys)})
+    {
+        BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+        bool is_success = true;
+        long binary_reads = 0, interpolation_reads = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            long key = keys[std::uniform_int_distribution<size_t>(0, keys.size() - 1)(gen)];
+
+            resetPageReads();
+            NodeFileOffset *expected = binarySearch(sst_filename, key, buffer_pool);
+            binary_reads += getPageReads();
+
+            resetPageReads();
+            NodeFileOffset *found = interpolationSearch(sst_filename, metadata, key, buffer_pool);
+            interpolation_reads += getPageReads();
+
+            // Keys between two keys of the SST are not found either
+            NodeFileOffset *missing = interpolationSearch(sst_filename, metadata, key + 1, buffer_pool);
+            if (expected == nullptr || found == nullptr || found->node->value != expected->node->value || missing != nullptr)
+            {
+                is_success = false;
+            }
+            delete expected;
+            delete found;
+            delete missing;
+        }
+        delete buffer_pool;
+
+        std::string name = sst_filename == uniform_filename ? "uniform" : "skewed";
+        check(is_success, "testInterpolationSearch: Interpolation search finds the same keys as binary search with " + name + " keys");
+        check(sst_filename == uniform_filename ? interpolation_reads * 2 < binary_reads : interpolation_reads <= binary_reads * 2,
+              "testInterpolationSearch: Page reads with " + name + " keys (" + std::to_string(interpolation_reads) + " vs " + std::to_string(binary_reads) + ")");
+    }
+
+    for (const std::string &sst_filename : {uniform_filename, skewed_filename})
+    {
+        std::filesystem::remove(sst_filename);
+        std::filesystem::remove(sst_filename + ".btree");
+        std::filesystem::remove(sst_filename + ".bloom");
+    }
+}
+
+void testSingleFileSST()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_single.bin";
+    std::string legacy_filename = filepath + "/sst_legacy.bin";
+
+    // Three full pages and a partial one, so the data block ends with padding
+    std::vector<long> keys;
+    for (long i = 0; i < 3 * static_cast<long>(MAX_PAIRS) + 17; ++i)
+    {
+        keys.push_back(i * 3);
+    }
+    SSTWriter writer(sst_filename);
+    for (long key : keys)
+    {
+        writer.put(key, key * 10);
+    }
+    check(writer.finish(), "testSingleFileSST: Write a single-file SST");
+    SSTMetadata metadata = writer.getMetadata();
+
+    SSTFooter footer;
+    bool has_footer = readSSTFooter(sst_filename, footer);
+    check(has_footer && footer.version == SST_FORMAT_VERSION && footer.num_entries == static_cast<long>(keys.size()) &&
+              footer.min_key == keys.front() && footer.max_key == keys.back() && footer.data_size == 4 * static_cast<long>(PAGE_SIZE),
+          "testSingleFileSST: Footer describes the data block");
+    check(footer.index_offset == footer.data_size && footer.filter_offset == footer.index_offset + footer.index_size &&
+              footer.checksum_offset == footer.filter_offset + static_cast<long>(PAGE_SIZE) && footer.tombstone_size == 0 &&
+              static_cast<long>(std::filesystem::file_size(sst_filename)) == footer.checksum_offset + 2 * static_cast<long>(PAGE_SIZE) &&
+              metadata.footer.filter_offset == footer.filter_offset,
+          "testSingleFileSST: Index, filter, checksum and footer blocks follow the data block");
+
+    long num_files = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(filepath))
+    {
+        num_files += entry.path().filename().string().find("sst_single") == 0;
+    }
+    check(num_files == 1, "testSingleFileSST: Only the SST file is written");
+
+    // The B-Tree is read from the index block, from disk and from a mapping of the file
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    MappedFile sst_map(sst_filename);
+    StaticBTree btree(sst_filename, sst_filename);
+    StaticBTree mapped_btree(sst_filename, sst_filename, &sst_map, &sst_map);
+    btree.setIndexBlock(footer);
+    mapped_btree.setIndexBlock(footer);
+    bool is_success = true;
+    for (long key : keys)
+    {
+        NodeFileOffset *found = binarySearch(sst_filename, key, buffer_pool, nullptr, &footer);
+        is_success = is_success && btree.get(key, buffer_pool) == key * 10 && mapped_btree.get(key) == key * 10 && btree.get(key + 1, buffer_pool) == -1 &&
+                     found != nullptr && found->node->value == key * 10;
+        delete found;
+    }
+    check(is_success, "testSingleFileSST: Get every key through the B-Tree and binary search");
+    check(btree.scan(keys.front(), keys.back(), buffer_pool).size() == keys.size() &&
+              binarySearchScan(sst_filename, keys.front(), keys.back(), buffer_pool, &sst_map).size() == keys.size(),
+          "testSingleFileSST: Scans stop at the end of the data block");
+    delete buffer_pool;
+
+    long num_pairs = 0;
+    SSTIterator iterator(sst_filename);
+    for (; iterator.valid(); iterator.next())
+    {
+        num_pairs++;
+    }
+    check(num_pairs == static_cast<long>(keys.size()) && !iterator.hasError(), "testSingleFileSST: Iterator stops at the end of the data block");
+
+    // An SST written as separate files has no footer
+    writeTestSST(legacy_filename, keys);
+    SSTFooter legacy_footer;
+    check(!readSSTFooter(legacy_filename, legacy_footer) && !legacy_footer.isSingleFile(), "testSingleFileSST: SST written as separate files has no footer");
+
+    for (const std::string &filename : {sst_filename, legacy_filename, legacy_filename + ".btree", legacy_filename + ".bloom"})
+    {
+        std::filesystem::remove(filename);
+        removeChecksumFile(filename);
+    }
+}
+
+void testSSTChecksumBlock()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_blocks.bin";
+
+    // Four pages of keys 0, 2, 4, ... with values 10 times larger, and two range tombstones
+    SSTWriter writer(sst_filename);
+    for (long i = 0; i < 4 * static_cast<long>(MAX_PAIRS); i++)
+    {
+        writer.put(i * 2, i * 20);
+    }
+    writer.putRangeTombstone(-100, -50);
+    writer.putRangeTombstone(10000000, 10000010);
+    check(writer.finish(), "testSSTChecksumBlock: Write a single-file SST with range tombstones");
+    SSTFooter footer = writer.getMetadata().footer;
+    check(!std::filesystem::exists(getRangeTombstoneFilename(sst_filename)) && !std::filesystem::exists(getChecksumFilename(sst_filename)),
+          "testSSTChecksumBlock: No range tombstone or checksum file is written");
+    check(footer.tombstone_size == 4 * static_cast<long>(sizeof(long)) && footer.checksum_offset == footer.tombstone_offset + static_cast<long>(PAGE_SIZE) &&
+              footer.checksum_size == footer.checksum_offset / static_cast<long>(PAGE_SIZE) * static_cast<long>(sizeof(uint32_t)),
+          "testSSTChecksumBlock: The checksum block covers every page before it");
+
+    // The range tombstones and the checksums are read back from the file
+    dropPageChecksums(sst_filename);
+    SSTMetadata metadata;
+    check(readSSTMetadata(sst_filename, metadata) && metadata.range_tombstones.getRanges() == std::vector<std::pair<long, long>>{{-100, -50}, {10000000, 10000010}} && metadata.num_entries == 4 * static_cast<long>(MAX_PAIRS),
+          "testSSTChecksumBlock: The range tombstones are read from the tombstone block");
+    dropPageChecksums(sst_filename);
+    check(getNumPageChecksums(sst_filename) == footer.checksum_offset / static_cast<long>(PAGE_SIZE), "testSSTChecksumBlock: The checksums are read from the checksum block");
+
+    // A corrupted data page is caught by the checksums of the block
+    int fd = open(sst_filename.c_str(), O_RDWR);
+    long corrupted_value = -1;
+    pwrite(fd, &corrupted_value, sizeof(long), PAGE_SIZE + sizeof(long));
+    close(fd);
+    dropPageChecksums(sst_filename);
+    long mismatches = getChecksumMismatches();
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    check(binarySearch(sst_filename, MAX_PAIRS * 2, buffer_pool, nullptr, &footer) == nullptr && getChecksumMismatches() == mismatches + 1,
+          "testSSTChecksumBlock: A corrupted page does not match the checksum block");
+    delete buffer_pool;
+
+    // A checksum block cut short (here by a footer that claims a single checksum) fails the pages it misses
+    std::vector<long> page(PAGE_SIZE / sizeof(long));
+    footer.checksum_size = sizeof(uint32_t);
+    footer.serialize(page.data());
+    fd = open(sst_filename.c_str(), O_RDWR);
+    pwrite(fd, page.data(), PAGE_SIZE, std::filesystem::file_size(sst_filename) - PAGE_SIZE);
+    pread(fd, page.data(), PAGE_SIZE, 0);
+    close(fd);
+    dropPageChecksums(sst_filename);
+    check(verifyPageChecksums(sst_filename, 0, page.data()), "testSSTChecksumBlock: A page covered by a short checksum block is still checked");
+    mismatches = getChecksumMismatches();
+    check(!verifyPageChecksums(sst_filename, 2, page.data()) && getChecksumMismatches() == mismatches + 1,
+          "testSSTChecksumBlock: A page missing from the checksum block is an error");
+
+    std::filesystem::remove(sst_filename);
+    dropPageChecksums(sst_filename);
+}
+
+void testColumnarSST()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_columnar.bin";
+
+    std::vector<long> keys;
+    for (long i = 0; i < 20 * static_cast<long>(MAX_PAIRS) + 17; ++i)
+    {
+        keys.push_back(i * 3 + (i % 5 == 0));
+    }
+
+    for (IndexLayout layout : {IndexLayout::B_TREE, IndexLayout::S_TREE})
+    {
+        std::string name = std::string("testColumnarSST: ") + (layout == IndexLayout::S_TREE ? "S+-tree" : "B-Tree");
+        std::filesystem::remove(sst_filename);
+        SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, layout, PageEncoding::COLUMNAR);
+        for (long key : keys)
+        {
+            writer.put(key, key * 10);
+        }
+        bool is_written = writer.finish();
+        SSTMetadata metadata = writer.getMetadata();
+
+        // The keys of a page come first, then their values
+        SSTFooter footer;
+        alignas(PAGE_SIZE) char page[PAGE_SIZE];
+        std::ifstream file(sst_filename, std::ios::binary);
+        file.read(page, PAGE_SIZE);
+        const long *page_longs = reinterpret_cast<const long *>(page);
+        check(is_written && readSSTFooter(sst_filename, footer) && footer.isColumnar() && footer.getNumDataPages() == (static_cast<long>(keys.size()) + static_cast<long>(MAX_PAIRS) - 1) / static_cast<long>(MAX_PAIRS) &&
+                  page_longs[1] == keys[1] && page_longs[MAX_PAIRS + 1] == keys[1] * 10,
+              name + ": pages hold their keys, then their values");
+
+        std::vector<long> read_keys;
+        bool is_success = true;
+        SSTIterator iterator(sst_filename);
+        for (; iterator.valid(); iterator.next())
+        {
+            read_keys.push_back(iterator.key());
+            is_success &= iterator.value() == iterator.key() * 10;
+        }
+        check(is_success && read_keys == keys && !iterator.hasError(), name + ": iterator returns every pair");
+
+        BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+        MappedFile sst_map(sst_filename);
+        StaticBTree btree(sst_filename, sst_filename);
+        StaticBTree mapped_btree(sst_filename, sst_filename, &sst_map, &sst_map);
+        btree.setIndexBlock(footer);
+        mapped_btree.setIndexBlock(footer);
+        is_success = true;
+        bool is_missing = true;
+        for (size_t i = 0; i < keys.size(); i += 7)
+        {
+            long key = keys[i];
+            NodeFileOffset *results[] = {binarySearch(sst_filename, key, buffer_pool, nullptr, &footer), fencePointerSearch(sst_filename, metadata, key, buffer_pool),
+                                         interpolationSearch(sst_filename, metadata, key, nullptr, &sst_map), learnedIndexSearch(sst_filename, metadata, key, buffer_pool)};
+            for (NodeFileOffset *found : results)
+            {
+                is_success &= found != nullptr && found->node->value == key * 10;
+                delete found;
+            }
+            is_success &= btree.get(key, buffer_pool) == key * 10 && mapped_btree.get(key) == key * 10;
+
+            NodeFileOffset *found = binarySearch(sst_filename, key + 1, buffer_pool, nullptr, &footer);
+            is_missing &= found == nullptr && btree.get(key + 1) == -1;
+            delete found;
+        }
+        check(is_success, name + ": get keys through the index, binary, fence pointer, interpolation and learned index searches");
+        check(is_missing, name + ": keys between the keys of the SST are not found");
+
+        long key1 = keys[MAX_PAIRS + 5], key2 = keys[10 * MAX_PAIRS];
+        std::vector<std::pair<long, long>> expected;
+        for (long key : keys)
+        {
+            if (key >= key1 && key <= key2)
+            {
+                expected.emplace_back(key, key * 10);
+            }
+        }
+        check(btree.scan(key1, key2, buffer_pool) == expected && mapped_btree.scan(key1, key2) == expected &&
+                  binarySearchScan(sst_filename, key1, key2, buffer_pool, nullptr, &footer) == expected,
+              name + ": scans return every pair in the range");
+        delete buffer_pool;
+    }
+
+    std::filesystem::remove(sst_filename);
+    removeChecksumFile(sst_filename);
+}
+
+void testLargePageSST()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_large_pages.bin";
+
+    std::vector<long> keys;
+    for (long i = 0; i < 30 * static_cast<long>(MAX_PAIRS) + 17; ++i)
+    {
+        keys.push_back(i * 3 + (i % 5 == 0));
+    }
+
+    for (size_t page_size : {16 * 1024UL, MAX_PAGE_SIZE})
+    {
+        for (IndexLayout layout : {IndexLayout::B_TREE, IndexLayout::S_TREE})
+        {
+            std::string name = "testLargePageSST: " + std::to_string(page_size / 1024) + " KB pages, " + (layout == IndexLayout::S_TREE ? "S+-tree" : "B-Tree");
+            std::filesystem::remove(sst_filename);
+            dropPageChecksums(sst_filename);
+            SSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, layout, PageEncoding::PLAIN, CompressionType::NONE, page_size);
+            for (long key : keys)
+            {
+                writer.put(key, key * 10);
+            }
+            bool is_written = writer.finish();
+            SSTMetadata metadata = writer.getMetadata();
+
+            // The data block is made of pages of page_size bytes, with a checksum for every PAGE_SIZE of them
+            long page_pairs = page_size / ENTRY_SIZE;
+            long num_pages = (static_cast<long>(keys.size()) + page_pairs - 1) / page_pairs;
+            SSTFooter footer;
+            SSTMetadata read_metadata;
+            check(is_written && readSSTFooter(sst_filename, footer) && footer.page_size == static_cast<long>(page_size) && footer.getNumDataPages() == num_pages &&
+                      static_cast<long>(metadata.fence_keys.size()) == num_pages && readSSTMetadata(sst_filename, read_metadata) &&
+                      read_metadata.fence_keys == metadata.fence_keys,
+                  name + ": the footer records the page size of the data block");
+            dropPageChecksums(sst_filename);
+            check(getNumPageChecksums(sst_filename) == footer.checksum_offset / static_cast<long>(PAGE_SIZE), name + ": every PAGE_SIZE of the file has a checksum");
+
+            std::vector<long> read_keys;
+            bool is_success = true;
+            SSTIterator iterator(sst_filename);
+            for (; iterator.valid(); iterator.next())
+            {
+                read_keys.push_back(iterator.key());
+                is_success &= iterator.value() == iterator.key() * 10;
+            }
+            check(is_success && read_keys == keys && !iterator.hasError(), name + ": iterator returns every pair");
+
+            BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+            MappedFile sst_map(sst_filename);
+            StaticBTree btree(sst_filename, sst_filename);
+            StaticBTree mapped_btree(sst_filename, sst_filename, &sst_map, &sst_map);
+            btree.setIndexBlock(footer);
+            mapped_btree.setIndexBlock(footer);
+            is_success = true;
+            bool is_missing = true;
+            for (size_t i = 0; i < keys.size(); i += 7)
+            {
+                long key = keys[i];
+                NodeFileOffset *results[] = {binarySearch(sst_filename, key, buffer_pool, nullptr, &footer), binarySearch(sst_filename, key, nullptr, &sst_map, &footer),
+                                             fencePointerSearch(sst_filename, metadata, key, buffer_pool), interpolationSearch(sst_filename, metadata, key, nullptr, &sst_map),
+                                             learnedIndexSearch(sst_filename, metadata, key, buffer_pool)};
+                for (NodeFileOffset *found : results)
+                {
+                    is_success &= found != nullptr && found->node->value == key * 10;
+                    delete found;
+                }
+                is_success &= btree.get(key, buffer_pool) == key * 10 && btree.get(key) == key * 10 && mapped_btree.get(key) == key * 10;
+
+                NodeFileOffset *found = binarySearch(sst_filename, key + 1, buffer_pool, nullptr, &footer);
+                is_missing &= found == nullptr && btree.get(key + 1) == -1;
+                delete found;
+            }
+            check(is_success, name + ": get keys through the index, binary, fence pointer, interpolation and learned index searches");
+            check(is_missing, name + ": keys between the keys of the SST are not found");
+
+            long key1 = keys[MAX_PAIRS + 5], key2 = keys[20 * MAX_PAIRS];
+            std::vector<std::pair<long, long>> expected;
+            for (long key : keys)
+            {
+                if (key >= key1 && key <= key2)
+                {
+                    expected.emplace_back(key, key * 10);
+                }
+            }
+            check(btree.scan(key1, key2, buffer_pool) == expected && mapped_btree.scan(key1, key2) == expected &&
+                      binarySearchScan(sst_filename, key1, key2, buffer_pool, nullptr, &footer) == expected,
+                  name + ": scans return every pair in the range");
+            delete buffer_pool;
+        }
+
+        // A corrupted PAGE_SIZE unit fails the whole page it is part of
+        int fd = open(sst_filename.c_str(), O_RDWR);
+        long corrupted_key = -1;
+        pwrite(fd, &corrupted_key, sizeof(long), 2 * PAGE_SIZE + ENTRY_SIZE);
+        close(fd);
+        SSTFooter footer;
+        readSSTFooter(sst_filename, footer);
+        long mismatches = getChecksumMismatches();
+        NodeFileOffset *found = binarySearch(sst_filename, keys[0], nullptr, nullptr, &footer);
+        check(found == nullptr && getChecksumMismatches() > mismatches, "testLargePageSST: " + std::to_string(page_size / 1024) + " KB pages: a corrupted part of a page is caught");
+        delete found;
+    }
+
+    // Only plain, uncompressed pages get larger, and the page size must be valid
+    std::filesystem::remove(sst_filename);
+    dropPageChecksums(sst_filename);
+    SSTWriter packed_writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, PageEncoding::PACKED, CompressionType::NONE, MAX_PAGE_SIZE);
+    for (long key : keys)
+    {
+        packed_writer.put(key, key * 10);
+    }
+    check(packed_writer.finish() && packed_writer.getMetadata().footer.page_size == static_cast<long>(PAGE_SIZE), "testLargePageSST: Packed SSTs keep PAGE_SIZE pages");
+    std::filesystem::remove(sst_filename);
+    dropPageChecksums(sst_filename);
+    SSTWriter invalid_writer(sst_filename, nullptr, IOPriority::HIGH, DEFAULT_INDEX_LAYOUT, PageEncoding::PLAIN, CompressionType::NONE, 24 * 1024);
+    check(!invalid_writer.isOpen(), "testLargePageSST: A page size that is not a power of two is rejected");
+
+    std::filesystem::remove(sst_filename);
+    dropPageChecksums(sst_filename);
+}
+
+// Returns the fraction of the odd keys in [0, 2 * num_keys) that the Bloom filter of an SST of the even keys lets through.
+static double getFilterFalsePositiveRate(const std::string &sst_filename, long num_keys, bool is_sized)
+{
+    std::filesystem::remove(sst_filename);
+    SSTWriter writer(sst_filename);
+    if (is_sized)
+    {
+        writer.sizeFilter(num_keys);
+    }
+    for (long i = 0; i < num_keys; ++i)
+    {
+        writer.put(i * 2, i);
+    }
+    SSTFooter footer;
+    if (!writer.finish() || !readSSTFooter(sst_filename, footer))
+    {
+        return 1;
+    }
+
+    std::vector<char> filter_block(footer.filter_size);
+    std::ifstream file(sst_filename, std::ios::binary);
+    file.seekg(footer.filter_offset);
+    file.read(filter_block.data(), footer.filter_size);
+    BloomFilter bloom_filter(footer.filter_size * 8, BLOOM_FILTER_NUM_HASHES);
+    bloom_filter.loadBitArrayFromBuffer(filter_block.data(), footer.filter_size);
+
+    long false_positives = 0;
+    for (long i = 0; i < num_keys; ++i)
+    {
+        false_positives += bloom_filter.mightContain(std::to_string(i * 2 + 1));
+    }
+    return static_cast<double>(false_positives) / num_keys;
+}
+
+void testSizedBloomFilter()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/sst_sized_filter.bin";
+    long num_keys = BULK_LOAD_SST_PAIRS;
+
+    // The fixed size filter of a bulk-loaded SST is saturated, a filter sized per key is not
+    double fixed_rate = getFilterFalsePositiveRate(sst_filename, num_keys, false);
+    double sized_rate = getFilterFalsePositiveRate(sst_filename, num_keys, true);
+    SSTFooter footer;
+    check(readSSTFooter(sst_filename, footer) && footer.filter_size == static_cast<long>(num_keys * BLOOM_FILTER_BITS_PER_KEY / 8),
+          "testSizedBloomFilter: Filter block is sized per key");
+    check(fixed_rate > 0.9 && sized_rate < 0.2,
+          "testSizedBloomFilter: False positive rate drops from " + std::to_string(fixed_rate) + " to " + std::to_string(sized_rate));
+
+    // Every key written is still found through the sized filter
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    SSTMetadata metadata;
+    bool is_success = readSSTMetadata(sst_filename, metadata) && metadata.num_entries == num_keys;
+    for (long i = 0; i < num_keys; i += 101)
+    {
+        NodeFileOffset *found = fencePointerSearch(sst_filename, metadata, i * 2, buffer_pool);
+        is_success &= found != nullptr && found->node->value == i;
+    }
+    check(is_success, "testSizedBloomFilter: Keys are found in an SST with a sized filter");
+
+    delete buffer_pool;
+    std::filesystem::remove(sst_filename);
+    removeChecksumFile(sst_filename);
+}
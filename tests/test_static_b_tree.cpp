@@ -166,4 +166,147 @@ int testBTreeMain(int memtable_size)
 
     std::cout << "Finished running static B-Tree tests." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
+// Test function for the S+-tree lower bound against std::lower_bound
+void testSTreeLowerBound()
+{
+    std::cout << "Running testSTreeLowerBound..." << std::endl;
+
+    std::mt19937 gen(443);
+    for (long num_keys : {0L, 1L, 16L, 17L, 272L, 300L, 5000L, 70000L})
+    {
+        std::vector<long> keys;
+        for (long i = 0; i < num_keys; ++i)
+        {
+            keys.push_back(i * 3 + 1);
+        }
+        STree tree;
+        tree.build(keys);
+
+        bool is_success = true;
+        std::uniform_int_distribution<long> distrib(0, num_keys * 3 + 2);
+        for (int i = 0; i < 2000; ++i)
+        {
+            long key = distrib(gen);
+            if (tree.lowerBound(key) != std::lower_bound(keys.begin(), keys.end(), key) - keys.begin())
+            {
+                is_success = false;
+            }
+        }
+        check(is_success, "STree Lower Bound Test: Matches std::lower_bound for " + std::to_string(num_keys) + " keys");
+    }
+
+    std::cout << "Passed: testSTreeLowerBound" << std::endl;
+}
+
+// Test function for gets and scans on an SST whose index was written in the S+-tree layout
+void testSTreeLayoutSST()
+{
+    std::cout << "Running testSTreeLayoutSST..." << std::endl;
+
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directory(filepath);
+    cleanup_test_files();
+
+    // More leaf pages than a single B-Tree Internal Node can index
+    long num_pairs = 300 * MAX_PAIRS + 17;
+    SSTWriter writer(sst_filename, btree_filename, bloom_filename, nullptr, IOPriority::HIGH, IndexLayout::S_TREE);
+    for (long i = 1; i <= num_pairs; ++i)
+    {
+        writer.put(i * 2, i * 20);
+    }
+    check(writer.finish(), "STree Layout Test: Write an SST with an S+-tree index");
+
+    MappedFile sst_map(sst_filename);
+    MappedFile btree_map(btree_filename);
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_MAX_PAGES);
+    StaticBTree btree(sst_filename, btree_filename);
+    StaticBTree mapped_btree(sst_filename, btree_filename, &sst_map, &btree_map);
+
+    bool is_success = true;
+    for (long key = 0; key <= num_pairs * 2 + 4; key += 97)
+    {
+        long expected_value = (key > 0 && key % 2 == 0 && key <= num_pairs * 2) ? key * 10 : -1;
+        if (btree.get(key, buffer_pool) != expected_value || mapped_btree.get(key) != expected_value)
+        {
+            is_success = false;
+        }
+    }
+    check(is_success, "STree Layout Test: Get keys through the S+-tree");
+
+    std::vector<std::pair<long, long>> results = btree.scan(1001, 3000, buffer_pool);
+    std::vector<std::pair<long, long>> mapped_results = mapped_btree.scan(1001, 3000);
+    check(results.size() == 1000 && results.front().first == 1002 && results.back().first == 3000 && results == mapped_results,
+          "STree Layout Test: Scan a range across pages through the S+-tree");
+
+    delete buffer_pool;
+    cleanup_test_files();
+    std::filesystem::remove(bloom_filename);
+    std::cout << "Passed: testSTreeLayoutSST" << std::endl;
+}
+
+// Test function for reading pages in place through a PageView, from disk and from buffer pool frames
+void testBTreePageView()
+{
+    std::cout << "Running testBTreePageView..." << std::endl;
+
+    // A partial Leaf page ends with the LEAF marker, while an Internal Node is padded with -1 up to its last key
+    alignas(PAGE_SIZE) long leaf_page[MAX_PAIRS * 2];
+    alignas(PAGE_SIZE) long internal_page[MAX_PAIRS * 2];
+    std::fill(leaf_page, leaf_page + MAX_PAIRS * 2, INTERNAL);
+    std::fill(internal_page, internal_page + MAX_PAIRS * 2, INTERNAL);
+    for (int i = 0; i < 10; ++i)
+    {
+        leaf_page[i * 2] = i * 2 + 1;
+        leaf_page[i * 2 + 1] = i * 100;
+        internal_page[i * 2] = i * 50;
+        internal_page[i * 2 + 1] = i + 1;
+    }
+    leaf_page[(MAX_PAIRS - 1) * 2] = LEAF;
+
+    PageView leaf_view(reinterpret_cast<const char *>(leaf_page));
+    PageView internal_view(reinterpret_cast<const char *>(internal_page));
+    check(leaf_view.isLeaf() && leaf_view.getNumKeys() == 10 && leaf_view.getKey(3) == 7 && leaf_view.getPageOrValue(3) == 300,
+          "PageView Test: View a partial Leaf page in place");
+    check(!internal_view.isLeaf() && internal_view.getNumKeys() == 10 && internal_view.getPageOrValue(9) == 10,
+          "PageView Test: View an Internal Node in place");
+
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directory(filepath);
+    cleanup_test_files();
+
+    long num_pairs = 200 * MAX_PAIRS + 17;
+    SSTWriter writer(sst_filename, btree_filename, bloom_filename);
+    for (long i = 1; i <= num_pairs; ++i)
+    {
+        writer.put(i * 2, i * 20);
+    }
+    check(writer.finish(), "PageView Test: Write an SST with a B-Tree index");
+
+    // The second round of gets finds every Node in the buffer pool and searches the frames in place
+    BufferPool *buffer_pool = new BufferPool(1024);
+    StaticBTree btree(sst_filename, btree_filename);
+    bool is_success = true;
+    for (int round = 0; round < 2; ++round)
+    {
+        for (long key = 0; key <= num_pairs * 2 + 4; key += 37)
+        {
+            long expected_value = (key > 0 && key % 2 == 0 && key <= num_pairs * 2) ? key * 10 : -1;
+            if (btree.get(key, buffer_pool) != expected_value || btree.get(key) != expected_value)
+            {
+                is_success = false;
+            }
+        }
+    }
+    check(is_success, "PageView Test: Get keys from disk and from buffer pool frames");
+
+    std::vector<std::pair<long, long>> results = btree.scan(1001, 3000);
+    std::vector<std::pair<long, long>> cached_results = btree.scan(1001, 3000, buffer_pool);
+    check(results.size() == 1000 && results.front().first == 1002 && results.back().first == 3000 && results == cached_results,
+          "PageView Test: Scan a range across Leaf pages");
+
+    delete buffer_pool;
+    cleanup_test_files();
+    std::filesystem::remove(bloom_filename);
+    std::cout << "Passed: testBTreePageView" << std::endl;
+}
@@ -0,0 +1,376 @@
+#include "test_string_sst.h"
+#include "checksum.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns a key of the form "user:<i>" zero-padded to sort like i.
+static std::string makeKey(long i)
+{
+    std::string number = std::to_string(i);
+    return "user:" + std::string(8 - number.size(), '0') + number;
+}
+
+// Returns a value of the given length made of the bytes of i (including zeros).
+static std::string makeValue(long i, size_t length)
+{
+    std::string value(length, '\0');
+    for (size_t j = 0; j < length; ++j)
+    {
+        value[j] = static_cast<char>((i * 31 + j) % 256);
+    }
+    return value;
+}
+
+void testSlottedPage()
+{
+    SlottedPageBuilder builder;
+    check(builder.empty() && builder.getFreeBytes() == PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE, "testSlottedPage: A new page is empty");
+
+    // Keys and values of different lengths, with a zero byte, an empty value and a tombstone
+    std::vector<std::pair<std::string, std::string>> pairs = {{"a", "1"}, {"ab", ""}, {std::string("b\0c", 3), "zero"}, {"bb", "tombstone"}, {"c", std::string(100, 'x')}};
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        builder.add(pairs[i].first, pairs[i].second, i == 3);
+    }
+    alignas(PAGE_SIZE) char page[PAGE_SIZE];
+    builder.write(page);
+
+    bool is_success = getSlottedPageNumSlots(page) == 5 && isSlottedPageValid(page);
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        is_success &= getSlottedKey(page, i) == pairs[i].first && isSlottedTombstone(page, i) == (i == 3) &&
+                      getSlottedValue(page, i) == (i == 3 ? std::string() : pairs[i].second);
+    }
+    check(is_success, "testSlottedPage: Every key, value and tombstone is read back in place");
+
+    check(slottedLowerBound(page, "") == 0 && slottedLowerBound(page, "ab") == 1 && slottedLowerBound(page, "aa") == 1 &&
+              slottedLowerBound(page, std::string("b\0d", 3)) == 3 && slottedLowerBound(page, "d") == 5,
+          "testSlottedPage: The lower bound of a key compares its bytes");
+    check(builder.getFirstKey() == "a" && builder.getLastKey() == "c" && builder.size() == 5, "testSlottedPage: The builder keeps its first and last keys");
+
+    // A page fills up once its slots and records meet
+    builder.clear();
+    long num_added = 0;
+    while (builder.add(makeKey(num_added), makeValue(num_added, 50)))
+    {
+        num_added++;
+    }
+    check(num_added == static_cast<long>((PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE) / getSlottedRecordBytes(13, 50)) && builder.getFreeBytes() < getSlottedRecordBytes(13, 50),
+          "testSlottedPage: A page holds as many pairs as their sizes allow");
+    check(builder.add("z", std::string(builder.getFreeBytes() - getSlottedRecordBytes(1, 0), 'v')) && builder.getFreeBytes() == 0,
+          "testSlottedPage: A pair that exactly fills the page fits");
+
+    // A page whose slots point past its end is rejected
+    builder.write(page);
+    std::memset(page + SLOTTED_PAGE_HEADER_SIZE, 0xFF, SLOTTED_SLOT_SIZE);
+    check(!isSlottedPageValid(page), "testSlottedPage: A corrupted slot is detected");
+
+    check(getSeparatorKey("apple", "apricot") == "apr" && getSeparatorKey("ab", "abc") == "abc" && getSeparatorKey("a", "b") == "b",
+          "testSlottedPage: A separator is the shortest prefix of the first key greater than the previous key");
+}
+
+void testStringSST()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+    std::string sst_filename = filepath + "/strsst_test.bin";
+
+    // Keys of varying lengths and values from empty to a few KB, with every 10th key deleted
+    std::mt19937_64 gen(443);
+    std::uniform_int_distribution<size_t> value_length(0, 300);
+    std::map<std::string, StringEntry> expected;
+    for (long i = 0; i < 20000; i += 2)
+    {
+        std::string key = makeKey(i) + std::string(i % 7, 'k');
+        bool is_tombstone = i % 10 == 0;
+        expected[key] = {is_tombstone ? std::string() : makeValue(i, i % 1000 == 2 ? 3000 : value_length(gen)), is_tombstone};
+    }
+
+    std::remove(sst_filename.c_str());
+    StringSSTWriter writer(sst_filename);
+    bool is_success = writer.isOpen();
+    for (const auto &[key, entry] : expected)
+    {
+        is_success &= writer.put(key, entry.value, entry.is_tombstone);
+    }
+    check(!writer.put("a", "out of order"), "testStringSST: A key smaller than the last one is rejected");
+    check(!writer.put("zzz", std::string(PAGE_SIZE, 'v')), "testStringSST: A pair larger than a page is rejected");
+    check(!writer.put(std::string(STRING_SST_MAX_KEY_BYTES + 1, 'z'), ""), "testStringSST: A key too long for the index is rejected");
+    is_success &= writer.finish();
+    check(is_success, "testStringSST: Write an SST of byte-string pairs");
+
+    StringSSTMetadata metadata = writer.getMetadata();
+    SSTFooter footer;
+    check(readSSTFooter(sst_filename, footer) && footer.page_encoding == PageEncoding::SLOTTED && footer.num_entries == static_cast<long>(expected.size()) &&
+              footer.getNumIndexPages() > 1,
+          "testStringSST: The footer describes slotted pages and a multi-page B-Tree");
+    check(metadata.num_entries == static_cast<long>(expected.size()) && metadata.num_tombstones == 2000 && metadata.min_key == expected.begin()->first &&
+              metadata.max_key == expected.rbegin()->first,
+          "testStringSST: The metadata counts the pairs and tombstones and keeps the key range");
+
+    StringSSTMetadata read_metadata = readStringSSTMetadata(sst_filename);
+    check(read_metadata.num_entries == metadata.num_entries && read_metadata.num_bytes == metadata.num_bytes && read_metadata.max_key == metadata.max_key,
+          "testStringSST: The metadata is computed again from the file");
+
+    // The iterator returns every pair in order
+    is_success = true;
+    auto expected_it = expected.begin();
+    StringSSTIterator iterator(sst_filename);
+    for (; iterator.valid() && expected_it != expected.end(); iterator.next(), ++expected_it)
+    {
+        is_success &= iterator.key() == expected_it->first && iterator.value() == expected_it->second.value && iterator.isTombstone() == expected_it->second.is_tombstone;
+    }
+    check(is_success && !iterator.valid() && expected_it == expected.end() && !iterator.hasError(), "testStringSST: The iterator returns every pair in key order");
+
+    // Gets read one page per level of the B-Tree
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    for (BufferPool *pool : {static_cast<BufferPool *>(nullptr), buffer_pool})
+    {
+        is_success = true;
+        for (const auto &[key, entry] : expected)
+        {
+            StringEntry found;
+            is_success &= stringSSTGet(sst_filename, metadata, key, found, pool) && found.value == entry.value && found.is_tombstone == entry.is_tombstone;
+        }
+        check(is_success, std::string("testStringSST: Get every key ") + (pool ? "with" : "without") + " a buffer pool");
+    }
+
+    is_success = true;
+    for (const std::string &missing_key : {std::string(""), std::string("a"), makeKey(1), makeKey(9999) + "k", makeKey(30000), std::string("user:")})
+    {
+        StringEntry found;
+        is_success &= !stringSSTGet(sst_filename, metadata, missing_key, found, buffer_pool);
+    }
+    check(is_success, "testStringSST: Keys that were not written are not found");
+
+    bool might_contain_all = true;
+    for (const auto &[key, entry] : expected)
+    {
+        might_contain_all &= stringSSTMightContain(sst_filename, metadata, key, buffer_pool);
+    }
+    check(might_contain_all, "testStringSST: The Bloom filter holds every key");
+
+    std::vector<std::pair<std::string, StringEntry>> results;
+    is_success = stringSSTScan(sst_filename, metadata, makeKey(5001), makeKey(7000), results, buffer_pool);
+    auto first = expected.lower_bound(makeKey(5001));
+    auto last = expected.upper_bound(makeKey(7000));
+    is_success &= static_cast<long>(results.size()) == std::distance(first, last);
+    for (size_t i = 0; is_success && i < results.size(); ++i, ++first)
+    {
+        is_success &= results[i].first == first->first && results[i].second.value == first->second.value;
+    }
+    check(is_success, "testStringSST: Scan returns every pair in the range in order");
+
+    // An SST without pairs can be written and searched
+    std::string empty_filename = filepath + "/strsst_empty.bin";
+    std::remove(empty_filename.c_str());
+    StringSSTWriter empty_writer(empty_filename);
+    StringEntry found;
+    check(empty_writer.finish() && !stringSSTGet(empty_filename, empty_writer.getMetadata(), "a", found, nullptr) && !StringSSTIterator(empty_filename).valid(),
+          "testStringSST: An empty SST has no pairs");
+
+    // A corrupted data page is detected by its checksum
+    ChecksumMode was_mode = getChecksumMode();
+    setChecksumMode(ChecksumMode::ON);
+    {
+        std::fstream file(sst_filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(PAGE_SIZE * 3 + 100);
+        file.put('\x7F');
+    }
+    StringSSTIterator corrupted_iterator(sst_filename);
+    while (corrupted_iterator.valid())
+    {
+        corrupted_iterator.next();
+    }
+    check(corrupted_iterator.hasError(), "testStringSST: A corrupted page stops the iterator");
+    setChecksumMode(was_mode);
+
+    delete buffer_pool;
+    for (const std::string &filename : {sst_filename, empty_filename})
+    {
+        std::remove(filename.c_str());
+        removeChecksumFile(filename);
+    }
+}
+
+void testStringLSMTree()
+{
+    std::string current_database = "test_db";
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+
+    // A 16 KB memtable, so the pairs below are flushed and compacted many times
+    StringLSMTree *lsm_tree = new StringLSMTree(16 * 1024, current_database);
+    std::map<std::string, std::string> expected;
+    std::mt19937_64 gen(443);
+    std::uniform_int_distribution<long> key_index(0, 3000);
+    std::uniform_int_distribution<size_t> value_length(1, 200);
+    bool is_success = true;
+    for (long i = 0; i < 12000; ++i)
+    {
+        long k = key_index(gen);
+        std::string key = "key" + std::to_string(k);
+        if (i % 7 == 0)
+        {
+            is_success &= lsm_tree->remove(key);
+            expected.erase(key);
+        }
+        else
+        {
+            std::string value = makeValue(i, value_length(gen));
+            is_success &= lsm_tree->put(key, value);
+            expected[key] = value;
+        }
+    }
+    check(is_success, "testStringLSMTree: Put and remove keys through flushes and compactions");
+
+    long num_ssts = 0;
+    for (const std::vector<StringSST> &level : lsm_tree->getLevels())
+    {
+        num_ssts += level.size();
+    }
+    check(num_ssts > 0 && lsm_tree->getLevels()[0].size() < LEVEL_SIZE_RATIO, "testStringLSMTree: The memtable was flushed and level 0 compacted");
+
+    is_success = true;
+    for (long k = 0; k <= 3000; ++k)
+    {
+        std::string key = "key" + std::to_string(k);
+        std::string value;
+        bool is_found = lsm_tree->get(key, value, buffer_pool);
+        auto it = expected.find(key);
+        is_success &= it == expected.end() ? !is_found : (is_found && value == it->second);
+    }
+    check(is_success, "testStringLSMTree: Get returns the newest value and hides removed keys");
+
+    std::vector<std::pair<std::string, std::string>> scanned = lsm_tree->scan("key1", "key2", buffer_pool);
+    auto first = expected.lower_bound("key1");
+    auto last = expected.upper_bound("key2");
+    is_success = static_cast<long>(scanned.size()) == std::distance(first, last);
+    for (size_t i = 0; is_success && i < scanned.size(); ++i, ++first)
+    {
+        is_success &= scanned[i].first == first->first && scanned[i].second == first->second;
+    }
+    check(is_success, "testStringLSMTree: Scan returns the newest value of every key in the range");
+
+    // Large values, up to what a page holds
+    std::string large_value = makeValue(7, SLOTTED_PAGE_MAX_RECORD_BYTES - 9 - VERSIONED_KEY_SUFFIX_BYTES);
+    std::string value;
+    check(lsm_tree->put("large:key", large_value) && lsm_tree->flush() && lsm_tree->get("large:key", value, buffer_pool) && value == large_value,
+          "testStringLSMTree: A value of a few KB is stored in an SST");
+    check(!lsm_tree->put("too:large", std::string(PAGE_SIZE, 'v')), "testStringLSMTree: A pair larger than a page is rejected");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
+
+void testStringSSTPageSizes()
+{
+    std::string filepath = DATA_FILE_PATH + "test_db";
+    std::filesystem::create_directories(filepath);
+
+    std::map<std::string, std::string> expected;
+    for (long i = 0; i < 20000; i += 2)
+    {
+        expected[makeKey(i)] = makeValue(i, i % 1000 == 2 ? 12000 : 100);
+    }
+
+    check(!isValidPageSize(2048) && !isValidPageSize(24 * 1024) && !isValidPageSize(2 * MAX_PAGE_SIZE) && isValidPageSize(PAGE_SIZE) && isValidPageSize(MAX_PAGE_SIZE),
+          "testStringSSTPageSizes: Page sizes are powers of two between PAGE_SIZE and MAX_PAGE_SIZE");
+    std::string invalid_filename = filepath + "/strsst_invalid.bin";
+    check(!StringSSTWriter(invalid_filename, nullptr, IOPriority::HIGH, 6000).isOpen(), "testStringSSTPageSizes: An SST with an invalid page size is not written");
+    std::remove(invalid_filename.c_str());
+
+    long num_4k_index_pages = 0;
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    for (size_t page_size : {PAGE_SIZE, static_cast<size_t>(16 * 1024), MAX_PAGE_SIZE})
+    {
+        std::string name = "testStringSSTPageSizes (" + std::to_string(page_size / 1024) + " KB): ";
+        std::string sst_filename = filepath + "/strsst_" + std::to_string(page_size) + ".bin";
+        std::remove(sst_filename.c_str());
+        StringSSTWriter writer(sst_filename, nullptr, IOPriority::HIGH, page_size);
+        bool is_success = writer.isOpen();
+        for (const auto &[key, value] : expected)
+        {
+            // Values larger than a 4 KB page only fit in larger pages
+            is_success &= writer.put(key, value) == (key.size() + value.size() <= getSlottedPageMaxRecordBytes(page_size));
+        }
+        is_success &= writer.finish();
+        check(is_success, name + "Write an SST, rejecting only the pairs larger than a page");
+
+        SSTFooter footer;
+        check(readSSTFooter(sst_filename, footer) && footer.page_size == static_cast<long>(page_size) && footer.version == SST_FORMAT_VERSION,
+              name + "The footer records the page size");
+        if (page_size == PAGE_SIZE)
+        {
+            num_4k_index_pages = footer.getNumIndexPages();
+        }
+        else
+        {
+            check(footer.getNumIndexPages() < num_4k_index_pages, name + "Larger pages need fewer index pages");
+        }
+
+        StringSSTMetadata metadata = writer.getMetadata();
+        for (BufferPool *pool : {static_cast<BufferPool *>(nullptr), buffer_pool, buffer_pool})
+        {
+            is_success = true;
+            for (const auto &[key, value] : expected)
+            {
+                StringEntry found;
+                bool is_found = stringSSTGet(sst_filename, metadata, key, found, pool);
+                is_success &= key.size() + value.size() <= getSlottedPageMaxRecordBytes(page_size) ? is_found && found.value == value : !is_found;
+            }
+            check(is_success, name + "Get every key " + (pool ? "with" : "without") + " a buffer pool");
+        }
+
+        std::vector<std::pair<std::string, StringEntry>> results;
+        is_success = stringSSTScan(sst_filename, metadata, makeKey(1001), makeKey(9000), results, buffer_pool) &&
+                     results.size() == (page_size == PAGE_SIZE ? 3992 : 4000);
+        long num_iterated = 0;
+        for (StringSSTIterator iterator(sst_filename); iterator.valid(); iterator.next())
+        {
+            num_iterated++;
+        }
+        check(is_success && num_iterated == metadata.num_entries, name + "Scan and iterate over the pairs");
+
+        std::remove(sst_filename.c_str());
+        removeChecksumFile(sst_filename);
+    }
+    delete buffer_pool;
+
+    // An LSM tree with 64 KB pages on every level stores and finds the same pairs
+    std::string current_database = "test_db";
+    buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    StringLSMTree *lsm_tree = new StringLSMTree(64 * 1024, current_database);
+    check(!lsm_tree->setPageSize(3 * PAGE_SIZE) && lsm_tree->setPageSize(MAX_PAGE_SIZE, 0), "testStringSSTPageSizes: The page size of an LSM tree is validated");
+    bool is_success = true;
+    for (long i = 0; i < 20000; ++i)
+    {
+        is_success &= lsm_tree->put(makeKey(i % 5000), makeValue(i, 100));
+    }
+    is_success &= lsm_tree->flush();
+    for (long k = 0; k < 5000; ++k)
+    {
+        std::string value;
+        is_success &= lsm_tree->get(makeKey(k), value, buffer_pool) && value == makeValue(15000 + k, 100);
+    }
+    is_success &= lsm_tree->scan(makeKey(100), makeKey(199), buffer_pool).size() == 100;
+    for (const std::vector<StringSST> &level : lsm_tree->getLevels())
+    {
+        for (const StringSST &sst : level)
+        {
+            SSTFooter footer;
+            is_success &= readSSTFooter(sst.sst_filename, footer) && footer.page_size == static_cast<long>(MAX_PAGE_SIZE);
+        }
+    }
+    check(is_success, "testStringSSTPageSizes: An LSM tree with 64 KB pages returns the newest values");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
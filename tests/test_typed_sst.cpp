@@ -0,0 +1,177 @@
+#include "test_typed_sst.h"
+#include "checksum.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+void testPageLayout()
+{
+    check(PageLayout<long, long>::MAX_PAIRS == MAX_PAIRS && PageLayout<long, long>::ENTRY_SIZE == ENTRY_SIZE, "testPageLayout: long keys and values are the default layout");
+    check(PageLayout<int32_t, int32_t>::MAX_PAIRS == 512, "testPageLayout: A page holds 512 pairs of 4-byte keys and values");
+    check(PageLayout<int32_t, long>::MAX_PAIRS == 341 && PageLayout<long, int32_t>::MAX_PAIRS == 341, "testPageLayout: A page holds 341 pairs of 4-byte and 8-byte fields");
+    check(PageLayout<int32_t, int32_t>::BTREE_PAGE_SIZE < PageLayout<long, long>::BTREE_PAGE_SIZE * 2, "testPageLayout: B-Tree nodes of 4-byte keys hold pages as longs");
+}
+
+// Writes num_pairs pairs (even keys from -num_pairs) into an SST of the types, then checks gets and a scan through the reader.
+template <typename Key, typename Value>
+static void checkTypedSST(const std::string &type_name, long num_pairs, BufferPool *buffer_pool)
+{
+    // The buffer pool identifies pages by file name, so every type width gets its own file
+    std::string sst_filename = DATA_FILE_PATH + "test_db/typed_sst_" + std::to_string(sizeof(Key)) + "_" + std::to_string(sizeof(Value)) + ".bin";
+    TypedSSTWriter<Key, Value> writer(sst_filename);
+    bool is_success = writer.isOpen();
+    for (long i = 0; i < num_pairs; ++i)
+    {
+        is_success &= writer.put(static_cast<Key>(2 * i - num_pairs), static_cast<Value>(i * 3 + 1));
+    }
+    is_success &= !writer.put(0, 0) && writer.finish() && writer.getNumEntries() == num_pairs;
+    check(is_success, "testTypedSST: Write " + type_name + " pairs in increasing key order");
+
+    const long max_pairs = PageLayout<Key, Value>::MAX_PAIRS;
+    TypedSSTReader<Key, Value> reader(sst_filename);
+    check(reader.isOpen() && reader.getNumPages() == (num_pairs + max_pairs - 1) / max_pairs, "testTypedSST: " + type_name + " pages hold " + std::to_string(max_pairs) + " pairs");
+
+    is_success = true;
+    for (long i = 0; i < num_pairs; ++i)
+    {
+        Value value;
+        is_success &= reader.get(static_cast<Key>(2 * i - num_pairs), value, buffer_pool) && value == static_cast<Value>(i * 3 + 1);
+        is_success &= !reader.get(static_cast<Key>(2 * i + 1 - num_pairs), value, buffer_pool);
+    }
+    Value value;
+    is_success &= !reader.get(static_cast<Key>(num_pairs), value, buffer_pool) && !reader.get(std::numeric_limits<Key>::min(), value, buffer_pool);
+    check(is_success, "testTypedSST: Get every " + type_name + " key, and no missing key");
+
+    std::vector<std::pair<Key, Value>> results;
+    is_success = reader.scan(static_cast<Key>(max_pairs - 3 - num_pairs), static_cast<Key>(4 * max_pairs + 1 - num_pairs), results, buffer_pool);
+    long first = (max_pairs - 2) / 2;
+    is_success &= static_cast<long>(results.size()) == std::max(0L, std::min(num_pairs, 2 * max_pairs + 1) - first);
+    for (size_t i = 0; is_success && i < results.size(); ++i)
+    {
+        is_success &= results[i].first == static_cast<Key>(2 * (first + i) - num_pairs) && results[i].second == static_cast<Value>((first + i) * 3 + 1);
+    }
+    results.clear();
+    is_success &= reader.scan(std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max(), results, buffer_pool) && static_cast<long>(results.size()) == num_pairs;
+    check(is_success, "testTypedSST: Scan a range of " + type_name + " keys across pages");
+
+    std::filesystem::remove(sst_filename);
+    removeChecksumFile(sst_filename);
+}
+
+void testTypedSST()
+{
+    std::filesystem::create_directories(DATA_FILE_PATH + "test_db");
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    for (BufferPool *pool : {static_cast<BufferPool *>(nullptr), buffer_pool})
+    {
+        checkTypedSST<int32_t, int32_t>("int32/int32", 5000, pool);
+        checkTypedSST<int32_t, long>("int32/long", 5000, pool);
+        checkTypedSST<long, int32_t>("long/int32", 5000, pool);
+        checkTypedSST<long, long>("long/long", 5000, pool);
+    }
+    checkTypedSST<int32_t, int32_t>("int32/int32", 100, nullptr);
+    delete buffer_pool;
+}
+
+// Puts and deletes random signed keys in a tree of the types with a small memtable, so they are flushed and compacted many times, then checks gets and scans.
+template <typename Key, typename Value>
+static void checkTypedLSMTree(const std::string &type_name, BufferPool *buffer_pool)
+{
+    TypedLSMTree<Key, Value> *lsm_tree = new TypedLSMTree<Key, Value>(1000, "test_db");
+    std::map<Key, Value> expected;
+    std::mt19937_64 gen(446);
+    std::uniform_int_distribution<long> key_index(-3000, 3000);
+    bool is_success = true;
+    for (long i = 0; i < 20000; ++i)
+    {
+        Key key = static_cast<Key>(key_index(gen) * 3);
+        if (i % 5 == 4)
+        {
+            is_success &= lsm_tree->remove(key);
+            expected.erase(key);
+            continue;
+        }
+        is_success &= lsm_tree->put(key, static_cast<Value>(i));
+        expected[key] = static_cast<Value>(i);
+    }
+    check(is_success, "testTypedLSMTree: Put and delete " + type_name + " pairs through flushes and compactions");
+
+    long num_ssts = 0;
+    bool is_compacted = false;
+    for (size_t level = 0; level < lsm_tree->getLevels().size(); ++level)
+    {
+        num_ssts += lsm_tree->getLevels()[level].size();
+        is_compacted |= level > 0 && !lsm_tree->getLevels()[level].empty();
+    }
+    check(num_ssts > 0 && is_compacted, "testTypedLSMTree: " + type_name + " SSTs are compacted into deeper levels");
+
+    is_success = true;
+    for (long k = -3000; k <= 3000; ++k)
+    {
+        Value value;
+        auto expected_pair = expected.find(static_cast<Key>(k * 3));
+        bool is_found = lsm_tree->get(static_cast<Key>(k * 3), value, buffer_pool);
+        is_success &= expected_pair == expected.end() ? !is_found : is_found && value == expected_pair->second;
+        is_success &= !lsm_tree->get(static_cast<Key>(k * 3 + 1), value, buffer_pool);
+    }
+    check(is_success, "testTypedLSMTree: Get the newest value of every " + type_name + " key, and no deleted key");
+
+    std::vector<std::pair<Key, Value>> results = lsm_tree->scan(-4000, 4000, buffer_pool);
+    std::vector<std::pair<Key, Value>> expected_results(expected.lower_bound(-4000), expected.upper_bound(4000));
+    check(results == expected_results, "testTypedLSMTree: Scan a range of " + type_name + " keys");
+
+    is_success = lsm_tree->flush() && lsm_tree->getMemtable()->getCurrSize() == 0;
+    results = lsm_tree->scan(std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max(), buffer_pool);
+    check(is_success && results == std::vector<std::pair<Key, Value>>(expected.begin(), expected.end()), "testTypedLSMTree: Flush and scan every " + type_name + " key");
+
+    for (const std::vector<TypedSST<Key, Value>> &level : lsm_tree->getLevels())
+    {
+        for (const TypedSST<Key, Value> &sst : level)
+        {
+            std::filesystem::remove(sst.sst_filename);
+            removeChecksumFile(sst.sst_filename);
+        }
+    }
+    delete lsm_tree;
+}
+
+void testTypedLSMTree()
+{
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+    checkTypedLSMTree<int32_t, int32_t>("int32/int32", buffer_pool);
+    checkTypedLSMTree<int32_t, long>("int32/long", buffer_pool);
+    checkTypedLSMTree<long, int32_t>("long/int32", nullptr);
+    checkTypedLSMTree<long, long>("long/long", nullptr);
+    delete buffer_pool;
+
+    // Deleting every key of the only SST leaves nothing once level 0 is compacted, as no deeper level holds a value for the tombstones to hide
+    TypedLSMTree<int32_t, int32_t> *lsm_tree = new TypedLSMTree<int32_t, int32_t>(100, "test_db");
+    bool is_success = true;
+    for (int32_t key = -50; key < 50; ++key)
+    {
+        is_success &= lsm_tree->put(key, key);
+    }
+    for (int32_t key = -50; key < 50; ++key)
+    {
+        is_success &= lsm_tree->remove(key);
+    }
+    long num_pages = 0;
+    for (const std::vector<TypedSST<int32_t, int32_t>> &level : lsm_tree->getLevels())
+    {
+        for (const TypedSST<int32_t, int32_t> &sst : level)
+        {
+            num_pages += sst.reader->getNumPages();
+            std::filesystem::remove(sst.sst_filename);
+            removeChecksumFile(sst.sst_filename);
+        }
+    }
+    check(is_success && lsm_tree->getLevels()[0].size() == 1 && num_pages == 0, "testTypedLSMTree: Compactions drop the tombstones of the deepest SSTs");
+    delete lsm_tree;
+}
@@ -0,0 +1,176 @@
+#include "test_value_log.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+extern void check(bool condition, const std::string &test_name);
+
+// Returns a value of the given length made of the bytes of i (including zeros).
+static std::string makeValue(long i, size_t length)
+{
+    std::string value(length, '\0');
+    for (size_t j = 0; j < length; ++j)
+    {
+        value[j] = static_cast<char>((i * 37 + j) % 256);
+    }
+    return value;
+}
+
+void testValueLog()
+{
+    std::string directory = DATA_FILE_PATH + "test_db";
+    ValueLog *value_log = new ValueLog(directory, 64 * 1024);
+
+    // Records of up to 2 KB, so they are spread over many 64 KB segments
+    std::vector<ValuePointer> pointers;
+    bool is_success = true;
+    for (long i = 0; i < 1000; ++i)
+    {
+        ValuePointer pointer;
+        is_success &= value_log->append("key" + std::to_string(i), makeValue(i, 1 + (i * 7) % 2048), pointer);
+        pointers.push_back(pointer);
+    }
+    check(is_success && value_log->getNumSegments() > 1, "testValueLog: Append records over many segments");
+    check(value_log->getBytesWritten() == value_log->getDiskBytes(), "testValueLog: Every appended byte is in a segment");
+
+    ValuePointer decoded;
+    check(decoded.decode(pointers[123].encode()) && decoded == pointers[123] && !decoded.decode("short"), "testValueLog: Encode and decode a pointer");
+
+    is_success = true;
+    for (long i = 0; i < 1000; ++i)
+    {
+        std::string value;
+        is_success &= value_log->read(pointers[i], value) && value == makeValue(i, 1 + (i * 7) % 2048);
+    }
+    check(is_success, "testValueLog: Read every value back");
+
+    std::vector<std::string> values;
+    is_success = value_log->readValues(pointers, values);
+    for (long i = 0; i < 1000; ++i)
+    {
+        is_success &= values[i] == makeValue(i, 1 + (i * 7) % 2048);
+    }
+    check(is_success, "testValueLog: Read every value back in parallel");
+
+    // Reopening the log keeps the old segments readable and appends to a new one
+    delete value_log;
+    value_log = new ValueLog(directory, 64 * 1024);
+    long num_segments = value_log->getNumSegments();
+    std::string value;
+    check(value_log->read(pointers[999], value) && value == makeValue(999, 1 + (999 * 7) % 2048), "testValueLog: Reopen the segments of a log");
+
+    // Collect the oldest segment, keeping the records of even keys
+    std::map<std::string, ValuePointer> relocated;
+    auto is_live = [](const std::string &key, const ValuePointer &)
+    {
+        return std::stol(key.substr(3)) % 2 == 0;
+    };
+    auto relocate = [&](const std::string &key, const ValuePointer &pointer)
+    {
+        relocated[key] = pointer;
+        return true;
+    };
+    long first_segment = pointers[0].segment;
+    long num_in_first_segment = 0;
+    for (const ValuePointer &pointer : pointers)
+    {
+        num_in_first_segment += pointer.segment == first_segment ? 1 : 0;
+    }
+    check(value_log->collectGarbage(is_live, relocate) && value_log->getNumSegments() == num_segments - 1, "testValueLog: Collect the oldest segment");
+    check(static_cast<long>(relocated.size()) == (num_in_first_segment + 1) / 2, "testValueLog: Only the live records are relocated");
+
+    is_success = true;
+    for (const auto &[key, pointer] : relocated)
+    {
+        long i = std::stol(key.substr(3));
+        is_success &= pointer.segment != first_segment && value_log->read(pointer, value) && value == makeValue(i, 1 + (i * 7) % 2048);
+    }
+    check(is_success && !value_log->read(pointers[1], value), "testValueLog: Relocated values are read from their new place and the old segment is gone");
+
+    // Corrupt a byte of a value
+    ValuePointer pointer = pointers[500];
+    {
+        std::fstream segment_file(directory + "/vlog_" + std::to_string(pointer.segment) + ".log", std::ios::in | std::ios::out | std::ios::binary);
+        segment_file.seekp(pointer.offset + pointer.size - 1);
+        segment_file.put(static_cast<char>(~makeValue(500, 1 + (500 * 7) % 2048).back()));
+    }
+    check(!value_log->read(pointer, value), "testValueLog: A corrupted record is detected");
+
+    value_log->removeAll();
+    delete value_log;
+}
+
+void testValueLogLSMTree()
+{
+    std::string current_database = "test_db";
+    BufferPool *buffer_pool = new BufferPool(BUFFER_POOL_SIZE);
+
+    // A 16 KB memtable and 64 KB segments, so values of 256 bytes or more are separated over many segments
+    StringLSMTree *lsm_tree = new StringLSMTree(16 * 1024, current_database);
+    lsm_tree->enableValueLog(256, 64 * 1024);
+    std::map<std::string, std::string> expected;
+    std::mt19937_64 gen(445);
+    std::uniform_int_distribution<long> key_index(0, 2000);
+    std::uniform_int_distribution<size_t> value_length(1, 1000);
+    bool is_success = true;
+    for (long i = 0; i < 8000; ++i)
+    {
+        std::string key = "key" + std::to_string(key_index(gen));
+        if (i % 9 == 0)
+        {
+            is_success &= lsm_tree->remove(key);
+            expected.erase(key);
+        }
+        else
+        {
+            // A few values are larger than a page
+            std::string value = makeValue(i, i % 500 == 1 ? 3 * PAGE_SIZE : value_length(gen));
+            is_success &= lsm_tree->put(key, value);
+            expected[key] = value;
+        }
+    }
+    check(is_success && lsm_tree->getValueLog()->getNumSegments() > 1, "testValueLogLSMTree: Put large values in the value log");
+
+    auto check_contents = [&](const std::string &test_name)
+    {
+        bool is_correct = true;
+        for (long k = 0; k <= 2000; ++k)
+        {
+            std::string key = "key" + std::to_string(k);
+            std::string value;
+            bool is_found = lsm_tree->get(key, value, buffer_pool);
+            auto it = expected.find(key);
+            is_correct &= it == expected.end() ? !is_found : (is_found && value == it->second);
+        }
+        check(is_correct, "testValueLogLSMTree: Get returns the newest value " + test_name);
+
+        std::vector<std::pair<std::string, std::string>> scanned = lsm_tree->scan("key1", "key2", buffer_pool);
+        auto first = expected.lower_bound("key1");
+        auto last = expected.upper_bound("key2");
+        is_correct = static_cast<long>(scanned.size()) == std::distance(first, last);
+        for (size_t i = 0; is_correct && i < scanned.size(); ++i, ++first)
+        {
+            is_correct &= scanned[i].first == first->first && scanned[i].second == first->second;
+        }
+        check(is_correct, "testValueLogLSMTree: Scan returns the newest value of every key in the range " + test_name);
+    };
+    check_contents("through the value log");
+
+    // Values overwritten or removed are garbage, so collecting every old segment shrinks the log
+    long disk_bytes = lsm_tree->getValueLog()->getDiskBytes();
+    long num_collected = 0;
+    for (long num_segments = lsm_tree->getValueLog()->getNumSegments(); num_collected < num_segments - 1 && lsm_tree->collectValueLogGarbage(buffer_pool);)
+    {
+        num_collected++;
+    }
+    check(num_collected > 0 && lsm_tree->getValueLog()->getDiskBytes() < disk_bytes, "testValueLogLSMTree: Garbage collection shrinks the value log");
+    check_contents("after garbage collection");
+    check(lsm_tree->getWriteAmplification() > 1, "testValueLogLSMTree: Write amplification counts the SST and value log bytes");
+
+    delete lsm_tree;
+    delete buffer_pool;
+    dbClear(current_database);
+}
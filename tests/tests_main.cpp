@@ -5,6 +5,19 @@
 #include "test_buffer_pool.h"
 #include "test_static_b_tree.h"
 #include "test_lsm_tree.h"
+#include "test_rate_limiter.h"
+#include "test_external_sort.h"
+#include "test_page_search.h"
+#include "test_learned_index.h"
+#include "test_checksum.h"
+#include "test_packed_page.h"
+#include "test_block_codec.h"
+#include "test_string_sst.h"
+#include "test_value_log.h"
+#include "test_typed_sst.h"
+#include "test_row_cache.h"
+#include "test_snapshots.h"
+#include "test_lsm_versions.h"
 
 // Global counters for test results
 int total_tests = 0;
@@ -40,6 +53,18 @@ const bool test_memtableScan = false;  // Tests to scan through SSTs of differen
 // Step 1.3
 const bool test_get = false;  // Tests to get Nodes from both Memtables and SSTs of different sizes.
 const bool test_scan = false; // Tests to scan through both Memtables and SSTs of different sizes and return a list of Nodes.
+const bool test_interpolation_search = true; // Tests for the interpolation search mode of SSTs
+const bool test_checksums = true;            // Tests for the CRC32C checksums of SST, B-Tree and Bloom filter pages
+const bool test_single_file_sst = true;      // Tests for the single-file SST format and its footer
+const bool test_packed_pages = true;         // Tests for the bit-packed key encoding of SST data pages
+const bool test_block_compression = true;    // Tests for the block compression codecs of SST data pages
+const bool test_columnar_pages = true;       // Tests for the columnar key-value layout of SST data pages
+const bool test_string_keys = true;          // Tests for byte-string keys and values in slotted SST pages
+const bool test_value_log = true;            // Tests for the value log of large byte-string values
+const bool test_typed_sst = true;            // Tests for the page layouts, Memtables, SSTs and LSM trees of other key and value types
+const bool test_row_cache = true;            // Tests for the row cache of recent get results
+const bool test_snapshots = true;            // Tests for the sequence numbers and snapshots of byte-string LSM trees
+const bool test_lsm_versions = true;         // Tests for the versions of an LSM tree read by several threads
 
 // Step 2.3
 const bool test_BTree_min_node = true;          // Tests for a B-Tree with a very tiny Leaf Node
@@ -47,9 +72,25 @@ const bool test_BTree_leaf_node = true;         // Tests for a B-Tree with a sin
 const bool test_BTree_internal_node = true;     // Tests for a B-Tree with a single Internal Node and Two Leaf Nodes
 const bool test_BTree_internal_node_max = true; // Tests for a B-Tree with a single Internal Node and 256 Leaf Nodes
 const bool test_BTree_multiple_nodes = false;   // Tests for a B-Tree with one layer of Internal Nodes
+const bool test_STree_layout = true;            // Tests for the S+-tree index layout
+const bool test_page_search = true;             // Tests for the SIMD lower bound search within a page
+const bool test_page_view = true;               // Tests for reading B-Tree pages in place
 
 // Step 3.1
 const bool test_lsm_tree_scan = true;
+const bool test_lsm_tree_tombstones = true; // Tests for dropping tombstones early and tombstone-triggered compactions
+const bool test_range_tombstones = true;   // Tests for DeleteRange in the Memtable, SSTs and compactions
+const bool test_trivial_move = true;       // Tests for moving non-overlapping SSTs down without rewriting them
+const bool test_bulk_load = true;          // Tests for bulk loading sorted pairs without the memtable
+const bool test_mmap_read_mode = true;      // Tests for reading SSTs through memory mappings
+const bool test_fence_pointers = true;      // Tests for the in-memory fence pointers of each SST
+const bool test_learned_index = true;       // Tests for the piecewise-linear learned index of each SST
+
+// Rate Limiter
+const bool test_rate_limiter = true; // Tests for the flush and compaction rate limiter
+
+// External Sort
+const bool test_external_sort = true; // Tests for external sorting and ingesting unsorted files
 
 int main(int argc, char *argv[])
 {
@@ -95,6 +136,120 @@ int main(int argc, char *argv[])
         testGetFromSST();
     }
 
+    if (test_interpolation_search)
+    {
+        std::cout << "\nTesting interpolation search of SSTs..." << std::endl;
+        testInterpolationSearch();
+    }
+
+    if (test_checksums)
+    {
+        std::cout << "\nTesting CRC32C kernels..." << std::endl;
+        testCRC32C();
+        std::cout << "\nTesting detection of corrupted pages..." << std::endl;
+        testChecksumCorruption();
+    }
+
+    if (test_single_file_sst)
+    {
+        std::cout << "\nTesting single-file SSTs..." << std::endl;
+        testSingleFileSST();
+        std::cout << "\nTesting the tombstone and checksum blocks of single-file SSTs..." << std::endl;
+        testSSTChecksumBlock();
+        std::cout << "\nTesting Bloom filters sized per key..." << std::endl;
+        testSizedBloomFilter();
+        std::cout << "\nTesting SSTs of larger pages..." << std::endl;
+        testLargePageSST();
+        std::cout << "\nTesting LSM trees with larger pages in the deeper levels..." << std::endl;
+        testLSMPageSize();
+    }
+
+    if (test_packed_pages)
+    {
+        std::cout << "\nTesting packed page decode kernels..." << std::endl;
+        testPackedPageKernels();
+        std::cout << "\nTesting packed SSTs..." << std::endl;
+        testPackedSST();
+        std::cout << "\nTesting LSM trees with packed SSTs..." << std::endl;
+        testLSMPackedPages();
+    }
+
+    if (test_block_compression)
+    {
+        std::cout << "\nTesting block compression codecs..." << std::endl;
+        testBlockCodecs();
+        std::cout << "\nTesting compressed SSTs..." << std::endl;
+        testCompressedSST();
+        std::cout << "\nTesting LSM trees with compressed levels..." << std::endl;
+        testLSMCompression();
+    }
+
+    if (test_columnar_pages)
+    {
+        std::cout << "\nTesting columnar SSTs..." << std::endl;
+        testColumnarSST();
+        std::cout << "\nTesting LSM trees with columnar SSTs..." << std::endl;
+        testLSMColumnarPages();
+    }
+
+    if (test_string_keys)
+    {
+        std::cout << "\nTesting slotted pages..." << std::endl;
+        testSlottedPage();
+        std::cout << "\nTesting byte-string SSTs..." << std::endl;
+        testStringSST();
+        std::cout << "\nTesting LSM trees of byte-string keys..." << std::endl;
+        testStringLSMTree();
+        std::cout << "\nTesting byte-string SSTs of larger pages..." << std::endl;
+        testStringSSTPageSizes();
+    }
+
+    if (test_value_log)
+    {
+        std::cout << "\nTesting the value log..." << std::endl;
+        testValueLog();
+        std::cout << "\nTesting LSM trees with a value log..." << std::endl;
+        testValueLogLSMTree();
+    }
+
+    if (test_typed_sst)
+    {
+        std::cout << "\nTesting page layouts of other key and value types..." << std::endl;
+        testPageLayout();
+        std::cout << "\nTesting Memtables of other key and value types..." << std::endl;
+        testBasicMemtableTypes();
+        std::cout << "\nTesting SSTs of other key and value types..." << std::endl;
+        testTypedSST();
+        std::cout << "\nTesting LSM trees of other key and value types..." << std::endl;
+        testTypedLSMTree();
+    }
+
+    if (test_row_cache)
+    {
+        std::cout << "\nTesting the row cache..." << std::endl;
+        testRowCache();
+        std::cout << "\nTesting LSM trees with a row cache..." << std::endl;
+        testRowCacheLSMTree();
+    }
+
+    if (test_snapshots)
+    {
+        std::cout << "\nTesting versioned keys..." << std::endl;
+        testVersionedKeys();
+        std::cout << "\nTesting snapshots of LSM trees of byte-string keys..." << std::endl;
+        testStringLSMSnapshots();
+    }
+
+    if (test_lsm_versions)
+    {
+        std::cout << "\nTesting versions of LSM trees..." << std::endl;
+        testLSMVersions();
+        std::cout << "\nTesting LSM trees read by several threads..." << std::endl;
+        testLSMConcurrentReads();
+        std::cout << "\nTesting snapshots of LSM trees..." << std::endl;
+        testLSMSnapshots();
+    }
+
     if (test_scan)
     {
         std::cout << "\nTesting scanning Nodes from the Memtable and all SSTs..." << std::endl;
@@ -131,6 +286,25 @@ int main(int argc, char *argv[])
         int n = testBTreeMain(131072);
     }
 
+    if (test_STree_layout)
+    {
+        std::cout << "\nTesting S+-Tree index layout..." << std::endl;
+        testSTreeLowerBound();
+        testSTreeLayoutSST();
+    }
+
+    if (test_page_search)
+    {
+        std::cout << "\nTesting page search kernels..." << std::endl;
+        testPageLowerBoundKernels();
+    }
+
+    if (test_page_view)
+    {
+        std::cout << "\nTesting B-Tree page views..." << std::endl;
+        testBTreePageView();
+    }
+
     if (test_lsm_tree_scan)
     {
         std::cout << "\nTesting LSM Scan SSTs with two pages..." << std::endl;
@@ -141,6 +315,82 @@ int main(int argc, char *argv[])
         testLSMScanThreePagesOnDiskTwoLevel();
     }
 
+    if (test_lsm_tree_tombstones)
+    {
+        std::cout << "\nTesting LSM dropping tombstones with nothing older to hide..." << std::endl;
+        testLSMTombstoneDroppedEarly();
+        std::cout << "\nTesting LSM compaction of SSTs with many tombstones..." << std::endl;
+        testLSMTombstoneDensityCompaction();
+        std::cout << "\nTesting LSM compaction of tombstones into the overlapping SSTs of the next level..." << std::endl;
+        testLSMTombstoneCompactionOverlap();
+        std::cout << "\nTesting LSM flushes after a compaction failed on a corrupted SST..." << std::endl;
+        testLSMCorruptedCompaction();
+    }
+
+    if (test_range_tombstones)
+    {
+        std::cout << "\nTesting DeleteRange in the Memtable..." << std::endl;
+        testMemtableDeleteRange();
+        std::cout << "\nTesting LSM DeleteRange with get and scan..." << std::endl;
+        testLSMDeleteRange();
+        std::cout << "\nTesting LSM compaction of range tombstones..." << std::endl;
+        testLSMDeleteRangeCompaction();
+    }
+
+    if (test_trivial_move)
+    {
+        std::cout << "\nTesting LSM trivial moves of non-overlapping SSTs..." << std::endl;
+        testLSMTrivialMove();
+    }
+
+    if (test_bulk_load)
+    {
+        std::cout << "\nTesting LSM bulk load of sorted pairs..." << std::endl;
+        testLSMBulkLoad();
+        std::cout << "\nTesting LSM compactions that split their output into SSTs..." << std::endl;
+        testLSMCompactionSplit();
+    }
+
+    if (test_mmap_read_mode)
+    {
+        std::cout << "\nTesting LSM reads in mmap mode..." << std::endl;
+        testLSMMmapReadMode();
+    }
+
+    if (test_fence_pointers)
+    {
+        std::cout << "\nTesting LSM gets with fence pointers..." << std::endl;
+        testLSMFencePointers();
+    }
+
+    if (test_learned_index)
+    {
+        std::cout << "\nTesting learned index error bound..." << std::endl;
+        testLearnedIndexErrorBound();
+        std::cout << "\nTesting LSM gets with the learned index..." << std::endl;
+        testLSMLearnedIndex();
+    }
+
+    if (test_rate_limiter)
+    {
+        std::cout << "\nTesting Rate Limiter throttling..." << std::endl;
+        testRateLimiterThrottle();
+        std::cout << "\nTesting Rate Limiter auto-tuning..." << std::endl;
+        testRateLimiterAutoTune();
+        std::cout << "\nTesting Rate Limiter without a budget..." << std::endl;
+        testRateLimiterZeroBudget();
+        std::cout << "\nTesting LSM Tree with a Rate Limiter..." << std::endl;
+        testLSMTreeRateLimiter();
+    }
+
+    if (test_external_sort)
+    {
+        std::cout << "\nTesting external sort of runs..." << std::endl;
+        testExternalSortRuns();
+        std::cout << "\nTesting LSM ingest of an unsorted CSV file..." << std::endl;
+        testLSMIngestCSV();
+    }
+
     std::cout << "\nFinished running all unit tests..." << std::endl;
     std::cout << "\nTotal Number of Tests: " << total_tests << std::endl;
     std::cout << "\nNumber of Tests Passed: " << passed_tests << ", meaning a " << (passed_tests / total_tests) * 100 << "% success rate!" << std::endl;